@@ -78,6 +78,9 @@ static void dump_all_codec(GF_FilterSession *session);
 static void write_filters_options(GF_FilterSession *fsess);
 static void write_core_options();
 static void write_file_extensions();
+#ifndef WIN32
+static void gpac_check_trace_request(GF_FilterSession *fsess);
+#endif
 static int gpac_make_lang(char *filename);
 static Bool gpac_expand_alias(int argc, char **argv);
 static u32 gpac_unit_tests(GF_MemTrackerType mem_track);
@@ -153,6 +156,9 @@ const char *gpac_doc =
 "  \n"
 "A filter may be assigned a tag (any string) using `:TAG=name` option. This tag does not need to be unique, and can be used to exclude filter in link resolution.\n"
 "  \n"
+"A filter may be assigned to a NUMA node using `:NODE=N` option. Filters loaded during link resolution inherit the node of their source filter, so that a filter chain can be grouped on one node. "
+"This is only used by the `steal` scheduler, which posts tasks of the filter to threads running on that node (see `-affinity`).\n"
+"  \n"
 "## Source and Sink filters\n"
 "Source and sink filters do not need to be addressed by the filter name, specifying `src=` or `dst=` instead is enough. "
 "You can also use the syntax `-src URL` or `-i URL` for sources and `-dst URL` or `-o URL` for destination, this allows prompt completion in shells.\n"
@@ -986,6 +992,9 @@ static char szCom[2048];
 static u64 run_start_time = 0;
 static Bool gpac_fsess_task(GF_FilterSession *fsess, void *callback, u32 *reschedule_ms)
 {
+#ifndef WIN32
+	gpac_check_trace_request(fsess);
+#endif
 	if (enable_prompt && gf_prompt_has_input()) {
 		u32 i, count;
 		GF_Filter *filter;
@@ -1200,6 +1209,25 @@ static void gpac_sig_handler(int sig)
 #endif
 }
 
+#ifndef WIN32
+//set by SIGUSR1, polled by gpac_fsess_task
+static volatile sig_atomic_t trace_requested = 0;
+
+//request a session trace window, see -trace option. The session is not async-signal-safe, the window is started by gpac_fsess_task
+static void gpac_sig_trace(int sig)
+{
+	trace_requested = 1;
+}
+
+static void gpac_check_trace_request(GF_FilterSession *fsess)
+{
+	if (trace_requested) {
+		trace_requested = 0;
+		gf_fs_trace_start(fsess, 0);
+	}
+}
+#endif
+
 static void parse_sep_set(const char *arg, Bool *override_seps)
 {
 	if (!arg) return;
@@ -1563,6 +1591,7 @@ static int gpac_main(int argc, char **argv)
 	Bool alias_set = GF_FALSE;
 	GF_FilterSession *tmp_sess;
 	Bool has_xopt = GF_FALSE;
+	Bool use_fsess_task = GF_FALSE;
 	helpout = stdout;
 
 	//look for mem track and profile, and also process all helpers
@@ -2125,7 +2154,14 @@ restart:
 		gf_fs_enable_reporting(session, GF_TRUE);
 	}
 
-	if (enable_prompt || (runfor>0)) {
+#ifndef WIN32
+	if (gf_opts_get_key("core", "trace")) {
+		trace_requested = 0;
+		signal(SIGUSR1, gpac_sig_trace);
+		use_fsess_task = GF_TRUE;
+	}
+#endif
+	if (enable_prompt || (runfor>0) || use_fsess_task) {
 		if (enable_prompt && !loops_done) {
 			GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("Running session, press 'h' for help\n"));
 		}
@@ -0,0 +1,164 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom Paris 2022
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / asynchronous file I/O benchmark
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*remuxes (or copies) a file with regular I/O then with asynchronous I/O, reporting throughput of each run*/
+
+#include <gpac/tools.h>
+#include <gpac/filters.h>
+
+static u32 block_size = 0x100000;
+static u32 nb_blocks = 4;
+static Bool direct = GF_FALSE;
+
+static GF_Err copy_file(const char *src, const char *dst, Bool use_aio)
+{
+	GF_Err e = GF_OK;
+	FILE *in, *out;
+	u8 *buf;
+	if (use_aio) {
+		in = gf_fopen_aio(src, "rb", block_size, nb_blocks, 0);
+		out = gf_fopen_aio(dst, "wb", block_size, nb_blocks, direct ? GF_FILE_AIO_DIRECT : 0);
+	} else {
+		in = gf_fopen(src, "rb");
+		out = gf_fopen(dst, "wb");
+	}
+	buf = gf_malloc(block_size);
+	if (!in || !out || !buf) {
+		e = GF_IO_ERR;
+	} else {
+		while (1) {
+			u32 read = (u32) gf_fread(buf, block_size, in);
+			if (!read) break;
+			if (gf_fwrite(buf, read, out) != read) {
+				e = GF_IO_ERR;
+				break;
+			}
+		}
+	}
+	if (buf) gf_free(buf);
+	if (in) gf_fclose(in);
+	if (out && gf_fclose(out)) e = GF_IO_ERR;
+	return e;
+}
+
+static GF_Err remux_file(const char *src, const char *dst, Bool use_aio)
+{
+	GF_Err e;
+	char *src_url, *dst_url, szOpt[100];
+	GF_FilterSession *fs = gf_fs_new_defaults(0);
+	if (!fs) return GF_OUT_OF_MEM;
+
+	src_url = gf_strdup(src);
+	dst_url = gf_strdup(dst);
+	if (use_aio) {
+		sprintf(szOpt, ":aio:ra=%u", nb_blocks);
+		gf_dynstrcat(&src_url, szOpt, NULL);
+		sprintf(szOpt, ":aio:aiobk=%u%s", block_size, direct ? ":direct" : "");
+		gf_dynstrcat(&dst_url, szOpt, NULL);
+	}
+	gf_fs_load_source(fs, src_url, NULL, NULL, &e);
+	if (!e) gf_fs_load_destination(fs, dst_url, NULL, NULL, &e);
+	if (!e) e = gf_fs_run(fs);
+	if (e==GF_EOS) e = GF_OK;
+	if (!e) e = gf_fs_get_last_connect_error(fs);
+	if (!e) e = gf_fs_get_last_process_error(fs);
+	gf_fs_del(fs);
+	gf_free(src_url);
+	gf_free(dst_url);
+	return e;
+}
+
+static void usage()
+{
+	fprintf(stderr, "usage: aiobench [options] SRC DST\n"
+		"SRC: source file\n"
+		"DST: destination file, overwritten at each run\n"
+		"-copy: copy file using gf_f* functions rather than remuxing through fin and fout filters\n"
+		"-bs N: block size in bytes, default 1048576\n"
+		"-nb N: number of blocks in flight, default 4\n"
+		"-direct: use direct I/O for asynchronous writes\n"
+		"-n N: number of runs for each mode, default 1\n"
+	);
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, r, nb_runs=1;
+	Bool copy = GF_FALSE;
+	char *src=NULL, *dst=NULL;
+	u64 src_size;
+	FILE *f;
+
+	for (i=1; i<(u32) argc; i++) {
+		if (!strcmp(argv[i], "-copy")) copy = GF_TRUE;
+		else if (!strcmp(argv[i], "-direct")) direct = GF_TRUE;
+		else if (!strcmp(argv[i], "-bs") && (i+1<(u32) argc)) block_size = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-nb") && (i+1<(u32) argc)) nb_blocks = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-n") && (i+1<(u32) argc)) nb_runs = atoi(argv[++i]);
+		else if (argv[i][0] != '-') {
+			if (!src) src = argv[i];
+			else dst = argv[i];
+		} else {
+			usage();
+			return 1;
+		}
+	}
+	if (!src || !dst || !block_size || !nb_runs) {
+		usage();
+		return 1;
+	}
+
+	gf_sys_init(GF_MemTrackerNone, NULL);
+	src_size = 0;
+	f = gf_fopen(src, "rb");
+	if (f) {
+		src_size = gf_fsize(f);
+		gf_fclose(f);
+	}
+	if (!src_size) {
+		fprintf(stderr, "cannot open %s\n", src);
+		gf_sys_close();
+		return 1;
+	}
+
+	for (r=0; r<2*nb_runs; r++) {
+		GF_Err e;
+		u64 start, now;
+		Bool use_aio = (r % 2) ? GF_TRUE : GF_FALSE;
+
+		start = gf_sys_clock_high_res();
+		e = copy ? copy_file(src, dst, use_aio) : remux_file(src, dst, use_aio);
+		now = gf_sys_clock_high_res() - start;
+		if (!now) now = 1;
+
+		if (e) {
+			fprintf(stderr, "%s run %u failed: %s\n", use_aio ? "async" : "regular", r/2 + 1, gf_error_to_string(e));
+			continue;
+		}
+		fprintf(stderr, "%s run %u: "LLU" bytes in %.3f s - %.2f MB/s\n", use_aio ? "async  " : "regular", r/2 + 1, src_size, ((Double) now) / 1000000, ((Double) src_size) / now);
+	}
+	gf_sys_close();
+	return 0;
+}
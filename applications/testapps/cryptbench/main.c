@@ -0,0 +1,141 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom Paris 2022
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / AES benchmark
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*measures throughput of the GPAC crypto library for AES-CTR, AES-CBC and the cbcs 1:9 pattern*/
+
+#include <gpac/tools.h>
+#include <gpac/crypt.h>
+
+enum
+{
+	BENCH_CTR = 0,
+	BENCH_CBC_ENC,
+	BENCH_CBC_DEC,
+	BENCH_CBCS,
+};
+
+static const char *bench_names[] = {"CTR", "CBC encrypt", "CBC decrypt", "cbcs 1:9"};
+
+static GF_Err run_bench(u32 type, u8 *buf, u32 size, u32 nb_iter, u64 *duration)
+{
+	u32 i;
+	u64 start;
+	GF_Err e = GF_OK;
+	GF_CryptJob job;
+	bin128 key = {0x2b,0x7e,0x15,0x16,0x28,0xae,0xd2,0xa6,0xab,0xf7,0x15,0x88,0x09,0xcf,0x4f,0x3c};
+	u8 IV[16] = {0xf0,0xf1,0xf2,0xf3,0xf4,0xf5,0xf6,0xf7,0xf8,0xf9,0xfa,0xfb,0xfc,0xfd,0xfe,0xff};
+	GF_Crypt *mc = gf_crypt_open(GF_AES_128, (type==BENCH_CTR) ? GF_CTR : GF_CBC);
+	if (!mc) return GF_IO_ERR;
+	e = gf_crypt_init(mc, key, IV);
+	if (e) return e;
+
+	memset(&job, 0, sizeof(GF_CryptJob));
+	if (type==BENCH_CBCS) {
+		job.mode = GF_CBC;
+		memcpy(job.key, key, 16);
+		memcpy(job.IV, IV, 16);
+		job.IV_size = 16;
+		job.data = buf;
+		e = gf_crypt_job_add_range(&job, 0, size, 1, 9, GF_TRUE);
+	}
+
+	start = gf_sys_clock_high_res();
+	for (i=0; (i<nb_iter) && !e; i++) {
+		switch (type) {
+		case BENCH_CTR:
+		case BENCH_CBC_ENC:
+			e = gf_crypt_encrypt(mc, buf, size);
+			break;
+		case BENCH_CBC_DEC:
+			e = gf_crypt_decrypt(mc, buf, size);
+			break;
+		case BENCH_CBCS:
+			e = gf_crypt_job_run(mc, &job);
+			break;
+		}
+	}
+	*duration = gf_sys_clock_high_res() - start;
+
+	if (job.ranges) gf_free(job.ranges);
+	gf_crypt_close(mc);
+	return e;
+}
+
+static void usage()
+{
+	fprintf(stderr, "usage: cryptbench [options]\n"
+		"-size N: buffer size in kilobytes, default 16384\n"
+		"-n N: number of passes over the buffer for each test, default 10\n"
+		"-no-aes-hw: disable AES instructions in the built-in AES implementation (no effect when GPAC uses OpenSSL)\n"
+	);
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, size=16384, nb_iter=10;
+	Bool no_hw = GF_FALSE;
+	u8 *buf;
+
+	for (i=1; i<(u32) argc; i++) {
+		if (!strcmp(argv[i], "-no-aes-hw")) no_hw = GF_TRUE;
+		else if (!strcmp(argv[i], "-size") && (i+1<(u32) argc)) size = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-n") && (i+1<(u32) argc)) nb_iter = atoi(argv[++i]);
+		else {
+			usage();
+			return 1;
+		}
+	}
+	if (!size || !nb_iter) {
+		usage();
+		return 1;
+	}
+	//size in kilobytes, CBC always runs on full blocks
+	size *= 1024;
+
+	gf_sys_init(GF_MemTrackerNone, NULL);
+	if (no_hw) gf_opts_set_key("temp", "no-aes-hw", "yes");
+
+	buf = gf_malloc(size);
+	if (!buf) {
+		gf_sys_close();
+		return 1;
+	}
+	for (i=0; i<size; i++) buf[i] = (u8) i;
+
+	for (i=BENCH_CTR; i<=BENCH_CBCS; i++) {
+		u64 duration;
+		GF_Err e = run_bench(i, buf, size, nb_iter, &duration);
+		if (e) {
+			fprintf(stderr, "%s failed: %s\n", bench_names[i], gf_error_to_string(e));
+			continue;
+		}
+		if (!duration) duration = 1;
+		//bytes per microsecond / 1000 = GB/s
+		fprintf(stderr, "%-12s: "LLU" bytes in %.3f s - %.3f GB/s\n", bench_names[i], ((u64) size) * nb_iter, ((Double) duration) / 1000000, ((Double) size) * nb_iter / duration / 1000);
+	}
+	gf_free(buf);
+	gf_sys_close();
+	return 0;
+}
@@ -0,0 +1,220 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom Paris 2022
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / HTTP server load test
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*opens N persistent connections to an HTTP server and issues GET requests in loop on each connection,
+reporting requests per second and latency percentiles. Responses must use Content-Length (no chunk transfer)*/
+
+#include <gpac/tools.h>
+#include <gpac/network.h>
+
+typedef struct
+{
+	GF_Socket *sk;
+	u64 req_start;
+	//header bytes received, header size once parsed
+	u32 hdr_len, hdr_size;
+	u64 body_size, body_recv;
+	char hdr[4096];
+} HTTPClient;
+
+static u32 nb_lats=0, alloc_lats=0;
+static u32 *lats=NULL;
+static u64 nb_bytes=0;
+static u32 nb_errors=0;
+
+static GF_Err send_request(HTTPClient *cl, const char *req, u32 req_len)
+{
+	cl->hdr_len = cl->hdr_size = 0;
+	cl->body_size = cl->body_recv = 0;
+	cl->req_start = gf_sys_clock_high_res();
+	return gf_sk_send(cl->sk, (const u8 *) req, req_len);
+}
+
+static void request_done(HTTPClient *cl)
+{
+	if (nb_lats == alloc_lats) {
+		alloc_lats = alloc_lats ? 2*alloc_lats : 10000;
+		lats = gf_realloc(lats, sizeof(u32)*alloc_lats);
+	}
+	lats[nb_lats++] = (u32) (gf_sys_clock_high_res() - cl->req_start);
+}
+
+//returns GF_TRUE if response is complete
+static Bool process_data(HTTPClient *cl, u8 *data, u32 size)
+{
+	if (!cl->hdr_size) {
+		char *end, *cl_hdr;
+		u32 copy = MIN(size, (u32) sizeof(cl->hdr) - 1 - cl->hdr_len);
+		memcpy(cl->hdr + cl->hdr_len, data, copy);
+		cl->hdr_len += copy;
+		cl->hdr[cl->hdr_len] = 0;
+		end = strstr(cl->hdr, "\r\n\r\n");
+		if (!end) {
+			if (cl->hdr_len == sizeof(cl->hdr) - 1) nb_errors++;
+			return GF_FALSE;
+		}
+		cl->hdr_size = (u32) (end + 4 - cl->hdr);
+		if (strncmp(cl->hdr, "HTTP/1.1 200", 12) && strncmp(cl->hdr, "HTTP/1.1 206", 12))
+			nb_errors++;
+		cl_hdr = strstr(cl->hdr, "Content-Length: ");
+		if (!cl_hdr) cl_hdr = strstr(cl->hdr, "content-length: ");
+		if (cl_hdr) sscanf(cl_hdr+16, LLU, &cl->body_size);
+		//body bytes received with the header
+		cl->body_recv = cl->hdr_len - cl->hdr_size;
+		//copy remaining bytes if header was truncated
+		if (copy < size) cl->body_recv += size - copy;
+	} else {
+		cl->body_recv += size;
+	}
+	if (cl->body_recv < cl->body_size) return GF_FALSE;
+	nb_bytes += cl->body_size;
+	return GF_TRUE;
+}
+
+static int cmp_lat(const void *a, const void *b)
+{
+	return (s32) (*(u32 *)a) - (s32) (*(u32 *)b);
+}
+
+static void usage()
+{
+	fprintf(stderr, "usage: httpbench [options] URL\n"
+		"URL: http://host:port/path of resource to fetch\n"
+		"-c N: number of concurrent persistent connections, default 100\n"
+		"-d N: duration of the test in seconds, default 10\n"
+	);
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, nb_conn=100, duration=10, port=80, req_len;
+	u64 start, now;
+	char *url=NULL, *sep, host[GF_MAX_IP_NAME_LEN], req[2048];
+	const char *path = "/";
+	u8 buf[65536];
+	HTTPClient *clients;
+	GF_SockGroup *sg;
+
+	for (i=1; i<(u32) argc; i++) {
+		if (!strcmp(argv[i], "-c") && (i+1<(u32) argc)) nb_conn = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-d") && (i+1<(u32) argc)) duration = atoi(argv[++i]);
+		else if (argv[i][0] != '-') url = argv[i];
+		else {
+			usage();
+			return 1;
+		}
+	}
+	if (!url || strncmp(url, "http://", 7) || !nb_conn) {
+		usage();
+		return 1;
+	}
+	strncpy(host, url+7, GF_MAX_IP_NAME_LEN-1);
+	host[GF_MAX_IP_NAME_LEN-1] = 0;
+	sep = strchr(host, '/');
+	if (sep) {
+		path = url + 7 + (sep - host);
+		sep[0] = 0;
+	}
+	sep = strchr(host, ':');
+	if (sep) {
+		port = atoi(sep+1);
+		sep[0] = 0;
+	}
+
+	gf_sys_init(GF_MemTrackerNone, NULL);
+	req_len = snprintf(req, sizeof(req), "GET %s HTTP/1.1\r\nHost: %s\r\nUser-Agent: httpbench\r\nConnection: keep-alive\r\n\r\n", path, host);
+
+	sg = gf_sk_group_new();
+	clients = gf_malloc(sizeof(HTTPClient) * nb_conn);
+	memset(clients, 0, sizeof(HTTPClient) * nb_conn);
+	for (i=0; i<nb_conn; i++) {
+		GF_Err e;
+		clients[i].sk = gf_sk_new(GF_SOCK_TYPE_TCP);
+		e = gf_sk_connect(clients[i].sk, host, port, NULL);
+		if (e) {
+			fprintf(stderr, "cannot connect client %d to %s:%d: %s\n", i, host, port, gf_error_to_string(e));
+			nb_conn = i;
+			gf_sk_del(clients[i].sk);
+			break;
+		}
+		gf_sk_set_block_mode(clients[i].sk, GF_TRUE);
+		gf_sk_group_register(sg, clients[i].sk);
+	}
+	fprintf(stderr, "running %d connections on %s:%d%s for %d seconds\n", nb_conn, host, port, path, duration);
+
+	start = gf_sys_clock_high_res();
+	for (i=0; i<nb_conn; i++)
+		send_request(&clients[i], req, req_len);
+
+	while (nb_conn) {
+		now = gf_sys_clock_high_res();
+		if (now - start > (u64) duration*1000000) break;
+
+		if (gf_sk_group_select(sg, 100000, GF_SK_SELECT_READ) != GF_OK)
+			continue;
+
+		for (i=0; i<nb_conn; i++) {
+			HTTPClient *cl = &clients[i];
+			if (!cl->sk || !gf_sk_group_sock_is_set(sg, cl->sk, GF_SK_SELECT_READ)) continue;
+
+			while (1) {
+				u32 read = 0;
+				GF_Err e = gf_sk_receive_no_select(cl->sk, buf, sizeof(buf), &read);
+				if ((e==GF_IP_SOCK_WOULD_BLOCK) || (e==GF_IP_NETWORK_EMPTY)) break;
+				if (e) {
+					gf_sk_group_unregister(sg, cl->sk);
+					gf_sk_del(cl->sk);
+					cl->sk = NULL;
+					nb_errors++;
+					break;
+				}
+				if (process_data(cl, buf, read)) {
+					request_done(cl);
+					send_request(cl, req, req_len);
+				}
+			}
+		}
+	}
+	now = gf_sys_clock_high_res() - start;
+
+	if (nb_lats) {
+		qsort(lats, nb_lats, sizeof(u32), cmp_lat);
+		fprintf(stderr, "%d requests in %.3f s - %.1f req/s - %.2f MB/s - %d errors\n", nb_lats, ((Double) now) / 1000000, ((Double) nb_lats) * 1000000 / now, ((Double) nb_bytes) / now, nb_errors);
+		fprintf(stderr, "latency: min %.3f ms - p50 %.3f ms - p99 %.3f ms - max %.3f ms\n", ((Double) lats[0]) / 1000, ((Double) lats[nb_lats/2]) / 1000, ((Double) lats[(u32) (nb_lats*0.99)]) / 1000, ((Double) lats[nb_lats-1]) / 1000);
+	} else {
+		fprintf(stderr, "no request completed - %d errors\n", nb_errors);
+	}
+
+	for (i=0; i<nb_conn; i++) {
+		if (!clients[i].sk) continue;
+		gf_sk_group_unregister(sg, clients[i].sk);
+		gf_sk_del(clients[i].sk);
+	}
+	gf_free(clients);
+	if (lats) gf_free(lats);
+	gf_sk_group_del(sg);
+	gf_sys_close();
+	return 0;
+}
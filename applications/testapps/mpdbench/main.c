@@ -0,0 +1,234 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom Paris 2022
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / MPD serialization benchmark
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*measures the cost of rewriting a live MPD and its HLS playlists with large timeshift buffers, as done by the dasher on each segment*/
+
+#include <gpac/tools.h>
+#include <gpac/xml.h>
+#include <gpac/mpd.h>
+
+static const char *mpd_skel_start = "<MPD xmlns=\"urn:mpeg:dash:schema:mpd:2011\" type=\"dynamic\" availabilityStartTime=\"2022-01-01T00:00:00Z\" minBufferTime=\"PT2S\" profiles=\"urn:mpeg:dash:profile:isoff-live:2011\">\n"
+	"<Period id=\"P1\" start=\"PT0S\">\n"
+	"<AdaptationSet segmentAlignment=\"true\" startWithSAP=\"1\">\n";
+static const char *mpd_skel_rep = "<Representation id=\"%d\" mimeType=\"video/mp4\" codecs=\"avc1.640028\" bandwidth=\"%d\" width=\"1280\" height=\"720\">\n"
+	"<SegmentTemplate timescale=\"1000\" media=\"rep%d_$Time$.m4s\" initialization=\"rep%d_init.mp4\">\n"
+	"<SegmentTimeline><S t=\"0\" d=\"1000\"/></SegmentTimeline>\n"
+	"</SegmentTemplate>\n"
+	"</Representation>\n";
+static const char *mpd_skel_end = "</AdaptationSet>\n</Period>\n</MPD>\n";
+
+//alternate durations so that timeline entries never merge in a repeat count
+static u32 get_seg_dur(u32 seg_num)
+{
+	return 998 + 2 * (seg_num % 3);
+}
+
+static GF_Err push_segment(GF_MPD_Representation *rep, u32 seg_num, u64 time)
+{
+	char szName[100];
+	GF_MPD_SegmentTimelineEntry *ent;
+	GF_DASH_SegmentContext *sctx;
+
+	GF_SAFEALLOC(ent, GF_MPD_SegmentTimelineEntry);
+	GF_SAFEALLOC(sctx, GF_DASH_SegmentContext);
+	if (!ent || !sctx) return GF_OUT_OF_MEM;
+	ent->start_time = time;
+	ent->duration = get_seg_dur(seg_num);
+	gf_list_add(rep->segment_template->segment_timeline->entries, ent);
+
+	sprintf(szName, "rep%s_"LLU".m4s", rep->id, time);
+	sctx->time = time;
+	sctx->dur = ent->duration;
+	sctx->seg_num = seg_num;
+	sctx->filename = gf_strdup(szName);
+	return gf_list_add(rep->state_seg_list, sctx);
+}
+
+static void pop_segment(GF_MPD_Representation *rep)
+{
+	GF_DASH_SegmentContext *sctx = gf_list_pop_front(rep->state_seg_list);
+	gf_free(gf_list_pop_front(rep->segment_template->segment_timeline->entries));
+	if (!sctx) return;
+	if (sctx->filename) gf_free(sctx->filename);
+	gf_free(sctx);
+}
+
+//chains the hash of a file to the hash of all previous outputs
+static void hash_file(u8 digest[2*GF_SHA1_DIGEST_SIZE], FILE *f)
+{
+	gf_sha1_file_ptr(f, digest + GF_SHA1_DIGEST_SIZE);
+	gf_sha1_csum(digest, 2*GF_SHA1_DIGEST_SIZE, digest);
+}
+
+static void usage()
+{
+	fprintf(stderr, "usage: mpdbench [options]\n"
+		"-reps N: number of representations, default 20\n"
+		"-tsb N: number of segments in the timeshift buffer, default 7200\n"
+		"-n N: number of manifest updates, default 50\n"
+		"-out DIR: directory for the output manifests, default is the temp directory\n"
+	);
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, j, nb_reps=20, tsb=7200, nb_updates=50, skel_len;
+	const char *out_dir = NULL;
+	char *skel, szMPD[GF_MAX_PATH], szM3U8[GF_MAX_PATH];
+	u64 mpd_time=0, m3u8_time=0, time=0;
+	u32 seg_num = 1;
+	u8 digest[2*GF_SHA1_DIGEST_SIZE];
+	GF_DOMParser *parser;
+	GF_MPD *mpd;
+	GF_MPD_Period *period;
+	GF_MPD_AdaptationSet *as;
+	GF_MPD_Representation *rep;
+	GF_Err e;
+
+	for (i=1; i<(u32) argc; i++) {
+		if (!strcmp(argv[i], "-reps") && (i+1<(u32) argc)) nb_reps = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-tsb") && (i+1<(u32) argc)) tsb = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-n") && (i+1<(u32) argc)) nb_updates = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-out") && (i+1<(u32) argc)) out_dir = argv[++i];
+		else {
+			usage();
+			return 1;
+		}
+	}
+	if (!nb_reps || !tsb || !nb_updates) {
+		usage();
+		return 1;
+	}
+
+	gf_sys_init(GF_MemTrackerNone, NULL);
+	if (!out_dir) out_dir = gf_get_default_cache_directory();
+	snprintf(szMPD, GF_MAX_PATH, "%s/mpdbench.mpd", out_dir);
+	snprintf(szM3U8, GF_MAX_PATH, "%s/mpdbench.m3u8", out_dir);
+
+	skel_len = (u32) (strlen(mpd_skel_start) + strlen(mpd_skel_end) + nb_reps * (strlen(mpd_skel_rep) + 40) + 1);
+	skel = gf_malloc(skel_len);
+	strcpy(skel, mpd_skel_start);
+	for (i=0; i<nb_reps; i++) {
+		u32 len = (u32) strlen(skel);
+		snprintf(skel + len, skel_len - len, mpd_skel_rep, i+1, 1000000 * (i+1), i+1, i+1);
+	}
+	strcat(skel, mpd_skel_end);
+
+	mpd = gf_mpd_new();
+	parser = gf_xml_dom_new();
+	e = gf_xml_dom_parse_string(parser, skel);
+	if (!e) e = gf_mpd_init_from_dom(gf_xml_dom_get_root(parser), mpd, szMPD);
+	gf_xml_dom_del(parser);
+	gf_free(skel);
+	if (e) {
+		fprintf(stderr, "failed to setup MPD: %s\n", gf_error_to_string(e));
+		gf_mpd_del(mpd);
+		gf_sys_close();
+		return 1;
+	}
+
+	if (!mpd->xml_namespace) mpd->xml_namespace = "urn:mpeg:dash:schema:mpd:2011";
+	period = gf_list_get(mpd->periods, 0);
+	as = gf_list_get(period->adaptation_sets, 0);
+	//replace parsed timelines with the segment state of a dasher running for tsb segments
+	i=0;
+	while ((rep = gf_list_enum(as->representations, &i))) {
+		GF_MPD_SegmentTimelineEntry *ent;
+		while ((ent = gf_list_pop_back(rep->segment_template->segment_timeline->entries)))
+			gf_free(ent);
+		rep->state_seg_list = gf_list_new();
+		rep->timescale = rep->timescale_mpd = 1000;
+		rep->dash_dur.num = rep->dash_dur.den = 1;
+	}
+	for (j=0; j<tsb; j++) {
+		i=0;
+		while ((rep = gf_list_enum(as->representations, &i))) {
+			e = push_segment(rep, seg_num, time);
+			if (e) break;
+		}
+		time += get_seg_dur(seg_num);
+		seg_num++;
+	}
+	mpd->time_shift_buffer_depth = tsb * 1000;
+
+	memset(digest, 0, sizeof(digest));
+	for (j=0; (j<nb_updates) && !e; j++) {
+		u64 start;
+		FILE *f;
+
+		i=0;
+		while ((rep = gf_list_enum(as->representations, &i))) {
+			pop_segment(rep);
+			e = push_segment(rep, seg_num, time);
+			if (e) break;
+		}
+		time += get_seg_dur(seg_num);
+		seg_num++;
+		//fixed publish time for reproducible output
+		mpd->publishTime = 1640995200000 + time;
+
+		start = gf_sys_clock_high_res();
+		e = gf_mpd_write_file(mpd, szMPD);
+		mpd_time += gf_sys_clock_high_res() - start;
+		if (e) break;
+
+		f = gf_fopen(szM3U8, "wb");
+		if (!f) {
+			e = GF_IO_ERR;
+			break;
+		}
+		start = gf_sys_clock_high_res();
+		e = gf_mpd_write_m3u8_master_playlist(mpd, f, szM3U8, period);
+		m3u8_time += gf_sys_clock_high_res() - start;
+		gf_fclose(f);
+		if (e) break;
+
+		f = gf_fopen(szMPD, "rb");
+		if (f) {
+			hash_file(digest, f);
+			gf_fclose(f);
+		}
+		i=0;
+		while ((rep = gf_list_enum(as->representations, &i))) {
+			if (rep->m3u8_var_file) hash_file(digest, rep->m3u8_var_file);
+		}
+	}
+
+	if (e) {
+		fprintf(stderr, "manifest update failed: %s\n", gf_error_to_string(e));
+	} else {
+		fprintf(stderr, "%d updates of %d representations with %d segments\n", nb_updates, nb_reps, tsb);
+		fprintf(stderr, "MPD : %.3f ms per update\n", ((Double) mpd_time) / nb_updates / 1000);
+		fprintf(stderr, "M3U8: %.3f ms per update\n", ((Double) m3u8_time) / nb_updates / 1000);
+		fprintf(stderr, "output hash: ");
+		for (i=0; i<GF_SHA1_DIGEST_SIZE; i++) fprintf(stderr, "%02x", digest[i]);
+		fprintf(stderr, "\n");
+	}
+	gf_file_delete(szMPD);
+	gf_file_delete(szM3U8);
+	gf_mpd_del(mpd);
+	gf_sys_close();
+	return e ? 1 : 0;
+}
@@ -0,0 +1,234 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom Paris 2022
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / NAL parsing benchmark
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*compares start code lookup and emulation prevention byte removal/insertion against byte-wise reference implementations*/
+
+#include <gpac/tools.h>
+#include <gpac/bitstream.h>
+#include <gpac/avparse.h>
+#include <gpac/internal/media_dev.h>
+
+/*byte-wise reference implementations*/
+static u32 ref_next_start_code(const u8 *data, u32 data_len, u32 *sc_size)
+{
+	u32 v = 0xffffffff, bpos = 0;
+	while (bpos < data_len) {
+		v = ((v << 8) & 0xFFFFFF00) | ((u32) data[bpos]);
+		bpos++;
+		if (v == 0x00000001) {
+			*sc_size = 4;
+			return bpos - 4;
+		}
+		else if ((v & 0x00FFFFFF) == 0x00000001) {
+			*sc_size = 3;
+			return bpos - 3;
+		}
+	}
+	return data_len;
+}
+
+static u32 ref_remove_emulation_bytes(const u8 *buffer_src, u8 *buffer_dst, u32 nal_size)
+{
+	u32 i = 0, emulation_bytes_count = 0;
+	u8 num_zero = 0;
+	while (i < nal_size) {
+		if ((num_zero == 2) && (buffer_src[i] == 0x03) && (i + 1 < nal_size) && (buffer_src[i + 1] < 0x04)) {
+			num_zero = 0;
+			emulation_bytes_count++;
+			i++;
+		}
+		buffer_dst[i - emulation_bytes_count] = buffer_src[i];
+		if (!buffer_src[i]) num_zero++;
+		else num_zero = 0;
+		i++;
+	}
+	return nal_size - emulation_bytes_count;
+}
+
+static u32 ref_add_emulation_bytes(const u8 *buffer_src, u8 *buffer_dst, u32 nal_size)
+{
+	u32 i = 0, emulation_bytes_count = 0;
+	u8 num_zero = 0;
+	while (i < nal_size) {
+		if ((num_zero == 2) && (buffer_src[i] < 0x04)) {
+			num_zero = 0;
+			buffer_dst[i + emulation_bytes_count] = 0x03;
+			emulation_bytes_count++;
+			if (!buffer_src[i]) num_zero = 1;
+		} else {
+			if (!buffer_src[i]) num_zero++;
+			else num_zero = 0;
+		}
+		buffer_dst[i + emulation_bytes_count] = buffer_src[i];
+		i++;
+	}
+	return nal_size + emulation_bytes_count;
+}
+
+static void ref_skip_bytes(GF_BitStream *bs, u32 nb_bytes)
+{
+	while (nb_bytes) {
+		gf_bs_read_u8(bs);
+		nb_bytes--;
+	}
+}
+
+static u64 bench_start_codes(const u8 *data, u32 size, Bool use_ref, u32 *nb_nals)
+{
+	u32 pos = 0, sc_size = 0;
+	u64 now = gf_sys_clock_high_res();
+	*nb_nals = 0;
+	while (pos < size) {
+		u32 next = use_ref ? ref_next_start_code(data + pos, size - pos, &sc_size) : gf_media_nalu_next_start_code(data + pos, size - pos, &sc_size);
+		if (next == size - pos) break;
+		(*nb_nals)++;
+		pos += next + sc_size;
+	}
+	return gf_sys_clock_high_res() - now;
+}
+
+static u64 bench_epb(const u8 *data, u32 size, u8 *dst, Bool add, Bool use_ref, u32 *out_size)
+{
+	u64 now = gf_sys_clock_high_res();
+	if (add) {
+		*out_size = use_ref ? ref_add_emulation_bytes(data, dst, size) : gf_media_nalu_add_emulation_bytes(data, dst, size);
+	} else {
+		*out_size = use_ref ? ref_remove_emulation_bytes(data, dst, size) : gf_media_nalu_remove_emulation_bytes(data, dst, size);
+	}
+	return gf_sys_clock_high_res() - now;
+}
+
+static u64 bench_skip(const u8 *data, u32 size, Bool use_ref, u64 *end_pos)
+{
+	u64 now;
+	GF_BitStream *bs = gf_bs_new(data, size, GF_BITSTREAM_READ);
+	gf_bs_enable_emulation_byte_removal(bs, GF_TRUE);
+	now = gf_sys_clock_high_res();
+	//skip by blocks, as done when skipping slice data
+	while (gf_bs_available(bs) > 1000) {
+		if (use_ref) ref_skip_bytes(bs, 997);
+		else gf_bs_skip_bytes(bs, 997);
+	}
+	now = gf_sys_clock_high_res() - now;
+	*end_pos = gf_bs_get_position(bs);
+	gf_bs_del(bs);
+	return now;
+}
+
+static void usage()
+{
+	fprintf(stderr, "usage: nalbench [options]\n"
+		"-i file: use the given file (Annex B bitstream or any binary file) rather than random data\n"
+		"-size N: size in MB of random data, default 64\n"
+		"-zeros N: probability in percent of zero bytes in random data, default 5\n"
+		"-loops N: number of loops for each test, default 5\n"
+	);
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, size = 64, zeros = 5, loops = 5, sizes[2], nb_nals[2];
+	u64 times[2], pos[2];
+	Bool ok = GF_TRUE;
+	const char *src = NULL;
+	u8 *data, *dst[2];
+
+	for (i=1; i<(u32) argc; i++) {
+		if (!strcmp(argv[i], "-i") && (i+1<(u32) argc)) src = argv[++i];
+		else if (!strcmp(argv[i], "-size") && (i+1<(u32) argc)) size = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-zeros") && (i+1<(u32) argc)) zeros = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-loops") && (i+1<(u32) argc)) loops = atoi(argv[++i]);
+		else {
+			usage();
+			return 1;
+		}
+	}
+	if (!loops) loops = 1;
+	nb_nals[0] = nb_nals[1] = sizes[0] = sizes[1] = 0;
+	pos[0] = pos[1] = 0;
+	gf_sys_init(GF_MemTrackerNone, NULL);
+
+	if (src) {
+		u32 fsize;
+		if (gf_file_load_data(src, &data, &fsize) != GF_OK) {
+			fprintf(stderr, "cannot load %s\n", src);
+			gf_sys_close();
+			return 1;
+		}
+		size = fsize;
+	} else {
+		size *= 1024*1024;
+		data = gf_malloc(size);
+		gf_rand_init(GF_FALSE);
+		for (i=0; i<size; i++) {
+			u32 r = gf_rand();
+			data[i] = ((r % 100) < zeros) ? 0 : (u8) (1 + (r>>8) % 255);
+		}
+	}
+	dst[0] = gf_malloc(size*3/2 + 16);
+	dst[1] = gf_malloc(size*3/2 + 16);
+
+	fprintf(stderr, "testing %u bytes, %u loops\n", size, loops);
+	times[0] = times[1] = 0;
+	for (i=0; i<loops; i++) {
+		times[0] += bench_start_codes(data, size, GF_TRUE, &nb_nals[0]);
+		times[1] += bench_start_codes(data, size, GF_FALSE, &nb_nals[1]);
+	}
+	if (nb_nals[0] != nb_nals[1]) ok = GF_FALSE;
+	fprintf(stderr, "start codes (%u NALs): reference "LLU" us - gpac "LLU" us\n", nb_nals[0], times[0]/loops, times[1]/loops);
+
+	times[0] = times[1] = 0;
+	for (i=0; i<loops; i++) {
+		times[0] += bench_epb(data, size, dst[0], GF_FALSE, GF_TRUE, &sizes[0]);
+		times[1] += bench_epb(data, size, dst[1], GF_FALSE, GF_FALSE, &sizes[1]);
+	}
+	if ((sizes[0] != sizes[1]) || memcmp(dst[0], dst[1], sizes[0])) ok = GF_FALSE;
+	if (gf_media_nalu_emulation_bytes_remove_count(data, size) != size - sizes[0]) ok = GF_FALSE;
+	fprintf(stderr, "EPB removal (%u bytes removed): reference "LLU" us - gpac "LLU" us\n", size - sizes[0], times[0]/loops, times[1]/loops);
+
+	times[0] = times[1] = 0;
+	for (i=0; i<loops; i++) {
+		times[0] += bench_epb(data, size, dst[0], GF_TRUE, GF_TRUE, &sizes[0]);
+		times[1] += bench_epb(data, size, dst[1], GF_TRUE, GF_FALSE, &sizes[1]);
+	}
+	if ((sizes[0] != sizes[1]) || memcmp(dst[0], dst[1], sizes[0])) ok = GF_FALSE;
+	if (gf_media_nalu_emulation_bytes_add_count(data, size) != sizes[0] - size) ok = GF_FALSE;
+	fprintf(stderr, "EPB insertion (%u bytes added): reference "LLU" us - gpac "LLU" us\n", sizes[0] - size, times[0]/loops, times[1]/loops);
+
+	times[0] = times[1] = 0;
+	for (i=0; i<loops; i++) {
+		times[0] += bench_skip(data, size, GF_TRUE, &pos[0]);
+		times[1] += bench_skip(data, size, GF_FALSE, &pos[1]);
+	}
+	if (pos[0] != pos[1]) ok = GF_FALSE;
+	fprintf(stderr, "EPB-aware skip: reference "LLU" us - gpac "LLU" us\n", times[0]/loops, times[1]/loops);
+
+	fprintf(stderr, "results %s\n", ok ? "identical" : "MISMATCH");
+	gf_free(data);
+	gf_free(dst[0]);
+	gf_free(dst[1]);
+	gf_sys_close();
+	return ok ? 0 : 1;
+}
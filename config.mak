@@ -0,0 +1,152 @@
+# Automatically generated by configure - do not modify
+GPAC_CONFIGURATION=
+prefix=/usr/local
+DESTDIR=
+moddir=gpac
+tinygl_target_bin_dir=-gcc
+MAKE=make
+CC=@gcc
+AR=@ar
+RANLIB=@ranlib
+STRIP=@strip
+WINDRES=windres
+INSTALL=install
+LIBTOOL=libtool
+INSTFLAGS=-p
+OPTFLAGS=-O3  -Wall -fno-strict-aliasing -Wno-pointer-sign -fPIC -DPIC -msse2 -DNDEBUG -Wno-deprecated -Wno-deprecated-declarations -Wno-int-in-bool-context -DGPAC_HAVE_CONFIG_H -I"/root/repo" -fvisibility="hidden"
+CXXFLAGS= -Wall -fno-strict-aliasing -fPIC -DPIC
+LDFLAGS= -Wl,--warn-common -Wl,-z,defs
+SHFLAGS=-shared
+lib_dir=lib
+man_dir=share/man
+STATIC_MODULES=no
+EXTRALIBS=-lm
+VERSION=1.1.0-DEV
+VERSION_MAJOR=10
+VERSION_SONAME=10.4.0
+CONFIG_LINUX=yes
+CONFIG_OS=CONFIG_LINUX
+GPAC_SH_FLAGS=-lpthread -llzma
+EXE_SUFFIX=
+DYN_LIB_SUFFIX=.so
+INSTFLAGS=
+CONFIG_JS=yes
+CONFIG_ZLIB=system
+CONFIG_FT=system
+CONFIG_JPEG=system
+jpeg_cflags=
+jpeg_lflags=
+CONFIG_PNG=system
+CONFIG_VTB=no
+CONFIG_LZMA=yes
+CONFIG_JP2=no
+CONFIG_FAAD=no
+CONFIG_MAD=no
+CONFIG_XVID=no
+CONFIG_OGG=no
+CONFIG_VORBIS=no
+CONFIG_THEORA=no
+CONFIG_FFMPEG=no
+DISABLE_DASHCAST=yes
+CONFIG_FFMPEG_OLD=yes
+CONFIG_OSS_AUDIO=yes
+CONFIG_ALSA=no
+CONFIG_JACK=no
+CONFIG_A52=no
+CONFIG_PULSEAUDIO=no
+CONFIG_FREENECT=no
+DISABLE_PLAYER=no
+DISABLE_STREAMING=no
+DISABLE_SVG=no
+DISABLE_LASER=no
+DISABLE_SAF=no
+DISABLE_BIFS=no
+DISABLE_SENG=no
+DISABLE_LOADER_ISOFF=no
+DISABLE_LOADER_BT=no
+DISABLE_LOADER_XMT=no
+DISABLE_LOADER_QTVR=no
+DISABLE_LOADER_SWF=no
+DISABLE_SCENE_STATS=no
+DISABLE_SCENE_DUMP=no
+DISABLE_SCENE_ENCODE=no
+DISABLE_SCENEGRAPH=no
+DISABLE_CRYPTO=no
+DISABLE_DVBX=yes
+DISABLE_AVILIB=no
+DISABLE_M2PS=no
+DISABLE_OGG=no
+DISABLE_ISOFF=no
+DISABLE_ISOFF_HINT=no
+DISABLE_VOBSUB=no
+DISABLE_TTXT=no
+DISABLE_TTML=no
+DISABLE_SMGR=no
+DISABLE_AV_PARSERS=no
+DISABLE_MEDIA_IMPORT=no
+DISABLE_MEDIA_EXPORT=no
+DISABLE_MPD=no
+DISABLE_DASH_CLIENT=no
+DISABLE_CORE_TOOLS=no
+DISABLE_OD_DUMP=no
+DISABLE_OD_PARSE=no
+MINIMAL_OD=no
+DISABLE_ISOM_ADOBE=no
+DISABLE_VRML=no
+DISABLE_ROUTE=no
+DISABLE_CRYPTO=no
+DISABLE_M2TS_MUX=no
+DISABLE_M2TS=no
+GPAC_USE_TINYGL=no
+OGL_INCLS=
+HAS_OPENGL=yes
+OGL_LIBS=-lGL -lGLU -lX11
+ENABLE_JOYSTICK=no
+HAS_OPENSSL=yes
+SSL_LIBS=-lssl -lcrypto
+HAS_HTTP2=no
+CONFIG_SDL=no
+FT_CFLAGS=-I/usr/include/freetype2 -I/usr/include/libpng16 
+FT_LIBS=-lfreetype 
+CONFIG_AMR_NB=no
+CONFIG_AMR_NB_FT=no
+CONFIG_AMR_WB_FT=no
+DEBUGBUILD=no
+GPROFBUILD=no
+MP4BOX_STATIC=no
+STATICBUILD=no
+CONFIG_IPV6=yes
+CONFIG_PLATINUM=no
+CONFIG_AVCAP=no
+CONFIG_OPENSVC=no
+CONFIG_OPENHEVC=no
+MOZILLA_DIR=local
+LINUX_DVB=yes
+OSS_INC_TYPE=yes
+OSS_CFLAGS=
+OSS_LDFLAGS=
+CONFIG_DIRECTFB=no
+DIRECTFB_INC_PATH=/usr/include/directfb
+DIRECTFB_LIB=-ldirectfb -lfusion -ldirect
+CONFIG_X11=yes
+USE_X11_SHM=yes
+CONFIG_HID=no
+HID_LDFLAGS=
+X11_LIB_PATH=/usr/X11R6/lib64
+X11_INC_PATH=/usr/X11R6/include
+RENOIR_ENABLE=no
+GPAC_ENST=no
+GPAC_ENST_INC=no
+SRC_LOCAL_PATH=yes
+SRC_PATH=/root/repo
+BUILD_PATH=/root/repo
+LOCAL_INC_PATH=/root/repo/extra_lib/include
+%.opic : %.c
+	@echo "  CC $<"
+	$(CC) $(CFLAGS) $(PIC_CFLAGS) -c $< -o $@
+%.o : %.c
+	@echo "  CC $<"
+	$(CC) $(CFLAGS) -c -o $@ $<
+%.o: %.cpp
+	@echo "  CC $<"
+	$(CXX) $(CFLAGS) -c -o $@ $<
@@ -590,6 +590,17 @@ Enables or disable emulation byte prevention for AVC and HEVC annex B formats in
  */
 void gf_bs_enable_emulation_byte_removal(GF_BitStream *bs, Bool do_remove);
 
+/*!
+\brief Zero pair lookup
+
+Finds the first occurence of two zero bytes followed by a byte lower than or equal to max_next, as used by NAL start codes (0x000001) and emulation prevention bytes (0x000003). SIMD instructions (SSE2, AVX2 or NEON) are used when supported by the CPU.
+\param data the buffer to inspect
+\param size the size of the buffer
+\param max_next maximum value of the byte following the two zero bytes
+\return the position of the first zero byte of the pattern, or size if not found
+ */
+u32 gf_bs_find_zero_pair(const u8 *data, u32 size, u8 max_next);
+
 /*!
 \brief Inserts a data block, moving bytes to the end
 
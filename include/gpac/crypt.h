@@ -142,6 +142,101 @@ GF_Err gf_crypt_encrypt(GF_Crypt *gfc, void *plaintext, u32 size);
 GF_Err gf_crypt_decrypt(GF_Crypt *gfc, void *ciphertext, u32 size);
 
 
+/*! byte range processed by a crypto job*/
+typedef struct
+{
+	/*! offset of the range in the job buffer*/
+	u32 offset;
+	/*! size of the range in bytes*/
+	u32 size;
+	/*! number of 16-bytes blocks processed in pattern mode, 0 if no pattern*/
+	u32 crypt_blocks;
+	/*! number of 16-bytes blocks left untouched in pattern mode, 0 if no pattern*/
+	u32 skip_blocks;
+	/*! if set, the job IV is restored before processing this range (constant IV in CBC mode)*/
+	Bool reset_IV;
+} GF_CryptRange;
+
+/*! crypto job, describing the ranges of a buffer to encrypt or decrypt with a given key and IV.
+A job does not share any state with other jobs, and can therefore be processed by any thread of a crypto pool*/
+typedef struct
+{
+	/*! chaining mode of the job*/
+	GF_CRYPTO_MODE mode;
+	/*! if set, job is a decryption job, otherwise an encryption job*/
+	Bool decrypt;
+	/*! key to use*/
+	bin128 key;
+	/*! IV at job start, 16 bytes in CBC mode or 17 bytes in CTR mode (see \ref gf_crypt_set_IV)*/
+	u8 IV[17];
+	/*! size of the IV, 0 to keep the current state of the crypto context (only allowed for \ref gf_crypt_job_run)*/
+	u32 IV_size;
+	/*! buffer to process inplace*/
+	u8 *data;
+	/*! ranges to process, in processing order*/
+	GF_CryptRange *ranges;
+	/*! number of ranges to process*/
+	u32 nb_ranges;
+	/*! number of allocated ranges*/
+	u32 nb_alloc_ranges;
+	/*! set to the job error once processed*/
+	GF_Err e;
+	/*! private - do not use*/
+	u32 state;
+} GF_CryptJob;
+
+/*! appends a range to a crypto job
+\param job the target crypto job
+\param offset the offset of the range in the job buffer
+\param size the size of the range
+\param crypt_blocks the number of encrypted 16-bytes blocks in pattern mode, 0 if no pattern
+\param skip_blocks the number of clear 16-bytes blocks in pattern mode, 0 if no pattern
+\param reset_IV if set, the job IV is restored before processing this range
+\return error if any
+*/
+GF_Err gf_crypt_job_add_range(GF_CryptJob *job, u32 offset, u32 size, u32 crypt_blocks, u32 skip_blocks, Bool reset_IV);
+
+/*! resets a crypto job, keeping allocated ranges for later usage
+\param job the target crypto job
+*/
+void gf_crypt_job_reset(GF_CryptJob *job);
+
+/*! processes a crypto job using a given crypto context. The key of the context is not modified.
+\param gfc the crypto context to use, already initialized with the job key
+\param job the crypto job to process
+\return error if any
+*/
+GF_Err gf_crypt_job_run(GF_Crypt *gfc, GF_CryptJob *job);
+
+/*! crypto worker pool object*/
+typedef struct __gf_crypt_pool GF_CryptPool;
+
+/*! creates a new pool of crypto workers
+\param nb_threads number of worker threads to use
+\return a new crypto pool, or NULL if error
+*/
+GF_CryptPool *gf_crypt_pool_new(u32 nb_threads);
+
+/*! destroys a crypto pool. All pending jobs are processed before the workers exit
+\param pool the target crypto pool
+*/
+void gf_crypt_pool_del(GF_CryptPool *pool);
+
+/*! posts a job to a crypto pool. The job must not be modified until it is completed, and its IV size must not be 0
+\param pool the target crypto pool
+\param job the crypto job to process
+\return error if any
+*/
+GF_Err gf_crypt_pool_post(GF_CryptPool *pool, GF_CryptJob *job);
+
+/*! checks if a job is completed
+\param pool the target crypto pool
+\param job the crypto job to check
+\param wait if set, blocks until the job is completed
+\return GF_TRUE if job is completed, GF_FALSE otherwise
+*/
+Bool gf_crypt_pool_job_done(GF_CryptPool *pool, GF_CryptJob *job, Bool wait);
+
 /*! @} */
 
 
@@ -493,6 +493,18 @@ GF_Err gf_dash_group_get_next_segment_location(GF_DashClient *dash, u32 group_id
 */
 GF_Err gf_dash_group_next_seg_info(GF_DashClient *dash, u32 group_idx, const char **seg_name, u32 *seg_number, GF_Fraction64 *seg_time, u32 *seg_dur_ms, const char **init_segment);
 
+/*! gets a segment queued for download after the segment currently being played, as set up by \ref gf_dash_set_prefetch
+\param dash the target dash client
+\param group_idx the 0-based index of the target group
+\param seg_idx the 0-based index of the segment in the download queue, 0 being the segment returned by \ref gf_dash_group_get_next_segment_location
+\param url set to the URL of the segment
+\param start_range set to the start of the byte range of the segment, 0 if none - optional, may be NULL
+\param end_range set to the end of the byte range of the segment, 0 if none - optional, may be NULL
+\param seg_time set to the segment start time - optional, may be NULL
+\return error if any, GF_EOS if no segment at this position in the queue, GF_URL_REMOVED if the segment is disabled
+*/
+GF_Err gf_dash_group_get_prefetch_segment(GF_DashClient *dash, u32 group_idx, u32 seg_idx, const char **url, u64 *start_range, u64 *end_range, GF_Fraction64 *seg_time);
+
 /*! checks if loop was detected in playback. This is mostly used for broadcast (eMBMS, ROUTE) based on pcap replay.
 \param dash the target dash client
 \param group_idx the 0-based index of the target group
@@ -698,6 +710,58 @@ void gf_dash_set_low_latency_mode(GF_DashClient *dash, GF_DASHLowLatencyMode low
 */
 void gf_dash_set_user_buffer(GF_DashClient *dash, u32 buffer_time_ms);
 
+/*! sets the number of media segments to resolve ahead of the segment being played in each group, so that the user can fetch them in parallel using \ref gf_dash_group_get_prefetch_segment.
+ Segments queued ahead are dropped and resolved again whenever the rate adaptation selects a new representation. This is only used for groups without dependent representations or groups, and must be called before the manifest is opened.
+\param dash the target dash client
+\param nb_segments number of segments to queue ahead, 0 disables prefetch
+*/
+void gf_dash_set_prefetch(GF_DashClient *dash, u32 nb_segments);
+
+/*! manifest update mode of dash client for dynamic MPDs*/
+typedef enum
+{
+	/*! each refresh reloads the complete manifest*/
+	GF_DASH_MPD_UPDATE_FULL = 0,
+	/*! each refresh reloads the manifest and merges segment timelines in the active manifest when the structure is unchanged*/
+	GF_DASH_MPD_UPDATE_MERGE,
+	/*! same as GF_DASH_MPD_UPDATE_MERGE, but fetches the MPD patch advertized by PatchLocation when present*/
+	GF_DASH_MPD_UPDATE_PATCH,
+} GF_DASHManifestUpdateMode;
+
+/*! sets the manifest update mode. Updates always fall back to a complete reload if the manifest cannot be merged or patched
+\param dash the target dash client
+\param mode the manifest update mode
+*/
+void gf_dash_set_manifest_update_mode(GF_DashClient *dash, GF_DASHManifestUpdateMode mode);
+
+/*! manifest refresh statistics*/
+typedef struct
+{
+	/*! number of manifest refreshes processed, excluding refreshes with unchanged manifest*/
+	u32 nb_refresh;
+	/*! number of complete manifest reloads*/
+	u32 nb_full;
+	/*! number of manifest refreshes merged in the active manifest*/
+	u32 nb_merge;
+	/*! number of MPD patches applied*/
+	u32 nb_patch;
+	/*! parse time of the last refresh in microseconds*/
+	u64 last_parse_time;
+	/*! maximum parse time of a refresh in microseconds*/
+	u64 max_parse_time;
+	/*! cumulated parse time of all refreshes in microseconds*/
+	u64 total_parse_time;
+	/*! number of new segments in the last merged or patched refresh*/
+	u32 last_new_segments;
+} GF_DASHManifestStats;
+
+/*! gets manifest refresh statistics
+\param dash the target dash client
+\param stats filled with the manifest statistics
+\return error if any
+*/
+GF_Err gf_dash_get_manifest_stats(GF_DashClient *dash, GF_DASHManifestStats *stats);
+
 /*! indicates the number of segments to wait before switching up bandwidth. The default value is 1 (ie stay in current bandwidth or one more segment before switching up, event if download rate is enough).
 Setting this to 0 means the switch will happen instantly, but this is more prone to quality changes due to network variations
 \param dash the target dash client
@@ -494,6 +494,24 @@ Forces session to use memory storage for future downloads
  */
 void gf_dm_sess_force_memory_mode(GF_DownloadSession *sess, u32 force_cache_type);
 
+/*!
+\brief Sets session priority
+
+Sets the weight of the session requests when sent on a shared HTTP/2 connection. The running request, if any, is updated.
+\param sess the current session
+\param weight HTTP/2 stream weight between 1 and 256, higher values get more bandwidth. 0 restores the default weight (16)
+\return error if any, GF_NOT_SUPPORTED if HTTP/2 is not available
+ */
+GF_Err gf_dm_sess_set_priority(GF_DownloadSession *sess, u32 weight);
+
+/*!
+\brief Checks if session uses HTTP/2
+
+\param sess the current session
+\return GF_TRUE if the session is using an HTTP/2 connection
+ */
+Bool gf_dm_sess_is_h2(GF_DownloadSession *sess);
+
 /*!
 Registers a local cache provider (bypassing the http session), used when populating cache from input data (ROUTE for example)
 
@@ -200,7 +200,9 @@ typedef enum
 	/*! In this mode, the scheduler uses locks for packet and property queues even if single-threaded (test mode) */
 	GF_FS_SCHEDULER_LOCK_FORCE,
 	/*! In this mode, the scheduler uses direct dispatch and no threads, trying to nest task calls within task calls */
-	GF_FS_SCHEDULER_DIRECT
+	GF_FS_SCHEDULER_DIRECT,
+	/*! In this mode, the scheduler does not use locks for packet and property queues, and each secondary thread has its own task list. Filter tasks are posted to the task list of the thread which last processed the filter, and idle threads steal tasks from other threads. Defaults to lock-free if no threads are used */
+	GF_FS_SCHEDULER_WORK_STEAL
 } GF_FilterSchedulerType;
 
 /*! Flag set to indicate meta filters should be loaded. A meta filter is a filter providing various subfilters.
@@ -304,6 +306,32 @@ GF_Err gf_fs_set_max_resolution_chain_length(GF_FilterSession *session, u32 max_
 */
 GF_Err gf_fs_set_max_sleep_time(GF_FilterSession *session, u32 max_sleep);
 
+/*! Sets the CPU affinity of the session threads. This must be called before running the session.
+\param session filter session
+\param affinity CPU affinity of the threads. Can be:
+- "none": no affinity
+- "core": each extra thread is pinned to a single CPU, round-robin. The main thread is not pinned
+- "node": each extra thread is pinned to all CPUs of a NUMA node, round-robin. The main thread is not pinned
+- a list of CPU sets separated by '/', one per thread starting with the main thread and cycled through. Each CPU set is a comma-separated list of CPU indexes or ranges, eg "0-3,8/4-7"
+\return error if any
+*/
+GF_Err gf_fs_set_thread_affinity(GF_FilterSession *session, const char *affinity);
+
+/*! Starts a trace window of the session tasks. Tracing must be enabled for the session using the `-trace` option.
+Each executed task is recorded with its filter, thread, execution time, time spent in task lists and number of packets consumed and produced by the filter.
+At the end of the trace window, the trace is written as Chrome trace events in $TRACE.json and as folded stacks in $TRACE.folded, $TRACE being the value of the `-trace` option. Windows after the first one use $TRACE_N as base name, N being the window number.
+\param session filter session
+\param duration duration of the trace window in milliseconds. 0 means use the `-trace-dur` option, and if not set, trace until gf_fs_trace_stop is called or the session is destroyed
+\return error if any
+*/
+GF_Err gf_fs_trace_start(GF_FilterSession *session, u32 duration);
+
+/*! Stops the current trace window and writes the trace
+\param session filter session
+\return error if any
+*/
+GF_Err gf_fs_trace_stop(GF_FilterSession *session);
+
 /*! gets the maximum filter chain lengtG
 \param session filter session
 \return maximum chain length when resolving filter links.
@@ -595,6 +623,8 @@ typedef enum
 \param name name of filter option to update
 \param val value of filter option to update
 \param propagate_mask propagation flags - 0 means no propagation
+
+If both fid and filter are NULL and name is "trace", a trace window is started for the duration in milliseconds given by val (see \ref gf_fs_trace_start), or stopped if val is "stop".
 */
 void gf_fs_send_update(GF_FilterSession *session, const char *fid, GF_Filter *filter, const char *name, const char *val, GF_EventPropagateType propagate_mask);
 
@@ -1481,6 +1511,8 @@ typedef struct
 	u8 skip_cache_expiration;
 	/*! hint block size for source, might not be respected*/
 	u32 hint_block_size;
+	/*! fetch priority hint for source, used as HTTP/2 stream weight (1 to 256, higher is fetched first), 0 for default*/
+	u32 priority;
 } GF_FEVT_SourceSeek;
 
 /*! Event structure for GF_FEVT_SEGMENT_SIZE*/
@@ -2143,6 +2175,12 @@ struct _gf_ft_mgr *gf_filter_get_font_manager(GF_Filter *filter);
 */
 void gf_filter_ask_rt_reschedule(GF_Filter *filter, u32 us_until_next);
 
+/*! Checks if the task currently executed by the filter is the only task pending in the session. Filters waiting for external events (sockets, ...) may then block in their process function for a short while instead of asking for a real-time reschedule
+\param filter target filter
+\return GF_TRUE if no other task is pending in the session, GF_FALSE otherwise
+*/
+Bool gf_filter_is_last_task(GF_Filter *filter);
+
 /*! Posts a filter process task to the parent session. This is needed for some filters not having any input packets to process but still needing to work
 such as decoder flushes, servers, etc... The filter session will ignore this call if the filter is already scheduled for processing
 \param filter target filter
@@ -3592,6 +3630,15 @@ However, packets don't have to be sent in their allocation order.
 */
 GF_Err gf_filter_pck_send(GF_FilterPacket *pck);
 
+/*! Sends a set of packets on their output PIDs. This is equivalent to calling \ref gf_filter_pck_send for each packet in array order, but packets are queued to each destination in a single operation and the destination filters are scheduled once for the whole batch.
+Packets may belong to different output PIDs of the same filter. Packets on a given PID are dispatched in array order.
+Invalid entries are discarded and do not prevent the other packets from being sent; in that case the first error is returned. All packets in the array are either sent or destroyed when the function returns.
+\param pcks array of output packets to send
+\param nb_pcks number of packets in array
+\return error if any
+*/
+GF_Err gf_filter_pck_send_batch(GF_FilterPacket **pcks, u32 nb_pcks);
+
 /*! Destructs a packet allocated but that cannot be sent. Shall not be used on packet references.
 \param pck the target output packet to send
 */
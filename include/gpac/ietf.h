@@ -781,6 +781,14 @@ void gf_rtp_reset_ssrc(GF_RTPChannel *ch);
 */
 u32 gf_rtp_read_rtp(GF_RTPChannel *ch, u8 *buffer, u32 buffer_size);
 
+/*! reads several RTP packets on UDP only (not valid for TCP) in a single call without performing any select, to be used with socket groups. Performs re-ordering if configured for it
+\param ch the target RTP channel
+\param dgrams the datagram descriptors to fill, all payload buffers shall have the same allocated size. Upon return, datagrams may be swapped in the array
+\param nb_dgrams the number of datagram descriptors, at most \ref GF_SK_MAX_BATCH are used
+\return number of RTP packets available in dgrams
+*/
+u32 gf_rtp_read_rtp_batch(GF_RTPChannel *ch, GF_SockDatagram *dgrams, u32 nb_dgrams);
+
 /*! flushes any pending data in packet reorderer, but does not flush packet reorderer if reorderer timeout is not exceeded
 \param ch the target RTP channel
 \param buffer the buffer where to store the data
@@ -851,6 +859,26 @@ GF_Err gf_rtp_send_bye(GF_RTPChannel *ch);
 */
 GF_Err gf_rtp_send_packet(GF_RTPChannel *ch, GF_RTPHeader *rtp_hdr, u8 *pck, u32 pck_size, Bool fast_send);
 
+/*! enables batched sending of RTP packets on UDP. Packets are queued and sent in a single call when the batch is full, when \ref gf_rtp_flush_send is called or before sending RTCP packets. Must be called after \ref gf_rtp_initialize
+\param ch the target RTP channel
+\param nb_packets maximum number of packets per call, at most \ref GF_SK_MAX_BATCH. A value of 0 or 1 disables batching
+\return error if any
+*/
+GF_Err gf_rtp_set_send_batch(GF_RTPChannel *ch, u32 nb_packets);
+
+/*! sends all RTP packets pending in the batch
+\param ch the target RTP channel
+\return error if any
+*/
+GF_Err gf_rtp_flush_send(GF_RTPChannel *ch);
+
+/*! gets RTP sending statistics
+\param ch the target RTP channel
+\param nb_calls set to the number of socket send calls - may be NULL
+\param nb_packets set to the number of RTP packets sent - may be NULL
+*/
+void gf_rtp_get_send_stats(GF_RTPChannel *ch, u64 *nb_calls, u64 *nb_packets);
+
 
 /*! callback used for writing rtp over TCP
 \param cbk1 opaque user data
@@ -132,6 +132,12 @@ struct __tag_rtp_channel
 	u32 last_pck_ntp_sec, last_pck_ntp_frac;
 	u32 num_pck_sent, num_payload_bytes;
 	u32 forced_ntp_sec, forced_ntp_frac;
+	/*RTP packets pending for batched sending, one send buffer size per packet*/
+	u8 *batch_buffer;
+	GF_SockDatagram *batch;
+	u32 batch_max, nb_batch;
+	/*number of send calls and packets sent on RTP socket*/
+	u64 nb_send_calls, nb_send_pck;
 
 	Bool no_auto_rtcp;
 	/*RTCP info*/
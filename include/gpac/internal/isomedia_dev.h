@@ -31,6 +31,7 @@ extern "C" {
 #endif
 
 #include <gpac/isomedia.h>
+#include <gpac/thread.h>
 
 
 enum
@@ -864,6 +865,8 @@ typedef struct
 	GF_ISONaluExtractMode extractor_mode;
 	Bool has_base_layer;
 	u32 pack_num_samples;
+	/*private for file mapping: readahead window of the track*/
+	u64 map_advise_start, map_advise_end;
 
 	u64 magic;
 	u32 index;
@@ -1058,6 +1061,25 @@ typedef struct
 	u32 sampleDelta;
 } GF_SttsEntry;
 
+/*flattened sample table of a non-fragmented track, built in read mode for fast random access
+arrays which can be computed directly from the boxes (constant duration, one sample per chunk, ...) are not allocated*/
+typedef struct __tag_sample_table_index
+{
+	u32 nb_samples, nb_chunks;
+	/*1-based number of the first sample of each chunk*/
+	u32 *chunk_first_sample;
+	/*0-based index of the stsc entry describing each chunk*/
+	u32 *chunk_stsc_idx;
+	/*file offset of each sample, NULL if offsets are computed from chunk offsets*/
+	u64 *offsets;
+	/*decode time of each sample, NULL if all samples have the same duration*/
+	u64 *dts;
+	/*duration of the first and last samples (used when no dts array is present)*/
+	u32 first_delta, last_delta;
+	/*composition offset of each sample, NULL if no ctts*/
+	s32 *cts_offsets;
+} GF_SampleTableIndex;
+
 typedef struct
 {
 	GF_ISOM_FULL_BOX
@@ -1073,6 +1095,8 @@ typedef struct
 	u32 r_FirstSampleInEntry;
 	u32 r_currentEntryIndex;
 	u64 r_CurrentDTS;
+	/*flattened index owned by the parent stbl, may be NULL*/
+	GF_SampleTableIndex *r_index;
 
 	//stats for read
 	u32 max_ts_delta;
@@ -1100,6 +1124,8 @@ typedef struct
 	/*Cache for read*/
 	u32 r_currentEntryIndex;
 	u32 r_FirstSampleInEntry;
+	/*flattened index owned by the parent stbl, may be NULL*/
+	GF_SampleTableIndex *r_index;
 
 	//stats for read
 	s32 max_ts_delta;
@@ -1500,6 +1526,8 @@ static const u8 GF_ISOM_IPOD_EXT[][16] = { { 0x6B, 0x68, 0x40, 0xF2, 0x5F, 0x24,
 
 Bool gf_isom_is_nalu_based_entry(GF_MediaBox *mdia, GF_SampleEntryBox *_entry);
 GF_Err gf_isom_nalu_sample_rewrite(GF_MediaBox *mdia, GF_ISOSample *sample, u32 sampleNumber, GF_MPEGVisualSampleEntryBox *entry);
+/*returns GF_TRUE if gf_isom_nalu_sample_rewrite only inspects the sample payload (SAP type detection) without modifying it*/
+Bool gf_isom_nalu_sample_rewrite_is_inspect_only(GF_MediaBox *mdia, GF_MPEGVisualSampleEntryBox *entry);
 
 /*this is the default visual sdst (to handle unknown media)*/
 typedef struct
@@ -1812,6 +1840,8 @@ typedef struct
 	u32 r_LastSyncSample;
 	/*0-based index in the array*/
 	u32 r_LastSampleIndex;
+	/*set when sample numbers are known to be sorted, enables binary search*/
+	Bool r_sorted;
 } GF_SyncSampleBox;
 
 typedef struct
@@ -1979,6 +2009,11 @@ typedef struct
 	Bool no_sync_found;
 
 	u32 r_last_chunk_num, r_last_sample_num, r_last_offset_in_chunk;
+
+	/*flattened sample table index, NULL if not built*/
+	GF_SampleTableIndex *r_index;
+	/*build the index on first random access*/
+	Bool r_index_lazy;
 } GF_SampleTableBox;
 
 GF_Err stbl_AppendTrafMap(GF_SampleTableBox *stbl, Bool is_seg_start, u64 seg_start_offset, u64 frag_start_offset, u8 *moof_template, u32 moof_template_size, u64 sidx_start, u64 sidx_end);
@@ -3683,10 +3718,16 @@ typedef struct
 
 /*regular file IO*/
 #define GF_ISOM_DATA_FILE         0x01
+/*File Mapping object, read-only mode on complete local files (no download)*/
+#define GF_ISOM_DATA_FILE_MAPPING 0x02
 /*External file object. Needs implementation*/
 #define GF_ISOM_DATA_FILE_EXTERN  0x03
 /*regular memory IO*/
 #define GF_ISOM_DATA_MEM          0x04
+/*block of file data shared by sample payloads, used for coalesced reads (not a data map)*/
+#define GF_ISOM_DATA_READ_BLOCK   0x10
+/*cache of read blocks of a file (not a data map)*/
+#define GF_ISOM_DATA_READ_CACHE   0x11
 
 /*Data Map modes*/
 enum
@@ -3739,6 +3780,8 @@ typedef struct
 	u64 file_size;
 	u8 *byte_map;
 	u64 byte_pos;
+	/*one reference for the data map itself, plus one per sample payload handed out through the mapping*/
+	volatile u32 nb_refs;
 } GF_FileMappingDataMap;
 
 GF_Err gf_isom_datamap_new(const char *location, const char *parentPath, u8 mode, GF_DataMap **outDataMap);
@@ -3756,6 +3799,60 @@ u32 gf_isom_fdm_get_data(GF_FileDataMap *ptr, u8 *buffer, u32 bufferLength, u64
 GF_DataMap *gf_isom_fdm_new_temp(const char *sTempPath);
 #endif
 
+/*File-mapping data map, returns NULL if mapping is not possible (not a regular file, larger than max_size or not supported)*/
+GF_DataMap *gf_isom_fmo_new(const char *sPath, u8 mode, u64 max_size);
+void gf_isom_fmo_del(GF_FileMappingDataMap *ptr);
+u32 gf_isom_fmo_get_data(GF_FileMappingDataMap *ptr, u8 *buffer, u32 bufferLength, u64 fileOffset);
+/*gets a pointer in the mapping for the given range - returns NULL if out of range
+if the range is outside [advise_start, advise_end], a readahead hint is issued and the window is updated*/
+const u8 *gf_isom_fmo_get_mapped_data(GF_FileMappingDataMap *ptr, u32 size, u64 fileOffset, u64 *advise_start, u64 *advise_end);
+void gf_isom_fmo_ref(GF_FileMappingDataMap *ptr);
+void gf_isom_fmo_unref(GF_FileMappingDataMap *ptr);
+
+typedef struct __isom_read_cache GF_ISOReadCache;
+
+/*block of file data read at once, covering payloads of one or more tracks*/
+typedef struct
+{
+	/*GF_ISOM_DATA_READ_BLOCK, same position as the type of data maps*/
+	u8 type;
+	/*one reference while in cache, plus one per sample payload handed out - protected by the cache mutex*/
+	u32 nb_refs;
+	Bool in_cache;
+	GF_ISOReadCache *cache;
+	u64 offset;
+	u32 size, alloc_size;
+	u8 *data;
+} GF_ISOReadBlock;
+
+struct __isom_read_cache
+{
+	/*GF_ISOM_DATA_READ_CACHE, same position as the type of data maps*/
+	u8 type;
+	/*one reference for the file, one per user of the cache (cf gf_isom_get_file_mapping) and one per live block*/
+	u32 nb_refs;
+	GF_Mutex *mx;
+	u32 block_size, max_blocks;
+	/*live blocks, blocks in cache first by most recent use*/
+	GF_List *blocks;
+	/*unused blocks kept for reuse*/
+	GF_List *pool;
+	u64 nb_reads, bytes_read;
+};
+
+/*creates a read cache for coalesced sample reads, the returned cache holds the file reference*/
+GF_ISOReadCache *gf_isom_rbc_new(u32 block_size, u32 max_blocks);
+/*releases the blocks kept in cache and the file reference*/
+void gf_isom_rbc_del(GF_ISOReadCache *cache);
+void gf_isom_rbc_ref(GF_ISOReadCache *cache);
+void gf_isom_rbc_unref(GF_ISOReadCache *cache);
+/*gets a pointer to the given range of the data map, reading a new block if the range is not in cache - returns NULL if the range cannot be read
+block is set to the block holding the data, with a reference to release using gf_isom_rbc_block_unref*/
+const u8 *gf_isom_rbc_get_data(GF_ISOReadCache *cache, GF_DataMap *map, u64 offset, u32 size, GF_ISOReadBlock **block);
+void gf_isom_rbc_block_unref(GF_ISOReadBlock *block);
+/*releases the block reference held for a payload, given a pointer to the payload*/
+void gf_isom_rbc_release_payload(GF_ISOReadCache *cache, const u8 *data);
+
 #ifndef GPAC_DISABLE_ISOM_WRITE
 u64 gf_isom_datamap_get_offset(GF_DataMap *map);
 GF_Err gf_isom_datamap_add_data(GF_DataMap *ptr, u8 *data, u32 dataSize);
@@ -3806,6 +3903,8 @@ struct __tag_isom {
 	to make easily parsable files (note there could be some data (mdat) before
 	the moov*/
 	GF_DataMap *movieFileMap;
+	/*cache for coalesced sample reads of movieFileMap, NULL if not used*/
+	GF_ISOReadCache *block_cache;
 
 #ifndef GPAC_DISABLE_ISOM_WRITE
 	/*the final file name*/
@@ -3913,6 +4012,13 @@ struct __tag_isom {
 	u8 *block_buffer;
 	u32 block_buffer_size;
 
+	//space reserved before mdat for moov in capture mode, and its offset
+	u32 moov_reserve;
+	u64 moov_reserve_offset;
+	//moov size at last write, and whether it was written in the reserved space
+	u32 moov_reserve_used;
+	Bool moov_in_reserve;
+
 	u32 nb_box_init_seg;
 };
 
@@ -3950,7 +4056,8 @@ Bool IsMP4Description(u32 entryType);
 GF_Err Track_FindRef(GF_TrackBox *trak, u32 ReferenceType, GF_TrackReferenceTypeBox **dpnd);
 /*Time and sample*/
 GF_Err GetMediaTime(GF_TrackBox *trak, Bool force_non_empty, u64 movieTime, u64 *MediaTime, s64 *SegmentStartTime, s64 *MediaOffset, u8 *useEdit, u64 *next_edit_start_plus_one);
-GF_Err Media_GetSample(GF_MediaBox *mdia, u32 sampleNumber, GF_ISOSample **samp, u32 *sampleDescriptionIndex, Bool no_data, u64 *out_offset);
+/*if mapped_data is set and the sample payload can be used as is from a file mapping or read cache, the payload is not copied, mapped_data is set to its location and mapping to the object holding it, with a reference added*/
+GF_Err Media_GetSample(GF_MediaBox *mdia, u32 sampleNumber, GF_ISOSample **samp, u32 *sampleDescriptionIndex, Bool no_data, u64 *out_offset, const u8 **mapped_data, void **mapping);
 GF_Err Media_CheckDataEntry(GF_MediaBox *mdia, u32 dataEntryIndex);
 GF_Err Media_FindSyncSample(GF_SampleTableBox *stbl, u32 searchFromTime, u32 *sampleNumber, u8 mode);
 GF_Err Media_RewriteODFrame(GF_MediaBox *mdia, GF_ISOSample *sample);
@@ -3988,6 +4095,15 @@ GF_Err stbl_GetSampleShadow(GF_ShadowSyncBox *stsh, u32 *sampleNumber, u32 *sync
 GF_Err stbl_GetPaddingBits(GF_PaddingBitsBox *padb, u32 SampleNumber, u8 *PadBits);
 GF_Err stbl_GetSampleDepType(GF_SampleDependencyTypeBox *stbl, u32 SampleNumber, u32 *isLeading, u32 *dependsOn, u32 *dependedOn, u32 *redundant);
 
+/*builds the flattened sample index of the table - read mode only*/
+GF_Err stbl_build_index(GF_SampleTableBox *stbl);
+/*attaches an index to the table after checking it matches the table*/
+GF_Err stbl_set_index(GF_SampleTableBox *stbl, GF_SampleTableIndex *index);
+/*destroys the flattened sample index of the table if any*/
+void stbl_del_index(GF_SampleTableBox *stbl);
+/*destroys a flattened sample index*/
+void stbl_index_del(GF_SampleTableIndex *index);
+
 
 /*unpack sample2chunk and chunk offset so that we have 1 sample per chunk (edition mode only)*/
 GF_Err stbl_UnpackOffsets(GF_SampleTableBox *stbl);
@@ -988,6 +988,96 @@ This function is the same as \ref gf_isom_get_sample except that it fills in the
 */
 GF_ISOSample *gf_isom_get_sample_ex(GF_ISOFile *isom_file, u32 trackNumber, u32 sampleNumber, u32 *sampleDescriptionIndex, GF_ISOSample *static_sample, u64 *data_offset);
 
+/*! memory-maps the movie file for sample data access. The file must be a complete local file opened in read mode; growing files (progressive download, live fragmented files) shall not be mapped
+\param isom_file the target ISO file
+\param max_size maximum file size allowed for the mapping, larger files keep using regular file IO. 0 means no limit
+\return error if any, GF_NOT_SUPPORTED if the file cannot be mapped (pipes, memory files, byte range, platform without file mapping)
+*/
+GF_Err gf_isom_enable_file_mapping(GF_ISOFile *isom_file, u64 max_size);
+
+/*! fetches a sample from a track without copying its payload when possible.
+This function is the same as \ref gf_isom_get_sample_ex, except that if the file is memory-mapped (cf \ref gf_isom_enable_file_mapping) and the sample payload does not need any rewrite, the payload is not copied in the static_sample data buffer but accessed directly from the file mapping
+
+\param isom_file the target ISO file
+\param trackNumber the target track
+\param sampleNumber the desired sample number (1-based index)
+\param sampleDescriptionIndex set to the sample description index corresponding to this sample
+\param static_sample a caller-allocated ISO sample to use as the returned sample
+\param data_offset set to data offset in file / current bitstream - may be NULL
+\param mapped_data set to the sample payload in the file mapping, or NULL if the payload was copied in the sample data buffer
+\param mapping set to the mapping holding the payload if mapped_data is not NULL. The mapping stays valid, even after closing the file, until released using \ref gf_isom_release_mapped_data
+\return the ISO sample or NULL if not found or end of stream or incomplete file. Use \ref gf_isom_last_error to check the error code
+\note When mapped_data is set, the data field of the returned sample is left untouched and shall not be used
+*/
+GF_ISOSample *gf_isom_get_sample_mapped(GF_ISOFile *isom_file, u32 trackNumber, u32 sampleNumber, u32 *sampleDescriptionIndex, GF_ISOSample *static_sample, u64 *data_offset, const u8 **mapped_data, void **mapping);
+
+/*! enables block reads for sample data access on a file which is not memory-mapped.
+Sample payloads are fetched through a small cache of large contiguous blocks read from the file, and can be accessed without copy using \ref gf_isom_get_sample_mapped. This reduces the number of seeks and reads when samples of several tracks are interleaved in the file
+\param isom_file the target ISO file
+\param block_size minimum size in bytes of each read, 0 disables block reads
+\param max_blocks maximum number of blocks kept in cache, blocks still used by mapped payloads are not counted
+\return error if any, GF_NOT_SUPPORTED if the file is memory-mapped, a memory file or opened with a byte range
+*/
+GF_Err gf_isom_enable_block_reads(GF_ISOFile *isom_file, u32 block_size, u32 max_blocks);
+
+/*! gets block reads statistics
+\param isom_file the target ISO file
+\param nb_reads set to the number of block reads performed - may be NULL
+\param nb_bytes set to the number of bytes read - may be NULL
+\return error if any, GF_BAD_PARAM if block reads are not enabled
+*/
+GF_Err gf_isom_get_block_read_stats(GF_ISOFile *isom_file, u64 *nb_reads, u64 *nb_bytes);
+
+/*! gets a reference on the file mapping of the movie
+\param isom_file the target ISO file
+\return the file mapping or the block cache (cf \ref gf_isom_enable_block_reads), or NULL if the file is neither memory-mapped nor using block reads. The reference shall be released using \ref gf_isom_release_mapped_data
+*/
+void *gf_isom_get_file_mapping(GF_ISOFile *isom_file);
+
+/*! releases a file mapping reference obtained by \ref gf_isom_get_sample_mapped or \ref gf_isom_get_file_mapping
+\param mapping the mapping to release
+*/
+void gf_isom_release_mapped_data(void *mapping);
+
+/*! releases a sample payload obtained by \ref gf_isom_get_sample_mapped, using the file mapping reference instead of the sample mapping
+\param file_mapping the file mapping as returned by \ref gf_isom_get_file_mapping. For memory-mapped files, a reference on the mapping is released; for block reads, the block holding the payload is released
+\param data the sample payload
+*/
+void gf_isom_release_mapped_payload(void *file_mapping, const u8 *data);
+
+/*! sample table index modes*/
+typedef enum
+{
+	/*! no sample index, any existing index is destroyed*/
+	GF_ISOM_SAMPLE_INDEX_NONE=0,
+	/*! sample index is built upon first random access in the track*/
+	GF_ISOM_SAMPLE_INDEX_LAZY,
+	/*! sample index is built immediately*/
+	GF_ISOM_SAMPLE_INDEX_BUILD,
+} GF_ISOSampleIndexMode;
+
+/*! sets the sample index mode of tracks. The sample index flattens the sample tables (offsets, decode times, composition offsets) of a track for logarithmic time lookup of samples by number or by time, at the cost of memory (up to 20 bytes per sample). This is only supported for non-fragmented files opened in read mode
+\param isom_file the target ISO file
+\param trackNumber the target track, or 0 for all tracks
+\param mode the sample index mode to use
+\return error if any, GF_NOT_SUPPORTED if the file cannot use sample indexes
+*/
+GF_Err gf_isom_set_sample_index(GF_ISOFile *isom_file, u32 trackNumber, GF_ISOSampleIndexMode mode);
+
+/*! saves the sample indexes of all tracks to a sidecar file. Tracks without sample index are not saved
+\param isom_file the target ISO file
+\param file_name the sidecar file name
+\return error if any
+*/
+GF_Err gf_isom_save_sample_index(GF_ISOFile *isom_file, const char *file_name);
+
+/*! loads the sample indexes of tracks from a sidecar file created by \ref gf_isom_save_sample_index. Indexes not matching the sample tables of the file are ignored
+\param isom_file the target ISO file
+\param file_name the sidecar file name
+\return error if any, GF_NON_COMPLIANT_BITSTREAM if some indexes did not match the file sample tables
+*/
+GF_Err gf_isom_load_sample_index(GF_ISOFile *isom_file, const char *file_name);
+
 /*! gets sample information. This is the same as \ref gf_isom_get_sample but doesn't fetch media data
 
 \param isom_file the target ISO file
@@ -1931,6 +2021,22 @@ GF_Err gf_isom_set_interleave_time(GF_ISOFile *isom_file, u32 InterleaveTime);
 */
 GF_Err gf_isom_force_64bit_chunk_offset(GF_ISOFile *isom_file, Bool set_on);
 
+/*! reserves space for the movie box before the media data (STREAMABLE and FASTSTART modes of files opened in \ref GF_ISOM_OPEN_WRITE only).
+The reserved space is written as a free box before the media data. When closing the file, the movie box is written in place of the free box if it fits in the reserved space, avoiding to move the media data; otherwise the movie box is inserted before the media data as usual
+\param isom_file the target ISO file
+\param size size in bytes of the reserved space, 0 disables the reservation. Must be at least 8 bytes
+\return error if any, GF_BAD_PARAM if media data has already been written
+*/
+GF_Err gf_isom_set_moov_reservation(GF_ISOFile *isom_file, u32 size);
+
+/*! gets info on the movie box reservation after the file has been written
+\param isom_file the target ISO file
+\param moov_size set to the size of the written movie box - may be NULL
+\param in_place set to GF_TRUE if the movie box was written in the reserved space, GF_FALSE if it had to be inserted - may be NULL
+\return error if any, GF_BAD_PARAM if no reservation was done
+*/
+GF_Err gf_isom_get_moov_reservation_info(GF_ISOFile *isom_file, u32 *moov_size, Bool *in_place);
+
 /*! compression mode of top-level boxes*/
 typedef enum
 {
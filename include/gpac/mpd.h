@@ -147,11 +147,20 @@ typedef struct
 	u32 repeat_count;
 } GF_MPD_SegmentTimelineEntry;
 
+/*! serialized form of manifest entries, used to only format new or modified entries when rewriting a manifest - GPAC internal*/
+typedef struct _gf_mpd_serial_cache GF_MPD_SerialCache;
+
 /*! Segment Timeline*/
 typedef struct
 {
 	/*! list of entries*/
 	GF_List *entries;
+	/*! GPAC internal, serialized entries of the timeline*/
+	GF_MPD_SerialCache *serial;
+	/*! GPAC internal, 1-based position of the timeline in the document loaded by \ref gf_mpd_init_from_file, 0 if unknown*/
+	u32 doc_index;
+	/*! GPAC internal, number of segments removed by the client at the start of the timeline since it was loaded or merged. Positional S selectors of MPD patches cannot be resolved if not 0*/
+	u32 nb_purged;
 } GF_MPD_SegmentTimeline;
 
 /*! Byte range info*/
@@ -644,6 +653,8 @@ typedef struct {
 	char *m3u8_var_name;
 	/*! temp file for m3u8 generation*/
 	FILE *m3u8_var_file;
+	/*! serialized segment entries of the m3u8 variant playlist*/
+	GF_MPD_SerialCache *m3u8_serial;
 } GF_MPD_Representation;
 
 /*! AdaptationSet*/
@@ -829,6 +840,10 @@ typedef struct {
 	GF_List *base_URLs;
 	/*! list of strings */
 	GF_List *locations;
+	/*! URL of the MPD patch document, NULL if none*/
+	char *patch_location;
+	/*! validity of the patch location in seconds after publishTime, 0 if unlimited*/
+	u32 patch_location_ttl;
 	/*! list of Metrics */
 	GF_List *metrics;
 	/*! list of GF_MPD_Period */
@@ -858,6 +873,13 @@ typedef struct {
 	Bool create_m3u8_files;
 	/*! indicates to insert clock reference in variant playlists*/
 	Bool m3u8_time;
+
+	/*! number of SegmentTimeline elements in the document loaded by \ref gf_mpd_init_from_file - GPAC internal*/
+	u32 nb_doc_timelines;
+	/*! signature of the document structure (everything but timeline entries) loaded by \ref gf_mpd_init_from_file - GPAC internal*/
+	u8 doc_signature[GF_SHA1_DIGEST_SIZE];
+	/*! timelines parsed by the SAX loader, only set while loading - GPAC internal*/
+	GF_List *sax_timelines;
 } GF_MPD;
 
 /*! parses an MPD Element (and subtree) from DOM
@@ -867,6 +889,32 @@ typedef struct {
 \return error if any
 */
 GF_Err gf_mpd_init_from_dom(GF_XMLNode *root, GF_MPD *mpd, const char *base_url);
+
+/*! parses an MPD file without building the DOM of SegmentTimeline entries. This is equivalent to a DOM parsing of the file followed by \ref gf_mpd_init_from_dom, but much lighter for manifests with large timelines.
+The structure of the document is recorded so that new versions of the manifest can be merged using \ref gf_mpd_merge_file
+\param file the MPD file to parse
+\param mpd MPD structure to fill
+\param base_url base URL of the document
+\return error if any
+*/
+GF_Err gf_mpd_init_from_file(const char *file, GF_MPD *mpd, const char *base_url);
+
+/*! merges a new version of an MPD file into an MPD loaded with \ref gf_mpd_init_from_file. The merge is only done if the new document differs from the loaded one only by its SegmentTimeline entries, the startNumber of segment templates or lists carrying a timeline and its publishTime.
+Timeline entries are updated in place, only entries not present in the MPD are allocated.
+\param file the new version of the MPD file
+\param mpd the MPD to update
+\param nb_new_entries set to the number of timeline entries added to the MPD - may be NULL
+\return error if any, GF_NOT_SUPPORTED if the document cannot be merged. The MPD is not modified if an error is returned
+*/
+GF_Err gf_mpd_merge_file(const char *file, GF_MPD *mpd, u32 *nb_new_entries);
+
+/*! applies an MPD patch document to an MPD. Supported operations are replacing the MPD publishTime and minimumUpdatePeriod, updating the PatchLocation, updating startNumber of segment templates and lists, and adding, removing or replacing SegmentTimeline entries and their attributes
+\param file the MPD patch file
+\param mpd the MPD to update
+\param nb_new_entries set to the number of timeline entries added to the MPD - may be NULL
+\return error if any, GF_NOT_SUPPORTED if the patch uses unsupported operations or does not apply to this MPD, GF_EOS if the patch does not modify the MPD. The MPD is not modified if an error is returned
+*/
+GF_Err gf_mpd_apply_patch(const char *file, GF_MPD *mpd, u32 *nb_new_entries);
 /*! parses an MPD Period element (and subtree) from DOM
 \param root root of DOM parsing result
 \param mpd MPD structure to fill
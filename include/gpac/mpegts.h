@@ -655,6 +655,8 @@ typedef struct
 	GF_M2TS_MetadataPointerDescriptor *metadata_pointer_descriptor;
 	/*! continuity counter check for pure PCR PIDs*/
 	s16 pcr_cc;
+	/*! private - set when the PCR PID of this program is dropped by the demuxer PID filter*/
+	Bool pcr_filtered;
 
 	void *user;
 } GF_M2TS_Program;
@@ -1102,6 +1104,15 @@ struct tag_m2ts_demux
 	if set, on_event shall be non-null
 	*/
 	Bool split_mode;
+
+	/*! if set, PCR PIDs of programs with no PES stream being reframed are dropped by the PID filter, and no GF_M2TS_EVT_PES_PCR is sent for these programs
+	pid_filter_dirty shall be set when modifying this flag
+	*/
+	Bool skip_inactive_pcr;
+	/*! private - bitmap of PIDs processed by the demuxer, only the adaptation field extension (TEMI descriptors) of packets on other PIDs is parsed*/
+	u32 pid_filter[GF_M2TS_MAX_STREAMS/32];
+	/*! private - set whenever the PID filter must be rebuilt*/
+	Bool pid_filter_dirty;
 };
 
 //! @endcond
@@ -1866,6 +1877,18 @@ typedef enum
 \return packet produced or NULL if error or idle
 */
 const u8 *gf_m2ts_mux_process(GF_M2TS_Mux *muxer, GF_M2TSMuxState *status, u32 *usec_till_next);
+
+/*! produces a block of packets of the multiplex in a caller-provided buffer
+Packets are written directly in the destination buffer, so that the output of the multiplexer can be sent without extra copies.
+The function stops when max_pck packets have been produced or when the multiplexer has nothing to produce
+\param muxer the target MPEG-2 TS multiplexer
+\param dst the destination buffer, at least max_pck*188 bytes
+\param max_pck the maximum number of packets to produce
+\param status set to the state of the multiplexer after the last packet
+\param usec_till_next set to the number of microseconds until next packet (real-time mux only)
+\return number of packets produced
+*/
+u32 gf_m2ts_mux_process_block(GF_M2TS_Mux *muxer, u8 *dst, u32 max_pck, GF_M2TSMuxState *status, u32 *usec_till_next);
 /*! gets the system clock of the multiplexer (time ellapsed since start)
 \param muxer the target MPEG-2 TS multiplexer
 \return system clock of the multiplexer in milliseconds
@@ -422,6 +422,31 @@ Sends a buffer on the socket. The socket must be in a bound or connected mode
  */
 GF_Err gf_sk_send(GF_Socket *sock, const u8 *buffer, u32 length);
 /*!
+\brief data emission with partial write report
+
+Sends a buffer on the socket. The socket must be in a bound or connected mode. This is the same as \ref gf_sk_send but reports how many bytes were sent, which is needed by callers of non-blocking sockets to resume a partial send
+\param sock the socket object
+\param buffer the data buffer to send
+\param length the data length to send
+\param written set to the number of bytes sent - may be NULL
+\return error if any
+ */
+GF_Err gf_sk_send_ex(GF_Socket *sock, const u8 *buffer, u32 length, u32 *written);
+/*!
+\brief zero-copy file emission
+
+Sends a file range on the socket without copying data to user space, using sendfile for regular files or splice for pipes when supported by the platform. The socket must be a connected TCP socket.
+
+For pipes, the offset is ignored and data is read from the current pipe position; the file must not have pending buffered data.
+\param sock the socket object
+\param file the file to send data from, as opened by \ref gf_fopen
+\param offset the offset in the file of the first byte to send
+\param length the number of bytes to send
+\param written set to the number of bytes actually sent, may be less than length if the socket would block or end of file is reached
+\return error if any, GF_NOT_SUPPORTED if zero-copy is not available for this file or socket, in which case no data has been sent
+ */
+GF_Err gf_sk_send_file(GF_Socket *sock, FILE *file, u64 offset, u32 length, u32 *written);
+/*!
 \brief data reception
 
 Fetches data on a socket. The socket must be in a bound or connected state
@@ -586,6 +611,38 @@ Fetches data on a socket without performing any select (wait), to be used with s
  */
 GF_Err gf_sk_receive_no_select(GF_Socket *sock, u8 *buffer, u32 length, u32 *read);
 
+/*! maximum number of datagrams exchanged in a single call to \ref gf_sk_receive_batch or \ref gf_sk_send_batch*/
+#define GF_SK_MAX_BATCH	64
+
+/*! datagram descriptor for batched socket I/O*/
+typedef struct
+{
+	/*! datagram payload*/
+	u8 *data;
+	/*! for reception, allocated size of the payload buffer, set to the received size upon return; for emission, size of the datagram*/
+	u32 size;
+} GF_SockDatagram;
+
+/*!
+Fetches several datagrams on a socket without performing any select (wait), to be used with socket group on sockets that are set in the selected socket group. On platforms supporting it, all datagrams are fetched in a single system call (recvmmsg), otherwise one call per datagram is made.
+\param sock the socket object
+\param dgrams the datagram descriptors to fill
+\param nb_dgrams the number of datagram descriptors, at most \ref GF_SK_MAX_BATCH are used
+\param nb_recv set to the number of datagrams received
+\return error if any, GF_IP_NETWORK_EMPTY if nothing to read
+ */
+GF_Err gf_sk_receive_batch(GF_Socket *sock, GF_SockDatagram *dgrams, u32 nb_dgrams, u32 *nb_recv);
+
+/*!
+Sends several datagrams on a socket. On platforms supporting it, up to \ref GF_SK_MAX_BATCH datagrams are sent in a single system call (sendmmsg), and consecutive datagrams of the same size are handed to the kernel as one buffer using UDP segmentation offload when available. Otherwise one call per datagram is made. For TCP sockets, datagrams are sent one after the other.
+\param sock the socket object
+\param dgrams the datagrams to send
+\param nb_dgrams the number of datagrams to send
+\param nb_sent set to the number of datagrams sent, may be less than nb_dgrams in case of error - may be NULL
+\return error if any
+ */
+GF_Err gf_sk_send_batch(GF_Socket *sock, const GF_SockDatagram *dgrams, u32 nb_dgrams, u32 *nb_sent);
+
 /*!
 Checks if connection has been closed by remote peer
 \param sock the socket object
@@ -260,6 +260,18 @@ u64 gf_route_dmx_get_nb_packets(GF_ROUTEDmx *routedmx);
  */
 u64 gf_route_dmx_get_recv_bytes(GF_ROUTEDmx *routedmx);
 
+/*! Gets the number of socket reception calls since start of the session, for all active services. Several packets can be received per call
+\param routedmx the ROUTE demultiplexer
+\return number of reception calls
+ */
+u64 gf_route_dmx_get_nb_recv_calls(GF_ROUTEDmx *routedmx);
+
+/*! Sets the maximum number of packets received per socket call on service sockets. Must be called before processing starts
+\param routedmx the ROUTE demultiplexer
+\param nb_datagrams maximum number of packets per call, at most \ref GF_SK_MAX_BATCH - default is \ref GF_SK_MAX_BATCH
+ */
+void gf_route_dmx_set_batch(GF_ROUTEDmx *routedmx, u32 nb_datagrams);
+
 /*! Gather only  objects with given TSI (for debug purposes)
 \param routedmx the ROUTE demultiplexer
 \param tsi the target TSI, 0 for no filtering
@@ -241,6 +241,26 @@ u16 gf_rtp_streamer_get_next_rtp_sn(GF_RTPStreamer *streamer);
 */
 GF_Err gf_rtp_streamer_set_interleave_callbacks(GF_RTPStreamer *streamer, GF_Err (*RTP_TCPCallback)(void *cbk1, void *cbk2, Bool is_rtcp, u8 *pck, u32 pck_size), void *cbk1, void *cbk2);
 
+/*! sets the maximum number of RTP packets sent per socket call
+\param streamer the target RTP streamer
+\param nb_packets maximum number of packets per call, at most \ref GF_SK_MAX_BATCH. A value of 0 or 1 disables batching
+\return error if any
+*/
+GF_Err gf_rtp_streamer_set_send_batch(GF_RTPStreamer *streamer, u32 nb_packets);
+
+/*! sends all RTP packets pending in the batch
+\param streamer the target RTP streamer
+\return error if any
+*/
+GF_Err gf_rtp_streamer_flush(GF_RTPStreamer *streamer);
+
+/*! gets RTP sending statistics
+\param streamer the target RTP streamer
+\param nb_calls set to the number of socket send calls - may be NULL
+\param nb_packets set to the number of RTP packets sent - may be NULL
+*/
+void gf_rtp_streamer_get_send_stats(GF_RTPStreamer *streamer, u64 *nb_calls, u64 *nb_packets);
+
 /*! @} */
 
 #ifdef __cplusplus
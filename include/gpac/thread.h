@@ -230,6 +230,45 @@ Gets the ID of the current thread the caller is in.
 */
 u32 gf_th_id();
 
+/*!
+\brief thread CPU affinity
+
+Restricts execution of a thread to a set of CPUs
+\param th the thread object, or NULL for the calling thread
+\param cpus list of CPU indexes (0-based) the thread may run on
+\param nb_cpus number of CPU indexes in the list
+\return error if any, GF_NOT_SUPPORTED if CPU affinity is not supported on this platform
+ */
+GF_Err gf_th_set_cpu_affinity(GF_Thread *th, const u32 *cpus, u32 nb_cpus);
+
+/*!
+\brief current CPU
+
+Gets the CPU the calling thread is currently running on
+\return CPU index, or -1 if unknown
+*/
+s32 gf_th_get_cpu();
+
+/*!
+\brief CPU NUMA node
+
+Gets the NUMA node of a CPU
+\param cpu the CPU index
+\return NUMA node index, or -1 if unknown. Systems without NUMA support report node 0
+*/
+s32 gf_sys_get_cpu_node(u32 cpu);
+
+/*!
+\brief NUMA node CPUs
+
+Gets the list of CPUs of a NUMA node
+\param node the NUMA node index
+\param cpus list of CPU indexes to fill
+\param max_cpus maximum number of entries in the CPU list
+\return number of CPUs of the node set in the list
+*/
+u32 gf_sys_get_node_cpus(u32 node, u32 *cpus, u32 max_cpus);
+
 #ifdef GPAC_CONFIG_ANDROID
 /*! Register a function that will be called before pthread_exist is called */
 GF_Err gf_register_before_exit_function(GF_Thread *t, u32 (*toRunBeforePthreadExit)(void *param));
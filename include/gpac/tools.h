@@ -1309,6 +1309,37 @@ Opens a file, potentially using file IO if the parent URL is a File IO wrapper
 \return stream habdle of the file or file IO object*/
 FILE *gf_fopen_ex(const char *file_name, const char *parent_url, const char *mode);
 
+/*! asynchronous file opening flags*/
+enum
+{
+	/*! use direct I/O (bypass system cache) for full blocks in write mode*/
+	GF_FILE_AIO_DIRECT = 1,
+};
+
+/*!
+\brief asynchronous file opening
+
+Opens a local file using asynchronous I/O (io_uring, Linux only). In read mode, several blocks are read ahead of the current position. In write mode, data is written in blocks submitted together. Reading a file opened in write mode waits for all pending writes.
+
+The returned object is a file IO wrapper (see \ref gf_fileio_check) usable with all gf_f* functions and closed with \ref gf_fclose. If asynchronous I/O is not available for the file, mode or system, the file is opened with \ref gf_fopen.
+\param file_name local file path
+\param mode same as fopen. Only read ("r", "rb") and write ("w", "wb", "w+", "w+b") modes use asynchronous I/O
+\param block_size size in bytes of I/O blocks, 0 for default (1 MByte)
+\param nb_blocks number of I/O blocks, 0 for default (4)
+\param flags asynchronous I/O flags
+\return stream handle of the file object
+*/
+FILE *gf_fopen_aio(const char *file_name, const char *mode, u32 block_size, u32 nb_blocks, u32 flags);
+
+/*!
+\brief asynchronous file check
+
+Checks if a file was opened with asynchronous I/O
+\param fp FILE object to check
+\return GF_TRUE if the file uses asynchronous I/O
+*/
+Bool gf_file_is_aio(FILE *fp);
+
 /*!
 \brief file closing
 
@@ -1420,6 +1451,16 @@ Moves or renames a file or directory.
 */
 GF_Err gf_file_move(const char *fileName, const char *newFileName);
 
+/*!
+\brief File Replace
+
+Renames a file, replacing the destination file if it exists. The destination is replaced in a single operation on platforms supporting it, so that readers see either the old or the new file, never a missing one.
+\param fileName absolute path of the file to rename
+\param newFileName absolute path of the file to replace
+\return error if any
+*/
+GF_Err gf_file_replace(const char *fileName, const char *newFileName);
+
 /*!
 \brief Temporary File Creation
 
@@ -24,6 +24,8 @@
 */
 
 #include <gpac/internal/crypt_dev.h>
+#include <gpac/thread.h>
+#include <gpac/list.h>
 
 GF_EXPORT
 GF_Crypt *gf_crypt_open(GF_CRYPTO_ALGO algorithm, GF_CRYPTO_MODE mode)
@@ -103,3 +105,273 @@ GF_Err gf_crypt_decrypt(GF_Crypt *td, void *ciphertext, u32 len)
 	if (!len) return GF_OK;
 	return td->_decrypt(td, ciphertext, len);
 }
+
+GF_EXPORT
+GF_Err gf_crypt_job_add_range(GF_CryptJob *job, u32 offset, u32 size, u32 crypt_blocks, u32 skip_blocks, Bool reset_IV)
+{
+	GF_CryptRange *r;
+	if (!job) return GF_BAD_PARAM;
+	if (!size) return GF_OK;
+
+	if (job->nb_ranges == job->nb_alloc_ranges) {
+		job->nb_alloc_ranges = job->nb_alloc_ranges ? 2*job->nb_alloc_ranges : 10;
+		job->ranges = gf_realloc(job->ranges, sizeof(GF_CryptRange) * job->nb_alloc_ranges);
+		if (!job->ranges) {
+			job->nb_alloc_ranges = job->nb_ranges = 0;
+			return GF_OUT_OF_MEM;
+		}
+	}
+	r = &job->ranges[job->nb_ranges];
+	r->offset = offset;
+	r->size = size;
+	r->crypt_blocks = crypt_blocks;
+	r->skip_blocks = skip_blocks;
+	r->reset_IV = reset_IV;
+	job->nb_ranges++;
+	return GF_OK;
+}
+
+GF_EXPORT
+void gf_crypt_job_reset(GF_CryptJob *job)
+{
+	if (!job) return;
+	job->nb_ranges = 0;
+	job->IV_size = 0;
+	job->data = NULL;
+	job->e = GF_OK;
+	job->state = 0;
+}
+
+GF_EXPORT
+GF_Err gf_crypt_job_run(GF_Crypt *td, GF_CryptJob *job)
+{
+	u32 i;
+	GF_Err e;
+	GF_Err (*crypt_fun)(GF_Crypt *td, void *buf, u32 len);
+
+	if (!td || !job) return GF_BAD_PARAM;
+	crypt_fun = job->decrypt ? gf_crypt_decrypt : gf_crypt_encrypt;
+
+	if (job->IV_size) {
+		e = gf_crypt_set_IV(td, job->IV, job->IV_size);
+		if (e) return e;
+	}
+	for (i=0; i<job->nb_ranges; i++) {
+		GF_CryptRange *r = &job->ranges[i];
+		u8 *ptr = job->data + r->offset;
+		u32 res = r->size;
+
+		if (r->reset_IV && job->IV_size)
+			gf_crypt_set_IV(td, job->IV, job->IV_size);
+
+		//full range
+		if (!r->crypt_blocks || !r->skip_blocks) {
+			e = crypt_fun(td, ptr, res);
+			if (e) return e;
+			continue;
+		}
+		//pattern, the last pattern may be shorter than crypt_blocks
+		while (res) {
+			u32 cryp_block = 16 * r->crypt_blocks;
+			u32 full_block = 16 * (r->crypt_blocks + r->skip_blocks);
+			e = crypt_fun(td, ptr, (res >= cryp_block) ? cryp_block : res);
+			if (e) return e;
+			if (res >= full_block) {
+				ptr += full_block;
+				res -= full_block;
+			} else {
+				res = 0;
+			}
+		}
+	}
+	return GF_OK;
+}
+
+enum
+{
+	CRYPT_JOB_IDLE = 0,
+	CRYPT_JOB_PENDING,
+	CRYPT_JOB_DONE,
+};
+
+typedef struct
+{
+	GF_CryptPool *pool;
+	GF_Thread *th;
+	//one context per chaining mode, created on first job
+	GF_Crypt *crypt[2];
+	bin128 key[2];
+} GF_CryptWorker;
+
+struct __gf_crypt_pool
+{
+	GF_CryptWorker *workers;
+	u32 nb_workers;
+
+	GF_Mutex *mx;
+	//signaled once per posted job and once per worker at exit
+	GF_Semaphore *sema_jobs;
+	//signaled when a job is done and someone is waiting
+	GF_Semaphore *sema_done;
+	GF_List *jobs;
+	Bool stop, waiting;
+};
+
+static GF_Err crypt_worker_process(GF_CryptWorker *w, GF_CryptJob *job)
+{
+	GF_Crypt *td;
+	u32 midx = (job->mode==GF_CTR) ? 1 : 0;
+
+	if (!job->IV_size) return GF_BAD_PARAM;
+
+	td = w->crypt[midx];
+	if (!td) {
+		GF_Err e;
+		td = gf_crypt_open(GF_AES_128, job->mode);
+		if (!td) return GF_OUT_OF_MEM;
+		//gf_crypt_init closes the context on error
+		e = gf_crypt_init(td, job->key, NULL);
+		if (e) return e;
+		memcpy(w->key[midx], job->key, sizeof(bin128));
+		w->crypt[midx] = td;
+	}
+	else if (memcmp(w->key[midx], job->key, sizeof(bin128))) {
+		gf_crypt_set_key(td, job->key);
+		memcpy(w->key[midx], job->key, sizeof(bin128));
+	}
+	return gf_crypt_job_run(td, job);
+}
+
+static u32 crypt_worker_run(void *par)
+{
+	GF_CryptWorker *w = (GF_CryptWorker *)par;
+	GF_CryptPool *pool = w->pool;
+
+	while (1) {
+		GF_CryptJob *job;
+		Bool stop;
+		gf_sema_wait(pool->sema_jobs);
+
+		gf_mx_p(pool->mx);
+		job = gf_list_pop_front(pool->jobs);
+		stop = pool->stop;
+		gf_mx_v(pool->mx);
+
+		if (!job) {
+			if (stop) break;
+			continue;
+		}
+		job->e = crypt_worker_process(w, job);
+
+		gf_mx_p(pool->mx);
+		job->state = CRYPT_JOB_DONE;
+		if (pool->waiting) {
+			pool->waiting = GF_FALSE;
+			gf_sema_notify(pool->sema_done, 1);
+		}
+		gf_mx_v(pool->mx);
+	}
+	return 0;
+}
+
+GF_EXPORT
+GF_CryptPool *gf_crypt_pool_new(u32 nb_threads)
+{
+	u32 i;
+	GF_CryptPool *pool;
+	if (!nb_threads) return NULL;
+
+	GF_SAFEALLOC(pool, GF_CryptPool);
+	if (!pool) return NULL;
+	pool->workers = gf_malloc(sizeof(GF_CryptWorker) * nb_threads);
+	pool->mx = gf_mx_new("CryptPool");
+	pool->sema_jobs = gf_sema_new(GF_INT_MAX, 0);
+	pool->sema_done = gf_sema_new(1, 0);
+	pool->jobs = gf_list_new();
+	if (!pool->workers || !pool->mx || !pool->sema_jobs || !pool->sema_done || !pool->jobs) {
+		gf_crypt_pool_del(pool);
+		return NULL;
+	}
+	memset(pool->workers, 0, sizeof(GF_CryptWorker) * nb_threads);
+
+	for (i=0; i<nb_threads; i++) {
+		GF_CryptWorker *w = &pool->workers[i];
+		w->pool = pool;
+		w->th = gf_th_new("CryptWorker");
+		if (!w->th) break;
+		if (gf_th_run(w->th, crypt_worker_run, w) != GF_OK) {
+			gf_th_del(w->th);
+			w->th = NULL;
+			break;
+		}
+		pool->nb_workers++;
+	}
+	if (!pool->nb_workers) {
+		gf_crypt_pool_del(pool);
+		return NULL;
+	}
+	return pool;
+}
+
+GF_EXPORT
+void gf_crypt_pool_del(GF_CryptPool *pool)
+{
+	u32 i;
+	if (!pool) return;
+
+	if (pool->nb_workers) {
+		gf_mx_p(pool->mx);
+		pool->stop = GF_TRUE;
+		gf_mx_v(pool->mx);
+		gf_sema_notify(pool->sema_jobs, pool->nb_workers);
+	}
+	for (i=0; i<pool->nb_workers; i++) {
+		GF_CryptWorker *w = &pool->workers[i];
+		gf_th_del(w->th);
+		if (w->crypt[0]) gf_crypt_close(w->crypt[0]);
+		if (w->crypt[1]) gf_crypt_close(w->crypt[1]);
+	}
+	if (pool->workers) gf_free(pool->workers);
+	if (pool->jobs) gf_list_del(pool->jobs);
+	if (pool->sema_jobs) gf_sema_del(pool->sema_jobs);
+	if (pool->sema_done) gf_sema_del(pool->sema_done);
+	if (pool->mx) gf_mx_del(pool->mx);
+	gf_free(pool);
+}
+
+GF_EXPORT
+GF_Err gf_crypt_pool_post(GF_CryptPool *pool, GF_CryptJob *job)
+{
+	GF_Err e;
+	if (!pool || !job || !job->IV_size) return GF_BAD_PARAM;
+
+	gf_mx_p(pool->mx);
+	job->state = CRYPT_JOB_PENDING;
+	job->e = GF_OK;
+	e = gf_list_add(pool->jobs, job);
+	gf_mx_v(pool->mx);
+	if (e) return e;
+
+	gf_sema_notify(pool->sema_jobs, 1);
+	return GF_OK;
+}
+
+GF_EXPORT
+Bool gf_crypt_pool_job_done(GF_CryptPool *pool, GF_CryptJob *job, Bool wait)
+{
+	if (!pool || !job) return GF_TRUE;
+
+	gf_mx_p(pool->mx);
+	while (job->state == CRYPT_JOB_PENDING) {
+		if (!wait) {
+			gf_mx_v(pool->mx);
+			return GF_FALSE;
+		}
+		pool->waiting = GF_TRUE;
+		gf_mx_v(pool->mx);
+		gf_sema_wait(pool->sema_done);
+		gf_mx_p(pool->mx);
+	}
+	gf_mx_v(pool->mx);
+	return GF_TRUE;
+}
@@ -84,20 +84,19 @@ GF_Err gf_crypt_get_IV_openssl_cbc(GF_Crypt* td, u8 *iv, u32 *iv_size)
 
 GF_Err gf_crypt_crypt_openssl_cbc(GF_Crypt* td, u8 *plaintext, u32 len, u32 aes_crypt_type) {
 	Openssl_ctx_cbc* ctx = (Openssl_ctx_cbc*)td->context;
-	u32 iteration;
 	AES_KEY *key = aes_crypt_type ? &ctx->enc_key : &ctx->dec_key;
-	u32 numberOfIterations = len / AES_BLOCK_SIZE;
-	if (numberOfIterations * AES_BLOCK_SIZE < len) numberOfIterations++;
-
-	for (iteration = 0; iteration < numberOfIterations; ++iteration) {
-		if (len - iteration*AES_BLOCK_SIZE < AES_BLOCK_SIZE) {
-			memset(ctx->padded_input, 0, AES_BLOCK_SIZE);
-			memcpy(ctx->padded_input, plaintext, len - iteration*AES_BLOCK_SIZE);
-			AES_cbc_encrypt(plaintext + iteration*AES_BLOCK_SIZE, ctx->block, AES_BLOCK_SIZE, key, ctx->previous_ciphertext, aes_crypt_type);
-			memcpy(plaintext + iteration*AES_BLOCK_SIZE, ctx->block, len - iteration*AES_BLOCK_SIZE);
-		} else {
-			AES_cbc_encrypt(plaintext + iteration*AES_BLOCK_SIZE, plaintext + iteration*AES_BLOCK_SIZE, AES_BLOCK_SIZE, key, ctx->previous_ciphertext, aes_crypt_type);
-		}
+	u32 nb_full_blocks = len / AES_BLOCK_SIZE;
+
+	//process all full blocks in a single call, inplace processing is supported and the IV is updated to the last cipher block
+	if (nb_full_blocks) {
+		AES_cbc_encrypt(plaintext, plaintext, nb_full_blocks*AES_BLOCK_SIZE, key, ctx->previous_ciphertext, aes_crypt_type);
+	}
+	if (nb_full_blocks*AES_BLOCK_SIZE < len) {
+		u32 iteration = nb_full_blocks;
+		memset(ctx->padded_input, 0, AES_BLOCK_SIZE);
+		memcpy(ctx->padded_input, plaintext, len - iteration*AES_BLOCK_SIZE);
+		AES_cbc_encrypt(plaintext + iteration*AES_BLOCK_SIZE, ctx->block, AES_BLOCK_SIZE, key, ctx->previous_ciphertext, aes_crypt_type);
+		memcpy(plaintext + iteration*AES_BLOCK_SIZE, ctx->block, len - iteration*AES_BLOCK_SIZE);
 	}
 	return GF_OK;
 }
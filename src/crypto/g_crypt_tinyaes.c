@@ -30,6 +30,13 @@
 
 #include <math.h>
 
+//AES instructions are used when available unless disabled through -no-aes-hw
+static u8 gf_crypt_tinyaes_use_hw()
+{
+	if (gf_opts_get_bool("core", "no-aes-hw")) return 0;
+	return AES_hw_available();
+}
+
 /** CBC mode **/
 
 GF_Err gf_crypt_init_tinyaes_cbc(GF_Crypt* td, void *key, const void *iv)
@@ -41,8 +48,8 @@ GF_Err gf_crypt_init_tinyaes_cbc(GF_Crypt* td, void *key, const void *iv)
 
 		td->context = ctx;
 	}
+	ctx->hw = gf_crypt_tinyaes_use_hw();
 
-	
 	if (iv != NULL) {
 		AES_init_ctx_iv(ctx, key, iv);
 	} else {
@@ -136,6 +143,7 @@ GF_Err gf_crypt_init_tinyaes_ctr(GF_Crypt* td, void *key, const void *iv)
 		if (ctx == NULL) return GF_OUT_OF_MEM;
 		td->context = ctx;
 	}
+	ctx->hw = gf_crypt_tinyaes_use_hw();
 
 	/* For ctr */
 	if (iv) {
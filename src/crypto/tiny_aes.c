@@ -224,9 +224,12 @@ static void KeyExpansion(u8* RoundKey, const u8* Key)
   }
 }
 
+static void ExpandDecKeys(struct AES_ctx* ctx);
+
 void AES_init_ctx(struct AES_ctx* ctx, const u8* key)
 {
   KeyExpansion(ctx->RoundKey, key);
+  if (ctx->hw) ExpandDecKeys(ctx);
 #if (defined(CTR) && (CTR == 1))
 	ctx->counter_pos = 0;
 #endif
@@ -236,6 +239,7 @@ void AES_init_ctx(struct AES_ctx* ctx, const u8* key)
 void AES_init_ctx_iv(struct AES_ctx* ctx, const u8* key, const u8* iv)
 {
   KeyExpansion(ctx->RoundKey, key);
+  if (ctx->hw) ExpandDecKeys(ctx);
 #if (defined(CTR) && (CTR == 1))
 	ctx->counter_pos = 0;
 #endif
@@ -471,6 +475,281 @@ static void InvCipher(state_t* state,u8* RoundKey)
 }
 
 
+
+/*****************************************************************************/
+/* Hardware AES:                                                             */
+/*****************************************************************************/
+// AES-NI on x86 and ARMv8 crypto extensions on aarch64, selected at runtime (see AES_hw_available).
+// The kernels use the round keys computed by KeyExpansion, and the equivalent inverse cipher for decryption
+// (round keys computed by ExpandDecKeys). CTR and CBC decryption process 8 then 4 blocks at once to hide
+// the latency of the AES instructions, CBC encryption is chained and processes one block at a time.
+#if !defined(GPAC_DISABLE_AES_HW)
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+  #define AES_HW_X86
+  #define AES_HW_TARGET __attribute__((target("aes,sse2")))
+  #include <cpuid.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  #define AES_HW_X86
+  #define AES_HW_TARGET
+  #include <intrin.h>
+#elif defined(__aarch64__) && (defined(__linux__) || defined(__APPLE__)) \
+	&& (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_AES) || defined(__clang__) || (defined(__GNUC__) && (__GNUC__ >= 8)))
+  #define AES_HW_ARM
+  #if defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_AES)
+    #define AES_HW_TARGET
+  #elif defined(__clang__)
+    #define AES_HW_TARGET __attribute__((target("crypto")))
+  #else
+    #define AES_HW_TARGET __attribute__((target("+crypto")))
+  #endif
+  #ifdef __linux__
+    #include <sys/auxv.h>
+    #ifndef HWCAP_AES
+      #define HWCAP_AES (1 << 3)
+    #endif
+  #endif
+#endif
+#endif //GPAC_DISABLE_AES_HW
+
+// Round keys for the equivalent inverse cipher: encryption round keys in reverse order, InvMixColumns applied to inner rounds
+static void ExpandDecKeys(struct AES_ctx* ctx)
+{
+  u8 i;
+  memcpy(ctx->DecRoundKey, ctx->RoundKey + Nr * AES_BLOCKLEN, AES_BLOCKLEN);
+  for (i = 1; i < Nr; ++i)
+  {
+    memcpy(ctx->DecRoundKey + i * AES_BLOCKLEN, ctx->RoundKey + (Nr - i) * AES_BLOCKLEN, AES_BLOCKLEN);
+    InvMixColumns((state_t*)(ctx->DecRoundKey + i * AES_BLOCKLEN));
+  }
+  memcpy(ctx->DecRoundKey + Nr * AES_BLOCKLEN, ctx->RoundKey, AES_BLOCKLEN);
+}
+
+#if defined(AES_HW_X86) || defined(AES_HW_ARM)
+#define AES_HW
+
+#if defined(AES_HW_X86)
+#include <wmmintrin.h>
+
+typedef __m128i aes_block;
+#define AES_LOAD(_p)		_mm_loadu_si128((const __m128i *)(_p))
+#define AES_STORE(_p, _v)	_mm_storeu_si128((__m128i *)(_p), _v)
+#define AES_XOR(_a, _b)		_mm_xor_si128(_a, _b)
+
+// AESENC/AESDEC perform a full round (round key added last), so rounds 1 to Nr-1 use one instruction each
+#define AES_MID_ROUNDS_END	Nr
+#define AES_ENC_INIT(i)		s##i = _mm_xor_si128(s##i, k[0]);
+#define AES_ENC_ROUND(i)	s##i = _mm_aesenc_si128(s##i, k[r]);
+#define AES_ENC_LAST(i)		s##i = _mm_aesenclast_si128(s##i, k[Nr]);
+#define AES_DEC_INIT(i)		s##i = _mm_xor_si128(s##i, k[0]);
+#define AES_DEC_ROUND(i)	s##i = _mm_aesdec_si128(s##i, k[r]);
+#define AES_DEC_LAST(i)		s##i = _mm_aesdeclast_si128(s##i, k[Nr]);
+
+#else
+#include <arm_neon.h>
+
+typedef uint8x16_t aes_block;
+#define AES_LOAD(_p)		vld1q_u8((const u8 *)(_p))
+#define AES_STORE(_p, _v)	vst1q_u8((u8 *)(_p), _v)
+#define AES_XOR(_a, _b)		veorq_u8(_a, _b)
+
+// AESE/AESD add the round key first, so the last round key is added with a plain XOR
+#define AES_MID_ROUNDS_END	(Nr - 1)
+#define AES_ENC_INIT(i)		s##i = vaesmcq_u8(vaeseq_u8(s##i, k[0]));
+#define AES_ENC_ROUND(i)	s##i = vaesmcq_u8(vaeseq_u8(s##i, k[r]));
+#define AES_ENC_LAST(i)		s##i = veorq_u8(vaeseq_u8(s##i, k[Nr - 1]), k[Nr]);
+#define AES_DEC_INIT(i)		s##i = vaesimcq_u8(vaesdq_u8(s##i, k[0]));
+#define AES_DEC_ROUND(i)	s##i = vaesimcq_u8(vaesdq_u8(s##i, k[r]));
+#define AES_DEC_LAST(i)		s##i = veorq_u8(vaesdq_u8(s##i, k[Nr - 1]), k[Nr]);
+
+#endif
+
+#define AES_X4(_op)	_op(0) _op(1) _op(2) _op(3)
+#define AES_X8(_op)	AES_X4(_op) _op(4) _op(5) _op(6) _op(7)
+
+#define AES_LOAD_KEYS(_rk) \
+  for (r = 0; r <= Nr; ++r) k[r] = AES_LOAD((_rk) + r * AES_BLOCKLEN);
+
+#define AES_ENCRYPT(_X) \
+  _X(AES_ENC_INIT) \
+  for (r = 1; r < AES_MID_ROUNDS_END; ++r) { _X(AES_ENC_ROUND) } \
+  _X(AES_ENC_LAST)
+
+#define AES_DECRYPT(_X) \
+  _X(AES_DEC_INIT) \
+  for (r = 1; r < AES_MID_ROUNDS_END; ++r) { _X(AES_DEC_ROUND) } \
+  _X(AES_DEC_LAST)
+
+#define AES_X1(_op)	_op(0)
+
+static s32 aes_hw_support = -1;
+
+u8 AES_hw_available(void)
+{
+  if (aes_hw_support < 0)
+  {
+#if defined(AES_HW_X86) && defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 1);
+    aes_hw_support = ((regs[2] & (1 << 25)) && (regs[3] & (1 << 26))) ? 1 : 0;
+#elif defined(AES_HW_X86)
+    unsigned int a, b, c, d;
+    aes_hw_support = (__get_cpuid(1, &a, &b, &c, &d) && (c & (1 << 25)) && (d & (1 << 26))) ? 1 : 0;
+#elif defined(__APPLE__)
+    aes_hw_support = 1;
+#else
+    aes_hw_support = (getauxval(AT_HWCAP) & HWCAP_AES) ? 1 : 0;
+#endif
+  }
+  return (u8) aes_hw_support;
+}
+
+// writes the 128-bit big endian counter hi:lo to dst and increments it
+static GFINLINE void aes_hw_ctr_next(u8* dst, u64* hi, u64* lo)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  u64 v = __builtin_bswap64(*hi);
+  memcpy(dst, &v, 8);
+  v = __builtin_bswap64(*lo);
+  memcpy(dst + 8, &v, 8);
+#else
+  u8 i;
+  for (i = 0; i < 8; ++i)
+  {
+    dst[i] = (u8) (*hi >> (56 - 8 * i));
+    dst[8 + i] = (u8) (*lo >> (56 - 8 * i));
+  }
+#endif
+  (*lo)++;
+  if (! *lo) (*hi)++;
+}
+
+// CTR on nb_blocks full blocks, Iv is the counter of the first block and is updated to the counter following the last block
+AES_HW_TARGET static void aes_hw_ctr(const u8* RoundKey, u8* Iv, u8* buf, u32 nb_blocks)
+{
+  aes_block k[Nr + 1], s0, s1, s2, s3, s4, s5, s6, s7;
+  u8 ctr[8 * AES_BLOCKLEN];
+  u64 hi = 0, lo = 0;
+  u32 r, i;
+
+  for (i = 0; i < 8; ++i)
+  {
+    hi = (hi << 8) | Iv[i];
+    lo = (lo << 8) | Iv[8 + i];
+  }
+  AES_LOAD_KEYS(RoundKey)
+
+#define AES_CTR_LOAD(i)	s##i = AES_LOAD(ctr + i * AES_BLOCKLEN);
+#define AES_CTR_XOR(i)	AES_STORE(buf + i * AES_BLOCKLEN, AES_XOR(s##i, AES_LOAD(buf + i * AES_BLOCKLEN)));
+
+  while (nb_blocks >= 8)
+  {
+    for (i = 0; i < 8; ++i) aes_hw_ctr_next(ctr + i * AES_BLOCKLEN, &hi, &lo);
+    AES_X8(AES_CTR_LOAD)
+    AES_ENCRYPT(AES_X8)
+    AES_X8(AES_CTR_XOR)
+    buf += 8 * AES_BLOCKLEN;
+    nb_blocks -= 8;
+  }
+  if (nb_blocks >= 4)
+  {
+    for (i = 0; i < 4; ++i) aes_hw_ctr_next(ctr + i * AES_BLOCKLEN, &hi, &lo);
+    AES_X4(AES_CTR_LOAD)
+    AES_ENCRYPT(AES_X4)
+    AES_X4(AES_CTR_XOR)
+    buf += 4 * AES_BLOCKLEN;
+    nb_blocks -= 4;
+  }
+  while (nb_blocks)
+  {
+    aes_hw_ctr_next(ctr, &hi, &lo);
+    AES_CTR_LOAD(0)
+    AES_ENCRYPT(AES_X1)
+    AES_CTR_XOR(0)
+    buf += AES_BLOCKLEN;
+    nb_blocks--;
+  }
+  aes_hw_ctr_next(Iv, &hi, &lo);
+}
+
+AES_HW_TARGET static void aes_hw_cbc_encrypt(const u8* RoundKey, u8* Iv, u8* buf, u32 nb_blocks)
+{
+  aes_block k[Nr + 1], s0, iv;
+  u32 r;
+
+  AES_LOAD_KEYS(RoundKey)
+  iv = AES_LOAD(Iv);
+  while (nb_blocks)
+  {
+    s0 = AES_XOR(AES_LOAD(buf), iv);
+    AES_ENCRYPT(AES_X1)
+    AES_STORE(buf, s0);
+    iv = s0;
+    buf += AES_BLOCKLEN;
+    nb_blocks--;
+  }
+  AES_STORE(Iv, iv);
+}
+
+AES_HW_TARGET static void aes_hw_cbc_decrypt(const u8* DecRoundKey, u8* Iv, u8* buf, u32 nb_blocks)
+{
+  aes_block k[Nr + 1], s0, s1, s2, s3, s4, s5, s6, s7, c0, c1, c2, c3, c4, c5, c6, c7, iv;
+  u32 r;
+
+  AES_LOAD_KEYS(DecRoundKey)
+  iv = AES_LOAD(Iv);
+
+#define AES_CBC_LOAD(i)	c##i = s##i = AES_LOAD(buf + i * AES_BLOCKLEN);
+
+  while (nb_blocks >= 8)
+  {
+    AES_X8(AES_CBC_LOAD)
+    AES_DECRYPT(AES_X8)
+    AES_STORE(buf, AES_XOR(s0, iv));
+    AES_STORE(buf + 1 * AES_BLOCKLEN, AES_XOR(s1, c0));
+    AES_STORE(buf + 2 * AES_BLOCKLEN, AES_XOR(s2, c1));
+    AES_STORE(buf + 3 * AES_BLOCKLEN, AES_XOR(s3, c2));
+    AES_STORE(buf + 4 * AES_BLOCKLEN, AES_XOR(s4, c3));
+    AES_STORE(buf + 5 * AES_BLOCKLEN, AES_XOR(s5, c4));
+    AES_STORE(buf + 6 * AES_BLOCKLEN, AES_XOR(s6, c5));
+    AES_STORE(buf + 7 * AES_BLOCKLEN, AES_XOR(s7, c6));
+    iv = c7;
+    buf += 8 * AES_BLOCKLEN;
+    nb_blocks -= 8;
+  }
+  if (nb_blocks >= 4)
+  {
+    AES_X4(AES_CBC_LOAD)
+    AES_DECRYPT(AES_X4)
+    AES_STORE(buf, AES_XOR(s0, iv));
+    AES_STORE(buf + 1 * AES_BLOCKLEN, AES_XOR(s1, c0));
+    AES_STORE(buf + 2 * AES_BLOCKLEN, AES_XOR(s2, c1));
+    AES_STORE(buf + 3 * AES_BLOCKLEN, AES_XOR(s3, c2));
+    iv = c3;
+    buf += 4 * AES_BLOCKLEN;
+    nb_blocks -= 4;
+  }
+  while (nb_blocks)
+  {
+    AES_CBC_LOAD(0)
+    AES_DECRYPT(AES_X1)
+    AES_STORE(buf, AES_XOR(s0, iv));
+    iv = c0;
+    buf += AES_BLOCKLEN;
+    nb_blocks--;
+  }
+  AES_STORE(Iv, iv);
+}
+
+#else
+
+u8 AES_hw_available(void)
+{
+  return 0;
+}
+
+#endif // AES_HW
+
+
 /*****************************************************************************/
 /* Public functions:                                                         */
 /*****************************************************************************/
@@ -512,6 +791,13 @@ void AES_CBC_encrypt_buffer(struct AES_ctx *ctx,u8* buf, u32 length)
 {
   uintptr_t i;
   u8 *Iv = ctx->Iv;
+#ifdef AES_HW
+  if (ctx->hw)
+  {
+    aes_hw_cbc_encrypt(ctx->RoundKey, ctx->Iv, buf, length / AES_BLOCKLEN);
+    return;
+  }
+#endif
   for (i = 0; i < length; i += AES_BLOCKLEN)
   {
     XorWithIv(buf, Iv);
@@ -528,6 +814,13 @@ void AES_CBC_decrypt_buffer(struct AES_ctx* ctx, u8* buf,  u32 length)
 {
   uintptr_t i;
   u8 storeNextIv[AES_BLOCKLEN];
+#ifdef AES_HW
+  if (ctx->hw)
+  {
+    aes_hw_cbc_decrypt(ctx->DecRoundKey, ctx->Iv, buf, length / AES_BLOCKLEN);
+    return;
+  }
+#endif
   for (i = 0; i < length; i += AES_BLOCKLEN)
   {
     memcpy(storeNextIv, buf, AES_BLOCKLEN);
@@ -552,6 +845,37 @@ void AES_CTR_xcrypt_buffer(struct AES_ctx* ctx, u8* buf, u32 length)
   int bi = (AES_BLOCKLEN - ctx->counter_pos);
   assert(ctx->counter_pos<AES_BLOCKLEN);
 
+#ifdef AES_HW
+  if (ctx->hw)
+  {
+    u32 nb_blocks;
+    /* use remaining bytes of the current xor compliment */
+    while (ctx->counter_pos && length)
+    {
+      *buf++ ^= ctx->buffer[AES_BLOCKLEN - ctx->counter_pos];
+      ctx->counter_pos--;
+      length--;
+    }
+    nb_blocks = length / AES_BLOCKLEN;
+    if (nb_blocks)
+    {
+      aes_hw_ctr(ctx->RoundKey, ctx->Iv, buf, nb_blocks);
+      buf += nb_blocks * AES_BLOCKLEN;
+      length -= nb_blocks * AES_BLOCKLEN;
+    }
+    if (length)
+    {
+      /* regen xor compliment for the last partial block */
+      memset(ctx->buffer, 0, AES_BLOCKLEN);
+      aes_hw_ctr(ctx->RoundKey, ctx->Iv, ctx->buffer, 1);
+      for (i = 0; i < length; ++i)
+        buf[i] ^= ctx->buffer[i];
+      ctx->counter_pos = AES_BLOCKLEN - length;
+    }
+    return;
+  }
+#endif
+
   for (i = 0; i < length; ++i, ++bi)
   {
     if (bi == AES_BLOCKLEN) /* we need to regen xor compliment in buffer */
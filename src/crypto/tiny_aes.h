@@ -43,6 +43,9 @@
 struct AES_ctx
 {
   u8 RoundKey[AES_keyExpSize];
+  // set before key init to use hardware AES (see AES_hw_available); decryption round keys are then also computed
+  u8 hw;
+  u8 DecRoundKey[AES_keyExpSize];
 #if (defined(CBC) && (CBC == 1)) || (defined(CTR) && (CTR == 1))
   u8 Iv[AES_BLOCKLEN];
   u8 counter_pos;
@@ -50,6 +53,9 @@ struct AES_ctx
 #endif
 };
 
+// returns 1 if AES instructions (AES-NI or ARMv8 crypto extensions) are available on this CPU, 0 otherwise
+u8 AES_hw_available(void);
+
 void AES_init_ctx(struct AES_ctx* ctx, const u8* key);
 #if (defined(CBC) && (CBC == 1)) || (defined(CTR) && (CTR == 1))
 void AES_init_ctx_iv(struct AES_ctx* ctx, const u8* key, const u8* iv);
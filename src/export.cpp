@@ -125,11 +125,14 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_set_progress_callback) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_file_delete) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_file_move) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_file_replace) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_file_temp) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_file_modification_time) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_fwrite) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_fopen) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_fclose) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_fopen_aio) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_file_is_aio) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_fseek) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_ftell) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_fread) )
@@ -302,6 +305,8 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_send_wait) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_receive_wait) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_receive_no_select) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_receive_batch) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_send_batch) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_set_usec_wait) )
 
 #pragma comment (linker, EXPORT_SYMBOL(gf_url_is_local) )
@@ -1179,6 +1184,9 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_streamer_send_rtcp) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_streamer_get_payload_type) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_streamer_set_interleave_callbacks) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_streamer_set_send_batch) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_streamer_flush) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_streamer_get_send_stats) )
 
 #endif
 
@@ -1302,12 +1310,16 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_get_current_time) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_reset_buffers) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_read_rtp) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_read_rtp_batch) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_read_rtcp) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_decode_rtp) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_decode_rtcp) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_send_rtcp_report) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_send_bye) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_send_packet) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_set_send_batch) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_flush_send) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_get_send_stats) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_is_unicast) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_is_interleaved) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_get_clockrate) )
@@ -1463,6 +1475,13 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_crypt_encrypt) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_crypt_set_key) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_crypt_set_IV) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_crypt_job_add_range) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_crypt_job_reset) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_crypt_job_run) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_crypt_pool_new) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_crypt_pool_del) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_crypt_pool_post) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_crypt_pool_job_done) )
 #endif GPAC_DISABLE_CRYPTO
 
 #pragma comment (linker, EXPORT_SYMBOL(gf_sha1_csum) )
@@ -2030,6 +2049,7 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_program_stream_add) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_mux_update_config) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_mux_process) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_mux_process_block) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_get_sys_clock) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_get_ts_clock) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_mux_use_single_au_pes_mode) )
@@ -2043,6 +2063,9 @@
 /* M3U8 & MPD related functions */
 #pragma comment (linker, EXPORT_SYMBOL(gf_mpd_new) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_mpd_init_from_dom) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_mpd_init_from_file) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_mpd_merge_file) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_mpd_apply_patch) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_mpd_del) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_m3u8_to_mpd) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_mpd_smooth_to_mpd) )
@@ -2053,6 +2076,7 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_m3u8_parse_master_playlist) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_mpd_write) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_mpd_write_file) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_mpd_write_m3u8_master_playlist) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_mpd_get_base_url_count) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_mpd_resolve_url) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_mpd_get_duration) )
@@ -2234,6 +2258,8 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_dash_group_get_num_components) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dash_all_groups_done) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dash_set_period_xlink_query_string) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_dash_set_manifest_update_mode) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_dash_get_manifest_stats) )
 
 #endif
 
@@ -2260,6 +2286,8 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_route_dmx_get_last_packet_time) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_route_dmx_get_nb_packets) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_route_dmx_get_recv_bytes) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_route_dmx_get_nb_recv_calls) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_route_dmx_set_batch) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_route_dmx_set_service_udta) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_route_dmx_get_service_udta) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_route_dmx_debug_tsi) )
@@ -34,10 +34,22 @@ void gf_void_del(void *p)
 void gf_filterpacket_del(void *p)
 {
 	GF_FilterPacket *pck=(GF_FilterPacket *)p;
-	if (pck->data) gf_free(pck->data);
+	gf_filter_pck_free_data(pck->session, pck);
 	gf_free(p);
 }
 
+void gf_filter_reset_pck_reservoirs(GF_Filter *filter)
+{
+	void *item;
+	//this is only called by the thread processing the filter, which is the only one popping from these queues
+	while ((item = gf_fq_pop(filter->pcks_alloc_reservoir))) {
+		gf_filterpacket_del(item);
+	}
+	while ((item = gf_fq_pop(filter->pcks_inst_reservoir))) {
+		gf_free(item);
+	}
+}
+
 static void gf_filter_parse_args(GF_Filter *filter, const char *args, GF_FilterArgType arg_type, Bool for_script);
 
 const char *gf_fs_path_escape_colon(GF_FilterSession *sess, const char *path)
@@ -208,6 +220,8 @@ GF_Filter *gf_filter_new(GF_FilterSession *fsess, const GF_FilterRegister *freg,
 
 	filter->bundle_idx_at_resolution = -1;
 	filter->cap_idx_at_resolution = -1;
+	filter->numa_node = -1;
+	filter->last_node = -1;
 
 	if (fsess->filters_mx) gf_mx_p(fsess->filters_mx);
 	gf_list_add(fsess->filters, filter);
@@ -1442,6 +1456,14 @@ skip_date:
 				internal_arg = GF_TRUE;
 				opts_optional = GF_TRUE;
 			}
+			//NUMA node
+			else if (!strcmp("NODE", szArg)) {
+				if (value && ((arg_type==GF_FILTER_ARG_EXPLICIT_SINK) || (arg_type==GF_FILTER_ARG_EXPLICIT) || (arg_type==GF_FILTER_ARG_EXPLICIT_SOURCE))) {
+					filter->numa_node = atoi(value);
+				}
+				found = GF_TRUE;
+				internal_arg = GF_TRUE;
+			}
 			//filter tag
 			else if (!strcmp("TAG", szArg)) {
 				if (! filter->dynamic_filter) {
@@ -2517,6 +2539,13 @@ void gf_filter_ask_rt_reschedule(GF_Filter *filter, u32 us_until_next)
 	GF_LOG(GF_LOG_DEBUG, GF_LOG_SCHEDULER, ("Filter %s real-time reschedule in %d us (at "LLU" sys clock)\n", filter->name, us_until_next, filter->schedule_next_time));
 }
 
+GF_EXPORT
+Bool gf_filter_is_last_task(GF_Filter *filter)
+{
+	if (!filter) return GF_TRUE;
+	return gf_fs_is_last_task(filter->session);
+}
+
 GF_EXPORT
 void gf_filter_set_setup_failure_callback(GF_Filter *filter, GF_Filter *source_filter, void (*on_setup_error)(GF_Filter *f, void *on_setup_error_udta, GF_Err e), void *udta)
 {
@@ -36,6 +36,29 @@ static void gf_filter_pck_reset_props(GF_FilterPacket *pck, GF_FilterPid *pid)
 	pck->session = pid->filter->session;
 }
 
+//packet property maps may be shared between packets (merge, clone, property references), copy the map before modifying it
+static GF_Err gf_filter_pck_props_make_writable(GF_FilterPacket *pck)
+{
+	GF_Err e;
+	GF_PropertyMap *map;
+	if (!pck->props || (pck->props->reference_count<=1))
+		return GF_OK;
+
+	map = gf_props_new(pck->pid->filter);
+	if (!map) return GF_OUT_OF_MEM;
+	e = gf_props_merge_property(map, pck->props, NULL, NULL);
+	if (e) {
+		safe_int_dec(&map->reference_count);
+		gf_props_del(map);
+		return e;
+	}
+	if (safe_int_dec(&pck->props->reference_count) == 0) {
+		gf_props_del(pck->props);
+	}
+	pck->props = map;
+	return GF_OK;
+}
+
 GF_EXPORT
 GF_Err gf_filter_pck_merge_properties_filter(GF_FilterPacket *pck_src, GF_FilterPacket *pck_dst, gf_filter_prop_filter filter_prop, void *cbk)
 {
@@ -55,9 +78,18 @@ GF_Err gf_filter_pck_merge_properties_filter(GF_FilterPacket *pck_src, GF_Filter
 		return GF_OK;
 	}
 	if (!pck_dst->props) {
+		//no filtering, share the source map until one of the packets modifies it
+		if (!filter_prop) {
+			pck_dst->props = pck_src->props;
+			safe_int_inc(&pck_dst->props->reference_count);
+			return GF_OK;
+		}
 		pck_dst->props = gf_props_new(pck_dst->pid->filter);
 
 		if (!pck_dst->props) return GF_OUT_OF_MEM;
+	} else {
+		GF_Err e = gf_filter_pck_props_make_writable(pck_dst);
+		if (e) return e;
 	}
 	return gf_props_merge_property(pck_dst->props, pck_src->props, filter_prop, cbk);
 }
@@ -68,6 +100,241 @@ GF_Err gf_filter_pck_merge_properties(GF_FilterPacket *pck_src, GF_FilterPacket
 	return gf_filter_pck_merge_properties_filter(pck_src, pck_dst, NULL, NULL);
 }
 
+GF_FilterSlab *gf_fs_slab_new(u64 max_bytes)
+{
+	GF_FilterSlab *slab;
+	GF_SAFEALLOC(slab, GF_FilterSlab);
+	if (!slab) return NULL;
+	slab->mx = gf_mx_new("FilterSlab");
+	if (!slab->mx) {
+		gf_free(slab);
+		return NULL;
+	}
+	slab->max_bytes = max_bytes;
+	return slab;
+}
+
+//sizes above the largest class are not pooled and are allocated with their exact size, not rounded up
+static u32 gf_fs_slab_get_class(u32 size)
+{
+	u32 c = 0;
+	u32 block_size = 1<<GF_SLAB_MIN_SHIFT;
+	if (size > (1<<(GF_SLAB_MIN_SHIFT+GF_SLAB_NB_CLASSES-1))) return GF_SLAB_NB_CLASSES;
+	while (block_size < size) {
+		c++;
+		if (c>=GF_SLAB_NB_CLASSES) return GF_SLAB_NB_CLASSES;
+		block_size <<= 1;
+	}
+	return c;
+}
+
+//keep at most 4 MB per class in thread magazines
+static u32 gf_fs_slab_get_mag_size(u32 c)
+{
+	u32 shift = GF_SLAB_MIN_SHIFT + c;
+	if (shift>=22) return 1;
+	shift = 22 - shift;
+	if (shift>=3) return GF_SLAB_MAG_SIZE;
+	return 1<<shift;
+}
+
+static void *gf_fs_slab_block_new(u32 c)
+{
+	return gf_malloc(1 << (GF_SLAB_MIN_SHIFT + c));
+}
+
+static void gf_fs_slab_block_del(void *block, u32 c)
+{
+	gf_free(block);
+}
+
+static void gf_fs_slab_flush_magazines(GF_SessionThread *sess_th)
+{
+	u32 c;
+	if (!sess_th->slab_mags) return;
+	for (c=0; c<GF_SLAB_NB_CLASSES; c++) {
+		GF_SlabMagazine *mag = &sess_th->slab_mags[c];
+		while (mag->nb_blocks) {
+			mag->nb_blocks--;
+			gf_fs_slab_block_del(mag->blocks[mag->nb_blocks], c);
+		}
+	}
+	gf_free(sess_th->slab_mags);
+	sess_th->slab_mags = NULL;
+}
+
+void gf_fs_slab_del(GF_FilterSession *fsess)
+{
+	u32 i, c;
+	GF_FilterSlab *slab = fsess->slab;
+	if (!slab) return;
+
+	gf_fs_slab_flush_magazines(&fsess->main_th);
+	for (i=0; i<gf_list_count(fsess->threads); i++) {
+		gf_fs_slab_flush_magazines(gf_list_get(fsess->threads, i));
+	}
+	for (c=0; c<GF_SLAB_NB_CLASSES; c++) {
+		GF_SlabDepot *depot = &slab->depots[c];
+		while (depot->nb_blocks) {
+			depot->nb_blocks--;
+			gf_fs_slab_block_del(depot->blocks[depot->nb_blocks], c);
+		}
+		if (depot->blocks) gf_free(depot->blocks);
+	}
+	gf_mx_del(slab->mx);
+	gf_free(slab);
+	fsess->slab = NULL;
+}
+
+static void *gf_fs_slab_alloc(GF_FilterSession *fsess, u32 c)
+{
+	u64 used;
+	void *block = NULL;
+	GF_FilterSlab *slab = fsess->slab;
+	u32 size = 1 << (GF_SLAB_MIN_SHIFT + c);
+	GF_SessionThread *sess_th = gf_fs_get_current_thread(fsess);
+
+	if (sess_th && sess_th->slab_mags && sess_th->slab_mags[c].nb_blocks) {
+		GF_SlabMagazine *mag = &sess_th->slab_mags[c];
+		mag->nb_blocks--;
+		block = mag->blocks[mag->nb_blocks];
+		sess_th->nb_slab_hits++;
+	} else if (slab->depots[c].nb_blocks) {
+		GF_SlabDepot *depot = &slab->depots[c];
+		gf_mx_p(slab->mx);
+		if (depot->nb_blocks) {
+			depot->nb_blocks--;
+			block = depot->blocks[depot->nb_blocks];
+			slab->nb_depot_hits++;
+		}
+		gf_mx_v(slab->mx);
+	}
+
+	if (block) {
+		safe_int64_sub(&slab->bytes_held, size);
+	} else {
+		block = gf_fs_slab_block_new(c);
+		if (!block) return NULL;
+		safe_int_inc(&slab->nb_misses);
+	}
+	used = safe_int64_add(&slab->bytes_used, size);
+	if (used > slab->peak_used) slab->peak_used = used;
+	return block;
+}
+
+static void gf_fs_slab_free(GF_FilterSession *fsess, void *block, u32 c)
+{
+	u64 held;
+	GF_SessionThread *sess_th;
+	GF_SlabDepot *depot;
+	GF_FilterSlab *slab = fsess->slab;
+	u32 size = 1 << (GF_SLAB_MIN_SHIFT + c);
+
+	//slab already destroyed, give the block back to the system
+	if (!slab) {
+		gf_fs_slab_block_del(block, c);
+		return;
+	}
+	safe_int64_sub(&slab->bytes_used, size);
+	//reserve the bytes before checking the ceiling, so that concurrent frees cannot both pass the check
+	held = safe_int64_add(&slab->bytes_held, size);
+	//memory ceiling reached, give the block back to the system
+	if (held > slab->max_bytes) {
+		safe_int64_sub(&slab->bytes_held, size);
+		gf_fs_slab_block_del(block, c);
+		safe_int_inc(&slab->nb_drops);
+		return;
+	}
+	if (held > slab->peak_held) slab->peak_held = held;
+
+	sess_th = gf_fs_get_current_thread(fsess);
+	if (sess_th) {
+		if (!sess_th->slab_mags) {
+			sess_th->slab_mags = gf_malloc(sizeof(GF_SlabMagazine) * GF_SLAB_NB_CLASSES);
+			if (sess_th->slab_mags)
+				memset(sess_th->slab_mags, 0, sizeof(GF_SlabMagazine) * GF_SLAB_NB_CLASSES);
+		}
+		if (sess_th->slab_mags) {
+			GF_SlabMagazine *mag = &sess_th->slab_mags[c];
+			if (mag->nb_blocks < gf_fs_slab_get_mag_size(c)) {
+				mag->blocks[mag->nb_blocks] = block;
+				mag->nb_blocks++;
+				return;
+			}
+		}
+	}
+
+	depot = &slab->depots[c];
+	gf_mx_p(slab->mx);
+	if (depot->nb_blocks == depot->nb_alloc) {
+		void **blocks = gf_realloc(depot->blocks, sizeof(void *) * (depot->nb_alloc + 16));
+		if (!blocks) {
+			gf_mx_v(slab->mx);
+			safe_int64_sub(&slab->bytes_held, size);
+			gf_fs_slab_block_del(block, c);
+			return;
+		}
+		depot->blocks = blocks;
+		depot->nb_alloc += 16;
+	}
+	depot->blocks[depot->nb_blocks] = block;
+	depot->nb_blocks++;
+	gf_mx_v(slab->mx);
+}
+
+void gf_filter_pck_free_data(GF_FilterSession *fsess, GF_FilterPacket *pck)
+{
+	if (pck->data) {
+		if (pck->slab_class) {
+			gf_fs_slab_free(fsess, pck->data, pck->slab_class-1);
+		} else {
+			gf_free(pck->data);
+		}
+	}
+	pck->data = NULL;
+	pck->alloc_size = 0;
+	pck->slab_class = 0;
+}
+
+Bool gf_filter_pck_alloc_data(GF_FilterSession *fsess, GF_FilterPacket *pck, u32 size, Bool keep_data)
+{
+	char *data;
+	u32 c = GF_SLAB_NB_CLASSES;
+
+	if (fsess->slab) {
+		c = gf_fs_slab_get_class(size);
+		if (c == GF_SLAB_NB_CLASSES)
+			safe_int_inc(&fsess->slab->nb_oversize);
+	}
+
+	if (c < GF_SLAB_NB_CLASSES) {
+		data = gf_fs_slab_alloc(fsess, c);
+		if (!data) return GF_FALSE;
+		if (keep_data && pck->data && pck->data_length)
+			memcpy(data, pck->data, MIN(pck->data_length, size));
+		gf_filter_pck_free_data(fsess, pck);
+		pck->data = data;
+		pck->alloc_size = 1 << (GF_SLAB_MIN_SHIFT + c);
+		pck->slab_class = c+1;
+		return GF_TRUE;
+	}
+
+	if (keep_data && pck->data && !pck->slab_class) {
+		data = gf_realloc(pck->data, sizeof(char)*size);
+		if (!data) return GF_FALSE;
+	} else {
+		data = gf_malloc(sizeof(char)*size);
+		if (!data) return GF_FALSE;
+		if (keep_data && pck->data && pck->data_length)
+			memcpy(data, pck->data, MIN(pck->data_length, size));
+		gf_filter_pck_free_data(fsess, pck);
+	}
+	pck->data = data;
+	pck->alloc_size = size;
+	pck->slab_class = 0;
+	return GF_TRUE;
+}
+
 typedef struct
 {
 	u32 data_size;
@@ -126,8 +393,8 @@ static GF_FilterPacket *gf_filter_pck_new_alloc_internal(GF_FilterPid *pid, u32
 
 	if (!pck && (count>=max_reservoir_size)) {
 		assert(closest);
-		closest->alloc_size = data_size;
-		closest->data = gf_realloc(closest->data, closest->alloc_size);
+		if (!gf_filter_pck_alloc_data(pid->filter->session, closest, data_size, GF_FALSE))
+			return NULL;
 		pck = closest;
 #ifdef GPAC_MEMORY_TRACKING
 		pid->filter->session->nb_realloc_pck++;
@@ -138,8 +405,10 @@ static GF_FilterPacket *gf_filter_pck_new_alloc_internal(GF_FilterPid *pid, u32
 		GF_SAFEALLOC(pck, GF_FilterPacket);
 		if (!pck)
 			return NULL;
-		pck->data = gf_malloc(sizeof(char)*data_size);
-		pck->alloc_size = data_size;
+		if (!gf_filter_pck_alloc_data(pid->filter->session, pck, data_size, GF_FALSE)) {
+			gf_free(pck);
+			return NULL;
+		}
 #ifdef GPAC_MEMORY_TRACKING
 		pid->filter->session->nb_alloc_pck+=2;
 #endif
@@ -152,10 +421,13 @@ static GF_FilterPacket *gf_filter_pck_new_alloc_internal(GF_FilterPid *pid, u32
 		GF_FilterPacket *head_pck = gf_fq_pop(pid->filter->pcks_alloc_reservoir);
 		char *pck_data = pck->data;
 		u32 alloc_size = pck->alloc_size;
+		u32 slab_class = pck->slab_class;
 		pck->data = head_pck->data;
 		pck->alloc_size = head_pck->alloc_size;
+		pck->slab_class = head_pck->slab_class;
 		head_pck->data = pck_data;
 		head_pck->alloc_size = alloc_size;
+		head_pck->slab_class = slab_class;
 		pck = head_pck;
 	}
 
@@ -532,7 +804,7 @@ void gf_filter_packet_destroy(GF_FilterPacket *pck)
 			gf_free(pck);
 		}
 	} else if (is_filter_destroyed) {
-		if (!pck->filter_owns_mem && pck->data) gf_free(pck->data);
+		if (!pck->filter_owns_mem) gf_filter_pck_free_data(pck->session, pck);
 		gf_free(pck);
 	} else if (pck->filter_owns_mem ) {
 		if (pid->filter && pid->filter->pcks_shared_reservoir) {
@@ -544,7 +816,7 @@ void gf_filter_packet_destroy(GF_FilterPacket *pck)
 		if (pid->filter && pid->filter->pcks_alloc_reservoir) {
 			gf_fq_add(pid->filter->pcks_alloc_reservoir, pck);
 		} else {
-			if (pck->data) gf_free(pck->data);
+			gf_filter_pck_free_data(pck->session, pck);
 			gf_free(pck);
 		}
 	}
@@ -698,7 +970,44 @@ void gf_filter_pck_discard(GF_FilterPacket *pck)
 	}
 }
 
-GF_Err gf_filter_pck_send_internal(GF_FilterPacket *pck, Bool from_filter)
+static void gf_filter_pid_inst_batch_add(GF_FilterPidInst *dst, GF_FilterPacketInstance *inst)
+{
+	if (dst->nb_batch_insts == dst->alloc_batch_insts) {
+		GF_FilterPacketInstance **insts = gf_realloc(dst->batch_insts, sizeof(GF_FilterPacketInstance *) * (dst->alloc_batch_insts + 16));
+		if (!insts) {
+			//cannot grow, dispatch directly
+			safe_int_inc(&dst->filter->pending_packets);
+			gf_fq_add(dst->packets, inst);
+			return;
+		}
+		dst->batch_insts = insts;
+		dst->alloc_batch_insts += 16;
+	}
+	dst->batch_insts[dst->nb_batch_insts] = inst;
+	dst->nb_batch_insts++;
+}
+
+//enqueues all packet instances pending for the destination and posts a single process task
+static void gf_filter_pid_inst_batch_flush(GF_FilterPid *pid, GF_FilterPidInst *dst)
+{
+	u32 nb_pck;
+	if (!dst->nb_batch_insts) return;
+
+	safe_int_add(&dst->filter->pending_packets, dst->nb_batch_insts);
+	gf_fq_add_batch(dst->packets, (void **) dst->batch_insts, dst->nb_batch_insts);
+	dst->nb_batch_insts = 0;
+
+	//same as in gf_filter_pck_send_internal, but done once for the whole batch
+	gf_mx_p(pid->filter->tasks_mx);
+	nb_pck = gf_fq_count(dst->packets);
+	if (pid->nb_buffer_unit < nb_pck) pid->nb_buffer_unit = nb_pck;
+	if ((s64) pid->buffer_duration < dst->buffer_duration) pid->buffer_duration = dst->buffer_duration;
+	gf_mx_v(pid->filter->tasks_mx);
+
+	gf_filter_post_process_task_internal(dst->filter, pid->direct_dispatch);
+}
+
+static GF_Err gf_filter_pck_send_ex(GF_FilterPacket *pck, Bool from_filter, Bool in_batch)
 {
 	u32 i, count, nb_dispatch=0, nb_discard=0;
 	GF_FilterPid *pid;
@@ -999,6 +1308,10 @@ GF_Err gf_filter_pck_send_internal(GF_FilterPacket *pck, Bool from_filter)
 			continue;
 		}
 
+		//keep packet order for this destination
+		if (in_batch && cktype)
+			gf_filter_pid_inst_batch_flush(pid, dst);
+
 		inst = gf_fq_pop(pck->pid->filter->pcks_inst_reservoir);
 		if (!inst) {
 			GF_SAFEALLOC(inst, GF_FilterPacketInstance);
@@ -1078,30 +1391,24 @@ GF_Err gf_filter_pck_send_internal(GF_FilterPacket *pck, Bool from_filter)
 				//consumable until end of block is received, and source might be waiting for this packet to be freed to dispatch further packets
 				if (inst->pck->filter_owns_mem) {
 					u8 *data;
-					u32 alloc_size;
+					u32 alloc_size, slab_class;
 					inst->pck = gf_filter_pck_new_alloc_internal(pck->pid, pck->data_length, &data, GF_TRUE);
 					alloc_size = inst->pck->alloc_size;
+					slab_class = inst->pck->slab_class;
 					memcpy(inst->pck, pck, sizeof(GF_FilterPacket));
 					inst->pck->pck = inst->pck;
 					inst->pck->data = data;
 					memcpy(inst->pck->data, pck->data, pck->data_length);
 					inst->pck->alloc_size = alloc_size;
+					inst->pck->slab_class = slab_class;
 					inst->pck->filter_owns_mem = 0;
 					inst->pck->reference_count = 0;
 					inst->pck->reference = NULL;
 					inst->pck->destructor = NULL;
 					inst->pck->frame_ifce = NULL;
-					if (pck->props) {
-						GF_Err e;
-						inst->pck->props = gf_props_new(pck->pid->filter);
-						if (inst->pck->props) {
-							e = gf_props_merge_property(inst->pck->props, pck->props, NULL, NULL);
-						} else {
-							e = GF_OUT_OF_MEM;
-						}
-						if (e) {
-							GF_LOG(GF_LOG_ERROR, GF_LOG_FILTER, ("Filter %s: failed to copy properties for cloned packet: %s\n", pid->filter->name, gf_error_to_string(e) ));
-						}
+					//property map is shared and copied on write
+					if (inst->pck->props) {
+						safe_int_inc(&inst->pck->props->reference_count);
 					}
 					if (inst->pck->pid_props) {
 						safe_int_inc(&inst->pck->pid_props->reference_count);
@@ -1138,8 +1445,12 @@ GF_Err gf_filter_pck_send_internal(GF_FilterPacket *pck, Bool from_filter)
 				duration /= timescale;
 				safe_int64_add(&dst->buffer_duration, duration);
 			}
+			if (in_batch) {
+				gf_filter_pid_inst_batch_add(dst, inst);
+				pid->batch_pending = GF_TRUE;
+				continue;
+			}
 			safe_int_inc(&dst->filter->pending_packets);
-//
 			gf_fq_add(dst->packets, inst);
 			post_task = GF_TRUE;
 		}
@@ -1168,7 +1479,8 @@ GF_Err gf_filter_pck_send_internal(GF_FilterPacket *pck, Bool from_filter)
 	}
 #endif
 
-	gf_filter_pid_would_block(pid);
+	if (!in_batch)
+		gf_filter_pid_would_block(pid);
 
 	//unprotect the packet now that it is safely dispatched
 	assert(pck->reference_count);
@@ -1186,6 +1498,11 @@ GF_Err gf_filter_pck_send_internal(GF_FilterPacket *pck, Bool from_filter)
 	return GF_OK;
 }
 
+GF_Err gf_filter_pck_send_internal(GF_FilterPacket *pck, Bool from_filter)
+{
+	return gf_filter_pck_send_ex(pck, from_filter, GF_FALSE);
+}
+
 GF_EXPORT
 GF_Err gf_filter_pck_send(GF_FilterPacket *pck)
 {
@@ -1193,6 +1510,57 @@ GF_Err gf_filter_pck_send(GF_FilterPacket *pck)
 	return gf_filter_pck_send_internal(pck, GF_TRUE);
 }
 
+GF_EXPORT
+GF_Err gf_filter_pck_send_batch(GF_FilterPacket **pcks, u32 nb_pcks)
+{
+	u32 i, count;
+	GF_Filter *filter = NULL;
+	GF_Err e = GF_OK;
+
+	if (!pcks || !nb_pcks) return GF_OK;
+
+	for (i=0; i<nb_pcks; i++) {
+		GF_Err ret;
+		GF_FilterPacket *pck = pcks[i];
+		if (!pck) {
+			e = GF_BAD_PARAM;
+			continue;
+		}
+		//invalid entry, destroy it if possible and go on with the rest of the batch
+		if (!pck->pid || !pck->src_filter || PCK_IS_INPUT(pck)) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_FILTER, ("Invalid packet %d in packet batch, discarding\n", i));
+			if (pck->pid && !PCK_IS_INPUT(pck)) gf_filter_pck_discard(pck);
+			if (!e) e = GF_BAD_PARAM;
+			continue;
+		}
+		if (!filter) filter = pck->pid->filter;
+
+		//packet from another filter, cannot be batched with the others
+		if (pck->pid->filter != filter) {
+			GF_LOG(GF_LOG_WARNING, GF_LOG_FILTER, ("Packet batch with packets from different filters (%s and %s), sending packet directly\n", filter->name, pck->pid->filter->name));
+			ret = gf_filter_pck_send_ex(pck, GF_TRUE, GF_FALSE);
+		} else {
+			ret = gf_filter_pck_send_ex(pck, GF_TRUE, GF_TRUE);
+		}
+		if ((ret<0) && !e) e = ret;
+	}
+	if (!filter) return e;
+
+	count = filter->num_output_pids;
+	for (i=0; i<count; i++) {
+		u32 j;
+		GF_FilterPid *pid = gf_list_get(filter->output_pids, i);
+		if (!pid->batch_pending) continue;
+		pid->batch_pending = GF_FALSE;
+		for (j=0; j<pid->num_destinations; j++) {
+			GF_FilterPidInst *dst = gf_list_get(pid->destinations, j);
+			gf_filter_pid_inst_batch_flush(pid, dst);
+		}
+		gf_filter_pid_would_block(pid);
+	}
+	return e;
+}
+
 GF_EXPORT
 GF_Err gf_filter_pck_ref(GF_FilterPacket **pck)
 {
@@ -1279,7 +1647,6 @@ const u8 *gf_filter_pck_get_data(GF_FilterPacket *pck, u32 *size)
 
 static GF_Err gf_filter_pck_set_property_full(GF_FilterPacket *pck, u32 prop_4cc, const char *prop_name, char *dyn_name, const GF_PropertyValue *value)
 {
-	u32 hash;
 	assert(pck);
 	assert(pck->pid);
 	if (PCK_IS_INPUT(pck)) {
@@ -1288,16 +1655,18 @@ static GF_Err gf_filter_pck_set_property_full(GF_FilterPacket *pck, u32 prop_4cc
 	}
 	//get true packet pointer
 	pck=pck->pck;
-	hash = gf_props_hash_djb2(prop_4cc, prop_name ? prop_name : dyn_name);
 
 	if (!pck->props) {
 		pck->props = gf_props_new(pck->pid->filter);
+		if (!pck->props) return GF_OUT_OF_MEM;
 	} else {
-		gf_props_remove_property(pck->props, hash, prop_4cc, prop_name ? prop_name : dyn_name);
+		GF_Err e = gf_filter_pck_props_make_writable(pck);
+		if (e) return e;
+		gf_props_remove_property(pck->props, prop_4cc, prop_name ? prop_name : dyn_name);
 	}
 	if (!value) return GF_OK;
 	
-	return gf_props_insert_property(pck->props, hash, prop_4cc, prop_name, dyn_name, value);
+	return gf_props_insert_property(pck->props, prop_4cc, prop_name, dyn_name, value);
 }
 
 GF_EXPORT
@@ -1640,8 +2009,8 @@ GF_Err gf_filter_pck_expand(GF_FilterPacket *pck, u32 nb_bytes_to_add, u8 **data
 		return GF_BAD_PARAM;
 
 	if (pck->data_length + nb_bytes_to_add > pck->alloc_size) {
-		pck->alloc_size = pck->data_length + nb_bytes_to_add;
-		pck->data = gf_realloc(pck->data, pck->alloc_size);
+		if (!gf_filter_pck_alloc_data(pck->session, pck, pck->data_length + nb_bytes_to_add, GF_TRUE))
+			return GF_OUT_OF_MEM;
 #ifdef GPAC_MEMORY_TRACKING
 		pck->pid->filter->session->nb_realloc_pck++;
 #endif
@@ -57,6 +57,7 @@ void gf_filter_pid_inst_del(GF_FilterPidInst *pidinst)
  	gf_fq_del(pidinst->packets, (gf_destruct_fun) pcki_del);
 	gf_mx_del(pidinst->pck_mx);
 	gf_list_del(pidinst->pck_reassembly);
+	if (pidinst->batch_insts) gf_free(pidinst->batch_insts);
 	if (pidinst->props) {
 		assert(pidinst->props->reference_count);
 		if (safe_int_dec(&pidinst->props->reference_count) == 0) {
@@ -688,6 +689,10 @@ static GF_Err gf_filter_pid_configure(GF_Filter *filter, GF_FilterPid *pid, GF_P
 		filter->num_input_pids = gf_list_count(filter->input_pids);
 		gf_mx_v(filter->tasks_mx);
 
+		//filters loaded during link resolution stay on the NUMA node of their source
+		if (filter->dynamic_filter && (filter->numa_node<0))
+			filter->numa_node = pid->filter->numa_node;
+
 		//new connection, update caps in case we have events using caps (buffer req) being sent
 		//while processing the configure (they would be dispatched on the source filter, not the dest one being
 		//processed here)
@@ -3666,12 +3671,13 @@ static void add_possible_link_destination(GF_List *possible_linked_resolutions,
 #if 0
 static void dump_pid_props(GF_FilterPid *pid)
 {
-	u32 idx = 0;
+	u32 idx = 0, p4cc;
+	const char *pname;
 	char szDump[GF_PROP_DUMP_ARG_SIZE];
-	const GF_PropertyEntry *p;
+	const GF_PropertyValue *p;
 	GF_PropertyMap *pmap = gf_list_get(pid->properties, 0);
-	while (pmap && (p = gf_list_enum(pmap->properties, &idx))) {
-		GF_LOG(GF_LOG_DEBUG, GF_LOG_FILTER, ("Pid prop %s: %s\n", gf_props_4cc_get_name(p->p4cc), gf_props_dump(p->p4cc, &p->prop, szDump, GF_PROP_DUMP_DATA_NONE) ));
+	while (pmap && (p = gf_props_enum_property(pmap, &idx, &p4cc, &pname))) {
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_FILTER, ("Pid prop %s: %s\n", p4cc ? gf_props_4cc_get_name(p4cc) : pname, gf_props_dump(p4cc, p, szDump, GF_PROP_DUMP_DATA_NONE) ));
 	}
 }
 #endif
@@ -626,25 +626,266 @@ Bool gf_props_equal(const GF_PropertyValue *p1, const GF_PropertyValue *p2)
 	return GF_FALSE;
 }
 
-#if GF_PROPS_HASHTABLE_SIZE
-GFINLINE u32 gf_props_hash_djb2(u32 p4cc, const char *str)
+static GFINLINE u32 gf_props_name_hash(const char *str)
 {
 	u32 hash = 5381;
+	int c;
+	while ( (c = *str++) )
+		hash = ((hash << 5) + hash) + c; /* hash * 33 + c */
+	return hash;
+}
 
-	if (p4cc) {
-		hash = ((hash << 5) + hash) + ((p4cc>>24)&0xFF);
-		hash = ((hash << 5) + hash) + ((p4cc>>16)&0xFF);
-		hash = ((hash << 5) + hash) + ((p4cc>>8)&0xFF);
-		hash = ((hash << 5) + hash) + (p4cc&0xFF);
-	} else {
-		int c;
-		while ( (c = *str++) )
-			hash = ((hash << 5) + hash) + c; /* hash * 33 + c */
+//atomic load and store used for lock-free lookup of interned names
+#if defined(WIN32) || defined(_WIN32_WCE)
+#define GF_PROPS_LOAD(_v) (u32) InterlockedCompareExchange((LONG volatile *) &(_v), 0, 0)
+#define GF_PROPS_STORE(_v, _val) InterlockedExchange((LONG volatile *) &(_v), (LONG) (_val))
+#define GF_PROPS_LOAD_PTR(_p) InterlockedCompareExchangePointer((PVOID volatile *) &(_p), NULL, NULL)
+#define GF_PROPS_STORE_PTR(_p, _val) InterlockedExchangePointer((PVOID volatile *) &(_p), (PVOID) (_val))
+#else
+#define GF_PROPS_LOAD(_v) __atomic_load_n(&(_v), __ATOMIC_ACQUIRE)
+#define GF_PROPS_STORE(_v, _val) __atomic_store_n(&(_v), _val, __ATOMIC_RELEASE)
+#define GF_PROPS_LOAD_PTR(_p) __atomic_load_n(&(_p), __ATOMIC_ACQUIRE)
+#define GF_PROPS_STORE_PTR(_p, _val) __atomic_store_n(&(_p), _val, __ATOMIC_RELEASE)
+#endif
+
+static void gf_props_names_add_index(GF_PropNames *tab, u32 id, u32 hash)
+{
+	u32 mask = tab->index_size - 1;
+	u32 pos = hash & mask;
+	while (tab->index[pos])
+		pos = (pos+1) & mask;
+	//name is set before publishing its id in the index
+	GF_PROPS_STORE(tab->index[pos], id);
+}
+
+static u32 gf_props_names_lookup(GF_PropNames *tab, const char *name, u32 hash)
+{
+	u32 id;
+	u32 mask = tab->index_size - 1;
+	u32 pos = hash & mask;
+	while ((id = GF_PROPS_LOAD(tab->index[pos]))) {
+		if (!strcmp(tab->names[id-1], name)) return id;
+		pos = (pos+1) & mask;
+	}
+	return 0;
+}
 
+//creates a new name table twice as large as the current one, with the same names and ids
+static GF_PropNames *gf_props_names_grow(GF_PropNames *prev)
+{
+	u32 i;
+	GF_PropNames *tab;
+	GF_SAFEALLOC(tab, GF_PropNames);
+	if (!tab) return NULL;
+	tab->max_names = prev ? 2*prev->max_names : 32;
+	//keep index at most half full
+	tab->index_size = 2*tab->max_names;
+	tab->names = gf_malloc(sizeof(char *) * tab->max_names);
+	tab->index = gf_malloc(sizeof(u32) * tab->index_size);
+	if (!tab->names || !tab->index) {
+		if (tab->names) gf_free(tab->names);
+		if (tab->index) gf_free(tab->index);
+		gf_free(tab);
+		return NULL;
+	}
+	memset(tab->index, 0, sizeof(u32) * tab->index_size);
+	if (prev) {
+		memcpy(tab->names, prev->names, sizeof(char *) * prev->nb_names);
+		tab->nb_names = prev->nb_names;
+		for (i=0; i<tab->nb_names; i++)
+			gf_props_names_add_index(tab, i+1, gf_props_name_hash(tab->names[i]));
 	}
-	return (hash % GF_PROPS_HASHTABLE_SIZE);
+	tab->prev = prev;
+	return tab;
+}
+
+u32 gf_props_get_name_id(GF_FilterSession *fsess, const char *name, Bool create)
+{
+	u32 id = 0, hash;
+	GF_PropNames *tab;
+	if (!name) return 0;
+
+	hash = gf_props_name_hash(name);
+	//tables are never modified once replaced and entries are only appended, lookups don't need the lock
+	tab = GF_PROPS_LOAD_PTR(fsess->prop_names);
+	if (tab) id = gf_props_names_lookup(tab, name, hash);
+	if (id || !create) return id;
+
+	gf_mx_p(fsess->prop_names_mx);
+	tab = fsess->prop_names;
+	if (tab) id = gf_props_names_lookup(tab, name, hash);
+	if (id) {
+		gf_mx_v(fsess->prop_names_mx);
+		return id;
+	}
+	if (!tab || (tab->nb_names == tab->max_names)) {
+		tab = gf_props_names_grow(tab);
+		if (!tab) {
+			gf_mx_v(fsess->prop_names_mx);
+			return 0;
+		}
+		GF_PROPS_STORE_PTR(fsess->prop_names, tab);
+	}
+	tab->names[tab->nb_names] = gf_strdup(name);
+	if (!tab->names[tab->nb_names]) {
+		gf_mx_v(fsess->prop_names_mx);
+		return 0;
+	}
+	tab->nb_names++;
+	id = tab->nb_names;
+	gf_props_names_add_index(tab, id, hash);
+	gf_mx_v(fsess->prop_names_mx);
+	return id;
+}
+
+void gf_props_names_del(GF_FilterSession *fsess)
+{
+	u32 i;
+	GF_PropNames *tab = fsess->prop_names;
+	if (!tab) return;
+	//the current table holds all names
+	for (i=0; i<tab->nb_names; i++)
+		gf_free(tab->names[i]);
+	while (tab) {
+		GF_PropNames *prev = tab->prev;
+		gf_free(tab->names);
+		gf_free(tab->index);
+		gf_free(tab);
+		tab = prev;
+	}
+	fsess->prop_names = NULL;
+}
+
+static GFINLINE u32 gf_props_key_hash(u32 p4cc, u32 name_id)
+{
+	u32 hash = (p4cc ? p4cc : (name_id ^ 0x9E3779B9)) * 2654435761U;
+	return hash ^ (hash>>16);
+}
+
+static GFINLINE Bool gf_props_key_match(const GF_PropertyEntry *p, u32 p4cc, u32 name_id)
+{
+	if (p4cc) return (p->p4cc==p4cc) ? GF_TRUE : GF_FALSE;
+	return (!p->p4cc && (p->name_id==name_id)) ? GF_TRUE : GF_FALSE;
+}
+
+static void gf_props_index_add(GF_PropertyMap *map, GF_PropertyEntry *p)
+{
+	u32 mask = map->index_size - 1;
+	u32 slot = gf_props_key_hash(p->p4cc, p->name_id) & mask;
+	while (map->index[slot])
+		slot = (slot+1) & mask;
+	map->index[slot] = p;
+}
+
+//removes an entry from the index, moving back the following entries of the probe sequence instead of rebuilding the index
+static void gf_props_index_remove(GF_PropertyMap *map, GF_PropertyEntry *p)
+{
+	u32 mask = map->index_size - 1;
+	u32 slot = gf_props_key_hash(p->p4cc, p->name_id) & mask;
+	u32 next;
+	while (map->index[slot] != p) {
+		if (!map->index[slot]) return;
+		slot = (slot+1) & mask;
+	}
+	next = slot;
+	while (1) {
+		u32 home;
+		GF_PropertyEntry *np;
+		next = (next+1) & mask;
+		np = map->index[next];
+		if (!np) break;
+		home = gf_props_key_hash(np->p4cc, np->name_id) & mask;
+		//entry can be moved to the free slot if its home position is not in ]slot, next]
+		if ((slot<next) ? ((home<=slot) || (home>next)) : ((home<=slot) && (home>next))) {
+			map->index[slot] = np;
+			slot = next;
+		}
+	}
+	map->index[slot] = NULL;
+}
+
+//rebuilds the index of properties, only used for maps with more than GF_PROPS_INLINE_SIZE properties
+//if the index cannot be grown, the previous one is kept while it has free slots, otherwise lookups fall back to a linear scan
+static void gf_props_index_rebuild(GF_PropertyMap *map)
+{
+	u32 i;
+	if (map->nb_props <= GF_PROPS_INLINE_SIZE) return;
+
+	//keep index at most half full
+	if (2*map->nb_props > map->index_size) {
+		GF_PropertyEntry **index;
+		u32 size = map->index_size ? map->index_size : 4*GF_PROPS_INLINE_SIZE;
+		while (2*map->nb_props > size) size *= 2;
+		index = gf_malloc(sizeof(GF_PropertyEntry *) * size);
+		if (index) {
+			if (map->index) gf_free(map->index);
+			map->index = index;
+			map->index_size = size;
+		} else if (map->nb_props >= map->index_size) {
+			if (map->index) gf_free(map->index);
+			map->index = NULL;
+			map->index_size = 0;
+			return;
+		}
+	}
+	memset(map->index, 0, sizeof(GF_PropertyEntry *) * map->index_size);
+	for (i=0; i<map->nb_props; i++)
+		gf_props_index_add(map, map->props[i]);
+}
+
+static GF_Err gf_props_append(GF_PropertyMap *map, GF_PropertyEntry *prop)
+{
+	if (map->nb_props == map->alloc_props) {
+		GF_PropertyEntry **props;
+		u32 alloc = 2*map->alloc_props;
+		if (map->props == map->inline_props) {
+			props = gf_malloc(sizeof(GF_PropertyEntry *) * alloc);
+			if (props) memcpy(props, map->inline_props, sizeof(GF_PropertyEntry *) * map->nb_props);
+		} else {
+			props = gf_realloc(map->props, sizeof(GF_PropertyEntry *) * alloc);
+		}
+		if (!props) return GF_OUT_OF_MEM;
+		map->props = props;
+		map->alloc_props = alloc;
+	}
+	map->props[map->nb_props] = prop;
+	map->nb_props++;
+
+	if (map->nb_props <= GF_PROPS_INLINE_SIZE) return GF_OK;
+	//first use of index, index full or not available
+	if ((map->nb_props == GF_PROPS_INLINE_SIZE+1) || (2*map->nb_props > map->index_size)) {
+		gf_props_index_rebuild(map);
+		return GF_OK;
+	}
+	gf_props_index_add(map, prop);
+	return GF_OK;
+}
+
+static GF_PropertyEntry *gf_props_find(GF_PropertyMap *map, u32 p4cc, u32 name_id)
+{
+	u32 i, mask, slot;
+	GF_PropertyEntry *p;
+	if ((map->nb_props <= GF_PROPS_INLINE_SIZE) || !map->index) {
+		for (i=0; i<map->nb_props; i++) {
+			p = map->props[i];
+			if (!p) {
+				GF_LOG(GF_LOG_WARNING, GF_LOG_FILTER, ("Concurrent read/write access to property map, cannot query property now\n"));
+				return NULL;
+			}
+			if (gf_props_key_match(p, p4cc, name_id))
+				return p;
+		}
+		return NULL;
+	}
+	mask = map->index_size - 1;
+	slot = gf_props_key_hash(p4cc, name_id) & mask;
+	while ((p = map->index[slot])) {
+		if (gf_props_key_match(p, p4cc, name_id))
+			return p;
+		slot = (slot+1) & mask;
+	}
+	return NULL;
 }
-#endif
 
 GF_PropertyMap * gf_props_new(GF_Filter *filter)
 {
@@ -657,10 +898,8 @@ GF_PropertyMap * gf_props_new(GF_Filter *filter)
 		if (!map) return NULL;
 		
 		map->session = filter->session;
-#if GF_PROPS_HASHTABLE_SIZE
-#else
-		map->properties = gf_list_new();
-#endif
+		map->props = map->inline_props;
+		map->alloc_props = GF_PROPS_INLINE_SIZE;
 	}
 	assert(!map->reference_count);
 	map->reference_count = 1;
@@ -751,38 +990,20 @@ void gf_props_del_property(GF_PropertyEntry *it)
 
 void gf_propmap_del(void *pmap)
 {
-#if GF_PROPS_HASHTABLE_SIZE
-	gf_free(pamp);
-#else
 	GF_PropertyMap *map = pmap;
-	gf_list_del(map->properties);
+	if (map->props != map->inline_props) gf_free(map->props);
+	if (map->index) gf_free(map->index);
 	gf_free(map);
-#endif
-
 }
+
 void gf_props_reset(GF_PropertyMap *prop)
 {
-#if GF_PROPS_HASHTABLE_SIZE
-	u32 i;
-	for (i=0; i<GF_PROPS_HASHTABLE_SIZE; i++) {
-		if (prop->hash_table[i]) {
-			GF_List *l = prop->hash_table[i];
-			while (gf_list_count(l)) {
-				gf_props_del_property((GF_PropertyEntry *) gf_list_pop_back(l) );
-			}
-			prop->hash_table[i] = NULL;
-			if (prop->session->prop_maps_list_reservoir) {
-				gf_fq_add(prop->session->prop_maps_list_reservoir, l);
-			} else {
-				gf_list_del(l);
-			}
-		}
+	while (prop->nb_props) {
+		prop->nb_props--;
+		gf_props_del_property(prop->props[prop->nb_props]);
+		prop->props[prop->nb_props] = NULL;
 	}
-#else
-	while (gf_list_count(prop->properties)) {
-		gf_props_del_property( (GF_PropertyEntry *) gf_list_pop_back(prop->properties) );
-	}
-#endif
+	//keep allocated arrays for reuse, index is rebuilt upon next growth
 }
 
 void gf_props_del(GF_PropertyMap *map)
@@ -797,55 +1018,39 @@ void gf_props_del(GF_PropertyMap *map)
 	if (map->session->prop_maps_reservoir) {
 		gf_fq_add(map->session->prop_maps_reservoir, map);
 	} else {
-		gf_list_del(map->properties);
-		gf_free(map);
+		gf_propmap_del(map);
 	}
 }
 
 
 
 //purge existing property of same name
-void gf_props_remove_property(GF_PropertyMap *map, u32 hash, u32 p4cc, const char *name)
+void gf_props_remove_property(GF_PropertyMap *map, u32 p4cc, const char *name)
 {
-#if GF_PROPS_HASHTABLE_SIZE
-	if (map->hash_table[hash]) {
-		u32 i, count = gf_list_count(map->hash_table[hash]);
-		for (i=0; i<count; i++) {
-			GF_PropertyEntry *prop = gf_list_get(map->hash_table[hash], i);
-			if ((p4cc && (p4cc==prop->p4cc)) || (name && prop->pname && !strcmp(prop->pname, name)) ) {
-				gf_list_rem(map->hash_table[hash], i);
-				gf_props_del_property(prop);
-				break;
-			}
-		}
-	}
-#else
-	u32 i, count = gf_list_count(map->properties);
-	for (i=0; i<count; i++) {
-		GF_PropertyEntry *prop = gf_list_get(map->properties, i);
-		if ((p4cc && (p4cc==prop->p4cc)) || (name && prop->pname && !strcmp(prop->pname, name)) ) {
-			gf_list_rem(map->properties, i);
-			gf_props_del_property(prop);
-			break;
-		}
+	u32 pos;
+	u32 name_id = 0;
+	GF_PropertyEntry *prop;
+	if (!p4cc) {
+		name_id = gf_props_get_name_id(map->session, name, GF_FALSE);
+		if (!name_id) return;
 	}
-#endif
-}
+	prop = gf_props_find(map, p4cc, name_id);
+	if (!prop) return;
 
-
-#if GF_PROPS_HASHTABLE_SIZE
-GF_List *gf_props_get_list(GF_PropertyMap *map)
-{
-	GF_List *l;
-
-	l = gf_fq_pop(map->session->prop_maps_list_reservoir);
-
-	if (!l) l = gf_list_new();
-	return l;
+	if ((map->nb_props > GF_PROPS_INLINE_SIZE) && map->index)
+		gf_props_index_remove(map, prop);
+	for (pos=0; pos<map->nb_props; pos++) {
+		if (map->props[pos]==prop) break;
+	}
+	map->nb_props--;
+	if (pos < map->nb_props)
+		memmove(&map->props[pos], &map->props[pos+1], sizeof(GF_PropertyEntry *) * (map->nb_props - pos));
+	map->props[map->nb_props] = NULL;
+	gf_props_del_property(prop);
 }
-#endif
 
 static void gf_props_assign_value(GF_PropertyEntry *prop, const GF_PropertyValue *value, Bool is_old_prop)
+
 {
 	char *src_ptr;
 	//remember source pointer
@@ -889,34 +1094,23 @@ static void gf_props_assign_value(GF_PropertyEntry *prop, const GF_PropertyValue
 	}
 }
 
-GF_Err gf_props_insert_property(GF_PropertyMap *map, u32 hash, u32 p4cc, const char *name, char *dyn_name, const GF_PropertyValue *value)
+GF_Err gf_props_insert_property(GF_PropertyMap *map, u32 p4cc, const char *name, char *dyn_name, const GF_PropertyValue *value)
 {
+	GF_Err e;
+	u32 name_id = 0;
 	GF_PropertyEntry *prop;
-#if GF_PROPS_HASHTABLE_SIZE
-	u32 i, count;
-#endif
+
 	if ((value->type == GF_PROP_DATA) || (value->type == GF_PROP_DATA_NO_COPY)) {
 		if (!value->value.data.ptr) {
 			GF_LOG(GF_LOG_ERROR, GF_LOG_FILTER, ("Attempt at defining data property %s with NULL pointer, not allowed\n", p4cc ? gf_4cc_to_str(p4cc) : name ? name : dyn_name ));
 			return GF_BAD_PARAM;
 		}
 	}
-#if GF_PROPS_HASHTABLE_SIZE
-	if (! map->hash_table[hash] ) {
-		map->hash_table[hash] = gf_props_get_list(map);
-		if (!map->hash_table[hash]) return GF_OUT_OF_MEM;
-	} else {
-		count = gf_list_count(map->hash_table[hash]);
-		if (count) {
-			GF_LOG(GF_LOG_DEBUG, GF_LOG_FILTER, ("PropertyMap hash collision for %s - %d entries before insertion:\n", p4cc ? gf_4cc_to_str(p4cc) : name ? name : dyn_name, gf_list_count(map->hash_table[hash]) ));
-			for (i=0; i<count; i++) {
-				GF_PropertyEntry *prop_c = gf_list_get(map->hash_table[hash], i);
-				GF_LOG(GF_LOG_DEBUG, GF_LOG_FILTER, ("\t%s\n\n", prop_c->pname ? prop_c->pname : gf_4cc_to_str(prop_c->p4cc)  ));
-				assert(!prop_c->p4cc || (prop_c->p4cc != p4cc));
-			}
-		}
+	if (!p4cc) {
+		name_id = gf_props_get_name_id(map->session, name ? name : dyn_name, GF_TRUE);
+		if (!name_id) return GF_OUT_OF_MEM;
 	}
-#endif
+
 	if ((value->type == GF_PROP_DATA) && value->value.data.ptr) {
 		prop = gf_fq_pop(map->session->prop_maps_entry_data_alloc_reservoir);
 	} else {
@@ -931,6 +1125,7 @@ GF_Err gf_props_insert_property(GF_PropertyMap *map, u32 hash, u32 p4cc, const c
 
 	prop->reference_count = 1;
 	prop->p4cc = p4cc;
+	prop->name_id = name_id;
 	prop->pname = (char *) name;
 	if (dyn_name) {
 		prop->pname = gf_strdup(dyn_name);
@@ -939,61 +1134,33 @@ GF_Err gf_props_insert_property(GF_PropertyMap *map, u32 hash, u32 p4cc, const c
 
 	gf_props_assign_value(prop, value, GF_FALSE);
 
-#if GF_PROPS_HASHTABLE_SIZE
-	return gf_list_add(map->hash_table[hash], prop);
-#else
-	return gf_list_add(map->properties, prop);
-#endif
-
+	e = gf_props_append(map, prop);
+	if (e) gf_props_del_property(prop);
+	return e;
 }
 
 GF_Err gf_props_set_property(GF_PropertyMap *map, u32 p4cc, const char *name, char *dyn_name, const GF_PropertyValue *value)
 {
 	GF_Err e;
-	u32 hash = gf_props_hash_djb2(p4cc, name ? name : dyn_name);
 	gf_mx_p(map->session->info_mx);
-	gf_props_remove_property(map, hash, p4cc, name ? name : dyn_name);
+	gf_props_remove_property(map, p4cc, name ? name : dyn_name);
 	if (!value)
 		e = GF_OK;
 	else
-		e = gf_props_insert_property(map, hash, p4cc, name, dyn_name, value);
+		e = gf_props_insert_property(map, p4cc, name, dyn_name, value);
 	gf_mx_v(map->session->info_mx);
 	return e;
 }
 
 const GF_PropertyEntry *gf_props_get_property_entry(GF_PropertyMap *map, u32 prop_4cc, const char *name)
 {
-	u32 i, count;
-	const GF_PropertyEntry *res=NULL;
-#if GF_PROPS_HASHTABLE_SIZE
-	u32 hash = gf_props_hash_djb2(prop_4cc, name);
-	if (map->hash_table[hash] ) {
-		count = gf_list_count(map->hash_table[hash]);
-		for (i=0; i<count; i++) {
-			GF_PropertyEntry *p = gf_list_get(map->hash_table[hash], i);
-
-			if ((prop_4cc && (p->p4cc==prop_4cc)) || (p->pname && name && !strcmp(p->pname, name)) ) {
-				res = p;
-				break;
-			}
-		}
-	}
-#else
-	count = gf_list_count(map->properties);
-	for (i=0; i<count; i++) {
-		GF_PropertyEntry *p = gf_list_get(map->properties, i);
-		if (!p) {
-			GF_LOG(GF_LOG_WARNING, GF_LOG_FILTER, ("Concurrent read/write access to property map, cannot query property now\n"));
-			return NULL;
-		}
-
-		if ((prop_4cc && (p->p4cc==prop_4cc)) || (p->pname && name && !strcmp(p->pname, name)) ) {
-			res = p;
-			break;
-		}
+	u32 name_id = 0;
+	if (!prop_4cc) {
+		//name never used in session, no need to look further
+		name_id = gf_props_get_name_id(map->session, name, GF_FALSE);
+		if (!name_id) return NULL;
 	}
-#endif
-	return res;
+	return gf_props_find(map, prop_4cc, name_id);
 }
 
 const GF_PropertyValue *gf_props_get_property(GF_PropertyMap *map, u32 prop_4cc, const char *name)
@@ -1006,99 +1173,47 @@ const GF_PropertyValue *gf_props_get_property(GF_PropertyMap *map, u32 prop_4cc,
 GF_Err gf_props_merge_property(GF_PropertyMap *dst_props, GF_PropertyMap *src_props, gf_filter_prop_filter filter_prop, void *cbk)
 {
 	GF_Err e;
-	u32 i, count;
-#if GF_PROPS_HASHTABLE_SIZE
-	u32 idx;
-#endif
-	GF_List *list;
+	u32 i;
 	if (src_props->timescale)
 		dst_props->timescale = src_props->timescale;
 
-#if GF_PROPS_HASHTABLE_SIZE
-	for (idx=0; idx<GF_PROPS_HASHTABLE_SIZE; idx++) {
-		if (src_props->hash_table[idx]) {
-			list = src_props->hash_table[idx];
-#else
-			list = src_props->properties;
-#endif
-			count = gf_list_count(list);
-			for (i=0; i<count; i++) {
-				GF_PropertyEntry *prop = gf_list_get(list, i);
-				assert(prop->reference_count);
-				if (!filter_prop || filter_prop(cbk, prop->p4cc, prop->pname, &prop->prop)) {
-					safe_int_inc(&prop->reference_count);
-
-#if GF_PROPS_HASHTABLE_SIZE
-					if (!dst_props->hash_table[idx]) {
-						dst_props->hash_table[idx] = gf_props_get_list(dst_props);
-						if (!dst_props->hash_table[idx]) return GF_OUT_OF_MEM;
-					}
-					e = gf_list_add(dst_props->hash_table[idx], prop);
-					if (e) return e;
-#else
-					e = gf_list_add(dst_props->properties, prop);
-					if (e) return e;
-#endif
-				}
+	for (i=0; i<src_props->nb_props; i++) {
+		GF_PropertyEntry *prop = src_props->props[i];
+		assert(prop->reference_count);
+		if (!filter_prop || filter_prop(cbk, prop->p4cc, prop->pname, &prop->prop)) {
+			safe_int_inc(&prop->reference_count);
+			e = gf_props_append(dst_props, prop);
+			if (e) {
+				safe_int_dec(&prop->reference_count);
+				return e;
 			}
-#if GF_PROPS_HASHTABLE_SIZE
 		}
 	}
-#endif
 	return GF_OK;
 }
 
 const GF_PropertyValue *gf_props_enum_property(GF_PropertyMap *props, u32 *io_idx, u32 *prop_4cc, const char **prop_name)
 {
-#if GF_PROPS_HASHTABLE_SIZE
-	u32 i, nb_items = 0;
-#endif
-	u32 idx, count;
-	
+	u32 idx;
 	const GF_PropertyEntry *pe;
 	if (!io_idx) return NULL;
 
 	idx = *io_idx;
 	if (idx == 0xFFFFFFFF) return NULL;
 
-#if GF_PROPS_HASHTABLE_SIZE
-	for (i=0; i<GF_PROPS_HASHTABLE_SIZE; i++) {
-		if (props->hash_table[i]) {
-			count = gf_list_count(props->hash_table[i]);
-			nb_items+=count;
-			if (idx >= count) {
-				idx -= count;
-				continue;
-			}
-			pe = gf_list_get(props->hash_table[i], idx);
-			if (!pe) {
-				*io_idx = nb_items;
-				return NULL;
-			}
-			if (prop_4cc) *prop_4cc = pe->p4cc;
-			if (prop_name) *prop_name = pe->pname;
-			*io_idx = (*io_idx) + 1;
-			return &pe->prop;
-		}
-	}
-	*io_idx = nb_items;
-	return NULL;
-#else
-	count = gf_list_count(props->properties);
-	if (idx >= count) {
-		*io_idx = count;
+	if (idx >= props->nb_props) {
+		*io_idx = props->nb_props;
 		return NULL;
 	}
-	pe = gf_list_get(props->properties, idx);
+	pe = props->props[idx];
 	if (!pe) {
-		*io_idx = count;
+		*io_idx = props->nb_props;
 		return NULL;
 	}
 	if (prop_4cc) *prop_4cc = pe->p4cc;
 	if (prop_name) *prop_name = pe->pname;
 	*io_idx = (*io_idx) + 1;
 	return &pe->prop;
-#endif
 }
 
 typedef struct
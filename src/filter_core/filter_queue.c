@@ -115,7 +115,8 @@ void gf_fq_del(GF_FilterQueue *q, void (*item_delete)(void *) )
 	gf_free(q);
 }
 
-static void gf_fq_lockfree_enqueue(GF_LFQItem *it, GF_LFQItem **tail_ptr)
+//appends the chain of items from first to last, linked through their next field
+static void gf_fq_lockfree_enqueue(GF_LFQItem *first, GF_LFQItem *last, GF_LFQItem **tail_ptr)
 {
 	GF_LFQItem *tail;
 
@@ -125,7 +126,7 @@ static void gf_fq_lockfree_enqueue(GF_LFQItem *it, GF_LFQItem **tail_ptr)
 		next = tail->next;
 		if (next == tail->next) {
 			if (next==NULL) {
-				if (atomic_compare_and_swap(&tail->next, next, it)) {
+				if (atomic_compare_and_swap(&tail->next, next, first)) {
 					break; // Enqueue is done.  Exit loop
 				}
 			} else {
@@ -134,7 +135,7 @@ static void gf_fq_lockfree_enqueue(GF_LFQItem *it, GF_LFQItem **tail_ptr)
 			}
 		}
 	}
-	atomic_compare_and_swap(tail_ptr, tail, it);
+	atomic_compare_and_swap(tail_ptr, tail, last);
 }
 
 static void *gf_fq_lockfree_dequeue(GF_LFQItem **head_ptr, GF_LFQItem **tail_ptr, GF_LFQItem **prev_head)
@@ -185,7 +186,7 @@ void gf_lfq_add(GF_FilterQueue *q, void *item)
 		it->next = NULL;
 	}
 	it->data=item;
-	gf_fq_lockfree_enqueue(it, &q->tail);
+	gf_fq_lockfree_enqueue(it, it, &q->tail);
 	safe_int_inc(&q->nb_items);
 }
 
@@ -201,7 +202,7 @@ void *gf_lfq_pop(GF_FilterQueue *q)
 
 	slot->data = NULL;
 	slot->next = NULL;
-	gf_fq_lockfree_enqueue(slot, &q->res_tail);
+	gf_fq_lockfree_enqueue(slot, slot, &q->res_tail);
 
 	return data;
 }
@@ -244,6 +245,41 @@ void gf_fq_add(GF_FilterQueue *fq, void *item)
 	}
 }
 
+void gf_fq_add_batch(GF_FilterQueue *fq, void **items, u32 nb_items)
+{
+	u32 i;
+	GF_LFQItem *first=NULL, *last=NULL;
+	assert(fq);
+
+	if (fq->mx) {
+		//mutex is recursive, hold it for the whole batch
+		gf_mx_p(fq->mx);
+		for (i=0; i<nb_items; i++)
+			gf_fq_add(fq, items[i]);
+		gf_mx_v(fq->mx);
+		return;
+	}
+
+	//build the chain of items, then splice it in one enqueue
+	for (i=0; i<nb_items; i++) {
+		GF_LFQItem *it=NULL;
+		gf_fq_lockfree_dequeue( &fq->res_head, &fq->res_tail, &it);
+		if (!it) {
+			GF_SAFEALLOC(it, GF_LFQItem);
+			if (!it) break;
+		} else {
+			it->next = NULL;
+		}
+		it->data = items[i];
+		if (last) last->next = it;
+		else first = it;
+		last = it;
+	}
+	if (!first) return;
+	gf_fq_lockfree_enqueue(first, last, &fq->tail);
+	safe_int_add(&fq->nb_items, i);
+}
+
 void *gf_fq_pop(GF_FilterQueue *fq)
 {
 	GF_LFQItem *it;
@@ -352,3 +388,129 @@ void gf_fq_enum(GF_FilterQueue *fq, Bool (*enum_func)(void *udta1, void *item),
 		}
 	}
 }
+
+
+struct __gf_filter_deque
+{
+	//ring buffer of items, size is always a power of 2
+	void **items;
+	u32 alloc;
+	//index of top (oldest) item, bottom is top+nb_items
+	u32 top;
+	volatile u32 nb_items;
+	GF_Mutex *mx;
+};
+
+GF_FilterDeque *gf_fdq_new(const char *name)
+{
+	GF_FilterDeque *dq;
+	GF_SAFEALLOC(dq, GF_FilterDeque);
+	if (!dq) return NULL;
+	dq->alloc = 64;
+	dq->items = gf_malloc(sizeof(void *) * dq->alloc);
+	dq->mx = gf_mx_new(name);
+	if (!dq->items || !dq->mx) {
+		gf_fdq_del(dq, NULL);
+		return NULL;
+	}
+	return dq;
+}
+
+void gf_fdq_del(GF_FilterDeque *dq, void (*item_delete)(void *) )
+{
+	if (!dq) return;
+	if (dq->items) {
+		u32 i;
+		for (i=0; i<dq->nb_items; i++) {
+			void *item = dq->items[ (dq->top + i) & (dq->alloc-1) ];
+			if (item_delete) item_delete(item);
+		}
+		gf_free(dq->items);
+	}
+	if (dq->mx) gf_mx_del(dq->mx);
+	gf_free(dq);
+}
+
+//must be called with mutex held
+static Bool gf_fdq_grow(GF_FilterDeque *dq)
+{
+	u32 i;
+	void **items;
+	if (dq->nb_items < dq->alloc) return GF_TRUE;
+
+	items = gf_malloc(sizeof(void *) * dq->alloc * 2);
+	if (!items) return GF_FALSE;
+	for (i=0; i<dq->nb_items; i++) {
+		items[i] = dq->items[ (dq->top + i) & (dq->alloc-1) ];
+	}
+	gf_free(dq->items);
+	dq->items = items;
+	dq->alloc *= 2;
+	dq->top = 0;
+	return GF_TRUE;
+}
+
+GF_Err gf_fdq_push(GF_FilterDeque *dq, void *item)
+{
+	GF_Err e = GF_OK;
+	gf_mx_p(dq->mx);
+	if (gf_fdq_grow(dq)) {
+		dq->items[ (dq->top + dq->nb_items) & (dq->alloc-1) ] = item;
+		dq->nb_items++;
+	} else {
+		e = GF_OUT_OF_MEM;
+	}
+	gf_mx_v(dq->mx);
+	return e;
+}
+
+GF_Err gf_fdq_push_top(GF_FilterDeque *dq, void *item)
+{
+	GF_Err e = GF_OK;
+	gf_mx_p(dq->mx);
+	if (gf_fdq_grow(dq)) {
+		dq->top = (dq->top + dq->alloc - 1) & (dq->alloc-1);
+		dq->items[dq->top] = item;
+		dq->nb_items++;
+	} else {
+		e = GF_OUT_OF_MEM;
+	}
+	gf_mx_v(dq->mx);
+	return e;
+}
+
+void *gf_fdq_pop(GF_FilterDeque *dq)
+{
+	void *item = NULL;
+	//unprotected check to avoid locking empty queues
+	if (!dq || !dq->nb_items) return NULL;
+
+	gf_mx_p(dq->mx);
+	if (dq->nb_items) {
+		dq->nb_items--;
+		item = dq->items[ (dq->top + dq->nb_items) & (dq->alloc-1) ];
+	}
+	gf_mx_v(dq->mx);
+	return item;
+}
+
+void *gf_fdq_steal(GF_FilterDeque *dq)
+{
+	void *item = NULL;
+	//unprotected check to avoid locking empty queues
+	if (!dq || !dq->nb_items) return NULL;
+
+	gf_mx_p(dq->mx);
+	if (dq->nb_items) {
+		item = dq->items[dq->top];
+		dq->top = (dq->top + 1) & (dq->alloc-1);
+		dq->nb_items--;
+	}
+	gf_mx_v(dq->mx);
+	return item;
+}
+
+u32 gf_fdq_count(GF_FilterDeque *dq)
+{
+	return dq ? dq->nb_items : 0;
+}
@@ -37,6 +37,121 @@ void gf_font_manager_del(struct _gf_ft_mgr *fm);
 #endif
 
 
+//returns number of tasks in secondary task lists (global and per-thread lists)
+static u32 gf_fs_sched_secondary_count(GF_FilterSession *fsess)
+{
+	u32 i, count, nb_tasks = gf_fq_count(fsess->tasks);
+	if (!fsess->work_steal) return nb_tasks;
+
+	count = gf_list_count(fsess->threads);
+	for (i=0; i<count; i++) {
+		GF_SessionThread *sess_th = gf_list_get(fsess->threads, i);
+		nb_tasks += gf_fdq_count(sess_th->local_tasks);
+	}
+	return nb_tasks;
+}
+
+#if defined(_MSC_VER)
+#define GF_FS_TLS __declspec(thread)
+#elif defined(__GNUC__)
+#define GF_FS_TLS __thread
+#endif
+
+#ifdef GF_FS_TLS
+//session and session thread object of the calling secondary thread, set when the thread starts processing
+//a secondary thread belongs to a single session for its whole life, so these are never stale
+static GF_FS_TLS GF_FilterSession *tls_fsess = NULL;
+static GF_FS_TLS GF_SessionThread *tls_sess_th = NULL;
+#endif
+
+//gets the secondary session thread object of the calling thread, NULL if main thread or not a session thread
+static GF_SessionThread *gf_fs_get_secondary_thread(GF_FilterSession *fsess)
+{
+#ifdef GF_FS_TLS
+	return (tls_fsess==fsess) ? tls_sess_th : NULL;
+#else
+	u32 i, count = gf_list_count(fsess->threads);
+	u32 th_id = gf_th_id();
+	for (i=0; i<count; i++) {
+		GF_SessionThread *sess_th = gf_list_get(fsess->threads, i);
+		if (sess_th->th_id == th_id) return sess_th;
+	}
+	return NULL;
+#endif
+}
+
+GF_SessionThread *gf_fs_get_current_thread(GF_FilterSession *fsess)
+{
+	if (fsess->main_th.th_id == gf_th_id()) return &fsess->main_th;
+	return gf_fs_get_secondary_thread(fsess);
+}
+
+//posts a task to the secondary task list. In work-stealing mode, filter tasks are posted to the task list of the last
+//thread having processed the filter (or of the calling thread), to keep filters on the same thread as much as possible.
+//Requeued tasks are pushed at the other end of the task list, so that the owner processes pending tasks before running them again.
+//Timed tasks are always posted to the global list, as the timing logic of the scheduler only looks at this list
+static void gf_fs_sched_push_task(GF_FilterSession *fsess, GF_FSTask *task, Bool requeue)
+{
+	GF_SessionThread *target = NULL;
+	if (fsess->work_steal && task->filter && !task->schedule_next_time) {
+		s32 node = task->filter->numa_node;
+		target = task->filter->sched_thread;
+		if (!target) target = gf_fs_get_secondary_thread(fsess);
+		//filter assigned to a NUMA node, post to a thread on that node
+		if ((node>=0) && (!target || (target->numa_node != node))) {
+			u32 i, count = gf_list_count(fsess->threads);
+			for (i=0; i<count; i++) {
+				GF_SessionThread *sess_th = gf_list_get(fsess->threads, i);
+				if (sess_th->numa_node == node) {
+					target = sess_th;
+					break;
+				}
+			}
+		}
+	}
+	if (target && ((requeue ? gf_fdq_push_top(target->local_tasks, task) : gf_fdq_push(target->local_tasks, task))==GF_OK))
+		return;
+	//no target thread or failed to grow its task list, use global list
+	gf_fq_add(fsess->tasks, task);
+}
+
+//steals a task from the task lists of secondary threads, starting after the given thread index
+static GF_FSTask *gf_fs_sched_steal_task(GF_FilterSession *fsess, GF_SessionThread *sess_thread, u32 thid)
+{
+	u32 i, count, pass;
+	GF_FSTask *task;
+	count = gf_list_count(fsess->threads);
+	//first pass steals from threads on the same NUMA node, second pass from the other threads
+	for (pass=0; pass<2; pass++) {
+		for (i=0; i<count; i++) {
+			GF_SessionThread *victim = gf_list_get(fsess->threads, (thid + i) % count);
+			if (victim == sess_thread) continue;
+			if ((victim->numa_node == sess_thread->numa_node) != (pass==0))
+				continue;
+			task = gf_fdq_steal(victim->local_tasks);
+			if (task) {
+				sess_thread->nb_steals++;
+				return task;
+			}
+		}
+	}
+	return NULL;
+}
+
+//fetches a task for a secondary thread in work-stealing mode: local list first, then global list, then steal from other threads
+static GF_FSTask *gf_fs_sched_pop_task(GF_FilterSession *fsess, GF_SessionThread *sess_thread, u32 thid)
+{
+	GF_FSTask *task = gf_fdq_pop(sess_thread->local_tasks);
+	if (task) {
+		sess_thread->nb_local_tasks++;
+		return task;
+	}
+	task = gf_fq_pop(fsess->tasks);
+	if (task) return task;
+	//thid is 1-based, start from next thread
+	return gf_fs_sched_steal_task(fsess, sess_thread, thid);
+}
+
 static GFINLINE void gf_fs_sema_io(GF_FilterSession *fsess, Bool notify, Bool main)
 {
 	GF_Semaphore *sem = main ? fsess->semaphore_main : fsess->semaphore_other;
@@ -58,7 +173,7 @@ static GFINLINE void gf_fs_sema_io(GF_FilterSession *fsess, Bool notify, Bool ma
 			nb_tasks = 1;
 			//no active threads, count number of tasks. If no posted tasks we are likely at the end of the session, don't block, rather use a sem_wait 
 			if (!fsess->active_threads)
-			 	nb_tasks = gf_fq_count(fsess->main_thread_tasks) + gf_fq_count(fsess->tasks);
+			 	nb_tasks = gf_fq_count(fsess->main_thread_tasks) + gf_fs_sched_secondary_count(fsess);
 
 			//if main semaphore, keep track that we are going to sleep
 			if (main) {
@@ -130,6 +245,14 @@ static Bool fs_default_event_proc(void *ptr, GF_Event *evt)
 	return 0;
 }
 
+//allocates the trace ring buffer of a session thread, tracing is disabled for the thread on failure
+static void gf_fs_trace_thread_init(GF_FilterSession *fsess, GF_SessionThread *sess_th)
+{
+	sess_th->trace_mx = gf_mx_new("FilterSessionThreadTrace");
+	if (!sess_th->trace_mx) return;
+	sess_th->trace_events = gf_malloc(sizeof(GF_FSTraceEvent) * fsess->trace_size);
+}
+
 GF_EXPORT
 GF_FilterSession *gf_fs_new(s32 nb_threads, GF_FilterSchedulerType sched_type, u32 flags, const char *blacklist)
 {
@@ -153,6 +276,8 @@ GF_FilterSession *gf_fs_new(s32 nb_threads, GF_FilterSchedulerType sched_type, u
 
 	fsess->filters = gf_list_new();
 	fsess->main_th.fsess = fsess;
+	fsess->main_th.numa_node = -1;
+	fsess->main_th.last_cpu = -1;
 
 	if ((s32) nb_threads == -1) {
 		GF_SystemRTInfo rti;
@@ -170,6 +295,10 @@ GF_FilterSession *gf_fs_new(s32 nb_threads, GF_FilterSchedulerType sched_type, u
 		fsess->direct_mode = GF_TRUE;
 		nb_threads=0;
 	}
+	//work stealing only makes sense with secondary threads
+	if ((sched_type==GF_FS_SCHEDULER_WORK_STEAL) && (nb_threads>0)) {
+		fsess->work_steal = GF_TRUE;
+	}
 	if (nb_threads && (sched_type != GF_FS_SCHEDULER_LOCK_FREE_X)) {
 		fsess->tasks_mx = gf_mx_new("TasksList");
 	}
@@ -228,9 +357,11 @@ GF_FilterSession *gf_fs_new(s32 nb_threads, GF_FilterSchedulerType sched_type, u
 		fsess->props_mx = gf_mx_new("FilterSessionProps");
 
 	if (!(flags & GF_FS_FLAG_NO_RESERVOIR)) {
-#if GF_PROPS_HASHTABLE_SIZE
-		fsess->prop_maps_list_reservoir = gf_fq_new(fsess->props_mx);
-#endif
+		const char *slab_max = gf_opts_get_key("core", "slab-max");
+		u32 max_mb = slab_max ? atoi(slab_max) : 32;
+		if (max_mb)
+			fsess->slab = gf_fs_slab_new((u64) max_mb * 1024 * 1024);
+
 		fsess->prop_maps_reservoir = gf_fq_new(fsess->props_mx);
 		fsess->prop_maps_entry_reservoir = gf_fq_new(fsess->props_mx);
 		fsess->prop_maps_entry_data_alloc_reservoir = gf_fq_new(fsess->props_mx);
@@ -253,6 +384,20 @@ GF_FilterSession *gf_fs_new(s32 nb_threads, GF_FilterSchedulerType sched_type, u
 	if (nb_threads) {
 		fsess->info_mx = gf_mx_new("FilterSessionInfo");
 		fsess->ui_mx = gf_mx_new("FilterSessionUIProc");
+		fsess->prop_names_mx = gf_mx_new("FilterSessionPropNames");
+	}
+
+	opt = gf_opts_get_key("core", "trace");
+	if (opt) {
+		fsess->trace_file = gf_strdup(opt);
+		fsess->trace_size = gf_opts_get_int("core", "trace-size");
+		if (!fsess->trace_size) fsess->trace_size = 65536;
+		fsess->trace_dur = gf_opts_get_int("core", "trace-dur");
+		fsess->trace_names = gf_list_new();
+		fsess->trace_mx = gf_mx_new("FilterSessionTrace");
+		gf_fs_trace_thread_init(fsess, &fsess->main_th);
+		if (!gf_opts_get_bool("core", "trace-defer"))
+			gf_fs_trace_start(fsess, 0);
 	}
 
 	for (i=0; i<(u32) nb_threads; i++) {
@@ -267,9 +412,24 @@ GF_FilterSession *gf_fs_new(s32 nb_threads, GF_FilterSchedulerType sched_type, u
 			gf_free(sess_thread);
 			continue;
 		}
+		if (fsess->work_steal) {
+			sess_thread->local_tasks = gf_fdq_new("ThreadTasks");
+			if (!sess_thread->local_tasks) {
+				gf_th_del(sess_thread->th);
+				gf_free(sess_thread);
+				continue;
+			}
+		}
 		sess_thread->fsess = fsess;
+		sess_thread->numa_node = -1;
+		sess_thread->last_cpu = -1;
+		if (fsess->trace_file)
+			gf_fs_trace_thread_init(fsess, sess_thread);
 		gf_list_add(fsess->threads, sess_thread);
 	}
+	//no secondary thread could be created, tasks would only be posted to the global list
+	if (!gf_list_count(fsess->threads))
+		fsess->work_steal = GF_FALSE;
 
 	gf_fs_set_separators(fsess, NULL);
 
@@ -411,6 +571,7 @@ GF_FilterSession *gf_fs_new_defaults(u32 inflags)
 	else if (!strcmp(opt, "direct")) sched_type = GF_FS_SCHEDULER_DIRECT;
 	else if (!strcmp(opt, "free")) sched_type = GF_FS_SCHEDULER_LOCK_FREE;
 	else if (!strcmp(opt, "freex")) sched_type = GF_FS_SCHEDULER_LOCK_FREE_X;
+	else if (!strcmp(opt, "steal")) sched_type = GF_FS_SCHEDULER_WORK_STEAL;
 	else {
 		GF_LOG(GF_LOG_ERROR, GF_LOG_FILTER, ("Unrecognized scheduler type %s\n", opt));
 		return NULL;
@@ -460,6 +621,13 @@ GF_FilterSession *gf_fs_new_defaults(u32 inflags)
 	if (opt)
 		gf_fs_set_separators(fsess, opt);
 
+	opt = gf_opts_get_key("core", "affinity");
+	if (opt && gf_fs_set_thread_affinity(fsess, opt)) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_FILTER, ("Invalid thread affinity %s\n", opt));
+		gf_fs_del(fsess);
+		return NULL;
+	}
+
 	return fsess;
 }
 
@@ -562,6 +730,12 @@ void gf_fs_del(GF_FilterSession *fsess)
 	gf_fs_stop(fsess);
 	GF_LOG(GF_LOG_DEBUG, GF_LOG_FILTER, ("Session destroy begin\n"));
 
+	//all threads are stopped, dump pending trace
+	if (fsess->trace_file) {
+		fsess->trace_active = GF_FALSE;
+		gf_fs_trace_dump(fsess);
+	}
+
 	if (fsess->parsed_args) {
 		while (gf_list_count(fsess->parsed_args)) {
 			GF_FSArgItem *ai = gf_list_pop_back(fsess->parsed_args);
@@ -647,6 +821,9 @@ void gf_fs_del(GF_FilterSession *fsess)
 	if (fsess->tasks_reservoir)
 		gf_fq_del(fsess->tasks_reservoir, gf_void_del);
 
+	//all filters are destroyed, no more packet data in use
+	gf_fs_slab_del(fsess);
+
 	if (fsess->threads) {
 		if (fsess->main_thread_tasks)
 			gf_fq_del(fsess->main_thread_tasks, gf_void_del);
@@ -654,17 +831,39 @@ void gf_fs_del(GF_FilterSession *fsess)
 		while (gf_list_count(fsess->threads)) {
 			GF_SessionThread *sess_th = gf_list_pop_back(fsess->threads);
 			gf_th_del(sess_th->th);
+			if (sess_th->local_tasks)
+				gf_fdq_del(sess_th->local_tasks, gf_void_del);
+			if (sess_th->cpus)
+				gf_free(sess_th->cpus);
+			if (sess_th->trace_events)
+				gf_free(sess_th->trace_events);
+			if (sess_th->trace_mx)
+				gf_mx_del(sess_th->trace_mx);
 			gf_free(sess_th);
 		}
 		gf_list_del(fsess->threads);
 	}
 
+	if (fsess->main_th.cpus)
+		gf_free(fsess->main_th.cpus);
+	if (fsess->main_th.trace_events)
+		gf_free(fsess->main_th.trace_events);
+	if (fsess->main_th.trace_mx)
+		gf_mx_del(fsess->main_th.trace_mx);
+	if (fsess->trace_names) {
+		while (gf_list_count(fsess->trace_names))
+			gf_free(gf_list_pop_back(fsess->trace_names));
+		gf_list_del(fsess->trace_names);
+	}
+	if (fsess->trace_mx)
+		gf_mx_del(fsess->trace_mx);
+	if (fsess->trace_file)
+		gf_free(fsess->trace_file);
+	if (fsess->cpu_nodes)
+		gf_free(fsess->cpu_nodes);
+
 	if (fsess->prop_maps_reservoir)
 		gf_fq_del(fsess->prop_maps_reservoir, gf_propmap_del);
-#if GF_PROPS_HASHTABLE_SIZE
-	if (fsess->prop_maps_list_reservoir)
-		gf_fq_del(fsess->prop_maps_list_reservoir, (gf_destruct_fun) gf_list_del);
-#endif
 	if (fsess->prop_maps_entry_reservoir)
 		gf_fq_del(fsess->prop_maps_entry_reservoir, gf_void_del);
 	if (fsess->prop_maps_entry_data_alloc_reservoir)
@@ -679,6 +878,10 @@ void gf_fs_del(GF_FilterSession *fsess)
 	if (fsess->info_mx)
 		gf_mx_del(fsess->info_mx);
 
+	gf_props_names_del(fsess);
+	if (fsess->prop_names_mx)
+		gf_mx_del(fsess->prop_names_mx);
+
 	if (fsess->ui_mx)
 		gf_mx_del(fsess->ui_mx);
 
@@ -802,6 +1005,7 @@ void gf_fs_post_task_ex(GF_FilterSession *fsess, gf_fs_task_callback task_fun, G
 	task->run_task = task_fun;
 	task->log_name = log_name;
 	task->udta = udta;
+	task->post_time = fsess->trace_active ? gf_sys_clock_high_res() : 0;
 
 	if (filter && is_configure) {
 		if (filter->freg->flags & GF_FS_REG_CONFIGURE_MAIN_THREAD)
@@ -855,7 +1059,7 @@ void gf_fs_post_task_ex(GF_FilterSession *fsess, gf_fs_task_callback task_fun, G
 			gf_fs_sema_io(fsess, GF_TRUE, GF_TRUE);
 		} else {
 			assert(task->run_task);
-			gf_fq_add(fsess->tasks, task);
+			gf_fs_sched_push_task(fsess, task, GF_FALSE);
 			gf_fs_sema_io(fsess, GF_TRUE, GF_FALSE);
 		}
 	}
@@ -1127,6 +1331,409 @@ GF_Filter *gf_fs_load_filter(GF_FilterSession *fsess, const char *name, GF_Err *
 	return NULL;
 }
 
+//builds the CPU to NUMA node table. Unless forced, the table is only built on systems with several NUMA nodes
+static void gf_fs_init_cpu_nodes(GF_FilterSession *fsess, Bool force)
+{
+	u32 i;
+	GF_SystemRTInfo rti;
+	if (fsess->cpu_nodes) return;
+
+	memset(&rti, 0, sizeof(GF_SystemRTInfo));
+	if (!gf_sys_get_rti(0, &rti, 0) || !rti.nb_cores)
+		return;
+
+	fsess->cpu_nodes = gf_malloc(sizeof(s32) * rti.nb_cores);
+	if (!fsess->cpu_nodes) return;
+	fsess->nb_cpu_nodes = rti.nb_cores;
+	fsess->nb_numa_nodes = 0;
+	for (i=0; i<rti.nb_cores; i++) {
+		fsess->cpu_nodes[i] = gf_sys_get_cpu_node(i);
+		if (fsess->cpu_nodes[i] + 1 > (s32) fsess->nb_numa_nodes)
+			fsess->nb_numa_nodes = fsess->cpu_nodes[i] + 1;
+	}
+	if (!force && (fsess->nb_numa_nodes<2)) {
+		gf_free(fsess->cpu_nodes);
+		fsess->cpu_nodes = NULL;
+		fsess->nb_cpu_nodes = 0;
+	}
+}
+
+//tracks thread and filter placement on CPUs and NUMA nodes
+static void gf_fs_check_placement(GF_FilterSession *fsess, GF_SessionThread *sess_thread, GF_Filter *filter)
+{
+	s32 cpu = gf_th_get_cpu();
+	if ((cpu<0) || (cpu >= (s32) fsess->nb_cpu_nodes)) return;
+
+	if (cpu != sess_thread->last_cpu) {
+		if (sess_thread->last_cpu>=0)
+			sess_thread->nb_cpu_migrations++;
+		sess_thread->last_cpu = cpu;
+		sess_thread->numa_node = fsess->cpu_nodes[cpu];
+	}
+	if (!filter || (filter->last_node == sess_thread->numa_node))
+		return;
+
+	//filter moved to another node, drop its packet reservoirs so that new packets are allocated on this node
+	if (filter->last_node>=0) {
+		sess_thread->nb_migrations++;
+		if (fsess->nb_numa_nodes>1)
+			gf_filter_reset_pck_reservoirs(filter);
+	}
+	filter->last_node = sess_thread->numa_node;
+}
+
+static GF_Err gf_fs_thread_set_cpus(GF_FilterSession *fsess, GF_SessionThread *sess_thread, u32 *cpus, u32 nb_cpus)
+{
+	u32 i;
+	if (sess_thread->cpus) gf_free(sess_thread->cpus);
+	sess_thread->cpus = gf_malloc(sizeof(u32) * nb_cpus);
+	if (!sess_thread->cpus) return GF_OUT_OF_MEM;
+	memcpy(sess_thread->cpus, cpus, sizeof(u32) * nb_cpus);
+	sess_thread->nb_cpus = nb_cpus;
+
+	//thread node is known if all CPUs belong to the same node
+	sess_thread->numa_node = -1;
+	for (i=0; i<nb_cpus; i++) {
+		s32 node = (cpus[i] < fsess->nb_cpu_nodes) ? fsess->cpu_nodes[cpus[i]] : -1;
+		if (!i) sess_thread->numa_node = node;
+		else if (node != sess_thread->numa_node) {
+			sess_thread->numa_node = -1;
+			break;
+		}
+	}
+	return GF_OK;
+}
+
+GF_EXPORT
+GF_Err gf_fs_set_thread_affinity(GF_FilterSession *fsess, const char *affinity)
+{
+	u32 i, nb_threads, nb_cpus, *cpus;
+	const char *set;
+	GF_Err e = GF_OK;
+	if (!fsess || !affinity) return GF_BAD_PARAM;
+	if (!strcmp(affinity, "none")) return GF_OK;
+
+	gf_fs_init_cpu_nodes(fsess, GF_TRUE);
+	if (!fsess->cpu_nodes) return GF_NOT_SUPPORTED;
+	//node of all CPUs unknown, assume a single node
+	if (!fsess->nb_numa_nodes) fsess->nb_numa_nodes = 1;
+
+	cpus = gf_malloc(sizeof(u32) * fsess->nb_cpu_nodes);
+	if (!cpus) return GF_OUT_OF_MEM;
+
+	nb_threads = 1 + gf_list_count(fsess->threads);
+	set = affinity;
+	for (i=0; i<nb_threads; i++) {
+		GF_SessionThread *sess_th = i ? gf_list_get(fsess->threads, i-1) : &fsess->main_th;
+		nb_cpus = 0;
+
+		//one thread per CPU, round-robin - the main thread is not pinned
+		if (!strcmp(affinity, "core")) {
+			if (!i) continue;
+			cpus[0] = (i-1) % fsess->nb_cpu_nodes;
+			nb_cpus = 1;
+		}
+		//one thread per NUMA node, round-robin - the main thread is not pinned
+		else if (!strcmp(affinity, "node")) {
+			if (!i) continue;
+			nb_cpus = gf_sys_get_node_cpus((i-1) % fsess->nb_numa_nodes, cpus, fsess->nb_cpu_nodes);
+		}
+		//list of CPU sets, cycled through
+		else {
+			char *sep;
+			if (!set || !set[0]) set = affinity;
+			sep = strchr(set, '/');
+			while (set && set[0] && (set[0]!='/')) {
+				u32 first, last;
+				if (sscanf(set, "%u-%u", &first, &last) != 2) {
+					if (sscanf(set, "%u", &first) != 1) {
+						e = GF_BAD_PARAM;
+						break;
+					}
+					last = first;
+				}
+				while ((first<=last) && (nb_cpus < fsess->nb_cpu_nodes)) {
+					cpus[nb_cpus] = first;
+					nb_cpus++;
+					first++;
+				}
+				set = strchr(set, ',');
+				if (!set || (sep && (set>sep))) break;
+				set++;
+			}
+			set = sep ? sep+1 : NULL;
+		}
+		if (e) break;
+		if (!nb_cpus) {
+			e = GF_BAD_PARAM;
+			break;
+		}
+		e = gf_fs_thread_set_cpus(fsess, sess_th, cpus, nb_cpus);
+		if (e) break;
+	}
+	gf_free(cpus);
+	return e;
+}
+
+static u32 gf_fs_trace_filter_idx(GF_FilterSession *fsess, GF_Filter *filter)
+{
+	if (!filter) return 0;
+	if (!filter->trace_idx) {
+		const char *name = filter->name ? filter->name : filter->freg->name;
+		gf_mx_p(fsess->trace_mx);
+		gf_list_add(fsess->trace_names, gf_strdup(name));
+		filter->trace_idx = gf_list_count(fsess->trace_names);
+		gf_mx_v(fsess->trace_mx);
+	}
+	return filter->trace_idx;
+}
+
+static void gf_fs_trace_dump_task(GF_FSTask *task)
+{
+	gf_fs_trace_dump(task->udta);
+}
+
+static void gf_fs_trace_record(GF_FilterSession *fsess, GF_SessionThread *sess_thread, GF_FSTask *task, u32 filter_idx, u64 start, u64 end, u32 nb_pck_in, u32 nb_pck_out)
+{
+	GF_FSTraceEvent *evt;
+
+	if (!sess_thread->trace_events) return;
+	gf_mx_p(sess_thread->trace_mx);
+	//new trace window, reset our ring buffer
+	if (sess_thread->trace_gen != fsess->trace_gen) {
+		sess_thread->trace_gen = fsess->trace_gen;
+		sess_thread->trace_nb_events = 0;
+	}
+	evt = &sess_thread->trace_events[sess_thread->trace_nb_events % fsess->trace_size];
+	evt->start = start;
+	evt->end = end;
+	evt->wait = (task->post_time && (task->post_time < start)) ? (start - task->post_time) : 0;
+	evt->nb_pck_in = nb_pck_in;
+	evt->nb_pck_out = nb_pck_out;
+	evt->filter_idx = filter_idx;
+	evt->task_name = task->log_name;
+	sess_thread->trace_nb_events++;
+	gf_mx_v(sess_thread->trace_mx);
+
+	//end of trace window, the thread closing the window posts the dump
+	if (fsess->trace_end && (end > fsess->trace_end)) {
+		Bool do_dump = GF_FALSE;
+		gf_mx_p(fsess->trace_mx);
+		if (fsess->trace_active && fsess->trace_end && (end > fsess->trace_end)) {
+			fsess->trace_active = GF_FALSE;
+			do_dump = GF_TRUE;
+		}
+		gf_mx_v(fsess->trace_mx);
+		if (do_dump)
+			gf_fs_post_task(fsess, gf_fs_trace_dump_task, NULL, NULL, "trace_dump", fsess);
+	}
+}
+
+GF_EXPORT
+GF_Err gf_fs_trace_start(GF_FilterSession *fsess, u32 duration)
+{
+	if (!fsess || !fsess->trace_file) return GF_BAD_PARAM;
+	gf_mx_p(fsess->trace_mx);
+	if (!fsess->trace_active) {
+		if (!duration) duration = fsess->trace_dur;
+		fsess->trace_gen++;
+		fsess->trace_start = gf_sys_clock_high_res();
+		fsess->trace_end = duration ? fsess->trace_start + 1000 * (u64) duration : 0;
+		fsess->trace_active = GF_TRUE;
+		GF_LOG(GF_LOG_INFO, GF_LOG_SCHEDULER, ("Session tracing started%s\n", duration ? "" : " until session end"));
+	}
+	gf_mx_v(fsess->trace_mx);
+	return GF_OK;
+}
+
+GF_EXPORT
+GF_Err gf_fs_trace_stop(GF_FilterSession *fsess)
+{
+	Bool do_dump = GF_FALSE;
+	if (!fsess || !fsess->trace_file) return GF_BAD_PARAM;
+	gf_mx_p(fsess->trace_mx);
+	if (fsess->trace_active) {
+		fsess->trace_active = GF_FALSE;
+		do_dump = GF_TRUE;
+	}
+	gf_mx_v(fsess->trace_mx);
+	if (do_dump)
+		gf_fs_post_task(fsess, gf_fs_trace_dump_task, NULL, NULL, "trace_dump", fsess);
+	return GF_OK;
+}
+
+static void gf_fs_trace_write_name(FILE *out, const char *name, Bool folded)
+{
+	char c;
+	if (!name) name = "unknown";
+	if (!strpbrk(name, folded ? "; " : "\"\\\n\r\t")) {
+		gf_fputs(name, out);
+		return;
+	}
+	while ((c = *name++)) {
+		if (folded) {
+			//frames are separated by ';' and the sample count by the last space
+			if ((c==';') || (c==' ')) c = '_';
+			gf_fputc(c, out);
+		} else {
+			if ((c=='"') || (c=='\\')) gf_fputc('\\', out);
+			if ((u8) c < 0x20) c = ' ';
+			gf_fputc(c, out);
+		}
+	}
+}
+
+typedef struct
+{
+	u32 thid, filter_idx;
+	const char *task_name, *filter_name;
+	u64 duration;
+} GF_FSTraceStack;
+
+//trace event copied from the thread ring buffers, written to file once the trace lock is released
+typedef struct
+{
+	GF_FSTraceEvent evt;
+	u32 thid;
+	const char *filter_name;
+} GF_FSTraceSnapshot;
+
+void gf_fs_trace_dump(GF_FilterSession *fsess)
+{
+	u32 i, j, nb_threads, nb_stacks=0, alloc_stacks=0, trace_gen;
+	u64 nb_events=0, alloc_events=0, trace_start;
+	GF_FSTraceStack *stacks = NULL;
+	GF_FSTraceSnapshot *events = NULL;
+	char *name, *ext;
+	FILE *json, *folded;
+	if (!fsess->trace_file) return;
+
+	gf_mx_p(fsess->trace_mx);
+	if (fsess->trace_dumped_gen == fsess->trace_gen) {
+		gf_mx_v(fsess->trace_mx);
+		return;
+	}
+	fsess->trace_dumped_gen = fsess->trace_gen;
+	trace_gen = fsess->trace_gen;
+	trace_start = fsess->trace_start;
+
+	//snapshot events under lock, file writing is done once the lock is released
+	nb_threads = 1 + gf_list_count(fsess->threads);
+	//a ring holds at most trace_size events, allocate for full rings so that events recorded meanwhile fit
+	for (i=0; i<nb_threads; i++) {
+		GF_SessionThread *sess_th = i ? gf_list_get(fsess->threads, i-1) : &fsess->main_th;
+		if (sess_th->trace_events) alloc_events += fsess->trace_size;
+	}
+	if (alloc_events) {
+		events = gf_malloc(sizeof(GF_FSTraceSnapshot) * (size_t) alloc_events);
+		if (!events) {
+			gf_mx_v(fsess->trace_mx);
+			GF_LOG(GF_LOG_ERROR, GF_LOG_SCHEDULER, ("Failed to allocate trace snapshot of "LLU" events\n", alloc_events));
+			return;
+		}
+	}
+	//each ring is copied under its thread lock, so that no event is read while being written
+	for (i=0; i<nb_threads; i++) {
+		u64 k, nb;
+		GF_SessionThread *sess_th = i ? gf_list_get(fsess->threads, i-1) : &fsess->main_th;
+		if (!sess_th->trace_events) continue;
+
+		gf_mx_p(sess_th->trace_mx);
+		if (sess_th->trace_gen != trace_gen) {
+			gf_mx_v(sess_th->trace_mx);
+			continue;
+		}
+		nb = sess_th->trace_nb_events;
+		k = (nb > fsess->trace_size) ? nb - fsess->trace_size : 0;
+		for (; k<nb; k++) {
+			GF_FSTraceSnapshot *snap = &events[nb_events];
+			snap->evt = sess_th->trace_events[k % fsess->trace_size];
+			snap->thid = i;
+			snap->filter_name = snap->evt.filter_idx ? gf_list_get(fsess->trace_names, snap->evt.filter_idx-1) : "session";
+			nb_events++;
+		}
+		gf_mx_v(sess_th->trace_mx);
+	}
+	gf_mx_v(fsess->trace_mx);
+
+	name = gf_malloc(sizeof(char) * (strlen(fsess->trace_file) + 30));
+	if (!name) {
+		if (events) gf_free(events);
+		return;
+	}
+	//keep file name of first window, append window number for the next ones
+	if (trace_gen>1) sprintf(name, "%s_%u.json", fsess->trace_file, trace_gen);
+	else sprintf(name, "%s.json", fsess->trace_file);
+	json = gf_fopen(name, "wt");
+	ext = strrchr(name, '.');
+	strcpy(ext, ".folded");
+	folded = gf_fopen(name, "wt");
+	ext[0] = 0;
+	if (!json || !folded) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_SCHEDULER, ("Failed to open trace output files %s.json/.folded\n", name));
+		if (json) gf_fclose(json);
+		if (folded) gf_fclose(folded);
+		gf_free(name);
+		if (events) gf_free(events);
+		return;
+	}
+
+	gf_fprintf(json, "{\"traceEvents\":[\n");
+	for (i=0; i<nb_threads; i++) {
+		gf_fprintf(json, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"FSThread%u\"}}", i ? ",\n" : "", i, i);
+	}
+	for (i=0; i<nb_events; i++) {
+		GF_FSTraceSnapshot *snap = &events[i];
+		GF_FSTraceEvent *evt = &snap->evt;
+		u64 ts = (evt->start > trace_start) ? (evt->start - trace_start) : 0;
+
+		gf_fprintf(json, ",\n{\"name\":\"");
+		gf_fs_trace_write_name(json, evt->task_name, GF_FALSE);
+		gf_fprintf(json, "\",\"cat\":\"");
+		gf_fs_trace_write_name(json, snap->filter_name, GF_FALSE);
+		gf_fprintf(json, "\",\"ph\":\"X\",\"ts\":"LLU",\"dur\":"LLU",\"pid\":1,\"tid\":%u,\"args\":{\"wait\":"LLU",\"pck_in\":%u,\"pck_out\":%u}}",
+			ts, evt->end - evt->start, snap->thid, evt->wait, evt->nb_pck_in, evt->nb_pck_out);
+
+		//aggregate per thread, filter and task for folded stacks
+		for (j=0; j<nb_stacks; j++) {
+			if ((stacks[j].thid==snap->thid) && (stacks[j].filter_idx==evt->filter_idx) && (stacks[j].task_name==evt->task_name))
+				break;
+		}
+		if (j==nb_stacks) {
+			if (nb_stacks==alloc_stacks) {
+				alloc_stacks = alloc_stacks ? 2*alloc_stacks : 64;
+				stacks = gf_realloc(stacks, sizeof(GF_FSTraceStack) * alloc_stacks);
+				if (!stacks) {
+					nb_stacks = alloc_stacks = 0;
+					continue;
+				}
+			}
+			stacks[j].thid = snap->thid;
+			stacks[j].filter_idx = evt->filter_idx;
+			stacks[j].task_name = evt->task_name;
+			stacks[j].filter_name = snap->filter_name;
+			stacks[j].duration = 0;
+			nb_stacks++;
+		}
+		stacks[j].duration += evt->end - evt->start;
+	}
+	gf_fprintf(json, "\n]}\n");
+
+	for (j=0; j<nb_stacks; j++) {
+		gf_fprintf(folded, "FSThread%u;", stacks[j].thid);
+		gf_fs_trace_write_name(folded, stacks[j].filter_name, GF_TRUE);
+		gf_fputc(';', folded);
+		gf_fs_trace_write_name(folded, stacks[j].task_name, GF_TRUE);
+		gf_fprintf(folded, " "LLU"\n", stacks[j].duration);
+	}
+	gf_fclose(json);
+	gf_fclose(folded);
+	if (stacks) gf_free(stacks);
+	if (events) gf_free(events);
+	GF_LOG(GF_LOG_INFO, GF_LOG_SCHEDULER, ("Session trace of "LLU" tasks written to %s.json and %s.folded\n", nb_events, name, name));
+	gf_free(name);
+}
+
 //in mono thread mode, we cannot always sleep for the requested timeout in case there are more tasks to be processed
 //this defines the number of pending tasks above wich we limit sleep
 #define MONOTH_MIN_TASKS	2
@@ -1151,6 +1758,12 @@ static u32 gf_fs_thread_proc(GF_SessionThread *sess_thread)
 
 	GF_Filter *current_filter = NULL;
 	sess_thread->th_id = gf_th_id();
+#ifdef GF_FS_TLS
+	if (thid) {
+		tls_fsess = fsess;
+		tls_sess_th = sess_thread;
+	}
+#endif
 
 #ifndef GPAC_DISABLE_REMOTERY
 	sess_thread->rmt_tasks=40;
@@ -1159,6 +1772,13 @@ static u32 gf_fs_thread_proc(GF_SessionThread *sess_thread)
 
 	gf_rmt_begin(fs_thread, 0);
 
+	if (!sess_thread->affinity_set) {
+		sess_thread->affinity_set = GF_TRUE;
+		if (sess_thread->nb_cpus) {
+			gf_th_set_cpu_affinity(NULL, sess_thread->cpus, sess_thread->nb_cpus);
+		}
+	}
+
 	safe_int_inc(&fsess->active_threads);
 
 	if (!thid && fsess->no_main_thread) {
@@ -1168,7 +1788,10 @@ static u32 gf_fs_thread_proc(GF_SessionThread *sess_thread)
 	while (1) {
 		Bool notified;
 		Bool requeue = GF_FALSE;
-		u64 active_start, task_time;
+		Bool traced;
+		u32 trace_filter_idx = 0;
+		u64 active_start, task_time, task_start, task_end;
+		u64 trace_pck_in = 0, trace_pck_out = 0;
 		GF_FSTask *task=NULL;
 #ifdef CHECK_TASK_LIST_INTEGRITY
 		GF_Filter *prev_current_filter = NULL;
@@ -1207,6 +1830,9 @@ static u32 gf_fs_thread_proc(GF_SessionThread *sess_thread)
 				}
 				if (!task) {
 					task = gf_fq_pop(fsess->tasks);
+					//in work-stealing mode, also process tasks of secondary threads, otherwise they starve when the owner thread is busy
+					if (!task && fsess->work_steal)
+						task = gf_fs_sched_steal_task(fsess, sess_thread, 0);
 					if (task && task->blocking) {
 						gf_fq_add(fsess->tasks, task);
 						task = NULL;
@@ -1214,6 +1840,8 @@ static u32 gf_fs_thread_proc(GF_SessionThread *sess_thread)
 					}
 				}
 				force_secondary_tasks = GF_FALSE;
+			} else if (sess_thread->local_tasks) {
+				task = gf_fs_sched_pop_task(fsess, sess_thread, thid);
 			} else {
 				task = gf_fq_pop(fsess->tasks);
 			}
@@ -1263,7 +1891,7 @@ static u32 gf_fs_thread_proc(GF_SessionThread *sess_thread)
 
 			//no pending tasks and first time main task queue is empty, flush to detect if we
 			//are indeed done
-			if (!fsess->tasks_pending && !fsess->tasks_in_process && !sess_thread->has_seen_eot && !gf_fq_count(fsess->tasks)) {
+			if (!fsess->tasks_pending && !fsess->tasks_in_process && !sess_thread->has_seen_eot && !gf_fs_sched_secondary_count(fsess)) {
 				//maybe last task, force a notify to check if we are truly done
 				sess_thread->has_seen_eot = GF_TRUE;
 				//not main thread and some tasks pending on main, notify only ourselves
@@ -1516,6 +2144,15 @@ static u32 gf_fs_thread_proc(GF_SessionThread *sess_thread)
 			current_filter->in_process = GF_TRUE;
 			current_filter->process_th_id = gf_th_id();
 		}
+		if (fsess->cpu_nodes) {
+			gf_fs_check_placement(fsess, sess_thread, current_filter);
+		}
+		//remember last secondary thread for this filter, unless we are not on the filter NUMA node
+		if (current_filter && sess_thread->local_tasks
+			&& ((current_filter->numa_node<0) || (current_filter->numa_node==sess_thread->numa_node))
+		) {
+			current_filter->sched_thread = sess_thread;
+		}
 
 		sess_thread->nb_tasks++;
 		sess_thread->has_seen_eot = GF_FALSE;
@@ -1527,16 +2164,38 @@ static u32 gf_fs_thread_proc(GF_SessionThread *sess_thread)
 
 		safe_int_inc(& fsess->tasks_in_process );
 		assert( task->run_task );
-		task_time = gf_sys_clock_high_res();
+
+		traced = fsess->trace_active;
+		if (traced) {
+			trace_filter_idx = gf_fs_trace_filter_idx(fsess, current_filter);
+			if (current_filter) {
+				trace_pck_in = current_filter->nb_pck_processed;
+				trace_pck_out = current_filter->nb_pck_sent;
+			}
+		}
+		task_start = gf_sys_clock_high_res();
 
 		task->can_swap = GF_FALSE;
 		task->requeue_request = GF_FALSE;
 		task->run_task(task);
 		requeue = task->requeue_request;
 
-		task_time = gf_sys_clock_high_res() - task_time;
+		task_end = gf_sys_clock_high_res();
+		task_time = task_end - task_start;
 		safe_int_dec(& fsess->tasks_in_process );
 
+		if (traced) {
+			u32 nb_in=0, nb_out=0;
+			//filter may have been destroyed by the task
+			if (task->filter) {
+				nb_in = (u32) (task->filter->nb_pck_processed - trace_pck_in);
+				nb_out = (u32) (task->filter->nb_pck_sent - trace_pck_out);
+			}
+			gf_fs_trace_record(fsess, sess_thread, task, trace_filter_idx, task_start, task_end, nb_in, nb_out);
+			//requeued tasks wait from now on
+			task->post_time = task_end;
+		}
+
 		//may now be NULL if task was a filter destruction task
 		current_filter = task->filter;
 
@@ -1662,7 +2321,7 @@ static u32 gf_fs_thread_proc(GF_SessionThread *sess_thread)
 				if (task->filter && (task->filter->freg->flags & GF_FS_REG_MAIN_THREAD)) {
 					gf_fq_add(fsess->main_thread_tasks, task);
 				} else {
-					gf_fq_add(fsess->tasks, task);
+					gf_fs_sched_push_task(fsess, task, GF_TRUE);
 				}
 				gf_fs_sema_io(fsess, GF_TRUE, use_main_sema);
 			}
@@ -1704,7 +2363,7 @@ static u32 gf_fs_thread_proc(GF_SessionThread *sess_thread)
 			current_filter->in_process = GF_FALSE;
 		}
 		//not requeuing and first time we have an empty task queue, flush to detect if we are indeed done
-		if (!current_filter && !fsess->tasks_pending && !sess_thread->has_seen_eot && !gf_fq_count(fsess->tasks)) {
+		if (!current_filter && !fsess->tasks_pending && !sess_thread->has_seen_eot && !gf_fs_sched_secondary_count(fsess)) {
 			//if not the main thread, or if main thread and task list is empty, enter end of session probing mode
 			if (thid || !gf_fq_count(fsess->main_thread_tasks) ) {
 				//maybe last task, force a notify to check if we are truly done. We only tag "session done" for the non-main
@@ -1761,6 +2420,8 @@ GF_Err gf_fs_run(GF_FilterSession *fsess)
 	fsess->main_th.has_seen_eot = GF_FALSE;
 	fsess->nb_threads_stopped = 0;
 
+	gf_fs_init_cpu_nodes(fsess, GF_FALSE);
+
 	nb_threads = gf_list_count(fsess->threads);
 	for (i=0;i<nb_threads; i++) {
 		GF_SessionThread *sess_th = gf_list_get(fsess->threads, i);
@@ -1909,7 +2570,7 @@ GF_Err gf_fs_stop(GF_FilterSession *fsess)
 		if (gf_fq_count(fsess->main_thread_tasks))
 			continue;
 
-		if (count && (count == fsess->nb_threads_stopped) && gf_fq_count(fsess->tasks) ) {
+		if (count && (count == fsess->nb_threads_stopped) && gf_fs_sched_secondary_count(fsess) ) {
 			continue;
 		}
 		break;
@@ -1965,7 +2626,7 @@ static GFINLINE void print_filter_name(GF_Filter *f, Bool skip_id, Bool skip_arg
 GF_EXPORT
 void gf_fs_print_stats(GF_FilterSession *fsess)
 {
-	u64 run_time=0, active_time=0, nb_tasks=0, nb_filters=0;
+	u64 run_time=0, active_time=0, nb_tasks=0, nb_filters=0, nb_steals=0, nb_slab_hits=0;
 	u32 i, count;
 
 	GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("\n"));
@@ -2041,22 +2702,46 @@ void gf_fs_print_stats(GF_FilterSession *fsess)
 	count=gf_list_count(fsess->threads);
 	GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("Session stats - threads %d\n", 1+count));
 
-	GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("\tThread %u: run_time "LLU" us active_time "LLU" us nb_tasks "LLU"\n", 1, fsess->main_th.run_time, fsess->main_th.active_time, fsess->main_th.nb_tasks));
+	GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("\tThread %u: run_time "LLU" us active_time "LLU" us nb_tasks "LLU"", 1, fsess->main_th.run_time, fsess->main_th.active_time, fsess->main_th.nb_tasks));
+	if (fsess->cpu_nodes) {
+		GF_LOG(GF_LOG_INFO, GF_LOG_APP, (" node %d cpu_migrations "LLU" filter_migrations "LLU"", fsess->main_th.numa_node, fsess->main_th.nb_cpu_migrations, fsess->main_th.nb_migrations));
+	}
+	GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("\n"));
 
 	run_time+=fsess->main_th.run_time;
 	active_time+=fsess->main_th.active_time;
 	nb_tasks+=fsess->main_th.nb_tasks;
+	nb_slab_hits+=fsess->main_th.nb_slab_hits;
 
 	for (i=0; i<count; i++) {
 		GF_SessionThread *s = gf_list_get(fsess->threads, i);
 
-		GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("\tThread %u: run_time "LLU" us active_time "LLU" us nb_tasks "LLU"\n", i+2, s->run_time, s->active_time, s->nb_tasks));
+		GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("\tThread %u: run_time "LLU" us active_time "LLU" us nb_tasks "LLU"", i+2, s->run_time, s->active_time, s->nb_tasks));
+		if (fsess->work_steal) {
+			GF_LOG(GF_LOG_INFO, GF_LOG_APP, (" local_tasks "LLU" steals "LLU"", s->nb_local_tasks, s->nb_steals));
+		}
+		if (fsess->cpu_nodes) {
+			GF_LOG(GF_LOG_INFO, GF_LOG_APP, (" node %d cpu_migrations "LLU" filter_migrations "LLU"", s->numa_node, s->nb_cpu_migrations, s->nb_migrations));
+		}
+		GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("\n"));
 
 		run_time+=s->run_time;
 		active_time+=s->active_time;
 		nb_tasks+=s->nb_tasks;
+		nb_steals+=s->nb_steals;
+		nb_slab_hits+=s->nb_slab_hits;
+	}
+	GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("\nTotal: run_time "LLU" us active_time "LLU" us nb_tasks "LLU"", run_time, active_time, nb_tasks));
+	if (fsess->work_steal) {
+		GF_LOG(GF_LOG_INFO, GF_LOG_APP, (" steals "LLU"", nb_steals));
+	}
+	GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("\n"));
+
+	if (fsess->slab) {
+		GF_FilterSlab *slab = fsess->slab;
+		GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("Packet slab: hits "LLU" (thread "LLU" shared "LLU") misses %u drops %u oversize %u\n", nb_slab_hits + slab->nb_depot_hits, nb_slab_hits, slab->nb_depot_hits, slab->nb_misses, slab->nb_drops, slab->nb_oversize));
+		GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("\tbytes held "LLU" (peak "LLU" max "LLU") bytes used "LLU" (peak "LLU")\n", slab->bytes_held, slab->peak_held, slab->max_bytes, slab->bytes_used, slab->peak_used));
 	}
-	GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("\nTotal: run_time "LLU" us active_time "LLU" us nb_tasks "LLU"\n", run_time, active_time, nb_tasks));
 }
 
 static void gf_fs_print_filter_outputs(GF_Filter *f, GF_List *filters_done, u32 indent, GF_FilterPid *pid, GF_Filter *alias_for)
@@ -2171,6 +2856,12 @@ void gf_fs_send_update(GF_FilterSession *fsess, const char *fid, GF_Filter *filt
 	GF_FilterUpdate *upd;
 	u32 i, count;
 	Bool removed = GF_FALSE;
+	//session trace window
+	if (!fid && !filter && name && !strcmp(name, "trace")) {
+		if (val && !strcmp(val, "stop")) gf_fs_trace_stop(fsess);
+		else gf_fs_trace_start(fsess, val ? atoi(val) : 0);
+		return;
+	}
 	if ((!fid && !filter) || !name) return;
 	if (!fsess) {
 		if (!filter) return;
@@ -3054,7 +3745,7 @@ Bool gf_fs_is_last_task(GF_FilterSession *fsess)
 	if (!fsess) return GF_TRUE;
 	if (fsess->tasks_pending>1) return GF_FALSE;
 	if (gf_fq_count(fsess->main_thread_tasks)) return GF_FALSE;
-	if (gf_fq_count(fsess->tasks)) return GF_FALSE;
+	if (gf_fs_sched_secondary_count(fsess)) return GF_FALSE;
 	return GF_TRUE;
 }
 
@@ -51,6 +51,8 @@ struct __gf_prop_entry
 	GF_FilterSession *session;
 	volatile u32 reference_count;
 	u32 p4cc;
+	//session-wide identifier of pname for non built-in properties, 0 otherwise
+	u32 name_id;
 	Bool name_alloc;
 	char *pname;
 
@@ -58,19 +60,34 @@ struct __gf_prop_entry
 	u32 alloc_size;
 };
 
-#ifndef GF_PROPS_HASHTABLE_SIZE
-#define GF_PROPS_HASHTABLE_SIZE 0
-#endif
+//number of properties stored in the map itself, lookup is a linear scan below this count
+//and uses an open-addressed index above
+#define GF_PROPS_INLINE_SIZE	8
+
+//table of interned property names, a property name is identified by its index+1 in names
+//names and index slots are only appended, and a new table is published when full, so that lookups don't need locking
+typedef struct __gf_prop_names
+{
+	char **names;
+	u32 nb_names, max_names;
+	//open-addressed index of name ids, twice as large as names
+	u32 *index;
+	u32 index_size;
+	//previous table, kept until the session is destroyed since lookups may still be using it
+	struct __gf_prop_names *prev;
+} GF_PropNames;
 
 void gf_propmap_del(void *pmap);
 
 typedef struct
 {
-#if GF_PROPS_HASHTABLE_SIZE
-	GF_List *hash_table[GF_PROPS_HASHTABLE_SIZE];
-#else
-	GF_List *properties;
-#endif
+	//properties in insertion order, points to inline_props until more than GF_PROPS_INLINE_SIZE properties are set
+	GF_PropertyEntry **props;
+	u32 nb_props, alloc_props;
+	GF_PropertyEntry *inline_props[GF_PROPS_INLINE_SIZE];
+	//open-addressed index of entries in props, only used above GF_PROPS_INLINE_SIZE properties
+	GF_PropertyEntry **index;
+	u32 index_size;
 	volatile u32 reference_count;
 	//number of references hold by packet references - since these may be destroyed at the end of the refering filter
 	//the pid might be dead. This is only used for pid props maps
@@ -85,19 +102,17 @@ void gf_props_del(GF_PropertyMap *prop);
 void gf_props_reset(GF_PropertyMap *prop);
 
 GF_Err gf_props_set_property(GF_PropertyMap *map, u32 p4cc, const char *name, char *dyn_name, const GF_PropertyValue *value);
-GF_Err gf_props_insert_property(GF_PropertyMap *map, u32 hash, u32 p4cc, const char *name, char *dyn_name, const GF_PropertyValue *value);
+GF_Err gf_props_insert_property(GF_PropertyMap *map, u32 p4cc, const char *name, char *dyn_name, const GF_PropertyValue *value);
 
-void gf_props_remove_property(GF_PropertyMap *map, u32 hash, u32 p4cc, const char *name);
+void gf_props_remove_property(GF_PropertyMap *map, u32 p4cc, const char *name);
 
 const GF_PropertyValue *gf_props_get_property(GF_PropertyMap *map, u32 prop_4cc, const char *name);
 
 const GF_PropertyEntry *gf_props_get_property_entry(GF_PropertyMap *map, u32 prop_4cc, const char *name);
 
-#if GF_PROPS_HASHTABLE_SIZE
-u32 gf_props_hash_djb2(u32 p4cc, const char *str);
-#else
-#define gf_props_hash_djb2(_a, _b) 0
-#endif
+//gets the session-wide identifier of a property name, creating it if create is set - returns 0 if name is not known
+u32 gf_props_get_name_id(GF_FilterSession *fsess, const char *name, Bool create);
+void gf_props_names_del(GF_FilterSession *fsess);
 
 GF_Err gf_props_merge_property(GF_PropertyMap *dst_props, GF_PropertyMap *src_props, gf_filter_prop_filter filter_prop, void *cbk);
 
@@ -114,12 +129,29 @@ typedef struct __gf_filter_queue GF_FilterQueue;
 GF_FilterQueue *gf_fq_new(const GF_Mutex *mx);
 void gf_fq_del(GF_FilterQueue *fq, void (*item_delete)(void *) );
 void gf_fq_add(GF_FilterQueue *fq, void *item);
+//adds nb_items items in order, as a single splice in lock-free mode or under a single lock otherwise
+void gf_fq_add_batch(GF_FilterQueue *fq, void **items, u32 nb_items);
 void *gf_fq_pop(GF_FilterQueue *fq);
 void *gf_fq_head(GF_FilterQueue *fq);
 u32 gf_fq_count(GF_FilterQueue *fq);
 void *gf_fq_get(GF_FilterQueue *fq, u32 idx);
 void gf_fq_enum(GF_FilterQueue *fq, Bool (*enum_func)(void *udta1, void *item), void *udta);
 
+typedef struct __gf_filter_deque GF_FilterDeque;
+//constructs a new double-ended queue, used as per-thread task list by the work-stealing scheduler.
+//The owner thread pushes and pops at the bottom (LIFO), other threads steal from the top (FIFO). All operations are mutex-protected
+GF_FilterDeque *gf_fdq_new(const char *name);
+void gf_fdq_del(GF_FilterDeque *dq, void (*item_delete)(void *) );
+//push at bottom of queue, returns GF_OUT_OF_MEM if the queue could not be grown (item is not added)
+GF_Err gf_fdq_push(GF_FilterDeque *dq, void *item);
+//push at top of queue, the item is popped by the owner after all other items and is the first one stolen
+GF_Err gf_fdq_push_top(GF_FilterDeque *dq, void *item);
+//pop from bottom of queue
+void *gf_fdq_pop(GF_FilterDeque *dq);
+//pop from top of queue
+void *gf_fdq_steal(GF_FilterDeque *dq);
+u32 gf_fdq_count(GF_FilterDeque *dq);
+
 
 typedef void (*gf_destruct_fun)(void *cbck);
 
@@ -221,6 +253,8 @@ struct __gf_filter_pck
 
 	//for allocated memory packets
 	u32 alloc_size;
+	//0 if data was allocated with gf_malloc, slab size class + 1 otherwise
+	u32 slab_class;
 	//for shared memory packets: 0: cloned mem, 1: read/write mem from source filter, 2: read-only mem from filter
 	//note that packets with frame_ifce are always considered as read-only memory
 	u32 filter_owns_mem;
@@ -252,7 +286,8 @@ struct __gf_fs_task
 	Bool blocking;
 
 	u64 schedule_next_time;
-
+	//time at which the task was posted or last executed, only set when tracing
+	u64 post_time;
 
 	gf_fs_task_callback run_task;
 	GF_Filter *filter;
@@ -261,12 +296,71 @@ struct __gf_fs_task
 	void *udta;
 };
 
+//writes the current trace window as Chrome trace events and folded stacks
+void gf_fs_trace_dump(GF_FilterSession *fsess);
+
 void gf_fs_post_task(GF_FilterSession *fsess, gf_fs_task_callback fun, GF_Filter *filter, GF_FilterPid *pid, const char *log_name, void *udta);
 void gf_fs_post_task_ex(GF_FilterSession *fsess, gf_fs_task_callback task_fun, GF_Filter *filter, GF_FilterPid *pid, const char *log_name, void *udta, Bool requires_main_thread, Bool force_direct_call);
 
 void gf_filter_pid_send_event_downstream(GF_FSTask *task);
 
 
+//smallest slab block size is 1<<GF_SLAB_MIN_SHIFT
+#define GF_SLAB_MIN_SHIFT	8
+//number of power-of-two size classes, the largest block size is 1<<(GF_SLAB_MIN_SHIFT+GF_SLAB_NB_CLASSES-1) (1 MB)
+#define GF_SLAB_NB_CLASSES	13
+//max number of blocks in a thread magazine
+#define GF_SLAB_MAG_SIZE	8
+
+//trace record of one executed task
+typedef struct
+{
+	//task execution start and end time in microseconds
+	u64 start, end;
+	//time spent by the task in the task lists before execution
+	u64 wait;
+	//number of packets consumed and produced by the filter during the task
+	u32 nb_pck_in, nb_pck_out;
+	//index+1 of the filter name in the session trace names, 0 for tasks without filter
+	u32 filter_idx;
+	const char *task_name;
+} GF_FSTraceEvent;
+
+//per-thread cache of free blocks for one size class, only accessed by its owner thread
+typedef struct
+{
+	void *blocks[GF_SLAB_MAG_SIZE];
+	u32 nb_blocks;
+} GF_SlabMagazine;
+
+//session-wide list of free blocks for one size class, protected by the slab mutex
+typedef struct
+{
+	void **blocks;
+	u32 nb_blocks, nb_alloc;
+} GF_SlabDepot;
+
+typedef struct
+{
+	GF_Mutex *mx;
+	GF_SlabDepot depots[GF_SLAB_NB_CLASSES];
+	//max number of bytes kept in free blocks (depots and magazines)
+	u64 max_bytes;
+	//number of bytes currently kept in free blocks
+	volatile u64 bytes_held;
+	//number of bytes currently used by packets
+	volatile u64 bytes_used;
+	u64 peak_held, peak_used;
+	//blocks allocated from the system, blocks released to the system because of the memory ceiling, blocks too large for the slab
+	volatile u32 nb_misses, nb_drops, nb_oversize;
+	//blocks fetched from depots - hits from magazines are counted per thread
+	u64 nb_depot_hits;
+} GF_FilterSlab;
+
+GF_FilterSlab *gf_fs_slab_new(u64 max_bytes);
+//destroys the slab of the session and all blocks kept in depots and thread magazines
+void gf_fs_slab_del(GF_FilterSession *fsess);
+
 typedef struct __gf_fs_thread
 {
 	//NULL for main thread
@@ -280,6 +374,39 @@ typedef struct __gf_fs_thread
 	u64 run_time;
 	u64 active_time;
 
+	//local task list for work-stealing scheduler, NULL otherwise
+	GF_FilterDeque *local_tasks;
+	//number of tasks fetched from the local task list
+	u64 nb_local_tasks;
+	//number of tasks stolen from other threads
+	u64 nb_steals;
+
+	//CPUs this thread is pinned to, if any
+	u32 *cpus;
+	u32 nb_cpus;
+	Bool affinity_set;
+	//current NUMA node, -1 if unknown
+	s32 numa_node;
+	s32 last_cpu;
+	//number of CPU changes of this thread
+	u64 nb_cpu_migrations;
+	//number of tasks processed for filters last processed on another NUMA node
+	u64 nb_migrations;
+
+	//slab magazines of this thread, one per size class, allocated at first use
+	GF_SlabMagazine *slab_mags;
+	//number of blocks fetched from the slab magazines of this thread
+	u64 nb_slab_hits;
+
+	//trace ring buffer of this thread, allocated with the thread if tracing is enabled
+	GF_FSTraceEvent *trace_events;
+	//trace window the ring buffer belongs to
+	u32 trace_gen;
+	//number of events recorded in the window, the ring buffer only keeps the last trace_size ones
+	u64 trace_nb_events;
+	//protects the ring buffer against trace dumps from other threads
+	GF_Mutex *trace_mx;
+
 #ifndef GPAC_DISABLE_REMOTERY
 	u32 rmt_tasks;
 	char rmt_name[20];
@@ -308,6 +435,11 @@ struct __gf_filter_session
 	u32 flags;
 	Bool use_locks;
 	Bool direct_mode;
+	//work-stealing scheduler, each secondary thread has its own task list
+	Bool work_steal;
+	//NUMA node of each CPU, only set when thread affinity is used or when the system has several NUMA nodes
+	s32 *cpu_nodes;
+	u32 nb_cpu_nodes, nb_numa_nodes;
 	volatile u32 tasks_in_process;
 	Bool requires_solved_graph;
 	Bool no_main_thread;
@@ -331,10 +463,22 @@ struct __gf_filter_session
 	GF_FilterQueue *prop_maps_entry_reservoir;
 	//reservoir for property entries with allocated data buffers - properties may be inherited between packets
 	GF_FilterQueue *prop_maps_entry_data_alloc_reservoir;
-#if GF_PROPS_HASHTABLE_SIZE
-	//reservoir for property maps hash table entries (GF_Lists) for PID and packets properties
-	GF_FilterQueue *prop_maps_list_reservoir;
-#endif
+	//interned names of non built-in properties, read without lock - modified only under prop_names_mx
+	GF_PropNames * volatile prop_names;
+	GF_Mutex *prop_names_mx;
+
+	//task tracing, only enabled if trace_file is set
+	char *trace_file;
+	//size of per-thread trace ring buffers in events, and default trace window duration in ms
+	u32 trace_size, trace_dur;
+	volatile u32 trace_active;
+	//current trace window and last dumped window
+	u32 trace_gen, trace_dumped_gen;
+	//start and end time of trace window, end is 0 if no limit
+	u64 trace_start, trace_end;
+	//names of traced filters, filters keep their index in this list
+	GF_List *trace_names;
+	GF_Mutex *trace_mx;
 	//reservoir for reference property packets - we mutualize at session level to collect them
 	//it is not possible to do so at filter or pid level because a prop ref packet may be destroyed after the source
 	//pid/packet is destroyed, and we don't want to track them per pid/filter
@@ -350,6 +494,9 @@ struct __gf_filter_session
 	GF_List *threads;
 	GF_SessionThread main_th;
 
+	//slab allocator for packet data, NULL if disabled
+	GF_FilterSlab *slab;
+
 	//only used in forced lock mode
 	GF_Mutex *tasks_mx;
 
@@ -510,6 +657,12 @@ struct __gf_filter
 	//set to true when the filter is being processed by a thread
 	volatile Bool in_process;
 	u32 process_th_id;
+	//last secondary thread having processed this filter, only used by work-stealing scheduler
+	GF_SessionThread *sched_thread;
+	//NUMA node the filter should run on, -1 if any
+	s32 numa_node;
+	//NUMA node of the thread which last processed the filter, -1 if unknown
+	s32 last_node;
 	//user data for the filter implementation
 	void *filter_udta;
 
@@ -588,6 +741,8 @@ struct __gf_filter
 	u64 nb_bytes_processed;
 	//number of packets sent by this filter
 	u64 nb_pck_sent;
+	//index+1 of the filter name in the session trace names, 0 if not traced yet
+	u32 trace_idx;
 	//number of hardware frames packets sent by this filter
 	u64 nb_hw_pck_sent;
 	//number of processing errors in the lifetime of the filter
@@ -735,6 +890,14 @@ void gf_filter_pid_inst_delete_task(GF_FSTask *task);
 
 void gf_filter_pid_inst_reset(GF_FilterPidInst *pidinst);
 void gf_filter_pid_inst_del(GF_FilterPidInst *pidinst);
+//drops all packets and packet instances kept for reuse, so that new ones are allocated (and first touched) by the calling thread
+void gf_filter_reset_pck_reservoirs(GF_Filter *filter);
+//allocates (or reallocates if keep_data is set) data of a packet with at least size bytes, using the session slab if enabled
+Bool gf_filter_pck_alloc_data(GF_FilterSession *fsess, GF_FilterPacket *pck, u32 size, Bool keep_data);
+//frees data of a packet allocated with gf_filter_pck_alloc_data
+void gf_filter_pck_free_data(GF_FilterSession *fsess, GF_FilterPacket *pck);
+//returns the session thread object of the calling thread, or NULL if not a session thread
+GF_SessionThread *gf_fs_get_current_thread(GF_FilterSession *fsess);
 
 void gf_filter_forward_clock(GF_Filter *filter);
 
@@ -819,6 +982,9 @@ struct __gf_filter_pid_inst
 
 	GF_Fraction64 last_ts_drop;
 
+	//packet instances pending dispatch during gf_filter_pck_send_batch, only accessed by the thread of the source filter
+	GF_FilterPacketInstance **batch_insts;
+	u32 nb_batch_insts, alloc_batch_insts;
 };
 
 struct __gf_filter_pid
@@ -849,6 +1015,8 @@ struct __gf_filter_pid
 	//set whenever an eos packet is dispatched, reset whenever a regular packet is dispatched
 	Bool has_seen_eos;
 	u32 nb_reaggregation_pending;
+	//set when packet instances for this pid are pending in gf_filter_pck_send_batch
+	Bool batch_pending;
 
 	//only valid for decoder output pids
 	u32 max_buffer_unit;
@@ -74,9 +74,20 @@ typedef struct
 	Bool crypt_init;
 } GF_CENCDecStream;
 
+typedef struct
+{
+	//first for casting
+	GF_CryptJob job;
+	//output packet, sent once the job is done
+	GF_FilterPacket *pck;
+	//set if the job was posted to the crypto pool, otherwise packet can be sent right away
+	Bool posted;
+} GF_CENCDecJob;
+
 typedef struct
 {
 	const char *cfile;
+	s32 threads;
 
 	GF_CryptInfo *cinfo;
 	
@@ -84,8 +95,77 @@ typedef struct
 	GF_BitStream *bs_r;
 
 	GF_DownloadManager *dm;
+
+	//crypto pool, NULL if no threading
+	GF_CryptPool *pool;
+	u32 max_pending;
+	//jobs in output order
+	GF_List *pending_jobs;
+	GF_List *job_reservoir;
+	//job being built
+	GF_CENCDecJob *cur_job;
 } GF_CENCDecCtx;
 
+static GF_CENCDecJob *cenc_dec_get_job(GF_CENCDecCtx *ctx)
+{
+	GF_CENCDecJob *job = gf_list_pop_back(ctx->job_reservoir);
+	if (!job) {
+		GF_SAFEALLOC(job, GF_CENCDecJob);
+	}
+	return job;
+}
+
+static void cenc_dec_del_job(GF_CENCDecJob *job)
+{
+	if (job->job.ranges) gf_free(job->job.ranges);
+	gf_free(job);
+}
+
+//sends packets of completed jobs in order, blocking while more than max_pending jobs are pending
+static GF_Err cenc_dec_flush_jobs(GF_CENCDecCtx *ctx, u32 max_pending)
+{
+	GF_Err e = GF_OK;
+	while (gf_list_count(ctx->pending_jobs)) {
+		GF_CENCDecJob *job = gf_list_get(ctx->pending_jobs, 0);
+		if (job->posted) {
+			Bool wait = (gf_list_count(ctx->pending_jobs) > max_pending) ? GF_TRUE : GF_FALSE;
+			if (!gf_crypt_pool_job_done(ctx->pool, &job->job, wait))
+				break;
+		}
+		gf_list_rem(ctx->pending_jobs, 0);
+		if (job->posted && job->job.e) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_AUTHOR, ("[CENC] Error decrypting packet: %s\n", gf_error_to_string(job->job.e) ));
+			gf_filter_pck_discard(job->pck);
+			if (!e) e = job->job.e;
+		} else {
+			gf_filter_pck_send(job->pck);
+		}
+		job->pck = NULL;
+		job->posted = GF_FALSE;
+		gf_crypt_job_reset(&job->job);
+		gf_list_add(ctx->job_reservoir, job);
+	}
+	return e;
+}
+
+//sends a packet, or queues it after the pending jobs
+static GF_Err cenc_dec_send_packet(GF_CENCDecCtx *ctx, GF_FilterPacket *pck)
+{
+	GF_CENCDecJob *job;
+	if (!gf_list_count(ctx->pending_jobs)) {
+		gf_filter_pck_send(pck);
+		return GF_OK;
+	}
+	job = cenc_dec_get_job(ctx);
+	if (!job) {
+		gf_filter_pck_discard(pck);
+		return GF_OUT_OF_MEM;
+	}
+	job->pck = pck;
+	job->posted = GF_FALSE;
+	return gf_list_add(ctx->pending_jobs, job);
+}
+
 
 #ifdef OLD_KEY_FETCHERS
 static void cenc_dec_kms_netio(void *cbck, GF_NETIO_Parameter *par)
@@ -757,6 +837,8 @@ static GF_Err cenc_dec_process_cenc(GF_CENCDecCtx *ctx, GF_CENCDecStream *cstr,
 	Bool crypt_reinit = GF_FALSE;
 	GF_FilterPacket *out_pck;
 	const GF_PropertyValue *prop, *const_IV=NULL, *cbc_pattern=NULL;
+	GF_CryptJob *job;
+	u8 *job_IV;
 
 	if (!cstr->crypt)
 		return GF_SERVICE_ERROR;
@@ -768,8 +850,7 @@ static GF_Err cenc_dec_process_cenc(GF_CENCDecCtx *ctx, GF_CENCDecStream *cstr,
 		gf_filter_pck_merge_properties(in_pck, out_pck);
 		gf_filter_pck_set_property(out_pck, GF_PROP_PCK_CENC_SAI, NULL);
 		gf_filter_pck_set_crypt_flags(out_pck, 0);
-		gf_filter_pck_send(out_pck);
-		return GF_OK;
+		return cenc_dec_send_packet(ctx, out_pck);
 	}
 	prop = gf_filter_pid_get_property(cstr->ipid, GF_PROP_PID_KID);
 	if (!prop) {
@@ -862,6 +943,27 @@ static GF_Err cenc_dec_process_cenc(GF_CENCDecCtx *ctx, GF_CENCDecStream *cstr,
 		goto exit;
 	}
 
+	if (!ctx->cur_job) ctx->cur_job = cenc_dec_get_job(ctx);
+	if (!ctx->cur_job) {
+		e = GF_OUT_OF_MEM;
+		goto exit;
+	}
+	//every sample restores its IV, jobs never depend on the previous sample
+	job = &ctx->cur_job->job;
+	gf_crypt_job_reset(job);
+	job->mode = cstr->is_cenc ? GF_CTR : GF_CBC;
+	job->decrypt = GF_TRUE;
+	job->data = out_data;
+	memcpy(job->key, cstr->key, sizeof(bin128));
+	memset(job->IV, 0, sizeof(job->IV));
+	job_IV = cstr->is_cbc ? job->IV : job->IV+1;
+	if (const_IV) {
+		memcpy(job_IV, const_IV->value.data.ptr, MIN(const_IV->value.data.size, 16));
+	} else {
+		memcpy(job_IV, IV, 16);
+	}
+	job->IV_size = cstr->is_cbc ? 16 : 17;
+
 	if (crypt_reinit) {
 		if (const_IV) {
 			memcpy(IV, const_IV->value.data.ptr, const_IV->value.data.size);
@@ -912,12 +1014,6 @@ static GF_Err cenc_dec_process_cenc(GF_CENCDecCtx *ctx, GF_CENCDecStream *cstr,
 			bytes_encrypted_data = gf_bs_read_u32(ctx->bs_r);
 			subsample_count--;
 
-			if (const_IV) {
-				memmove(IV, const_IV->value.data.ptr, const_IV->value.data.size);
-				if (const_IV->value.data.size == 8)
-					memset(IV+8, 0, sizeof(char)*8);
-				gf_crypt_set_IV(cstr->crypt, IV, 16);
-			}
 			if (cur_pos + bytes_clear_data + bytes_encrypted_data > data_size) {
 				GF_LOG(GF_LOG_ERROR, GF_LOG_AUTHOR, ("[CENC] Corrupted CENC sai, subsample info describe more bytes (%d) than in packet (%d)\n", cur_pos + bytes_clear_data + bytes_encrypted_data , data_size ));
 				e = GF_NON_COMPLIANT_BITSTREAM;
@@ -928,51 +1024,58 @@ static GF_Err cenc_dec_process_cenc(GF_CENCDecCtx *ctx, GF_CENCDecStream *cstr,
 
 			//pattern decryption
 			if (cbc_pattern && cbc_pattern->value.frac.den && cbc_pattern->value.frac.num) {
-				u32 pos = cur_pos;
 				u32 res = bytes_encrypted_data;
-				u32 cryp_block = 16 * cbc_pattern->value.frac.den;
-				u32 full_block = 16 * (cbc_pattern->value.frac.den + cbc_pattern->value.frac.num);
 
 				if (cstr->is_cbc) {
 					u32 clear_trailing = res % 16;
 					res -= clear_trailing;
 				}
-
-				while (res) {
-					gf_crypt_decrypt(cstr->crypt, out_data + pos, (res >= cryp_block) ? cryp_block : res);
-					if (res >= full_block) {
-						pos += full_block;
-						assert(res>=full_block);
-						res -= full_block;
-					} else {
-						res = 0;
-					}
-				}
+				e = gf_crypt_job_add_range(job, cur_pos, res, cbc_pattern->value.frac.den, cbc_pattern->value.frac.num, const_IV ? GF_TRUE : GF_FALSE);
 			}
 			//full subsample decryption
 			else {
-				gf_crypt_decrypt(cstr->crypt, out_data+cur_pos, bytes_encrypted_data);
+				e = gf_crypt_job_add_range(job, cur_pos, bytes_encrypted_data, 0, 0, const_IV ? GF_TRUE : GF_FALSE);
 			}
+			if (e) goto exit;
 			cur_pos += bytes_encrypted_data;
 		}
 	}
 	//full sample encryption
 	else {
 		if (cstr->is_cenc) {
-			gf_crypt_decrypt(cstr->crypt, out_data, data_size);
+			e = gf_crypt_job_add_range(job, 0, data_size, 0, 0, GF_FALSE);
 		} else {
 			u32 ret = data_size % 16;
 			if (data_size >= 16) {
-				gf_crypt_decrypt(cstr->crypt, out_data, data_size-ret);
+				e = gf_crypt_job_add_range(job, 0, data_size-ret, 0, 0, GF_FALSE);
 			}
 		}
+		if (e) goto exit;
 	}
 
 	gf_filter_pck_merge_properties(in_pck, out_pck);
 	gf_filter_pck_set_property(out_pck, GF_PROP_PCK_CENC_SAI, NULL);
 	gf_filter_pck_set_crypt_flags(out_pck, 0);
 
-	gf_filter_pck_send(out_pck);
+	if (ctx->pool) {
+		ctx->cur_job->pck = out_pck;
+		ctx->cur_job->posted = GF_TRUE;
+		e = gf_crypt_pool_post(ctx->pool, job);
+		if (e) {
+			ctx->cur_job->pck = NULL;
+			ctx->cur_job->posted = GF_FALSE;
+			goto exit;
+		}
+		gf_list_add(ctx->pending_jobs, ctx->cur_job);
+		ctx->cur_job = NULL;
+		return GF_OK;
+	}
+
+	e = gf_crypt_job_run(cstr->crypt, job);
+	if (e) goto exit;
+	e = cenc_dec_send_packet(ctx, out_pck);
+	//packet is sent or discarded
+	out_pck = NULL;
 
 exit:
 	if (e && out_pck) {
@@ -1064,6 +1167,12 @@ static GF_Err cenc_dec_configure_pid(GF_Filter *filter, GF_FilterPid *pid, Bool
 	GF_CENCDecStream *cstr;
 	GF_CENCDecCtx *ctx = (GF_CENCDecCtx *)gf_filter_get_udta(filter);
 
+	//pending packets must be sent before any change on output PIDs
+	if (ctx->pool) {
+		e = cenc_dec_flush_jobs(ctx, 0);
+		if (e) return e;
+	}
+
 	prop = gf_filter_pid_get_property(pid, GF_PROP_PID_PROTECTION_SCHEME_TYPE);
 	if (prop) scheme_type = prop->value.uint;
 
@@ -1218,15 +1327,22 @@ static Bool cenc_dec_process_event(GF_Filter *filter, const GF_FilterEvent *evt)
 static GF_Err cenc_dec_process(GF_Filter *filter)
 {
 	GF_CENCDecCtx *ctx = (GF_CENCDecCtx *)gf_filter_get_udta(filter);
-	u32 i, nb_eos, count = gf_list_count(ctx->streams);
+	u32 i, nb_eos, nb_pck, count = gf_list_count(ctx->streams);
+
+	if (ctx->pool) {
+		GF_Err e = cenc_dec_flush_jobs(ctx, ctx->max_pending);
+		if (e) return e;
+	}
 
-	nb_eos = 0;
+	nb_eos = nb_pck = 0;
 	for (i=0; i<count; i++) {
 		GF_Err e;
 		GF_CENCDecStream *cstr = gf_list_get(ctx->streams, i);
 		GF_FilterPacket *pck = gf_filter_pid_get_packet(cstr->ipid);
 		if (!pck) {
 			if (gf_filter_pid_is_eos(cstr->ipid)) {
+				e = cenc_dec_flush_jobs(ctx, 0);
+				if (e) return e;
 				nb_eos++;
 				gf_filter_pid_set_eos(cstr->opid);
 			}
@@ -1243,9 +1359,15 @@ static GF_Err cenc_dec_process(GF_Filter *filter)
 			e = cenc_dec_process_isma(ctx, cstr, pck);
 		}
 		gf_filter_pid_drop_packet(cstr->ipid);
+		nb_pck++;
 		if (e) return e;
 	}
 	if (nb_eos && (nb_eos==count)) return GF_EOS;
+
+	if (ctx->pool) {
+		//no input, wait for all pending jobs, otherwise only for the oldest ones above the limit
+		return cenc_dec_flush_jobs(ctx, nb_pck ? ctx->max_pending : 0);
+	}
 	return GF_OK;
 }
 
@@ -1264,6 +1386,27 @@ static GF_Err cenc_dec_initialize(GF_Filter *filter)
 		}
 	}
 	ctx->bs_r = gf_bs_new((char *) ctx, 1, GF_BITSTREAM_READ);
+
+	if (ctx->threads) {
+		u32 nb_threads = 0;
+		if (ctx->threads>0) {
+			nb_threads = (u32) ctx->threads;
+		} else {
+			GF_SystemRTInfo rti;
+			if (gf_sys_get_rti(0, &rti, 0))
+				nb_threads = (rti.nb_cores>1) ? rti.nb_cores-1 : 1;
+		}
+		if (nb_threads)
+			ctx->pool = gf_crypt_pool_new(nb_threads);
+		if (!ctx->pool) {
+			GF_LOG(GF_LOG_WARNING, GF_LOG_AUTHOR, ("[CENCCrypt] Failed to create crypto workers, using single thread\n" ));
+		} else {
+			GF_LOG(GF_LOG_INFO, GF_LOG_AUTHOR, ("[CENCCrypt] Using %d crypto workers\n", nb_threads ));
+			ctx->max_pending = 4 * nb_threads;
+			ctx->pending_jobs = gf_list_new();
+			ctx->job_reservoir = gf_list_new();
+		}
+	}
 	return GF_OK;
 }
 
@@ -1271,6 +1414,20 @@ static void cenc_dec_finalize(GF_Filter *filter)
 {
 	GF_CENCDecCtx *ctx = (GF_CENCDecCtx *)gf_filter_get_udta(filter);
 
+	//waits for all workers to exit
+	if (ctx->pool) gf_crypt_pool_del(ctx->pool);
+	while (gf_list_count(ctx->pending_jobs)) {
+		GF_CENCDecJob *job = gf_list_pop_back(ctx->pending_jobs);
+		gf_filter_pck_discard(job->pck);
+		cenc_dec_del_job(job);
+	}
+	gf_list_del(ctx->pending_jobs);
+	while (gf_list_count(ctx->job_reservoir)) {
+		cenc_dec_del_job(gf_list_pop_back(ctx->job_reservoir));
+	}
+	gf_list_del(ctx->job_reservoir);
+	if (ctx->cur_job) cenc_dec_del_job(ctx->cur_job);
+
 	while (gf_list_count(ctx->streams)) {
 		GF_CENCDecStream *cstr = gf_list_pop_back(ctx->streams);
 		cenc_dec_stream_del(cstr);
@@ -1307,6 +1464,7 @@ static const GF_FilterCapability CENCDecCaps[] =
 static const GF_FilterArgs GF_CENCDecArgs[] =
 {
 	{ OFFS(cfile), "crypt file location - see filter help", GF_PROP_STRING, NULL, NULL, 0},
+	{ OFFS(threads), "number of threads used for CENC decryption, 0 disables multithreading and -1 uses number of cores minus one", GF_PROP_SINT, "0", NULL, GF_FS_ARG_HINT_EXPERT},
 	{0}
 };
 
@@ -1317,7 +1475,9 @@ GF_FilterRegister CENCDecRegister = {
 	"The syntax is available at https://wiki.gpac.io/Common-Encryption\n"
 	"The file can be set per PID using the property `DecryptInfo` (highest priority), `CryptInfo` (lower priority) "
 	"or set at the filter level using [-cfile]() (lowest priority).\n"
-	"When the file is set per PID, the first `CryptInfo` with the same ID is used, otherwise the first `CryptInfo` is used.")
+	"When the file is set per PID, the first `CryptInfo` with the same ID is used, otherwise the first `CryptInfo` is used.\n"
+	"\n"
+	"CENC samples can be decrypted by several threads using [-threads](), packets are still output in order.")
 	.private_size = sizeof(GF_CENCDecCtx),
 	.max_extra_pids=-1,
 	.args = GF_CENCDecArgs,
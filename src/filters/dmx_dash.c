@@ -29,6 +29,7 @@
 #ifndef GPAC_DISABLE_DASH_CLIENT
 
 #include <gpac/dash.h>
+#include <gpac/thread.h>
 
 #ifdef GPAC_HAS_QJS
 #include "../quickjs/quickjs.h"
@@ -39,7 +40,7 @@ typedef struct
 {
 	//opts
 	s32 shift_utc, debug_as, route_shift;
-	u32 max_buffer, auto_switch, tiles_rate, segstore, delay40X, exp_threshold, switch_count, bwcheck;
+	u32 max_buffer, auto_switch, tiles_rate, segstore, delay40X, exp_threshold, switch_count, bwcheck, prefetch;
 	s32 init_timeshift;
 	Bool server_utc, screen_res, aggressive, speedadapt, filemode, fmodefwd, skip_lqt, llhls_merge;
 	GF_DASHInitialSelectionMode start_with;
@@ -48,7 +49,7 @@ typedef struct
 	Bool max_res, immediate, abort, use_bmin;
 	char *query;
 	Bool noxlink, split_as, noseek;
-	u32 lowlat;
+	u32 lowlat, mupdate;
 
 	GF_FilterPid *mpd_pid;
 	GF_Filter *filter;
@@ -80,6 +81,11 @@ typedef struct
 
 	Bool is_dash;
 	Bool manifest_stop_sent;
+
+	//segment prefetch requests of all groups
+	GF_List *prefetches;
+	//protects the prefetch list and request states, updated by downloader callbacks
+	GF_Mutex *prefetch_mx;
 #ifdef GPAC_HAS_QJS
 	JSContext *js_ctx;
 	Bool owns_context;
@@ -128,8 +134,33 @@ typedef struct
 	u32 seg_discard_state;
 
 	char *template;
+	//prefetch request of the segment being played, if any
+	struct _dash_seg_prefetch *prefetch;
 } GF_DASHGroup;
 
+typedef enum
+{
+	DASH_PREFETCH_RUNNING = 0,
+	DASH_PREFETCH_DONE,
+	DASH_PREFETCH_FAILED,
+} DASHPrefetchState;
+
+typedef struct _dash_seg_prefetch
+{
+	GF_DASHGroup *group;
+	GF_DownloadSession *sess;
+	char *url;
+	u64 start_range, end_range;
+	DASHPrefetchState state;
+	//segment start time in seconds, requests are issued by increasing start time
+	Double deadline;
+	//download stats, used for rate adaptation once the segment is played
+	u64 us_start, us_end, size;
+	u32 bytes_per_sec;
+} DASHSegPrefetch;
+
+static void dashdmx_prefetch_reset(GF_DASHDmxCtx *ctx, GF_DASHGroup *group);
+
 
 
 void dashdmx_forward_packet(GF_DASHDmxCtx *ctx, GF_FilterPacket *in_pck, GF_FilterPid *in_pid, GF_FilterPid *out_pid, GF_DASHGroup *group)
@@ -805,6 +836,7 @@ GF_Err dashdmx_io_on_dash_event(GF_DASHFileIO *dashio, GF_DASHEventType dash_evt
 				group->seg_filter_src = NULL;
 			}
 			if (group->template) gf_free(group->template);
+			if (ctx->prefetches) dashdmx_prefetch_reset(ctx, group);
 			gf_free(group);
 			gf_dash_set_group_udta(ctx->dash, i, NULL);
 		}
@@ -1755,6 +1787,16 @@ static GF_Err dashdmx_initialize(GF_Filter *filter)
 	gf_dash_ignore_xlink(ctx->dash, ctx->noxlink);
 	gf_dash_set_period_xlink_query_string(ctx->dash, ctx->query);
 	gf_dash_set_low_latency_mode(ctx->dash, ctx->lowlat);
+	//manifests are forwarded in filemode, patches cannot be used
+	if (ctx->filemode && (ctx->mupdate==GF_DASH_MPD_UPDATE_PATCH))
+		gf_dash_set_manifest_update_mode(ctx->dash, GF_DASH_MPD_UPDATE_MERGE);
+	else
+		gf_dash_set_manifest_update_mode(ctx->dash, ctx->mupdate);
+	if (ctx->prefetch) {
+		gf_dash_set_prefetch(ctx->dash, ctx->prefetch);
+		ctx->prefetches = gf_list_new();
+		ctx->prefetch_mx = gf_mx_new("DASHPrefetch");
+	}
 	if (ctx->split_as)
 		gf_dash_split_adaptation_sets(ctx->dash);
 	gf_dash_disable_low_quality_tiles(ctx->dash, ctx->skip_lqt);
@@ -1799,8 +1841,21 @@ static void dashdmx_finalize(GF_Filter *filter)
 	GF_DASHDmxCtx *ctx = (GF_DASHDmxCtx*) gf_filter_get_udta(filter);
 	assert(ctx);
 
-	if (ctx->dash)
+	if (ctx->dash) {
+#ifndef GPAC_DISABLE_LOG
+		GF_DASHManifestStats stats;
+		if ((gf_dash_get_manifest_stats(ctx->dash, &stats)==GF_OK) && stats.nb_refresh) {
+			GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[DASHDmx] %d manifest refreshes (%d full, %d merged, %d patched) - parse time avg "LLU" us max "LLU" us\n", stats.nb_refresh, stats.nb_full, stats.nb_merge, stats.nb_patch, stats.total_parse_time / stats.nb_refresh, stats.max_parse_time));
+		}
+#endif
 		gf_dash_del(ctx->dash);
+	}
+
+	if (ctx->prefetches) {
+		dashdmx_prefetch_reset(ctx, NULL);
+		gf_list_del(ctx->prefetches);
+		gf_mx_del(ctx->prefetch_mx);
+	}
 
 	if (ctx->frag_url)
 		gf_free(ctx->frag_url);
@@ -2068,6 +2123,11 @@ static void dashdmx_update_group_stats(GF_DASHDmxCtx *ctx, GF_DASHGroup *group)
 	if (!group->seg_filter_src) return;
 
 	p = gf_filter_get_info(group->seg_filter_src, GF_PROP_PID_FILE_CACHED, &pe);
+	//prefetched segment, no download monitoring on the segment source
+	if ((!p || !p->value.boolean) && group->prefetch) {
+		gf_filter_release_property(pe);
+		return;
+	}
 	if (!p || !p->value.boolean) {
 		u64 us_since_start = 0;
 		u64 down_bytes = 0;
@@ -2113,7 +2173,15 @@ static void dashdmx_update_group_stats(GF_DASHDmxCtx *ctx, GF_DASHGroup *group)
 	else
 		dep_rep_idx = group->current_dependent_rep_idx;
 
-	gf_dash_group_store_stats(ctx->dash, group->idx, dep_rep_idx, bytes_per_sec, file_size, broadcast_flag, gf_sys_clock_high_res() - group->us_at_seg_start);
+	//prefetched segment, use stats of the prefetch request
+	if (ctx->prefetch_mx) gf_mx_p(ctx->prefetch_mx);
+	if (group->prefetch && (group->prefetch->state==DASH_PREFETCH_DONE)) {
+		DASHSegPrefetch *pf = group->prefetch;
+		gf_dash_group_store_stats(ctx->dash, group->idx, dep_rep_idx, pf->bytes_per_sec, pf->size, broadcast_flag, pf->us_end - pf->us_start);
+	} else {
+		gf_dash_group_store_stats(ctx->dash, group->idx, dep_rep_idx, bytes_per_sec, file_size, broadcast_flag, gf_sys_clock_high_res() - group->us_at_seg_start);
+	}
+	if (ctx->prefetch_mx) gf_mx_v(ctx->prefetch_mx);
 
 	p = gf_filter_get_info(group->seg_filter_src, GF_PROP_PID_FILE_CACHED, &pe);
 	if (p && p->value.boolean)
@@ -2123,6 +2191,217 @@ static void dashdmx_update_group_stats(GF_DASHDmxCtx *ctx, GF_DASHGroup *group)
 }
 
 
+//fetch priority of the next media segment of a group (HTTP/2 stream weight), higher when the group buffer is low - 0 means default
+static u32 dashdmx_group_priority(GF_DASHDmxCtx *ctx, GF_DASHGroup *group)
+{
+	u32 i, weight = 0;
+	for (i=0; i<gf_filter_get_opid_count(ctx->filter); i++) {
+		u32 max_units, nb_pck, max_dur, dur, w;
+		GF_FilterPid *opid = gf_filter_get_opid(ctx->filter, i);
+		if (gf_filter_pid_get_udta(opid) != group) continue;
+		if (!gf_filter_pid_get_buffer_occupancy(opid, &max_units, &nb_pck, &max_dur, &dur) || !max_dur) continue;
+		if (dur > max_dur) dur = max_dur;
+		w = 1 + (u32) ( ((u64) 255) * (max_dur - dur) / max_dur);
+		if (w > weight) weight = w;
+	}
+	return weight;
+}
+
+//must be called with prefetch_mx locked - a callback blocked on the mutex defers the session destruction
+static void dashdmx_prefetch_del(GF_DASHDmxCtx *ctx, DASHSegPrefetch *pf)
+{
+	if (pf->group && (pf->group->prefetch == pf))
+		pf->group->prefetch = NULL;
+	if (pf->sess) {
+		//flag the cache entry for removal, effective once no session uses it anymore
+		gf_dm_delete_cached_file_entry_session(pf->sess, pf->url);
+		gf_dm_sess_del(pf->sess);
+	}
+	gf_list_del_item(ctx->prefetches, pf);
+	gf_free(pf->url);
+	gf_free(pf);
+}
+
+//remove all prefetch requests of a group, or of all groups if NULL
+static void dashdmx_prefetch_reset(GF_DASHDmxCtx *ctx, GF_DASHGroup *group)
+{
+	u32 i;
+	gf_mx_p(ctx->prefetch_mx);
+	for (i=0; i<gf_list_count(ctx->prefetches); i++) {
+		DASHSegPrefetch *pf = gf_list_get(ctx->prefetches, i);
+		if (group && (pf->group != group)) continue;
+		dashdmx_prefetch_del(ctx, pf);
+		i--;
+	}
+	gf_mx_v(ctx->prefetch_mx);
+}
+
+static DASHSegPrefetch *dashdmx_prefetch_find(GF_DASHDmxCtx *ctx, GF_DASHGroup *group, const char *url, u64 start_range, u64 end_range)
+{
+	u32 i, count = gf_list_count(ctx->prefetches);
+	for (i=0; i<count; i++) {
+		DASHSegPrefetch *pf = gf_list_get(ctx->prefetches, i);
+		if (pf->group != group) continue;
+		if ((pf->start_range != start_range) || (pf->end_range != end_range)) continue;
+		if (!strcmp(pf->url, url)) return pf;
+	}
+	return NULL;
+}
+
+//prefetch downloads run as downloader tasks, the demuxer is only woken up once a request is done
+//the request is looked up by session since it may have been canceled while the callback was pending
+static void dashdmx_prefetch_io(void *usr_cbk, GF_NETIO_Parameter *param)
+{
+	u32 i, count;
+	DASHSegPrefetch *pf = NULL;
+	GF_DASHDmxCtx *ctx = usr_cbk;
+
+	if ((param->msg_type!=GF_NETIO_STATE_ERROR) && (param->error>=0) && (param->msg_type!=GF_NETIO_DATA_TRANSFERED))
+		return;
+
+	gf_mx_p(ctx->prefetch_mx);
+	count = gf_list_count(ctx->prefetches);
+	for (i=0; i<count; i++) {
+		pf = gf_list_get(ctx->prefetches, i);
+		if (pf->sess == param->sess) break;
+		pf = NULL;
+	}
+	if (!pf || (pf->state != DASH_PREFETCH_RUNNING)) {
+		gf_mx_v(ctx->prefetch_mx);
+		return;
+	}
+
+	if ((param->msg_type==GF_NETIO_STATE_ERROR) || (param->error<0)) {
+		GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[DASHDmx] group %d failed to prefetch %s: %s\n", pf->group->idx, pf->url, gf_error_to_string(param->error) ));
+		pf->state = DASH_PREFETCH_FAILED;
+	} else if (param->msg_type==GF_NETIO_DATA_TRANSFERED) {
+		u64 bytes_done = 0;
+		pf->us_end = gf_sys_clock_high_res();
+		gf_dm_sess_get_stats(pf->sess, NULL, NULL, &pf->size, &bytes_done, &pf->bytes_per_sec, NULL);
+		if (!pf->size) pf->size = bytes_done;
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[DASHDmx] group %d prefetched %s: "LLU" bytes in "LLU" us (%d kbps)\n", pf->group->idx, pf->url, pf->size, pf->us_end - pf->us_start, 8*pf->bytes_per_sec/1000));
+		pf->state = DASH_PREFETCH_DONE;
+	}
+	gf_mx_v(ctx->prefetch_mx);
+	gf_filter_post_process_task(ctx->filter);
+}
+
+//fetch media segments queued after the one being played, in playout order across groups
+static void dashdmx_prefetch_process(GF_DASHDmxCtx *ctx)
+{
+	u32 i, j, count, nb_groups;
+	GF_List *to_start = NULL;
+
+	gf_mx_p(ctx->prefetch_mx);
+	//cancel requests for segments no longer queued (played, seek or quality switch)
+	for (i=0; i<gf_list_count(ctx->prefetches); i++) {
+		Bool found = GF_FALSE;
+		DASHSegPrefetch *pf = gf_list_get(ctx->prefetches, i);
+		for (j=0; ; j++) {
+			const char *url;
+			u64 start_range, end_range;
+			GF_Err e = gf_dash_group_get_prefetch_segment(ctx->dash, pf->group->idx, j, &url, &start_range, &end_range, NULL);
+			if (!url) break;
+			if (e) continue;
+			if ((pf->start_range == start_range) && (pf->end_range == end_range) && !strcmp(pf->url, url)) {
+				found = GF_TRUE;
+				break;
+			}
+		}
+		if (found) continue;
+		if (pf->state==DASH_PREFETCH_RUNNING) {
+			GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[DASHDmx] group %d canceling prefetch of %s\n", pf->group->idx, pf->url));
+		}
+		dashdmx_prefetch_del(ctx, pf);
+		i--;
+	}
+
+	//gather segments to prefetch, sorted by start time
+	nb_groups = gf_dash_get_group_count(ctx->dash);
+	for (i=0; i<nb_groups; i++) {
+		u32 nb_running = 0;
+		GF_DASHGroup *group = gf_dash_get_group_udta(ctx->dash, i);
+		if (!group || !group->is_playing || !group->seg_filter_src) continue;
+
+		count = gf_list_count(ctx->prefetches);
+		for (j=0; j<count; j++) {
+			DASHSegPrefetch *pf = gf_list_get(ctx->prefetches, j);
+			if ((pf->group == group) && (pf->state==DASH_PREFETCH_RUNNING))
+				nb_running++;
+		}
+		//first segment in queue is fetched by the segment source
+		for (j=1; nb_running < ctx->prefetch; j++) {
+			const char *url;
+			u64 start_range, end_range;
+			GF_Fraction64 seg_time;
+			DASHSegPrefetch *pf;
+			u32 k;
+			GF_Err e = gf_dash_group_get_prefetch_segment(ctx->dash, group->idx, j, &url, &start_range, &end_range, &seg_time);
+			if (!url) break;
+			if (e) continue;
+			if (strnicmp(url, "http://", 7) && strnicmp(url, "https://", 8)) continue;
+			if (dashdmx_prefetch_find(ctx, group, url, start_range, end_range)) continue;
+
+			GF_SAFEALLOC(pf, DASHSegPrefetch);
+			if (!pf) break;
+			pf->group = group;
+			pf->url = gf_strdup(url);
+			pf->start_range = start_range;
+			pf->end_range = end_range;
+			pf->deadline = seg_time.den ? ((Double) seg_time.num) / seg_time.den : 0;
+
+			if (!to_start) to_start = gf_list_new();
+			for (k=0; k<gf_list_count(to_start); k++) {
+				DASHSegPrefetch *apf = gf_list_get(to_start, k);
+				if (apf->deadline > pf->deadline) break;
+			}
+			gf_list_insert(to_start, pf, k);
+			nb_running++;
+		}
+	}
+
+	//issue new requests by deadline
+	while (gf_list_count(to_start)) {
+		GF_Err e;
+		//not persistent: completed requests waiting to be played must not hold a connection to the server
+		u32 flags = 0;
+		DASHSegPrefetch *pf = gf_list_pop_front(to_start);
+
+		if (!ctx->segstore) flags |= GF_NETIO_SESSION_MEMORY_CACHE;
+		else if (ctx->segstore==2) flags |= GF_NETIO_SESSION_KEEP_CACHE;
+
+		pf->us_start = gf_sys_clock_high_res();
+		pf->sess = gf_dm_sess_new(ctx->dm, pf->url, flags, dashdmx_prefetch_io, ctx, &e);
+		if (pf->sess && (pf->start_range || pf->end_range))
+			e = gf_dm_sess_set_range(pf->sess, pf->start_range, pf->end_range, GF_TRUE);
+		if (pf->sess && !e) {
+			gf_dm_sess_set_priority(pf->sess, dashdmx_group_priority(ctx, pf->group));
+			e = gf_dm_sess_process(pf->sess);
+		}
+		if (!pf->sess || e) {
+			GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[DASHDmx] group %d failed to setup prefetch of %s: %s\n", pf->group->idx, pf->url, gf_error_to_string(e) ));
+			if (pf->sess) gf_dm_sess_del(pf->sess);
+			pf->sess = NULL;
+			pf->state = DASH_PREFETCH_FAILED;
+		} else {
+			GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[DASHDmx] group %d prefetching %s\n", pf->group->idx, pf->url));
+		}
+		gf_list_add(ctx->prefetches, pf);
+	}
+	gf_list_del(to_start);
+
+	//drop sessions of failed requests so that the segment source does not reuse the failed cache entry, but keep the request to avoid fetching it again
+	count = gf_list_count(ctx->prefetches);
+	for (i=0; i<count; i++) {
+		DASHSegPrefetch *pf = gf_list_get(ctx->prefetches, i);
+		if ((pf->state != DASH_PREFETCH_FAILED) || !pf->sess) continue;
+		gf_dm_delete_cached_file_entry_session(pf->sess, pf->url);
+		gf_dm_sess_del(pf->sess);
+		pf->sess = NULL;
+	}
+	gf_mx_v(ctx->prefetch_mx);
+}
+
 static void dashdmx_switch_segment(GF_DASHDmxCtx *ctx, GF_DASHGroup *group)
 {
 	u32 dependent_representation_index;
@@ -2256,6 +2535,8 @@ fetch_next:
 		evt.seek.source_switch = next_url_init_or_switch_segment;
 		evt.seek.is_init_segment = GF_TRUE;
 		evt.seek.skip_cache_expiration = GF_TRUE;
+		//init segment is needed before anything else in the group
+		evt.seek.priority = 256;
 
 		group->prev_is_init_segment = GF_TRUE;
 
@@ -2292,6 +2573,21 @@ fetch_next:
 	evt.seek.start_offset = start_range;
 	evt.seek.end_offset = end_range;
 	evt.seek.is_init_segment = GF_FALSE;
+	evt.seek.priority = dashdmx_group_priority(ctx, group);
+
+	//segment is (being) prefetched, source will use the download cache
+	group->prefetch = NULL;
+	if (ctx->prefetches) {
+		gf_mx_p(ctx->prefetch_mx);
+		group->prefetch = dashdmx_prefetch_find(ctx, group, next_url, start_range, end_range);
+		if (group->prefetch && group->prefetch->sess) {
+			GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[DASHDmx] group %d segment %s was prefetched\n", group->idx, next_url));
+			evt.seek.skip_cache_expiration = GF_TRUE;
+		} else {
+			group->prefetch = NULL;
+		}
+		gf_mx_v(ctx->prefetch_mx);
+	}
 	gf_filter_send_event(group->seg_filter_src, &evt, GF_FALSE);
 }
 
@@ -2531,6 +2827,10 @@ GF_Err dashdmx_process(GF_Filter *filter)
 		}
 	}
 
+	//issue or cancel prefetch requests, completed requests wake up the filter
+	if (ctx->prefetches && !gf_dash_is_in_setup(ctx->dash))
+		dashdmx_prefetch_process(ctx);
+
 	if (gf_dash_is_in_setup(ctx->dash))
 		gf_filter_post_process_task(filter);
 	else if (ctx->abort)
@@ -2632,10 +2932,15 @@ static const GF_FilterArgs DASHDmxArgs[] =
 		"- no: disable low latency\n"
 		"- strict: strict respect of AST offset in low latency\n"
 		"- early: allow fetching segments earlier than their AST in low latency when input demux is empty", GF_PROP_UINT, "early", "no|strict|early", GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(mupdate), "manifest update mode for live sessions\n"
+		"- full: reload the complete manifest at each update\n"
+		"- merge: merge SegmentTimeline changes in the active manifest when the rest of the manifest is unchanged\n"
+		"- patch: same as `merge` but use MPD patches when advertized by the manifest (`merge` is used in [-filemode]())", GF_PROP_UINT, "patch", "full|merge|patch", GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(filemode), "do not demux files and forward them as file pids (imply `segstore=mem`)", GF_PROP_BOOL, "no", NULL, GF_FS_ARG_HINT_ADVANCED},
 	{ OFFS(fmodefwd), "forward packet rather than copy them in [-filemode](). Packet copy might improve performances in low latency mode", GF_PROP_BOOL, "yes", NULL, GF_FS_ARG_HINT_EXPERT},
 
 	{ OFFS(skip_lqt), "disable decoding of tiles with highest degradation hints (not visible, not gazed at) for debug purposes", GF_PROP_BOOL, "no", NULL, GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(prefetch), "number of media segments to fetch in parallel ahead of the segment being played in each adaptation set, 0 disables prefetch. Prefetched segments are canceled upon quality switch", GF_PROP_UINT, "0", NULL, GF_FS_ARG_HINT_ADVANCED},
 	{ OFFS(llhls_merge), "merge LL-HLS byte range parts into a single open byte range request", GF_PROP_BOOL, "yes", NULL, GF_FS_ARG_HINT_EXPERT},
 	{0}
 };
@@ -85,6 +85,10 @@ typedef struct
 
 	u32 mux_tune_state;
 	u32 wait_for_progs;
+
+	//PES packets produced while processing an input packet, sent as a single batch
+	GF_FilterPacket **pck_batch;
+	u32 nb_pck_batch, alloc_pck_batch;
 } GF_M2TSDmxCtx;
 
 
@@ -94,7 +98,14 @@ static void m2tsdmx_estimate_duration(GF_M2TSDmxCtx *ctx, GF_M2TS_ES *stream)
 	Double pck_dur;
 	const GF_PropertyValue *p;
 
-	if (ctx->duration.num) return;
+	if (ctx->duration.num) {
+		//PCRs of programs not being played are no longer needed once duration is known
+		if (!ctx->ts->skip_inactive_pcr) {
+			ctx->ts->skip_inactive_pcr = GF_TRUE;
+			ctx->ts->pid_filter_dirty = GF_TRUE;
+		}
+		return;
+	}
 	if (!ctx->file_size) {
 		p = gf_filter_pid_get_property(ctx->ipid, GF_PROP_PID_DOWN_SIZE);
 		if (p) {
@@ -426,6 +437,32 @@ static void m2tdmx_merge_temi(GF_M2TS_ES *stream, GF_FilterPacket *pck)
 	}
 }
 
+static void m2tsdmx_flush_batch(GF_M2TSDmxCtx *ctx)
+{
+	GF_Err e;
+	if (!ctx->nb_pck_batch) return;
+	e = gf_filter_pck_send_batch(ctx->pck_batch, ctx->nb_pck_batch);
+	if (e) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_CONTAINER, ("[M2TSDmx] Failed to send batch of %d packets: %s\n", ctx->nb_pck_batch, gf_error_to_string(e) ));
+	}
+	ctx->nb_pck_batch = 0;
+}
+
+static void m2tsdmx_batch_packet(GF_M2TSDmxCtx *ctx, GF_FilterPacket *pck)
+{
+	if (ctx->nb_pck_batch == ctx->alloc_pck_batch) {
+		GF_FilterPacket **batch = gf_realloc(ctx->pck_batch, sizeof(GF_FilterPacket *) * (ctx->alloc_pck_batch + 10));
+		if (!batch) {
+			gf_filter_pck_send(pck);
+			return;
+		}
+		ctx->pck_batch = batch;
+		ctx->alloc_pck_batch += 10;
+	}
+	ctx->pck_batch[ctx->nb_pck_batch] = pck;
+	ctx->nb_pck_batch++;
+}
+
 static void m2tsdmx_send_packet(GF_M2TSDmxCtx *ctx, GF_M2TS_PES_PCK *pck)
 {
 	GF_FilterPid *opid;
@@ -450,7 +487,7 @@ static void m2tsdmx_send_packet(GF_M2TSDmxCtx *ctx, GF_M2TS_PES_PCK *pck)
 		gf_filter_pck_set_sap(dst_pck, (pck->flags & GF_M2TS_PES_PCK_RAP) ? GF_FILTER_SAP_1 : GF_FILTER_SAP_NONE);
 	}
 	m2tdmx_merge_temi((GF_M2TS_ES *)pck->stream, dst_pck);
-	gf_filter_pck_send(dst_pck);
+	m2tsdmx_batch_packet(ctx, dst_pck);
 }
 
 static GF_M2TS_ES *m2tsdmx_get_m4sys_stream(GF_M2TSDmxCtx *ctx, u32 m4sys_es_id)
@@ -580,6 +617,10 @@ static void m2tsdmx_on_event(GF_M2TS_Demuxer *ts, u32 evt_type, void *param)
 	GF_Filter *filter = (GF_Filter *) ts->user;
 	GF_M2TSDmxCtx *ctx = gf_filter_get_udta(filter);
 
+	//any other event may modify the output pids or send packets, dispatch pending PES packets first
+	if (evt_type != GF_M2TS_EVT_PES_PCK)
+		m2tsdmx_flush_batch(ctx);
+
 	switch (evt_type) {
 	case GF_M2TS_EVT_PAT_UPDATE:
 		break;
@@ -1051,6 +1092,11 @@ static void m2tsdmx_finalize(GF_Filter *filter)
 {
 	GF_M2TSDmxCtx *ctx = gf_filter_get_udta(filter);
 	if (ctx->ts) gf_m2ts_demux_del(ctx->ts);
+	while (ctx->nb_pck_batch) {
+		ctx->nb_pck_batch--;
+		gf_filter_pck_discard(ctx->pck_batch[ctx->nb_pck_batch]);
+	}
+	if (ctx->pck_batch) gf_free(ctx->pck_batch);
 
 }
 
@@ -1066,6 +1112,7 @@ static GF_Err m2tsdmx_process(GF_Filter *filter)
 			u32 i, nb_streams = gf_filter_get_opid_count(filter);
 
 			gf_m2ts_flush_all(ctx->ts);
+			m2tsdmx_flush_batch(ctx);
 			for (i=0; i<nb_streams; i++) {
 				GF_FilterPid *opid = gf_filter_get_opid(filter, i);
 				gf_filter_pid_set_eos(opid);
@@ -1095,6 +1142,7 @@ static GF_Err m2tsdmx_process(GF_Filter *filter)
 	data = gf_filter_pck_get_data(pck, &size);
 	if (data && size)
 		gf_m2ts_process_data(ctx->ts, (char*) data, size);
+	m2tsdmx_flush_batch(ctx);
 
 	gf_filter_pid_drop_packet(ctx->ipid);
 
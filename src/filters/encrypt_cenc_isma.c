@@ -106,20 +106,100 @@ typedef struct
 	Bool slice_header_clear;
 } GF_CENCStream;
 
+typedef struct
+{
+	//first for casting
+	GF_CryptJob job;
+	//output packet, sent once the job is done
+	GF_FilterPacket *pck;
+	//set if the job was posted to the crypto pool, otherwise packet can be sent right away
+	Bool posted;
+} GF_CENCEncJob;
+
 typedef struct
 {
 	//options
 	const char *cfile;
 	Bool allc;
+	s32 threads;
 	
 	//internal
 	GF_CryptInfo *cinfo;
 
 	GF_List *streams;
 	GF_BitStream *bs_w, *bs_r;
+
+	//crypto pool, NULL if no threading
+	GF_CryptPool *pool;
+	u32 max_pending;
+	//jobs in output order
+	GF_List *pending_jobs;
+	GF_List *job_reservoir;
+	//job being built
+	GF_CENCEncJob *cur_job;
 } GF_CENCEncCtx;
 
 
+static GF_CENCEncJob *cenc_enc_get_job(GF_CENCEncCtx *ctx)
+{
+	GF_CENCEncJob *job = gf_list_pop_back(ctx->job_reservoir);
+	if (!job) {
+		GF_SAFEALLOC(job, GF_CENCEncJob);
+	}
+	return job;
+}
+
+static void cenc_enc_del_job(GF_CENCEncJob *job)
+{
+	if (job->job.ranges) gf_free(job->job.ranges);
+	gf_free(job);
+}
+
+//sends packets of completed jobs in order, blocking while more than max_pending jobs are pending
+static GF_Err cenc_enc_flush_jobs(GF_CENCEncCtx *ctx, u32 max_pending)
+{
+	GF_Err e = GF_OK;
+	while (gf_list_count(ctx->pending_jobs)) {
+		GF_CENCEncJob *job = gf_list_get(ctx->pending_jobs, 0);
+		if (job->posted) {
+			Bool wait = (gf_list_count(ctx->pending_jobs) > max_pending) ? GF_TRUE : GF_FALSE;
+			if (!gf_crypt_pool_job_done(ctx->pool, &job->job, wait))
+				break;
+		}
+		gf_list_rem(ctx->pending_jobs, 0);
+		if (job->posted && job->job.e) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_AUTHOR, ("[CENC] Error encrypting packet: %s\n", gf_error_to_string(job->job.e) ));
+			gf_filter_pck_discard(job->pck);
+			if (!e) e = job->job.e;
+		} else {
+			gf_filter_pck_send(job->pck);
+		}
+		job->pck = NULL;
+		job->posted = GF_FALSE;
+		gf_crypt_job_reset(&job->job);
+		gf_list_add(ctx->job_reservoir, job);
+	}
+	return e;
+}
+
+//sends a packet, or queues it after the pending jobs
+static GF_Err cenc_enc_send_packet(GF_CENCEncCtx *ctx, GF_FilterPacket *pck)
+{
+	GF_CENCEncJob *job;
+	if (!gf_list_count(ctx->pending_jobs)) {
+		gf_filter_pck_send(pck);
+		return GF_OK;
+	}
+	job = cenc_enc_get_job(ctx);
+	if (!job) {
+		gf_filter_pck_discard(pck);
+		return GF_OUT_OF_MEM;
+	}
+	job->pck = pck;
+	job->posted = GF_FALSE;
+	return gf_list_add(ctx->pending_jobs, job);
+}
+
 static GF_Err isma_enc_configure(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, Bool is_isma, const char *scheme_uri, const char *kms_uri)
 {
 	GF_Err e;
@@ -763,6 +843,11 @@ static GF_Err cenc_enc_configure_pid(GF_Filter *filter, GF_FilterPid *pid, Bool
 	GF_TrackCryptInfo *tci_any = NULL;
 	u32 i, count;
 
+	//pending packets must be sent before any change on output PIDs
+	if (ctx->pool) {
+		e = cenc_enc_flush_jobs(ctx, 0);
+		if (e) return e;
+	}
 
 	if (is_remove) {
 		cstr = gf_filter_pid_get_udta(pid);
@@ -1176,6 +1261,39 @@ static void cenc_resync_IV(GF_Crypt *mc, char IV[16], u8 IV_size)
 	memcpy(IV, next_IV+1, 16*sizeof(char));
 }
 
+//moves the counter by the number of bytes encrypted by the job, as if the job was run on the stream context
+static void cenc_advance_IV(GF_CENCStream *cstr, GF_CryptJob *job)
+{
+	char next_IV[17];
+	u64 nb_bytes = 0;
+	u64 nb_blocks;
+	u32 i;
+	s32 j;
+
+	for (i=0; i<job->nb_ranges; i++) {
+		GF_CryptRange *r = &job->ranges[i];
+		if (r->crypt_blocks && r->skip_blocks) {
+			u32 cryp_block = 16 * r->crypt_blocks;
+			u32 full_block = 16 * (r->crypt_blocks + r->skip_blocks);
+			u32 rem = r->size % full_block;
+			nb_bytes += (u64) (r->size / full_block) * cryp_block;
+			nb_bytes += MIN(rem, cryp_block);
+		} else {
+			nb_bytes += r->size;
+		}
+	}
+	nb_blocks = (nb_bytes + 15) / 16;
+	next_IV[0] = (nb_bytes % 16) ? 1 : 0;
+	memcpy(next_IV+1, cstr->IV, 16);
+	for (j=16; (j>0) && nb_blocks; j--) {
+		u32 v = (u8) next_IV[j] + (u32) (nb_blocks & 0xFF);
+		next_IV[j] = (char) (v & 0xFF);
+		nb_blocks = (nb_blocks >> 8) + (v >> 8);
+	}
+	gf_crypt_set_IV(cstr->crypt, next_IV, 17);
+	cenc_resync_IV(cstr->crypt, cstr->IV, cstr->tci->IV_size);
+}
+
 #ifndef GPAC_DISABLE_AV_PARSERS
 //parses slice header and returns its size
 static u32 cenc_get_clear_bytes(GF_CENCStream *cstr, GF_BitStream *plaintext_bs, char *samp_data, u32 nal_size, u32 bytes_in_nalhr)
@@ -1234,6 +1352,8 @@ static GF_Err cenc_encrypt_packet(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_Fi
 	u8 *output;
 	u32 sai_size = cstr->tci->IV_size;
 	u32 nb_subsamples=0;
+	GF_CryptJob *job;
+	Bool reset_IV;
 
 	//in cbcs scheme, if Per_Sample_IV_size is not 0 (no constant IV), fetch current IV
 	if (!cstr->ctr_mode && cstr->tci->IV_size) {
@@ -1241,6 +1361,26 @@ static GF_Err cenc_encrypt_packet(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_Fi
 		gf_crypt_get_IV(cstr->crypt, cstr->IV, &IV_size);
 	}
 
+	if (!ctx->cur_job) ctx->cur_job = cenc_enc_get_job(ctx);
+	if (!ctx->cur_job) return GF_OUT_OF_MEM;
+	job = &ctx->cur_job->job;
+	gf_crypt_job_reset(job);
+	job->mode = cstr->ctr_mode ? GF_CTR : GF_CBC;
+	job->decrypt = GF_FALSE;
+	memcpy(job->key, cstr->key, sizeof(bin128));
+
+	//the job carries the sample IV unless CBC chaining with previous sample is used (cbc1 and cbcs with per-sample IV)
+	if (cstr->ctr_mode) {
+		job->IV[0] = 0;
+		memcpy(job->IV+1, cstr->IV, 16);
+		job->IV_size = 17;
+	} else if (!cstr->tci->IV_size) {
+		memcpy(job->IV, cstr->IV, 16);
+		job->IV_size = 16;
+	}
+	//cbcs scheme with constant IV, reinit at each sub sample
+	reset_IV = (!cstr->ctr_mode && !cstr->tci->IV_size) ? GF_TRUE : GF_FALSE;
+
 
 	data = gf_filter_pck_get_data(pck, &pck_size);
 
@@ -1254,6 +1394,7 @@ static GF_Err cenc_encrypt_packet(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_Fi
 
 	gf_filter_pck_merge_properties(pck, dst_pck);
 	gf_filter_pck_set_crypt_flags(dst_pck, GF_FILTER_PCK_CRYPT);
+	job->data = output;
 
 	if (!ctx->bs_r) ctx->bs_r = gf_bs_new(data, pck_size, GF_BITSTREAM_READ);
 	else gf_bs_reassign_buffer(ctx->bs_r, data, pck_size);
@@ -1474,29 +1615,15 @@ static GF_Err cenc_encrypt_packet(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_Fi
 					/*skip bytes of encrypted data*/
 					gf_bs_skip_bytes(ctx->bs_r, nalu_size - clear_bytes);
 
-					//cbcs scheme with constant IV, reinit at each sub sample,
-					if (!cstr->ctr_mode && !cstr->tci->IV_size)
-						gf_crypt_set_IV(cstr->crypt, cstr->IV, 16);
-
 					//pattern encryption
 					if (cstr->tci->crypt_byte_block && cstr->tci->skip_byte_block) {
 						u32 res = nalu_size - clear_bytes - clear_bytes_at_end;
-						pos = cur_pos;
 						assert((res % 16) == 0);
-
-						while (res) {
-							e = gf_crypt_encrypt(cstr->crypt, output+pos, res >= (u32) (16*cstr->tci->crypt_byte_block) ? 16*cstr->tci->crypt_byte_block : res);
-							if (res >= (u32) (16 * (cstr->tci->crypt_byte_block + cstr->tci->skip_byte_block))) {
-								pos += 16 * (cstr->tci->crypt_byte_block + cstr->tci->skip_byte_block);
-								res -= 16 * (cstr->tci->crypt_byte_block + cstr->tci->skip_byte_block);
-							} else {
-								res = 0;
-							}
-						}
+						e = gf_crypt_job_add_range(job, cur_pos, res, cstr->tci->crypt_byte_block, cstr->tci->skip_byte_block, reset_IV);
 					}
 					//full subsample encryption
 					else {
-						e = gf_crypt_encrypt(cstr->crypt, output+cur_pos, nalu_size - clear_bytes);
+						e = gf_crypt_job_add_range(job, cur_pos, nalu_size - clear_bytes, 0, 0, reset_IV);
 					}
 				}
 
@@ -1559,18 +1686,14 @@ static GF_Err cenc_encrypt_packet(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_Fi
 			}
 		} else if (cstr->ctr_mode) {
 			gf_bs_skip_bytes(ctx->bs_r, pck_size);
-			e = gf_crypt_encrypt(cstr->crypt, output, pck_size);
+			e = gf_crypt_job_add_range(job, 0, pck_size, 0, 0, GF_FALSE);
 		} else {
 			u32 clear_trailing;
 
 			clear_trailing = pck_size % 16;
 
-			//cbcs scheme with constant IV, reinit at each sample,
-			if (!cstr->tci->IV_size)
-				gf_crypt_set_IV(cstr->crypt, cstr->IV, 16);
-
 			if (pck_size >= 16) {
-				gf_crypt_encrypt(cstr->crypt, output, pck_size - clear_trailing);
+				e = gf_crypt_job_add_range(job, 0, pck_size - clear_trailing, 0, 0, reset_IV);
 			}
 			gf_bs_skip_bytes(ctx->bs_r, pck_size);
 		}
@@ -1588,8 +1711,21 @@ static GF_Err cenc_encrypt_packet(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_Fi
 		gf_bs_write_u32(sai_bs, prev_entry_bytes_crypt);
 		sai_size+=6;
 	}
-	if (cstr->ctr_mode)
-		cenc_resync_IV(cstr->crypt, cstr->IV, cstr->tci->IV_size);
+
+	//job does not depend on the state of the previous sample, process it in the pool
+	if (ctx->pool && job->IV_size) {
+		if (cstr->ctr_mode)
+			cenc_advance_IV(cstr, job);
+	} else {
+		GF_Err e = gf_crypt_job_run(cstr->crypt, job);
+		if (e) {
+			gf_bs_del(sai_bs);
+			gf_filter_pck_discard(dst_pck);
+			return e;
+		}
+		if (cstr->ctr_mode)
+			cenc_resync_IV(cstr->crypt, cstr->IV, cstr->tci->IV_size);
+	}
 
 	if (sai_size) {
 		u8 *sai=NULL;
@@ -1604,8 +1740,22 @@ static GF_Err cenc_encrypt_packet(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_Fi
 	}
 	gf_bs_del(sai_bs);
 
-	gf_filter_pck_send(dst_pck);
-	return GF_OK;
+	if (ctx->pool && job->IV_size) {
+		GF_Err e;
+		ctx->cur_job->pck = dst_pck;
+		ctx->cur_job->posted = GF_TRUE;
+		e = gf_crypt_pool_post(ctx->pool, job);
+		if (e) {
+			gf_filter_pck_discard(dst_pck);
+			ctx->cur_job->pck = NULL;
+			ctx->cur_job->posted = GF_FALSE;
+			return e;
+		}
+		gf_list_add(ctx->pending_jobs, ctx->cur_job);
+		ctx->cur_job = NULL;
+		return GF_OK;
+	}
+	return cenc_enc_send_packet(ctx, dst_pck);
 }
 
 static GF_Err cenc_process(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_FilterPacket *pck)
@@ -1696,8 +1846,7 @@ static GF_Err cenc_process(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_FilterPac
 			gf_filter_pck_set_property(dst_pck, GF_PROP_PCK_CENC_SAI, &PROP_DATA_NO_COPY(sai, sai_size) );
 
 		gf_filter_pck_set_crypt_flags(dst_pck, signal_sai ? GF_FILTER_PCK_CRYPT : 0);
-		gf_filter_pck_send(dst_pck);
-		return GF_OK;
+		return cenc_enc_send_packet(ctx, dst_pck);
 	}
 
 	/*generate initialization vector for the first sample in track ... */
@@ -1747,6 +1896,9 @@ static GF_Err cenc_process(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_FilterPac
 	}
 
 	if (key_changed) {
+		//packets encrypted with the previous key must be sent before signaling the new KID
+		e = cenc_enc_flush_jobs(ctx, 0);
+		if (e) return e;
 		gf_filter_pid_set_property(cstr->opid, GF_PROP_PID_KID, &PROP_DATA( cstr->tci->KIDs[cstr->kidx], sizeof(bin128) ) );
 		//TODO add support for multiple patterns and keys ?
 		//TODO add support for multiple IV size in key roll ?
@@ -1765,15 +1917,22 @@ static GF_Err cenc_process(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_FilterPac
 static GF_Err cenc_enc_process(GF_Filter *filter)
 {
 	GF_CENCEncCtx *ctx = (GF_CENCEncCtx *)gf_filter_get_udta(filter);
-	u32 i, nb_eos, count = gf_list_count(ctx->streams);
+	u32 i, nb_eos, nb_pck, count = gf_list_count(ctx->streams);
+
+	if (ctx->pool) {
+		GF_Err e = cenc_enc_flush_jobs(ctx, ctx->max_pending);
+		if (e) return e;
+	}
 
-	nb_eos = 0;
+	nb_eos = nb_pck = 0;
 	for (i=0; i<count; i++) {
 		GF_Err e = GF_OK;;
 		GF_CENCStream *cstr = gf_list_get(ctx->streams, i);
 		GF_FilterPacket *pck = gf_filter_pid_get_packet(cstr->ipid);
 		if (!pck) {
 			if (gf_filter_pid_is_eos(cstr->ipid)) {
+				e = cenc_enc_flush_jobs(ctx, 0);
+				if (e) return e;
 				gf_filter_pid_set_eos(cstr->opid);
 				nb_eos++;
 			}
@@ -1792,11 +1951,17 @@ static GF_Err cenc_enc_process(GF_Filter *filter)
 		}
 		gf_filter_pid_drop_packet(cstr->ipid);
 		cstr->nb_pck++;
+		nb_pck++;
 
 		if (e) return e;
 	}
 	if (nb_eos==count) return GF_EOS;
 
+	if (ctx->pool) {
+		//no input, wait for all pending jobs, otherwise only for the oldest ones above the limit
+		return cenc_enc_flush_jobs(ctx, nb_pck ? ctx->max_pending : 0);
+	}
+
 	return GF_OK;
 }
 
@@ -1814,12 +1979,48 @@ static GF_Err cenc_enc_initialize(GF_Filter *filter)
 	}
 
 	ctx->streams = gf_list_new();
+
+	if (ctx->threads) {
+		u32 nb_threads = 0;
+		if (ctx->threads>0) {
+			nb_threads = (u32) ctx->threads;
+		} else {
+			GF_SystemRTInfo rti;
+			if (gf_sys_get_rti(0, &rti, 0))
+				nb_threads = (rti.nb_cores>1) ? rti.nb_cores-1 : 1;
+		}
+		if (nb_threads)
+			ctx->pool = gf_crypt_pool_new(nb_threads);
+		if (!ctx->pool) {
+			GF_LOG(GF_LOG_WARNING, GF_LOG_AUTHOR, ("[CENCCrypt] Failed to create crypto workers, using single thread\n" ));
+		} else {
+			GF_LOG(GF_LOG_INFO, GF_LOG_AUTHOR, ("[CENCCrypt] Using %d crypto workers\n", nb_threads ));
+			ctx->max_pending = 4 * nb_threads;
+			ctx->pending_jobs = gf_list_new();
+			ctx->job_reservoir = gf_list_new();
+		}
+	}
 	return GF_OK;
 }
 
 static void cenc_enc_finalize(GF_Filter *filter)
 {
 	GF_CENCEncCtx *ctx = (GF_CENCEncCtx *)gf_filter_get_udta(filter);
+
+	//waits for all workers to exit
+	if (ctx->pool) gf_crypt_pool_del(ctx->pool);
+	while (gf_list_count(ctx->pending_jobs)) {
+		GF_CENCEncJob *job = gf_list_pop_back(ctx->pending_jobs);
+		gf_filter_pck_discard(job->pck);
+		cenc_enc_del_job(job);
+	}
+	gf_list_del(ctx->pending_jobs);
+	while (gf_list_count(ctx->job_reservoir)) {
+		cenc_enc_del_job(gf_list_pop_back(ctx->job_reservoir));
+	}
+	gf_list_del(ctx->job_reservoir);
+	if (ctx->cur_job) cenc_enc_del_job(ctx->cur_job);
+
 	if (ctx->cinfo) gf_crypt_info_del(ctx->cinfo);
 	while (gf_list_count(ctx->streams)) {
 		GF_CENCStream *s = gf_list_pop_back(ctx->streams);
@@ -1852,7 +2053,8 @@ static const GF_FilterCapability CENCEncCaps[] =
 static const GF_FilterArgs GF_CENCEncArgs[] =
 {
 	{ OFFS(cfile), "crypt file location - see filter help", GF_PROP_STRING, NULL, NULL, 0},
-	{ OFFS(allc), "throw error if no DRM config file is found for a PID - see filter help", GF_PROP_STRING, NULL, NULL, 0},
+	{ OFFS(allc), "throw error if no DRM config file is found for a PID - see filter help", GF_PROP_BOOL, "false", NULL, 0},
+	{ OFFS(threads), "number of threads used for encryption of CTR and constant IV CBC samples, 0 disables multithreading and -1 uses number of cores minus one", GF_PROP_SINT, "0", NULL, GF_FS_ARG_HINT_EXPERT},
 	{0}
 };
 
@@ -1864,6 +2066,9 @@ GF_FilterRegister CENCEncRegister = {
 	"The DRM config file can be set per PID using the property `CryptInfo`, or set at the filter level using [-cfile]().\n"
 	"When the DRM config file is set per PID, the first `CrypTrack` in the DRM config file with the same ID is used, otherwise the first `CrypTrack` is used.\n"
 	"If no DRM config file is defined for a given PID, this PID will not be encrypted, or an error will be thrown if [-allc]() is specified.\n"
+	"\n"
+	"Samples which do not depend on the previous sample state (CTR modes and CBC with constant IV) can be encrypted by several threads using [-threads](). "
+	"Packets are still output in order, and the result is identical to single-threaded encryption. CBC with per-sample IV is always encrypted in the filter thread.\n"
 	)
 	.private_size = sizeof(GF_CENCEncCtx),
 	.max_extra_pids=-1,
@@ -43,6 +43,8 @@ typedef struct
 	char *ext, *mime;
 	u32 block_size;
 	GF_Fraction64 range;
+	Bool aio;
+	u32 ra;
 
 	//only one output pid declared
 	GF_FilterPid *pid;
@@ -60,6 +62,11 @@ typedef struct
 	Bool no_failure;
 } GF_FileInCtx;
 
+//files opened with asynchronous I/O are wrapped in GF_FileIO but behave as regular files
+static Bool filein_is_gfio(FILE *file)
+{
+	return (gf_fileio_check(file) && !gf_file_is_aio(file)) ? GF_TRUE : GF_FALSE;
+}
 
 static GF_Err filein_initialize(GF_Filter *filter)
 {
@@ -128,12 +135,15 @@ static GF_Err filein_initialize(GF_Filter *filter)
 	if (ctx->do_reconfigure) {
 		old_file = ctx->file;
 		ctx->file = NULL;
-		if (gf_fileio_check(old_file))
+		if (filein_is_gfio(old_file))
 			prev_url = gf_fileio_url((GF_FileIO *)old_file);
 	}
 
 	if (!ctx->file) {
-		ctx->file = gf_fopen_ex(src, prev_url, "rb");
+		if (ctx->aio && !prev_url)
+			ctx->file = gf_fopen_aio(src, "rb", 0, ctx->ra, 0);
+		else
+			ctx->file = gf_fopen_ex(src, prev_url, "rb");
 	}
 
 	if (old_file) {
@@ -165,7 +175,7 @@ static GF_Err filein_initialize(GF_Filter *filter)
 	ctx->cached_set = GF_FALSE;
 	ctx->full_file_only = GF_FALSE;
 
-	if (ctx->do_reconfigure && gf_fileio_check(ctx->file)) {
+	if (ctx->do_reconfigure && filein_is_gfio(ctx->file)) {
 		GF_FileIO *gfio = (GF_FileIO *)ctx->file;
 		gf_free(ctx->src);
 		ctx->src = gf_strdup(gf_fileio_url(gfio));
@@ -273,7 +283,7 @@ static Bool filein_process_event(GF_Filter *filter, const GF_FilterEvent *evt)
 		GF_LOG(GF_LOG_INFO, GF_LOG_MMIO, ("[FileIn] Asked to seek source to range "LLU"-"LLU"\n", evt->seek.start_offset, evt->seek.end_offset));
 		ctx->is_end = GF_FALSE;
 
-		if (gf_fileio_check(ctx->file)) {
+		if (filein_is_gfio(ctx->file)) {
 			ctx->cached_set = GF_FALSE;
 		}
 
@@ -470,7 +480,7 @@ static GF_Err filein_process(GF_Filter *filter)
 		e = gf_filter_pid_raw_new(filter, ctx->src, ctx->src, ctx->mime, ctx->ext, ctx->block, nb_read, GF_TRUE, &ctx->pid);
 		if (e) return e;
 
-		if (!gf_fileio_check(ctx->file)) {
+		if (!filein_is_gfio(ctx->file)) {
 			gf_filter_pid_set_property(ctx->pid, GF_PROP_PID_FILE_CACHED, &PROP_BOOL(GF_TRUE) );
 
 			gf_filter_pid_set_property(ctx->pid, GF_PROP_PID_DOWN_SIZE, ctx->file_size ? &PROP_LONGUINT(ctx->file_size) : NULL);
@@ -557,6 +567,8 @@ static const GF_FilterArgs FileInArgs[] =
 	{ OFFS(range), "byte range", GF_PROP_FRACTION64, "0-0", NULL, 0},
 	{ OFFS(ext), "override file extension", GF_PROP_NAME, NULL, NULL, 0},
 	{ OFFS(mime), "set file mime type", GF_PROP_NAME, NULL, NULL, 0},
+	{ OFFS(aio), "use asynchronous I/O (io_uring, Linux only) with read-ahead", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(ra), "number of 1 MByte blocks read ahead in asynchronous mode", GF_PROP_UINT, "4", NULL, GF_FS_ARG_HINT_EXPERT},
 	{0}
 };
 
@@ -577,6 +589,9 @@ GF_FilterRegister FileInRegister = {
 	"The special file name `randsc` is used to generate random data with fake startcodes (0x000001).\n"
 	"\n"
 	"The filter handles both files and GF_FileIO objects as input URL.\n"
+	"\n"
+	"On Linux, [-aio]() reads the file using io_uring, keeping [-ra]() blocks in flight ahead of the current read position. "
+	"If asynchronous I/O is not available, the file is read using regular I/O.\n"
 	)
 	.private_size = sizeof(GF_FileInCtx),
 	.args = FileInArgs,
@@ -314,6 +314,9 @@ static Bool httpin_process_event(GF_Filter *filter, const GF_FilterEvent *evt)
 
 		if (!e && (evt->seek.start_offset || evt->seek.end_offset))
             e = gf_dm_sess_set_range(ctx->sess, evt->seek.start_offset, evt->seek.end_offset, GF_TRUE);
+		//fetch priority, only used with HTTP/2
+		if (!e && ctx->sess)
+			gf_dm_sess_set_priority(ctx->sess, evt->seek.priority);
 		
         if (e) {
 			//use info and not error, as source switch is done by dashin and can be scheduled too early in live cases
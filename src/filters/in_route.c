@@ -56,7 +56,7 @@ typedef struct
 	//options
 	char *src, *ifce, *odir;
 	Bool gcache, kc, sr, reorder, fullseg;
-	u32 buffer, timeout, stats, max_segs, tsidbg, rtimeout, nbcached, repair;
+	u32 buffer, timeout, stats, max_segs, tsidbg, rtimeout, nbcached, repair, batch;
 	s32 tunein, stsi;
 	
 	//internal
@@ -731,13 +731,14 @@ static GF_Err routein_process(GF_Filter *filter)
 				u64 et = gf_route_dmx_get_last_packet_time(ctx->route_dmx);
 				u64 nb_pck = gf_route_dmx_get_nb_packets(ctx->route_dmx);
 				u64 nb_bytes = gf_route_dmx_get_recv_bytes(ctx->route_dmx);
+				u64 nb_calls = gf_route_dmx_get_nb_recv_calls(ctx->route_dmx);
 
 				et -= st;
 				if (et) {
 					rate = (Double)nb_bytes*8;
 					rate /= et;
 				}
-				sprintf(szRpt, "[%us] "LLU" bytes "LLU" packets in "LLU" ms rate %.02f mbps", now/1000, nb_bytes, nb_pck, et/1000, rate);
+				sprintf(szRpt, "[%us] "LLU" bytes "LLU" packets in "LLU" ms rate %.02f mbps - %.02f packets per call", now/1000, nb_bytes, nb_pck, et/1000, rate, nb_calls ? ((Double) nb_pck) / nb_calls : 0.0);
 				gf_filter_update_status(filter, 0, szRpt);
 			}
 		}
@@ -803,6 +804,8 @@ static GF_Err routein_initialize(GF_Filter *filter)
 
 	gf_route_set_reorder(ctx->route_dmx, ctx->reorder, ctx->rtimeout);
 
+	gf_route_dmx_set_batch(ctx->route_dmx, ctx->batch);
+
 	if (ctx->tsidbg) {
 		gf_route_dmx_debug_tsi(ctx->route_dmx, ctx->tsidbg);
 	}
@@ -849,6 +852,7 @@ static const GF_FilterArgs ROUTEInArgs[] =
 	{ OFFS(gcache), "indicate the files should populate GPAC HTTP cache - see filter help", GF_PROP_BOOL, "true", NULL, GF_FS_ARG_HINT_ADVANCED},
 	{ OFFS(tunein), "service ID to bootstrap on for ATSC 3.0 mode. 0 means tune to no service, -1 tune all services -2 means tune on first service found", GF_PROP_SINT, "-2", NULL, 0},
 	{ OFFS(buffer), "receive buffer size to use in bytes", GF_PROP_UINT, "0x80000", NULL, GF_FS_ARG_HINT_ADVANCED},
+	{ OFFS(batch), "maximum number of packets read per system call, 0 or 1 disables batching", GF_PROP_UINT, "64", "0-64", GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(timeout), "timeout in ms after which tunein fails", GF_PROP_UINT, "5000", NULL, 0},
     { OFFS(nbcached), "number of segments to keep in cache per service", GF_PROP_UINT, "8", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(kc), "keep corrupted file", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_ADVANCED},
@@ -38,6 +38,8 @@
 
 
 #define RTSP_BUFFER_SIZE		5000
+/*max size of an RTP packet when reading packets in batch*/
+#define RTP_BATCH_DGRAM_SIZE	10000
 
 typedef struct _rtsp_session GF_RTPInRTSP;
 typedef struct __rtpin_stream GF_RTPInStream;
@@ -50,7 +52,7 @@ typedef struct
 	u32 firstport, ttl, satip_port;
 	const char *ifce, *force_mcast, *user_agent, *languages;
 	Bool use_client_ports;
-	u32 bandwidth, reorder_len, reorder_delay, nat_keepalive, block_size;
+	u32 bandwidth, reorder_len, reorder_delay, nat_keepalive, block_size, batch;
 	Bool disable_rtcp;
 	u32 default_port;
 	u32 rtsp_timeout, udp_timeout, rtcp_timeout, stats;
@@ -240,6 +242,10 @@ struct __rtpin_stream
 
 	/*rtp receive buffer*/
 	char *buffer;
+	/*rtp packets received in one call, allocated at first read if batching is enabled*/
+	u8 *batch_buffer;
+	GF_SockDatagram *dgrams;
+	u32 nb_recv_calls, nb_recv_pck;
 	/*set at play/seek stages to sync app NPT to RTP time (RTSP) or NTP to RTP (RTCP)
 	*/
 	u32 check_rtp_time;
@@ -92,6 +92,8 @@ void rtpin_stream_del(GF_RTPInStream *stream)
 	if (stream->control) gf_free(stream->control);
 	if (stream->session_id) gf_free(stream->session_id);
 	if (stream->buffer) gf_free(stream->buffer);
+	if (stream->batch_buffer) gf_free(stream->batch_buffer);
+	if (stream->dgrams) gf_free(stream->dgrams);
 	if (stream->pck_queue) {
 		rtpin_stream_reset_queue(stream);
 		gf_list_del(stream->pck_queue);
@@ -524,6 +526,10 @@ static void rtpin_stream_update_stats(GF_RTPInStream *stream)
 	bps *= 1000;
 	bps /= time;
 	gf_filter_pid_set_info_str(stream->opid, "nets:ctrl_bw_up", &PROP_UINT( (u32) bps ) );
+
+	if (stream->nb_recv_calls) {
+		gf_filter_pid_set_info_str(stream->opid, "nets:pck_per_call", &PROP_FLOAT( ((Float) stream->nb_recv_pck) / stream->nb_recv_calls ) );
+	}
 }
 
 
@@ -732,11 +738,37 @@ u32 rtpin_stream_read(GF_RTPInStream *stream)
 	}
 
 	if (gf_sk_group_sock_is_set(stream->rtpin->sockgroup, stream->rtp_ch->rtp, GF_SK_SELECT_READ)) {
-		size = gf_rtp_read_rtp(stream->rtp_ch, stream->buffer, stream->rtpin->block_size);
-		if (size) {
-			tot_size += size;
-			stream->rtpin->udp_timeout = 0;
-			rtpin_stream_on_rtp_pck(stream, stream->buffer, size);
+		if (stream->rtpin->batch>1) {
+			u32 i, nb_pck, nb_dgrams = MIN(stream->rtpin->batch, GF_SK_MAX_BATCH);
+			u32 dgram_size = MIN(stream->rtpin->block_size, RTP_BATCH_DGRAM_SIZE);
+			if (!stream->batch_buffer) {
+				stream->batch_buffer = gf_malloc(sizeof(u8) * dgram_size * nb_dgrams);
+				stream->dgrams = gf_malloc(sizeof(GF_SockDatagram) * nb_dgrams);
+				if (!stream->batch_buffer || !stream->dgrams) return 0;
+			}
+			for (i=0; i<nb_dgrams; i++) {
+				stream->dgrams[i].data = stream->batch_buffer + i * dgram_size;
+				stream->dgrams[i].size = dgram_size;
+			}
+			nb_pck = gf_rtp_read_rtp_batch(stream->rtp_ch, stream->dgrams, nb_dgrams);
+			if (nb_pck) {
+				stream->nb_recv_calls++;
+				stream->nb_recv_pck += nb_pck;
+				stream->rtpin->udp_timeout = 0;
+			}
+			for (i=0; i<nb_pck; i++) {
+				tot_size += stream->dgrams[i].size;
+				rtpin_stream_on_rtp_pck(stream, stream->dgrams[i].data, stream->dgrams[i].size);
+			}
+		} else {
+			size = gf_rtp_read_rtp(stream->rtp_ch, stream->buffer, stream->rtpin->block_size);
+			if (size) {
+				tot_size += size;
+				stream->nb_recv_calls++;
+				stream->nb_recv_pck++;
+				stream->rtpin->udp_timeout = 0;
+				rtpin_stream_on_rtp_pck(stream, stream->buffer, size);
+			}
 		}
 	}
 	if (!tot_size) return 0;
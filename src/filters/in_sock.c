@@ -54,7 +54,7 @@ typedef struct
 {
 	//options
 	const char *src;
-	u32 block_size, sockbuf;
+	u32 block_size, sockbuf, batch;
 	u32 port, maxc;
 	char *ifce;
 	const char *ext;
@@ -72,6 +72,10 @@ typedef struct
 	Bool is_udp;
 
 	char *buffer;
+	//datagrams received in one call, a single one if no batch
+	GF_SockDatagram *dgrams;
+	Bool use_batch;
+	u64 nb_recv_calls, nb_recv_dgrams;
 
 	GF_SockGroup *active_sockets;
 	u64 last_rcv_time;
@@ -171,8 +175,19 @@ static GF_Err sockin_initialize(GF_Filter *filter)
 
 	if (ctx->block_size<2000)
 		ctx->block_size = 2000;
-	ctx->buffer = gf_malloc(ctx->block_size + 1);
+	if (ctx->batch>GF_SK_MAX_BATCH) ctx->batch = GF_SK_MAX_BATCH;
+	if ((sock_type==GF_SOCK_TYPE_UDP)
+#ifdef GPAC_HAS_SOCK_UN
+		|| (sock_type==GF_SOCK_TYPE_UDP_UN)
+#endif
+	) {
+		if (ctx->batch>1) ctx->use_batch = GF_TRUE;
+	}
+	//one more byte per datagram for probing
+	ctx->buffer = gf_malloc((ctx->block_size + 1) * (ctx->use_batch ? ctx->batch : 1));
 	if (!ctx->buffer) return GF_OUT_OF_MEM;
+	ctx->dgrams = gf_malloc(sizeof(GF_SockDatagram) * (ctx->use_batch ? ctx->batch : 1));
+	if (!ctx->dgrams) return GF_OUT_OF_MEM;
 	//ext/mime given and not mpeg2, disable probe
 	if (ctx->ext && !strstr("ts|m2t|mts|dmb|trp", ctx->ext)) ctx->tsprobe = GF_FALSE;
 	if (ctx->mime && !strstr(ctx->mime, "mpeg-2") && !strstr(ctx->mime, "mp2t")) ctx->tsprobe = GF_FALSE;
@@ -206,6 +221,7 @@ static void sockin_finalize(GF_Filter *filter)
 	}
 	sockin_client_reset(&ctx->sock_c);
 	if (ctx->buffer) gf_free(ctx->buffer);
+	if (ctx->dgrams) gf_free(ctx->dgrams);
 	if (ctx->active_sockets) gf_sk_group_del(ctx->active_sockets);
 }
 
@@ -249,8 +265,8 @@ static Bool sockin_process_event(GF_Filter *filter, const GF_FilterEvent *evt)
 
 static GF_Err sockin_read_client(GF_Filter *filter, GF_SockInCtx *ctx, GF_SockInClient *sock_c)
 {
-	u32 nb_read;
-	u64 bitrate;
+	u32 i, nb_read, nb_dgrams, pck_size;
+	u64 bitrate, batch_bytes;
 	GF_Err e;
 	GF_FilterPacket *dst_pck;
 	u8 *out_data, *in_data;
@@ -266,7 +282,19 @@ static GF_Err sockin_read_client(GF_Filter *filter, GF_SockInCtx *ctx, GF_SockIn
 
 	if (!sock_c->start_time) sock_c->start_time = gf_sys_clock_high_res();
 
-	e = gf_sk_receive_no_select(sock_c->socket, ctx->buffer, ctx->block_size, &nb_read);
+	nb_dgrams = 0;
+	if (ctx->use_batch) {
+		for (i=0; i<ctx->batch; i++) {
+			ctx->dgrams[i].data = ctx->buffer + i * (ctx->block_size + 1);
+			ctx->dgrams[i].size = ctx->block_size;
+		}
+		e = gf_sk_receive_batch(sock_c->socket, ctx->dgrams, ctx->batch, &nb_dgrams);
+	} else {
+		e = gf_sk_receive_no_select(sock_c->socket, ctx->buffer, ctx->block_size, &nb_read);
+		ctx->dgrams[0].data = ctx->buffer;
+		ctx->dgrams[0].size = nb_read;
+		if (!e && nb_read) nb_dgrams = 1;
+	}
 	switch (e) {
 	case GF_IP_NETWORK_EMPTY:
 		return GF_OK;
@@ -281,85 +309,112 @@ static GF_Err sockin_read_client(GF_Filter *filter, GF_SockInCtx *ctx, GF_SockIn
 	default:
 		return e;
 	}
-	if (!nb_read) return GF_OK;
-	sock_c->nb_bytes += nb_read;
-	sock_c->done = GF_FALSE;
-
-	//we allocated one more byte for that
-	ctx->buffer[nb_read] = 0;
-
-	//first run, probe data
-	if (!sock_c->pid) {
-		const char *mime = ctx->mime;
-		//probe MPEG-2
-		if (ctx->tsprobe) {
-			/*TS over RTP signaled as udp */
-			if ((ctx->buffer[0] != 0x47) && ((ctx->buffer[1] & 0x7F) == 33) ) {
+	if (!nb_dgrams) return GF_OK;
+	ctx->nb_recv_calls++;
+	ctx->nb_recv_dgrams += nb_dgrams;
+
+	pck_size = 0;
+	batch_bytes = 0;
+	for (i=0; i<nb_dgrams; i++) {
+		u8 *data = ctx->dgrams[i].data;
+		nb_read = ctx->dgrams[i].size;
+		if (!nb_read) continue;
+		sock_c->nb_bytes += nb_read;
+		batch_bytes += nb_read;
+		sock_c->done = GF_FALSE;
+
+		//we allocated one more byte for that
+		data[nb_read] = 0;
+
+		//first run, probe data
+		if (!sock_c->pid) {
+			const char *mime = ctx->mime;
+			//probe MPEG-2
+			if (ctx->tsprobe) {
+				/*TS over RTP signaled as udp */
+				if ((data[0] != 0x47) && ((data[1] & 0x7F) == 33) ) {
 #ifndef GPAC_DISABLE_STREAMING
-				sock_c->rtp_reorder = gf_rtp_reorderer_new(ctx->reorder_pck, ctx->reorder_delay);
+					sock_c->rtp_reorder = gf_rtp_reorderer_new(ctx->reorder_pck, ctx->reorder_delay);
 #else
-				sock_c->is_rtp = GF_TRUE;
+					sock_c->is_rtp = GF_TRUE;
 #endif
-				mime = "video/mp2t";
-			} else if (ctx->buffer[0] == 0x47) {
-				mime = "video/mp2t";
+					mime = "video/mp2t";
+				} else if (data[0] == 0x47) {
+					mime = "video/mp2t";
+				}
 			}
-		}
 
-		e = gf_filter_pid_raw_new(filter, ctx->src, NULL, mime, ctx->ext, ctx->buffer, nb_read, GF_TRUE, &sock_c->pid);
-		if (e) return e;
+			e = gf_filter_pid_raw_new(filter, ctx->src, NULL, mime, ctx->ext, data, nb_read, GF_TRUE, &sock_c->pid);
+			if (e) return e;
 
-//		if (ctx->is_udp) gf_filter_pid_set_property(sock_c->pid, GF_PROP_PID_UDP, &PROP_BOOL(GF_TRUE) );
+//			if (ctx->is_udp) gf_filter_pid_set_property(sock_c->pid, GF_PROP_PID_UDP, &PROP_BOOL(GF_TRUE) );
 
-		gf_filter_pid_set_udta(sock_c->pid, sock_c);
+			gf_filter_pid_set_udta(sock_c->pid, sock_c);
 
 #ifdef GPAC_ENABLE_COVERAGE
-		if (gf_sys_is_cov_mode()) {
-			GF_FilterEvent evt;
-			memset(&evt, 0, sizeof(GF_FilterEvent));
-			evt.base.type = GF_FEVT_PLAY;
-			evt.base.on_pid = sock_c->pid;
-			sockin_process_event(filter, &evt);
-		}
+			if (gf_sys_is_cov_mode()) {
+				GF_FilterEvent evt;
+				memset(&evt, 0, sizeof(GF_FilterEvent));
+				evt.base.type = GF_FEVT_PLAY;
+				evt.base.on_pid = sock_c->pid;
+				sockin_process_event(filter, &evt);
+			}
 #endif
-
-	}
-
-	in_data = ctx->buffer;
+		}
 
 #ifndef GPAC_DISABLE_STREAMING
-	if (sock_c->rtp_reorder) {
-		char *pck;
-		u16 seq_num = ((ctx->buffer[2] << 8) & 0xFF00) | (ctx->buffer[3] & 0xFF);
-		gf_rtp_reorderer_add(sock_c->rtp_reorder, (void *) ctx->buffer, nb_read, seq_num);
-
-		pck = (char *) gf_rtp_reorderer_get(sock_c->rtp_reorder, &nb_read, GF_FALSE);
-		if (pck) {
-			dst_pck = gf_filter_pck_new_shared(sock_c->pid, pck+12, nb_read-12, sockin_rtp_destructor);
-			gf_filter_pck_set_framing(dst_pck, GF_TRUE, GF_TRUE);
-			gf_filter_pck_send(dst_pck);
+		if (sock_c->rtp_reorder) {
+			char *pck;
+			u16 seq_num = ((data[2] << 8) & 0xFF00) | (data[3] & 0xFF);
+			gf_rtp_reorderer_add(sock_c->rtp_reorder, (void *) data, nb_read, seq_num);
+
+			pck = (char *) gf_rtp_reorderer_get(sock_c->rtp_reorder, &nb_read, GF_FALSE);
+			if (pck) {
+				dst_pck = gf_filter_pck_new_shared(sock_c->pid, pck+12, nb_read-12, sockin_rtp_destructor);
+				gf_filter_pck_set_framing(dst_pck, GF_TRUE, GF_TRUE);
+				gf_filter_pck_send(dst_pck);
+			}
+			continue;
 		}
-		return GF_OK;
-	}
 #else
-	if (sock_c->is_rtp) {
-		in_data = ctx->buffer + 12;
-		nb_read -= 12;
-	}
+		if (sock_c->is_rtp) {
+			if (nb_read<=12) {
+				ctx->dgrams[i].size = 0;
+				continue;
+			}
+			ctx->dgrams[i].data += 12;
+			ctx->dgrams[i].size -= 12;
+		}
 #endif
+		pck_size += ctx->dgrams[i].size;
+	}
 
-	dst_pck = gf_filter_pck_new_alloc(sock_c->pid, nb_read, &out_data);
-	memcpy(out_data, in_data, nb_read);
-
-	gf_filter_pck_set_framing(dst_pck, (sock_c->nb_bytes == nb_read)  ? GF_TRUE : GF_FALSE, GF_FALSE);
-	gf_filter_pck_send(dst_pck);
+	//all datagrams of the batch are sent in a single packet
+	if (pck_size) {
+		dst_pck = gf_filter_pck_new_alloc(sock_c->pid, pck_size, &out_data);
+		if (!dst_pck) return GF_OUT_OF_MEM;
+		for (i=0; i<nb_dgrams; i++) {
+			in_data = ctx->dgrams[i].data;
+			nb_read = ctx->dgrams[i].size;
+			if (!nb_read) continue;
+			memcpy(out_data, in_data, nb_read);
+			out_data += nb_read;
+		}
+		gf_filter_pck_set_framing(dst_pck, (sock_c->nb_bytes == batch_bytes)  ? GF_TRUE : GF_FALSE, GF_FALSE);
+		gf_filter_pck_send(dst_pck);
+	}
 
 	//send bitrate
 	bitrate = ( gf_sys_clock_high_res() - sock_c->start_time );
-	if (bitrate) {
+	if (bitrate && sock_c->pid) {
 		bitrate = (sock_c->nb_bytes * 8 * 1000000) / bitrate;
 		gf_filter_pid_set_property(sock_c->pid, GF_PROP_PID_DOWN_RATE, &PROP_UINT((u32) bitrate) );
 		GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[SockIn] Receiving from %s at %d kbps\r", sock_c->address, (u32) (bitrate/10)));
+		if (gf_filter_reporting_enabled(filter)) {
+			char szStatus[200];
+			snprintf(szStatus, 200, "Receiving at %d kbps - %.02f datagrams per call", (u32) (bitrate/1000), ((Double) ctx->nb_recv_dgrams) / ctx->nb_recv_calls);
+			gf_filter_update_status(filter, -1, szStatus);
+		}
 	}
 
 	return GF_OK;
@@ -481,6 +536,7 @@ static const GF_FilterArgs SockInArgs[] =
 	{ OFFS(src), "address of source content - see filter help", GF_PROP_NAME, NULL, NULL, 0},
 	{ OFFS(block_size), "block size used to read socket", GF_PROP_UINT, "10000", NULL, GF_FS_ARG_HINT_ADVANCED},
 	{ OFFS(sockbuf), "socket max buffer size", GF_PROP_UINT, "65536", NULL, GF_FS_ARG_HINT_ADVANCED},
+	{ OFFS(batch), "maximum number of datagrams read per system call for UDP sockets, each datagram using [-block_size]() bytes of memory. A value of 0 or 1 disables batching", GF_PROP_UINT, "64", "0-64", GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(port), "default port if not specified", GF_PROP_UINT, "1234", NULL, 0},
 	{ OFFS(ifce), "default multicast interface", GF_PROP_NAME, NULL, NULL, GF_FS_ARG_HINT_ADVANCED},
 	{ OFFS(listen), "indicate the input socket works in server mode", GF_PROP_BOOL, "false", NULL, 0},
@@ -64,6 +64,8 @@ typedef struct
 	Bool sigfrag;
 	Bool nocrypt, strtxt;
 	u32 mstore_purge, mstore_samples, mstore_size;
+	u32 mmap, rblock;
+	u32 sindex;
 
 	//internal
 
@@ -119,6 +121,9 @@ typedef struct
 	u64 last_min_offset;
 	GF_Err in_error;
 	Bool force_fetch;
+
+	//file mapping used for zero-copy packets, one reference held by the reader and one per packet
+	void *mapping;
 } ISOMReader;
 
 typedef struct
@@ -135,6 +140,9 @@ typedef struct
 	/*current sample*/
 	GF_ISOSample *static_sample;
 	GF_ISOSample *sample;
+	//payload of the current sample in the file mapping, sample->data is not used if set
+	const u8 *mapped_data;
+	void *mapping;
 	u64 sample_data_offset, last_valid_sample_data_offset;
 	GF_Err last_state;
 	Bool sap_3;
@@ -202,6 +210,7 @@ typedef struct
 void isor_reset_reader(ISOMChannel *ch);
 void isor_reader_get_sample(ISOMChannel *ch);
 void isor_reader_release_sample(ISOMChannel *ch);
+void isor_reader_release_mapped_data(ISOMChannel *ch);
 void isor_update_channel_config(ISOMChannel *ch);
 
 void isor_check_producer_ref_time(ISOMReader *read);
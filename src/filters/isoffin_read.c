@@ -53,6 +53,28 @@ static GFINLINE Bool isor_is_local(const char *url)
 }
 
 
+static void isoffin_setup_mapping(ISOMReader *read)
+{
+	const GF_PropertyValue *prop;
+	//the mapping is released by packet destructors through read->mapping, it is never changed once set
+	if (read->mapping) return;
+	//only map complete non-fragmented files, fragmented files may grow or be segments of a session
+	if ((!read->mmap && !read->rblock) || read->frag_type) return;
+	if (read->pid) {
+		prop = gf_filter_pid_get_property(read->pid, GF_PROP_PID_FILE_CACHED);
+		if (!prop || !prop->value.boolean) return;
+	}
+	if (!read->mmap || (gf_isom_enable_file_mapping(read->mov, ((u64) read->mmap) * 1024 * 1024) != GF_OK)) {
+		u32 nb_blocks;
+		if (!read->rblock) return;
+		//one block per track being read plus a few for interleaving jitter
+		nb_blocks = gf_isom_get_track_count(read->mov) + 2;
+		if (nb_blocks>64) nb_blocks = 64;
+		if (gf_isom_enable_block_reads(read->mov, read->rblock, nb_blocks) != GF_OK) return;
+	}
+	read->mapping = gf_isom_get_file_mapping(read->mov);
+}
+
 static GF_Err isoffin_setup(GF_Filter *filter, ISOMReader *read)
 {
 	char szURL[2048];
@@ -142,6 +164,10 @@ static GF_Err isoffin_setup(GF_Filter *filter, ISOMReader *read)
 	if (!read->input_loaded && read->frag_type)
 		read->refresh_fragmented = GF_TRUE;
 
+	isoffin_setup_mapping(read);
+	if (read->sindex && !read->frag_type)
+		gf_isom_set_sample_index(read->mov, 0, (read->sindex==1) ? GF_ISOM_SAMPLE_INDEX_LAZY : GF_ISOM_SAMPLE_INDEX_BUILD);
+
 	if (read->strtxt)
 		gf_isom_text_set_streaming_mode(read->mov, GF_TRUE);
 
@@ -467,9 +493,18 @@ static void isoffin_finalize(GF_Filter *filter)
 	}
 	gf_list_del(read->channels);
 
+	if (read->mov) {
+		u64 nb_reads, nb_bytes;
+		if (gf_isom_get_block_read_stats(read->mov, &nb_reads, &nb_bytes) == GF_OK) {
+			GF_LOG(GF_LOG_INFO, GF_LOG_CONTAINER, ("[IsoMedia] Block reads: "LLU" reads "LLU" bytes\n", nb_reads, nb_bytes));
+		}
+	}
 	if (!read->extern_mov && read->mov) gf_isom_close(read->mov);
 	read->mov = NULL;
 
+	//pointer is kept for the destructors of packets still in use
+	if (read->mapping) gf_isom_release_mapped_data(read->mapping);
+
 	if (read->mem_blob.data) gf_free(read->mem_blob.data);
 	if (read->mem_url) gf_free(read->mem_url);
 }
@@ -1094,6 +1129,13 @@ static void isoffin_purge_mem(ISOMReader *read, u64 min_offset)
 	}
 }
 
+static void isoffin_mapped_pck_del(GF_Filter *filter, GF_FilterPid *pid, GF_FilterPacket *pck)
+{
+	u32 size;
+	ISOMReader *read = gf_filter_get_udta(filter);
+	gf_isom_release_mapped_payload(read->mapping, gf_filter_pck_get_data(pck, &size));
+}
+
 static GF_Err isoffin_process(GF_Filter *filter)
 {
 	ISOMReader *read = gf_filter_get_udta(filter);
@@ -1279,10 +1321,20 @@ static GF_Err isoffin_process(GF_Filter *filter)
 				//strip param sets from payload, trigger reconfig if needed
 				isor_reader_check_config(ch);
 
-				pck = gf_filter_pck_new_alloc(ch->pid, ch->sample->dataLength, &data);
-				assert(pck);
+				if (ch->mapped_data && read->mapping) {
+					pck = gf_filter_pck_new_shared(ch->pid, ch->mapped_data, ch->sample->dataLength, isoffin_mapped_pck_del);
+					assert(pck);
+					//mapped memory is read-only and block cache memory is shared by several samples, prevent inplace processing downstream
+					gf_filter_pck_set_readonly(pck);
+					//reference is now owned by the packet
+					ch->mapping = NULL;
+					ch->mapped_data = NULL;
+				} else {
+					pck = gf_filter_pck_new_alloc(ch->pid, ch->sample->dataLength, &data);
+					assert(pck);
 
-				memcpy(data, ch->sample->data, ch->sample->dataLength);
+					memcpy(data, ch->mapped_data ? ch->mapped_data : ch->sample->data, ch->sample->dataLength);
+				}
 
 				gf_filter_pck_set_dts(pck, ch->dts);
 				gf_filter_pck_set_cts(pck, ch->cts);
@@ -1482,6 +1534,12 @@ static const GF_FilterArgs ISOFFInArgs[] =
 	{ OFFS(mstore_purge), "minimum size in bytes between memory purges when reading from memory stream (pipe etc...), 0 means purge as soon as possible", GF_PROP_UINT, "50000", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(mstore_samples), "minimum number of samples to be present before purging sample tables when reading from memory stream (pipe etc...), 0 means purge as soon as possible", GF_PROP_UINT, "50", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(strtxt), "load text tracks (apple/tx3g) as MPEG-4 streaming text tracks", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(mmap), "memory-map complete local files up to the given size in MiB and dispatch sample payloads without copy when possible (0 disables). This mostly benefits files read several times or from page cache, cold reads of large files may be slower than regular file IO", GF_PROP_UINT, "0", NULL, GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(rblock), "read sample data of complete local files not memory-mapped by blocks of at least the given size in bytes and dispatch sample payloads without copy when possible (0 disables). Tracks are still read in turn, not in file offset order: loosely interleaved files may read the same data several times", GF_PROP_UINT, "0", NULL, GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(sindex), "flattened sample table index for fast random access in non-fragmented files\n"
+	"- no: no sample index\n"
+	"- lazy: build index on first random access in a track\n"
+	"- full: build index when opening the file", GF_PROP_UINT, "no", "no|lazy|full", GF_FS_ARG_HINT_EXPERT},
 
 	{0}
 };
@@ -333,9 +333,16 @@ void isor_reader_get_sample(ISOMChannel *ch)
 			}
 		}
 		if (do_fetch) {
-			ch->sample = gf_isom_get_sample_ex(ch->owner->mov, ch->track, ch->sample_num, &sample_desc_index, ch->static_sample, &ch->sample_data_offset);
+			if (ch->owner->mapping) {
+				//in case previous sample was dropped without release
+				isor_reader_release_mapped_data(ch);
+				ch->sample = gf_isom_get_sample_mapped(ch->owner->mov, ch->track, ch->sample_num, &sample_desc_index, ch->static_sample, &ch->sample_data_offset, &ch->mapped_data, &ch->mapping);
+			} else {
+				ch->sample = gf_isom_get_sample_ex(ch->owner->mov, ch->track, ch->sample_num, &sample_desc_index, ch->static_sample, &ch->sample_data_offset);
+			}
 			/*if sync shadow / carousel RAP skip*/
 			if (ch->sample && (ch->sample->IsRAP==RAP_REDUNDANT)) {
+				isor_reader_release_mapped_data(ch);
 				ch->sample = NULL;
 				ch->sample_num++;
 				isor_reader_get_sample(ch);
@@ -515,10 +522,35 @@ void isor_reader_get_sample(ISOMChannel *ch)
 		ch->sample_num += ch->sample->nb_pack-1;
 }
 
+void isor_reader_release_mapped_data(ISOMChannel *ch)
+{
+	if (ch->mapping) gf_isom_release_mapped_data(ch->mapping);
+	ch->mapping = NULL;
+	ch->mapped_data = NULL;
+}
+
+//copy the mapped payload to the sample buffer, used when the payload must be modified
+static GF_Err isor_reader_unmap_sample(ISOMChannel *ch)
+{
+	if (!ch->mapped_data) return GF_OK;
+	if (ch->sample->alloc_size < ch->sample->dataLength) {
+		ch->sample->data = gf_realloc(ch->sample->data, ch->sample->dataLength);
+		if (!ch->sample->data) {
+			ch->sample->alloc_size = 0;
+			return GF_OUT_OF_MEM;
+		}
+		ch->sample->alloc_size = ch->sample->dataLength;
+	}
+	memcpy(ch->sample->data, ch->mapped_data, ch->sample->dataLength);
+	isor_reader_release_mapped_data(ch);
+	return GF_OK;
+}
+
 void isor_reader_release_sample(ISOMChannel *ch)
 {
 	if (ch->sample)
 		ch->au_seq_num++;
+	isor_reader_release_mapped_data(ch);
 	ch->sample = NULL;
 	ch->sai_buffer_size = 0;
 }
@@ -608,6 +640,7 @@ static void isor_replace_nal(GF_AVCConfig *avcc, GF_HEVCConfig *hvcc, u8 *data,
 void isor_reader_check_config(ISOMChannel *ch)
 {
 	u32 nalu_len, reset_state;
+	u8 *data;
 	if (!ch->check_hevc_ps && !ch->check_avc_ps && !ch->check_mhas_pl) return;
 
 	if (!ch->sample) return;
@@ -617,7 +650,7 @@ void isor_reader_check_config(ISOMChannel *ch)
 
 	if (ch->check_mhas_pl) {
 		u64 ch_layout = 0;
-		s32 PL = gf_mpegh_get_mhas_pl(ch->sample->data, ch->sample->dataLength, &ch_layout);
+		s32 PL = gf_mpegh_get_mhas_pl(ch->mapped_data ? (u8 *) ch->mapped_data : ch->sample->data, ch->sample->dataLength, &ch_layout);
 		if (PL>0) {
 			gf_filter_pid_set_property(ch->pid, GF_PROP_PID_PROFILE_LEVEL, &PROP_UINT((u32) PL));
 			ch->check_mhas_pl = GF_FALSE;
@@ -632,8 +665,10 @@ void isor_reader_check_config(ISOMChannel *ch)
 	nalu_len = ch->hvcc ? ch->hvcc->nal_unit_size : (ch->avcc ? ch->avcc->nal_unit_size : 4);
 	reset_state = 0;
 
-	if (!ch->nal_bs) ch->nal_bs = gf_bs_new(ch->sample->data, ch->sample->dataLength, GF_BITSTREAM_READ);
-	else gf_bs_reassign_buffer(ch->nal_bs, ch->sample->data, ch->sample->dataLength);
+	//mapped payload is only inspected, and copied if parameter sets have to be removed
+	data = ch->mapped_data ? (u8 *) ch->mapped_data : ch->sample->data;
+	if (!ch->nal_bs) ch->nal_bs = gf_bs_new(data, ch->sample->dataLength, GF_BITSTREAM_READ);
+	else gf_bs_reassign_buffer(ch->nal_bs, data, ch->sample->dataLength);
 
 	while (gf_bs_available(ch->nal_bs)) {
 		Bool replace_nal = GF_FALSE;
@@ -664,6 +699,9 @@ void isor_reader_check_config(ISOMChannel *ch)
 		}
 		gf_bs_skip_bytes(ch->nal_bs, size);
 
+		if (replace_nal && ch->mapped_data) {
+			if (isor_reader_unmap_sample(ch) != GF_OK) break;
+		}
 		if (replace_nal) {
 			u32 move_size = ch->sample->dataLength - size - pos - nalu_len;
 			isor_replace_nal(ch->avcc, ch->hvcc, ch->sample->data + pos + nalu_len, size, nal_type, &reset_state);
@@ -209,6 +209,7 @@ typedef struct
 	u32 xps_inband;
 	u32 block_size;
 	u32 store, tktpl, mudta;
+	s32 moovres;
 	s32 subs_sidx;
 	GF_Fraction cdur;
 	s32 moovts;
@@ -294,6 +295,9 @@ typedef struct
 	Bool moov_inserted;
 	Bool update_report;
 	u64 total_bytes_in, total_bytes_out;
+	//bytes patched in place and inserted in output file
+	u64 total_bytes_patch, total_bytes_insert, insert_offset;
+	Bool moovres_done;
 	u32 total_samples, last_mux_pc;
 
 	u32 maxchunk;
@@ -4381,6 +4385,7 @@ GF_Err mp4mx_reload_output(GF_Filter *filter, GF_MP4MuxCtx *ctx)
 		ctx->file = NULL;
 	}
 	ctx->init_movie_done = GF_FALSE;
+	ctx->moovres_done = GF_FALSE;
 	e = mp4_mux_initialize(filter);
 	if (e) return e;
 	ctx->config_timing = GF_TRUE;
@@ -5062,6 +5067,110 @@ void mp4_mux_format_report(GF_Filter *filter, GF_MP4MuxCtx *ctx, u64 done, u64 t
 }
 
 
+//estimate moov size from declared durations, frame rates and bitrates, so that moov can be written before mdat without moving data
+static u32 mp4_mux_estimate_moov_size(GF_MP4MuxCtx *ctx)
+{
+	u32 i, count = gf_list_count(ctx->tracks);
+	u64 est_size = 1024, file_size = 0;
+	Bool use_co64;
+
+	//first pass to check if we need 64 bit chunk offsets
+	for (i=0; i<count; i++) {
+		const GF_PropertyValue *p;
+		TrackWriter *tkw = gf_list_get(ctx->tracks, i);
+		GF_Fraction64 pid_dur;
+		p = gf_filter_pid_get_property(tkw->ipid, GF_PROP_PID_DURATION);
+		if (!p || !p->value.lfrac.den || (p->value.lfrac.num<=0)) continue;
+		pid_dur = p->value.lfrac;
+		p = gf_filter_pid_get_property(tkw->ipid, GF_PROP_PID_BITRATE);
+		if (p) file_size += p->value.uint * (u64) pid_dur.num / pid_dur.den / 8;
+	}
+	use_co64 = (file_size > 0xFFFFFFFFUL) ? GF_TRUE : GF_FALSE;
+
+	for (i=0; i<count; i++) {
+		const GF_PropertyValue *p;
+		u64 nb_samples=0, nb_chunks, bytes_per_sample;
+		Double dur;
+		GF_Fraction64 pid_dur = {0, 0};
+		TrackWriter *tkw = gf_list_get(ctx->tracks, i);
+
+		//track, media and sample description boxes
+		est_size += 1024;
+		p = gf_filter_pid_get_property(tkw->ipid, GF_PROP_PID_DECODER_CONFIG);
+		if (p) est_size += p->value.data.size;
+		p = gf_filter_pid_get_property(tkw->ipid, GF_PROP_PID_DECODER_CONFIG_ENHANCEMENT);
+		if (p) est_size += p->value.data.size;
+
+		if (tkw->is_item) continue;
+
+		p = gf_filter_pid_get_property(tkw->ipid, GF_PROP_PID_DURATION);
+		if (p) pid_dur = p->value.lfrac;
+		if (!pid_dur.den || (pid_dur.num<=0)) {
+			//systems streams without duration usually only have a few samples
+			if ((tkw->stream_type!=GF_STREAM_VISUAL) && (tkw->stream_type!=GF_STREAM_AUDIO)) {
+				est_size += 1024;
+				continue;
+			}
+			GF_LOG(GF_LOG_WARNING, GF_LOG_CONTAINER, ("[MP4Mux] Unknown duration for PID %s, cannot estimate moov size\n", gf_filter_pid_get_name(tkw->ipid) ));
+			return 0;
+		}
+		dur = (Double) pid_dur.num;
+		dur /= pid_dur.den;
+
+		if (tkw->nb_frames) {
+			nb_samples = tkw->nb_frames;
+		} else if (tkw->stream_type==GF_STREAM_VISUAL) {
+			p = gf_filter_pid_get_property(tkw->ipid, GF_PROP_PID_FPS);
+			if (p && p->value.frac.den && p->value.frac.num)
+				nb_samples = (u64) (dur * p->value.frac.num / p->value.frac.den) + 1;
+		} else if (tkw->stream_type==GF_STREAM_AUDIO) {
+			u32 spf = 1024;
+			p = gf_filter_pid_get_property(tkw->ipid, GF_PROP_PID_SAMPLES_PER_FRAME);
+			if (p && p->value.uint) spf = p->value.uint;
+			p = gf_filter_pid_get_property(tkw->ipid, GF_PROP_PID_SAMPLE_RATE);
+			if (p && p->value.uint)
+				nb_samples = (u64) (dur * p->value.uint / spf) + 1;
+		}
+		//text and others, assume at most 2 samples per second
+		if (!nb_samples)
+			nb_samples = (u64) (dur * 2) + 1;
+
+		//stsz entry, stts/stss/sdtp share, ctts entry for video
+		bytes_per_sample = 6;
+		if (tkw->stream_type==GF_STREAM_VISUAL) bytes_per_sample += 8;
+
+		//one chunk per sample when not interleaving
+		nb_chunks = nb_samples;
+		if (ctx->cdur.num && ctx->cdur.den) {
+			nb_chunks = (u64) (dur * ctx->cdur.den / ctx->cdur.num) + 1;
+			if (nb_chunks > nb_samples) nb_chunks = nb_samples;
+		}
+		//chunk offset entry and stsc entry
+		est_size += nb_samples * bytes_per_sample + nb_chunks * ((use_co64 ? 8 : 4) + 12);
+	}
+	//safety margin
+	est_size += est_size / 8;
+	if (est_size > 0xFFFFFFFFUL) return 0;
+	return (u32) est_size;
+}
+
+static void mp4_mux_setup_moov_reservation(GF_MP4MuxCtx *ctx)
+{
+	GF_Err e;
+	u32 size;
+	ctx->moovres_done = GF_TRUE;
+	if (ctx->moovres>0) size = (u32) ctx->moovres;
+	else size = mp4_mux_estimate_moov_size(ctx);
+	if (!size) return;
+
+	e = gf_isom_set_moov_reservation(ctx->file, size);
+	if (e) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_CONTAINER, ("[MP4Mux] Failed to reserve moov space: %s\n", gf_error_to_string(e) ));
+	} else {
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_CONTAINER, ("[MP4Mux] Reserved %u bytes for moov\n", size));
+	}
+}
+
 GF_Err mp4_mux_process(GF_Filter *filter)
 {
 	GF_MP4MuxCtx *ctx = gf_filter_get_udta(filter);
@@ -5086,6 +5195,10 @@ GF_Err mp4_mux_process(GF_Filter *filter)
 		return e;
 	}
 
+	if ((ctx->store==MP4MX_MODE_FASTSTART) && ctx->moovres && ctx->owns_mov && !ctx->moovres_done) {
+		mp4_mux_setup_moov_reservation(ctx);
+	}
+
 	nb_suspended = 0;
 	for (i=0; i<count; i++) {
 		TrackWriter *tkw = gf_list_get(ctx->tracks, i);
@@ -5208,8 +5321,14 @@ static GF_Err mp4_mux_on_data_patch(void *cbk, u8 *data, u32 block_size, u64 fil
 	memcpy(output, data, block_size);
 	gf_filter_pck_set_framing(pck, GF_FALSE, GF_FALSE);
 	gf_filter_pck_set_seek_flag(pck, GF_TRUE);
-	if (is_insert)
+	if (is_insert) {
 		gf_filter_pck_set_interlaced(pck, 1);
+		if (!ctx->total_bytes_insert || (file_offset < ctx->insert_offset))
+			ctx->insert_offset = file_offset;
+		ctx->total_bytes_insert += block_size;
+	} else {
+		ctx->total_bytes_patch += block_size;
+	}
 	gf_filter_pck_set_byte_offset(pck, file_offset);
 	gf_filter_pck_send(pck);
 	return GF_OK;
@@ -5710,9 +5829,25 @@ static GF_Err mp4_mux_done(GF_Filter *filter, GF_MP4MuxCtx *ctx, Bool is_final)
 		if (e) {
 			GF_LOG(GF_LOG_INFO, GF_LOG_AUTHOR, ("[MP4Mux] Failed to set storage mode: %s\n", gf_error_to_string(e) ));
 		} else {
-			e = gf_isom_close(ctx->file);
+			u32 moov_size=0;
+			Bool in_place=GF_FALSE;
+			e = gf_isom_write(ctx->file);
+			gf_isom_get_moov_reservation_info(ctx->file, &moov_size, &in_place);
+			//flushes remaining output
+			gf_isom_delete(ctx->file);
 			if (e) {
 				GF_LOG(GF_LOG_ERROR, GF_LOG_AUTHOR, ("[MP4Mux] Failed to write file: %s\n", gf_error_to_string(e) ));
+			} else if (ctx->store==MP4MX_MODE_FASTSTART) {
+				u64 out_size = ctx->total_bytes_out + ctx->total_bytes_insert;
+				//inserting requires the output to move all bytes after the insertion point
+				u64 written = out_size + ctx->total_bytes_patch;
+				if (ctx->total_bytes_insert) written += out_size - ctx->insert_offset;
+
+				if (in_place) {
+					GF_LOG(GF_LOG_INFO, GF_LOG_CONTAINER, ("[MP4Mux] moov (%u bytes) written in reserved space - "LLU" bytes written for "LLU" bytes output\n", moov_size, written, out_size));
+				} else {
+					GF_LOG(GF_LOG_INFO, GF_LOG_CONTAINER, ("[MP4Mux] moov inserted before mdat - "LLU" bytes written for "LLU" bytes output\n", written, out_size));
+				}
 			}
 		}
 		ctx->file = NULL;
@@ -5796,6 +5931,10 @@ static const GF_FilterArgs MP4MuxArgs[] =
 	{ OFFS(cdur), "chunk duration for interleaving and fragmentation modes\n"
 	"- 0: no specific interleaving but moov first\n"
 	"- negative: defaults to 1.0 unless overridden by storage profile", GF_PROP_FRACTION, "-1/1", NULL, 0},
+	{ OFFS(moovres), "reserve space for moov before mdat in fstart mode, so that moov is patched in place at the end instead of moving the media data (see filter help)\n"
+	"- 0: disabled\n"
+	"- negative: estimate size from PID durations, frame rates and bitrates\n"
+	"- positive: size in bytes", GF_PROP_SINT, "0", NULL, GF_FS_ARG_HINT_ADVANCED},
 	{ OFFS(moovts), "timescale to use for movie. A negative value picks the media timescale of the first track added", GF_PROP_SINT, "600", NULL, GF_FS_ARG_HINT_ADVANCED},
 	{ OFFS(moof_first), "generate fragments starting with moof then mdat", GF_PROP_BOOL, "true", NULL, GF_FS_ARG_HINT_ADVANCED},
 	{ OFFS(abs_offset), "use absolute file offset in fragments rather than offsets from moof", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_ADVANCED},
@@ -5899,6 +6038,10 @@ GF_FilterRegister MP4MuxRegister = {
 	"# Storage\n"
 	"The [-store]() option allows controling if the file is fragmented ot not, and when not fragmented, how interleaving is done. For cases where disk requirements are tight and fragmentation cannot be used, it is recommended to use either `flat` or `fstart` modes.\n"
 	"  \n"
+	"In `fstart` mode, the moov box is by default inserted before the media data once the file is complete, which requires the output to move all media data. The [-moovres]() option reserves space for the moov box before the media data, using a `free` box. If the final moov box fits in the reserved space, it is written in place and the remaining space is kept as a `free` box, otherwise the moov box is inserted after the reserved space.\n"
+	"When [-moovres]() is negative, the reserved size is estimated from the PID durations, frame rates, sample rates and bitrates; all PIDs must have a known duration.\n"
+	"EX -i source.mp4 -o dst.mp4:store=fstart:moovres=-1\n"
+	"  \n"
 	"The [-vodcache]() option allows controling how DASH onDemand segments are generated:\n"
 	"- If set to `on`, file data is stored to a temporary file on disk and flushed upon completion, no padding is present.\n"
 	"- If set to `insert`, SIDX/SSIX will be injected upon completion of the file by shifting bytes in file. In this case, no padding is required but this might not be compatible with all output sinks and will take longer to write the file.\n"
@@ -108,7 +108,6 @@ typedef struct
 
 	Bool check_pcr;
 	Bool update_mux;
-	char *pack_buffer;
 	u64 nb_pck;
 	Bool init_buffering;
 	u32 last_log_time;
@@ -1356,39 +1355,33 @@ static GF_Err tsmux_process(GF_Filter *filter)
 	}
 
 	nb_pck_in_call = 0;
-	nb_pck_in_pack=0;
 	while (1) {
 		u64 pck_ts;
 		u8 *output;
-		u32 osize;
-		Bool is_pack_flush = GF_FALSE;
-		const char *ts_pck;
 
-		ts_pck = gf_m2ts_mux_process(ctx->mux, &status, &usec_till_next);
-		if (ts_pck == NULL) {
-			if (!nb_pck_in_pack)
-				break;
-			ts_pck = (const char *) ctx->pack_buffer;
-			is_pack_flush = GF_TRUE;
-		} else {
-
-			tsmux_insert_sidx(ctx, GF_FALSE);
+		//packets are produced by the mux directly in the output packet
+		pck = gf_filter_pck_new_alloc(ctx->opid, 188 * ctx->nb_pack, &output);
+		if (!pck) return GF_OUT_OF_MEM;
 
-			if (ctx->nb_pack>1) {
-				memcpy(ctx->pack_buffer + 188 * nb_pck_in_pack, ts_pck, 188);
+		if (ctx->subs_sidx<0) {
+			nb_pck_in_pack = gf_m2ts_mux_process_block(ctx->mux, output, ctx->nb_pack, &status, &usec_till_next);
+		} else {
+			//sidx generation needs the SAP state after each TS packet
+			nb_pck_in_pack = 0;
+			while (nb_pck_in_pack < ctx->nb_pack) {
+				if (!gf_m2ts_mux_process_block(ctx->mux, output + 188 * nb_pck_in_pack, 1, &status, &usec_till_next))
+					break;
 				nb_pck_in_pack++;
-
-				if (nb_pck_in_pack < ctx->nb_pack)
-					continue;
-
-				ts_pck = (const char *) ctx->pack_buffer;
-			} else {
-				nb_pck_in_pack = 1;
+				tsmux_insert_sidx(ctx, GF_FALSE);
 			}
 		}
-		osize = nb_pck_in_pack * 188;
-		pck = gf_filter_pck_new_alloc(ctx->opid, osize, &output);
-		memcpy(output, ts_pck, osize);
+		if (!nb_pck_in_pack) {
+			gf_filter_pck_discard(pck);
+			break;
+		}
+		if (nb_pck_in_pack < ctx->nb_pack)
+			gf_filter_pck_truncate(pck, 188 * nb_pck_in_pack);
+
 		gf_filter_pck_set_framing(pck, ctx->nb_pck ? ctx->next_is_start : GF_TRUE, (status==GF_M2TS_STATE_EOS) ? GF_TRUE : GF_FALSE);
 
 		if (ctx->next_is_start && ctx->dash_mode) {
@@ -1419,9 +1412,9 @@ static GF_Err tsmux_process(GF_Filter *filter)
 		ctx->nb_pck_in_seg += nb_pck_in_pack;
 		ctx->nb_pck_in_file += nb_pck_in_pack;
 		nb_pck_in_call += nb_pck_in_pack;
-		nb_pck_in_pack = 0;
 
-		if (is_pack_flush)
+		//mux has nothing more to produce for now
+		if (nb_pck_in_pack < ctx->nb_pack)
 			break;
 
 		if (status>=GF_M2TS_STATE_PADDING) {
@@ -1529,7 +1522,7 @@ static GF_Err tsmux_initialize(GF_Filter *filter)
 		ctx->init_buffering = GF_TRUE;
 	}
 	ctx->pids = gf_list_new();
-	if (ctx->nb_pack>1) ctx->pack_buffer = gf_malloc(sizeof(char)*188*ctx->nb_pack);
+	if (!ctx->nb_pack) ctx->nb_pack = 1;
 
 #ifdef GPAC_ENABLE_COVERAGE
 	if (gf_sys_is_cov_mode()) {
@@ -1559,7 +1552,6 @@ static void tsmux_finalize(GF_Filter *filter)
 	}
 	gf_list_del(ctx->pids);
 	gf_m2ts_mux_del(ctx->mux);
-	if (ctx->pack_buffer) gf_free(ctx->pack_buffer);
 	if (ctx->sidx_entries) gf_free(ctx->sidx_entries);
 	if (ctx->idx_bs) gf_bs_del(ctx->idx_bs);
 	if (ctx->cur_file_suffix) gf_free(ctx->cur_file_suffix);
@@ -1648,7 +1640,7 @@ static const GF_FilterArgs TSMuxArgs[] =
 	{ OFFS(repeat_rate), "interval in ms between two carousel send for MPEG-4 systems. Is overridden by carousel duration PID property if defined", GF_PROP_UINT, "0", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(repeat_img), "interval in ms between re-sending (as PES) of single-image streams. If 0, image data is sent once only", GF_PROP_UINT, "0", NULL, GF_FS_ARG_HINT_ADVANCED},
 	{ OFFS(max_pcr), "set max interval in ms between 2 PCR", GF_PROP_UINT, "100", NULL, GF_FS_ARG_HINT_ADVANCED},
-	{ OFFS(nb_pack), "pack N TS packets in output packets", GF_PROP_UINT, "4", NULL, 0},
+	{ OFFS(nb_pack), "pack N TS packets in output packets, produced directly by the multiplexer (use 7 to fill a 1316 bytes UDP datagram, higher values reduce overhead for file output)", GF_PROP_UINT, "4", NULL, 0},
 	{ OFFS(pes_pack), "set AU to PES packing mode\n"\
 		"- audio: will pack only multiple audio AUs in a PES\n"\
 		"- none: make exactly one AU per PES\n"\
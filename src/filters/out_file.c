@@ -43,6 +43,8 @@ typedef struct
 	Bool append, dynext, ow, redund;
 	u32 cat;
 	u32 mvbk;
+	Bool aio, direct, atomic;
+	u32 aiobk;
 
 	//only one input pid
 	GF_FilterPid *pid;
@@ -64,6 +66,8 @@ typedef struct
 	GF_FileIO *gfio_ref;
 
 	FILE *hls_chunk;
+	//file is written under a temporary name and renamed when closed
+	char *atomic_name;
 } GF_FileOutCtx;
 
 #ifdef WIN32
@@ -85,6 +89,16 @@ static GF_Err fileout_open_close(GF_FileOutCtx *ctx, const char *filename, const
 		gf_fclose(ctx->file);
 
 		fileout_close_hls_chunk(ctx, GF_FALSE);
+
+		if (ctx->atomic_name) {
+			if (gf_file_replace(ctx->atomic_name, ctx->szFileName)) {
+				GF_LOG(GF_LOG_ERROR, GF_LOG_MMIO, ("[FileOut] failed to rename %s to %s\n", ctx->atomic_name, ctx->szFileName));
+			}
+		}
+	}
+	if (ctx->atomic_name) {
+		gf_free(ctx->atomic_name);
+		ctx->atomic_name = NULL;
 	}
 	ctx->file = NULL;
 
@@ -156,7 +170,24 @@ static GF_Err fileout_open_close(GF_FileOutCtx *ctx, const char *filename, const
 		}
 
 		GF_LOG(GF_LOG_INFO, GF_LOG_MMIO, ("[FileOut] opening output file %s\n", szFinalName));
-		ctx->file = gf_fopen_ex(szFinalName, ctx->original_url, append ? "a+b" : "w+b");
+		//complete file rewritten in one packet (manifests), write it under a temporary name
+		if (ctx->atomic && explicit_overwrite && !append && !ctx->gfio_ref && (url==filename)) {
+			ctx->atomic_name = gf_malloc(strlen(szFinalName) + 7);
+			if (ctx->atomic_name) {
+				sprintf(ctx->atomic_name, "%s.gftmp", szFinalName);
+				ctx->file = gf_fopen(ctx->atomic_name, "w+b");
+				if (!ctx->file) {
+					gf_free(ctx->atomic_name);
+					ctx->atomic_name = NULL;
+				}
+			}
+		}
+		if (!ctx->file) {
+			if (ctx->aio && !append && !ctx->gfio_ref)
+				ctx->file = gf_fopen_aio(szFinalName, "w+b", ctx->aiobk, 0, ctx->direct ? GF_FILE_AIO_DIRECT : 0);
+			else
+				ctx->file = gf_fopen_ex(szFinalName, ctx->original_url, append ? "a+b" : "w+b");
+		}
 
 		if (!strcmp(szFinalName, ctx->szFileName) && !append && ctx->nb_write && !explicit_overwrite) {
 			GF_LOG(GF_LOG_WARNING, GF_LOG_MMIO, ("[FileOut] re-opening in write mode output file %s, content overwrite (use `cat` option to enable append)\n", szFinalName));
@@ -674,6 +705,10 @@ static const GF_FilterArgs FileOutArgs[] =
 	{ OFFS(ow), "overwrite output if existing", GF_PROP_BOOL, "true", NULL, 0},
 	{ OFFS(mvbk), "block size used when moving parts of the file around in patch mode", GF_PROP_UINT, "8192", NULL, 0},
 	{ OFFS(redund), "keep redundant packet in output file", GF_PROP_BOOL, "false", NULL, 0},
+	{ OFFS(aio), "use asynchronous I/O (io_uring, Linux only)", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(aiobk), "block size used for asynchronous writes", GF_PROP_UINT, "1048576", NULL, GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(direct), "bypass system cache (O_DIRECT) for asynchronous writes", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(atomic), "write files sent in a single packet (e.g. manifests) to a temporary file renamed once written, so that readers never see a partial file", GF_PROP_BOOL, "true", NULL, GF_FS_ARG_HINT_ADVANCED},
 
 	{0}
 };
@@ -693,6 +728,10 @@ GF_FilterRegister FileOutRegister = {
 		"In regular mode, the filter only accept pid of type file. It will dump to file incomming packets (stream type file), starting a new file for each packet having a __frame_start__ flag set, unless operating in [-cat]() mode.\n"
 		"The ouput file name can use gpac templating mechanism, see `gpac -h doc`."
 		"The filter watches the property `FileNumber` on incoming packets to create new files.\n"
+		"\n"
+		"On Linux, [-aio]() writes files using io_uring: data is written in blocks of [-aiobk]() bytes, several blocks being written at once. "
+		"When [-direct]() is set, full blocks are written without going through the system cache, which is useful for large sequential outputs. "
+		"Append mode and GF_FileIO destinations always use regular I/O.\n"
 	)
 	.private_size = sizeof(GF_FileOutCtx),
 	.args = FileOutArgs,
@@ -35,6 +35,10 @@
 
 GF_DownloadSession *gf_dm_sess_new_server(GF_Socket *server, void *ssl_ctx, gf_dm_user_io user_io, void *usr_cbk, GF_Err *e);
 GF_Err gf_dm_sess_send(GF_DownloadSession *sess, u8 *data, u32 size);
+GF_Err gf_dm_sess_server_reset(GF_DownloadSession *sess);
+Bool gf_dm_sess_server_has_pending(GF_DownloadSession *sess);
+Bool gf_dm_sess_server_can_send(GF_DownloadSession *sess);
+GF_DownloadSession *gf_dm_sess_server_new_stream(GF_DownloadSession *sess, gf_dm_user_io user_io, void *usr_cbk, GF_Err *e);
 
 #ifdef GPAC_HAS_SSL
 
@@ -59,8 +63,8 @@ typedef struct
 	//options
 	char *dst, *user_agent, *ifce, *cache_control, *ext, *mime, *wdir, *cert, *pkey, *reqlog;
 	GF_PropStringList rdirs;
-	Bool close, hold, quit, post, dlist, ice;
-	u32 port, block_size, maxc, maxp, timeout, hmode, sutc, cors;
+	Bool close, hold, quit, post, dlist, ice, ewait, zcopy, mdisk;
+	u32 port, block_size, maxc, maxp, timeout, hmode, sutc, cors, mcache;
 
 	//internal
 	GF_Filter *filter;
@@ -71,6 +75,15 @@ typedef struct
 	u32 next_wake_us;
 	char *ip;
 	Bool done;
+	//no activity during last process call
+	Bool idle;
+	//a session has data to send but its socket was not writable
+	Bool write_wait;
+	//HTTP/2 requests or frames pending in a session
+	Bool h2_pending;
+	//bytes sent from files using zero-copy and buffered transfers, and from memory cache
+	u64 nb_bytes_zcopy, nb_bytes_buffered, nb_bytes_mem;
+	u64 last_status_bytes;
 
 	GF_SockGroup *sg;
 	Bool no_etag;
@@ -87,8 +100,30 @@ typedef struct
 
 	u64 req_id;
 	Bool log_record;
+
+	//in-memory cache of files produced by inputs, in LRU order (last is most recent)
+	GF_List *cache;
+	u64 cache_size, last_cache_modif;
 } GF_HTTPOutCtx;
 
+//in-memory file produced by an input in server mode
+typedef struct
+{
+	//resource path on server, starting with '/'
+	char *path;
+	char *mime;
+	u8 *data;
+	u32 size, alloc_size;
+	//UTC of file completion in ms, used as ETag and Last-Modified
+	u64 modif_time;
+	//file is complete, data is no longer modified
+	Bool done;
+	//removed from cache, destroyed once no longer used
+	Bool evicted;
+	//number of sessions and inputs using this entry
+	u32 nb_refs;
+} GF_HTTPOutCacheEntry;
+
 typedef struct
 {
 	GF_HTTPOutCtx *ctx;
@@ -114,6 +149,8 @@ typedef struct
 	//for server mode, recording
 	char *local_path;
 	FILE *resource;
+	//for server mode, memory cache entry being written
+	GF_HTTPOutCacheEntry *cache_entry, *hls_chunk_entry;
 
 	FILE *hls_chunk;
 	char *hls_chunk_path, *hls_chunk_local_path;
@@ -136,6 +173,12 @@ typedef struct __httpout_session
 
 	GF_Socket *socket;
 	GF_DownloadSession *http_sess;
+	//HTTP/2 connection session while a response is being sent
+	GF_DownloadSession *h2_sess;
+	//HTTP/2 session owning the connection for sessions serving a single stream, NULL otherwise
+	struct __httpout_session *h2_conn;
+	//number of single stream sessions attached to this HTTP/2 connection
+	u32 nb_h2_streams;
 	char peer_address[GF_MAX_IP_NAME_LEN];
 	void *ssl;
 
@@ -154,6 +197,10 @@ typedef struct __httpout_session
 	Bool is_head;
 	Bool file_in_progress;
 	Bool use_chunk_transfer;
+	//zero-copy not supported for this resource
+	Bool no_zcopy;
+	//resource is sent from memory cache
+	GF_HTTPOutCacheEntry *cache_entry;
 	u32 put_in_progress;
 	//for upload only: 0 not an upload, 1 creation, 2: update
 	u32 upload_type;
@@ -173,10 +220,155 @@ typedef struct __httpout_session
 	u32 method_type, reply_code;
 } GF_HTTPOutSession;
 
+static void httpout_cache_del_entry(GF_HTTPOutCacheEntry *entry)
+{
+	if (entry->data) gf_free(entry->data);
+	if (entry->mime) gf_free(entry->mime);
+	gf_free(entry->path);
+	gf_free(entry);
+}
+
+static void httpout_cache_evict(GF_HTTPOutCtx *ctx, GF_HTTPOutCacheEntry *entry)
+{
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_HTTP, ("[HTTPOut] Evicting %s from memory cache\n", entry->path));
+	gf_list_del_item(ctx->cache, entry);
+	ctx->cache_size -= entry->size;
+	entry->evicted = GF_TRUE;
+	if (!entry->nb_refs)
+		httpout_cache_del_entry(entry);
+}
+
+static void httpout_cache_unref(GF_HTTPOutCacheEntry *entry)
+{
+	assert(entry->nb_refs);
+	entry->nb_refs--;
+	if (!entry->nb_refs && entry->evicted)
+		httpout_cache_del_entry(entry);
+}
+
+static GF_HTTPOutCacheEntry *httpout_cache_find(GF_HTTPOutCtx *ctx, const char *path)
+{
+	u32 i, count = gf_list_count(ctx->cache);
+	//most recent entries are more likely to be requested
+	for (i=count; i>0; i--) {
+		GF_HTTPOutCacheEntry *entry = gf_list_get(ctx->cache, i-1);
+		if (strcmp(entry->path, path)) continue;
+		//move to end of LRU
+		if (i<count) {
+			gf_list_rem(ctx->cache, i-1);
+			gf_list_add(ctx->cache, entry);
+		}
+		return entry;
+	}
+	return NULL;
+}
+
+static void httpout_cache_trim(GF_HTTPOutCtx *ctx)
+{
+	u32 i=0;
+	u64 max_size = ((u64) ctx->mcache) * 1000000;
+	while (ctx->cache_size > max_size) {
+		GF_HTTPOutCacheEntry *entry = gf_list_get(ctx->cache, i);
+		if (!entry) break;
+		//files being written are never evicted
+		if (!entry->done) {
+			i++;
+			continue;
+		}
+		httpout_cache_evict(ctx, entry);
+	}
+}
+
+//creates a new entry for the given path, replacing any previous version - the returned entry is referenced by the caller
+static GF_HTTPOutCacheEntry *httpout_cache_new(GF_HTTPOutCtx *ctx, const char *path, const char *mime)
+{
+	GF_HTTPOutCacheEntry *entry = httpout_cache_find(ctx, path);
+	//sessions still sending the previous version keep it until done
+	if (entry) httpout_cache_evict(ctx, entry);
+
+	GF_SAFEALLOC(entry, GF_HTTPOutCacheEntry);
+	if (!entry) return NULL;
+	entry->path = gf_strdup(path);
+	if (mime) entry->mime = gf_strdup(mime);
+	entry->nb_refs = 1;
+	gf_list_add(ctx->cache, entry);
+	return entry;
+}
+
+static GF_Err httpout_cache_append(GF_HTTPOutCtx *ctx, GF_HTTPOutCacheEntry *entry, const u8 *data, u32 size)
+{
+	if (entry->size + size > entry->alloc_size) {
+		u8 *new_data;
+		u32 new_size = entry->alloc_size ? 2*entry->alloc_size : ctx->block_size;
+		while (new_size < entry->size + size)
+			new_size *= 2;
+		new_data = gf_realloc(entry->data, new_size);
+		//keep current data for sessions still sending it, but remove the incomplete entry from cache
+		if (!new_data) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_HTTP, ("[HTTPOut] Failed to grow memory cache entry %s to %u bytes, evicting\n", entry->path, new_size));
+			if (!entry->evicted)
+				httpout_cache_evict(ctx, entry);
+			return GF_OUT_OF_MEM;
+		}
+		entry->data = new_data;
+		entry->alloc_size = new_size;
+	}
+	memcpy(entry->data + entry->size, data, size);
+	entry->size += size;
+	if (!entry->evicted)
+		ctx->cache_size += size;
+	return GF_OK;
+}
+
+static void httpout_cache_done(GF_HTTPOutCtx *ctx, GF_HTTPOutCacheEntry *entry)
+{
+	u64 now = gf_net_get_utc();
+	//ETag must change for each version of the file
+	if (now <= ctx->last_cache_modif)
+		now = ctx->last_cache_modif + 1;
+	ctx->last_cache_modif = now;
+
+	entry->modif_time = now;
+	entry->done = GF_TRUE;
+	httpout_cache_unref(entry);
+	httpout_cache_trim(ctx);
+}
+
+static void httpout_sess_release_cache(GF_HTTPOutSession *sess)
+{
+	if (!sess->cache_entry) return;
+	httpout_cache_unref(sess->cache_entry);
+	sess->cache_entry = NULL;
+}
+
 static void httpout_reset_socket(GF_HTTPOutSession *sess)
 {
 	if (!sess->socket) return;
 
+	//HTTP/2 stream, only release the stream, the connection is owned by the parent session
+	if (sess->h2_conn) {
+		if (sess->http_sess) gf_dm_sess_del(sess->http_sess);
+		sess->http_sess = NULL;
+		if (sess->h2_sess) gf_dm_sess_del(sess->h2_sess);
+		sess->h2_sess = NULL;
+		sess->h2_conn->nb_h2_streams--;
+		sess->h2_conn = NULL;
+		sess->socket = NULL;
+		sess->ssl = NULL;
+		if (sess->in_source) sess->in_source->nb_dest--;
+		return;
+	}
+	//release all streams before destroying the connection
+	if (sess->nb_h2_streams) {
+		u32 i, count = gf_list_count(sess->ctx->sessions);
+		for (i=0; i<count; i++) {
+			GF_HTTPOutSession *a_sess = gf_list_get(sess->ctx->sessions, i);
+			if (a_sess->h2_conn != sess) continue;
+			a_sess->done = GF_TRUE;
+			httpout_reset_socket(a_sess);
+		}
+	}
+
 	assert(sess->ctx->nb_connections);
 	sess->ctx->nb_connections--;
 
@@ -192,7 +384,7 @@ static void httpout_reset_socket(GF_HTTPOutSession *sess)
 	if (sess->in_source) sess->in_source->nb_dest--;
 }
 
-static void httpout_insert_date(u64 time, char **headers, Bool for_listing)
+static void httpout_insert_date(u64 time, char **headers, Bool for_listing, const char *hdr_name)
 {
 	char szDate[200];
 	time_t gtime;
@@ -235,7 +427,8 @@ static void httpout_insert_date(u64 time, char **headers, Bool for_listing)
 		gf_dynstrcat(headers, szDate, NULL);
 	} else {
 		sprintf(szDate, "%s, %02d %s %d %02d:%02d:%02d GMT", wday, t->tm_mday, month, 1900 + t->tm_year, t->tm_hour, t->tm_min, sec);
-		gf_dynstrcat(headers, "Date: ", NULL);
+		gf_dynstrcat(headers, hdr_name ? hdr_name : "Date", NULL);
+		gf_dynstrcat(headers, ": ", NULL);
 		gf_dynstrcat(headers, szDate, NULL);
 		gf_dynstrcat(headers, "\r\n", NULL);
 	}
@@ -270,7 +463,7 @@ static Bool httpout_dir_file_enum(void *cbck, char *item_name, char *item_path,
 		gf_dynstrcat(listing, " ", NULL);
 	}
 	if (file_info)
-		httpout_insert_date(file_info->last_modified*1000, listing, GF_TRUE);
+		httpout_insert_date(file_info->last_modified*1000, listing, GF_TRUE, NULL);
 
 	if (is_dir || !file_info) {
 		gf_dynstrcat(listing, "    -\n", NULL);
@@ -542,6 +735,12 @@ static Bool httpout_sess_parse_range(GF_HTTPOutSession *sess, char *range)
 GF_Err httpout_sess_send(GF_HTTPOutSession *sess, const u8 *buffer, u32 length)
 {
 	GF_Err e;
+	//HTTP/2, data is sent on the current stream
+	if (sess->h2_sess)
+		return gf_dm_sess_send(sess->h2_sess, (u8 *) buffer, length);
+	if (sess->http_sess && gf_dm_sess_is_h2(sess->http_sess))
+		return gf_dm_sess_send(sess->http_sess, (u8 *) buffer, length);
+
 #ifdef GPAC_HAS_SSL
 	if (sess->ssl) {
 		e = gf_ssl_write(sess->ssl, buffer, length);
@@ -620,6 +819,7 @@ static void httpout_sess_io(void *usr_cbk, GF_NETIO_Parameter *parameter)
 	GF_HTTPOutInput *source_pid = NULL;
 	Bool source_pid_is_ll_hls_chunk = GF_FALSE;
 	GF_HTTPOutSession *source_sess = NULL;
+	GF_HTTPOutCacheEntry *cache_entry = NULL;
 	GF_HTTPOutSession *sess = usr_cbk;
 
 	if (parameter->msg_type != GF_NETIO_PARSE_REPLY) {
@@ -680,6 +880,7 @@ static void httpout_sess_io(void *usr_cbk, GF_NETIO_Parameter *parameter)
 			sess->in_source->nb_dest--;
 			sess->in_source = NULL;
 		}
+		httpout_sess_release_cache(sess);
 		sess->content_length = 0;
 		hdr = gf_dm_sess_get_header(sess->http_sess, "Content-Length");
 		if (hdr) {
@@ -761,10 +962,17 @@ static void httpout_sess_io(void *usr_cbk, GF_NETIO_Parameter *parameter)
 		return;
 	}
 
-	/*first check active inputs*/
+	/*check memory cache*/
+	if (sess->ctx->cache && (parameter->reply != GF_HTTP_DELETE)) {
+		cache_entry = httpout_cache_find(sess->ctx, url);
+		if (cache_entry)
+			full_path = gf_strdup(url);
+	}
+
+	/*then check active inputs*/
 	count = gf_list_count(sess->ctx->inputs);
 	//delete only accepts local files
-	if (parameter->reply == GF_HTTP_DELETE)
+	if ((parameter->reply == GF_HTTP_DELETE) || cache_entry)
 		count = 0;
 
 	for (i=0; i<count; i++) {
@@ -816,7 +1024,7 @@ static void httpout_sess_io(void *usr_cbk, GF_NETIO_Parameter *parameter)
 	}
 
 	//check if request is HEAD or GET on a file being uploaded
-	if (full_path && ((parameter->reply == GF_HTTP_GET) || (parameter->reply == GF_HTTP_HEAD))) {
+	if (full_path && !cache_entry && ((parameter->reply == GF_HTTP_GET) || (parameter->reply == GF_HTTP_HEAD))) {
 		count = gf_list_count(sess->ctx->sessions);
 		for (i=0; i<count; i++) {
 			source_sess = gf_list_get(sess->ctx->sessions, i);
@@ -835,6 +1043,14 @@ static void httpout_sess_io(void *usr_cbk, GF_NETIO_Parameter *parameter)
 	else if (source_sess) {
 		etag = NULL;
 	}
+	//resource is in memory cache, always consider as modified while being written
+	else if (cache_entry) {
+		if (cache_entry->done) {
+			modif_time = cache_entry->modif_time;
+			sprintf(szETag, LLU, modif_time);
+			etag = gf_dm_sess_get_header(sess->http_sess, "If-None-Match");
+		}
+	}
 	//check ETag
 	else if (full_path) {
 		modif_time = gf_file_modification_time(full_path);
@@ -848,8 +1064,10 @@ static void httpout_sess_io(void *usr_cbk, GF_NETIO_Parameter *parameter)
 		sess->in_source->nb_dest--;
 		sess->in_source = NULL;
 	}
+	httpout_sess_release_cache(sess);
 	sess->file_in_progress = GF_FALSE;
 	sess->use_chunk_transfer = GF_FALSE;
+	sess->no_zcopy = GF_FALSE;
 	sess->put_in_progress = 0;
 	sess->nb_bytes = 0;
 	sess->upload_type = 0;
@@ -905,6 +1123,38 @@ static void httpout_sess_io(void *usr_cbk, GF_NETIO_Parameter *parameter)
 		sess->path = full_path;
 		not_modified = GF_TRUE;
 	}
+	/*resource is in memory cache, data is sent from the shared cache entry*/
+	else if (cache_entry) {
+		if (sess->path) gf_free(sess->path);
+		sess->path = full_path;
+		if (sess->resource) gf_fclose(sess->resource);
+		sess->resource = NULL;
+		sess->cache_entry = cache_entry;
+		cache_entry->nb_refs++;
+		//file being written, size is refreshed while sending
+		if (!cache_entry->done) {
+			sess->file_in_progress = GF_TRUE;
+			sess->use_chunk_transfer = GF_TRUE;
+			sess->file_size = 0;
+		} else {
+			sess->file_size = cache_entry->size;
+		}
+		sess->file_pos = 0;
+		sess->bytes_in_req = sess->file_size;
+
+		mime = cache_entry->mime;
+		//probe for mime
+		if (!mime && cache_entry->size) {
+			u8 probe_buf[5001];
+			u32 read = MIN(cache_entry->size, 5000);
+			memcpy(probe_buf, cache_entry->data, read);
+			probe_buf[read] = 0;
+			mime = gf_filter_probe_data(sess->ctx->filter, probe_buf, read);
+		}
+		if (sess->mime) gf_free(sess->mime);
+		sess->mime = ( mime && strcmp(mime, "*")) ? gf_strdup(mime) : NULL;
+		sess->last_file_modif = cache_entry->modif_time;
+	}
 	/*we have the same URL, source file is setup and not modified, no need to resetup - byte-range is setup after */
 	else if (!sess->in_source && sess->resource && (sess->last_file_modif == modif_time) && sess->path && full_path && !strcmp(sess->path, full_path) ) {
 		gf_free(full_path);
@@ -1018,7 +1268,7 @@ static void httpout_sess_io(void *usr_cbk, GF_NETIO_Parameter *parameter)
 	gf_dynstrcat(&rsp_buf, "Server: ", NULL);
 	gf_dynstrcat(&rsp_buf, sess->ctx->user_agent, NULL);
 	gf_dynstrcat(&rsp_buf, "\r\n", NULL);
-	httpout_insert_date(gf_net_get_utc(), &rsp_buf, GF_FALSE);
+	httpout_insert_date(gf_net_get_utc(), &rsp_buf, GF_FALSE, NULL);
 	if (sess->ctx->cors) {
 		gf_dynstrcat(&rsp_buf, "Access-Control-Allow-Origin: *\r\n", NULL);
 		gf_dynstrcat(&rsp_buf, "Access-Control-Expose-Headers: *\r\n", NULL);
@@ -1052,10 +1302,12 @@ static void httpout_sess_io(void *usr_cbk, GF_NETIO_Parameter *parameter)
 	}
 	//for HEAD/GET only
 	else if (!not_modified && (parameter->reply!=GF_HTTP_DELETE) ) {
-		if (!sess->in_source && !sess->ctx->no_etag) {
+		if (!sess->in_source && !sess->ctx->no_etag && (!sess->cache_entry || sess->cache_entry->done)) {
 			gf_dynstrcat(&rsp_buf, "ETag: ", NULL);
 			gf_dynstrcat(&rsp_buf, szETag, NULL);
 			gf_dynstrcat(&rsp_buf, "\r\n", NULL);
+			if (sess->cache_entry)
+				httpout_insert_date(sess->cache_entry->modif_time, &rsp_buf, GF_FALSE, "Last-Modified");
 			if (sess->ctx->cache_control) {
 				gf_dynstrcat(&rsp_buf, "Cache-Control: ", NULL);
 				gf_dynstrcat(&rsp_buf, sess->ctx->cache_control, NULL);
@@ -1231,7 +1483,7 @@ exit:
 	gf_dynstrcat(&rsp_buf, "Server: ", NULL);
 	gf_dynstrcat(&rsp_buf, sess->ctx->user_agent, NULL);
 	gf_dynstrcat(&rsp_buf, "\r\n", NULL);
-	httpout_insert_date(gf_net_get_utc(), &rsp_buf, GF_FALSE);
+	httpout_insert_date(gf_net_get_utc(), &rsp_buf, GF_FALSE, NULL);
 	gf_dynstrcat(&rsp_buf, "Connection: close\r\n", NULL);
 	if (sess->ctx->cors) {
 		gf_dynstrcat(&rsp_buf, "Access-Control-Allow-Origin: *\r\n", NULL);
@@ -1437,7 +1689,8 @@ static GF_Err httpout_configure_pid(GF_Filter *filter, GF_FilterPid *pid, Bool i
 }
 
 
-static void httpout_check_new_session(GF_HTTPOutCtx *ctx)
+//returns GF_FALSE if no more pending connection
+static Bool httpout_check_new_session(GF_HTTPOutCtx *ctx)
 {
 	char peer_address[GF_MAX_IP_NAME_LEN];
 	GF_HTTPOutSession *sess;
@@ -1445,34 +1698,35 @@ static void httpout_check_new_session(GF_HTTPOutCtx *ctx)
 	GF_Socket *new_conn=NULL;
 
 	e = gf_sk_accept(ctx->server_sock, &new_conn);
-	if (e==GF_IP_SOCK_WOULD_BLOCK) return;
+	if ((e==GF_IP_SOCK_WOULD_BLOCK) || (e==GF_IP_NETWORK_EMPTY)) return GF_FALSE;
 	else if (e) {
 		GF_LOG(GF_LOG_ERROR, GF_LOG_HTTP, ("[HTTPOut] Accept failure %s\n", gf_error_to_string(e) ));
-		return;
+		return GF_FALSE;
 	}
 	//check max connections
 	if (ctx->maxc && (ctx->nb_connections>=ctx->maxc)) {
 		GF_LOG(GF_LOG_WARNING, GF_LOG_HTTP, ("[HTTPOut] Connection rejected due to too many connections\n"));
 		gf_sk_del(new_conn);
-		return;
+		return GF_TRUE;
 	}
 	gf_sk_get_remote_address(new_conn, peer_address);
 	if (ctx->maxp) {
 		u32 i, nb_conn=0, count = gf_list_count(ctx->sessions);
 		for (i=0; i<count; i++) {
 			sess = gf_list_get(ctx->sessions, i);
+			if (sess->h2_conn) continue;
 			if (!strcmp(sess->peer_address, peer_address)) nb_conn++;
 		}
 		if (nb_conn>=ctx->maxp) {
 			GF_LOG(GF_LOG_WARNING, GF_LOG_HTTP, ("[HTTPOut] Connection rejected due to too many connections from peer %s\n", peer_address));
 			gf_sk_del(new_conn);
-			return;
+			return GF_TRUE;
 		}
 	}
 	GF_SAFEALLOC(sess, GF_HTTPOutSession);
 	if (!sess) {
 		gf_sk_del(new_conn);
-		return;
+		return GF_FALSE;
 	}
 	
 	sess->socket = new_conn;
@@ -1485,7 +1739,7 @@ static void httpout_check_new_session(GF_HTTPOutCtx *ctx)
 			GF_LOG(GF_LOG_INFO, GF_LOG_HTTP, ("[HTTPOut] Failed to create TLS session from %s: %s\n", sess->peer_address, gf_error_to_string(e) ));
 			gf_free(sess);
 			gf_sk_del(new_conn);
-			return;
+			return GF_TRUE;
 		}
 	}
 #endif
@@ -1495,7 +1749,7 @@ static void httpout_check_new_session(GF_HTTPOutCtx *ctx)
 		gf_sk_del(new_conn);
 		GF_LOG(GF_LOG_INFO, GF_LOG_HTTP, ("[HTTPOut] Failed to create HTTP server session from %s: %s\n", sess->peer_address, gf_error_to_string(e) ));
 		gf_free(sess);
-		return;
+		return GF_TRUE;
 	}
 	ctx->nb_connections++;
 
@@ -1509,6 +1763,7 @@ static void httpout_check_new_session(GF_HTTPOutCtx *ctx)
 
 	GF_LOG(GF_LOG_INFO, GF_LOG_HTTP, ("[HTTPOut] Accepting new connection from %s\n", sess->peer_address));
 	ctx->next_wake_us = 0;
+	return GF_TRUE;
 }
 
 static GF_Err httpout_initialize(GF_Filter *filter)
@@ -1606,6 +1861,12 @@ static GF_Err httpout_initialize(GF_Filter *filter)
 	ctx->active_sessions = gf_list_new();
 	ctx->inputs = gf_list_new();
 	ctx->filter = filter;
+	if (ctx->mcache) {
+		if (ctx->rdirs.nb_items)
+			ctx->cache = gf_list_new();
+		else
+			GF_LOG(GF_LOG_WARNING, GF_LOG_HTTP, ("[HTTPOut] Memory cache is only used in server mode, ignoring\n"));
+	}
 	//used in both server and push modes
 	ctx->sg = gf_sk_group_new();
 
@@ -1654,7 +1915,8 @@ static GF_Err httpout_initialize(GF_Filter *filter)
 
 	ctx->server_sock = gf_sk_new(GF_SOCK_TYPE_TCP);
 	e = gf_sk_bind(ctx->server_sock, NULL, port, ip, 0, GF_SOCK_REUSE_PORT);
-	if (!e) e = gf_sk_listen(ctx->server_sock, ctx->maxc);
+	//backlog of pending connections, not limited by maxc=0
+	if (!e) e = gf_sk_listen(ctx->server_sock, ctx->maxc ? ctx->maxc : 1024);
 	if (e) {
 		GF_LOG(GF_LOG_ERROR, GF_LOG_HTTP, ("[HTTPOut] failed to start server on port %d: %s\n", ctx->port, gf_error_to_string(e) ));
 		return e;
@@ -1674,6 +1936,9 @@ static GF_Err httpout_initialize(GF_Filter *filter)
 
 static void httpout_del_session(GF_HTTPOutSession *s)
 {
+	//streams must be released before their connection
+	if (s->h2_conn || s->nb_h2_streams)
+		httpout_reset_socket(s);
 	gf_list_del_item(s->ctx->active_sessions, s);
 	gf_list_del_item(s->ctx->sessions, s);
 	if (s->socket) gf_sk_del(s->socket);
@@ -1681,15 +1946,27 @@ static void httpout_del_session(GF_HTTPOutSession *s)
 	if (s->path) gf_free(s->path);
 	if (s->mime) gf_free(s->mime);
 	if (s->http_sess) gf_dm_sess_del(s->http_sess);
+	if (s->h2_sess) gf_dm_sess_del(s->h2_sess);
 	if (s->opid) gf_filter_pid_remove(s->opid);
 	if (s->resource) gf_fclose(s->resource);
 	if (s->ranges) gf_free(s->ranges);
+	httpout_sess_release_cache(s);
 	gf_free(s);
 }
 
 static void httpout_close_hls_chunk(GF_HTTPOutCtx *ctx, GF_HTTPOutInput *in, Bool final_flush)
 {
-	if (!in->hls_chunk) return;
+	if (in->hls_chunk_entry) {
+		httpout_cache_done(ctx, in->hls_chunk_entry);
+		in->hls_chunk_entry = NULL;
+	}
+	if (!in->hls_chunk) {
+		if (in->hls_chunk_path) gf_free(in->hls_chunk_path);
+		in->hls_chunk_path = NULL;
+		if (in->hls_chunk_local_path) gf_free(in->hls_chunk_local_path);
+		in->hls_chunk_local_path = NULL;
+		return;
+	}
 
 	gf_fclose(in->hls_chunk);
 	in->hls_chunk = NULL;
@@ -1739,6 +2016,9 @@ static void httpout_finalize(GF_Filter *filter)
 		tmp->opid = NULL;
 		httpout_del_session(tmp);
 	}
+	if (ctx->nb_bytes_zcopy || ctx->nb_bytes_buffered || ctx->nb_bytes_mem) {
+		GF_LOG(GF_LOG_INFO, GF_LOG_HTTP, ("[HTTPOut] Files sent: "LLU" bytes using zero-copy, "LLU" bytes using buffered transfer, "LLU" bytes from memory cache\n", ctx->nb_bytes_zcopy, ctx->nb_bytes_buffered, ctx->nb_bytes_mem));
+	}
 	gf_list_del(ctx->sessions);
 	gf_list_del(ctx->active_sessions);
 
@@ -1751,6 +2031,7 @@ static void httpout_finalize(GF_Filter *filter)
 		httpout_close_hls_chunk(ctx, in, GF_TRUE);
 
 		if (in->resource) gf_fclose(in->resource);
+		if (in->cache_entry) httpout_cache_unref(in->cache_entry);
 		if (in->upload) gf_dm_sess_del(in->upload);
 		if (in->file_deletes) {
 			while (gf_list_count(in->file_deletes)) {
@@ -1762,6 +2043,13 @@ static void httpout_finalize(GF_Filter *filter)
 		gf_free(in);
 	}
 	gf_list_del(ctx->inputs);
+	if (ctx->cache) {
+		while (gf_list_count(ctx->cache)) {
+			GF_HTTPOutCacheEntry *entry = gf_list_last(ctx->cache);
+			httpout_cache_evict(ctx, entry);
+		}
+		gf_list_del(ctx->cache);
+	}
 	if (ctx->server_sock) gf_sk_del(ctx->server_sock);
 	if (ctx->sg) gf_sk_group_del(ctx->sg);
 	if (ctx->ip) gf_free(ctx->ip);
@@ -1836,6 +2124,27 @@ static GF_Err httpout_sess_data_upload(GF_HTTPOutSession *sess, const u8 *data,
 	}
 	return GF_OK;
 }
+//keep alive, prepare the downloader session for the next request
+static GF_Err httpout_sess_next_request(GF_HTTPOutSession *sess)
+{
+	GF_Err e;
+	//HTTP/2 stream sessions only serve a single request, let the caller destroy the session
+	if (sess->h2_conn)
+		return GF_EOS;
+	if (sess->h2_sess) {
+		if (sess->http_sess) gf_dm_sess_del(sess->http_sess);
+		sess->http_sess = sess->h2_sess;
+		sess->h2_sess = NULL;
+	}
+	//HTTP/2 session is kept for the connection lifetime
+	if (sess->http_sess && gf_dm_sess_is_h2(sess->http_sess))
+		return gf_dm_sess_server_reset(sess->http_sess);
+
+	if (sess->http_sess) gf_dm_sess_del(sess->http_sess);
+	sess->http_sess = gf_dm_sess_new_server(sess->socket, sess->ssl, httpout_sess_io, sess, &e);
+	return e;
+}
+
 static void httpout_check_connection(GF_HTTPOutSession *sess)
 {
 	GF_Err e = gf_sk_probe(sess->socket);
@@ -1882,9 +2191,21 @@ static void log_request_done(GF_HTTPOutSession *sess)
 	}
 }
 
+static void httpout_update_status(GF_HTTPOutCtx *ctx)
+{
+	char szStatus[200];
+	u64 tot_bytes = ctx->nb_bytes_zcopy + ctx->nb_bytes_buffered + ctx->nb_bytes_mem;
+	if (ctx->last_status_bytes == tot_bytes)
+		return;
+	ctx->last_status_bytes = tot_bytes;
+	sprintf(szStatus, "files sent: zero-copy "LLU" bytes - buffered "LLU" bytes - memory "LLU" bytes", ctx->nb_bytes_zcopy, ctx->nb_bytes_buffered, ctx->nb_bytes_mem);
+	gf_filter_update_status(ctx->filter, -1, szStatus);
+}
+
 static void httpout_process_session(GF_Filter *filter, GF_HTTPOutCtx *ctx, GF_HTTPOutSession *sess)
 {
 	u32 read;
+	const u8 *data;
 	u64 to_read=0;
 	GF_Err e = GF_OK;
 	Bool close_session = ctx->close;
@@ -1963,7 +2284,7 @@ static void httpout_process_session(GF_Filter *filter, GF_HTTPOutCtx *ctx, GF_HT
 		gf_dynstrcat(&rsp_buf, "Server: ", NULL);
 		gf_dynstrcat(&rsp_buf, sess->ctx->user_agent, NULL);
 		gf_dynstrcat(&rsp_buf, "\r\n", NULL);
-		httpout_insert_date(gf_net_get_utc(), &rsp_buf, GF_FALSE);
+		httpout_insert_date(gf_net_get_utc(), &rsp_buf, GF_FALSE, NULL);
 		if (close_session)
 			gf_dynstrcat(&rsp_buf, "Connection: close\r\n", NULL);
 		else
@@ -2016,8 +2337,7 @@ static void httpout_process_session(GF_Filter *filter, GF_HTTPOutCtx *ctx, GF_HT
 			httpout_reset_socket(sess);
 		} else {
 			//we keep alive, recreate a dm session
-			if (sess->http_sess) gf_dm_sess_del(sess->http_sess);
-			sess->http_sess = gf_dm_sess_new_server(sess->socket, sess->ssl, httpout_sess_io, sess, &e);
+			e = httpout_sess_next_request(sess);
 			if (e) {
 				httpout_reset_socket(sess);
 			}
@@ -2026,10 +2346,17 @@ static void httpout_process_session(GF_Filter *filter, GF_HTTPOutCtx *ctx, GF_HT
 	}
 	//read request and process headers
 	else if (sess->http_sess) {
-		if (!gf_sk_group_sock_is_set(ctx->sg, sess->socket, GF_SK_SELECT_READ)) {
+		//HTTP/2 requests may already be buffered
+		Bool is_h2 = gf_dm_sess_is_h2(sess->http_sess);
+		if (!is_h2 && !gf_sk_group_sock_is_set(ctx->sg, sess->socket, GF_SK_SELECT_READ)) {
 			return;
 		}
 		e = gf_dm_sess_process(sess->http_sess);
+		//session may have switched to HTTP/2 during processing
+		is_h2 = gf_dm_sess_is_h2(sess->http_sess);
+		//no pending request on HTTP/2 connection, or HTTP/2 preface not completely received
+		if (e==GF_IP_NETWORK_EMPTY)
+			return;
 
 		if (e<0) {
 			GF_LOG(GF_LOG_INFO, GF_LOG_HTTP, ("[HTTPOut] Connection to %s closed: %s\n", sess->peer_address, gf_error_to_string(e) ));
@@ -2046,7 +2373,12 @@ static void httpout_process_session(GF_Filter *filter, GF_HTTPOutCtx *ctx, GF_HT
 		//otherwise we use the session to parse transfered data
 		if (!sess->upload_type) {
 			//no support for request pipeline yet, just remove the downloader session until done
-			gf_dm_sess_del(sess->http_sess);
+			//the HTTP/2 session is kept to send the response
+			if (is_h2) {
+				sess->h2_sess = sess->http_sess;
+			} else {
+				gf_dm_sess_del(sess->http_sess);
+			}
 			sess->http_sess = NULL;
 			if (sess->done && sess->socket && (e!=GF_IP_NETWORK_EMPTY) )
 				goto session_done;
@@ -2062,10 +2394,11 @@ static void httpout_process_session(GF_Filter *filter, GF_HTTPOutCtx *ctx, GF_HT
 	if (sess->in_source && !sess->in_source->resource) return;
 
 	if (!gf_sk_group_sock_is_set(ctx->sg, sess->socket, GF_SK_SELECT_WRITE)) {
+		ctx->write_wait = GF_TRUE;
 		return;
 	}
 	//resource is not set
-	if (!sess->resource && sess->path) {
+	if (!sess->resource && sess->path && !sess->cache_entry) {
 		if (sess->in_source && !sess->in_source->nb_write) {
 			sess->last_active_time = gf_sys_clock_high_res();
 			return;
@@ -2081,8 +2414,15 @@ static void httpout_process_session(GF_Filter *filter, GF_HTTPOutCtx *ctx, GF_HT
 		sess->file_size = gf_fsize(sess->resource);
 		gf_fseek(sess->resource, sess->file_pos, SEEK_SET);
 	}
+	//refresh size of file being written in memory cache
+	if (sess->cache_entry) {
+		sess->file_size = sess->cache_entry->size;
+		if (sess->cache_entry->done)
+			sess->file_in_progress = GF_FALSE;
+	}
 
 resend:
+	to_read = 0;
 
 	//we have ranges
 	if (sess->nb_ranges) {
@@ -2092,7 +2432,8 @@ resend:
 			if (sess->range_idx+1<sess->nb_ranges) {
 				sess->range_idx++;
 				sess->file_pos = (u64) sess->ranges[sess->range_idx].start;
-				gf_fseek(sess->resource, sess->file_pos, SEEK_SET);
+				if (sess->resource)
+					gf_fseek(sess->resource, sess->file_pos, SEEK_SET);
 			}
 		}
 		if (sess->range_idx<sess->nb_ranges) {
@@ -2103,16 +2444,53 @@ resend:
 	}
 
 	if (to_read) {
+		//HTTP/2 stream has enough data queued, wait for the peer to consume it
+		if (sess->h2_sess && !gf_dm_sess_server_can_send(sess->h2_sess)) {
+			sess->last_active_time = gf_sys_clock_high_res();
+			return;
+		}
 		ctx->next_wake_us = 0;
 
+		//plain HTTP without chunk transfer, send directly from file without copy to user space
+		if (ctx->zcopy && !sess->ssl && !sess->h2_sess && !sess->use_chunk_transfer && !sess->no_zcopy && !sess->cache_entry) {
+			if (to_read > (u64) sess->ctx->block_size)
+				to_read = (u64) sess->ctx->block_size;
+
+			e = gf_sk_send_file(sess->socket, sess->resource, sess->file_pos, (u32) to_read, &read);
+			if (e != GF_NOT_SUPPORTED) {
+				//may happen when file writing is in progress
+				if (!read && !e) {
+					sess->last_active_time = gf_sys_clock_high_res();
+					return;
+				}
+				//socket buffer full, retry at next process
+				if (e==GF_IP_SOCK_WOULD_BLOCK)
+					e = GF_OK;
+				ctx->nb_bytes_zcopy += read;
+				goto data_sent;
+			}
+			GF_LOG(GF_LOG_DEBUG, GF_LOG_HTTP, ("[HTTPOut] zero-copy not available for %s, using buffered transfer\n", sess->path));
+			sess->no_zcopy = GF_TRUE;
+			e = GF_OK;
+			//sendfile does not move the file position, previous zero-copy transfers may have sent data past it
+			gf_fseek(sess->resource, sess->file_pos, SEEK_SET);
+		}
+
 		if (to_read > (u64) sess->ctx->block_size)
 			to_read = (u64) sess->ctx->block_size;
 
-		read = (u32) gf_fread(sess->buffer, (u32) to_read, sess->resource);
-		//may happen when file writing is in progress
-		if (!read) {
-			sess->last_active_time = gf_sys_clock_high_res();
-			return;
+		if (sess->cache_entry) {
+			//send directly from cache memory, entry data is only appended while in progress
+			data = sess->cache_entry->data + sess->file_pos;
+			read = (u32) to_read;
+		} else {
+			read = (u32) gf_fread(sess->buffer, (u32) to_read, sess->resource);
+			//may happen when file writing is in progress
+			if (!read) {
+				sess->last_active_time = gf_sys_clock_high_res();
+				return;
+			}
+			data = sess->buffer;
 		}
 		//transfer of file being uploaded, use chunk transfer
 		if (sess->use_chunk_transfer) {
@@ -2122,11 +2500,17 @@ resend:
 			len = (u32) strlen(szHdr);
 
 			e = httpout_sess_send(sess, szHdr, len);
-			e |= httpout_sess_send(sess, sess->buffer, read);
+			e |= httpout_sess_send(sess, data, read);
 			e |= httpout_sess_send(sess, "\r\n", 2);
 		} else {
-			e = httpout_sess_send(sess, sess->buffer, read);
+			e = httpout_sess_send(sess, data, read);
 		}
+		if (sess->cache_entry)
+			ctx->nb_bytes_mem += read;
+		else
+			ctx->nb_bytes_buffered += read;
+
+data_sent:
 		sess->last_active_time = gf_sys_clock_high_res();
 
 		sess->file_pos += read;
@@ -2144,7 +2528,8 @@ resend:
 		} else {
 			GF_LOG(GF_LOG_DEBUG, GF_LOG_HTTP, ("[HTTPOut] sending data to %s for %s: "LLU"/"LLU" bytes\n", sess->peer_address, sess->path, sess->nb_bytes, sess->bytes_in_req));
 
-			if (gf_sk_select(sess->socket, GF_SK_SELECT_WRITE)==GF_OK) {
+			//HTTP/2 streams send one block per call so that all responses on the connection progress
+			if (!sess->h2_sess && (gf_sk_select(sess->socket, GF_SK_SELECT_WRITE)==GF_OK)) {
 				goto resend;
 			}
 		}
@@ -2158,6 +2543,7 @@ resend:
 
 	if (!sess->is_head) {
 		GF_LOG(GF_LOG_INFO, GF_LOG_HTTP, ("[HTTPOut] Done sending %s to %s ("LLU"/"LLU" bytes)\n", sess->path, sess->peer_address, sess->nb_bytes, sess->bytes_in_req));
+		httpout_update_status(ctx);
 	}
 
 	log_request_done(sess);
@@ -2178,6 +2564,7 @@ session_done:
 		}
 		if (sess->resource) gf_fclose(sess->resource);
 		sess->resource = NULL;
+		httpout_sess_release_cache(sess);
 		//keep resource active
 		sess->done = GF_TRUE;
 		if (sess->ctx->quit)
@@ -2189,7 +2576,7 @@ session_done:
 	//might be NULL if quit was set
 	else if (sess->socket) {
 		//we keep alive, recreate an dm sess
-		sess->http_sess = gf_dm_sess_new_server(sess->socket, sess->ssl, httpout_sess_io, sess, &e);
+		e = httpout_sess_next_request(sess);
 		if (e) {
 			httpout_reset_socket(sess);
 		}
@@ -2219,7 +2606,7 @@ static Bool httpout_open_input(GF_HTTPOutCtx *ctx, GF_HTTPOutInput *in, const ch
 		len = (u32) strlen(dir);
 		if (!len) return GF_FALSE;
 
-        if (in->resource) return GF_FALSE;
+        if (in->resource || in->cache_entry) return GF_FALSE;
     }
 
     sep = name ? strstr(name, "://") : NULL;
@@ -2307,6 +2694,15 @@ static Bool httpout_open_input(GF_HTTPOutCtx *ctx, GF_HTTPOutInput *in, const ch
 	//file delete is async (the resource associated with the input can still be active)
 	if (is_delete) {
 		char *loc_path = NULL;
+		if (ctx->cache) {
+			GF_HTTPOutCacheEntry *entry = httpout_cache_find(ctx, sep);
+			if (entry) httpout_cache_evict(ctx, entry);
+			//files not written to disk
+			if (!ctx->mdisk) {
+				if (o_url) gf_free(o_url);
+				return GF_TRUE;
+			}
+		}
 		gf_dynstrcat(&loc_path, dir, NULL);
 		if (!strchr("/\\", dir[len-1]))
 			gf_dynstrcat(&loc_path, "/", NULL);
@@ -2335,8 +2731,14 @@ static Bool httpout_open_input(GF_HTTPOutCtx *ctx, GF_HTTPOutInput *in, const ch
 
 	httpout_set_local_path(ctx, in);
 
+	if (ctx->cache) {
+		in->cache_entry = httpout_cache_new(ctx, in->path, in->mime);
+		if (!ctx->mdisk)
+			return GF_TRUE;
+	}
+
 	in->resource = gf_fopen(in->local_path, "wb");
-	if (!in->resource)
+	if (!in->resource && !in->cache_entry)
 		in->is_open = GF_FALSE;
 	return GF_TRUE;
 }
@@ -2370,6 +2772,12 @@ static void httpout_close_input(GF_HTTPOutCtx *ctx, GF_HTTPOutInput *in)
 			GF_LOG(GF_LOG_INFO, GF_LOG_ALL, ("[HTTPOut] Closing output file %s\n", in->local_path ? in->local_path : in->path));
 		}
 
+		if (in->cache_entry) {
+			httpout_close_hls_chunk(ctx, in, GF_FALSE);
+			httpout_cache_done(ctx, in->cache_entry);
+			in->cache_entry = NULL;
+		}
+
 		if (in->resource) {
 			assert(in->local_path);
 			//close all LL-HLS chunks before closing session
@@ -2459,6 +2867,18 @@ retry:
 				gf_fflush(in->hls_chunk);
 			}
 		}
+		if (in->cache_entry) {
+			if (!in->resource) out = pck_size;
+			//entries which cannot grow are closed so that sessions sending them terminate
+			if (httpout_cache_append(ctx, in->cache_entry, pck_data, pck_size) != GF_OK) {
+				httpout_cache_done(ctx, in->cache_entry);
+				in->cache_entry = NULL;
+			}
+			if (in->hls_chunk_entry && (httpout_cache_append(ctx, in->hls_chunk_entry, pck_data, pck_size) != GF_OK)) {
+				httpout_cache_done(ctx, in->hls_chunk_entry);
+				in->hls_chunk_entry = NULL;
+			}
+		}
 
 		for (i=0; i<count; i++) {
 			GF_HTTPOutSession *sess = gf_list_get(ctx->active_sessions, i);
@@ -2512,7 +2932,11 @@ static Bool httpout_input_write_ready(GF_HTTPOutCtx *ctx, GF_HTTPOutInput *in)
 		GF_HTTPOutSession *sess = gf_list_get(ctx->active_sessions, i);
 		if (sess->in_source != in) continue;
 
-		if (!sess->file_in_progress && !gf_sk_group_sock_is_set(ctx->sg, sess->socket, GF_SK_SELECT_WRITE))
+		if (!sess->file_in_progress && !gf_sk_group_sock_is_set(ctx->sg, sess->socket, GF_SK_SELECT_WRITE)) {
+			ctx->write_wait = GF_TRUE;
+			return GF_FALSE;
+		}
+		if (sess->h2_sess && !gf_dm_sess_server_can_send(sess->h2_sess))
 			return GF_FALSE;
 	}
 	return count ? GF_TRUE : GF_FALSE;
@@ -2635,14 +3059,17 @@ static void httpout_process_inputs(GF_HTTPOutCtx *ctx)
 		}
 
 		p = gf_filter_pck_get_property(pck, GF_PROP_PCK_HLS_FRAG_NUM);
-		if (p && in->resource) {
+		if (p && (in->resource || in->cache_entry)) {
 			char szHLSChunk[GF_MAX_PATH];
 			snprintf(szHLSChunk, GF_MAX_PATH-1, "%s.%d", in->local_path, p->value.uint);
 			httpout_close_hls_chunk(ctx, in, GF_FALSE);
-			in->hls_chunk = gf_fopen(szHLSChunk, "w+b");
+			if (in->resource)
+				in->hls_chunk = gf_fopen(szHLSChunk, "w+b");
 			in->hls_chunk_local_path = gf_strdup(szHLSChunk);
 			snprintf(szHLSChunk, GF_MAX_PATH-1, "%s.%d", in->path, p->value.uint);
 			in->hls_chunk_path = gf_strdup(szHLSChunk);
+			if (in->cache_entry)
+				in->hls_chunk_entry = httpout_cache_new(ctx, in->hls_chunk_path, in->mime);
 		}
 
 		//no destination and not holding packets (either first connection not here or disabled), trash packet
@@ -2656,7 +3083,7 @@ static void httpout_process_inputs(GF_HTTPOutCtx *ctx)
 		}
 
 		pck_data = gf_filter_pck_get_data(pck, &pck_size);
-		if (in->upload || ctx->single_mode || in->resource) {
+		if (in->upload || ctx->single_mode || in->resource || in->cache_entry) {
 			GF_FilterFrameInterface *hwf = gf_filter_pck_get_frame_interface(pck);
 			if (pck_data && pck_size) {
 
@@ -2765,6 +3192,31 @@ static void httpout_process_inputs(GF_HTTPOutCtx *ctx)
 		ctx->next_wake_us = 0;
 }
 
+static void httpout_h2_new_streams(GF_HTTPOutCtx *ctx, GF_HTTPOutSession *sess)
+{
+	while (1) {
+		GF_Err e;
+		GF_HTTPOutSession *st_sess;
+		GF_SAFEALLOC(st_sess, GF_HTTPOutSession);
+		if (!st_sess) return;
+		st_sess->http_sess = gf_dm_sess_server_new_stream(sess->h2_sess, httpout_sess_io, st_sess, &e);
+		if (!st_sess->http_sess) {
+			gf_free(st_sess);
+			return;
+		}
+		st_sess->ctx = ctx;
+		st_sess->socket = sess->socket;
+		st_sess->ssl = sess->ssl;
+		st_sess->h2_conn = sess;
+		strcpy(st_sess->peer_address, sess->peer_address);
+		sess->nb_h2_streams++;
+		//processed after the current sessions, giving each response a turn
+		gf_list_add(ctx->sessions, st_sess);
+		gf_list_add(ctx->active_sessions, st_sess);
+		ctx->next_wake_us = 0;
+	}
+}
+
 static GF_Err httpout_process(GF_Filter *filter)
 {
 	GF_Err e=GF_OK;
@@ -2777,11 +3229,21 @@ static GF_Err httpout_process(GF_Filter *filter)
 	//wakeup every 50ms when inactive
 	ctx->next_wake_us = 50000;
 
-	e = gf_sk_group_select(ctx->sg, 10, GF_SK_SELECT_BOTH);
-	if ((e==GF_OK) && ctx->server_sock) {
+	//nothing happened since last call and nothing else to schedule, wait for incoming data rather than polling
+	//also wait for write readiness if a session could not send its data
+	if (ctx->ewait && ctx->idle && !ctx->h2_pending && ctx->server_sock && gf_filter_is_last_task(filter)) {
+		e = gf_sk_group_select(ctx->sg, ctx->next_wake_us, ctx->write_wait ? GF_SK_SELECT_BOTH : GF_SK_SELECT_READ);
+	} else {
+		e = gf_sk_group_select(ctx->sg, 10, GF_SK_SELECT_BOTH);
+	}
+	//HTTP/2 sessions may have requests or frames buffered, process them even if no socket event
+	if (((e==GF_OK) || ctx->h2_pending) && ctx->server_sock) {
+		ctx->h2_pending = GF_FALSE;
+		ctx->write_wait = GF_FALSE;
 		//server mode, check pending connections
-		if (gf_sk_group_sock_is_set(ctx->sg, ctx->server_sock, GF_SK_SELECT_READ)) {
-			httpout_check_new_session(ctx);
+		if ((e==GF_OK) && gf_sk_group_sock_is_set(ctx->sg, ctx->server_sock, GF_SK_SELECT_READ)) {
+			//accept all pending connections, readiness may only be signaled once for several connections
+			while (httpout_check_new_session(ctx)) { }
 		}
 
 		count = gf_list_count(ctx->active_sessions);
@@ -2799,8 +3261,17 @@ static GF_Err httpout_process(GF_Filter *filter)
 				count--;
 				if (!count && ctx->quit)
 					ctx->done = GF_TRUE;
+				continue;
+			}
+			if (gf_dm_sess_server_has_pending(sess->h2_sess ? sess->h2_sess : sess->http_sess)) {
+				ctx->h2_pending = GF_TRUE;
+				//HTTP/2 connection busy with a response, serve other requests in parallel
+				if (sess->h2_sess && !sess->h2_conn)
+					httpout_h2_new_streams(ctx, sess);
 			}
 		}
+		if (ctx->h2_pending)
+			ctx->next_wake_us = 0;
 	}
 
 	httpout_process_inputs(ctx);
@@ -2830,6 +3301,11 @@ static GF_Err httpout_process(GF_Filter *filter)
 		e=GF_OK;
 	}
 
+	ctx->idle = ctx->next_wake_us ? GF_TRUE : GF_FALSE;
+	//idle and nothing else scheduled, recall us right away to block on socket events
+	if (ctx->idle && ctx->ewait && ctx->server_sock && gf_filter_is_last_task(filter))
+		ctx->next_wake_us = 1;
+
 	if (ctx->next_wake_us)
 		gf_filter_ask_rt_reschedule(filter, ctx->next_wake_us);
 
@@ -2925,6 +3401,10 @@ static const GF_FilterArgs HTTPOutArgs[] =
 	{ OFFS(cors), "insert CORS header allowing all domains", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(reqlog), "provide short log of the requests indicated in this option (comma separated list, `*` for all) regardless of HTTP log settings. Value `REC`logs file writing start/end", GF_PROP_STRING, NULL, NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(ice), "insert ICE meta-data in response headers in sink mode - see filter help", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(ewait), "when idle and no other task is pending in the session, wait for socket events instead of polling sockets every 50ms", GF_PROP_BOOL, "true", NULL, GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(zcopy), "use zero-copy transfer (sendfile/splice) when sending files over plain HTTP", GF_PROP_BOOL, "true", NULL, GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(mcache), "maximum size in MB of memory cache for files produced by inputs in server mode, 0 disables the cache - see filter help", GF_PROP_UINT, "0", NULL, GF_FS_ARG_HINT_ADVANCED},
+	{ OFFS(mdisk), "also write files produced by inputs to disk when memory cache is used", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_EXPERT},
 	{0}
 };
 
@@ -2951,6 +3431,11 @@ GF_FilterRegister HTTPOutRegister = {
 		"When multiple read directories are specified, the server root `/` contains the list of the mount points with their directory names.\n"
 		"When a write directory is specified, the upload resource name identifies a file in this directory (the write directory name is not present in the URL).\n"
 		"  \n"
+		"On Linux, client sockets are monitored using epoll, allowing large number of concurrent persistent connections (use [-maxc]()=0 and [-maxp]()=0 to remove connection limits). The `-no-epoll` option can be used to revert to select().\n"
+		"Files served over plain HTTP are sent using zero-copy (sendfile/splice) when supported, see [-zcopy](). TLS sessions and chunk transfers of files being written use buffered transfer.\n"
+		"  \n"
+		"When GPAC is built with HTTP/2 support, clients using HTTP/2 with prior knowledge (h2c) or negotiating it through TLS ALPN are accepted, unless `-no-h2` is set. Requests on an HTTP/2 connection are served one at a time in arrival order, without zero-copy transfer.\n"
+		"  \n"
 		"Listing can be enabled on server using [-dlist]().\n"
 		"When disabled, a GET on a directory will fail.\n"
 		"When enabled, a GET on a directory will return a simple HTML listing of the content inspired from Apache.\n"
@@ -2994,6 +3479,11 @@ GF_FilterRegister HTTPOutRegister = {
 		"EX gpac -i SOURCE reframer:rt=on @ -o http://localhost:8080/live.mpd --rdirs=temp --dmode=dynamic --cdur=0.1\n"
 		"In this example, a real-time dynamic DASH session with chunks of 100ms is created, outputting files in `temp`. A client connecting to the live edge will receive segments as they are produced using HTTP chunk transfer.\n"
 		"  \n"
+		"When [-mcache]() is set, files produced by inputs are kept in memory instead of being written to disk (unless [-mdisk]() is set), and served from memory, including while being produced.\n"
+		"Cached files are removed when deleted by the source (e.g. segments leaving the DASH timeshift buffer) or replaced by a new version (e.g. manifest update), and least recently used files are evicted when the cache size exceeds [-mcache]().\n"
+		"EX gpac -i SOURCE reframer:rt=on @ -o http://localhost:8080/live.mpd --rdirs=temp --dmode=dynamic --cdur=0.1 --tsb=10 --mcache=100\n"
+		"In this example, the same DASH session is served from memory, with segments available for 10 seconds and at most 100 MB of memory used.\n"
+		"  \n"
 		"# HTTP client sink\n"
 		"In this mode, the filter will upload input PIDs data to remote server using PUT (or POST if [-post]() is set).\n"
 		"This mode must be explicitly activated using [-hmode]().\n"
@@ -41,7 +41,7 @@ enum
 typedef struct
 {
 	char *dst, *ext, *mime, *ifce, *ip;
-	u32 carousel, first_port, bsid, mtu, splitlct, ttl, brinc, runfor;
+	u32 carousel, first_port, bsid, mtu, splitlct, ttl, brinc, runfor, batch;
 	Bool korean, llmode, noreg;
 
 	GF_FilterCapability in_caps[2];
@@ -62,7 +62,13 @@ typedef struct
 	u32 lls_slt_table_len;
 
 	u64 bytes_sent;
+	//one MTU per packet in batch
 	u8 *lct_buffer;
+	//LCT packets pending for the socket of the current batch
+	GF_SockDatagram *dgrams;
+	GF_Socket *batch_sock;
+	u32 nb_batch;
+	u64 nb_send_calls, nb_send_pck;
 
 	u64 reschedule_us;
 	u32 next_raw_file_toi;
@@ -616,7 +622,11 @@ static GF_Err routeout_initialize(GF_Filter *filter)
 		gf_sk_setup_multicast(ctx->sock_atsc_lls, GF_ATSC_MCAST_ADDR, GF_ATSC_MCAST_PORT, 0, GF_FALSE, ctx->ifce);
 	}
 
-	ctx->lct_buffer = gf_malloc(sizeof(u8) * ctx->mtu);
+	if (!ctx->batch) ctx->batch = 1;
+	else if (ctx->batch>GF_SK_MAX_BATCH) ctx->batch = GF_SK_MAX_BATCH;
+	ctx->lct_buffer = gf_malloc(sizeof(u8) * ctx->mtu * ctx->batch);
+	ctx->dgrams = gf_malloc(sizeof(GF_SockDatagram) * ctx->batch);
+	if (!ctx->lct_buffer || !ctx->dgrams) return GF_OUT_OF_MEM;
 	ctx->clock_init = gf_sys_clock_high_res();
 	ctx->clock_stats = ctx->clock_init;
 
@@ -627,6 +637,8 @@ static GF_Err routeout_initialize(GF_Filter *filter)
 	return GF_OK;
 }
 
+static void routeout_flush_batch(GF_ROUTEOutCtx *ctx);
+
 static void routeout_finalize(GF_Filter *filter)
 {
 	GF_ROUTEOutCtx *ctx;
@@ -636,6 +648,7 @@ static void routeout_finalize(GF_Filter *filter)
 
 	ctx = (GF_ROUTEOutCtx *) gf_filter_get_udta(filter);
 
+	routeout_flush_batch(ctx);
 	while (gf_list_count(ctx->services)) {
 		routeout_delete_service(gf_list_pop_back(ctx->services));
 	}
@@ -644,6 +657,7 @@ static void routeout_finalize(GF_Filter *filter)
 		gf_sk_del(ctx->sock_atsc_lls);
 
 	if (ctx->lct_buffer) gf_free(ctx->lct_buffer);
+	if (ctx->dgrams) gf_free(ctx->dgrams);
 	if (ctx->lls_slt_table) gf_free(ctx->lls_slt_table);
 	if (ctx->lls_time_table) gf_free(ctx->lls_time_table);
 }
@@ -1133,13 +1147,33 @@ static GF_Err routeout_check_service_updates(GF_ROUTEOutCtx *ctx, ROUTEService *
 }
 
 
+static void routeout_flush_batch(GF_ROUTEOutCtx *ctx)
+{
+	GF_Err e;
+	u32 nb_sent = 0;
+	if (!ctx->nb_batch) return;
+
+	e = gf_sk_send_batch(ctx->batch_sock, ctx->dgrams, ctx->nb_batch, &nb_sent);
+	if (e) {
+		u32 i;
+		GF_LOG(GF_LOG_ERROR, GF_LOG_ROUTE, ("[ROUTE] Failed to send %u LCT packets: %s\n", ctx->nb_batch - nb_sent, gf_error_to_string(e) ));
+		//dropped packets are not accounted in mux rate
+		for (i=nb_sent; i<ctx->nb_batch; i++)
+			ctx->bytes_sent -= ctx->dgrams[i].size;
+	}
+	ctx->nb_send_calls++;
+	ctx->nb_send_pck += nb_sent;
+	ctx->nb_batch = 0;
+	ctx->batch_sock = NULL;
+}
+
 u32 routeout_lct_send(GF_ROUTEOutCtx *ctx, GF_Socket *sock, u32 tsi, u32 toi, u32 codepoint, u8 *payload, u32 len, u32 offset, u32 service_id, u32 total_size, u32 offset_in_frame)
 {
 	u32 max_size = ctx->mtu;
 	u32 send_payl_size;
 	u32 hdr_len = 4;
 	u32 hpos;
-	GF_Err e;
+	u8 *buf;
 
 	if (total_size) {
 		//TOL extension
@@ -1147,6 +1181,11 @@ u32 routeout_lct_send(GF_ROUTEOutCtx *ctx, GF_Socket *sock, u32 tsi, u32 toi, u3
 		else hdr_len += 2;
 	}
 
+	//socket change or batch full, send pending packets
+	if (ctx->nb_batch && ((ctx->batch_sock != sock) || (ctx->nb_batch == ctx->batch)))
+		routeout_flush_batch(ctx);
+	buf = ctx->lct_buffer + ctx->nb_batch * ctx->mtu;
+
 	//start offset is not in header
 	send_payl_size = 4 * (hdr_len+1) + len - offset;
 	if (send_payl_size > max_size) {
@@ -1154,21 +1193,21 @@ u32 routeout_lct_send(GF_ROUTEOutCtx *ctx, GF_Socket *sock, u32 tsi, u32 toi, u3
 	} else {
 		send_payl_size = len - offset;
 	}
-	ctx->lct_buffer[0] = 0x12; //V=b0001, C=b00, PSI=b10
-	ctx->lct_buffer[1] = 0xA0; //S=b1, 0=b01, h=b0, res=b00, A=b0, B=X
+	buf[0] = 0x12; //V=b0001, C=b00, PSI=b10
+	buf[1] = 0xA0; //S=b1, 0=b01, h=b0, res=b00, A=b0, B=X
 	//set close flag only if total_len is known
 	if (total_size && (offset + send_payl_size == len))
-		ctx->lct_buffer[1] |= 1;
+		buf[1] |= 1;
 
-	ctx->lct_buffer[2] = hdr_len;
-	ctx->lct_buffer[3] = (u8) codepoint;
+	buf[2] = hdr_len;
+	buf[3] = (u8) codepoint;
 	hpos = 4;
 
 #define PUT_U32(_val)\
-	ctx->lct_buffer[hpos] = (_val>>24 & 0xFF);\
-	ctx->lct_buffer[hpos+1] = (_val>>16 & 0xFF);\
-	ctx->lct_buffer[hpos+2] = (_val>>8 & 0xFF);\
-	ctx->lct_buffer[hpos+3] = (_val & 0xFF); \
+	buf[hpos] = (_val>>24 & 0xFF);\
+	buf[hpos+1] = (_val>>16 & 0xFF);\
+	buf[hpos+2] = (_val>>8 & 0xFF);\
+	buf[hpos+3] = (_val & 0xFF); \
 	hpos+=4;
 
 	//CCI=0
@@ -1179,16 +1218,16 @@ u32 routeout_lct_send(GF_ROUTEOutCtx *ctx, GF_Socket *sock, u32 tsi, u32 toi, u3
 	//total length
 	if (total_size) {
 		if (total_size<=0xFFFFFF) {
-			ctx->lct_buffer[hpos] = GF_LCT_EXT_TOL24;
-			ctx->lct_buffer[hpos+1] = total_size>>16 & 0xFF;
-			ctx->lct_buffer[hpos+2] = total_size>>8 & 0xFF;
-			ctx->lct_buffer[hpos+3] = total_size & 0xFF;
+			buf[hpos] = GF_LCT_EXT_TOL24;
+			buf[hpos+1] = total_size>>16 & 0xFF;
+			buf[hpos+2] = total_size>>8 & 0xFF;
+			buf[hpos+3] = total_size & 0xFF;
 			hpos+=4;
 		} else {
-			ctx->lct_buffer[hpos] = GF_LCT_EXT_TOL48;
-			ctx->lct_buffer[hpos+1] = 2; //2 x 32 bits for header ext
-			ctx->lct_buffer[hpos+2] = 0;
-			ctx->lct_buffer[hpos+3] = 0;
+			buf[hpos] = GF_LCT_EXT_TOL48;
+			buf[hpos+1] = 2; //2 x 32 bits for header ext
+			buf[hpos+2] = 0;
+			buf[hpos+3] = 0;
 			hpos+=4;
 			PUT_U32(total_size);
 		}
@@ -1201,13 +1240,15 @@ u32 routeout_lct_send(GF_ROUTEOutCtx *ctx, GF_Socket *sock, u32 tsi, u32 toi, u3
 
 	GF_LOG(GF_LOG_DEBUG, GF_LOG_ROUTE, ("[ROUTE] LCT SID %u TSI %u TOI %u size %u (frag %u total %u) offset %u (%u in obj)\n", service_id, tsi, toi, send_payl_size, len, total_size, offset, offset_in_frame));
 
-	memcpy(ctx->lct_buffer + hpos, payload + offset, send_payl_size);
-	e = gf_sk_send(sock, ctx->lct_buffer, send_payl_size + hpos);
-	if (e) {
-		GF_LOG(GF_LOG_ERROR, GF_LOG_ROUTE, ("[ROUTE] Failed to send LCT object TSI %u TOI %u fragment: %s\n", tsi, toi, gf_error_to_string(e) ));
-	}
+	memcpy(buf + hpos, payload + offset, send_payl_size);
+	ctx->dgrams[ctx->nb_batch].data = buf;
+	ctx->dgrams[ctx->nb_batch].size = send_payl_size + hpos;
+	ctx->nb_batch++;
+	ctx->batch_sock = sock;
 	//store what we actually sent including header for rate estimation
 	ctx->bytes_sent += send_payl_size + hpos;
+	if (ctx->nb_batch == ctx->batch)
+		routeout_flush_batch(ctx);
 	//but return what we sent from the source
 	return send_payl_size;
 }
@@ -1920,6 +1961,7 @@ static GF_Err routeout_process(GF_Filter *filter)
 				all_serv_done = GF_FALSE;
 		}
 	}
+	routeout_flush_batch(ctx);
 
 	if (all_serv_done) {
 		return e ? e : GF_EOS;
@@ -1927,7 +1969,8 @@ static GF_Err routeout_process(GF_Filter *filter)
 
 	if (ctx->clock - ctx->clock_stats >= 1000000) {
 		u64 rate = ctx->bytes_sent * 8 * 1000 / (ctx->clock - ctx->clock_stats);
-		GF_LOG(GF_LOG_INFO, GF_LOG_ROUTE, ("[ROUTE] Mux rate "LLU" kbps\n", rate));
+		Double pck_per_call = ctx->nb_send_calls ? ((Double) ctx->nb_send_pck) / ctx->nb_send_calls : 0.0;
+		GF_LOG(GF_LOG_INFO, GF_LOG_ROUTE, ("[ROUTE] Mux rate "LLU" kbps - %.02f packets per call\n", rate, pck_per_call));
 		if (ctx->reporting_on) {
 			u32 progress = 0;
 			char szStatus[200];
@@ -1935,13 +1978,14 @@ static GF_Err routeout_process(GF_Filter *filter)
 				progress = (u32) (10000*ctx->total_bytes / ctx->total_size);
 
 			if (ctx->sock_atsc_lls) {
-				snprintf(szStatus, 200, "Mux rate "LLU" kbps - %d services - %d active resources %.02f %% done", rate, count, ctx->nb_resources, ((Double)progress) / 100);
+				snprintf(szStatus, 200, "Mux rate "LLU" kbps - %.02f packets per call - %d services - %d active resources %.02f %% done", rate, pck_per_call, count, ctx->nb_resources, ((Double)progress) / 100);
 			} else {
-				snprintf(szStatus, 200, "Mux rate "LLU" kbps - %d active resources %.02f %% done", rate, ctx->nb_resources, ((Double)progress) / 100);
+				snprintf(szStatus, 200, "Mux rate "LLU" kbps - %.02f packets per call - %d active resources %.02f %% done", rate, pck_per_call, ctx->nb_resources, ((Double)progress) / 100);
 			}
 			gf_filter_update_status(filter, 0, szStatus);
 		}
 		ctx->bytes_sent = 0;
+		ctx->nb_send_calls = ctx->nb_send_pck = 0;
 		ctx->clock_stats = ctx->clock;
 	}
 	ctx->reschedule_us++;
@@ -1998,6 +2042,7 @@ static const GF_FilterArgs ROUTEOutArgs[] =
 	{ OFFS(ttl), "time-to-live for multicast packets", GF_PROP_UINT, "0", NULL, 0},
 	{ OFFS(bsid), "ID for ATSC broadcast stream", GF_PROP_UINT, "800", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(mtu), "size of LCT MTU in bytes", GF_PROP_UINT, "1472", NULL, 0},
+	{ OFFS(batch), "maximum number of LCT packets sent per system call, 0 or 1 disables batching", GF_PROP_UINT, "64", "0-64", GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(splitlct), "split mode for LCT channels\n"
 		"- off: all streams are in the same LCT channel\n"
 		"- type: each new stream type results in a new LCT channel\n"
@@ -54,6 +54,7 @@ typedef struct
 	char *info, *url, *email;
 	s32 runfor, tso;
 	Bool latm;
+	u32 batch;
 
 	/*timeline origin of our session (all tracks) in microseconds*/
 	u64 sys_clock_at_init;
@@ -78,6 +79,8 @@ typedef struct
 	u32 single_stream;
 	GF_FilterCapability in_caps[2];
 	char szExt[10];
+
+	u64 clock_stats;
 } GF_RTPOutCtx;
 
 
@@ -660,6 +663,8 @@ static GF_Err rtpout_configure_pid(GF_Filter *filter, GF_FilterPid *pid, Bool is
 	//init rtp
 	e = rtpout_init_streamer(stream,  ctx->ip ? ctx->ip : "127.0.0.1", ctx->xps, ctx->mpeg4, ctx->latm, payt, ctx->mtu, ctx->ttl, ctx->ifce, GF_FALSE, &ctx->base_pid_id, ctx->single_stream);
 	if (e) return e;
+	e = gf_rtp_streamer_set_send_batch(stream->rtp, ctx->batch);
+	if (e) return e;
 
 	stream->selected = GF_TRUE;
 
@@ -1049,6 +1054,10 @@ GF_Err rtpout_process_rtp(GF_List *streams, GF_RTPOutStream **active_stream, Boo
 	gf_filter_pid_drop_packet(stream->pid);
 	stream->pck = NULL;
 
+	//send all RTP packets of the AU
+	if (!e)
+		e = gf_rtp_streamer_flush(stream->rtp);
+
 	if (e) {
 		GF_LOG(GF_LOG_ERROR, GF_LOG_RTP, ("[RTPOut] Error sending RTP packet %d: %s\n", stream->pck_num, gf_error_to_string(e) ));
 	}
@@ -1088,6 +1097,25 @@ static GF_Err rtpout_process(GF_Filter *filter)
 	e = rtpout_process_rtp(ctx->streams, &ctx->active_stream, ctx->loop, ctx->delay, &ctx->active_stream_idx, ctx->sys_clock_at_init, &ctx->active_min_ts_microsec, ctx->microsec_ts_init, &ctx->wait_for_loop, &repost_delay_us, &ctx->first_RTCP_sent, ctx->base_pid_id);
 	if (e) return e;
 
+	if (gf_filter_reporting_enabled(filter)) {
+		u64 now = gf_sys_clock_high_res();
+		if (now - ctx->clock_stats >= 1000000) {
+			u32 i, count = gf_list_count(ctx->streams);
+			u64 nb_calls=0, nb_pck=0;
+			char szStatus[200];
+			for (i=0; i<count; i++) {
+				u64 calls, pcks;
+				GF_RTPOutStream *stream = gf_list_get(ctx->streams, i);
+				gf_rtp_streamer_get_send_stats(stream->rtp, &calls, &pcks);
+				nb_calls += calls;
+				nb_pck += pcks;
+			}
+			snprintf(szStatus, 200, "Sent "LLU" RTP packets - %.02f packets per call", nb_pck, nb_calls ? ((Double) nb_pck) / nb_calls : 0.0);
+			gf_filter_update_status(filter, -1, szStatus);
+			ctx->clock_stats = now;
+		}
+	}
+
 	if (repost_delay_us)
 		gf_filter_ask_rt_reschedule(filter, repost_delay_us);
 
@@ -1129,6 +1157,7 @@ static const GF_FilterArgs RTPOutArgs[] =
 	{ OFFS(loop), "loop all streams in session (not always possible depending on source type)", GF_PROP_BOOL, "true", NULL, 0},
 	{ OFFS(mpeg4), "send all streams using MPEG-4 generic payload format if posible", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(mtu), "size of RTP MTU in bytes", GF_PROP_UINT, "1460", NULL, 0},
+	{ OFFS(batch), "maximum number of RTP packets of an access unit sent per system call, 0 or 1 disables batching", GF_PROP_UINT, "64", "0-64", GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(ttl), "time-to-live for muticast packets", GF_PROP_UINT, "2", NULL, GF_FS_ARG_HINT_ADVANCED},
 	{ OFFS(ifce), "default network inteface to use", GF_PROP_STRING, NULL, NULL, GF_FS_ARG_HINT_ADVANCED},
 	{ OFFS(payt), "payload type to use for dynamic configs", GF_PROP_UINT, "96", "96-127", GF_FS_ARG_HINT_EXPERT},
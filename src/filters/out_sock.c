@@ -42,7 +42,7 @@ typedef struct
 	Double start, speed;
 	char *dst, *mime, *ext, *ifce;
 	Bool listen;
-	u32 maxc, port, sockbuf, ka, kp, rate, ttl;
+	u32 maxc, port, sockbuf, ka, kp, rate, ttl, batch;
 	GF_Fraction pckr, pckd;
 
 	GF_Socket *socket;
@@ -66,6 +66,13 @@ typedef struct
 	GF_FilterPacket *rev_pck;
 	u32 next_pckd_idx, next_pckr_idx;
 	u32 nb_pckd_wnd, nb_pckr_wnd;
+
+	//packets pending in the current batch of datagrams
+	Bool use_batch;
+	GF_SockDatagram *dgrams;
+	GF_FilterPacket **batch_pcks;
+	u32 nb_batch;
+	u64 nb_send_calls, nb_send_dgrams;
 } GF_SockOutCtx;
 
 
@@ -228,6 +235,17 @@ static GF_Err sockout_initialize(GF_Filter *filter)
 
 	gf_sk_set_buffer_size(ctx->socket, 0, ctx->sockbuf);
 
+	if (ctx->batch>GF_SK_MAX_BATCH) ctx->batch = GF_SK_MAX_BATCH;
+	if ((ctx->batch>1) && !ctx->listen && (sock_type != GF_SOCK_TYPE_TCP)
+#ifdef GPAC_HAS_SOCK_UN
+		&& (sock_type != GF_SOCK_TYPE_TCP_UN)
+#endif
+	) {
+		ctx->use_batch = GF_TRUE;
+		ctx->dgrams = gf_malloc(sizeof(GF_SockDatagram) * ctx->batch);
+		ctx->batch_pcks = gf_malloc(sizeof(GF_FilterPacket *) * ctx->batch);
+		if (!ctx->dgrams || !ctx->batch_pcks) return GF_OUT_OF_MEM;
+	}
 	return GF_OK;
 }
 
@@ -244,6 +262,13 @@ static void sockout_finalize(GF_Filter *filter)
 	}
 
 	if (ctx->socket) gf_sk_del(ctx->socket);
+
+	while (ctx->nb_batch) {
+		ctx->nb_batch--;
+		gf_filter_pck_unref(ctx->batch_pcks[ctx->nb_batch]);
+	}
+	if (ctx->dgrams) gf_free(ctx->dgrams);
+	if (ctx->batch_pcks) gf_free(ctx->batch_pcks);
 }
 
 static GF_Err sockout_send_packet(GF_SockOutCtx *ctx, GF_FilterPacket *pck, GF_Socket *dst_sock)
@@ -312,6 +337,68 @@ static GF_Err sockout_send_packet(GF_SockOutCtx *ctx, GF_FilterPacket *pck, GF_S
 	return GF_OK;
 }
 
+//sends queued packets as a batch of datagrams, returns GF_EOS if no packet could be batched
+static GF_Err sockout_send_batch(GF_Filter *filter, GF_SockOutCtx *ctx)
+{
+	GF_Err e;
+	u32 i, nb_sent=0;
+	u64 max_bytes = 0;
+
+	//bytes we can send before exceeding the target rate
+	if (ctx->rate) {
+		u64 now = gf_sys_clock_high_res() - ctx->start_time;
+		max_bytes = ctx->rate * now / 8000000;
+		max_bytes = (max_bytes > ctx->nb_bytes_sent) ? (max_bytes - ctx->nb_bytes_sent) : 0;
+	}
+	//gather packets
+	while (ctx->nb_batch < ctx->batch) {
+		u32 size;
+		const u8 *data;
+		GF_FilterPacket *pck = gf_filter_pid_get_packet(ctx->pid);
+		if (!pck) break;
+		data = gf_filter_pck_get_data(pck, &size);
+		//frame interface, use regular send
+		if (!data) break;
+		if (ctx->rate && ctx->nb_batch) {
+			if (size > max_bytes) break;
+			max_bytes -= size;
+		}
+		gf_filter_pck_ref(&pck);
+		gf_filter_pid_drop_packet(ctx->pid);
+		ctx->batch_pcks[ctx->nb_batch] = pck;
+		ctx->dgrams[ctx->nb_batch].data = (u8 *) data;
+		ctx->dgrams[ctx->nb_batch].size = size;
+		ctx->nb_batch++;
+	}
+	if (!ctx->nb_batch) return GF_EOS;
+
+	e = gf_sk_send_batch(ctx->socket, ctx->dgrams, ctx->nb_batch, &nb_sent);
+	ctx->nb_send_calls++;
+	ctx->nb_send_dgrams += nb_sent;
+	if (e && (e != GF_BUFFER_TOO_SMALL) && (e != GF_IP_SOCK_WOULD_BLOCK)) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[SockOut] Write error: %s\n", gf_error_to_string(e) ));
+		//discard datagram in error
+		nb_sent++;
+	}
+	for (i=0; i<nb_sent; i++) {
+		ctx->nb_bytes_sent += ctx->dgrams[i].size;
+		gf_filter_pck_unref(ctx->batch_pcks[i]);
+	}
+	ctx->nb_pck_processed += nb_sent;
+	ctx->nb_batch -= nb_sent;
+	if (ctx->nb_batch) {
+		memmove(ctx->dgrams, ctx->dgrams + nb_sent, sizeof(GF_SockDatagram) * ctx->nb_batch);
+		memmove(ctx->batch_pcks, ctx->batch_pcks + nb_sent, sizeof(GF_FilterPacket *) * ctx->nb_batch);
+		//socket buffer full, retry later
+		gf_filter_ask_rt_reschedule(filter, 1000);
+	}
+	if (!ctx->rate && gf_filter_reporting_enabled(filter)) {
+		char szStatus[200];
+		snprintf(szStatus, 200, "Sent "LLU" bytes - %.02f datagrams per call", ctx->nb_bytes_sent, ((Double) ctx->nb_send_dgrams) / ctx->nb_send_calls);
+		gf_filter_update_status(filter, -1, szStatus);
+	}
+	return GF_OK;
+}
 
 static GF_Err sockout_process(GF_Filter *filter)
 {
@@ -334,7 +421,10 @@ static GF_Err sockout_process(GF_Filter *filter)
 				return GF_OK;
 			} else if (gf_filter_reporting_enabled(filter)) {
 				char szMsg[200];
-				snprintf(szMsg, 199, "Sending at "LLU" kbps\r", ctx->nb_bytes_sent*8*1000/now);
+				if (ctx->nb_send_calls)
+					snprintf(szMsg, 199, "Sending at "LLU" kbps - %.02f datagrams per call\r", ctx->nb_bytes_sent*8*1000/now, ((Double) ctx->nb_send_dgrams) / ctx->nb_send_calls);
+				else
+					snprintf(szMsg, 199, "Sending at "LLU" kbps\r", ctx->nb_bytes_sent*8*1000/now);
 				szMsg[199] = 0;
 				gf_filter_update_status(filter, 0, szMsg);
 			}
@@ -372,6 +462,12 @@ static GF_Err sockout_process(GF_Filter *filter)
 		return GF_OK;
 	}
 
+	//no batch when dropping or reordering packets
+	if (ctx->use_batch && !ctx->pckd.den && !ctx->pckr.den) {
+		e = sockout_send_batch(filter, ctx);
+		if (e != GF_EOS) return e;
+	}
+
 	pck = gf_filter_pid_get_packet(ctx->pid);
 	if (!pck) {
 		if (gf_filter_pid_is_eos(ctx->pid)) {
@@ -528,6 +624,7 @@ static const GF_FilterArgs SockOutArgs[] =
 	{ OFFS(pckr), "reverse packet every N - see filter help", GF_PROP_FRACTION, "0/0", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(pckd), "drop packet every N - see filter help", GF_PROP_FRACTION, "0/0", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(ttl), "multicast TTL", GF_PROP_UINT, "0", "0-127", GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(batch), "maximum number of packets sent per system call for UDP sockets, each packet being sent as one datagram. A value of 0 or 1 disables batching", GF_PROP_UINT, "64", "0-64", GF_FS_ARG_HINT_EXPERT},
 	{0}
 };
 
@@ -135,6 +135,9 @@ typedef struct
 	//strict_poc=0: we wait after each IDR until we find a stable poc diff between pictures, controled by poc_probe_done
 	//strict_poc>=1: we dispatch only after IDR or at the end (huge delay)
 	GF_List *pck_queue;
+	//packets removed from pck_queue and sent as a single batch
+	GF_FilterPacket **pck_batch;
+	u32 nb_pck_batch, alloc_pck_batch;
 	//dts of the last IDR found
 	u64 dts_last_IDR;
 	//max size of NALUs in the bitstream
@@ -558,6 +561,21 @@ static void naludmx_check_dur(GF_Filter *filter, GF_NALUDmxCtx *ctx)
 }
 
 
+static void naludmx_batch_pck(GF_NALUDmxCtx *ctx, GF_FilterPacket *pck)
+{
+	if (ctx->nb_pck_batch == ctx->alloc_pck_batch) {
+		GF_FilterPacket **batch = gf_realloc(ctx->pck_batch, sizeof(GF_FilterPacket *) * (ctx->alloc_pck_batch + 10));
+		if (!batch) {
+			gf_filter_pck_send(pck);
+			return;
+		}
+		ctx->pck_batch = batch;
+		ctx->alloc_pck_batch += 10;
+	}
+	ctx->pck_batch[ctx->nb_pck_batch] = pck;
+	ctx->nb_pck_batch++;
+}
+
 static void naludmx_enqueue_or_dispatch(GF_NALUDmxCtx *ctx, GF_FilterPacket *n_pck, Bool flush_ref)
 {
 	//TODO: we are dispatching frames in "negctts mode", ie we may have DTS>CTS
@@ -613,7 +631,7 @@ static void naludmx_enqueue_or_dispatch(GF_NALUDmxCtx *ctx, GF_FilterPacket *n_p
 				if (!carousel_info) {
 					assert(ctx->timescale);
 					gf_list_rem(ctx->pck_queue, 0);
-					gf_filter_pck_send(q_pck);
+					naludmx_batch_pck(ctx, q_pck);
 					continue;
 				}
 				gf_filter_pck_set_carousel_version(q_pck, 0);
@@ -666,7 +684,14 @@ static void naludmx_enqueue_or_dispatch(GF_NALUDmxCtx *ctx, GF_FilterPacket *n_p
 				}
 			}
 			gf_list_rem(ctx->pck_queue, 0);
-			gf_filter_pck_send(q_pck);
+			naludmx_batch_pck(ctx, q_pck);
+		}
+		if (ctx->nb_pck_batch) {
+			GF_Err e = gf_filter_pck_send_batch(ctx->pck_batch, ctx->nb_pck_batch);
+			if (e) {
+				GF_LOG(GF_LOG_WARNING, GF_LOG_PARSER, ("[%s] Failed to send batch of %d packets: %s\n", ctx->log_name, ctx->nb_pck_batch, gf_error_to_string(e) ));
+			}
+			ctx->nb_pck_batch = 0;
 		}
 	}
 	if (!n_pck) return;
@@ -3655,6 +3680,7 @@ static void naludmx_finalize(GF_Filter *filter)
 		}
 		gf_list_del(ctx->pck_queue);
 	}
+	if (ctx->pck_batch) gf_free(ctx->pck_batch);
 	if (ctx->sei_buffer) gf_free(ctx->sei_buffer);
 	if (ctx->svc_prefix_buffer) gf_free(ctx->svc_prefix_buffer);
 	if (ctx->subsamp_buffer) gf_free(ctx->subsamp_buffer);
@@ -35,13 +35,29 @@ typedef struct
 {
 	GF_FilterPid *opid;
 	u32 pmt_pid;
+	u32 prog_number;
 	u8 pat_pck[192];
 	u32 pat_pck_size;
 
 	u8 *pck_buffer;
 	u32 nb_pck;
+
+	//pending run of contiguous packets in the current input packet
+	u32 run_start, run_size;
+
+	//stats
+	u64 nb_pck_fwd, nb_pck_drop;
 } GF_M2TSSplit_SPTS;
 
+enum
+{
+	M2TSSPLIT_PID_NONE = 0,
+	M2TSSPLIT_PID_PAT,
+	M2TSSPLIT_PID_PMT,
+	M2TSSPLIT_PID_PROG,
+	M2TSSPLIT_PID_DVB,
+};
+
 
 typedef struct
 {
@@ -62,6 +78,27 @@ typedef struct
 	u8 tsbuf[192];
 	GF_BitStream *bsw;
 
+	//PID to program lookup, only PAT and PMT packets are sent to the demuxer
+	u8 pid_type[GF_M2TS_MAX_STREAMS];
+	GF_M2TSSplit_SPTS *pid_map[GF_M2TS_MAX_STREAMS];
+
+	//packet size, 188 or 192, 0 until first sync
+	u32 pck_size;
+	//incomplete packet at the end of the last input packet
+	u8 rem[196];
+	u32 rem_size;
+	//sync was lost at the end of the last input packet, rem holds the bytes that could not be checked
+	Bool rem_unsync;
+	//byte offset expected for the next input packet, to detect source restarts
+	u64 next_offset;
+
+	//input packet being processed
+	GF_FilterPacket *in_pck;
+	const u8 *in_data;
+	Bool in_blocking;
+
+	u64 start_time, last_report, nb_pck_drop;
+	Bool report_done;
 } GF_M2TSSplitCtx;
 
 
@@ -93,17 +130,335 @@ void m2tssplit_send_packet(GF_M2TSSplitCtx *ctx, GF_M2TSSplit_SPTS *stream, u8 *
 	}
 }
 
+static void m2tssplit_flush_run(GF_M2TSSplitCtx *ctx, GF_M2TSSplit_SPTS *stream)
+{
+	u32 i, nb_pck;
+	if (!stream->run_size) return;
+
+	nb_pck = stream->run_size / ctx->pck_size;
+	//runs large enough are sent in a single packet, by reference to the input packet if possible, smaller ones are packed
+	if (!ctx->nb_pack || (nb_pck >= ctx->nb_pack)) {
+		GF_FilterPacket *pck;
+		if (stream->nb_pck)
+			m2tssplit_send_packet(ctx, stream, NULL, ctx->pck_size);
+
+		//the source is waiting for the input packet to be released, don't hold it until all programs are consumed
+		if (ctx->in_blocking) {
+			u8 *buffer;
+			pck = gf_filter_pck_new_alloc(stream->opid, stream->run_size, &buffer);
+			memcpy(buffer, ctx->in_data + stream->run_start, stream->run_size);
+		} else {
+			pck = gf_filter_pck_new_ref(stream->opid, stream->run_start, stream->run_size, ctx->in_pck);
+		}
+		gf_filter_pck_set_framing(pck, GF_FALSE, GF_FALSE);
+		gf_filter_pck_send(pck);
+	} else {
+		for (i=0; i<nb_pck; i++) {
+			m2tssplit_send_packet(ctx, stream, (u8 *) ctx->in_data + stream->run_start + i*ctx->pck_size, ctx->pck_size);
+		}
+	}
+	stream->run_size = 0;
+}
+
+//send all pending packets of a program, called before inserting a packet not coming from the input
+static void m2tssplit_flush_stream(GF_M2TSSplitCtx *ctx, GF_M2TSSplit_SPTS *stream)
+{
+	m2tssplit_flush_run(ctx, stream);
+	if (stream->nb_pck)
+		m2tssplit_send_packet(ctx, stream, NULL, ctx->pck_size);
+}
+
 void m2tssplit_flush(GF_M2TSSplitCtx *ctx)
 {
 	u32 i;
-	if (!ctx->nb_pack) return;
-
 	for (i=0; i<gf_list_count(ctx->streams); i++ ) {
 		GF_M2TSSplit_SPTS *stream = gf_list_get(ctx->streams, i);
-		if (stream->opid && stream->nb_pck)
-			m2tssplit_send_packet(ctx, stream, NULL, 0);
+		if (stream->opid)
+			m2tssplit_flush_stream(ctx, stream);
+	}
+}
+
+static void m2tssplit_report(GF_Filter *filter, GF_M2TSSplitCtx *ctx, Bool is_final)
+{
+	u32 i, count;
+	u64 now = gf_sys_clock_high_res();
+	u64 dur = now - ctx->start_time;
+	if (!ctx->start_time || ctx->report_done) return;
+	if (!dur) dur = 1;
+
+	count = gf_list_count(ctx->streams);
+	if (is_final) {
+		for (i=0; i<count; i++) {
+			GF_M2TSSplit_SPTS *stream = gf_list_get(ctx->streams, i);
+			GF_LOG(GF_LOG_INFO, GF_LOG_CONTAINER, ("[M2TSSplit] Program %d: "LLU" packets forwarded (%.02f pck/s) - "LLU" packets dropped\n", stream->prog_number, stream->nb_pck_fwd, ((Double) stream->nb_pck_fwd) * 1000000 / dur, stream->nb_pck_drop));
+		}
+		if (ctx->nb_pck_drop) {
+			GF_LOG(GF_LOG_INFO, GF_LOG_CONTAINER, ("[M2TSSplit] "LLU" packets dropped on PIDs not belonging to any program\n", ctx->nb_pck_drop));
+		}
+		ctx->report_done = GF_TRUE;
+	}
+	if (gf_filter_reporting_enabled(filter)) {
+		char szStatus[200];
+		u64 nb_fwd=0, nb_drop=ctx->nb_pck_drop;
+		for (i=0; i<count; i++) {
+			GF_M2TSSplit_SPTS *stream = gf_list_get(ctx->streams, i);
+			nb_fwd += stream->nb_pck_fwd;
+			nb_drop += stream->nb_pck_drop;
+		}
+		snprintf(szStatus, 200, "%d programs - %.02f pck/s - "LLU" packets dropped", count, ((Double) nb_fwd) * 1000000 / dur, nb_drop);
+		gf_filter_update_status(filter, is_final ? 10000 : -1, szStatus);
+	}
+	ctx->last_report = now;
+}
+
+static void m2tssplit_update_pid_map(GF_M2TSSplitCtx *ctx)
+{
+	u32 i, count;
+	static const u32 dvb_pids[] = {
+		GF_M2TS_PID_CAT, GF_M2TS_PID_TSDT, GF_M2TS_PID_NIT_ST, GF_M2TS_PID_SDT_BAT_ST, GF_M2TS_PID_EIT_ST_CIT, GF_M2TS_PID_RST_ST, GF_M2TS_PID_TDT_TOT_ST,
+		GF_M2TS_PID_NET_SYNC, GF_M2TS_PID_RNT, GF_M2TS_PID_IN_SIG, GF_M2TS_PID_MEAS, GF_M2TS_PID_DIT, GF_M2TS_PID_SIT
+	};
+
+	memset(ctx->pid_type, M2TSSPLIT_PID_NONE, sizeof(ctx->pid_type));
+	memset(ctx->pid_map, 0, sizeof(ctx->pid_map));
+
+	ctx->pid_type[GF_M2TS_PID_PAT] = M2TSSPLIT_PID_PAT;
+	for (i=0; i<GF_ARRAY_LENGTH(dvb_pids); i++)
+		ctx->pid_type[dvb_pids[i]] = M2TSSPLIT_PID_DVB;
+
+	//PCR-only PIDs are not declared in the PMT streams
+	count = gf_list_count(ctx->dmx->programs);
+	for (i=0; i<count; i++) {
+		GF_M2TS_Program *prog = gf_list_get(ctx->dmx->programs, i);
+		if (!prog->user || !prog->pcr_pid || (prog->pcr_pid>=0x1FFF)) continue;
+		ctx->pid_type[prog->pcr_pid] = M2TSSPLIT_PID_PROG;
+		ctx->pid_map[prog->pcr_pid] = prog->user;
+	}
+	for (i=0; i<GF_M2TS_MAX_STREAMS; i++) {
+		GF_M2TS_ES *es = ctx->dmx->ess[i];
+		if (!es || !es->program->user) continue;
+		ctx->pid_type[i] = (es->flags & GF_M2TS_ES_IS_PMT) ? M2TSSPLIT_PID_PMT : M2TSSPLIT_PID_PROG;
+		ctx->pid_map[i] = es->program->user;
+	}
+}
+
+//checks packets the same way the demuxer does, invalid packets are dropped
+static Bool m2tssplit_check_packet(const u8 *data)
+{
+	if ((data[0] != 0x47) || (data[1] & 0x80)) return GF_FALSE;
+	//scrambled packets are not supported
+	if (data[3] & 0xC0) return GF_FALSE;
+
+	switch ((data[3] >> 4) & 0x3) {
+	//reserved
+	case 0:
+		return GF_FALSE;
+	//adaptation only, only forwarded if carrying a PCR
+	case 2:
+		if (data[4] != 183) return GF_FALSE;
+		return (data[5] & 0x10) ? GF_TRUE : GF_FALSE;
+	case 3:
+		if (data[4] > 183) return GF_FALSE;
+		break;
+	}
+	return GF_TRUE;
+}
+
+static void m2tssplit_forward(GF_M2TSSplitCtx *ctx, GF_M2TSSplit_SPTS *stream, u8 *data, s32 offset)
+{
+	stream->nb_pck_fwd++;
+	//packet is in the current input packet, extend or start run
+	if (offset>=0) {
+		if (stream->run_size && (stream->run_start + stream->run_size == (u32) offset)) {
+			stream->run_size += ctx->pck_size;
+			return;
+		}
+		m2tssplit_flush_run(ctx, stream);
+		stream->run_start = offset;
+		stream->run_size = ctx->pck_size;
+		return;
+	}
+	m2tssplit_flush_run(ctx, stream);
+	m2tssplit_send_packet(ctx, stream, data, ctx->pck_size);
+}
+
+//process one packet, offset is the packet position in the current input packet, or -1 if the packet was reassembled
+static void m2tssplit_process_ts_packet(GF_M2TSSplitCtx *ctx, u8 *data, s32 offset)
+{
+	u32 i, count, pid;
+	GF_M2TSSplit_SPTS *stream;
+	//in 192 bytes mode, the 4 bytes prefix is before the sync byte
+	u8 *ts_data = data + ctx->pck_size - 188;
+
+	pid = ((ts_data[1] & 0x1f) << 8) | ts_data[2];
+	if (!m2tssplit_check_packet(ts_data)) {
+		stream = ctx->pid_map[pid];
+		if (stream) stream->nb_pck_drop++;
+		else ctx->nb_pck_drop++;
+		return;
+	}
+
+	switch (ctx->pid_type[pid]) {
+	case M2TSSPLIT_PID_PAT:
+		//PAT is rewritten for each program
+		gf_m2ts_process_data(ctx->dmx, ts_data, 188);
+		return;
+	case M2TSSPLIT_PID_PMT:
+		//process PMT, this may create the program output and update the PID map
+		gf_m2ts_process_data(ctx->dmx, ts_data, 188);
+		//fallthrough
+	case M2TSSPLIT_PID_PROG:
+		stream = ctx->pid_map[pid];
+		if (!stream) {
+			ctx->nb_pck_drop++;
+			return;
+		}
+		if (!stream->opid) {
+			stream->nb_pck_drop++;
+			return;
+		}
+		m2tssplit_forward(ctx, stream, data, offset);
+		return;
+	case M2TSSPLIT_PID_DVB:
+		if (!ctx->dvb) return;
+		count = gf_list_count(ctx->streams);
+		for (i=0; i<count; i++) {
+			stream = gf_list_get(ctx->streams, i);
+			if (!stream->opid) continue;
+			m2tssplit_forward(ctx, stream, data, offset);
+		}
+		return;
+	default:
+		ctx->nb_pck_drop++;
+		return;
+	}
+}
+
+//number of bytes kept after a sync loss: the sync byte of the last packets could not be checked, and 192 bytes packets start 4 bytes before it
+#define M2TSSPLIT_RESYNC_KEEP(_ctx)	((_ctx->pck_size==192) ? 196 : 188)
+
+//locates the first packet start, detecting packet size if unknown
+static u32 m2tssplit_sync(GF_M2TSSplitCtx *ctx, const u8 *data, u32 size)
+{
+	u32 i=0;
+	u32 lookahead = ctx->pck_size ? ctx->pck_size : 192;
+	while (i + lookahead < size) {
+		if (data[i]==0x47) {
+			if (!ctx->pck_size) {
+				if (data[i+188]==0x47) ctx->pck_size = 188;
+				else if (data[i+192]==0x47) ctx->pck_size = 192;
+			}
+			if (ctx->pck_size && (data[i+ctx->pck_size]==0x47)) {
+				if (ctx->pck_size==188) return i;
+				return (i>=4) ? i-4 : i+188;
+			}
+		}
+		i++;
+	}
+	return size;
+}
+
+static void m2tssplit_process_data(GF_M2TSSplitCtx *ctx, GF_FilterPacket *pck, const u8 *data, u32 size)
+{
+	u32 i, pos = 0;
+	Bool unsync = GF_FALSE;
+
+	if (!ctx->pck_size) {
+		pos = m2tssplit_sync(ctx, data, size);
+		if (!ctx->pck_size) {
+			GF_LOG(GF_LOG_WARNING, GF_LOG_CONTAINER, ("[M2TSSplit] Cannot find TS sync in %d bytes, discarding\n", size));
+			return;
+		}
+		ctx->start_time = ctx->last_report = gf_sys_clock_high_res();
+	}
+
+	//incomplete packet not starting with a sync byte, look for sync across both packets
+	if (ctx->rem_size && !ctx->rem_unsync && (ctx->rem_size > ctx->pck_size - 188) && (ctx->rem[ctx->pck_size - 188] != 0x47))
+		ctx->rem_unsync = GF_TRUE;
+	//sync was lost at the end of previous input packet, look for sync across both packets
+	if (ctx->rem_unsync) {
+		u8 tmp[196+392];
+		u32 j, nb_copy = MIN(size, 392);
+		u32 tmp_size = ctx->rem_size + nb_copy;
+		memcpy(tmp, ctx->rem, ctx->rem_size);
+		memcpy(tmp + ctx->rem_size, data, nb_copy);
+		j = m2tssplit_sync(ctx, tmp, tmp_size);
+		if (j && (j < tmp_size)) {
+			GF_LOG(GF_LOG_WARNING, GF_LOG_CONTAINER, ("[M2TSSplit] Lost sync, skipping %d bytes\n", j));
+		}
+		if (j < ctx->rem_size) {
+			//packet starts in the kept bytes, complete it below
+			memmove(ctx->rem, ctx->rem + j, ctx->rem_size - j);
+			ctx->rem_size -= j;
+			//for 192 bytes packets, the kept bytes may hold a complete packet followed by a few bytes
+			if (ctx->rem_size > ctx->pck_size) {
+				m2tssplit_process_ts_packet(ctx, ctx->rem, -1);
+				ctx->rem_size -= ctx->pck_size;
+				memmove(ctx->rem, ctx->rem + ctx->pck_size, ctx->rem_size);
+			}
+		} else if (j < tmp_size) {
+			pos = j - ctx->rem_size;
+			ctx->rem_size = 0;
+		} else if (nb_copy < size) {
+			//not found, keep looking in the current packet
+			ctx->rem_size = 0;
+		} else {
+			u32 keep = MIN(tmp_size, M2TSSPLIT_RESYNC_KEEP(ctx));
+			GF_LOG(GF_LOG_WARNING, GF_LOG_CONTAINER, ("[M2TSSplit] Lost sync, skipping %d bytes\n", tmp_size - keep));
+			memcpy(ctx->rem, tmp + tmp_size - keep, keep);
+			ctx->rem_size = keep;
+			return;
+		}
+		ctx->rem_unsync = GF_FALSE;
+	}
+
+	//complete packet started in previous input packet
+	if (ctx->rem_size) {
+		u32 to_copy = ctx->pck_size - ctx->rem_size;
+		if (to_copy > size) {
+			memcpy(ctx->rem + ctx->rem_size, data, size);
+			ctx->rem_size += size;
+			return;
+		}
+		memcpy(ctx->rem + ctx->rem_size, data, to_copy);
+		ctx->rem_size = 0;
+		m2tssplit_process_ts_packet(ctx, ctx->rem, -1);
+		pos = to_copy;
+	}
+
+	ctx->in_pck = pck;
+	ctx->in_data = data;
+	ctx->in_blocking = gf_filter_pck_is_blocking_ref(pck);
+	while (pos + ctx->pck_size <= size) {
+		if (data[pos + ctx->pck_size - 188] != 0x47) {
+			u32 skip = m2tssplit_sync(ctx, data+pos+1, size-pos-1) + 1;
+			//no sync found, the last bytes could not be checked and are kept for the next input packet
+			if (pos + skip >= size) {
+				u32 keep = MIN(size - pos - 1, M2TSSPLIT_RESYNC_KEEP(ctx));
+				skip = size - pos - keep;
+				unsync = GF_TRUE;
+			}
+			GF_LOG(GF_LOG_WARNING, GF_LOG_CONTAINER, ("[M2TSSplit] Lost sync, skipping %d bytes\n", skip));
+			pos += skip;
+			if (unsync) break;
+			continue;
+		}
+		m2tssplit_process_ts_packet(ctx, (u8 *) data + pos, pos);
+		pos += ctx->pck_size;
+	}
+	//runs cannot span over input packets
+	for (i=0; i<gf_list_count(ctx->streams); i++) {
+		GF_M2TSSplit_SPTS *stream = gf_list_get(ctx->streams, i);
+		m2tssplit_flush_run(ctx, stream);
 	}
+	ctx->in_pck = NULL;
+	ctx->in_data = NULL;
 
+	if (pos < size) {
+		memcpy(ctx->rem, data+pos, size-pos);
+		ctx->rem_size = size-pos;
+		ctx->rem_unsync = unsync;
+	}
 }
 
 GF_Err m2tssplit_configure_pid(GF_Filter *filter, GF_FilterPid *pid, Bool is_remove)
@@ -158,15 +513,27 @@ GF_Err m2tssplit_process(GF_Filter *filter)
 	u32 data_size;
 	pck = gf_filter_pid_get_packet(ctx->ipid);
 	if (!pck) {
-		if (gf_filter_pid_is_eos(ctx->ipid))
+		if (gf_filter_pid_is_eos(ctx->ipid)) {
 			m2tssplit_flush(ctx);
+			m2tssplit_report(filter, ctx, GF_TRUE);
+		}
 		return GF_OK;
 	}
 	data = gf_filter_pck_get_data(pck, &data_size);
-	if (data) {
-		gf_m2ts_process_data(ctx->dmx, (u8 *)data, data_size);
+	if (data && data_size) {
+		u64 offset = gf_filter_pck_get_byte_offset(pck);
+		//input is not contiguous (source restarted or seeked), bytes kept from the previous input packet are obsolete
+		if ((offset != GF_FILTER_NO_BO) && (offset != ctx->next_offset)) {
+			ctx->rem_size = 0;
+			ctx->rem_unsync = GF_FALSE;
+		}
+		ctx->next_offset = (offset != GF_FILTER_NO_BO) ? offset + data_size : GF_FILTER_NO_BO;
+		m2tssplit_process_data(ctx, pck, data, data_size);
 	}
 	gf_filter_pid_drop_packet(ctx->ipid);
+
+	if (ctx->start_time && (gf_sys_clock_high_res() - ctx->last_report > 1000000))
+		m2tssplit_report(filter, ctx, GF_FALSE);
 	return GF_OK;
 }
 
@@ -198,18 +565,19 @@ void m2tssplit_on_event(struct tag_m2ts_demux *ts, u32 evt_type, void *par)
 				if (!stream) return;
 				stream->pmt_pid = prog->pmt_pid;
 				first_pck = GF_TRUE;
-				prog->user = stream;
 				if (ctx->nb_pack)
-					stream->pck_buffer = gf_malloc(sizeof(char) * ctx->nb_pack * (ctx->dmx->prefix_present ? 192 : 188) );
+					stream->pck_buffer = gf_malloc(sizeof(char) * ctx->nb_pack * ctx->pck_size);
 
 				gf_list_add(ctx->streams, stream);
 
 				//do not create output stream until we are sure we have AV component in program
 			}
+			prog->user = stream;
+			stream->prog_number = prog->number;
 
 			//generate a pat
 			gf_bs_seek(ctx->bsw, 0);
-			if (ctx->dmx->prefix_present) {
+			if (ctx->pck_size==192) {
 				tot_len += 4;
 				offset += 4;
 				gf_bs_write_u32(ctx->bsw, 1);
@@ -268,12 +636,15 @@ void m2tssplit_on_event(struct tag_m2ts_demux *ts, u32 evt_type, void *par)
 
 			//output new PAT
 			if (stream->opid) {
-				GF_FilterPacket *pck = gf_filter_pck_new_alloc(stream->opid, tot_len, &buffer);
+				GF_FilterPacket *pck;
+				m2tssplit_flush_stream(ctx, stream);
+				pck = gf_filter_pck_new_alloc(stream->opid, tot_len, &buffer);
 				gf_filter_pck_set_framing(pck, first_pck, GF_FALSE);
 				memcpy(buffer, ctx->tsbuf, tot_len);
 				gf_filter_pck_send(pck);
 			}
 		}
+		m2tssplit_update_pid_map(ctx);
 		return;
 	}
 	//resend PAT
@@ -285,6 +656,7 @@ void m2tssplit_on_event(struct tag_m2ts_demux *ts, u32 evt_type, void *par)
 			if (!stream) continue;
 			if (!stream->opid) continue;
 
+			m2tssplit_flush_stream(ctx, stream);
 			GF_FilterPacket *pck = gf_filter_pck_new_alloc(stream->opid, stream->pat_pck_size, &buffer);
 			gf_filter_pck_set_framing(pck, GF_FALSE, GF_FALSE);
 			memcpy(buffer, stream->pat_pck, stream->pat_pck_size);
@@ -296,6 +668,8 @@ void m2tssplit_on_event(struct tag_m2ts_demux *ts, u32 evt_type, void *par)
 		GF_M2TS_Program *prog = par;
 		GF_M2TSSplit_SPTS *stream = prog->user;
 		u32 known_streams = 0;
+
+		m2tssplit_update_pid_map(ctx);
 		for (i=0; i<gf_list_count(prog->streams); i++) {
 			GF_M2TS_ES *es = gf_list_get(prog->streams, i);
 			switch (es->stream_type) {
@@ -354,60 +728,7 @@ void m2tssplit_on_event(struct tag_m2ts_demux *ts, u32 evt_type, void *par)
 		}
 		return;
 	}
-
-	if (evt_type==GF_M2TS_EVT_PCK) {
-		GF_M2TS_TSPCK *tspck = par;
-		Bool do_fwd;
-		GF_M2TSSplit_SPTS *stream = tspck->stream ? tspck->stream->program->user : NULL;
-
-		if (stream) {
-			if (!stream->opid) return;
-
-			if (ctx->dmx->prefix_present) {
-				u8 *data = tspck->data;
-				data -= 4;
-				m2tssplit_send_packet(ctx, stream, data, 192);
-			} else {
-				m2tssplit_send_packet(ctx, stream, tspck->data, 188);
-			}
-			return;
-		}
-
-		if (!ctx->dvb) return;
-
-		do_fwd = GF_FALSE;
-		switch (tspck->pid) {
-		case GF_M2TS_PID_CAT:
-		case GF_M2TS_PID_TSDT:
-		case GF_M2TS_PID_NIT_ST:
-		case GF_M2TS_PID_SDT_BAT_ST:
-		case GF_M2TS_PID_EIT_ST_CIT:
-		case GF_M2TS_PID_RST_ST:
-		case GF_M2TS_PID_TDT_TOT_ST:
-		case GF_M2TS_PID_NET_SYNC:
-		case GF_M2TS_PID_RNT:
-		case GF_M2TS_PID_IN_SIG:
-		case GF_M2TS_PID_MEAS:
-		case GF_M2TS_PID_DIT:
-		case GF_M2TS_PID_SIT:
-			do_fwd = GF_TRUE;
-		}
-		if (do_fwd) {
-			u32 count = gf_list_count(ctx->streams);
-			for (i=0; i<count; i++) {
-				stream = gf_list_get(ctx->streams, i);
-				if (!stream->opid) continue;
-
-				if (ctx->dmx->prefix_present) {
-					u8 *data = tspck->data;
-					data -= 4;
-					m2tssplit_send_packet(ctx, stream, data, 192);
-				} else {
-					m2tssplit_send_packet(ctx, stream, tspck->data, 188);
-				}
-			}
-		}
-	}
+	//GF_M2TS_EVT_PCK is ignored, packets are routed using the PID map
 }
 
 GF_Err m2tssplit_initialize(GF_Filter *filter)
@@ -422,6 +743,7 @@ GF_Err m2tssplit_initialize(GF_Filter *filter)
 	ctx->bsw = gf_bs_new(ctx->tsbuf, 192, GF_BITSTREAM_WRITE);
 	if (ctx->nb_pack<=1)
 		ctx->nb_pack = 0;
+	m2tssplit_update_pid_map(ctx);
 	return GF_OK;
 }
 
@@ -429,6 +751,7 @@ void m2tssplit_finalize(GF_Filter *filter)
 {
 	GF_M2TSSplitCtx *ctx = gf_filter_get_udta(filter);
 
+	m2tssplit_report(filter, ctx, GF_TRUE);
 	while (gf_list_count(ctx->streams)) {
 		GF_M2TSSplit_SPTS *st = gf_list_pop_back(ctx->streams);
 		if (st->pck_buffer) gf_free(st->pck_buffer);
@@ -452,7 +775,7 @@ static const GF_FilterArgs M2TSSplitArgs[] =
 	{ OFFS(dvb), "forward all packets from global DVB PIDs", GF_PROP_BOOL, "true", NULL, GF_FS_ARG_HINT_ADVANCED},
 	{ OFFS(mux_id), "set initial ID of output mux; the first program will use mux_id, the second mux_id+1, etc. If not set, this value will be set to sourceMuxId*255", GF_PROP_SINT, "-1", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(avonly), "do not forward programs with no AV component", GF_PROP_BOOL, "true", NULL, GF_FS_ARG_HINT_ADVANCED},
-	{ OFFS(nb_pack), "pack N packets before sending", GF_PROP_UINT, "10", NULL, GF_FS_ARG_HINT_ADVANCED},
+	{ OFFS(nb_pack), "pack N packets before sending; runs of at least N contiguous packets of a program are sent as a single packet, without copy unless the source is blocking", GF_PROP_UINT, "10", NULL, GF_FS_ARG_HINT_ADVANCED},
 
 	{0}
 };
@@ -464,7 +787,11 @@ GF_FilterRegister M2TSSplitRegister = {
 	GF_FS_SET_DESCRIPTION("MPEG Transport Stream splitter")
 	GF_FS_SET_HELP("This filter splits an MPEG-2 transport stream into several single program transport streams.\n"
 	"Only the PAT table is rewritten, the CAT table, PMT and all program streams are forwarded as is.\n"
-	"In [-full]() mode, global DVB tables of the input multiplex are forwarded to each output mux; otherwise these tables are discarded.")
+	"In [-full]() mode, global DVB tables of the input multiplex are forwarded to each output mux; otherwise these tables are discarded.\n"
+	"\n"
+	"Once PAT and PMTs are acquired, packets are routed to each program based on their PID only, and only PAT and PMT packets are parsed.\n"
+	"Each program is output on its own PID, the processing chains of each program can run on separate threads when the session uses several threads (see [-threads](GPAC)).\n"
+	"The number of packets forwarded and dropped for each program is logged at the end of the session (`-logs=container@info`).")
 	.flags = GF_FS_REG_EXPLICIT_ONLY,
 	.private_size = sizeof(GF_M2TSSplitCtx),
 	.initialize = m2tssplit_initialize,
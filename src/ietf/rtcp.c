@@ -455,6 +455,9 @@ GF_Err gf_rtp_send_bye(GF_RTPChannel *ch)
 	u8 *report_buf;
 	GF_Err e = GF_OK;
 
+	//send pending RTP packets before the report
+	if (ch->nb_batch) gf_rtp_flush_send(ch);
+
 	bs = gf_bs_new(NULL, 0, GF_BITSTREAM_WRITE);
 
 	/*k were received/sent send the RR/SR - note we don't wait for next Repor and force its emission now*/
@@ -500,6 +503,9 @@ GF_Err gf_rtp_send_rtcp_report(GF_RTPChannel *ch)
 	Time = gf_rtp_get_report_time();
 	if ( Time < ch->next_report_time) return GF_OK;
 
+	//send pending RTP packets before the report
+	if (ch->nb_batch) gf_rtp_flush_send(ch);
+
 	bs = gf_bs_new(NULL, 0, GF_BITSTREAM_WRITE);
 
 	//pck were received/sent send the RR/SR
@@ -48,6 +48,7 @@ GF_EXPORT
 void gf_rtp_del(GF_RTPChannel *ch)
 {
 	if (!ch) return;
+	if (ch->nb_batch) gf_rtp_flush_send(ch);
 	if (ch->rtp) gf_sk_del(ch->rtp);
 	if (ch->rtcp) gf_sk_del(ch->rtcp);
 	if (ch->net_info.source) gf_free(ch->net_info.source);
@@ -55,6 +56,8 @@ void gf_rtp_del(GF_RTPChannel *ch)
 	if (ch->net_info.Profile) gf_free(ch->net_info.Profile);
 	if (ch->po) gf_rtp_reorderer_del(ch->po);
 	if (ch->send_buffer) gf_free(ch->send_buffer);
+	if (ch->batch_buffer) gf_free(ch->batch_buffer);
+	if (ch->batch) gf_free(ch->batch);
 
 	if (ch->CName) gf_free(ch->CName);
 	if (ch->s_name) gf_free(ch->s_name);
@@ -169,6 +172,7 @@ GF_Err gf_rtp_stop(GF_RTPChannel *ch)
 	ch->rtcp = NULL;
 	if (ch->po) gf_rtp_reorderer_del(ch->po);
 	ch->po = NULL;
+	ch->nb_batch = 0;
 	return GF_OK;
 }
 
@@ -186,6 +190,7 @@ GF_Err gf_rtp_initialize(GF_RTPChannel *ch, u32 UDPBufferSize, Bool IsSource, u3
 	ch->rtcp = NULL;
 	if (ch->po) gf_rtp_reorderer_del(ch->po);
 	ch->po = NULL;
+	ch->nb_batch = 0;
 
 	ch->CurrentTime = 0;
 	ch->rtp_time = 0;
@@ -279,6 +284,8 @@ GF_Err gf_rtp_initialize(GF_RTPChannel *ch, u32 UDPBufferSize, Bool IsSource, u3
 		if (ch->send_buffer) gf_free(ch->send_buffer);
 		ch->send_buffer_size = PathMTU + 12;
 		ch->send_buffer = (char *) gf_malloc(sizeof(char) * ch->send_buffer_size);
+		//MTU may have changed, realloc batch
+		if (ch->batch_max) gf_rtp_set_send_batch(ch, ch->batch_max);
 	}
 
 	//format CNAME if not done yet
@@ -374,6 +381,41 @@ u32 gf_rtp_flush_rtp(GF_RTPChannel *ch, u8 *buffer, u32 buffer_size)
 	return 0;
 }
 
+static void gf_rtp_check_nat_keepalive(GF_RTPChannel *ch, Bool has_data)
+{
+	if (ch->nat_keepalive_time_period && !ch->send_interleave) {
+		u32 now = gf_sys_clock();
+		if (has_data) {
+			ch->last_nat_keepalive_time = now;
+		} else {
+			if (now - ch->last_nat_keepalive_time >= ch->nat_keepalive_time_period) {
+				GF_Err e;
+				char rtp_nat[12];
+				rtp_nat[0] = (u8) 0xC0;
+				rtp_nat[1] = ch->PayloadType;
+				rtp_nat[2] = (ch->last_pck_sn>>8)&0xFF;
+				rtp_nat[3] = (ch->last_pck_sn)&0xFF;
+				rtp_nat[4] = (ch->last_pck_ts>>24)&0xFF;
+				rtp_nat[5] = (ch->last_pck_ts>>16)&0xFF;
+				rtp_nat[6] = (ch->last_pck_ts>>8)&0xFF;
+				rtp_nat[7] = (ch->last_pck_ts)&0xFF;
+				rtp_nat[8] = (ch->SenderSSRC>>24)&0xFF;
+				rtp_nat[9] = (ch->SenderSSRC>>16)&0xFF;
+				rtp_nat[10] = (ch->SenderSSRC>>8)&0xFF;
+				rtp_nat[11] = (ch->SenderSSRC)&0xFF;
+				e = gf_sk_send(ch->rtp, rtp_nat, 12);
+				if (e) {
+					GF_LOG(GF_LOG_ERROR, GF_LOG_RTP, ("[RTP] Error sending NAT keep-alive packet: %s - disabling NAT\n", gf_error_to_string(e) ));
+					ch->nat_keepalive_time_period = 0;
+				} else {
+					GF_LOG(GF_LOG_DEBUG, GF_LOG_RTP, ("[RTP] Sending NAT keep-alive packet - response %s\n", gf_error_to_string(e) ));
+				}
+				ch->last_nat_keepalive_time = now;
+			}
+		}
+	}
+}
+
 GF_EXPORT
 u32 gf_rtp_read_rtp(GF_RTPChannel *ch, u8 *buffer, u32 buffer_size)
 {
@@ -412,37 +454,62 @@ u32 gf_rtp_read_rtp(GF_RTPChannel *ch, u8 *buffer, u32 buffer_size)
 		}
 	}
 	/*monitor keep-alive period*/
-	if (ch->nat_keepalive_time_period && !ch->send_interleave) {
-		u32 now = gf_sys_clock();
-		if (res) {
-			ch->last_nat_keepalive_time = now;
-		} else {
-			if (now - ch->last_nat_keepalive_time >= ch->nat_keepalive_time_period) {
-				char rtp_nat[12];
-				rtp_nat[0] = (u8) 0xC0;
-				rtp_nat[1] = ch->PayloadType;
-				rtp_nat[2] = (ch->last_pck_sn>>8)&0xFF;
-				rtp_nat[3] = (ch->last_pck_sn)&0xFF;
-				rtp_nat[4] = (ch->last_pck_ts>>24)&0xFF;
-				rtp_nat[5] = (ch->last_pck_ts>>16)&0xFF;
-				rtp_nat[6] = (ch->last_pck_ts>>8)&0xFF;
-				rtp_nat[7] = (ch->last_pck_ts)&0xFF;
-				rtp_nat[8] = (ch->SenderSSRC>>24)&0xFF;
-				rtp_nat[9] = (ch->SenderSSRC>>16)&0xFF;
-				rtp_nat[10] = (ch->SenderSSRC>>8)&0xFF;
-				rtp_nat[11] = (ch->SenderSSRC)&0xFF;
-				e = gf_sk_send(ch->rtp, rtp_nat, 12);
-				if (e) {
-					GF_LOG(GF_LOG_ERROR, GF_LOG_RTP, ("[RTP] Error sending NAT keep-alive packet: %s - disabling NAT\n", gf_error_to_string(e) ));
-					ch->nat_keepalive_time_period = 0;
-				} else {
-					GF_LOG(GF_LOG_DEBUG, GF_LOG_RTP, ("[RTP] Sending NAT keep-alive packet - response %s\n", gf_error_to_string(e) ));
-				}
-				ch->last_nat_keepalive_time = now;
+	gf_rtp_check_nat_keepalive(ch, res ? GF_TRUE : GF_FALSE);
+	return res;
+}
+
+GF_EXPORT
+u32 gf_rtp_read_rtp_batch(GF_RTPChannel *ch, GF_SockDatagram *dgrams, u32 nb_dgrams)
+{
+	GF_Err e;
+	u32 i, nb_recv=0, nb_pck=0, buffer_size;
+
+	//only if the socket exist (otherwise RTSP interleaved channel)
+	if (!ch || !ch->rtp || !dgrams || !nb_dgrams) return 0;
+	if (nb_dgrams > GF_SK_MAX_BATCH) nb_dgrams = GF_SK_MAX_BATCH;
+	buffer_size = dgrams[0].size;
+
+	e = gf_sk_receive_batch(ch->rtp, dgrams, nb_dgrams, &nb_recv);
+	if (e) nb_recv = 0;
+
+	for (i=0; i<nb_recv; i++) {
+		u32 size = dgrams[i].size;
+		u8 *buffer = dgrams[i].data;
+		if (size < 12) continue;
+
+		ch->total_bytes += size;
+		ch->total_pck++;
+		//add the packet to our Queue if any
+		if (ch->po) {
+			u32 seq_num = ((((u32)buffer[2]) << 8) & 0xFF00) | (buffer[3] & 0xFF);
+			gf_rtp_reorderer_add(ch->po, (void *) buffer, size, seq_num);
+		}
+		//move valid packets first
+		else {
+			if (nb_pck != i) {
+				GF_SockDatagram tmp = dgrams[nb_pck];
+				dgrams[nb_pck] = dgrams[i];
+				dgrams[i] = tmp;
 			}
+			nb_pck++;
 		}
 	}
-	return res;
+	//all packets were queued, get the ones ready
+	if (ch->po) {
+		while (nb_pck < nb_dgrams) {
+			u32 size;
+			char *pck = (char *) gf_rtp_reorderer_get(ch->po, &size, GF_FALSE);
+			if (!pck) break;
+			if (size > buffer_size) size = buffer_size;
+			memcpy(dgrams[nb_pck].data, pck, size);
+			dgrams[nb_pck].size = size;
+			gf_free(pck);
+			nb_pck++;
+		}
+	}
+	/*monitor keep-alive period*/
+	gf_rtp_check_nat_keepalive(ch, nb_pck ? GF_TRUE : GF_FALSE);
+	return nb_pck;
 }
 
 
@@ -664,12 +731,31 @@ GF_Err gf_rtp_send_packet(GF_RTPChannel *ch, GF_RTPHeader *rtp_hdr, u8 *pck, u32
 			e = ch->send_interleave(ch->interleave_cbk1, ch->interleave_cbk2, GF_FALSE, ch->send_buffer, Start + pck_size);
 		}
 	}
+	//queue packet
+	else if (ch->batch_max) {
+		u8 *dst = ch->batch_buffer + ch->nb_batch * ch->send_buffer_size;
+		if (fast_send) {
+			memcpy(dst, hdr, pck_size+12);
+			Start = 12;
+		} else {
+			memcpy(dst, ch->send_buffer, Start);
+			memcpy(dst + Start, pck, pck_size);
+		}
+		ch->batch[ch->nb_batch].data = dst;
+		ch->batch[ch->nb_batch].size = Start + pck_size;
+		ch->nb_batch++;
+		e = (ch->nb_batch == ch->batch_max) ? gf_rtp_flush_send(ch) : GF_OK;
+	}
 	//copy payload
-	else if (fast_send) {
-		e = gf_sk_send(ch->rtp, hdr, pck_size+12);
-	} else {
-		memcpy(ch->send_buffer + Start, pck, pck_size);
-		e = gf_sk_send(ch->rtp, ch->send_buffer, Start + pck_size);
+	else {
+		if (fast_send) {
+			e = gf_sk_send(ch->rtp, hdr, pck_size+12);
+		} else {
+			memcpy(ch->send_buffer + Start, pck, pck_size);
+			e = gf_sk_send(ch->rtp, ch->send_buffer, Start + pck_size);
+		}
+		ch->nb_send_calls++;
+		if (!e) ch->nb_send_pck++;
 	}
 	if (e) return e;
 
@@ -693,6 +779,52 @@ GF_Err gf_rtp_send_packet(GF_RTPChannel *ch, GF_RTPHeader *rtp_hdr, u8 *pck, u32
 	return GF_OK;
 }
 
+GF_EXPORT
+GF_Err gf_rtp_set_send_batch(GF_RTPChannel *ch, u32 nb_packets)
+{
+	if (!ch || !ch->send_buffer_size) return GF_BAD_PARAM;
+	if (ch->nb_batch) gf_rtp_flush_send(ch);
+	if (ch->batch_buffer) gf_free(ch->batch_buffer);
+	if (ch->batch) gf_free(ch->batch);
+	ch->batch_buffer = NULL;
+	ch->batch = NULL;
+	ch->batch_max = 0;
+
+	//no batch for RTSP interleaved channels
+	if ((nb_packets<=1) || !ch->rtp || ch->send_interleave) return GF_OK;
+	if (nb_packets > GF_SK_MAX_BATCH) nb_packets = GF_SK_MAX_BATCH;
+
+	ch->batch_buffer = gf_malloc(sizeof(u8) * ch->send_buffer_size * nb_packets);
+	ch->batch = gf_malloc(sizeof(GF_SockDatagram) * nb_packets);
+	if (!ch->batch_buffer || !ch->batch) return GF_OUT_OF_MEM;
+	ch->batch_max = nb_packets;
+	return GF_OK;
+}
+
+GF_EXPORT
+GF_Err gf_rtp_flush_send(GF_RTPChannel *ch)
+{
+	GF_Err e;
+	u32 nb_sent = 0;
+	if (!ch || !ch->nb_batch) return GF_OK;
+
+	e = gf_sk_send_batch(ch->rtp, ch->batch, ch->nb_batch, &nb_sent);
+	if (e) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_RTP, ("[RTP] Failed to send %d RTP packets: %s\n", ch->nb_batch - nb_sent, gf_error_to_string(e) ));
+	}
+	ch->nb_send_calls++;
+	ch->nb_send_pck += nb_sent;
+	ch->nb_batch = 0;
+	return e;
+}
+
+GF_EXPORT
+void gf_rtp_get_send_stats(GF_RTPChannel *ch, u64 *nb_calls, u64 *nb_packets)
+{
+	if (nb_calls) *nb_calls = ch ? ch->nb_send_calls : 0;
+	if (nb_packets) *nb_packets = ch ? ch->nb_send_pck : 0;
+}
+
 GF_EXPORT
 u32 gf_rtp_is_unicast(GF_RTPChannel *ch)
 {
@@ -786,6 +786,26 @@ GF_Err gf_rtp_streamer_send_bye(GF_RTPStreamer *streamer)
 	return gf_rtp_send_bye(streamer->channel);
 }
 
+GF_EXPORT
+GF_Err gf_rtp_streamer_set_send_batch(GF_RTPStreamer *streamer, u32 nb_packets)
+{
+	if (!streamer) return GF_BAD_PARAM;
+	return gf_rtp_set_send_batch(streamer->channel, nb_packets);
+}
+
+GF_EXPORT
+GF_Err gf_rtp_streamer_flush(GF_RTPStreamer *streamer)
+{
+	if (!streamer) return GF_BAD_PARAM;
+	return gf_rtp_flush_send(streamer->channel);
+}
+
+GF_EXPORT
+void gf_rtp_streamer_get_send_stats(GF_RTPStreamer *streamer, u64 *nb_calls, u64 *nb_packets)
+{
+	gf_rtp_get_send_stats(streamer ? streamer->channel : NULL, nb_calls, nb_packets);
+}
+
 GF_EXPORT
 u8 gf_rtp_streamer_get_payload_type(GF_RTPStreamer *streamer)
 {
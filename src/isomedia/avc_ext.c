@@ -179,7 +179,7 @@ static GF_Err process_extractor(GF_ISOFile *file, GF_MediaBox *mdia, u32 sampleN
 			if ((sample_offset<0) && (ref_sample_num > (u32) -sample_offset)) return GF_ISOM_INVALID_FILE;
 			ref_sample_num = (u32) ( (s32) ref_sample_num + sample_offset);
 
-			e = Media_GetSample(ref_trak->Media, ref_sample_num, &mdia->extracted_samp, &di, GF_FALSE, NULL);
+			e = Media_GetSample(ref_trak->Media, ref_sample_num, &mdia->extracted_samp, &di, GF_FALSE, NULL, NULL, NULL);
 			if (e) return e;
 			if (!mdia->extracted_samp->alloc_size)
 				mdia->extracted_samp->alloc_size = mdia->extracted_samp->dataLength;
@@ -411,6 +411,30 @@ static void nalu_merge_ps(GF_BitStream *ps_bs, Bool rewrite_start_codes, u32 nal
 }
 
 
+Bool gf_isom_nalu_sample_rewrite_is_inspect_only(GF_MediaBox *mdia, GF_MPEGVisualSampleEntryBox *entry)
+{
+	u32 track_num;
+	GF_TrackReferenceTypeBox *scal = NULL;
+	GF_ISOFile *file = mdia->mediaTrack->moov->mov;
+
+	if (mdia->mediaTrack->extractor_mode & (GF_ISOM_NALU_EXTRACT_INBAND_PS_FLAG|GF_ISOM_NALU_EXTRACT_ANNEXB_FLAG|GF_ISOM_NALU_EXTRACT_VDRD_FLAG))
+		return GF_FALSE;
+	//no aggregation nor rewrite in inspect mode
+	if ((mdia->mediaTrack->extractor_mode & 0x0000FFFF) == GF_ISOM_NALU_EXTRACT_INSPECT)
+		return GF_TRUE;
+
+	if (!entry || entry->svc_config || entry->mvc_config || entry->lhvc_config)
+		return GF_FALSE;
+
+	Track_FindRef(mdia->mediaTrack, GF_ISOM_REF_SCAL, &scal);
+	if (scal) return GF_FALSE;
+
+	track_num = 1 + gf_list_find(mdia->mediaTrack->moov->trackList, mdia->mediaTrack);
+	if (gf_isom_get_reference_count(file, track_num, GF_ISOM_REF_SABT) > 0) return GF_FALSE;
+	if (gf_isom_get_reference_count(file, track_num, GF_ISOM_REF_TBAS) > 0) return GF_FALSE;
+	return GF_TRUE;
+}
+
 GF_Err gf_isom_nalu_sample_rewrite(GF_MediaBox *mdia, GF_ISOSample *sample, u32 sampleNumber, GF_MPEGVisualSampleEntryBox *entry)
 {
 	Bool is_hevc = GF_FALSE;
@@ -4903,6 +4903,8 @@ void stbl_box_del(GF_Box *s)
 		}
 		gf_free(ptr->traf_map);
 	}
+	//child boxes may already be destroyed, only free the index
+	stbl_index_del(ptr->r_index);
 	gf_free(ptr);
 }
 
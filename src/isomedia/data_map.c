@@ -27,10 +27,6 @@
 #include <gpac/network.h>
 #include <gpac/thread.h>
 
-
-/*File Mapping object, read-only mode on complete files (no download)*/
-//#define GF_ISOM_DATA_FILE_MAPPING 0x02
-
 #ifndef GPAC_DISABLE_ISOM
 
 
@@ -47,11 +43,9 @@ void gf_isom_datamap_del(GF_DataMap *ptr)
 	case GF_ISOM_DATA_MEM:
 		gf_isom_fdm_del((GF_FileDataMap *)ptr);
 		break;
-#if 0
 	case GF_ISOM_DATA_FILE_MAPPING:
 		gf_isom_fmo_del((GF_FileMappingDataMap *)ptr);
 		break;
-#endif
 	default:
 		if (ptr->bs) gf_bs_del(ptr->bs);
 		gf_free(ptr);
@@ -278,10 +272,8 @@ u32 gf_isom_datamap_get_data(GF_DataMap *map, u8 *buffer, u32 bufferLength, u64
 	case GF_ISOM_DATA_MEM:
 		return gf_isom_fdm_get_data((GF_FileDataMap *)map, buffer, bufferLength, Offset);
 
-#if 0
 	case GF_ISOM_DATA_FILE_MAPPING:
 		return gf_isom_fmo_get_data((GF_FileMappingDataMap *)map, buffer, bufferLength, Offset);
-#endif
 
 	default:
 		return 0;
@@ -425,6 +417,7 @@ GF_DataMap *gf_isom_fdm_new(const char *sPath, u8 mode)
 				tmp->is_stdout = 1;
 			}
 
+			if (!tmp->stream && gf_opts_get_bool("core", "aio")) tmp->stream = gf_fopen_aio(sPath, "w+b", 0, 0, 0);
 			if (!tmp->stream) tmp->stream = gf_fopen(sPath, "w+b");
 			if (!tmp->stream) tmp->stream = gf_fopen(sPath, "wb");
 		}
@@ -572,127 +565,440 @@ GF_Err FDM_AddData(GF_FileDataMap *ptr, char *data, u32 dataSize)
 #endif	/*GPAC_DISABLE_ISOM_WRITE*/
 
 
-#if 0 //file mapping disabled
+/*size of the readahead window requested when sample reads leave the previous window*/
+#define GF_ISOM_FMO_READAHEAD	(4*1024*1024)
 
-#ifdef WIN32
+#if defined(WIN32) && !defined(_WIN32_WCE)
 
 #include <windows.h>
 #include <winerror.h>
 
-GF_DataMap *gf_isom_fmo_new(const char *sPath, u8 mode)
+GF_DataMap *gf_isom_fmo_new(const char *sPath, u8 mode, u64 max_size)
 {
 	GF_FileMappingDataMap *tmp;
 	HANDLE fileH, fileMapH;
-#ifdef _WIN32_WCE
-	unsigned short sWPath[MAX_PATH];
-#endif
+	LARGE_INTEGER fsize;
+	u8 *byte_map;
 
 	//only in read only
 	if (mode != GF_ISOM_DATA_MAP_READ) return NULL;
 
-	GF_SAFEALLOC(tmp, GF_FileMappingDataMap);
-	if (!tmp) return NULL;
-
-	tmp->type = GF_ISOM_DATA_FILE_MAPPING;
-	tmp->mode = mode;
-	tmp->name = gf_strdup(sPath);
-
-	//
-	//	Open the file
-	//
-#ifdef _WIN32_WCE
-	//convert to WIDE
-	CE_CharToWide((char *)sPath, sWPath);
-
-	fileH = CreateFileForMapping(sWPath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
-	                             (FILE_ATTRIBUTE_READONLY | FILE_FLAG_RANDOM_ACCESS), NULL );
-#else
 	fileH = CreateFile(sPath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
 	                   (FILE_ATTRIBUTE_READONLY | FILE_FLAG_RANDOM_ACCESS), NULL );
-#endif
+	if (fileH == INVALID_HANDLE_VALUE) return NULL;
 
-
-	if (fileH == INVALID_HANDLE_VALUE) {
-		gf_free(tmp->name);
-		gf_free(tmp);
-		return NULL;
-	}
-
-	tmp->file_size = GetFileSize(fileH, NULL);
-	if (tmp->file_size == 0xFFFFFFFF) {
+	if ((GetFileType(fileH) != FILE_TYPE_DISK) || !GetFileSizeEx(fileH, &fsize) || !fsize.QuadPart
+		|| (max_size && ((u64) fsize.QuadPart > max_size))
+		|| ((u64) fsize.QuadPart != (SIZE_T) fsize.QuadPart)
+	) {
 		CloseHandle(fileH);
-		gf_free(tmp->name);
-		gf_free(tmp);
 		return NULL;
 	}
 
-	//
-	//	Create the mapping
-	//
 	fileMapH = CreateFileMapping(fileH, NULL, PAGE_READONLY, 0, 0, NULL);
 	if (fileMapH == NULL) {
 		CloseHandle(fileH);
-		gf_free(tmp->name);
-		gf_free(tmp);
 		return NULL;
 	}
+	byte_map = MapViewOfFile(fileMapH, FILE_MAP_READ, 0, 0, 0);
+	//the view keeps a reference on the mapping object
+	CloseHandle(fileMapH);
+	CloseHandle(fileH);
+	if (byte_map == NULL) return NULL;
 
-	tmp->byte_map = MapViewOfFile(fileMapH, FILE_MAP_READ, 0, 0, 0);
-	if (tmp->byte_map == NULL) {
-		CloseHandle(fileMapH);
-		CloseHandle(fileH);
-		gf_free(tmp->name);
-		gf_free(tmp);
+	GF_SAFEALLOC(tmp, GF_FileMappingDataMap);
+	if (!tmp) {
+		UnmapViewOfFile(byte_map);
 		return NULL;
 	}
+	tmp->type = GF_ISOM_DATA_FILE_MAPPING;
+	tmp->mode = mode;
+	tmp->name = gf_strdup(sPath);
+	tmp->file_size = (u64) fsize.QuadPart;
+	tmp->byte_map = byte_map;
+	tmp->nb_refs = 1;
+	tmp->bs = gf_bs_new(tmp->byte_map, tmp->file_size, GF_BITSTREAM_READ);
+	if (!tmp->bs) {
+		gf_isom_fmo_unref(tmp);
+		return NULL;
+	}
+	return (GF_DataMap *)tmp;
+}
 
-	CloseHandle(fileH);
-	CloseHandle(fileMapH);
+static void gf_isom_fmo_unmap(GF_FileMappingDataMap *ptr)
+{
+	UnmapViewOfFile(ptr->byte_map);
+}
+
+#define gf_isom_fmo_advise(_ptr, _start, _size)
+
+#elif defined(GPAC_CONFIG_LINUX) || defined(GPAC_CONFIG_DARWIN)
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+GF_DataMap *gf_isom_fmo_new(const char *sPath, u8 mode, u64 max_size)
+{
+	GF_FileMappingDataMap *tmp;
+	struct stat st;
+	void *byte_map;
+	int fd;
+
+	//only in read only
+	if (mode != GF_ISOM_DATA_MAP_READ) return NULL;
 
-	//finaly open our bitstream (from buffer)
+	fd = open(sPath, O_RDONLY);
+	if (fd<0) return NULL;
+
+	//pipes, devices and files larger than the address space budget use regular file IO
+	if (fstat(fd, &st) || !S_ISREG(st.st_mode) || !st.st_size
+		|| (max_size && ((u64) st.st_size > max_size))
+		|| ((u64) st.st_size != (size_t) st.st_size)
+	) {
+		close(fd);
+		return NULL;
+	}
+	byte_map = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	//the mapping keeps a reference on the file
+	close(fd);
+	if (byte_map == MAP_FAILED) return NULL;
+	//samples are mostly read in file order, enable aggressive readahead and early release of pages already read
+	madvise(byte_map, (size_t) st.st_size, MADV_SEQUENTIAL);
+
+	GF_SAFEALLOC(tmp, GF_FileMappingDataMap);
+	if (!tmp) {
+		munmap(byte_map, (size_t) st.st_size);
+		return NULL;
+	}
+	tmp->type = GF_ISOM_DATA_FILE_MAPPING;
+	tmp->mode = mode;
+	tmp->name = gf_strdup(sPath);
+	tmp->file_size = (u64) st.st_size;
+	tmp->byte_map = byte_map;
+	tmp->nb_refs = 1;
 	tmp->bs = gf_bs_new(tmp->byte_map, tmp->file_size, GF_BITSTREAM_READ);
+	if (!tmp->bs) {
+		gf_isom_fmo_unref(tmp);
+		return NULL;
+	}
 	return (GF_DataMap *)tmp;
 }
 
-void gf_isom_fmo_del(GF_FileMappingDataMap *ptr)
+static void gf_isom_fmo_unmap(GF_FileMappingDataMap *ptr)
+{
+	munmap(ptr->byte_map, (size_t) ptr->file_size);
+}
+
+static void gf_isom_fmo_advise(GF_FileMappingDataMap *ptr, u64 start, u64 size)
+{
+	static u64 page_size = 0;
+	if (!page_size) page_size = (u64) sysconf(_SC_PAGESIZE);
+	//madvise requires a page-aligned address
+	size += start % page_size;
+	start -= start % page_size;
+	madvise(ptr->byte_map + start, (size_t) size, MADV_WILLNEED);
+}
+
+#else
+
+GF_DataMap *gf_isom_fmo_new(const char *sPath, u8 mode, u64 max_size)
+{
+	return NULL;
+}
+
+static void gf_isom_fmo_unmap(GF_FileMappingDataMap *ptr)
+{
+}
+
+#define gf_isom_fmo_advise(_ptr, _start, _size)
+
+#endif
+
+void gf_isom_fmo_ref(GF_FileMappingDataMap *ptr)
+{
+	if (!ptr || (ptr->type != GF_ISOM_DATA_FILE_MAPPING)) return;
+	safe_int_inc(&ptr->nb_refs);
+}
+
+void gf_isom_fmo_unref(GF_FileMappingDataMap *ptr)
 {
 	if (!ptr || (ptr->type != GF_ISOM_DATA_FILE_MAPPING)) return;
+	//sample payloads may still point to the mapping after the data map is destroyed
+	if (safe_int_dec(&ptr->nb_refs) != 0) return;
 
 	if (ptr->bs) gf_bs_del(ptr->bs);
-	if (ptr->byte_map) UnmapViewOfFile(ptr->byte_map);
-	gf_free(ptr->name);
+	if (ptr->byte_map) gf_isom_fmo_unmap(ptr);
+	if (ptr->name) gf_free(ptr->name);
 	gf_free(ptr);
 }
 
+void gf_isom_fmo_del(GF_FileMappingDataMap *ptr)
+{
+	gf_isom_fmo_unref(ptr);
+}
 
 u32 gf_isom_fmo_get_data(GF_FileMappingDataMap *ptr, u8 *buffer, u32 bufferLength, u64 fileOffset)
 {
 	//can we seek till that point ???
-	if (fileOffset > ptr->file_size) return 0;
+	if (fileOffset + bufferLength > ptr->file_size) return 0;
 
 	//we do only read operations, so trivial
 	memcpy(buffer, ptr->byte_map + fileOffset, bufferLength);
+	ptr->curPos = fileOffset + bufferLength;
 	return bufferLength;
 }
 
-#else
+const u8 *gf_isom_fmo_get_mapped_data(GF_FileMappingDataMap *ptr, u32 size, u64 fileOffset, u64 *advise_start, u64 *advise_end)
+{
+	if (!ptr || (ptr->type != GF_ISOM_DATA_FILE_MAPPING)) return NULL;
+	if (fileOffset + size > ptr->file_size) return NULL;
+
+	//sample left the readahead window of its track (first access, seek or next chunk), prefetch the following bytes
+	if (advise_start && advise_end && ((fileOffset < *advise_start) || (fileOffset + size > *advise_end))) {
+		u64 len = GF_ISOM_FMO_READAHEAD;
+		if (len < size) len = size;
+		if (fileOffset + len > ptr->file_size) len = ptr->file_size - fileOffset;
+		gf_isom_fmo_advise(ptr, fileOffset, len);
+		*advise_start = fileOffset;
+		*advise_end = fileOffset + len;
+	}
+	return ptr->byte_map + fileOffset;
+}
 
-GF_DataMap *gf_isom_fmo_new(const char *sPath, u8 mode)
+GF_ISOReadCache *gf_isom_rbc_new(u32 block_size, u32 max_blocks)
 {
-	return gf_isom_fdm_new(sPath, mode);
+	GF_ISOReadCache *cache;
+	if (!block_size || !max_blocks) return NULL;
+	GF_SAFEALLOC(cache, GF_ISOReadCache);
+	if (!cache) return NULL;
+	cache->type = GF_ISOM_DATA_READ_CACHE;
+	cache->block_size = block_size;
+	cache->max_blocks = max_blocks;
+	cache->nb_refs = 1;
+	cache->mx = gf_mx_new("ISOReadCache");
+	cache->blocks = gf_list_new();
+	cache->pool = gf_list_new();
+	if (!cache->mx || !cache->blocks || !cache->pool) {
+		if (cache->mx) gf_mx_del(cache->mx);
+		if (cache->blocks) gf_list_del(cache->blocks);
+		if (cache->pool) gf_list_del(cache->pool);
+		gf_free(cache);
+		return NULL;
+	}
+	return cache;
 }
 
-void gf_isom_fmo_del(GF_FileMappingDataMap *ptr)
+static void gf_isom_rbc_block_del(GF_ISOReadBlock *block)
 {
-	gf_isom_fdm_del((GF_FileDataMap *)ptr);
+	if (block->data) gf_free(block->data);
+	gf_free(block);
 }
 
-u32 gf_isom_fmo_get_data(GF_FileMappingDataMap *ptr, u8 *buffer, u32 bufferLength, u64 fileOffset)
+//cache mutex shall be held, returns GF_TRUE if the cache shall be destroyed
+static Bool gf_isom_rbc_unref_locked(GF_ISOReadCache *cache)
+{
+	assert(cache->nb_refs);
+	cache->nb_refs--;
+	return cache->nb_refs ? GF_FALSE : GF_TRUE;
+}
+
+static void gf_isom_rbc_destroy(GF_ISOReadCache *cache)
 {
-	return gf_isom_fdm_get_data((GF_FileDataMap *)ptr, buffer, bufferLength, fileOffset);
+	while (gf_list_count(cache->pool)) {
+		gf_isom_rbc_block_del(gf_list_pop_back(cache->pool));
+	}
+	gf_list_del(cache->pool);
+	gf_list_del(cache->blocks);
+	gf_mx_del(cache->mx);
+	gf_free(cache);
 }
 
-#endif //win32
-#endif //file mapping disabled
+//cache mutex shall be held, returns GF_TRUE if the cache shall be destroyed
+static Bool gf_isom_rbc_block_unref_locked(GF_ISOReadBlock *block)
+{
+	GF_ISOReadCache *cache = block->cache;
+	assert(block->nb_refs);
+	block->nb_refs--;
+	if (block->nb_refs) return GF_FALSE;
+
+	gf_list_del_item(cache->blocks, block);
+	//keep for reuse unless the file is closed
+	if ((cache->nb_refs>1) && (gf_list_count(cache->pool) < cache->max_blocks)) {
+		gf_list_add(cache->pool, block);
+	} else {
+		gf_isom_rbc_block_del(block);
+	}
+	//the block held a reference on the cache
+	return gf_isom_rbc_unref_locked(cache);
+}
+
+void gf_isom_rbc_ref(GF_ISOReadCache *cache)
+{
+	if (!cache) return;
+	gf_mx_p(cache->mx);
+	cache->nb_refs++;
+	gf_mx_v(cache->mx);
+}
+
+void gf_isom_rbc_unref(GF_ISOReadCache *cache)
+{
+	Bool destroy;
+	if (!cache) return;
+	gf_mx_p(cache->mx);
+	destroy = gf_isom_rbc_unref_locked(cache);
+	gf_mx_v(cache->mx);
+	if (destroy) gf_isom_rbc_destroy(cache);
+}
+
+void gf_isom_rbc_block_unref(GF_ISOReadBlock *block)
+{
+	Bool destroy;
+	GF_ISOReadCache *cache;
+	if (!block) return;
+	cache = block->cache;
+	gf_mx_p(cache->mx);
+	destroy = gf_isom_rbc_block_unref_locked(block);
+	gf_mx_v(cache->mx);
+	if (destroy) gf_isom_rbc_destroy(cache);
+}
+
+void gf_isom_rbc_del(GF_ISOReadCache *cache)
+{
+	u32 i;
+	Bool destroy = GF_FALSE;
+	if (!cache) return;
+	gf_mx_p(cache->mx);
+	//drop cache references, blocks used by sample payloads stay alive until released
+	for (i=0; i<gf_list_count(cache->blocks); i++) {
+		GF_ISOReadBlock *block = gf_list_get(cache->blocks, i);
+		if (!block->in_cache) continue;
+		block->in_cache = GF_FALSE;
+		if (block->nb_refs==1) i--;
+		destroy = gf_isom_rbc_block_unref_locked(block);
+	}
+	while (gf_list_count(cache->pool)) {
+		gf_isom_rbc_block_del(gf_list_pop_back(cache->pool));
+	}
+	if (!destroy)
+		destroy = gf_isom_rbc_unref_locked(cache);
+	gf_mx_v(cache->mx);
+	if (destroy) gf_isom_rbc_destroy(cache);
+}
+
+const u8 *gf_isom_rbc_get_data(GF_ISOReadCache *cache, GF_DataMap *map, u64 offset, u32 size, GF_ISOReadBlock **out_block)
+{
+	u32 i, count, nb_cached, read;
+	u64 end, map_size;
+	GF_ISOReadBlock *block, *lru;
+
+	*out_block = NULL;
+	if (!cache || !map || !map->bs || !size) return NULL;
+
+	gf_mx_p(cache->mx);
+	count = gf_list_count(cache->blocks);
+	nb_cached = 0;
+	lru = NULL;
+	for (i=0; i<count; i++) {
+		block = gf_list_get(cache->blocks, i);
+		if (!block->in_cache) continue;
+		nb_cached++;
+		lru = block;
+		if ((offset < block->offset) || (offset + size > block->offset + block->size))
+			continue;
+
+		//most recently used first
+		if (i) {
+			gf_list_rem(cache->blocks, i);
+			gf_list_insert(cache->blocks, block, 0);
+		}
+		block->nb_refs++;
+		gf_mx_v(cache->mx);
+		*out_block = block;
+		return block->data + (offset - block->offset);
+	}
+
+	//read a new block starting at the payload, covering the following samples of all tracks stored in this range
+	end = offset + MAX(size, cache->block_size);
+	map_size = gf_bs_get_size(map->bs);
+	if (end > map_size) map_size = gf_bs_get_refreshed_size(map->bs);
+	if (end > map_size) end = map_size;
+	if (end < offset + size) {
+		gf_mx_v(cache->mx);
+		return NULL;
+	}
+	//do not read again data already in cache
+	for (i=0; i<count; i++) {
+		block = gf_list_get(cache->blocks, i);
+		if (!block->in_cache) continue;
+		if ((block->offset >= offset + size) && (block->offset < end))
+			end = block->offset;
+	}
+
+	//cache full, drop the least recently used block
+	if (lru && (nb_cached >= cache->max_blocks)) {
+		lru->in_cache = GF_FALSE;
+		gf_isom_rbc_block_unref_locked(lru);
+	}
+	block = gf_list_pop_back(cache->pool);
+	gf_mx_v(cache->mx);
+
+	if (!block) {
+		GF_SAFEALLOC(block, GF_ISOReadBlock);
+		if (!block) return NULL;
+		block->type = GF_ISOM_DATA_READ_BLOCK;
+		block->cache = cache;
+	}
+	block->offset = offset;
+	block->size = (u32) (end - offset);
+	if (block->alloc_size < block->size) {
+		u8 *data = gf_realloc(block->data, block->size);
+		if (!data) {
+			gf_isom_rbc_block_del(block);
+			return NULL;
+		}
+		block->data = data;
+		block->alloc_size = block->size;
+	}
+	read = gf_isom_datamap_get_data(map, block->data, block->size, offset);
+
+	gf_mx_p(cache->mx);
+	if (read != block->size) {
+		if (gf_list_count(cache->pool) < cache->max_blocks) gf_list_add(cache->pool, block);
+		else gf_isom_rbc_block_del(block);
+		gf_mx_v(cache->mx);
+		return NULL;
+	}
+	cache->nb_reads++;
+	cache->bytes_read += block->size;
+	//one reference for the cache, one for the caller, and the block holds a reference on the cache
+	block->nb_refs = 2;
+	block->in_cache = GF_TRUE;
+	cache->nb_refs++;
+	gf_list_insert(cache->blocks, block, 0);
+	gf_mx_v(cache->mx);
+
+	*out_block = block;
+	return block->data;
+}
+
+void gf_isom_rbc_release_payload(GF_ISOReadCache *cache, const u8 *data)
+{
+	u32 i, count;
+	Bool destroy = GF_FALSE;
+	if (!cache) return;
+	gf_mx_p(cache->mx);
+	count = gf_list_count(cache->blocks);
+	for (i=0; i<count; i++) {
+		GF_ISOReadBlock *block = gf_list_get(cache->blocks, i);
+		if ((data >= block->data) && (data < block->data + block->size)) {
+			destroy = gf_isom_rbc_block_unref_locked(block);
+			break;
+		}
+	}
+	gf_mx_v(cache->mx);
+	if (destroy) gf_isom_rbc_destroy(cache);
+}
 
 #endif /*GPAC_DISABLE_ISOM*/
@@ -892,6 +892,7 @@ void gf_isom_delete_movie(GF_ISOFile *mov)
 
 	//these are our two main files
 	if (mov->movieFileMap) gf_isom_datamap_del(mov->movieFileMap);
+	if (mov->block_cache) gf_isom_rbc_del(mov->block_cache);
 
 #ifndef GPAC_DISABLE_ISOM_WRITE
 	if (mov->editFileMap) {
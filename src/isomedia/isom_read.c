@@ -1767,8 +1767,7 @@ GF_Err gf_isom_get_sample_flags(GF_ISOFile *the_file, u32 trackNumber, u32 sampl
 //return a sample give its number, and set the SampleDescIndex of this sample
 //this index allows to retrieve the stream description if needed (2 media in 1 track)
 //return NULL if error
-GF_EXPORT
-GF_ISOSample *gf_isom_get_sample_ex(GF_ISOFile *the_file, u32 trackNumber, u32 sampleNumber, u32 *sampleDescriptionIndex, GF_ISOSample *static_sample, u64 *data_offset)
+static GF_ISOSample *gf_isom_get_sample_internal(GF_ISOFile *the_file, u32 trackNumber, u32 sampleNumber, u32 *sampleDescriptionIndex, GF_ISOSample *static_sample, u64 *data_offset, const u8 **mapped_data, void **mapping)
 {
 	GF_Err e;
 	u32 descIndex;
@@ -1780,7 +1779,8 @@ GF_ISOSample *gf_isom_get_sample_ex(GF_ISOFile *the_file, u32 trackNumber, u32 s
 	if (!sampleNumber) return NULL;
 	if (static_sample) {
 		samp = static_sample;
-		if (static_sample->dataLength && !static_sample->alloc_size)
+		//data may be NULL if the previous payload was read from a file mapping
+		if (static_sample->data && static_sample->dataLength && !static_sample->alloc_size)
 			static_sample->alloc_size = static_sample->dataLength;
 	} else {
 		samp = gf_isom_sample_new();
@@ -1793,11 +1793,16 @@ GF_ISOSample *gf_isom_get_sample_ex(GF_ISOFile *the_file, u32 trackNumber, u32 s
 	sampleNumber -= trak->sample_count_at_seg_start;
 #endif
 
-	e = Media_GetSample(trak->Media, sampleNumber, &samp, &descIndex, GF_FALSE, data_offset);
-	if (static_sample && !static_sample->alloc_size)
+	e = Media_GetSample(trak->Media, sampleNumber, &samp, &descIndex, GF_FALSE, data_offset, mapped_data, mapping);
+	if (static_sample && static_sample->data && !static_sample->alloc_size)
 		static_sample->alloc_size = static_sample->dataLength;
 
 	if (e) {
+		if (mapping && *mapping) {
+			gf_isom_release_mapped_data(*mapping);
+			*mapping = NULL;
+			*mapped_data = NULL;
+		}
 		gf_isom_set_last_error(the_file, e);
 		if (!static_sample) gf_isom_sample_del(&samp);
 		return NULL;
@@ -1810,6 +1815,414 @@ GF_ISOSample *gf_isom_get_sample_ex(GF_ISOFile *the_file, u32 trackNumber, u32 s
 	return samp;
 }
 
+GF_EXPORT
+GF_ISOSample *gf_isom_get_sample_ex(GF_ISOFile *the_file, u32 trackNumber, u32 sampleNumber, u32 *sampleDescriptionIndex, GF_ISOSample *static_sample, u64 *data_offset)
+{
+	return gf_isom_get_sample_internal(the_file, trackNumber, sampleNumber, sampleDescriptionIndex, static_sample, data_offset, NULL, NULL);
+}
+
+GF_EXPORT
+GF_ISOSample *gf_isom_get_sample_mapped(GF_ISOFile *the_file, u32 trackNumber, u32 sampleNumber, u32 *sampleDescriptionIndex, GF_ISOSample *static_sample, u64 *data_offset, const u8 **mapped_data, void **mapping)
+{
+	if (!mapped_data || !mapping) return NULL;
+	*mapped_data = NULL;
+	*mapping = NULL;
+	return gf_isom_get_sample_internal(the_file, trackNumber, sampleNumber, sampleDescriptionIndex, static_sample, data_offset, mapped_data, mapping);
+}
+
+GF_EXPORT
+void *gf_isom_get_file_mapping(GF_ISOFile *movie)
+{
+	if (!movie || !movie->movieFileMap) return NULL;
+	if (movie->movieFileMap->type == GF_ISOM_DATA_FILE_MAPPING) {
+		gf_isom_fmo_ref((GF_FileMappingDataMap *) movie->movieFileMap);
+		return movie->movieFileMap;
+	}
+	if (movie->block_cache) {
+		gf_isom_rbc_ref(movie->block_cache);
+		return movie->block_cache;
+	}
+	return NULL;
+}
+
+GF_EXPORT
+void gf_isom_release_mapped_data(void *mapping)
+{
+	if (!mapping) return;
+	//all objects start with their type
+	switch (*(u8 *) mapping) {
+	case GF_ISOM_DATA_READ_BLOCK:
+		gf_isom_rbc_block_unref((GF_ISOReadBlock *) mapping);
+		break;
+	case GF_ISOM_DATA_READ_CACHE:
+		gf_isom_rbc_unref((GF_ISOReadCache *) mapping);
+		break;
+	default:
+		gf_isom_fmo_unref((GF_FileMappingDataMap *) mapping);
+		break;
+	}
+}
+
+GF_EXPORT
+void gf_isom_release_mapped_payload(void *file_mapping, const u8 *data)
+{
+	if (!file_mapping) return;
+	if (*(u8 *) file_mapping == GF_ISOM_DATA_READ_CACHE)
+		gf_isom_rbc_release_payload((GF_ISOReadCache *) file_mapping, data);
+	else
+		gf_isom_fmo_unref((GF_FileMappingDataMap *) file_mapping);
+}
+
+GF_EXPORT
+GF_Err gf_isom_enable_block_reads(GF_ISOFile *movie, u32 block_size, u32 max_blocks)
+{
+	GF_FileDataMap *fdm;
+	if (!movie || !movie->movieFileMap) return GF_BAD_PARAM;
+	if (movie->openMode != GF_ISOM_OPEN_READ) return GF_BAD_PARAM;
+
+	if (movie->block_cache) {
+		gf_isom_rbc_del(movie->block_cache);
+		movie->block_cache = NULL;
+	}
+	if (!block_size) return GF_OK;
+	//mapped files are already read without copy
+	if (movie->movieFileMap->type != GF_ISOM_DATA_FILE) return GF_NOT_SUPPORTED;
+	fdm = (GF_FileDataMap *)movie->movieFileMap;
+	//memory blobs are already in memory, files opened with a byte range are not supported
+	if (fdm->blob || !fdm->stream || movie->read_byte_offset || movie->bytes_removed) return GF_NOT_SUPPORTED;
+
+	if (!max_blocks) max_blocks = 4;
+	movie->block_cache = gf_isom_rbc_new(block_size, max_blocks);
+	if (!movie->block_cache) return GF_OUT_OF_MEM;
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_CONTAINER, ("[IsoMedia] File %s using block reads of %u bytes, %u blocks in cache\n", movie->fileName, block_size, max_blocks));
+	return GF_OK;
+}
+
+GF_EXPORT
+GF_Err gf_isom_get_block_read_stats(GF_ISOFile *movie, u64 *nb_reads, u64 *nb_bytes)
+{
+	if (!movie || !movie->block_cache) return GF_BAD_PARAM;
+	gf_mx_p(movie->block_cache->mx);
+	if (nb_reads) *nb_reads = movie->block_cache->nb_reads;
+	if (nb_bytes) *nb_bytes = movie->block_cache->bytes_read;
+	gf_mx_v(movie->block_cache->mx);
+	return GF_OK;
+}
+
+GF_EXPORT
+GF_Err gf_isom_enable_file_mapping(GF_ISOFile *movie, u64 max_size)
+{
+	u32 i;
+	GF_DataMap *map, *prev_map;
+	GF_FileDataMap *fdm;
+	if (!movie || !movie->movieFileMap || !movie->fileName) return GF_BAD_PARAM;
+	if (movie->openMode != GF_ISOM_OPEN_READ) return GF_BAD_PARAM;
+	if (movie->movieFileMap->type == GF_ISOM_DATA_FILE_MAPPING) return GF_OK;
+	if (movie->movieFileMap->type != GF_ISOM_DATA_FILE) return GF_NOT_SUPPORTED;
+
+	fdm = (GF_FileDataMap *)movie->movieFileMap;
+	//memory blobs and gfio are not mapped, nor files opened with a byte range
+	if (fdm->blob || !fdm->stream || movie->read_byte_offset || movie->bytes_removed) return GF_NOT_SUPPORTED;
+	if (!gf_url_is_local(movie->fileName)) return GF_NOT_SUPPORTED;
+
+	map = gf_isom_fmo_new(movie->fileName, GF_ISOM_DATA_MAP_READ, max_size);
+	if (!map) return GF_NOT_SUPPORTED;
+	//size mismatch (range, file being modified): keep regular file IO
+	if (gf_bs_get_size(map->bs) != gf_bs_get_refreshed_size(fdm->bs)) {
+		gf_isom_datamap_del(map);
+		return GF_NOT_SUPPORTED;
+	}
+	gf_bs_seek(map->bs, gf_bs_get_position(fdm->bs));
+
+	prev_map = movie->movieFileMap;
+	if (movie->moov) {
+		for (i=0; i<gf_list_count(movie->moov->trackList); i++) {
+			GF_TrackBox *trak = (GF_TrackBox *)gf_list_get(movie->moov->trackList, i);
+			if (!trak->Media || !trak->Media->information) continue;
+			if (trak->Media->information->dataHandler == prev_map)
+				trak->Media->information->dataHandler = map;
+			if (trak->Media->information->scalableDataHandler == prev_map)
+				trak->Media->information->scalableDataHandler = map;
+		}
+	}
+	movie->movieFileMap = map;
+	gf_isom_datamap_del(prev_map);
+	//no longer used, blocks are released with the payloads still using them
+	if (movie->block_cache) {
+		gf_isom_rbc_del(movie->block_cache);
+		movie->block_cache = NULL;
+	}
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_CONTAINER, ("[IsoMedia] File %s memory-mapped ("LLU" bytes)\n", movie->fileName, gf_bs_get_size(map->bs)));
+	return GF_OK;
+}
+
+static GF_Err gf_isom_check_sample_index(GF_ISOFile *movie)
+{
+	if (!movie || !movie->moov) return GF_BAD_PARAM;
+	if (movie->openMode != GF_ISOM_OPEN_READ) return GF_NOT_SUPPORTED;
+#ifndef GPAC_DISABLE_ISOM_FRAGMENTS
+	//sample tables of fragmented files change over time
+	if (movie->moov->mvex) return GF_NOT_SUPPORTED;
+#endif
+	return GF_OK;
+}
+
+GF_EXPORT
+GF_Err gf_isom_set_sample_index(GF_ISOFile *movie, u32 trackNumber, GF_ISOSampleIndexMode mode)
+{
+	u32 i, count;
+	GF_Err e = gf_isom_check_sample_index(movie);
+	if (e) return e;
+
+	count = gf_list_count(movie->moov->trackList);
+	for (i=0; i<count; i++) {
+		GF_SampleTableBox *stbl;
+		GF_TrackBox *trak = (GF_TrackBox *)gf_list_get(movie->moov->trackList, i);
+		if (trackNumber && (trackNumber != i+1)) continue;
+		if (!trak->Media || !trak->Media->information || !trak->Media->information->sampleTable) continue;
+		stbl = trak->Media->information->sampleTable;
+
+		switch (mode) {
+		case GF_ISOM_SAMPLE_INDEX_NONE:
+			stbl_del_index(stbl);
+			break;
+		case GF_ISOM_SAMPLE_INDEX_LAZY:
+			if (!stbl->r_index) stbl->r_index_lazy = GF_TRUE;
+			break;
+		default:
+			e = stbl_build_index(stbl);
+			if (e==GF_NOT_SUPPORTED) e = GF_OK;
+			if (e) return e;
+			break;
+		}
+	}
+	return GF_OK;
+}
+
+#define GF_ISOM_SAMPLE_INDEX_MAGIC	GF_4CC('G','S','I','X')
+
+enum
+{
+	GF_ISOM_SAMPLE_INDEX_HAS_OFFSETS = 1,
+	GF_ISOM_SAMPLE_INDEX_HAS_DTS = 1<<1,
+	GF_ISOM_SAMPLE_INDEX_HAS_CTS = 1<<2,
+};
+
+//signature of the tables the index is computed from
+static u32 gf_isom_sample_index_crc(GF_SampleTableBox *stbl)
+{
+	if (!stbl->ChunkOffset) return 0;
+	if (stbl->ChunkOffset->type == GF_ISOM_BOX_TYPE_STCO) {
+		GF_ChunkOffsetBox *stco = (GF_ChunkOffsetBox *)stbl->ChunkOffset;
+		if (!stco->offsets) return 0;
+		return gf_crc_32((u8 *) stco->offsets, sizeof(u32) * stco->nb_entries);
+	} else {
+		GF_ChunkLargeOffsetBox *co64 = (GF_ChunkLargeOffsetBox *)stbl->ChunkOffset;
+		if (!co64->offsets) return 0;
+		return gf_crc_32((u8 *) co64->offsets, sizeof(u64) * co64->nb_entries);
+	}
+}
+
+static void gf_isom_sample_index_write_signature(GF_BitStream *bs, GF_TrackBox *trak)
+{
+	GF_SampleTableBox *stbl = trak->Media->information->sampleTable;
+	gf_bs_write_u32(bs, trak->Header->trackID);
+	gf_bs_write_u32(bs, stbl->SampleSize ? stbl->SampleSize->sampleCount : 0);
+	gf_bs_write_u32(bs, stbl->SampleToChunk ? stbl->SampleToChunk->nb_entries : 0);
+	gf_bs_write_u32(bs, stbl->TimeToSample ? stbl->TimeToSample->nb_entries : 0);
+	gf_bs_write_u32(bs, stbl->CompositionOffset ? stbl->CompositionOffset->nb_entries : 0);
+	gf_bs_write_u32(bs, gf_isom_sample_index_crc(stbl));
+}
+
+static Bool gf_isom_sample_index_check_signature(GF_BitStream *bs, GF_TrackBox *trak)
+{
+	Bool ok = GF_TRUE;
+	GF_SampleTableBox *stbl = trak->Media->information->sampleTable;
+	if (gf_bs_read_u32(bs) != (stbl->SampleSize ? stbl->SampleSize->sampleCount : 0)) ok = GF_FALSE;
+	if (gf_bs_read_u32(bs) != (stbl->SampleToChunk ? stbl->SampleToChunk->nb_entries : 0)) ok = GF_FALSE;
+	if (gf_bs_read_u32(bs) != (stbl->TimeToSample ? stbl->TimeToSample->nb_entries : 0)) ok = GF_FALSE;
+	if (gf_bs_read_u32(bs) != (stbl->CompositionOffset ? stbl->CompositionOffset->nb_entries : 0)) ok = GF_FALSE;
+	if (gf_bs_read_u32(bs) != gf_isom_sample_index_crc(stbl)) ok = GF_FALSE;
+	return ok;
+}
+
+//arrays are stored as big-endian 32 or 64 bit integers, written and read in blocks
+static void gf_isom_sample_index_write_array(GF_BitStream *bs, const void *array, u32 count, u32 item_size)
+{
+	u8 buf[4096];
+	u32 i, j, k = 0;
+	for (i=0; i<count; i++) {
+		u64 v = (item_size==8) ? ((const u64 *)array)[i] : ((const u32 *)array)[i];
+		for (j=item_size; j>0; j--) buf[k++] = (u8) (v >> (8*(j-1)));
+		if (k == sizeof(buf)) {
+			gf_bs_write_data(bs, buf, k);
+			k = 0;
+		}
+	}
+	if (k) gf_bs_write_data(bs, buf, k);
+}
+
+static void gf_isom_sample_index_read_array(GF_BitStream *bs, void *array, u32 count, u32 item_size)
+{
+	u32 i, j;
+	u8 *p = (u8 *)array;
+	gf_bs_read_data(bs, (u8 *)array, count * item_size);
+	//convert in place, items are read before being overwritten
+	for (i=0; i<count; i++, p+=item_size) {
+		u64 v = 0;
+		for (j=0; j<item_size; j++) v = (v<<8) | p[j];
+		if (item_size==8) ((u64 *)array)[i] = v;
+		else ((u32 *)array)[i] = (u32) v;
+	}
+}
+
+GF_EXPORT
+GF_Err gf_isom_save_sample_index(GF_ISOFile *movie, const char *file_name)
+{
+	u32 i, count, nb_idx;
+	FILE *f;
+	GF_BitStream *bs;
+	GF_Err e = gf_isom_check_sample_index(movie);
+	if (e) return e;
+	if (!file_name) return GF_BAD_PARAM;
+
+	count = gf_list_count(movie->moov->trackList);
+	nb_idx = 0;
+	for (i=0; i<count; i++) {
+		GF_TrackBox *trak = (GF_TrackBox *)gf_list_get(movie->moov->trackList, i);
+		if (trak->Media && trak->Media->information && trak->Media->information->sampleTable && trak->Media->information->sampleTable->r_index)
+			nb_idx++;
+	}
+	f = gf_fopen(file_name, "wb");
+	if (!f) return GF_IO_ERR;
+	bs = gf_bs_from_file(f, GF_BITSTREAM_WRITE);
+	if (!bs) {
+		gf_fclose(f);
+		return GF_OUT_OF_MEM;
+	}
+	gf_bs_write_u32(bs, GF_ISOM_SAMPLE_INDEX_MAGIC);
+	gf_bs_write_u32(bs, 1);
+	gf_bs_write_u32(bs, nb_idx);
+
+	for (i=0; i<count; i++) {
+		GF_SampleTableIndex *index;
+		GF_TrackBox *trak = (GF_TrackBox *)gf_list_get(movie->moov->trackList, i);
+		if (!trak->Media || !trak->Media->information || !trak->Media->information->sampleTable) continue;
+		index = trak->Media->information->sampleTable->r_index;
+		if (!index) continue;
+
+		gf_isom_sample_index_write_signature(bs, trak);
+		gf_bs_write_u32(bs, index->nb_chunks);
+		gf_bs_write_u32(bs, index->first_delta);
+		gf_bs_write_u32(bs, index->last_delta);
+		gf_bs_write_u8(bs, (index->offsets ? GF_ISOM_SAMPLE_INDEX_HAS_OFFSETS : 0)
+			| (index->dts ? GF_ISOM_SAMPLE_INDEX_HAS_DTS : 0)
+			| (index->cts_offsets ? GF_ISOM_SAMPLE_INDEX_HAS_CTS : 0)
+		);
+		gf_isom_sample_index_write_array(bs, index->chunk_first_sample, index->nb_chunks, 4);
+		gf_isom_sample_index_write_array(bs, index->chunk_stsc_idx, index->nb_chunks, 4);
+		if (index->offsets) gf_isom_sample_index_write_array(bs, index->offsets, index->nb_samples, 8);
+		if (index->dts) gf_isom_sample_index_write_array(bs, index->dts, index->nb_samples, 8);
+		if (index->cts_offsets) gf_isom_sample_index_write_array(bs, index->cts_offsets, index->nb_samples, 4);
+	}
+	gf_bs_del(bs);
+	gf_fclose(f);
+	return GF_OK;
+}
+
+GF_EXPORT
+GF_Err gf_isom_load_sample_index(GF_ISOFile *movie, const char *file_name)
+{
+	u32 i, nb_idx;
+	FILE *f;
+	GF_BitStream *bs;
+	GF_Err e = gf_isom_check_sample_index(movie);
+	if (e) return e;
+	if (!file_name) return GF_BAD_PARAM;
+
+	f = gf_fopen(file_name, "rb");
+	if (!f) return GF_URL_ERROR;
+	bs = gf_bs_from_file(f, GF_BITSTREAM_READ);
+	if (!bs) {
+		gf_fclose(f);
+		return GF_OUT_OF_MEM;
+	}
+	if ((gf_bs_read_u32(bs) != GF_ISOM_SAMPLE_INDEX_MAGIC) || (gf_bs_read_u32(bs) != 1)) {
+		e = GF_NOT_SUPPORTED;
+		goto exit;
+	}
+	nb_idx = gf_bs_read_u32(bs);
+	for (i=0; i<nb_idx; i++) {
+		u8 flags;
+		u32 nb_samples, nb_chunks;
+		Bool valid;
+		GF_SampleTableIndex *index;
+		GF_TrackBox *trak = GetTrackbyID(movie->moov, gf_bs_read_u32(bs));
+		//read signature as is, it is checked once the index is loaded
+		u32 pos = (u32) gf_bs_get_position(bs);
+
+		nb_samples = gf_bs_read_u32(bs);
+		gf_bs_skip_bytes(bs, 16);
+		nb_chunks = gf_bs_read_u32(bs);
+		GF_SAFEALLOC(index, GF_SampleTableIndex);
+		if (!index) {
+			e = GF_OUT_OF_MEM;
+			goto exit;
+		}
+		index->nb_samples = nb_samples;
+		index->nb_chunks = nb_chunks;
+		index->first_delta = gf_bs_read_u32(bs);
+		index->last_delta = gf_bs_read_u32(bs);
+		flags = gf_bs_read_u8(bs);
+		if (gf_bs_available(bs) < 8 * (u64) nb_chunks + (u64) nb_samples * (
+			((flags & GF_ISOM_SAMPLE_INDEX_HAS_OFFSETS) ? 8 : 0) + ((flags & GF_ISOM_SAMPLE_INDEX_HAS_DTS) ? 8 : 0) + ((flags & GF_ISOM_SAMPLE_INDEX_HAS_CTS) ? 4 : 0))
+		) {
+			gf_free(index);
+			e = GF_NON_COMPLIANT_BITSTREAM;
+			goto exit;
+		}
+		index->chunk_first_sample = gf_malloc(sizeof(u32) * nb_chunks);
+		index->chunk_stsc_idx = gf_malloc(sizeof(u32) * nb_chunks);
+		if (flags & GF_ISOM_SAMPLE_INDEX_HAS_OFFSETS) index->offsets = gf_malloc(sizeof(u64) * nb_samples);
+		if (flags & GF_ISOM_SAMPLE_INDEX_HAS_DTS) index->dts = gf_malloc(sizeof(u64) * nb_samples);
+		if (flags & GF_ISOM_SAMPLE_INDEX_HAS_CTS) index->cts_offsets = gf_malloc(sizeof(s32) * nb_samples);
+		if (!index->chunk_first_sample || !index->chunk_stsc_idx
+			|| ((flags & GF_ISOM_SAMPLE_INDEX_HAS_OFFSETS) && !index->offsets)
+			|| ((flags & GF_ISOM_SAMPLE_INDEX_HAS_DTS) && !index->dts)
+			|| ((flags & GF_ISOM_SAMPLE_INDEX_HAS_CTS) && !index->cts_offsets)
+		) {
+			stbl_index_del(index);
+			e = GF_OUT_OF_MEM;
+			goto exit;
+		}
+		gf_isom_sample_index_read_array(bs, index->chunk_first_sample, nb_chunks, 4);
+		gf_isom_sample_index_read_array(bs, index->chunk_stsc_idx, nb_chunks, 4);
+		if (index->offsets) gf_isom_sample_index_read_array(bs, index->offsets, nb_samples, 8);
+		if (index->dts) gf_isom_sample_index_read_array(bs, index->dts, nb_samples, 8);
+		if (index->cts_offsets) gf_isom_sample_index_read_array(bs, index->cts_offsets, nb_samples, 4);
+
+		valid = GF_FALSE;
+		if (trak && trak->Media && trak->Media->information && trak->Media->information->sampleTable) {
+			u64 end = gf_bs_get_position(bs);
+			gf_bs_seek(bs, pos);
+			valid = gf_isom_sample_index_check_signature(bs, trak);
+			gf_bs_seek(bs, end);
+			if (valid && stbl_set_index(trak->Media->information->sampleTable, index))
+				valid = GF_FALSE;
+		}
+		if (!valid) {
+			GF_LOG(GF_LOG_WARNING, GF_LOG_CONTAINER, ("[iso file] Sample index for track %d in %s does not match the sample tables, ignoring\n", trak ? trak->Header->trackID : 0, file_name));
+			stbl_index_del(index);
+			e = GF_NON_COMPLIANT_BITSTREAM;
+		}
+	}
+
+exit:
+	gf_bs_del(bs);
+	gf_fclose(f);
+	return e;
+}
+
 GF_EXPORT
 GF_ISOSample *gf_isom_get_sample(GF_ISOFile *the_file, u32 trackNumber, u32 sampleNumber, u32 *sampleDescriptionIndex)
 {
@@ -1928,7 +2341,7 @@ GF_ISOSample *gf_isom_get_sample_info_ex(GF_ISOFile *the_file, u32 trackNumber,
 		if (!samp) return NULL;
 	}
 
-	e = Media_GetSample(trak->Media, sampleNumber, &samp, sampleDescriptionIndex, GF_TRUE, data_offset);
+	e = Media_GetSample(trak->Media, sampleNumber, &samp, sampleDescriptionIndex, GF_TRUE, data_offset, NULL, NULL);
 	if (e) {
 		gf_isom_set_last_error(the_file, e);
 		if (!static_sample)
@@ -2125,7 +2538,7 @@ GF_Err gf_isom_get_sample_for_media_time(GF_ISOFile *the_file, u32 trackNumber,
 		}
 	}
 
-	e = Media_GetSample(trak->Media, sampleNumber, sample, StreamDescriptionIndex, GF_FALSE, data_offset);
+	e = Media_GetSample(trak->Media, sampleNumber, sample, StreamDescriptionIndex, GF_FALSE, data_offset, NULL, NULL);
 	if (e) {
 		if (!static_sample)
 			gf_isom_sample_del(sample);
@@ -865,6 +865,15 @@ GF_Err DoWrite(MovieWriter *mw, GF_List *writers, GF_BitStream *bs, u8 Emulation
 }
 
 
+//moov written in reserved space, append the header of the free box covering the rest of the reservation
+static void write_reserve_free(GF_ISOFile *movie, GF_BitStream *moov_bs)
+{
+	u32 remain = movie->moov_reserve - movie->moov_reserve_used;
+	if (!remain) return;
+	gf_bs_write_u32(moov_bs, remain);
+	gf_bs_write_u32(moov_bs, GF_ISOM_BOX_TYPE_FREE);
+}
+
 //write the file track by track, with moov box before or after the mdat
 static GF_Err WriteFlat(MovieWriter *mw, u8 moovFirst, GF_BitStream *bs, Bool non_seakable, Bool for_fragments, GF_BitStream *moov_bs)
 {
@@ -876,6 +885,7 @@ static GF_Err WriteFlat(MovieWriter *mw, u8 moovFirst, GF_BitStream *bs, Bool no
 	GF_ISOFile *movie = mw->movie;
 	s32 moov_meta_pos=-1;
 
+	movie->moov_in_reserve = GF_FALSE;
 	//in case we did a read on the file while producing it, seek to end of edit
 	totSize = gf_bs_get_size(bs);
 	if (gf_bs_get_position(bs) != totSize) {
@@ -1021,23 +1031,38 @@ static GF_Err WriteFlat(MovieWriter *mw, u8 moovFirst, GF_BitStream *bs, Bool no
 		}
 
 		if (moov_bs) {
+			Bool has_reserve = GF_FALSE;
 			e = DoWrite(mw, writers, bs, 1, movie->mdat->bsOffset);
 			if (e) goto exit;
 
+			//reserved space is only written with the first media data
+			if (movie->moov_reserve && (movie->mdat->bsOffset >= movie->moov_reserve_offset + movie->moov_reserve))
+				has_reserve = GF_TRUE;
+
 			firstSize = GetMoovAndMetaSize(movie, writers);
+			movie->moov_reserve_used = (u32) firstSize;
 
-			offset = firstSize;
-			e = ShiftOffset(movie, writers, offset);
-			if (e) goto exit;
-			//get the size and see if it has changed (eg, we moved to 64 bit offsets)
-			finalSize = GetMoovAndMetaSize(movie, writers);
-			if (firstSize != finalSize) {
-				finalOffset = finalSize;
-				//OK, now we're sure about the final size.
-				//we don't need to re-emulate, as the only thing that changed is the offset
-				//so just shift the offset
-				e = ShiftOffset(movie, writers, finalOffset - offset);
+			//moov fits in the space reserved before mdat (exactly or leaving room for a free box), offsets are final
+			if (has_reserve && ((firstSize==movie->moov_reserve) || (firstSize + 8 <= movie->moov_reserve))) {
+				movie->moov_in_reserve = GF_TRUE;
+			} else {
+				if (has_reserve) {
+					GF_LOG(GF_LOG_WARNING, GF_LOG_CONTAINER, ("[ISOBMFF] moov size "LLU" does not fit in reserved space of %u bytes, inserting moov before mdat\n", firstSize, movie->moov_reserve));
+				}
+				offset = firstSize;
+				e = ShiftOffset(movie, writers, offset);
 				if (e) goto exit;
+				//get the size and see if it has changed (eg, we moved to 64 bit offsets)
+				finalSize = GetMoovAndMetaSize(movie, writers);
+				if (firstSize != finalSize) {
+					finalOffset = finalSize;
+					//OK, now we're sure about the final size.
+					//we don't need to re-emulate, as the only thing that changed is the offset
+					//so just shift the offset
+					e = ShiftOffset(movie, writers, finalOffset - offset);
+					if (e) goto exit;
+					movie->moov_reserve_used = (u32) finalSize;
+				}
 			}
 		}
 		//get real sample offsets for meta items
@@ -1824,10 +1849,14 @@ GF_Err WriteToFile(GF_ISOFile *movie, Bool for_fragments)
 				u8 *moov_data;
 				u32 moov_size;
 
+				if (movie->moov_in_reserve) write_reserve_free(movie, moov_bs);
 				gf_bs_get_content(moov_bs, &moov_data, &moov_size);
 				gf_bs_del(moov_bs);
 
-				movie->on_block_patch(movie->on_block_out_usr_data, moov_data, moov_size, mdat_start, GF_TRUE);
+				if (movie->moov_in_reserve)
+					movie->on_block_patch(movie->on_block_out_usr_data, moov_data, moov_size, movie->moov_reserve_offset, GF_FALSE);
+				else
+					movie->on_block_patch(movie->on_block_out_usr_data, moov_data, moov_size, mdat_start, GF_TRUE);
 				gf_free(moov_data);
 			}
 		} else {
@@ -1840,10 +1869,17 @@ GF_Err WriteToFile(GF_ISOFile *movie, Bool for_fragments)
 				u8 *moov_data;
 				u32 moov_size;
 
+				if (movie->moov_in_reserve) write_reserve_free(movie, moov_bs);
 				gf_bs_get_content(moov_bs, &moov_data, &moov_size);
 				gf_bs_del(moov_bs);
-				if (!e)
+				if (!e && movie->moov_in_reserve) {
+					u64 pos = gf_bs_get_position(movie->editFileMap->bs);
+					gf_bs_seek(movie->editFileMap->bs, movie->moov_reserve_offset);
+					gf_bs_write_data(movie->editFileMap->bs, moov_data, moov_size);
+					e = gf_bs_seek(movie->editFileMap->bs, pos);
+				} else if (!e) {
 					e = gf_bs_insert_data(movie->editFileMap->bs, moov_data, moov_size, movie->mdat->bsOffset);
+				}
 					
 				gf_free(moov_data);
 			}
@@ -1864,7 +1900,9 @@ GF_Err WriteToFile(GF_ISOFile *movie, Bool for_fragments)
 				is_stdout = GF_TRUE;
 
 			//OK, we need a new bitstream
-			stream = is_stdout ? stdout : gf_fopen(movie->finalName, "w+b");
+			if (is_stdout) stream = stdout;
+			else if (gf_opts_get_bool("core", "aio")) stream = gf_fopen_aio(movie->finalName, "w+b", 0, 0, 0);
+			else stream = gf_fopen(movie->finalName, "w+b");
 			if (!stream)
 				return GF_IO_ERR;
 			bs = gf_bs_from_file(stream, GF_BITSTREAM_WRITE);
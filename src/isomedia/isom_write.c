@@ -84,6 +84,22 @@ GF_Err FlushCaptureMode(GF_ISOFile *movie)
 		e = gf_isom_box_write((GF_Box *)movie->pdin, movie->editFileMap->bs);
 		if (e) return e;
 	}
+	/*reserve space for the moov as a free box, it will be overwritten at close if the moov fits*/
+	if (movie->moov_reserve && ((movie->storageMode==GF_ISOM_STORE_STREAMABLE) || (movie->storageMode==GF_ISOM_STORE_FASTSTART))) {
+		u8 zeros[1024];
+		u32 remain = movie->moov_reserve - 8;
+		movie->moov_reserve_offset = gf_bs_get_position(movie->editFileMap->bs);
+		gf_bs_write_u32(movie->editFileMap->bs, movie->moov_reserve);
+		gf_bs_write_u32(movie->editFileMap->bs, GF_ISOM_BOX_TYPE_FREE);
+		memset(zeros, 0, 1024);
+		while (remain) {
+			u32 nb_write = MIN(remain, 1024);
+			gf_bs_write_data(movie->editFileMap->bs, zeros, nb_write);
+			remain -= nb_write;
+		}
+	} else {
+		movie->moov_reserve = 0;
+	}
 	movie->mdat->bsOffset = gf_bs_get_position(movie->editFileMap->bs);
 
 	/*we have a trick here: the data will be stored on the fly, so the first
@@ -2367,6 +2383,29 @@ GF_Err gf_isom_force_64bit_chunk_offset(GF_ISOFile *file, Bool set_on)
 	return GF_OK;
 }
 
+GF_EXPORT
+GF_Err gf_isom_set_moov_reservation(GF_ISOFile *movie, u32 size)
+{
+	GF_Err e = CanAccessMovie(movie, GF_ISOM_OPEN_WRITE);
+	if (e) return e;
+	//only in capture mode, other modes already write moov before mdat in a single pass
+	if (movie->openMode != GF_ISOM_OPEN_WRITE) return GF_NOT_SUPPORTED;
+	e = CheckNoData(movie);
+	if (e) return e;
+	if (size && (size<8)) return GF_BAD_PARAM;
+	movie->moov_reserve = size;
+	return GF_OK;
+}
+
+GF_EXPORT
+GF_Err gf_isom_get_moov_reservation_info(GF_ISOFile *movie, u32 *moov_size, Bool *in_place)
+{
+	if (!movie || !movie->moov_reserve) return GF_BAD_PARAM;
+	if (moov_size) *moov_size = movie->moov_reserve_used;
+	if (in_place) *in_place = movie->moov_in_reserve;
+	return GF_OK;
+}
+
 
 //update or insert a new edit segment in the track time line. Edits are used to modify
 //the media normal timing. EditTime and EditDuration are expressed in Movie TimeScale
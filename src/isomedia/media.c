@@ -426,7 +426,33 @@ Bool Media_IsSampleSyncShadow(GF_ShadowSyncBox *stsh, u32 sampleNumber)
 	return 0;
 }
 
-GF_Err Media_GetSample(GF_MediaBox *mdia, u32 sampleNumber, GF_ISOSample **samp, u32 *sIDX, Bool no_data, u64 *out_offset)
+//checks if the payload of samples of the given entry can be used as is from the file mapping or read cache
+static Bool Media_IsSampleMappable(GF_MediaBox *mdia, GF_SampleEntryBox *entry)
+{
+	GF_ISOFile *mov = mdia->mediaTrack->moov->mov;
+	GF_DataMap *map = mdia->information->dataHandler;
+	if (!map) return GF_FALSE;
+	if ((map->type != GF_ISOM_DATA_FILE_MAPPING)
+		&& (!mov->block_cache || (map != mov->movieFileMap) || (map->type != GF_ISOM_DATA_FILE))
+	)
+		return GF_FALSE;
+	if (mdia->mediaTrack->padding_bytes || mov->read_byte_offset || mov->bytes_removed)
+		return GF_FALSE;
+
+	//same rules as the rewrite step of Media_GetSample
+	if (mdia->handler->handlerType == GF_ISOM_MEDIA_OD)
+		return mov->disable_odf_translate ? GF_TRUE : GF_FALSE;
+	if (gf_isom_is_nalu_based_entry(mdia, entry) && !gf_isom_is_encrypted_entry(entry->type))
+		return gf_isom_nalu_sample_rewrite_is_inspect_only(mdia, (GF_MPEGVisualSampleEntryBox *)entry);
+	if (mov->convert_streaming_text
+		&& ((mdia->handler->handlerType == GF_ISOM_MEDIA_TEXT) || (mdia->handler->handlerType == GF_ISOM_MEDIA_SCENE) || (mdia->handler->handlerType == GF_ISOM_MEDIA_SUBT))
+		&& (entry->type == GF_ISOM_BOX_TYPE_TX3G || entry->type == GF_ISOM_BOX_TYPE_TEXT)
+	)
+		return GF_FALSE;
+	return GF_TRUE;
+}
+
+GF_Err Media_GetSample(GF_MediaBox *mdia, u32 sampleNumber, GF_ISOSample **samp, u32 *sIDX, Bool no_data, u64 *out_offset, const u8 **mapped_data, void **mapping)
 {
 	GF_Err e;
 	u32 bytesRead;
@@ -436,6 +462,8 @@ GF_Err Media_GetSample(GF_MediaBox *mdia, u32 sampleNumber, GF_ISOSample **samp,
 	GF_SampleEntryBox *entry;
 	GF_StscEntry *stsc_entry;
 
+	if (mapped_data) *mapped_data = NULL;
+	if (mapping) *mapping = NULL;
 	if (!mdia || !mdia->information->sampleTable) return GF_BAD_PARAM;
 	if (!mdia->information->sampleTable->SampleSize)
 		return GF_ISOM_INVALID_FILE;
@@ -561,6 +589,23 @@ GF_Err Media_GetSample(GF_MediaBox *mdia, u32 sampleNumber, GF_ISOSample **samp,
 			(*samp)->nb_pack = left_in_chunk;
 		}
 
+		//payload used in place, no copy
+		if (mapped_data && mapping && Media_IsSampleMappable(mdia, entry)) {
+			GF_DataMap *map = mdia->information->dataHandler;
+			if (map->type == GF_ISOM_DATA_FILE_MAPPING) {
+				*mapped_data = gf_isom_fmo_get_mapped_data((GF_FileMappingDataMap *)map, (*samp)->dataLength, offset, &mdia->mediaTrack->map_advise_start, &mdia->mediaTrack->map_advise_end);
+				if (*mapped_data) {
+					gf_isom_fmo_ref((GF_FileMappingDataMap *)map);
+					*mapping = map;
+				}
+			} else {
+				GF_ISOReadBlock *block;
+				*mapped_data = gf_isom_rbc_get_data(mdia->mediaTrack->moov->mov->block_cache, map, offset, (*samp)->dataLength, &block);
+				if (*mapped_data) *mapping = block;
+			}
+		}
+	}
+	if ((*samp)->dataLength && (!mapped_data || !*mapped_data)) {
 		/*and finally get the data, include padding if needed*/
 		if ((*samp)->alloc_size) {
 			if ((*samp)->alloc_size < (*samp)->dataLength + mdia->mediaTrack->padding_bytes) {
@@ -606,7 +651,15 @@ GF_Err Media_GetSample(GF_MediaBox *mdia, u32 sampleNumber, GF_ISOSample **samp,
 	else if (gf_isom_is_nalu_based_entry(mdia, entry)
 		&& !gf_isom_is_encrypted_entry(entry->type)
 	) {
-		e = gf_isom_nalu_sample_rewrite(mdia, *samp, sampleNumber, (GF_MPEGVisualSampleEntryBox *)entry);
+		if (mapped_data && *mapped_data) {
+			//inspect only, the payload is not modified
+			u8 *data = (*samp)->data;
+			(*samp)->data = (u8 *) *mapped_data;
+			e = gf_isom_nalu_sample_rewrite(mdia, *samp, sampleNumber, (GF_MPEGVisualSampleEntryBox *)entry);
+			(*samp)->data = data;
+		} else {
+			e = gf_isom_nalu_sample_rewrite(mdia, *samp, sampleNumber, (GF_MPEGVisualSampleEntryBox *)entry);
+		}
 		if (e) return e;
 	}
 	else if (mdia->mediaTrack->moov->mov->convert_streaming_text
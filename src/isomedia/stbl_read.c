@@ -27,6 +27,12 @@
 
 #ifndef GPAC_DISABLE_ISOM
 
+static GFINLINE u64 stbl_index_get_dts(GF_SampleTableIndex *index, u32 sample_idx)
+{
+	if (index->dts) return index->dts[sample_idx];
+	return (u64) sample_idx * index->first_delta;
+}
+
 //Get the sample number
 GF_Err stbl_findEntryForTime(GF_SampleTableBox *stbl, u64 DTS, u8 useCTS, u32 *sampleNumber, u32 *prevSampleNumber)
 {
@@ -39,6 +45,27 @@ GF_Err stbl_findEntryForTime(GF_SampleTableBox *stbl, u64 DTS, u8 useCTS, u32 *s
 
 	if (!stbl->TimeToSample) return GF_ISOM_INVALID_FILE;
 
+	//time lookup is a random access, build the index if requested
+	if (stbl->r_index_lazy) stbl_build_index(stbl);
+	if (stbl->TimeToSample->r_index) {
+		GF_SampleTableIndex *index = stbl->TimeToSample->r_index;
+		u32 low = 0, high = index->nb_samples;
+		//first sample with DTS greater than or equal to the requested time
+		while (low < high) {
+			u32 mid = low + (high-low)/2;
+			if (stbl_index_get_dts(index, mid) < DTS) low = mid+1;
+			else high = mid;
+		}
+		if (low == index->nb_samples) return GF_OK;
+		curSampNum = low+1;
+		if (stbl_index_get_dts(index, low) == DTS) {
+			(*sampleNumber) = curSampNum;
+		} else {
+			(*prevSampleNumber) = (curSampNum != 1) ? curSampNum - 1 : 1;
+		}
+		return GF_OK;
+	}
+
 	/*CTS is ALWAYS disabled for now to make sure samples are fetched in decoding order. useCTS is therefore disabled*/
 #if 0
 	if (!stbl->CompositionOffset) useCTS = 0;
@@ -155,6 +182,11 @@ GF_Err stbl_GetSampleCTS(GF_CompositionOffsetBox *ctts, u32 SampleNumber, s32 *C
 	//test on SampleNumber is done before
 	if (!ctts || !SampleNumber) return GF_BAD_PARAM;
 
+	if (ctts->r_index && (SampleNumber <= ctts->r_index->nb_samples)) {
+		(*CTSoffset) = ctts->r_index->cts_offsets[SampleNumber-1];
+		return GF_OK;
+	}
+
 	if (ctts->r_FirstSampleInEntry && (ctts->r_FirstSampleInEntry < SampleNumber) ) {
 		i = ctts->r_currentEntryIndex;
 	} else {
@@ -188,6 +220,17 @@ GF_Err stbl_GetSampleDTS_and_Duration(GF_TimeToSampleBox *stts, u32 SampleNumber
 	}
 	if (!stts || !SampleNumber) return GF_BAD_PARAM;
 
+	if (stts->r_index && (SampleNumber <= stts->r_index->nb_samples)) {
+		GF_SampleTableIndex *index = stts->r_index;
+		(*DTS) = stbl_index_get_dts(index, SampleNumber-1);
+		if (duration) {
+			if (!index->dts) *duration = index->first_delta;
+			else if (SampleNumber < index->nb_samples) *duration = (u32) (index->dts[SampleNumber] - index->dts[SampleNumber-1]);
+			else *duration = index->last_delta;
+		}
+		return GF_OK;
+	}
+
 	ent = NULL;
 	//use our cache
 	count = stts->nb_entries;
@@ -246,8 +289,20 @@ GF_Err stbl_GetSampleRAP(GF_SyncSampleBox *stss, u32 SampleNumber, GF_ISOSAPType
 	(*IsRAP) = RAP_NO;
 	if (!stss || !SampleNumber) return GF_BAD_PARAM;
 
-	if (stss->r_LastSyncSample && (stss->r_LastSyncSample < SampleNumber) ) {
+	if (stss->r_LastSyncSample && (stss->r_LastSyncSample < SampleNumber)
+		//with sorted entries, only use the cache if the sample is before the next sync sample
+		&& (!stss->r_sorted || (stss->r_LastSampleIndex+1 >= stss->nb_entries) || (stss->sampleNumbers[stss->r_LastSampleIndex+1] >= SampleNumber))
+	) {
 		i = stss->r_LastSampleIndex;
+	} else if (stss->r_sorted && stss->nb_entries) {
+		//start from the last sync sample at or before the sample
+		u32 low = 0, high = stss->nb_entries-1;
+		while (low < high) {
+			u32 mid = low + (high-low+1)/2;
+			if (stss->sampleNumbers[mid] <= SampleNumber) low = mid;
+			else high = mid-1;
+		}
+		i = low;
 	} else {
 		i = 0;
 	}
@@ -395,6 +450,62 @@ void GetGhostNum(GF_StscEntry *ent, u32 EntryIndex, u32 count, GF_SampleTableBox
 	stbl->SampleToChunk->ghostNumber = ghostNum;
 }
 
+static u64 stbl_get_chunk_offset(GF_SampleTableBox *stbl, u32 chunk_idx);
+
+//checks if the stsc cursor can be used, ie if the sample is in the current or next chunk
+static Bool stbl_is_random_access(GF_SampleTableBox *stbl, u32 sampleNumber)
+{
+	GF_SampleToChunkBox *stsc = stbl->SampleToChunk;
+	if (!stsc->firstSampleInCurrentChunk) return (sampleNumber>1) ? GF_TRUE : GF_FALSE;
+	if (sampleNumber < stsc->firstSampleInCurrentChunk) return GF_TRUE;
+	if (stsc->currentIndex >= stsc->nb_entries) return GF_TRUE;
+	if (sampleNumber - stsc->firstSampleInCurrentChunk < 2 * stsc->entries[stsc->currentIndex].samplesPerChunk) return GF_FALSE;
+	return GF_TRUE;
+}
+
+static GF_Err stbl_get_sample_infos_indexed(GF_SampleTableBox *stbl, u32 sampleNumber, u64 *offset, u32 *chunkNumber, u32 *descIndex, GF_StscEntry **out_ent)
+{
+	u32 low, high, first;
+	u64 chunk_offset;
+	GF_StscEntry *ent;
+	GF_SampleTableIndex *index = stbl->r_index;
+	GF_SampleToChunkBox *stsc = stbl->SampleToChunk;
+
+	//last chunk starting at or before the sample
+	low = 0;
+	high = index->nb_chunks-1;
+	while (low < high) {
+		u32 mid = low + (high-low+1)/2;
+		if (index->chunk_first_sample[mid] <= sampleNumber) low = mid;
+		else high = mid-1;
+	}
+	first = index->chunk_first_sample[low];
+	ent = &stsc->entries[index->chunk_stsc_idx[low]];
+
+	//move the stsc cursor to this chunk, so that sequential access resumes from here
+	stsc->currentIndex = index->chunk_stsc_idx[low];
+	stsc->currentChunk = low + 2 - ent->firstChunk;
+	stsc->firstSampleInCurrentChunk = first;
+	GetGhostNum(ent, stsc->currentIndex, stsc->nb_entries, stbl);
+
+	chunk_offset = stbl_get_chunk_offset(stbl, low);
+	if (index->offsets) {
+		(*offset) = index->offsets[sampleNumber-1];
+	} else if ((stbl->SampleSize->type != GF_ISOM_BOX_TYPE_STZ2) && stbl->SampleSize->sampleSize) {
+		(*offset) = chunk_offset + (u64) (sampleNumber - first) * stbl->SampleSize->sampleSize;
+	} else {
+		(*offset) = chunk_offset;
+	}
+	stbl->r_last_chunk_num = low+1;
+	stbl->r_last_sample_num = sampleNumber;
+	stbl->r_last_offset_in_chunk = (u32) (*offset - chunk_offset);
+
+	(*descIndex) = ent->sampleDescriptionIndex;
+	(*chunkNumber) = low+1;
+	if (out_ent) *out_ent = ent;
+	return GF_OK;
+}
+
 //Get the offset, descIndex and chunkNumber of a sample...
 GF_Err stbl_GetSampleInfos(GF_SampleTableBox *stbl, u32 sampleNumber, u64 *offset, u32 *chunkNumber, u32 *descIndex, GF_StscEntry **out_ent)
 {
@@ -430,6 +541,12 @@ GF_Err stbl_GetSampleInfos(GF_SampleTableBox *stbl, u32 sampleNumber, u64 *offse
 		return GF_OK;
 	}
 
+	if ((stbl->r_index_lazy || stbl->r_index) && stbl_is_random_access(stbl, sampleNumber)) {
+		if (stbl->r_index_lazy) stbl_build_index(stbl);
+		if (stbl->r_index && (sampleNumber <= stbl->r_index->nb_samples))
+			return stbl_get_sample_infos_indexed(stbl, sampleNumber, offset, chunkNumber, descIndex, out_ent);
+	}
+
 	//check our cache: if desired sample is at or above current cache entry, start from here
 	if (stbl->SampleToChunk->firstSampleInCurrentChunk &&
 	        (stbl->SampleToChunk->firstSampleInCurrentChunk <= sampleNumber)) {
@@ -614,4 +731,218 @@ GF_Err stbl_GetSampleDepType(GF_SampleDependencyTypeBox *sdep, u32 SampleNumber,
 }
 
 
+static u64 stbl_get_chunk_offset(GF_SampleTableBox *stbl, u32 chunk_idx)
+{
+	if (stbl->ChunkOffset->type == GF_ISOM_BOX_TYPE_STCO)
+		return ((GF_ChunkOffsetBox *)stbl->ChunkOffset)->offsets[chunk_idx];
+	return ((GF_ChunkLargeOffsetBox *)stbl->ChunkOffset)->offsets[chunk_idx];
+}
+
+static u32 stbl_get_chunk_count(GF_SampleTableBox *stbl)
+{
+	if (!stbl->ChunkOffset) return 0;
+	if (stbl->ChunkOffset->type == GF_ISOM_BOX_TYPE_STCO) {
+		GF_ChunkOffsetBox *stco = (GF_ChunkOffsetBox *)stbl->ChunkOffset;
+		return stco->offsets ? stco->nb_entries : 0;
+	} else {
+		GF_ChunkLargeOffsetBox *co64 = (GF_ChunkLargeOffsetBox *)stbl->ChunkOffset;
+		return co64->offsets ? co64->nb_entries : 0;
+	}
+}
+
+void stbl_index_del(GF_SampleTableIndex *index)
+{
+	if (!index) return;
+	if (index->chunk_first_sample) gf_free(index->chunk_first_sample);
+	if (index->chunk_stsc_idx) gf_free(index->chunk_stsc_idx);
+	if (index->offsets) gf_free(index->offsets);
+	if (index->dts) gf_free(index->dts);
+	if (index->cts_offsets) gf_free(index->cts_offsets);
+	gf_free(index);
+}
+
+void stbl_del_index(GF_SampleTableBox *stbl)
+{
+	if (stbl->TimeToSample) stbl->TimeToSample->r_index = NULL;
+	if (stbl->CompositionOffset) stbl->CompositionOffset->r_index = NULL;
+	if (stbl->SyncSample) stbl->SyncSample->r_sorted = GF_FALSE;
+	stbl_index_del(stbl->r_index);
+	stbl->r_index = NULL;
+	stbl->r_index_lazy = GF_FALSE;
+}
+
+GF_Err stbl_set_index(GF_SampleTableBox *stbl, GF_SampleTableIndex *index)
+{
+	u32 i;
+	if (!stbl || !index || !stbl->SampleSize || !stbl->SampleToChunk || !stbl->TimeToSample) return GF_BAD_PARAM;
+	if (index->nb_samples != stbl->SampleSize->sampleCount) return GF_NON_COMPLIANT_BITSTREAM;
+	if (index->nb_chunks > stbl_get_chunk_count(stbl)) return GF_NON_COMPLIANT_BITSTREAM;
+	if ((stbl->CompositionOffset && stbl->CompositionOffset->nb_entries) != (index->cts_offsets ? GF_TRUE : GF_FALSE)) return GF_NON_COMPLIANT_BITSTREAM;
+	for (i=0; i<index->nb_chunks; i++) {
+		if (index->chunk_stsc_idx[i] >= stbl->SampleToChunk->nb_entries) return GF_NON_COMPLIANT_BITSTREAM;
+		if (stbl->SampleToChunk->entries[index->chunk_stsc_idx[i]].firstChunk > i+1) return GF_NON_COMPLIANT_BITSTREAM;
+		if (i && (index->chunk_first_sample[i] <= index->chunk_first_sample[i-1])) return GF_NON_COMPLIANT_BITSTREAM;
+	}
+	if (!index->nb_chunks || (index->chunk_first_sample[0] != 1)) return GF_NON_COMPLIANT_BITSTREAM;
+	if (index->chunk_first_sample[index->nb_chunks-1] > index->nb_samples) return GF_NON_COMPLIANT_BITSTREAM;
+
+	stbl_del_index(stbl);
+	stbl->r_index = index;
+	stbl->TimeToSample->r_index = index;
+	if (index->cts_offsets) stbl->CompositionOffset->r_index = index;
+
+	if (stbl->SyncSample) {
+		GF_SyncSampleBox *stss = stbl->SyncSample;
+		stss->r_sorted = GF_TRUE;
+		for (i=1; i<stss->nb_entries; i++) {
+			if (stss->sampleNumbers[i] <= stss->sampleNumbers[i-1]) {
+				stss->r_sorted = GF_FALSE;
+				break;
+			}
+		}
+	}
+	return GF_OK;
+}
+
+GF_Err stbl_build_index(GF_SampleTableBox *stbl)
+{
+	GF_Err e;
+	u32 i, j, k, nb_samples, nb_chunks, nb_stts_samples, sample_num, max_spc, const_size, nb_deltas, last_delta;
+	GF_SampleTableIndex *index;
+	GF_SampleToChunkBox *stsc;
+	GF_TimeToSampleBox *stts;
+
+	if (!stbl) return GF_BAD_PARAM;
+	stbl->r_index_lazy = GF_FALSE;
+	if (stbl->r_index) return GF_OK;
+	stsc = stbl->SampleToChunk;
+	stts = stbl->TimeToSample;
+	if (!stbl->SampleSize || !stsc || !stts) return GF_ISOM_INVALID_FILE;
+	nb_samples = stbl->SampleSize->sampleCount;
+	nb_chunks = stbl_get_chunk_count(stbl);
+	if (!nb_samples) return GF_OK;
+	if (!nb_chunks || !stsc->nb_entries) return GF_ISOM_INVALID_FILE;
+
+	//timing must describe all samples
+	nb_stts_samples = 0;
+	nb_deltas = last_delta = 0;
+	for (i=0; i<stts->nb_entries; i++) {
+		if (!stts->entries[i].sampleCount) continue;
+		if (stts->entries[i].sampleCount > nb_samples - nb_stts_samples) {
+			nb_stts_samples = 0;
+			break;
+		}
+		nb_stts_samples += stts->entries[i].sampleCount;
+		if (!nb_deltas) nb_deltas = 1;
+		else if (stts->entries[i].sampleDelta != last_delta) nb_deltas++;
+		last_delta = stts->entries[i].sampleDelta;
+	}
+	if (nb_stts_samples != nb_samples) {
+		GF_LOG(GF_LOG_INFO, GF_LOG_CONTAINER, ("[iso file] Time to sample table does not describe all samples, sample index disabled\n"));
+		return GF_NOT_SUPPORTED;
+	}
+
+	GF_SAFEALLOC(index, GF_SampleTableIndex);
+	if (!index) return GF_OUT_OF_MEM;
+	index->nb_samples = nb_samples;
+	index->nb_chunks = nb_chunks;
+	index->chunk_first_sample = gf_malloc(sizeof(u32) * nb_chunks);
+	index->chunk_stsc_idx = gf_malloc(sizeof(u32) * nb_chunks);
+	if (!index->chunk_first_sample || !index->chunk_stsc_idx) {
+		e = GF_OUT_OF_MEM;
+		goto exit;
+	}
+
+	//chunk layout, entries must be contiguous and cover all samples, otherwise we use the regular stsc walk
+	e = GF_NOT_SUPPORTED;
+	sample_num = 1;
+	max_spc = 0;
+	k = 0;
+	for (i=0; i<stsc->nb_entries; i++) {
+		u32 nb_ghosts;
+		GF_StscEntry *ent = &stsc->entries[i];
+		if (sample_num > nb_samples) break;
+		if ((ent->firstChunk != k+1) || !ent->samplesPerChunk) goto exit;
+		if (ent->nextChunk) nb_ghosts = (ent->nextChunk > ent->firstChunk) ? (ent->nextChunk - ent->firstChunk) : 1;
+		else if (i+1 == stsc->nb_entries) nb_ghosts = nb_chunks - k;
+		else goto exit;
+
+		for (j=0; (j<nb_ghosts) && (k<nb_chunks) && (sample_num <= nb_samples); j++, k++) {
+			index->chunk_first_sample[k] = sample_num;
+			index->chunk_stsc_idx[k] = i;
+			sample_num += ent->samplesPerChunk;
+		}
+		if (ent->samplesPerChunk > max_spc) max_spc = ent->samplesPerChunk;
+	}
+	if (sample_num <= nb_samples) goto exit;
+	//trailing empty chunks are never addressed
+	index->nb_chunks = k;
+
+	//offsets, only needed when chunks carry several samples of variable size
+	const_size = (stbl->SampleSize->type != GF_ISOM_BOX_TYPE_STZ2) ? stbl->SampleSize->sampleSize : 0;
+	if ((max_spc > 1) && !const_size) {
+		index->offsets = gf_malloc(sizeof(u64) * nb_samples);
+		if (!index->offsets) {
+			e = GF_OUT_OF_MEM;
+			goto exit;
+		}
+		for (k=0; k<index->nb_chunks; k++) {
+			u64 offset = stbl_get_chunk_offset(stbl, k);
+			u32 last = (k+1 < index->nb_chunks) ? index->chunk_first_sample[k+1] : nb_samples+1;
+			for (j=index->chunk_first_sample[k]; j<last; j++) {
+				index->offsets[j-1] = offset;
+				if (stbl->SampleSize->sizes) offset += stbl->SampleSize->sizes[j-1];
+			}
+		}
+	}
+
+	//timing, only needed for variable durations
+	for (i=0; i<stts->nb_entries; i++) {
+		if (!stts->entries[i].sampleCount) continue;
+		if (!index->first_delta) index->first_delta = stts->entries[i].sampleDelta;
+		index->last_delta = stts->entries[i].sampleDelta;
+	}
+	if (nb_deltas > 1) {
+		u64 dts = 0;
+		index->dts = gf_malloc(sizeof(u64) * nb_samples);
+		if (!index->dts) {
+			e = GF_OUT_OF_MEM;
+			goto exit;
+		}
+		k = 0;
+		for (i=0; i<stts->nb_entries; i++) {
+			for (j=0; j<stts->entries[i].sampleCount; j++) {
+				index->dts[k++] = dts;
+				dts += stts->entries[i].sampleDelta;
+			}
+		}
+	}
+	if (stbl->CompositionOffset && stbl->CompositionOffset->nb_entries) {
+		GF_CompositionOffsetBox *ctts = stbl->CompositionOffset;
+		index->cts_offsets = gf_malloc(sizeof(s32) * nb_samples);
+		if (!index->cts_offsets) {
+			e = GF_OUT_OF_MEM;
+			goto exit;
+		}
+		k = 0;
+		for (i=0; (i<ctts->nb_entries) && (k<nb_samples); i++) {
+			for (j=0; (j<ctts->entries[i].sampleCount) && (k<nb_samples); j++) {
+				index->cts_offsets[k++] = ctts->entries[i].decodingOffset;
+			}
+		}
+		//samples not in table have a 0 offset
+		if (k<nb_samples) memset(&index->cts_offsets[k], 0, sizeof(s32) * (nb_samples-k));
+	}
+	e = stbl_set_index(stbl, index);
+	if (!e) return GF_OK;
+
+exit:
+	if (e==GF_NOT_SUPPORTED) {
+		GF_LOG(GF_LOG_INFO, GF_LOG_CONTAINER, ("[iso file] Sample to chunk table layout not supported, sample index disabled\n"));
+	}
+	stbl_index_del(index);
+	return e;
+}
+
+
 #endif /*GPAC_DISABLE_ISOM*/
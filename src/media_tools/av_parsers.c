@@ -4712,6 +4712,18 @@ static u32 gf_media_nalu_locate_start_code_bs(GF_BitStream *bs, Bool locate_trai
 			cache_start = gf_bs_get_position(bs);
 			gf_bs_read_data(bs, avc_cache, (u32)load_size);
 		}
+		//start code not overlapping the previous cache, look for it in the whole cache
+		if (!locate_trailing && (bpos==3) && (load_size>3)) {
+			u32 sc_size = 0;
+			u32 pos = gf_media_nalu_next_start_code((u8 *) avc_cache, (u32) load_size, &sc_size);
+			if (pos < load_size) {
+				end = cache_start + pos;
+				break;
+			}
+			bpos = (u32) load_size;
+			v = ((u8) avc_cache[bpos-3]) << 16 | ((u8) avc_cache[bpos-2]) << 8 | ((u8) avc_cache[bpos-1]);
+			continue;
+		}
 		v = ( (v<<8) & 0xFFFFFF00) | ((u32) avc_cache[bpos]);
 		bpos++;
 
@@ -4742,39 +4754,30 @@ u32 gf_media_nalu_next_start_code_bs(GF_BitStream *bs)
 GF_EXPORT
 u32 gf_media_nalu_next_start_code(const u8 *data, u32 data_len, u32 *sc_size)
 {
-	u32 avail = data_len;
-	const u8 *cur = data;
-
-	while (cur) {
-		u32 v, bpos;
-		u8 *next_zero = memchr(cur, 0, avail);
-		if (!next_zero) return data_len;
+	u32 pos = 0;
 
-		v = 0xffffff00;
-		bpos = (u32)(next_zero - data) + 1;
-		while (1) {
-			u8 cval;
-			if (bpos == (u32)data_len)
-				return data_len;
-
-			cval = data[bpos];
-			v = ((v << 8) & 0xFFFFFF00) | ((u32)cval);
-			bpos++;
-			if (v == 0x00000001) {
+	while (pos < data_len) {
+		//locate 0x0000 followed by 0x00 or 0x01
+		pos += gf_bs_find_zero_pair(data + pos, data_len - pos, 1);
+		if (pos + 2 >= data_len) break;
+		if (data[pos+2] == 0x01) {
+			//0x00000001 start code
+			if (pos && !data[pos-1]) {
 				*sc_size = 4;
-				return bpos - 4;
-			}
-			else if ((v & 0x00FFFFFF) == 0x00000001) {
-				*sc_size = 3;
-				return bpos - 3;
+				return pos - 1;
 			}
-			if (cval)
-				break;
+			*sc_size = 3;
+			return pos;
 		}
-		if (bpos >= data_len)
-			break;
-		cur = data + bpos;
-		avail = data_len - bpos;
+		//0x000000, skip the zero run, start code may begin at its last two bytes
+		pos += 3;
+		while ((pos < data_len) && !data[pos]) pos++;
+		if (pos == data_len) break;
+		if (data[pos] == 0x01) {
+			*sc_size = 4;
+			return pos - 3;
+		}
+		pos++;
 	}
 	return data_len;
 }
@@ -4843,105 +4846,87 @@ static void avc_parse_hrd_parameters(GF_BitStream *bs, AVC_HRD *hrd)
 }
 
 /*returns the nal_size without emulation prevention bytes*/
+GF_EXPORT
 u32 gf_media_nalu_emulation_bytes_add_count(u8 *buffer, u32 nal_size)
 {
-	u32 i = 0, emulation_bytes_count = 0;
-	u8 num_zero = 0;
-
-	while (i < nal_size) {
-		/*ISO 14496-10: "Within the NAL unit, any four-byte sequence that starts with 0x000003
-		other than the following sequences shall not occur at any byte-aligned position:
-		\96 0x00000300
-		\96 0x00000301
-		\96 0x00000302
-		\96 0x00000303"
-		*/
-		if (num_zero == 2 && (u8)buffer[i] < 0x04) {
-			/*emulation code found*/
-			num_zero = 0;
-			emulation_bytes_count++;
-			if (!buffer[i])
-				num_zero = 1;
-		}
-		else {
-			if (!buffer[i])
-				num_zero++;
-			else
-				num_zero = 0;
-		}
-		i++;
+	u32 pos = 0, emulation_bytes_count = 0;
+
+	/*ISO 14496-10: "Within the NAL unit, any four-byte sequence that starts with 0x000003
+	other than the following sequences shall not occur at any byte-aligned position:
+	0x00000300
+	0x00000301
+	0x00000302
+	0x00000303"
+	an emulation prevention byte is inserted before any byte lower than 4 following two zero bytes,
+	counting of zero bytes restarts after an insertion
+	*/
+	while (pos < nal_size) {
+		//zero runs produce back-to-back insertions, check for them before the generic search
+		if ((pos + 2 >= nal_size) || buffer[pos] || buffer[pos+1] || (buffer[pos+2] > 0x03))
+			pos += gf_bs_find_zero_pair(buffer + pos, nal_size - pos, 0x03);
+		if (pos + 2 >= nal_size) break;
+		emulation_bytes_count++;
+		pos += 2;
 	}
 	return emulation_bytes_count;
 }
 
+GF_EXPORT
 u32 gf_media_nalu_add_emulation_bytes(const u8 *buffer_src, u8 *buffer_dst, u32 nal_size)
 {
-	u32 i = 0, emulation_bytes_count = 0;
-	u8 num_zero = 0;
-
-	while (i < nal_size) {
-		/*ISO 14496-10: "Within the NAL unit, any four-byte sequence that starts with 0x000003
-		other than the following sequences shall not occur at any byte-aligned position:
-		0x00000300
-		0x00000301
-		0x00000302
-		0x00000303"
-		*/
-		if (num_zero == 2 && (u8)buffer_src[i] < 0x04) {
-			/*add emulation code*/
-			num_zero = 0;
-			buffer_dst[i + emulation_bytes_count] = 0x03;
-			emulation_bytes_count++;
-			if (!buffer_src[i])
-				num_zero = 1;
-		}
-		else {
-			if (!buffer_src[i])
-				num_zero++;
-			else
-				num_zero = 0;
+	u32 pos = 0, copied = 0, emulation_bytes_count = 0;
+
+	while (pos < nal_size) {
+		//zero runs produce back-to-back insertions, check for them before the generic search
+		if ((pos + 2 >= nal_size) || buffer_src[pos] || buffer_src[pos+1] || (buffer_src[pos+2] > 0x03))
+			pos += gf_bs_find_zero_pair(buffer_src + pos, nal_size - pos, 0x03);
+		if (pos + 2 >= nal_size) break;
+		pos += 2;
+		/*add emulation code*/
+		memcpy(buffer_dst + copied + emulation_bytes_count, buffer_src + copied, pos - copied);
+		buffer_dst[pos + emulation_bytes_count] = 0x03;
+		emulation_bytes_count++;
+		copied = pos;
+	}
+	memcpy(buffer_dst + copied + emulation_bytes_count, buffer_src + copied, nal_size - copied);
+	return nal_size + emulation_bytes_count;
+}
+
+/*locates the next emulation prevention byte: 0x03 preceeded by exactly two zero bytes and followed by a byte lower than 4
+returns nal_size if not found*/
+static u32 gf_media_nalu_next_emulation_byte(const u8 *buffer, u32 pos, u32 nal_size)
+{
+	while (pos < nal_size) {
+		pos += gf_bs_find_zero_pair(buffer + pos, nal_size - pos, 0x03);
+		if (pos + 3 >= nal_size) break;
+		if ((buffer[pos+2] == 0x03) && (buffer[pos+3] < 0x04) && (!pos || buffer[pos-1]))
+			return pos+2;
+		if (buffer[pos+2]) {
+			pos++;
+			continue;
 		}
-		buffer_dst[i + emulation_bytes_count] = buffer_src[i];
-		i++;
+		//more than two zeros, the byte following the zero run cannot be an emulation prevention byte
+		pos += 3;
+		while ((pos < nal_size) && !buffer[pos]) pos++;
+		pos++;
 	}
-	return nal_size + emulation_bytes_count;
+	return nal_size;
 }
 
 /*returns the nal_size without emulation prevention bytes*/
+GF_EXPORT
 u32 gf_media_nalu_emulation_bytes_remove_count(const u8 *buffer, u32 nal_size)
 {
-	u32 i = 0, emulation_bytes_count = 0;
-	u8 num_zero = 0;
+	u32 pos = 0, emulation_bytes_count = 0;
 	if (!buffer || !nal_size) return 0;
 
-	while (i < nal_size)
-	{
-		/*ISO 14496-10: "Within the NAL unit, any four-byte sequence that starts with 0x000003
-		  other than the following sequences shall not occur at any byte-aligned position:
-		  \96 0x00000300
-		  \96 0x00000301
-		  \96 0x00000302
-		  \96 0x00000303"
-		*/
-		if (num_zero == 2
-			&& buffer[i] == 0x03
-			&& i + 1 < nal_size /*next byte is readable*/
-			&& (u8)buffer[i + 1] < 0x04)
-		{
-			/*emulation code found*/
-			num_zero = 0;
-			emulation_bytes_count++;
-			i++;
-		}
-
-		if (!buffer[i])
-			num_zero++;
-		else
-			num_zero = 0;
-
-		i++;
+	while (1) {
+		pos = gf_media_nalu_next_emulation_byte(buffer, pos, nal_size);
+		if (pos == nal_size) break;
+		/*emulation code found*/
+		emulation_bytes_count++;
+		pos++;
 	}
-
 	return emulation_bytes_count;
 }
 
@@ -4949,38 +4934,19 @@ u32 gf_media_nalu_emulation_bytes_remove_count(const u8 *buffer, u32 nal_size)
 GF_EXPORT
 u32 gf_media_nalu_remove_emulation_bytes(const u8 *buffer_src, u8 *buffer_dst, u32 nal_size)
 {
-	u32 i = 0, emulation_bytes_count = 0;
-	u8 num_zero = 0;
+	u32 pos = 0, copied = 0, emulation_bytes_count = 0;
 
-	while (i < nal_size)
-	{
-		/*ISO 14496-10: "Within the NAL unit, any four-byte sequence that starts with 0x000003
-		  other than the following sequences shall not occur at any byte-aligned position:
-		  0x00000300
-		  0x00000301
-		  0x00000302
-		  0x00000303"
-		*/
-		if (num_zero == 2
-			&& buffer_src[i] == 0x03
-			&& i + 1 < nal_size /*next byte is readable*/
-			&& (u8)buffer_src[i + 1] < 0x04)
-		{
-			/*emulation code found*/
-			num_zero = 0;
-			emulation_bytes_count++;
-			i++;
-		}
-
-		buffer_dst[i - emulation_bytes_count] = buffer_src[i];
-
-		if (!buffer_src[i])
-			num_zero++;
-		else
-			num_zero = 0;
-
-		i++;
+	while (1) {
+		pos = gf_media_nalu_next_emulation_byte(buffer_src, pos, nal_size);
+		if (pos == nal_size) break;
+		/*emulation code found, copy everything before it*/
+		memmove(buffer_dst + copied - emulation_bytes_count, buffer_src + copied, pos - copied);
+		emulation_bytes_count++;
+		pos++;
+		copied = pos;
 	}
+	if (nal_size > copied)
+		memmove(buffer_dst + copied - emulation_bytes_count, buffer_src + copied, nal_size - copied);
 
 	return nal_size - emulation_bytes_count;
 }
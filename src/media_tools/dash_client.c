@@ -136,6 +136,11 @@ struct __dash_client
 	u32 force_period_reload;
 
 	u32 user_buffer_ms;
+	//number of media segments queued ahead of the playing one in simple groups
+	u32 nb_prefetch;
+
+	GF_DASHManifestUpdateMode mpd_update_mode;
+	GF_DASHManifestStats mpd_stats;
 
 	u32 min_timeout_between_404, segment_lost_after_ms;
 
@@ -185,6 +190,7 @@ struct __dash_client
 };
 
 static void gf_dash_seek_group(GF_DashClient *dash, GF_DASH_Group *group, Double seek_to, Bool is_dynamic);
+static void gf_dash_group_cancel_queued(GF_DashClient *dash, GF_DASH_Group *group);
 
 
 enum
@@ -1815,6 +1821,7 @@ static u32 gf_dash_purge_segment_timeline(GF_DASH_Group *group, Double min_start
 			}
 		}
 		group->nb_segments_purged += nb_removed;
+		timeline->nb_purged += nb_removed;
 	}
 	return nb_removed;
 }
@@ -2033,6 +2040,185 @@ static u32 ls_hls_purge_segments(s32 live_edge_idx, GF_List *l)
 	return nb_removed_before_live;
 }
 
+/*gets the minimum media time to keep in the timelines given the timeshift buffer depth*/
+static Double gf_dash_get_timeshift_start(GF_DashClient *dash)
+{
+	u32 group_idx;
+	Double timeshift, timeline_start_time = 0;
+
+	if (dash->mpd->time_shift_buffer_depth == (u32) -1) return 0;
+
+	timeshift = dash->mpd->time_shift_buffer_depth;
+	timeshift /= 1000;
+
+	for (group_idx=0; group_idx<gf_list_count(dash->groups); group_idx++) {
+		GF_DASH_Group *group = gf_list_get(dash->groups, group_idx);
+		if (group->selection!=GF_DASH_GROUP_NOT_SELECTABLE) {
+			Double group_start = gf_dash_get_segment_start_time(group, NULL);
+			if (!group_idx || (timeline_start_time > group_start) ) timeline_start_time = group_start;
+		}
+	}
+	/*we can rewind our segments from timeshift*/
+	if (timeline_start_time > timeshift) return timeline_start_time - timeshift;
+	/*we can rewind all segments*/
+	return 0;
+}
+
+static void gf_dash_update_manifest_stats(GF_DashClient *dash, u64 parse_start, GF_DASHManifestUpdateMode mode, u32 nb_new_segs)
+{
+	u64 parse_time = gf_sys_clock_high_res() - parse_start;
+
+	dash->mpd_stats.nb_refresh++;
+	if (mode==GF_DASH_MPD_UPDATE_PATCH) dash->mpd_stats.nb_patch++;
+	else if (mode==GF_DASH_MPD_UPDATE_MERGE) dash->mpd_stats.nb_merge++;
+	else dash->mpd_stats.nb_full++;
+
+	dash->mpd_stats.last_parse_time = parse_time;
+	dash->mpd_stats.total_parse_time += parse_time;
+	if (dash->mpd_stats.max_parse_time < parse_time) dash->mpd_stats.max_parse_time = parse_time;
+	dash->mpd_stats.last_new_segments = nb_new_segs;
+
+	GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[DASH] Manifest %s in "LLU" us - %d new segments\n",
+		(mode==GF_DASH_MPD_UPDATE_PATCH) ? "patched" : (mode==GF_DASH_MPD_UPDATE_MERGE) ? "merged" : "reloaded", parse_time, nb_new_segs));
+}
+
+/*checks if the active manifest can be merged or patched. Segment lists are purged by the client and xlink periods are resolved
+by the client, and cannot be matched against a new version of the document*/
+static Bool gf_dash_can_update_manifest_inplace(GF_DashClient *dash)
+{
+	u32 i, j;
+	GF_MPD_Period *period;
+
+	if (dash->is_m3u8 || dash->is_smooth || dash->split_adaptation_set) return GF_FALSE;
+	if ((dash->mpd->type != GF_MPD_TYPE_DYNAMIC) || dash->mpd->media_presentation_duration) return GF_FALSE;
+
+	period = gf_list_get(dash->mpd->periods, dash->active_period_index);
+	if (!period || period->origin_base_url || period->segment_list) return GF_FALSE;
+
+	for (i=0; i<gf_list_count(dash->groups); i++) {
+		GF_MPD_Representation *rep;
+		GF_DASH_Group *group = gf_list_get(dash->groups, i);
+		if (!group->adaptation_set || (group->period != period) || group->adaptation_set->segment_list) return GF_FALSE;
+		j=0;
+		while ((rep = gf_list_enum(group->adaptation_set->representations, &j))) {
+			if (rep->segment_list) return GF_FALSE;
+		}
+	}
+	return GF_TRUE;
+}
+
+/*merges or patches the active manifest with the given file. If an error is returned, the manifest and the groups are not modified
+and a complete reload shall be done*/
+static GF_Err gf_dash_update_manifest_inplace(GF_DashClient *dash, const char *local_url, GF_DASHManifestUpdateMode mode, u64 fetch_time)
+{
+	GF_Err e;
+	u32 i, nb_new_segs = 0;
+	u64 parse_start;
+	Double timeline_start_time;
+
+	//store the current position of each group before the timelines are rewritten
+	for (i=0; i<gf_list_count(dash->groups); i++) {
+		GF_DASH_Group *group = gf_list_get(dash->groups, i);
+		if (group->selection==GF_DASH_GROUP_NOT_SELECTABLE) continue;
+		group->current_start_time = gf_dash_get_segment_start_time_with_timescale(group, NULL, &group->current_timescale);
+	}
+	timeline_start_time = gf_dash_get_timeshift_start(dash);
+
+	parse_start = gf_sys_clock_high_res();
+	if (mode==GF_DASH_MPD_UPDATE_PATCH)
+		e = gf_mpd_apply_patch(local_url, dash->mpd, &nb_new_segs);
+	else
+		e = gf_mpd_merge_file(local_url, dash->mpd, &nb_new_segs);
+	if (e) return e;
+
+	gf_dash_update_manifest_stats(dash, parse_start, mode, nb_new_segs);
+
+	for (i=0; i<gf_list_count(dash->groups); i++) {
+		u64 duration;
+		u32 timescale;
+		Double seg_dur;
+		GF_MPD_SegmentTimeline *timeline = NULL;
+		GF_MPD_Representation *rep;
+		GF_DASH_Group *group = gf_list_get(dash->groups, i);
+		if (group->selection==GF_DASH_GROUP_NOT_SELECTABLE) continue;
+
+		rep = gf_list_get(group->adaptation_set->representations, group->active_rep_index);
+		gf_mpd_resolve_segment_duration(rep, group->adaptation_set, group->period, &duration, &timescale, NULL, &timeline);
+		if (timeline) {
+			group->download_segment_index = gf_dash_get_index_in_timeline(timeline, group->current_start_time, group->current_timescale, timescale ? timescale : group->current_timescale);
+		}
+		gf_dash_get_segment_duration(rep, group->adaptation_set, group->period, dash->mpd, &group->nb_segments_in_rep, &seg_dur);
+
+		if (timeline_start_time) {
+			u32 nb_segments_removed = gf_dash_purge_segment_timeline(group, timeline_start_time);
+			if (nb_segments_removed) {
+				GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[DASH] AdaptationSet %d - removed %d segments from timeline (%d since start of the period)\n", i+1, nb_segments_removed, group->nb_segments_purged));
+			}
+		}
+		if (nb_new_segs)
+			group->last_mpd_change_time = gf_sys_clock();
+
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[DASH] Updated AdaptationSet %d - %d segments - next segment index %d\n", i+1, group->nb_segments_in_rep, group->download_segment_index));
+	}
+
+	dash->last_update_time = gf_sys_clock();
+	dash->mpd_fetch_time = fetch_time;
+	return GF_OK;
+}
+
+/*fetches and applies the MPD patch advertized by the manifest*/
+static GF_Err gf_dash_update_manifest_patch(GF_DashClient *dash)
+{
+	GF_Err e;
+	u64 fetch_time;
+	const char *local_url;
+	char *patch_url;
+
+	//patch location no longer valid
+	if (dash->mpd->patch_location_ttl && (dash->mpd->publishTime + 1000 * (u64) dash->mpd->patch_location_ttl < gf_net_get_utc()))
+		return GF_NOT_SUPPORTED;
+
+	patch_url = gf_url_concatenate(dash->base_url, dash->mpd->patch_location);
+	if (!patch_url) return GF_OUT_OF_MEM;
+
+	if (!dash->mpd_dnload) {
+		//local manifest, only use local patches
+		if (!gf_file_exists(patch_url)) {
+			gf_free(patch_url);
+			return GF_NOT_SUPPORTED;
+		}
+		local_url = patch_url;
+	} else {
+		local_url = dash->dash_io->get_cache_name(dash->dash_io, dash->mpd_dnload);
+		if (local_url) {
+			gf_file_delete(local_url);
+		}
+		e = gf_dash_download_resource(dash, &(dash->mpd_dnload), patch_url, 0, 0, 0, NULL);
+		if (e) {
+			GF_LOG(GF_LOG_WARNING, GF_LOG_DASH, ("[DASH] Failed to download MPD patch %s: %s - reloading manifest\n", patch_url, gf_error_to_string(e)));
+			gf_free(patch_url);
+			return e;
+		}
+		local_url = dash->dash_io->get_cache_name(dash->dash_io, dash->mpd_dnload);
+	}
+	fetch_time = dash_get_fetch_time(dash);
+
+	e = gf_dash_update_manifest_inplace(dash, local_url, GF_DASH_MPD_UPDATE_PATCH, fetch_time);
+	if (e==GF_EOS) {
+		dash->reload_count++;
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[DASH] MPD patch did not modify the manifest for %d consecutive reloads\n", dash->reload_count));
+		dash->last_update_time = gf_sys_clock();
+		dash->mpd_fetch_time = fetch_time;
+		e = GF_OK;
+	} else if (e) {
+		GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[DASH] Cannot apply MPD patch %s: %s - reloading manifest\n", patch_url, gf_error_to_string(e)));
+	} else {
+		dash->reload_count = 0;
+	}
+	gf_free(patch_url);
+	return e;
+}
+
 static GF_Err gf_dash_update_manifest(GF_DashClient *dash)
 {
 	GF_Err e;
@@ -2050,6 +2236,7 @@ static GF_Err gf_dash_update_manifest(GF_DashClient *dash)
 	Bool fetch_only = GF_FALSE;
 	u32 nb_group_unchanged = 0;
 	Bool has_reps_unchanged = GF_FALSE;
+	u64 parse_start;
 
 	//HLS: do not reload the playlist, directly update the reps
 	if (dash->is_m3u8 && !dash->m3u8_reload_master) {
@@ -2060,6 +2247,14 @@ static GF_Err gf_dash_update_manifest(GF_DashClient *dash)
 		goto process_m3u8_manifest;
 	}
 
+	//MPD patch: only fetch the patch, reloading the complete manifest if the patch cannot be fetched or applied
+	if ((dash->mpd_update_mode==GF_DASH_MPD_UPDATE_PATCH) && dash->mpd->patch_location && !dash->in_error
+		&& gf_dash_can_update_manifest_inplace(dash)
+	) {
+		if (gf_dash_update_manifest_patch(dash)==GF_OK)
+			return GF_OK;
+	}
+
 	if (!dash->mpd_dnload) {
 		local_url = purl = NULL;
 		if (!gf_list_count(dash->mpd->locations)) {
@@ -2199,26 +2394,37 @@ static GF_Err gf_dash_update_manifest(GF_DashClient *dash)
 			dash->dash_io->manifest_updated(dash->dash_io, szName, local_url, -1);
 		}
 
-		/* It means we have to reparse the file ... */
-		/* parse the MPD */
-		mpd_parser = gf_xml_dom_new();
-		e = gf_xml_dom_parse(mpd_parser, local_url, NULL, NULL);
-		if (e != GF_OK) {
-			gf_xml_dom_del(mpd_parser);
-			GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASH] Error - cannot update playlist: error in XML parsing %s\n", gf_error_to_string(e)));
-			return GF_NON_COMPLIANT_BITSTREAM;
+		/*if only segment timelines changed, merge them in the active manifest*/
+		if ((dash->mpd_update_mode!=GF_DASH_MPD_UPDATE_FULL) && !force_timeline_setup && gf_dash_can_update_manifest_inplace(dash)) {
+			e = gf_dash_update_manifest_inplace(dash, local_url, GF_DASH_MPD_UPDATE_MERGE, fetch_time);
+			if (e==GF_OK) return GF_OK;
 		}
+
+		/* It means we have to reparse the file ... */
+		parse_start = gf_sys_clock_high_res();
 		new_mpd = gf_mpd_new();
-		if (dash->is_smooth)
+		if (dash->is_smooth) {
+			/* parse the MPD */
+			mpd_parser = gf_xml_dom_new();
+			e = gf_xml_dom_parse(mpd_parser, local_url, NULL, NULL);
+			if (e != GF_OK) {
+				gf_xml_dom_del(mpd_parser);
+				gf_mpd_del(new_mpd);
+				GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASH] Error - cannot update playlist: error in XML parsing %s\n", gf_error_to_string(e)));
+				return GF_NON_COMPLIANT_BITSTREAM;
+			}
 			e = gf_mpd_init_smooth_from_dom(gf_xml_dom_get_root(mpd_parser), new_mpd, purl);
-		else
-			e = gf_mpd_init_from_dom(gf_xml_dom_get_root(mpd_parser), new_mpd, purl);
-		gf_xml_dom_del(mpd_parser);
+			gf_xml_dom_del(mpd_parser);
+		} else {
+			e = gf_mpd_init_from_file(local_url, new_mpd, purl);
+		}
 		if (e) {
 			GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASH] Error - cannot update playlist: error in MPD creation %s\n", gf_error_to_string(e)));
 			gf_mpd_del(new_mpd);
 			return GF_NON_COMPLIANT_BITSTREAM;
 		}
+		gf_dash_update_manifest_stats(dash, parse_start, GF_DASH_MPD_UPDATE_FULL, 0);
+
 		if (dash->ignore_xlink)
 			dash_purge_xlink(new_mpd);
 
@@ -2323,24 +2529,8 @@ restart_period_check:
 
 	GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[DASH] Updating playlist at UTC time "LLU" - availabilityStartTime "LLU"\n", fetch_time, new_mpd->availabilityStartTime));
 
-	timeline_start_time = 0;
 	/*if not infinity for timeShift, compute min media time before merge and adjust it*/
-	if (dash->mpd->time_shift_buffer_depth != (u32) -1) {
-		Double timeshift = dash->mpd->time_shift_buffer_depth;
-		timeshift /= 1000;
-
-		for (group_idx=0; group_idx<gf_list_count(dash->groups); group_idx++) {
-			GF_DASH_Group *group = gf_list_get(dash->groups, group_idx);
-			if (group->selection!=GF_DASH_GROUP_NOT_SELECTABLE) {
-				Double group_start = gf_dash_get_segment_start_time(group, NULL);
-				if (!group_idx || (timeline_start_time > group_start) ) timeline_start_time = group_start;
-			}
-		}
-		/*we can rewind our segments from timeshift*/
-		if (timeline_start_time > timeshift) timeline_start_time -= timeshift;
-		/*we can rewind all segments*/
-		else timeline_start_time = 0;
-	}
+	timeline_start_time = gf_dash_get_timeshift_start(dash);
 
 	/*update segmentTimeline at Period level*/
 	e = gf_dash_merge_segment_timeline(NULL, dash, period->segment_list, period->segment_template, new_period->segment_list, new_period->segment_template, timeline_start_time);
@@ -4190,6 +4380,9 @@ static void dash_do_rate_adaptation(GF_DashClient *dash, GF_DASH_Group *group)
 		/* request downloads for the new representation */
 		gf_dash_set_group_representation(group, new_rep, GF_FALSE);
 
+		/* segments prefetched with the previous representation are no longer needed*/
+		gf_dash_group_cancel_queued(dash, group);
+
 		/* Reset smoothing of switches
 		(note: should really apply only to algorithms using the switch_probe_count (smoothing the aggressiveness of the change)
 		for now: only GF_DASH_ALGO_GPAC_LEGACY_RATE and  GF_DASH_ALGO_GPAC_LEGACY_BUFFER */
@@ -4468,6 +4661,27 @@ static void gf_dash_group_reset_cache_entry(segment_cache_entry *cached)
 	memset(cached, 0, sizeof(segment_cache_entry));
 }
 
+//drop all segments queued after the first one, rewinding the download index so that they get resolved again
+//only done for prefetch queues: low latency groups and groups with dependencies keep their queue
+static void gf_dash_group_cancel_queued(GF_DashClient *dash, GF_DASH_Group *group)
+{
+	if (!dash->nb_prefetch || (group->max_cached_segments<=1)) return;
+	if (group->base_rep_index_plus_one || group->groups_depending_on || group->is_low_latency) return;
+
+	while (group->nb_cached_segments>1) {
+		group->nb_cached_segments--;
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[DASH] Group %d canceling queued segment %s\n", 1+gf_list_find(dash->groups, group), group->cached[group->nb_cached_segments].url));
+		gf_dash_group_reset_cache_entry(&group->cached[group->nb_cached_segments]);
+
+		if (dash->speed>=0) {
+			if (group->download_segment_index) group->download_segment_index--;
+		} else {
+			group->download_segment_index++;
+		}
+		group->done = GF_FALSE;
+	}
+}
+
 static void gf_dash_group_reset(GF_DashClient *dash, GF_DASH_Group *group)
 {
 	while (group->nb_cached_segments) {
@@ -4835,6 +5049,14 @@ GF_Err gf_dash_setup_groups(GF_DashClient *dash)
 
 			}
 		}
+		//prefetch is only used for groups without dependencies
+		else if (dash->nb_prefetch && !group->depend_on_group && !group->base_rep_index_plus_one) {
+			group->max_cached_segments *= (1+dash->nb_prefetch);
+			if (group->max_cached_segments>50)
+				group->max_cached_segments = 50;
+			group->cached = gf_realloc(group->cached, sizeof(segment_cache_entry)*group->max_cached_segments);
+			memset(group->cached, 0, sizeof(segment_cache_entry)*group->max_cached_segments);
+		}
 	}
 
 	return GF_OK;
@@ -7574,27 +7796,30 @@ GF_Err gf_dash_open(GF_DashClient *dash, const char *manifest_url)
 
 		GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[DASH] parsing %s manifest %s\n", dash->is_smooth ? "SmoothStreaming" : "DASH-MPD", local_url));
 
-		/* parse the MPD */
-		mpd_parser = gf_xml_dom_new();
-		e = gf_xml_dom_parse(mpd_parser, local_url, NULL, NULL);
-
-		if (sep_cgi) sep_cgi[0] = '?';
-		if (sep_frag) sep_frag[0] = '#';
-
-		if (e != GF_OK) {
-			GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASH] Error - cannot connect service: MPD parsing problem %s\n", gf_xml_dom_get_error(mpd_parser) ));
-			gf_xml_dom_del(mpd_parser);
-			dash->dash_io->del(dash->dash_io, dash->mpd_dnload);
-			dash->mpd_dnload = NULL;
-			return GF_URL_ERROR;
-		}
-
 		if (dash->is_smooth) {
+			/* parse the MPD */
+			mpd_parser = gf_xml_dom_new();
+			e = gf_xml_dom_parse(mpd_parser, local_url, NULL, NULL);
+
+			if (sep_cgi) sep_cgi[0] = '?';
+			if (sep_frag) sep_frag[0] = '#';
+
+			if (e != GF_OK) {
+				GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASH] Error - cannot connect service: MPD parsing problem %s\n", gf_xml_dom_get_error(mpd_parser) ));
+				gf_xml_dom_del(mpd_parser);
+				dash->dash_io->del(dash->dash_io, dash->mpd_dnload);
+				dash->mpd_dnload = NULL;
+				return GF_URL_ERROR;
+			}
 			e = gf_mpd_init_smooth_from_dom(gf_xml_dom_get_root(mpd_parser), dash->mpd, manifest_url);
+			gf_xml_dom_del(mpd_parser);
 		} else {
-			e = gf_mpd_init_from_dom(gf_xml_dom_get_root(mpd_parser), dash->mpd, manifest_url);
+			//SAX loading, keeping the document structure for later merges of the manifest
+			e = gf_mpd_init_from_file(local_url, dash->mpd, manifest_url);
+
+			if (sep_cgi) sep_cgi[0] = '?';
+			if (sep_frag) sep_frag[0] = '#';
 		}
-		gf_xml_dom_del(mpd_parser);
 
 		if (!e && dash->split_adaptation_set)
 			gf_mpd_split_adaptation_sets(dash->mpd);
@@ -7773,6 +7998,7 @@ GF_DashClient *gf_dash_new(GF_DASHFileIO *dash_io, u32 max_cache_duration, u32 a
 	dash->speed = 1.0;
 	dash->is_rt_speed = GF_TRUE;
 	dash->low_latency_mode = GF_DASH_LL_STRICT;
+	dash->mpd_update_mode = GF_DASH_MPD_UPDATE_PATCH;
 
 	//wait one segment to validate we have enough bandwidth
 	dash->probe_times_before_switch = 1;
@@ -8363,6 +8589,23 @@ GF_Err gf_dash_group_next_seg_info(GF_DashClient *dash, u32 idx, const char **se
 	return res;
 }
 
+GF_EXPORT
+GF_Err gf_dash_group_get_prefetch_segment(GF_DashClient *dash, u32 idx, u32 seg_idx, const char **url, u64 *start_range, u64 *end_range, GF_Fraction64 *seg_time)
+{
+	GF_DASH_Group *group = gf_list_get(dash->groups, idx);
+	if (!group || !url) return GF_BAD_PARAM;
+	*url = NULL;
+	if (seg_idx >= group->nb_cached_segments) return GF_EOS;
+
+	*url = group->cached[seg_idx].cache;
+	if (start_range) *start_range = group->cached[seg_idx].start_range;
+	if (end_range) *end_range = group->cached[seg_idx].end_range;
+	if (seg_time) *seg_time = group->cached[seg_idx].time;
+	if (group->cached[seg_idx].flags & SEG_FLAG_DISABLED)
+		return GF_URL_REMOVED;
+	return GF_OK;
+}
+
 GF_EXPORT
 void gf_dash_group_discard_segment(GF_DashClient *dash, u32 idx)
 {
@@ -8860,6 +9103,26 @@ void gf_dash_set_user_buffer(GF_DashClient *dash, u32 buffer_time_ms)
 	if (dash) dash->user_buffer_ms = buffer_time_ms;
 }
 
+GF_EXPORT
+void gf_dash_set_prefetch(GF_DashClient *dash, u32 nb_segments)
+{
+	if (dash) dash->nb_prefetch = nb_segments;
+}
+
+GF_EXPORT
+void gf_dash_set_manifest_update_mode(GF_DashClient *dash, GF_DASHManifestUpdateMode mode)
+{
+	if (dash) dash->mpd_update_mode = mode;
+}
+
+GF_EXPORT
+GF_Err gf_dash_get_manifest_stats(GF_DashClient *dash, GF_DASHManifestStats *stats)
+{
+	if (!dash || !stats) return GF_BAD_PARAM;
+	memcpy(stats, &dash->mpd_stats, sizeof(GF_DASHManifestStats));
+	return GF_OK;
+}
+
 /*returns active period start in ms*/
 GF_EXPORT
 u64 gf_dash_get_period_start(GF_DashClient *dash)
@@ -9423,6 +9686,9 @@ void gf_dash_set_group_download_state(GF_DashClient *dash, u32 idx, u32 cur_dep_
 	if (!group->nb_cached_segments) return;
 	rep = gf_list_get(group->adaptation_set->representations, group->cached[0].representation_index);
 
+	//segments prefetched after the failed one will be resolved again
+	gf_dash_group_cancel_queued(dash, group);
+
 	while (group->cached[0].representation_index < cur_dep_idx) {
 		gf_free(group->cached[0].key_url);
 		gf_free(group->cached[0].url);
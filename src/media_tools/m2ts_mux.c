@@ -2854,8 +2854,8 @@ GF_Err gf_m2ts_mux_enable_pcr_only_packets(GF_M2TS_Mux *muxer, Bool enable_force
 }
 
 
-GF_EXPORT
-const u8 *gf_m2ts_mux_process(GF_M2TS_Mux *muxer, GF_M2TSMuxState *status, u32 *usec_till_next)
+/*produces one TS packet in dst, or returns the NULL packet when padding*/
+static const u8 *gf_m2ts_mux_process_packet(GF_M2TS_Mux *muxer, GF_M2TSMuxState *status, u32 *usec_till_next, char *dst)
 {
 	GF_M2TS_Mux_Program *program;
 	GF_M2TS_Mux_Stream *stream, *stream_to_process;
@@ -3021,7 +3021,7 @@ const u8 *gf_m2ts_mux_process(GF_M2TS_Mux *muxer, GF_M2TSMuxState *status, u32 *
 				res = stream->process(muxer, stream);
 				/*next is rap on this stream, check flushing of other pes (we could use a goto)*/
 				if (!flush_all_pes && muxer->force_pat)
-					return gf_m2ts_mux_process(muxer, status, usec_till_next);
+					return gf_m2ts_mux_process_packet(muxer, status, usec_till_next, dst);
 
 				if (res) {
 					/*always schedule the earliest data*/
@@ -3074,9 +3074,9 @@ send_pck:
 		}
 	} else {
 		if (stream_to_process->tables) {
-			gf_m2ts_mux_table_get_next_packet(muxer, stream_to_process, muxer->dst_pck);
+			gf_m2ts_mux_table_get_next_packet(muxer, stream_to_process, dst);
 		} else {
-			gf_m2ts_mux_pes_get_next_packet(stream_to_process, muxer->dst_pck);
+			gf_m2ts_mux_pes_get_next_packet(stream_to_process, dst);
 			if (stream_to_process->pck_sap_type) {
 				muxer->sap_inserted = GF_TRUE;
 				muxer->sap_type = stream_to_process->pck_sap_type;
@@ -3086,7 +3086,7 @@ send_pck:
 			muxer->last_pid = stream_to_process->pid;
 		}
 
-		ret = muxer->dst_pck;
+		ret = dst;
 		*status = GF_M2TS_STATE_DATA;
 
 		GF_LOG(GF_LOG_DEBUG, GF_LOG_CONTAINER, ("[MPEG2-TS Muxer] Sending %s from PID %d at %d:%09d - mux time %d:%09d\n", stream_to_process->tables ? "table" : "PES", stream_to_process->pid, time.sec, time.nanosec, muxer->time.sec, muxer->time.nanosec));
@@ -3127,4 +3127,29 @@ send_pck:
 	return ret;
 }
 
+GF_EXPORT
+const u8 *gf_m2ts_mux_process(GF_M2TS_Mux *muxer, GF_M2TSMuxState *status, u32 *usec_till_next)
+{
+	return gf_m2ts_mux_process_packet(muxer, status, usec_till_next, muxer->dst_pck);
+}
+
+GF_EXPORT
+u32 gf_m2ts_mux_process_block(GF_M2TS_Mux *muxer, u8 *dst, u32 max_pck, GF_M2TSMuxState *status, u32 *usec_till_next)
+{
+	u32 nb_pck = 0;
+	*status = GF_M2TS_STATE_IDLE;
+	if (!muxer || !dst) return 0;
+
+	while (nb_pck < max_pck) {
+		char *pck_dst = (char *) dst + 188*nb_pck;
+		//tables and PES packets are written in place, only the NULL packet needs a copy
+		const u8 *ts_pck = gf_m2ts_mux_process_packet(muxer, status, usec_till_next, pck_dst);
+		if (!ts_pck) break;
+		if (ts_pck != (const u8 *) pck_dst)
+			memcpy(pck_dst, ts_pck, 188);
+		nb_pck++;
+	}
+	return nb_pck;
+}
+
 #endif /*GPAC_DISABLE_MPEG2TS_MUX*/
@@ -362,6 +362,26 @@ static void gf_mpd_parse_segment_base_generic(GF_MPD *mpd, GF_MPD_SegmentBase *s
 	}
 }
 
+//timeline entries parsed by the SAX loader for a SegmentTimeline element of the DOM
+typedef struct
+{
+	GF_XMLNode *node;
+	GF_List *entries;
+} GF_MPD_SAXTimeline;
+
+static void gf_mpd_parse_timeline_entry_att(GF_MPD_SegmentTimelineEntry *seg_tl_ent, const char *name, const char *value)
+{
+	if (!strcmp(name, "t"))
+		seg_tl_ent->start_time = gf_mpd_parse_long_int(value);
+	else if (!strcmp(name, "d"))
+		seg_tl_ent->duration = gf_mpd_parse_int(value);
+	else if (!strcmp(name, "r")) {
+		seg_tl_ent->repeat_count = gf_mpd_parse_int(value);
+		if (seg_tl_ent->repeat_count == (u32)-1)
+			seg_tl_ent->repeat_count--;
+	}
+}
+
 static GF_MPD_SegmentTimeline *gf_mpd_parse_segment_timeline(GF_MPD *mpd, GF_XMLNode *root)
 {
 	u32 i, j;
@@ -370,7 +390,19 @@ static GF_MPD_SegmentTimeline *gf_mpd_parse_segment_timeline(GF_MPD *mpd, GF_XML
 	GF_MPD_SegmentTimeline *seg;
 	GF_SAFEALLOC(seg, GF_MPD_SegmentTimeline);
 	if (!seg) return NULL;
-	seg->entries = gf_list_new();
+
+	//entries already parsed by the SAX loader
+	i = 0;
+	while (mpd->sax_timelines && (i<gf_list_count(mpd->sax_timelines))) {
+		GF_MPD_SAXTimeline *sax_tl = gf_list_get(mpd->sax_timelines, i);
+		i++;
+		if (sax_tl->node != root) continue;
+		seg->entries = sax_tl->entries;
+		sax_tl->entries = NULL;
+		seg->doc_index = i;
+		break;
+	}
+	if (!seg->entries) seg->entries = gf_list_new();
 
 	i = 0;
 	while ( (child = gf_list_enum(root->content, &i))) {
@@ -383,15 +415,7 @@ static GF_MPD_SegmentTimeline *gf_mpd_parse_segment_timeline(GF_MPD *mpd, GF_XML
 
 			j = 0;
 			while ( (att = gf_list_enum(child->attributes, &j)) ) {
-				if (!strcmp(att->name, "t"))
-					seg_tl_ent->start_time = gf_mpd_parse_long_int(att->value);
-				else if (!strcmp(att->name, "d"))
-					seg_tl_ent->duration = gf_mpd_parse_int(att->value);
-				else if (!strcmp(att->name, "r")) {
-					seg_tl_ent->repeat_count = gf_mpd_parse_int(att->value);
-					if (seg_tl_ent->repeat_count == (u32)-1)
-						seg_tl_ent->repeat_count--;
-				}
+				gf_mpd_parse_timeline_entry_att(seg_tl_ent, att->name, att->value);
 			}
 		}
 	}
@@ -1114,6 +1138,41 @@ void gf_mpd_segment_base_free(void *_item)
 	gf_free(ptr);
 }
 
+/*serialized entry of a manifest list (timeline entry, playlist segment)*/
+typedef struct
+{
+	/*source object*/
+	const void *obj;
+	/*state of the source object when serialized*/
+	u64 key[4];
+	/*serialized text in cache buffer*/
+	u32 offset, size;
+} GF_MPD_SerialEntry;
+
+struct _gf_mpd_serial_cache
+{
+	/*serialized text of entries - text of purged or modified entries is only reclaimed when compacting*/
+	char *buf;
+	u32 buf_size, buf_alloc, live_size;
+	/*serialized entries, valid ones starting at first*/
+	GF_MPD_SerialEntry *entries;
+	u32 first, nb_entries, nb_alloc;
+	/*current entry while writing, and start of its text if being formatted*/
+	u32 cur, render_start;
+	/*output of the current write*/
+	char *out;
+	u32 out_size, out_alloc;
+};
+
+static void gf_mpd_serial_cache_del(GF_MPD_SerialCache *sc)
+{
+	if (!sc) return;
+	if (sc->buf) gf_free(sc->buf);
+	if (sc->entries) gf_free(sc->entries);
+	if (sc->out) gf_free(sc->out);
+	gf_free(sc);
+}
+
 void gf_mpd_segment_entry_free(void *_item)
 {
 	gf_free(_item);
@@ -1122,6 +1181,7 @@ void gf_mpd_segment_timeline_free(void *_item)
 {
 	GF_MPD_SegmentTimeline *ptr = (GF_MPD_SegmentTimeline *)_item;
 	gf_mpd_del_list(ptr->entries, gf_mpd_segment_entry_free, 0);
+	gf_mpd_serial_cache_del(ptr->serial);
 	gf_free(ptr);
 }
 
@@ -1294,6 +1354,7 @@ void gf_mpd_representation_free(void *_item)
 	}
 	if (ptr->m3u8_var_name) gf_free(ptr->m3u8_var_name);
 	if (ptr->m3u8_var_file) gf_fclose(ptr->m3u8_var_file);
+	gf_mpd_serial_cache_del(ptr->m3u8_serial);
 
 	gf_free(ptr);
 }
@@ -1350,6 +1411,7 @@ void gf_mpd_del(GF_MPD *mpd)
 	gf_mpd_del_list(mpd->program_infos, gf_mpd_prog_info_free, 0);
 	gf_mpd_del_list(mpd->base_URLs, gf_mpd_base_url_free, 0);
 	gf_mpd_del_list(mpd->locations, gf_mpd_string_free, 0);
+	if (mpd->patch_location) gf_free(mpd->patch_location);
 	gf_mpd_del_list(mpd->metrics, NULL/*TODO*/, 0);
 	gf_mpd_del_list(mpd->periods, gf_mpd_period_free, 0);
 	if (mpd->profiles) gf_free(mpd->profiles);
@@ -1450,6 +1512,16 @@ GF_Err gf_mpd_complete_from_dom(GF_XMLNode *root, GF_MPD *mpd, const char *defau
 		} else if (!strcmp(child->name, "Location")) {
 			char *str = gf_mpd_parse_text_content(child);
 			if (str) gf_list_add(mpd->locations, str);
+		} else if (!strcmp(child->name, "PatchLocation")) {
+			//only the first patch location is used
+			if (!mpd->patch_location) {
+				u32 j=0;
+				mpd->patch_location = gf_mpd_parse_text_content(child);
+				while ((att = gf_list_enum(child->attributes, &j))) {
+					if (!strcmp(att->name, "ttl"))
+						mpd->patch_location_ttl = gf_mpd_parse_int(att->value);
+				}
+			}
 		} else if (!strcmp(child->name, "Period")) {
 			e = gf_mpd_parse_period(mpd, child);
 			if (e) return e;
@@ -1494,6 +1566,1205 @@ GF_Err gf_mpd_init_from_dom(GF_XMLNode *root, GF_MPD *mpd, const char *default_b
 	return gf_mpd_complete_from_dom(root, mpd, default_base_url);
 }
 
+/*SAX loading of MPD files: the DOM of the document is built without the SegmentTimeline entries, which are directly parsed
+into their timeline objects. A signature of the document structure (everything but timeline entries, the startNumber of
+segment templates and lists carrying a timeline and the MPD publishTime) is computed while loading, so that new versions of
+the document can be merged without building a DOM*/
+enum
+{
+	MPD_SAX_NODE=0,
+	/*SegmentTemplate or SegmentList*/
+	MPD_SAX_SEG_DESC,
+	/*SegmentTimeline of a SegmentTemplate or SegmentList*/
+	MPD_SAX_TIMELINE,
+	/*timeline entry or child of a timeline entry, not part of the DOM nor of the signature*/
+	MPD_SAX_SKIP,
+};
+
+typedef struct
+{
+	u32 type;
+	/*for SEG_DESC, set if the element has a SegmentTimeline*/
+	Bool has_timeline;
+	/*for SEG_DESC, startNumber only added to the signature if the element has no SegmentTimeline*/
+	char *start_number;
+	/*for TIMELINE, namespace of the element*/
+	char *ns;
+} GF_MPD_SAXFrame;
+
+/*timeline values collected when merging*/
+typedef struct
+{
+	GF_MPD_SegmentTimelineEntry *entries;
+	u32 nb_entries, nb_alloc;
+	u32 start_number;
+} GF_MPD_MergeTimeline;
+
+typedef struct
+{
+	GF_MPD *mpd;
+	GF_SAXParser *sax;
+	/*if not set, no DOM is built and timeline entries are collected in timelines*/
+	Bool build_dom;
+	GF_XMLNode *root;
+	GF_List *stack;
+
+	GF_MPD_SAXFrame *frames;
+	u32 depth, nb_alloc_frames;
+	Bool root_done;
+
+	GF_SHA1Context *sig;
+	u8 digest[GF_SHA1_DIGEST_SIZE];
+	u64 publish_time;
+
+	/*timeline being parsed when building DOM*/
+	GF_MPD_SAXTimeline *cur_tl;
+	/*timelines collected when not building DOM*/
+	GF_MPD_MergeTimeline *timelines;
+	u32 nb_timelines, nb_alloc_timelines;
+
+	GF_Err e;
+} GF_MPD_SAXLoader;
+
+static void mpd_sax_hash(GF_MPD_SAXLoader *ldr, const char *str)
+{
+	if (!str) str = "";
+	gf_sha1_update(ldr->sig, (u8 *) str, (u32) strlen(str) + 1);
+}
+
+static void mpd_sax_error(GF_MPD_SAXLoader *ldr, GF_Err e)
+{
+	if (!ldr->e) ldr->e = e;
+	gf_xml_sax_suspend(ldr->sax, GF_TRUE);
+}
+
+static Bool mpd_sax_same_ns(const char *ns1, const char *ns2)
+{
+	if (!ns1 && !ns2) return GF_TRUE;
+	if (ns1 && ns2 && !strcmp(ns1, ns2)) return GF_TRUE;
+	return GF_FALSE;
+}
+
+static GF_MPD_SegmentTimelineEntry *mpd_sax_new_entry(GF_MPD_SAXLoader *ldr)
+{
+	GF_MPD_SegmentTimelineEntry *ent;
+	GF_MPD_MergeTimeline *tl;
+	if (ldr->build_dom) {
+		GF_SAFEALLOC(ent, GF_MPD_SegmentTimelineEntry);
+		if (!ent) return NULL;
+		if (gf_list_add(ldr->cur_tl->entries, ent)) {
+			gf_free(ent);
+			return NULL;
+		}
+		return ent;
+	}
+	tl = &ldr->timelines[ldr->nb_timelines-1];
+	if (tl->nb_entries == tl->nb_alloc) {
+		u32 nb_alloc = tl->nb_alloc ? 2*tl->nb_alloc : 64;
+		GF_MPD_SegmentTimelineEntry *entries = gf_realloc(tl->entries, sizeof(GF_MPD_SegmentTimelineEntry) * nb_alloc);
+		if (!entries) return NULL;
+		tl->entries = entries;
+		tl->nb_alloc = nb_alloc;
+	}
+	ent = &tl->entries[tl->nb_entries];
+	tl->nb_entries++;
+	memset(ent, 0, sizeof(GF_MPD_SegmentTimelineEntry));
+	return ent;
+}
+
+static GF_Err mpd_sax_new_timeline(GF_MPD_SAXLoader *ldr, const char *start_number)
+{
+	GF_MPD_MergeTimeline *tl;
+	if (ldr->build_dom) {
+		GF_SAFEALLOC(ldr->cur_tl, GF_MPD_SAXTimeline);
+		if (!ldr->cur_tl) return GF_OUT_OF_MEM;
+		ldr->cur_tl->node = gf_list_last(ldr->stack);
+		ldr->cur_tl->entries = gf_list_new();
+		if (!ldr->cur_tl->entries || gf_list_add(ldr->mpd->sax_timelines, ldr->cur_tl)) {
+			if (ldr->cur_tl->entries) gf_list_del(ldr->cur_tl->entries);
+			gf_free(ldr->cur_tl);
+			ldr->cur_tl = NULL;
+			return GF_OUT_OF_MEM;
+		}
+		return GF_OK;
+	}
+	if (ldr->nb_timelines == ldr->nb_alloc_timelines) {
+		u32 nb_alloc = ldr->nb_alloc_timelines + 16;
+		GF_MPD_MergeTimeline *timelines = gf_realloc(ldr->timelines, sizeof(GF_MPD_MergeTimeline) * nb_alloc);
+		if (!timelines) return GF_OUT_OF_MEM;
+		ldr->timelines = timelines;
+		ldr->nb_alloc_timelines = nb_alloc;
+	}
+	tl = &ldr->timelines[ldr->nb_timelines];
+	ldr->nb_timelines++;
+	memset(tl, 0, sizeof(GF_MPD_MergeTimeline));
+	tl->start_number = start_number ? gf_mpd_parse_int(start_number) : (u32) -1;
+	return GF_OK;
+}
+
+static void mpd_sax_node_start(void *sax_cbck, const char *node_name, const char *name_space, const GF_XMLAttribute *attributes, u32 nb_attributes)
+{
+	u32 i, type = MPD_SAX_NODE;
+	GF_MPD_SAXFrame *frame;
+	GF_MPD_SAXLoader *ldr = (GF_MPD_SAXLoader *)sax_cbck;
+
+	if (ldr->e) return;
+	//only one root
+	if (ldr->root_done) {
+		gf_xml_sax_suspend(ldr->sax, GF_TRUE);
+		return;
+	}
+	frame = ldr->depth ? &ldr->frames[ldr->depth-1] : NULL;
+	if (frame && (frame->type==MPD_SAX_SKIP)) {
+		type = MPD_SAX_SKIP;
+	}
+	else if (frame && (frame->type==MPD_SAX_TIMELINE) && !strcmp(node_name, "S") && mpd_sax_same_ns(name_space, frame->ns)) {
+		GF_MPD_SegmentTimelineEntry *ent = mpd_sax_new_entry(ldr);
+		if (!ent) {
+			mpd_sax_error(ldr, GF_OUT_OF_MEM);
+			return;
+		}
+		for (i=0; i<nb_attributes; i++)
+			gf_mpd_parse_timeline_entry_att(ent, attributes[i].name, attributes[i].value);
+		type = MPD_SAX_SKIP;
+	}
+	else if (!strcmp(node_name, "SegmentTemplate") || !strcmp(node_name, "SegmentList")) {
+		type = MPD_SAX_SEG_DESC;
+	}
+	else if (frame && (frame->type==MPD_SAX_SEG_DESC) && !strcmp(node_name, "SegmentTimeline")) {
+		type = MPD_SAX_TIMELINE;
+	}
+
+	if (ldr->depth == ldr->nb_alloc_frames) {
+		u32 nb_alloc = ldr->nb_alloc_frames + 16;
+		GF_MPD_SAXFrame *frames = gf_realloc(ldr->frames, sizeof(GF_MPD_SAXFrame) * nb_alloc);
+		if (!frames) {
+			mpd_sax_error(ldr, GF_OUT_OF_MEM);
+			return;
+		}
+		ldr->frames = frames;
+		ldr->nb_alloc_frames = nb_alloc;
+	}
+	frame = &ldr->frames[ldr->depth];
+	ldr->depth++;
+	memset(frame, 0, sizeof(GF_MPD_SAXFrame));
+	frame->type = type;
+	if (type==MPD_SAX_SKIP) return;
+
+	if (ldr->build_dom) {
+		GF_XMLNode *node;
+		GF_SAFEALLOC(node, GF_XMLNode);
+		if (!node || gf_list_add(ldr->stack, node)) {
+			if (node) gf_free(node);
+			mpd_sax_error(ldr, GF_OUT_OF_MEM);
+			return;
+		}
+		node->attributes = gf_list_new();
+		node->content = gf_list_new();
+		node->name = gf_strdup(node_name);
+		if (name_space) node->ns = gf_strdup(name_space);
+		if (!ldr->root) ldr->root = node;
+		if (!node->attributes || !node->content || !node->name || (name_space && !node->ns)) {
+			mpd_sax_error(ldr, GF_OUT_OF_MEM);
+			return;
+		}
+		for (i=0; i<nb_attributes; i++) {
+			GF_XMLAttribute *att;
+			GF_SAFEALLOC(att, GF_XMLAttribute);
+			if (!att || gf_list_add(node->attributes, att)) {
+				if (att) gf_free(att);
+				mpd_sax_error(ldr, GF_OUT_OF_MEM);
+				return;
+			}
+			att->name = gf_strdup(attributes[i].name);
+			att->value = gf_strdup(attributes[i].value);
+		}
+	}
+
+	mpd_sax_hash(ldr, "<");
+	mpd_sax_hash(ldr, name_space);
+	mpd_sax_hash(ldr, node_name);
+	for (i=0; i<nb_attributes; i++) {
+		if ((ldr->depth==1) && !strcmp(attributes[i].name, "publishTime")) {
+			ldr->publish_time = gf_mpd_parse_date(attributes[i].value);
+			continue;
+		}
+		if ((type==MPD_SAX_SEG_DESC) && !strcmp(attributes[i].name, "startNumber")) {
+			if (!frame->start_number) frame->start_number = gf_strdup(attributes[i].value);
+			continue;
+		}
+		mpd_sax_hash(ldr, attributes[i].name);
+		mpd_sax_hash(ldr, attributes[i].value);
+	}
+
+	if (type==MPD_SAX_TIMELINE) {
+		GF_MPD_SAXFrame *seg_desc = &ldr->frames[ldr->depth-2];
+		GF_Err e;
+		seg_desc->has_timeline = GF_TRUE;
+		if (name_space) frame->ns = gf_strdup(name_space);
+		e = mpd_sax_new_timeline(ldr, seg_desc->start_number);
+		if (e) mpd_sax_error(ldr, e);
+	}
+}
+
+static void mpd_sax_node_end(void *sax_cbck, const char *node_name, const char *name_space)
+{
+	GF_MPD_SAXFrame *frame;
+	GF_MPD_SAXLoader *ldr = (GF_MPD_SAXLoader *)sax_cbck;
+
+	if (ldr->e || !ldr->depth) return;
+	frame = &ldr->frames[ldr->depth-1];
+	ldr->depth--;
+	if (frame->type==MPD_SAX_SKIP) return;
+
+	if (frame->start_number) {
+		if (!frame->has_timeline) {
+			mpd_sax_hash(ldr, "startNumber");
+			mpd_sax_hash(ldr, frame->start_number);
+		}
+		gf_free(frame->start_number);
+		frame->start_number = NULL;
+	}
+	if (frame->type==MPD_SAX_TIMELINE) {
+		if (frame->ns) gf_free(frame->ns);
+		frame->ns = NULL;
+		ldr->cur_tl = NULL;
+	}
+	mpd_sax_hash(ldr, "</");
+	mpd_sax_hash(ldr, name_space);
+	mpd_sax_hash(ldr, node_name);
+	if (!ldr->depth) ldr->root_done = GF_TRUE;
+
+	if (ldr->build_dom) {
+		GF_XMLNode *last = gf_list_last(ldr->stack);
+		gf_list_rem_last(ldr->stack);
+		if (!last || strcmp(last->name, node_name) || !mpd_sax_same_ns(last->ns, name_space)) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[MPD] Invalid node stack: closing node is %s but %s was expected\n", node_name, last ? last->name : "unknown"));
+			if (last==ldr->root) ldr->root = NULL;
+			gf_xml_dom_node_del(last);
+			mpd_sax_error(ldr, GF_NON_COMPLIANT_BITSTREAM);
+			return;
+		}
+		if (last != ldr->root) {
+			GF_XMLNode *parent = gf_list_last(ldr->stack);
+			if (gf_list_add(parent->content, last)) {
+				gf_xml_dom_node_del(last);
+				mpd_sax_error(ldr, GF_OUT_OF_MEM);
+			}
+		}
+	}
+}
+
+static void mpd_sax_text_content(void *sax_cbck, const char *content, Bool is_cdata)
+{
+	u32 i;
+	Bool is_space = GF_TRUE;
+	GF_MPD_SAXFrame *frame;
+	GF_XMLNode *node, *last;
+	GF_MPD_SAXLoader *ldr = (GF_MPD_SAXLoader *)sax_cbck;
+
+	if (ldr->e || !ldr->depth || !content) return;
+	frame = &ldr->frames[ldr->depth-1];
+	if (frame->type==MPD_SAX_SKIP) return;
+
+	for (i=0; content[i]; i++) {
+		if (!strchr(" \t\r\n", content[i])) {
+			is_space = GF_FALSE;
+			break;
+		}
+	}
+	if (!is_space) {
+		mpd_sax_hash(ldr, is_cdata ? "<![CDATA[" : "\"");
+		mpd_sax_hash(ldr, content);
+	}
+	//no need to keep formatting of large timelines
+	if (!ldr->build_dom || (is_space && (frame->type==MPD_SAX_TIMELINE)))
+		return;
+
+	last = gf_list_last(ldr->stack);
+	if (!last) return;
+	GF_SAFEALLOC(node, GF_XMLNode);
+	if (!node || gf_list_add(last->content, node)) {
+		if (node) gf_free(node);
+		mpd_sax_error(ldr, GF_OUT_OF_MEM);
+		return;
+	}
+	node->type = is_cdata ? GF_XML_CDATA_TYPE : GF_XML_TEXT_TYPE;
+	node->name = gf_strdup(content);
+}
+
+static GF_Err gf_mpd_sax_load(GF_MPD_SAXLoader *ldr, const char *file)
+{
+	GF_Err e = GF_OK;
+	u8 digest[GF_SHA1_DIGEST_SIZE];
+
+	ldr->sig = gf_sha1_starts();
+	if (ldr->build_dom) ldr->stack = gf_list_new();
+	ldr->sax = gf_xml_sax_new(mpd_sax_node_start, mpd_sax_node_end, mpd_sax_text_content, ldr);
+	if (!ldr->sig || !ldr->sax || (ldr->build_dom && !ldr->stack)) e = GF_OUT_OF_MEM;
+
+	if (!e) {
+		e = gf_xml_sax_parse_file(ldr->sax, file, NULL);
+		if (e>0) e = GF_OK;
+		else if (e<0) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[MPD] Failed to parse %s: %s\n", file, gf_xml_sax_get_error(ldr->sax)));
+		}
+		if (ldr->e) e = ldr->e;
+		if (!e && !ldr->root_done) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[MPD] Incomplete document %s: %s\n", file, gf_xml_sax_get_error(ldr->sax)));
+			e = GF_NON_COMPLIANT_BITSTREAM;
+		}
+	}
+	if (ldr->sig) {
+		gf_sha1_finish(ldr->sig, digest);
+		if (!e) memcpy(ldr->digest, digest, GF_SHA1_DIGEST_SIZE);
+		ldr->sig = NULL;
+	}
+	if (ldr->sax) gf_xml_sax_del(ldr->sax);
+	ldr->sax = NULL;
+
+	//unclosed nodes are not attached to their parent
+	while (gf_list_count(ldr->stack)) {
+		GF_XMLNode *node = gf_list_pop_back(ldr->stack);
+		if (node==ldr->root) ldr->root = NULL;
+		gf_xml_dom_node_del(node);
+	}
+	gf_list_del(ldr->stack);
+	ldr->stack = NULL;
+	while (ldr->depth) {
+		GF_MPD_SAXFrame *frame = &ldr->frames[ldr->depth-1];
+		if (frame->start_number) gf_free(frame->start_number);
+		if (frame->ns) gf_free(frame->ns);
+		ldr->depth--;
+	}
+	if (ldr->frames) gf_free(ldr->frames);
+	ldr->frames = NULL;
+	return e;
+}
+
+static void gf_mpd_sax_reset_timelines(GF_MPD_SAXLoader *ldr)
+{
+	u32 i;
+	for (i=0; i<ldr->nb_timelines; i++) {
+		if (ldr->timelines[i].entries) gf_free(ldr->timelines[i].entries);
+	}
+	if (ldr->timelines) gf_free(ldr->timelines);
+	ldr->timelines = NULL;
+	ldr->nb_timelines = ldr->nb_alloc_timelines = 0;
+}
+
+GF_EXPORT
+GF_Err gf_mpd_init_from_file(const char *file, GF_MPD *mpd, const char *base_url)
+{
+	GF_Err e;
+	GF_MPD_SAXLoader ldr;
+	if (!file || !mpd) return GF_BAD_PARAM;
+
+	memset(&ldr, 0, sizeof(GF_MPD_SAXLoader));
+	ldr.mpd = mpd;
+	ldr.build_dom = GF_TRUE;
+	mpd->sax_timelines = gf_list_new();
+	if (!mpd->sax_timelines) return GF_OUT_OF_MEM;
+
+	e = gf_mpd_sax_load(&ldr, file);
+	if (!e) e = gf_mpd_init_from_dom(ldr.root, mpd, base_url);
+	if (!e) {
+		mpd->nb_doc_timelines = gf_list_count(mpd->sax_timelines);
+		memcpy(mpd->doc_signature, ldr.digest, GF_SHA1_DIGEST_SIZE);
+	}
+
+	//destroy timelines not used by the MPD
+	while (gf_list_count(mpd->sax_timelines)) {
+		GF_MPD_SAXTimeline *sax_tl = gf_list_pop_back(mpd->sax_timelines);
+		gf_mpd_del_list(sax_tl->entries, gf_mpd_segment_entry_free, 0);
+		gf_free(sax_tl);
+	}
+	gf_list_del(mpd->sax_timelines);
+	mpd->sax_timelines = NULL;
+	if (ldr.root) gf_xml_dom_node_del(ldr.root);
+	return e;
+}
+
+/*advances start time by the segments of the entry and returns the number of these segments starting at or after end_time*/
+static u32 gf_mpd_timeline_entry_segments_after(GF_MPD_SegmentTimelineEntry *ent, u64 *start_time, u64 end_time)
+{
+	u32 nb_segs, nb_before;
+	if (ent->start_time) *start_time = ent->start_time;
+	//negative repeat count (until next entry or period end), only count first segment
+	nb_segs = (ent->repeat_count >= (u32) -2) ? 1 : ent->repeat_count + 1;
+
+	if (*start_time >= end_time) nb_before = 0;
+	else if (!ent->duration) nb_before = nb_segs;
+	else nb_before = (u32) ((end_time - *start_time + ent->duration - 1) / ent->duration);
+
+	*start_time += ((u64) ent->duration) * nb_segs;
+	return (nb_before>=nb_segs) ? 0 : nb_segs - nb_before;
+}
+
+static u64 gf_mpd_timeline_end(GF_List *entries)
+{
+	u32 i=0;
+	u64 start = 0;
+	GF_MPD_SegmentTimelineEntry *ent;
+	while ((ent = gf_list_enum(entries, &i))) {
+		gf_mpd_timeline_entry_segments_after(ent, &start, (u64) -1);
+	}
+	return start;
+}
+
+static Bool gf_mpd_merge_collect(GF_MPD_MultipleSegmentBase *seg, GF_MPD_MultipleSegmentBase **owners, u32 nb_owners)
+{
+	u32 idx;
+	if (!seg || !seg->segment_timeline) return GF_TRUE;
+	idx = seg->segment_timeline->doc_index;
+	if (!idx || (idx>nb_owners) || owners[idx-1]) return GF_FALSE;
+	owners[idx-1] = seg;
+	return GF_TRUE;
+}
+
+GF_EXPORT
+GF_Err gf_mpd_merge_file(const char *file, GF_MPD *mpd, u32 *nb_new_entries)
+{
+	GF_Err e;
+	u32 i, j, k, nb_alloc=0, nb_new=0;
+	Bool ok = GF_TRUE;
+	u8 zero_sig[GF_SHA1_DIGEST_SIZE];
+	GF_MPD_SAXLoader ldr;
+	GF_MPD_MultipleSegmentBase **owners = NULL;
+	GF_List *new_entries = NULL;
+	GF_MPD_Period *period;
+
+	if (nb_new_entries) *nb_new_entries = 0;
+	if (!file || !mpd) return GF_BAD_PARAM;
+	//not loaded through gf_mpd_init_from_file
+	memset(zero_sig, 0, GF_SHA1_DIGEST_SIZE);
+	if (!memcmp(mpd->doc_signature, zero_sig, GF_SHA1_DIGEST_SIZE)) return GF_NOT_SUPPORTED;
+
+	memset(&ldr, 0, sizeof(GF_MPD_SAXLoader));
+	ldr.mpd = mpd;
+	e = gf_mpd_sax_load(&ldr, file);
+	if (e) goto exit;
+
+	if (memcmp(ldr.digest, mpd->doc_signature, GF_SHA1_DIGEST_SIZE) || (ldr.nb_timelines != mpd->nb_doc_timelines)) {
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[MPD] Document structure changed, cannot merge\n"));
+		e = GF_NOT_SUPPORTED;
+		goto exit;
+	}
+
+	//locate timelines of the document in the MPD
+	if (ldr.nb_timelines) {
+		owners = gf_malloc(sizeof(GF_MPD_MultipleSegmentBase *) * ldr.nb_timelines);
+		if (!owners) {
+			e = GF_OUT_OF_MEM;
+			goto exit;
+		}
+		memset(owners, 0, sizeof(GF_MPD_MultipleSegmentBase *) * ldr.nb_timelines);
+	}
+	i=0;
+	while (ok && (period = gf_list_enum(mpd->periods, &i))) {
+		GF_MPD_AdaptationSet *as;
+		ok = gf_mpd_merge_collect((GF_MPD_MultipleSegmentBase *) period->segment_template, owners, ldr.nb_timelines)
+			&& gf_mpd_merge_collect((GF_MPD_MultipleSegmentBase *) period->segment_list, owners, ldr.nb_timelines);
+		j=0;
+		while (ok && (as = gf_list_enum(period->adaptation_sets, &j))) {
+			GF_MPD_Representation *rep;
+			ok = gf_mpd_merge_collect((GF_MPD_MultipleSegmentBase *) as->segment_template, owners, ldr.nb_timelines)
+				&& gf_mpd_merge_collect((GF_MPD_MultipleSegmentBase *) as->segment_list, owners, ldr.nb_timelines);
+			k=0;
+			while (ok && (rep = gf_list_enum(as->representations, &k))) {
+				ok = gf_mpd_merge_collect((GF_MPD_MultipleSegmentBase *) rep->segment_template, owners, ldr.nb_timelines)
+					&& gf_mpd_merge_collect((GF_MPD_MultipleSegmentBase *) rep->segment_list, owners, ldr.nb_timelines);
+			}
+		}
+	}
+	for (i=0; ok && (i<ldr.nb_timelines); i++) {
+		if (!owners[i]) ok = GF_FALSE;
+	}
+	if (!ok) {
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[MPD] SegmentTimeline elements do not match the MPD, cannot merge\n"));
+		e = GF_NOT_SUPPORTED;
+		goto exit;
+	}
+
+	//allocate all new entries before modifying the MPD
+	for (i=0; i<ldr.nb_timelines; i++) {
+		u32 count = gf_list_count(owners[i]->segment_timeline->entries);
+		if (ldr.timelines[i].nb_entries > count)
+			nb_alloc += ldr.timelines[i].nb_entries - count;
+	}
+	new_entries = gf_list_new();
+	if (!new_entries) {
+		e = GF_OUT_OF_MEM;
+		goto exit;
+	}
+	for (i=0; i<nb_alloc; i++) {
+		GF_MPD_SegmentTimelineEntry *ent;
+		GF_SAFEALLOC(ent, GF_MPD_SegmentTimelineEntry);
+		if (!ent || gf_list_add(new_entries, ent)) {
+			if (ent) gf_free(ent);
+			e = GF_OUT_OF_MEM;
+			goto exit;
+		}
+	}
+
+	//rewrite entries in place
+	for (i=0; i<ldr.nb_timelines; i++) {
+		GF_MPD_MergeTimeline *mtl = &ldr.timelines[i];
+		GF_List *entries = owners[i]->segment_timeline->entries;
+		u64 start = 0, end = gf_mpd_timeline_end(entries);
+
+		while (gf_list_count(entries) > mtl->nb_entries) {
+			gf_free(gf_list_pop_back(entries));
+		}
+		for (j=0; j<mtl->nb_entries; j++) {
+			GF_MPD_SegmentTimelineEntry *ent = gf_list_get(entries, j);
+			if (!ent) {
+				ent = gf_list_pop_back(new_entries);
+				gf_list_add(entries, ent);
+			}
+			*ent = mtl->entries[j];
+			nb_new += gf_mpd_timeline_entry_segments_after(ent, &start, end);
+		}
+		//timeline is now the one of the document
+		owners[i]->segment_timeline->nb_purged = 0;
+		owners[i]->start_number = mtl->start_number;
+	}
+	mpd->publishTime = ldr.publish_time;
+	if (nb_new_entries) *nb_new_entries = nb_new;
+
+exit:
+	gf_mpd_sax_reset_timelines(&ldr);
+	if (owners) gf_free(owners);
+	gf_mpd_del_list(new_entries, gf_mpd_segment_entry_free, 0);
+	return e;
+}
+
+/*MPD patch (ISO/IEC 23009-1 Annex J, using RFC 5261 operations): changes are staged and only applied to the MPD
+once all operations of the patch have been validated*/
+enum
+{
+	MPD_PATCH_ADD=0,
+	MPD_PATCH_REPLACE,
+	MPD_PATCH_REMOVE,
+};
+
+/*targets of patch selectors*/
+enum
+{
+	MPD_PATCH_MPD=0,
+	MPD_PATCH_PATCH_LOCATION,
+	MPD_PATCH_SEG_DESC,
+	MPD_PATCH_TIMELINE,
+	MPD_PATCH_S,
+};
+
+typedef struct
+{
+	GF_MPD_SegmentTimeline *tl;
+	/*entries of the timeline after patching*/
+	GF_List *entries;
+	/*end time of the timeline before patching*/
+	u64 end;
+} GF_MPD_PatchTimeline;
+
+typedef struct
+{
+	GF_MPD_MultipleSegmentBase *seg;
+	u32 start_number;
+} GF_MPD_PatchStartNumber;
+
+typedef struct
+{
+	GF_MPD *mpd;
+	GF_List *timelines;
+	GF_List *start_numbers;
+	/*entries allocated by the patch, destroyed if the patch fails*/
+	GF_List *new_entries;
+	/*entries removed from the MPD, destroyed if the patch succeeds*/
+	GF_List *removed_entries;
+
+	u64 publish_time;
+	u32 min_update_period;
+	Bool patch_location_set;
+	char *patch_location;
+	u32 patch_location_ttl;
+} GF_MPD_PatchCtx;
+
+typedef struct
+{
+	u32 type;
+	GF_MPD_MultipleSegmentBase *seg;
+	GF_MPD_PatchTimeline *ptl;
+	/*index of the entry in the patched timeline*/
+	u32 s_idx;
+	/*target attribute, NULL if the selector targets an element*/
+	const char *att;
+} GF_MPD_PatchTarget;
+
+/*parses the next step of a selector in place, sets sel to the following step or NULL if last*/
+static Bool gf_mpd_patch_step(char **sel, char **name, char **att, char **val, u32 *idx)
+{
+	char *s = *sel, *sep;
+	*name = s;
+	*att = *val = NULL;
+	*idx = 0;
+
+	while (*s && (*s!='/') && (*s!='[')) s++;
+	if (*s=='[') {
+		*s = 0;
+		s++;
+		if (*s=='@') {
+			char quote;
+			*att = s+1;
+			sep = strchr(s, '=');
+			if (!sep) return GF_FALSE;
+			*sep = 0;
+			quote = sep[1];
+			if ((quote!='\'') && (quote!='"')) return GF_FALSE;
+			*val = sep+2;
+			sep = strchr(sep+2, quote);
+			if (!sep || (sep[1]!=']')) return GF_FALSE;
+			*sep = 0;
+			s = sep+2;
+		} else {
+			*idx = atoi(s);
+			sep = strchr(s, ']');
+			if (!*idx || !sep) return GF_FALSE;
+			s = sep+1;
+		}
+	}
+	if (*s=='/') {
+		*s = 0;
+		*sel = s+1;
+	} else if (*s) {
+		return GF_FALSE;
+	} else {
+		*sel = NULL;
+	}
+	//ignore namespace prefix of elements
+	if ((*name)[0] != '@') {
+		sep = strchr(*name, ':');
+		if (sep) *name = sep+1;
+	}
+	return (*name)[0] ? GF_TRUE : GF_FALSE;
+}
+
+static void *gf_mpd_patch_find(GF_List *list, u32 level, const char *att, const char *val, u32 idx)
+{
+	u32 i=0;
+	void *item;
+	if (idx) return gf_list_get(list, idx-1);
+	if (!att || strcmp(att, "id")) return NULL;
+	while ((item = gf_list_enum(list, &i))) {
+		const char *id = NULL;
+		if (level==0) id = ((GF_MPD_Period *)item)->ID;
+		else if (level==2) id = ((GF_MPD_Representation *)item)->id;
+		else if (((GF_MPD_AdaptationSet *)item)->id == atoi(val)) return item;
+
+		if (id && !strcmp(id, val)) return item;
+	}
+	return NULL;
+}
+
+static GF_MPD_PatchTimeline *gf_mpd_patch_get_timeline(GF_MPD_PatchCtx *ctx, GF_MPD_SegmentTimeline *tl)
+{
+	u32 i=0;
+	GF_MPD_PatchTimeline *ptl;
+	while ((ptl = gf_list_enum(ctx->timelines, &i))) {
+		if (ptl->tl == tl) return ptl;
+	}
+	GF_SAFEALLOC(ptl, GF_MPD_PatchTimeline);
+	if (!ptl) return NULL;
+	ptl->tl = tl;
+	ptl->entries = gf_list_clone(tl->entries);
+	ptl->end = gf_mpd_timeline_end(tl->entries);
+	if (!ptl->entries || gf_list_add(ctx->timelines, ptl)) {
+		if (ptl->entries) gf_list_del(ptl->entries);
+		gf_free(ptl);
+		return NULL;
+	}
+	return ptl;
+}
+
+static GF_Err gf_mpd_patch_resolve(GF_MPD_PatchCtx *ctx, char *sel, GF_MPD_PatchTarget *tgt)
+{
+	char *name, *att, *val;
+	u32 idx;
+	GF_MPD_Period *period = NULL;
+	GF_MPD_AdaptationSet *as = NULL;
+	GF_MPD_Representation *rep = NULL;
+
+	memset(tgt, 0, sizeof(GF_MPD_PatchTarget));
+	if (sel[0] != '/') return GF_NOT_SUPPORTED;
+	sel++;
+	if (!gf_mpd_patch_step(&sel, &name, &att, &val, &idx) || strcmp(name, "MPD") || att || idx)
+		return GF_NOT_SUPPORTED;
+	tgt->type = MPD_PATCH_MPD;
+
+	while (sel) {
+		if (!gf_mpd_patch_step(&sel, &name, &att, &val, &idx))
+			return GF_NOT_SUPPORTED;
+		//attribute, last step
+		if (name[0]=='@') {
+			if (sel) return GF_NOT_SUPPORTED;
+			tgt->att = name+1;
+			return GF_OK;
+		}
+
+		if (tgt->type == MPD_PATCH_MPD) {
+			GF_List *list = NULL;
+			u32 level = 0;
+			if (!period && !strcmp(name, "PatchLocation")) {
+				if (att || (idx>1)) return GF_NOT_SUPPORTED;
+				if (ctx->patch_location_set ? !ctx->patch_location : !ctx->mpd->patch_location) return GF_NOT_SUPPORTED;
+				tgt->type = MPD_PATCH_PATCH_LOCATION;
+				continue;
+			}
+			if (!period && !strcmp(name, "Period")) list = ctx->mpd->periods;
+			else if (period && !as && !strcmp(name, "AdaptationSet")) {
+				list = period->adaptation_sets;
+				level = 1;
+			}
+			else if (as && !rep && !strcmp(name, "Representation")) {
+				list = as->representations;
+				level = 2;
+			}
+			if (list) {
+				void *item = gf_mpd_patch_find(list, level, att, val, idx);
+				if (!item) return GF_NOT_SUPPORTED;
+				if (level==0) period = item;
+				else if (level==1) as = item;
+				else rep = item;
+				continue;
+			}
+			if (!strcmp(name, "SegmentTemplate")) {
+				if (rep) tgt->seg = (GF_MPD_MultipleSegmentBase *) rep->segment_template;
+				else if (as) tgt->seg = (GF_MPD_MultipleSegmentBase *) as->segment_template;
+				else if (period) tgt->seg = (GF_MPD_MultipleSegmentBase *) period->segment_template;
+			} else if (!strcmp(name, "SegmentList")) {
+				if (rep) tgt->seg = (GF_MPD_MultipleSegmentBase *) rep->segment_list;
+				else if (as) tgt->seg = (GF_MPD_MultipleSegmentBase *) as->segment_list;
+				else if (period) tgt->seg = (GF_MPD_MultipleSegmentBase *) period->segment_list;
+			}
+			if (!tgt->seg || att || (idx>1)) return GF_NOT_SUPPORTED;
+			tgt->type = MPD_PATCH_SEG_DESC;
+			continue;
+		}
+		if (tgt->type == MPD_PATCH_SEG_DESC) {
+			if (strcmp(name, "SegmentTimeline") || att || (idx>1) || !tgt->seg->segment_timeline)
+				return GF_NOT_SUPPORTED;
+			tgt->ptl = gf_mpd_patch_get_timeline(ctx, tgt->seg->segment_timeline);
+			if (!tgt->ptl) return GF_OUT_OF_MEM;
+			tgt->type = MPD_PATCH_TIMELINE;
+			continue;
+		}
+		if ((tgt->type == MPD_PATCH_TIMELINE) && !strcmp(name, "S")) {
+			u32 count = gf_list_count(tgt->ptl->entries);
+			if (idx) {
+				//positions are relative to the timeline of the server, unknown once the client removed segments from the timeline
+				if (tgt->ptl->tl->nb_purged) return GF_NOT_SUPPORTED;
+				if (idx > count) return GF_NOT_SUPPORTED;
+				tgt->s_idx = idx-1;
+			} else if (att && !strcmp(att, "t")) {
+				u64 t = gf_mpd_parse_long_int(val), start = 0;
+				for (idx=0; idx<count; idx++) {
+					GF_MPD_SegmentTimelineEntry *ent = gf_list_get(tgt->ptl->entries, idx);
+					if (ent->start_time) start = ent->start_time;
+					if (start == t) break;
+					gf_mpd_timeline_entry_segments_after(ent, &start, (u64) -1);
+				}
+				if (idx==count) return GF_NOT_SUPPORTED;
+				tgt->s_idx = idx;
+			} else {
+				return GF_NOT_SUPPORTED;
+			}
+			tgt->type = MPD_PATCH_S;
+			continue;
+		}
+		return GF_NOT_SUPPORTED;
+	}
+	return GF_OK;
+}
+
+static void gf_mpd_patch_drop_entry(GF_MPD_PatchCtx *ctx, GF_MPD_SegmentTimelineEntry *ent)
+{
+	s32 idx = gf_list_find(ctx->new_entries, ent);
+	if (idx>=0) {
+		gf_list_rem(ctx->new_entries, idx);
+		gf_free(ent);
+	} else {
+		gf_list_add(ctx->removed_entries, ent);
+	}
+}
+
+/*gets an entry for modification, entries of the MPD are copied*/
+static GF_MPD_SegmentTimelineEntry *gf_mpd_patch_edit_entry(GF_MPD_PatchCtx *ctx, GF_MPD_PatchTarget *tgt)
+{
+	GF_MPD_SegmentTimelineEntry *copy, *ent = gf_list_get(tgt->ptl->entries, tgt->s_idx);
+	if (gf_list_find(ctx->new_entries, ent)>=0) return ent;
+
+	GF_SAFEALLOC(copy, GF_MPD_SegmentTimelineEntry);
+	if (!copy) return NULL;
+	if (gf_list_add(ctx->new_entries, copy)) {
+		gf_free(copy);
+		return NULL;
+	}
+	*copy = *ent;
+	gf_list_rem(tgt->ptl->entries, tgt->s_idx);
+	gf_list_insert(tgt->ptl->entries, copy, tgt->s_idx);
+	gf_list_add(ctx->removed_entries, ent);
+	return copy;
+}
+
+static GF_Err gf_mpd_patch_insert_entries(GF_MPD_PatchCtx *ctx, GF_MPD_PatchTimeline *ptl, GF_XMLNode *op, u32 pos)
+{
+	u32 i=0;
+	GF_XMLNode *child;
+	while ((child = gf_list_enum(op->content, &i))) {
+		u32 j=0;
+		GF_XMLAttribute *att;
+		GF_MPD_SegmentTimelineEntry *ent;
+		if (child->type != GF_XML_NODE_TYPE) continue;
+		if (strcmp(child->name, "S")) return GF_NOT_SUPPORTED;
+
+		GF_SAFEALLOC(ent, GF_MPD_SegmentTimelineEntry);
+		if (!ent) return GF_OUT_OF_MEM;
+		if (gf_list_add(ctx->new_entries, ent)) {
+			gf_free(ent);
+			return GF_OUT_OF_MEM;
+		}
+		while ((att = gf_list_enum(child->attributes, &j))) {
+			gf_mpd_parse_timeline_entry_att(ent, att->name, att->value);
+		}
+		if (gf_list_insert(ptl->entries, ent, pos)) return GF_OUT_OF_MEM;
+		pos++;
+	}
+	return GF_OK;
+}
+
+static GF_Err gf_mpd_patch_set_start_number(GF_MPD_PatchCtx *ctx, GF_MPD_MultipleSegmentBase *seg, u32 start_number)
+{
+	u32 i=0;
+	GF_MPD_PatchStartNumber *psn;
+	while ((psn = gf_list_enum(ctx->start_numbers, &i))) {
+		if (psn->seg == seg) break;
+	}
+	if (!psn) {
+		GF_SAFEALLOC(psn, GF_MPD_PatchStartNumber);
+		if (!psn) return GF_OUT_OF_MEM;
+		if (gf_list_add(ctx->start_numbers, psn)) {
+			gf_free(psn);
+			return GF_OUT_OF_MEM;
+		}
+		psn->seg = seg;
+	}
+	psn->start_number = start_number;
+	return GF_OK;
+}
+
+static GF_Err gf_mpd_patch_set_location(GF_MPD_PatchCtx *ctx, GF_XMLNode *pl)
+{
+	u32 i=0;
+	GF_XMLAttribute *att;
+	char *url = gf_mpd_parse_text_content(pl);
+	if (!url) return GF_NOT_SUPPORTED;
+	if (ctx->patch_location) gf_free(ctx->patch_location);
+	ctx->patch_location = url;
+	ctx->patch_location_set = GF_TRUE;
+	ctx->patch_location_ttl = 0;
+	while ((att = gf_list_enum(pl->attributes, &i))) {
+		if (!strcmp(att->name, "ttl"))
+			ctx->patch_location_ttl = gf_mpd_parse_int(att->value);
+	}
+	return GF_OK;
+}
+
+static GF_Err gf_mpd_patch_att(GF_MPD_PatchCtx *ctx, GF_MPD_PatchTarget *tgt, u32 op_type, GF_XMLNode *op)
+{
+	GF_Err e = GF_OK;
+	char *val = NULL;
+	if (op_type != MPD_PATCH_REMOVE) {
+		val = gf_mpd_parse_text_content(op);
+		if (!val) return GF_NOT_SUPPORTED;
+	}
+
+	switch (tgt->type) {
+	case MPD_PATCH_MPD:
+		if (!strcmp(tgt->att, "publishTime") && val)
+			ctx->publish_time = gf_mpd_parse_date(val);
+		else if (!strcmp(tgt->att, "minimumUpdatePeriod"))
+			ctx->min_update_period = val ? gf_mpd_parse_duration_u32(val) : 0;
+		else
+			e = GF_NOT_SUPPORTED;
+		break;
+	case MPD_PATCH_PATCH_LOCATION:
+		if (!strcmp(tgt->att, "ttl")) {
+			if (!ctx->patch_location_set) {
+				ctx->patch_location = gf_strdup(ctx->mpd->patch_location);
+				ctx->patch_location_set = GF_TRUE;
+			}
+			ctx->patch_location_ttl = val ? gf_mpd_parse_int(val) : 0;
+		} else {
+			e = GF_NOT_SUPPORTED;
+		}
+		break;
+	case MPD_PATCH_SEG_DESC:
+		if (!strcmp(tgt->att, "startNumber"))
+			e = gf_mpd_patch_set_start_number(ctx, tgt->seg, val ? gf_mpd_parse_int(val) : (u32) -1);
+		else
+			e = GF_NOT_SUPPORTED;
+		break;
+	case MPD_PATCH_S:
+		if (!strcmp(tgt->att, "t") || !strcmp(tgt->att, "d") || !strcmp(tgt->att, "r")) {
+			GF_MPD_SegmentTimelineEntry *ent;
+			//duration is mandatory
+			if (!val && !strcmp(tgt->att, "d")) {
+				e = GF_NOT_SUPPORTED;
+				break;
+			}
+			ent = gf_mpd_patch_edit_entry(ctx, tgt);
+			if (!ent) e = GF_OUT_OF_MEM;
+			else if (val) gf_mpd_parse_timeline_entry_att(ent, tgt->att, val);
+			else if (tgt->att[0]=='t') ent->start_time = 0;
+			else ent->repeat_count = 0;
+		} else {
+			e = GF_NOT_SUPPORTED;
+		}
+		break;
+	default:
+		e = GF_NOT_SUPPORTED;
+		break;
+	}
+	if (val) gf_free(val);
+	return e;
+}
+
+static GF_Err gf_mpd_patch_elt(GF_MPD_PatchCtx *ctx, GF_MPD_PatchTarget *tgt, u32 op_type, const char *pos, GF_XMLNode *op)
+{
+	u32 i=0;
+	GF_Err e;
+	GF_XMLNode *child;
+	GF_MPD_SegmentTimelineEntry *ent;
+
+	switch (tgt->type) {
+	case MPD_PATCH_MPD:
+		//only PatchLocation elements can be added to the MPD
+		if (op_type != MPD_PATCH_ADD) return GF_NOT_SUPPORTED;
+		while ((child = gf_list_enum(op->content, &i))) {
+			if (child->type != GF_XML_NODE_TYPE) continue;
+			if (strcmp(child->name, "PatchLocation")) return GF_NOT_SUPPORTED;
+			//only the first patch location is used
+			if (ctx->patch_location_set ? ctx->patch_location : ctx->mpd->patch_location) continue;
+			e = gf_mpd_patch_set_location(ctx, child);
+			if (e) return e;
+		}
+		return GF_OK;
+
+	case MPD_PATCH_PATCH_LOCATION:
+		if (op_type == MPD_PATCH_REMOVE) {
+			if (ctx->patch_location) gf_free(ctx->patch_location);
+			ctx->patch_location = NULL;
+			ctx->patch_location_ttl = 0;
+			ctx->patch_location_set = GF_TRUE;
+			return GF_OK;
+		}
+		if (op_type != MPD_PATCH_REPLACE) return GF_NOT_SUPPORTED;
+		while ((child = gf_list_enum(op->content, &i))) {
+			if (child->type != GF_XML_NODE_TYPE) continue;
+			if (strcmp(child->name, "PatchLocation")) return GF_NOT_SUPPORTED;
+			return gf_mpd_patch_set_location(ctx, child);
+		}
+		return GF_NOT_SUPPORTED;
+
+	case MPD_PATCH_TIMELINE:
+		if (op_type != MPD_PATCH_ADD) return GF_NOT_SUPPORTED;
+		if (!pos || !strcmp(pos, "append"))
+			return gf_mpd_patch_insert_entries(ctx, tgt->ptl, op, gf_list_count(tgt->ptl->entries));
+		if (!strcmp(pos, "prepend"))
+			return gf_mpd_patch_insert_entries(ctx, tgt->ptl, op, 0);
+		return GF_NOT_SUPPORTED;
+
+	case MPD_PATCH_S:
+		if (op_type == MPD_PATCH_ADD) {
+			if (pos && !strcmp(pos, "before"))
+				return gf_mpd_patch_insert_entries(ctx, tgt->ptl, op, tgt->s_idx);
+			if (pos && !strcmp(pos, "after"))
+				return gf_mpd_patch_insert_entries(ctx, tgt->ptl, op, tgt->s_idx + 1);
+			return GF_NOT_SUPPORTED;
+		}
+		ent = gf_list_get(tgt->ptl->entries, tgt->s_idx);
+		gf_list_rem(tgt->ptl->entries, tgt->s_idx);
+		gf_mpd_patch_drop_entry(ctx, ent);
+		if (op_type == MPD_PATCH_REPLACE)
+			return gf_mpd_patch_insert_entries(ctx, tgt->ptl, op, tgt->s_idx);
+		return GF_OK;
+
+	default:
+		return GF_NOT_SUPPORTED;
+	}
+}
+
+static GF_Err gf_mpd_patch_op(GF_MPD_PatchCtx *ctx, GF_XMLNode *op)
+{
+	GF_Err e;
+	u32 i=0, op_type;
+	char *sel = NULL, *sel_copy;
+	const char *pos = NULL, *type = NULL;
+	GF_XMLAttribute *att;
+	GF_MPD_PatchTarget tgt;
+
+	if (!strcmp(op->name, "add")) op_type = MPD_PATCH_ADD;
+	else if (!strcmp(op->name, "replace")) op_type = MPD_PATCH_REPLACE;
+	else if (!strcmp(op->name, "remove")) op_type = MPD_PATCH_REMOVE;
+	else {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_DASH, ("[MPD] Unknown patch operation %s\n", op->name));
+		return GF_NOT_SUPPORTED;
+	}
+	while ((att = gf_list_enum(op->attributes, &i))) {
+		if (!strcmp(att->name, "sel")) sel = att->value;
+		else if (!strcmp(att->name, "pos")) pos = att->value;
+		else if (!strcmp(att->name, "type")) type = att->value;
+	}
+	if (!sel) return GF_NOT_SUPPORTED;
+
+	sel_copy = gf_strdup(sel);
+	if (!sel_copy) return GF_OUT_OF_MEM;
+	e = gf_mpd_patch_resolve(ctx, sel_copy, &tgt);
+	//adding an attribute sets its value
+	if (!e && (op_type == MPD_PATCH_ADD) && type) {
+		if ((type[0] != '@') || tgt.att) e = GF_NOT_SUPPORTED;
+		else {
+			tgt.att = type+1;
+			op_type = MPD_PATCH_REPLACE;
+		}
+	}
+	if (!e) {
+		if (tgt.att) e = gf_mpd_patch_att(ctx, &tgt, op_type, op);
+		else e = gf_mpd_patch_elt(ctx, &tgt, op_type, pos, op);
+	}
+	if (e==GF_NOT_SUPPORTED) {
+		GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[MPD] Unsupported patch operation %s on %s\n", op->name, sel));
+	}
+	gf_free(sel_copy);
+	return e;
+}
+
+GF_EXPORT
+GF_Err gf_mpd_apply_patch(const char *file, GF_MPD *mpd, u32 *nb_new_entries)
+{
+	GF_Err e;
+	u32 i=0, nb_new=0;
+	u64 publish_time=0, orig_publish_time=0;
+	const char *mpd_id = NULL;
+	GF_XMLNode *root, *op;
+	GF_XMLAttribute *att;
+	GF_DOMParser *parser;
+	GF_MPD_PatchCtx ctx;
+	GF_MPD_PatchTimeline *ptl;
+	GF_MPD_PatchStartNumber *psn;
+
+	if (nb_new_entries) *nb_new_entries = 0;
+	if (!file || !mpd) return GF_BAD_PARAM;
+
+	parser = gf_xml_dom_new();
+	if (!parser) return GF_OUT_OF_MEM;
+	e = gf_xml_dom_parse(parser, file, NULL, NULL);
+	root = e ? NULL : gf_xml_dom_get_root(parser);
+	if (!root) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[MPD] Cannot parse patch %s: %s\n", file, gf_error_to_string(e)));
+		gf_xml_dom_del(parser);
+		return e ? e : GF_NON_COMPLIANT_BITSTREAM;
+	}
+	if (strcmp(root->name, "Patch")) {
+		gf_xml_dom_del(parser);
+		return GF_NOT_SUPPORTED;
+	}
+	while ((att = gf_list_enum(root->attributes, &i))) {
+		if (!strcmp(att->name, "mpdId")) mpd_id = att->value;
+		else if (!strcmp(att->name, "originalPublishTime")) orig_publish_time = gf_mpd_parse_date(att->value);
+		else if (!strcmp(att->name, "publishTime")) publish_time = gf_mpd_parse_date(att->value);
+	}
+	if (!mpd_id || !mpd->ID || strcmp(mpd_id, mpd->ID) || !publish_time) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_DASH, ("[MPD] Patch %s does not apply to MPD %s\n", file, mpd->ID ? mpd->ID : "without ID"));
+		gf_xml_dom_del(parser);
+		return GF_NOT_SUPPORTED;
+	}
+	//patch already applied or MPD not yet updated by server
+	if (publish_time <= mpd->publishTime) {
+		gf_xml_dom_del(parser);
+		return GF_EOS;
+	}
+	if (orig_publish_time != mpd->publishTime) {
+		GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[MPD] Patch %s does not apply to current MPD version\n", file));
+		gf_xml_dom_del(parser);
+		return GF_NOT_SUPPORTED;
+	}
+
+	memset(&ctx, 0, sizeof(GF_MPD_PatchCtx));
+	ctx.mpd = mpd;
+	ctx.timelines = gf_list_new();
+	ctx.start_numbers = gf_list_new();
+	ctx.new_entries = gf_list_new();
+	ctx.removed_entries = gf_list_new();
+	ctx.publish_time = publish_time;
+	ctx.min_update_period = mpd->minimum_update_period;
+	if (!ctx.timelines || !ctx.start_numbers || !ctx.new_entries || !ctx.removed_entries)
+		e = GF_OUT_OF_MEM;
+
+	i=0;
+	while (!e && (op = gf_list_enum(root->content, &i))) {
+		if (op->type != GF_XML_NODE_TYPE) continue;
+		e = gf_mpd_patch_op(&ctx, op);
+	}
+
+	//commit
+	if (!e) {
+		i=0;
+		while ((ptl = gf_list_enum(ctx.timelines, &i))) {
+			GF_List *old_entries = ptl->tl->entries;
+			u32 j=0;
+			u64 start = 0;
+			GF_MPD_SegmentTimelineEntry *ent;
+			while ((ent = gf_list_enum(ptl->entries, &j))) {
+				nb_new += gf_mpd_timeline_entry_segments_after(ent, &start, ptl->end);
+			}
+			ptl->tl->entries = ptl->entries;
+			ptl->entries = old_entries;
+		}
+		i=0;
+		while ((psn = gf_list_enum(ctx.start_numbers, &i))) {
+			psn->seg->start_number = psn->start_number;
+		}
+		mpd->publishTime = ctx.publish_time;
+		mpd->minimum_update_period = ctx.min_update_period;
+		if (ctx.patch_location_set) {
+			if (mpd->patch_location) gf_free(mpd->patch_location);
+			mpd->patch_location = ctx.patch_location;
+			mpd->patch_location_ttl = ctx.patch_location_ttl;
+			ctx.patch_location = NULL;
+		}
+		//entries now owned by the MPD
+		gf_list_reset(ctx.new_entries);
+		gf_mpd_del_list(ctx.removed_entries, gf_mpd_segment_entry_free, 1);
+		if (nb_new_entries) *nb_new_entries = nb_new;
+	}
+
+	while ((ptl = gf_list_pop_back(ctx.timelines))) {
+		gf_list_del(ptl->entries);
+		gf_free(ptl);
+	}
+	gf_list_del(ctx.timelines);
+	while ((psn = gf_list_pop_back(ctx.start_numbers))) {
+		gf_free(psn);
+	}
+	gf_list_del(ctx.start_numbers);
+	gf_mpd_del_list(ctx.new_entries, gf_mpd_segment_entry_free, 0);
+	gf_list_del(ctx.removed_entries);
+	if (ctx.patch_location) gf_free(ctx.patch_location);
+	gf_xml_dom_del(parser);
+	return e;
+}
+
 static GF_Err gf_m3u8_fill_mpd_struct(MasterPlaylist *pl, const char *m3u8_file, const char *src_base_url, const char *mpd_file, char *title, Double update_interval,
                                       char *mimeTypeForM3U8Segments, Bool do_import, Bool use_mpd_templates, Bool use_segment_timeline, Bool is_end, u32 max_dur, GF_MPD *mpd, Bool parse_sub_playlist)
 {
@@ -2526,6 +3797,165 @@ static GFINLINE void gf_mpd_nl(FILE *out, s32 indent)
 	}
 }
 
+/*incremental serialization of manifest lists: entries are matched against the cached ones by object and state, and only
+new or modified entries are formatted. Entries purged at the head of the list are dropped from the cache*/
+static GF_MPD_SerialCache *gf_mpd_serial_start(GF_MPD_SerialCache **p_sc, const void *first_obj)
+{
+	u32 i;
+	GF_MPD_SerialCache *sc = *p_sc;
+	if (!sc) {
+		GF_SAFEALLOC(sc, GF_MPD_SerialCache);
+		if (!sc) return NULL;
+		*p_sc = sc;
+	}
+	//drop purged entries
+	for (i=sc->first; i<sc->nb_entries; i++) {
+		if (sc->entries[i].obj == first_obj) break;
+	}
+	while (sc->first < i) {
+		sc->live_size -= sc->entries[sc->first].size;
+		sc->first++;
+	}
+	//compact entries and text once half of it is stale
+	if (sc->first && (sc->first >= sc->nb_entries/2)) {
+		memmove(sc->entries, sc->entries + sc->first, sizeof(GF_MPD_SerialEntry) * (sc->nb_entries - sc->first));
+		sc->nb_entries -= sc->first;
+		sc->first = 0;
+	}
+	if (sc->buf_size > 2*sc->live_size + 4096) {
+		char *buf = gf_malloc(sc->live_size + 4096);
+		if (buf) {
+			u32 size = 0;
+			for (i=sc->first; i<sc->nb_entries; i++) {
+				memcpy(buf + size, sc->buf + sc->entries[i].offset, sc->entries[i].size);
+				sc->entries[i].offset = size;
+				size += sc->entries[i].size;
+			}
+			gf_free(sc->buf);
+			sc->buf = buf;
+			sc->buf_size = size;
+			sc->buf_alloc = sc->live_size + 4096;
+		}
+	}
+	sc->cur = sc->first;
+	sc->out_size = 0;
+	return sc;
+}
+
+static Bool gf_mpd_serial_append(char **buf, u32 *size, u32 *alloc, const char *data, u32 len)
+{
+	if (*size + len > *alloc) {
+		u32 new_alloc = MAX(2 * (*alloc), *size + len + 1024);
+		char *new_buf = gf_realloc(*buf, new_alloc);
+		if (!new_buf) return GF_FALSE;
+		*buf = new_buf;
+		*alloc = new_alloc;
+	}
+	memcpy(*buf + *size, data, len);
+	*size += len;
+	return GF_TRUE;
+}
+
+/*reuses the cached text of the object if its state is unchanged, otherwise prepares for formatting the object*/
+static Bool gf_mpd_serial_reuse(GF_MPD_SerialCache *sc, const void *obj, u64 key[4])
+{
+	sc->render_start = sc->buf_size;
+	if (sc->cur < sc->nb_entries) {
+		GF_MPD_SerialEntry *ent = &sc->entries[sc->cur];
+		if (ent->obj == obj) {
+			if (memcmp(ent->key, key, sizeof(u64)*4)) return GF_FALSE;
+			gf_mpd_serial_append(&sc->out, &sc->out_size, &sc->out_alloc, sc->buf + ent->offset, ent->size);
+			sc->cur++;
+			return GF_TRUE;
+		}
+		//list no longer matches the cache, drop remaining entries
+		while (sc->nb_entries > sc->cur) {
+			sc->nb_entries--;
+			sc->live_size -= sc->entries[sc->nb_entries].size;
+		}
+	}
+	return GF_FALSE;
+}
+
+static void gf_mpd_serial_printf(GF_MPD_SerialCache *sc, const char *fmt, ...)
+{
+	s32 len;
+	va_list vl;
+	va_start(vl, fmt);
+	len = vsnprintf(sc->buf ? sc->buf + sc->buf_size : NULL, sc->buf_alloc - sc->buf_size, fmt, vl);
+	va_end(vl);
+	if (len<0) return;
+	if (sc->buf_size + len >= sc->buf_alloc) {
+		u32 new_alloc = MAX(2 * sc->buf_alloc, sc->buf_size + len + 1024);
+		char *new_buf = gf_realloc(sc->buf, new_alloc);
+		if (!new_buf) return;
+		sc->buf = new_buf;
+		sc->buf_alloc = new_alloc;
+		va_start(vl, fmt);
+		vsnprintf(sc->buf + sc->buf_size, sc->buf_alloc - sc->buf_size, fmt, vl);
+		va_end(vl);
+	}
+	sc->buf_size += len;
+}
+
+static void gf_mpd_serial_indent(GF_MPD_SerialCache *sc, s32 indent)
+{
+	if (indent>0) gf_mpd_serial_printf(sc, "%*s", indent, "");
+}
+
+/*stores the text formatted since last call to gf_mpd_serial_reuse for the object - a NULL object is not cached*/
+static void gf_mpd_serial_store(GF_MPD_SerialCache *sc, const void *obj, u64 key[4])
+{
+	GF_MPD_SerialEntry *ent;
+	u32 size = sc->buf_size - sc->render_start;
+	gf_mpd_serial_append(&sc->out, &sc->out_size, &sc->out_alloc, sc->buf + sc->render_start, size);
+
+	if (!obj) {
+		sc->buf_size = sc->render_start;
+		while (sc->nb_entries > sc->cur) {
+			sc->nb_entries--;
+			sc->live_size -= sc->entries[sc->nb_entries].size;
+		}
+		return;
+	}
+	//modified entry
+	if ((sc->cur < sc->nb_entries) && (sc->entries[sc->cur].obj == obj)) {
+		ent = &sc->entries[sc->cur];
+		sc->live_size -= ent->size;
+	} else {
+		if (sc->nb_entries == sc->nb_alloc) {
+			u32 new_alloc = sc->nb_alloc ? 2*sc->nb_alloc : 64;
+			GF_MPD_SerialEntry *entries = gf_realloc(sc->entries, sizeof(GF_MPD_SerialEntry) * new_alloc);
+			if (!entries) {
+				sc->buf_size = sc->render_start;
+				return;
+			}
+			sc->entries = entries;
+			sc->nb_alloc = new_alloc;
+		}
+		ent = &sc->entries[sc->nb_entries];
+		sc->nb_entries++;
+	}
+	ent->obj = obj;
+	memcpy(ent->key, key, sizeof(u64)*4);
+	ent->offset = sc->render_start;
+	ent->size = size;
+	sc->live_size += size;
+	sc->cur++;
+}
+
+/*writes the serialized entries, entries after the last written one are no longer valid*/
+static void gf_mpd_serial_flush(GF_MPD_SerialCache *sc, FILE *out)
+{
+	while (sc->nb_entries > sc->cur) {
+		sc->nb_entries--;
+		sc->live_size -= sc->entries[sc->nb_entries].size;
+	}
+	if (sc->out_size)
+		gf_fwrite(sc->out, sc->out_size, out);
+	sc->out_size = 0;
+}
+
 /*time is given in ms*/
 void gf_mpd_print_date(FILE *out, char *name, u64 time)
 {
@@ -2635,26 +4065,44 @@ static void gf_mpd_print_segment_timeline(FILE *out, GF_MPD_SegmentTimeline *tl,
 	u32 i;
 	u64 start_time=0;
 	GF_MPD_SegmentTimelineEntry *se;
+	GF_MPD_SerialCache *sc;
 
 	gf_mpd_nl(out, indent);
 	gf_fprintf(out, "<SegmentTimeline>");
 	gf_mpd_lf(out, indent);
 
+	//entries are only formatted when new or modified since last write
+	sc = gf_mpd_serial_start(&tl->serial, gf_list_get(tl->entries, 0));
+	if (!sc) return;
+
 	i = 0;
 	while ( (se = gf_list_enum(tl->entries, &i))) {
-		gf_mpd_nl(out, indent+1);
-		gf_fprintf(out, "<S");
+		u64 key[4];
+		Bool write_t = GF_FALSE;
 		if (!start_time || (se->start_time != start_time)) {
-			gf_fprintf(out, " t=\""LLD"\"", se->start_time);
+			write_t = GF_TRUE;
 			start_time = se->start_time;
 		}
 		start_time += (se->repeat_count+1) * se->duration;
 
-		if (se->duration) gf_fprintf(out, " d=\"%d\"", se->duration);
-		if (se->repeat_count) gf_fprintf(out, " r=\"%d\"", se->repeat_count);
-		gf_fprintf(out, "/>");
-		gf_mpd_lf(out, indent);
+		key[0] = se->start_time;
+		key[1] = se->duration;
+		key[2] = se->repeat_count;
+		key[3] = (((u64) (u32) indent) << 1) | write_t;
+		if (gf_mpd_serial_reuse(sc, se, key))
+			continue;
+
+		gf_mpd_serial_indent(sc, indent+1);
+		gf_mpd_serial_printf(sc, "<S");
+		if (write_t) gf_mpd_serial_printf(sc, " t=\""LLD"\"", se->start_time);
+		if (se->duration) gf_mpd_serial_printf(sc, " d=\"%d\"", se->duration);
+		if (se->repeat_count) gf_mpd_serial_printf(sc, " r=\"%d\"", se->repeat_count);
+		gf_mpd_serial_printf(sc, "/>");
+		if (indent>=0) gf_mpd_serial_printf(sc, "\n");
+		gf_mpd_serial_store(sc, se, key);
 	}
+	gf_mpd_serial_flush(sc, out);
+
 	gf_mpd_nl(out, indent);
 	gf_fprintf(out, "</SegmentTimeline>");
 	gf_mpd_lf(out, indent);
@@ -3445,10 +4893,23 @@ static const char *gf_mpd_m3u8_get_init_seg(const GF_MPD_Period *period, const G
 	return url;
 }
 
+static void gf_mpd_m3u8_segment_key(const GF_DASH_SegmentContext *sctx, Bool with_parts, u64 key[4])
+{
+	key[0] = sctx->time;
+	key[1] = sctx->dur;
+	key[2] = sctx->file_offset;
+	key[3] = ((u64) sctx->file_size) << 32;
+	key[3] |= (sctx->nb_frags & 0xFFFFFF) << 8;
+	key[3] |= (sctx->llhls_mode & 0x3) << 2;
+	if (sctx->llhls_done) key[3] |= 2;
+	if (with_parts) key[3] |= 1;
+}
+
 static GF_Err gf_mpd_write_m3u8_playlist(const GF_MPD *mpd, const GF_MPD_Period *period, const GF_MPD_AdaptationSet *as, GF_MPD_Representation *rep, char *m3u8_name, u32 hls_version)
 {
 	u32 i, count;
 	GF_DASH_SegmentContext *sctx;
+	GF_MPD_SerialCache *sc;
 	FILE *out;
 	Bool close_file = GF_FALSE;
 
@@ -3486,32 +4947,48 @@ static GF_Err gf_mpd_write_m3u8_playlist(const GF_MPD *mpd, const GF_MPD_Period
 	}
 
 
+	//segment entries are only formatted when new or modified since last write
+	sc = gf_mpd_serial_start(&rep->m3u8_serial, sctx);
+	if (!sc) {
+		if (close_file) gf_fclose(out);
+		return GF_OUT_OF_MEM;
+	}
+
 	if (sctx->filename) {
 		if (rep->hls_single_file_name) {
 			gf_fprintf(out,"#EXT-X-MAP:URI=\"%s\"\n", rep->hls_single_file_name);
 		}
 		for (i=0; i<count; i++) {
 			Double dur;
+			u64 key[4];
+			Bool with_parts;
 			sctx = gf_list_get(rep->state_seg_list, i);
 			assert(sctx->filename);
 
-			if ((mpd->type == GF_MPD_TYPE_DYNAMIC) && sctx->llhls_mode) {
+			with_parts = ((mpd->type == GF_MPD_TYPE_DYNAMIC) && sctx->llhls_mode) ? GF_TRUE : GF_FALSE;
+			gf_mpd_m3u8_segment_key(sctx, with_parts, key);
+			if (gf_mpd_serial_reuse(sc, sctx, key))
+				continue;
+
+			if (with_parts) {
 				u32 k;
 				for (k=0; k<sctx->nb_frags; k++) {
 					dur = sctx->frags[k].duration;
 					dur /= rep->timescale;
-					gf_fprintf(out, "#EXT-X-PART:DURATION=%g,URI=%s", dur, sctx->filename);
+					gf_mpd_serial_printf(sc, "#EXT-X-PART:DURATION=%g,URI=%s", dur, sctx->filename);
 					if (sctx->llhls_mode==1)
-						gf_fprintf(out, ",BYTERANGE=\""LLU"@"LLU"\"", sctx->frags[k].size, sctx->frags[k].offset );
+						gf_mpd_serial_printf(sc, ",BYTERANGE=\""LLU"@"LLU"\"", sctx->frags[k].size, sctx->frags[k].offset );
 					else
-						gf_fprintf(out, ".%d", k+1);
+						gf_mpd_serial_printf(sc, ".%d", k+1);
 
 					if (sctx->frags[k].independent)
-						gf_fprintf(out, ",INDEPENDENT=YES");
-					gf_fprintf(out, "\n");
+						gf_mpd_serial_printf(sc, ",INDEPENDENT=YES");
+					gf_mpd_serial_printf(sc, "\n");
 				}
 				//live edge not done yet
 				if (! sctx->llhls_mode) {
+					gf_mpd_serial_store(sc, NULL, NULL);
+					gf_mpd_serial_flush(sc, out);
 					if (close_file)
 						gf_fclose(out);
 
@@ -3521,8 +4998,10 @@ static GF_Err gf_mpd_write_m3u8_playlist(const GF_MPD *mpd, const GF_MPD_Period
 			
 			dur = (Double) sctx->dur;
 			dur /= rep->timescale;
-			gf_fprintf(out,"#EXTINF:%g,\n", dur);
-			gf_fprintf(out,"%s\n", sctx->filename);
+			gf_mpd_serial_printf(sc, "#EXTINF:%g,\n", dur);
+			gf_mpd_serial_printf(sc, "%s\n", sctx->filename);
+			//parts of the live edge segment are still being produced, do not cache it
+			gf_mpd_serial_store(sc, (with_parts && !sctx->llhls_done) ? NULL : sctx, key);
 		}
 	} else {
 		GF_MPD_BaseURL *base_url=NULL;
@@ -3549,17 +5028,24 @@ static GF_Err gf_mpd_write_m3u8_playlist(const GF_MPD *mpd, const GF_MPD_Period
 
 		for (i=0; i<count; i++) {
 			Double dur;
+			u64 key[4];
 			sctx = gf_list_get(rep->state_seg_list, i);
 			assert(!sctx->filename);
 			assert(sctx->file_size);
 
+			gf_mpd_m3u8_segment_key(sctx, GF_FALSE, key);
+			if (gf_mpd_serial_reuse(sc, sctx, key))
+				continue;
+
 			dur = (Double) sctx->dur;
 			dur /= rep->timescale;
-			gf_fprintf(out,"#EXTINF:%g\n", dur);
-			gf_fprintf(out,"#EXT-X-BYTERANGE:%d@"LLU"\n", sctx->file_size, sctx->file_offset);
-			gf_fprintf(out,"%s\n", base_url->URL);
+			gf_mpd_serial_printf(sc, "#EXTINF:%g\n", dur);
+			gf_mpd_serial_printf(sc, "#EXT-X-BYTERANGE:%d@"LLU"\n", sctx->file_size, sctx->file_offset);
+			gf_mpd_serial_printf(sc, "%s\n", base_url->URL);
+			gf_mpd_serial_store(sc, sctx, key);
 		}
 	}
+	gf_mpd_serial_flush(sc, out);
 
 	if (mpd->type != GF_MPD_TYPE_DYNAMIC)
 		gf_fprintf(out,"\n#EXT-X-ENDLIST\n");
@@ -3571,6 +5057,7 @@ static GF_Err gf_mpd_write_m3u8_playlist(const GF_MPD *mpd, const GF_MPD_Period
 }
 
 
+GF_EXPORT
 GF_Err gf_mpd_write_m3u8_master_playlist(GF_MPD const * const mpd, FILE *out, const char* m3u8_name, GF_MPD_Period *period)
 {
 	u32 i, j, hls_version;
@@ -3880,6 +5367,15 @@ GF_Err gf_mpd_write(GF_MPD const * const mpd, FILE *out, Bool compact)
 		gf_xml_dump_string(out, "<Location>", text, "</Location>");
 		gf_mpd_lf(out, indent);
 	}
+	if (mpd->patch_location) {
+		gf_mpd_nl(out, indent+1);
+		if (mpd->patch_location_ttl)
+			gf_fprintf(out, "<PatchLocation ttl=\"%d\">", mpd->patch_location_ttl);
+		else
+			gf_fprintf(out, "<PatchLocation>");
+		gf_xml_dump_string(out, NULL, mpd->patch_location, "</PatchLocation>");
+		gf_mpd_lf(out, indent);
+	}
 
 	if (mpd->inject_service_desc) {
 		gf_mpd_nl(out, indent+1);
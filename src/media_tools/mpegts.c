@@ -150,6 +150,7 @@ static u32 gf_m2ts_reframe_reset(GF_M2TS_Demuxer *ts, GF_M2TS_PES *pes, Bool sam
 	pes->reframe = NULL;
 	pes->cc = -1;
 	pes->temi_tc_desc_len = 0;
+	ts->pid_filter_dirty = GF_TRUE;
 	return 0;
 }
 
@@ -333,6 +334,7 @@ static void gf_m2ts_metadata_descriptor_del(GF_M2TS_MetadataDescriptor *metad)
 static void gf_m2ts_es_del(GF_M2TS_ES *es, GF_M2TS_Demuxer *ts)
 {
 	gf_list_del_item(es->program->streams, es);
+	ts->pid_filter_dirty = GF_TRUE;
 
 	if (es->flags & GF_M2TS_ES_IS_SECTION) {
 		GF_M2TS_SECTION_ES *ses = (GF_M2TS_SECTION_ES *)es;
@@ -1168,6 +1170,7 @@ static void gf_m2ts_process_pmt(GF_M2TS_Demuxer *ts, GF_M2TS_SECTION_ES *pmt, GF
 	}
 
 	pmt->program->pcr_pid = ((data[0] & 0x1f) << 8) | data[1];
+	ts->pid_filter_dirty = GF_TRUE;
 
 	info_length = ((data[2]&0xf)<<8) | data[3];
 	if (info_length + 4 > data_size) {
@@ -1748,6 +1751,7 @@ static void gf_m2ts_process_pat(GF_M2TS_Demuxer *ts, GF_M2TS_SECTION_ES *ses, GF
 		return;
 	}
 	nb_progs = data_size / 4;
+	ts->pid_filter_dirty = GF_TRUE;
 
 	for (i=0; i<nb_progs; i++) {
 		u16 number, pid;
@@ -2500,6 +2504,7 @@ static GF_Err gf_m2ts_process_packet(GF_M2TS_Demuxer *ts, unsigned char *data)
 					GF_M2TS_PES *pes = (GF_M2TS_PES *) gf_list_get(program->streams, j);
 					if (pes->flags & GF_M2TS_INHERIT_PCR) {
 						ts->ess[hdr.pid] = (GF_M2TS_ES *) pes;
+						ts->pid_filter_dirty = GF_TRUE;
 						pes->flags |= GF_M2TS_FAKE_PCR;
 						break;
 					}
@@ -2629,11 +2634,134 @@ static GF_Err gf_m2ts_process_packet(GF_M2TS_Demuxer *ts, unsigned char *data)
 	return GF_OK;
 }
 
+#define M2TS_PID_FILTER_SET(_ts, _pid)	(_ts)->pid_filter[(_pid)>>5] |= 1 << ((_pid) & 31)
+#define M2TS_PID_FILTER_ON(_ts, _pid)	((_ts)->pid_filter[(_pid)>>5] & (1 << ((_pid) & 31)))
+
+/*rebuilds the bitmap of PIDs for which packets have to be parsed: PSI/SI, section streams, PES streams being reframed and PCR PIDs.
+Packets on any other PID have no effect on the demuxer state, only their TEMI descriptors are checked*/
+static void gf_m2ts_update_pid_filter(GF_M2TS_Demuxer *ts)
+{
+	u32 i, j, count;
+
+	ts->pid_filter_dirty = GF_FALSE;
+	memset(ts->pid_filter, 0, sizeof(ts->pid_filter));
+
+	M2TS_PID_FILTER_SET(ts, GF_M2TS_PID_PAT);
+	M2TS_PID_FILTER_SET(ts, GF_M2TS_PID_CAT);
+	M2TS_PID_FILTER_SET(ts, GF_M2TS_PID_NIT_ST);
+	M2TS_PID_FILTER_SET(ts, GF_M2TS_PID_SDT_BAT_ST);
+	M2TS_PID_FILTER_SET(ts, GF_M2TS_PID_EIT_ST_CIT);
+	M2TS_PID_FILTER_SET(ts, GF_M2TS_PID_TDT_TOT_ST);
+
+	for (i=0; i<GF_M2TS_MAX_STREAMS; i++) {
+		GF_M2TS_ES *es = ts->ess[i];
+		if (!es) continue;
+		if ((es->flags & GF_M2TS_ES_IS_SECTION) || ((GF_M2TS_PES *)es)->reframe)
+			M2TS_PID_FILTER_SET(ts, i);
+	}
+
+	count = gf_list_count(ts->programs);
+	for (i=0; i<count; i++) {
+		Bool active = GF_TRUE;
+		GF_M2TS_Program *prog = (GF_M2TS_Program *)gf_list_get(ts->programs, i);
+		if (prog->pcr_pid >= GF_M2TS_MAX_STREAMS) continue;
+
+		if (ts->skip_inactive_pcr) {
+			u32 nb_streams = gf_list_count(prog->streams);
+			active = GF_FALSE;
+			for (j=0; j<nb_streams; j++) {
+				GF_M2TS_PES *pes = (GF_M2TS_PES *)gf_list_get(prog->streams, j);
+				if ((pes->flags & GF_M2TS_ES_IS_PES) && pes->reframe) {
+					active = GF_TRUE;
+					break;
+				}
+			}
+		}
+		if (!active) {
+			prog->pcr_filtered = GF_TRUE;
+			continue;
+		}
+		//PCR was not processed while the program was inactive, restart PCR tracking to avoid detecting a false discontinuity
+		if (prog->pcr_filtered) {
+			prog->pcr_filtered = GF_FALSE;
+			prog->last_pcr_value = prog->last_pcr_value_pck_number = 0;
+			prog->before_last_pcr_value = prog->before_last_pcr_value_pck_number = 0;
+		}
+		M2TS_PID_FILTER_SET(ts, prog->pcr_pid);
+	}
+}
+
+/*packets on PIDs not in the PID filter are only checked for adaptation field extensions, which may carry TEMI location
+and timeline descriptors for any PID*/
+static void gf_m2ts_process_filtered_packet(GF_M2TS_Demuxer *ts, u8 *data, u32 pid)
+{
+	GF_M2TS_AdaptationField af;
+	u32 af_size;
+	u32 af_type = (data[3] >> 4) & 0x3;
+
+	//no adaptation field, or scrambled packet
+	if (!(af_type & 0x2) || (data[3] & 0xC0)) return;
+	af_size = data[4];
+	if (!af_size || (af_size>183) || ((af_type==2) && (af_size != 183))) return;
+	//no adaptation field extension
+	if (!(data[5] & 0x1)) return;
+
+	memset(&af, 0, sizeof(GF_M2TS_AdaptationField));
+	gf_m2ts_get_adaptation_field(ts, &af, data+5, af_size, pid);
+}
+
+/*processes a set of complete TS packets: packet headers are checked in batch, runs of packets on PIDs not in the PID filter are dropped
+and runs of packets on the same PID are dispatched in sequence to the packet parser*/
+static GF_Err gf_m2ts_process_packets(GF_M2TS_Demuxer *ts, u8 *data, u32 nb_pck, u32 pck_size)
+{
+	GF_Err e = GF_OK;
+	u32 i = 0;
+
+	while (i<nb_pck) {
+		u32 pid, run;
+		u8 *pck = data + i*pck_size;
+
+		//split mode forwards all packets, and corrupted packets go through the regular parser for error reporting
+		if (ts->split_mode || (pck[0] != 0x47) || (pck[1] & 0x80)) {
+			e |= gf_m2ts_process_packet(ts, pck);
+			i++;
+			continue;
+		}
+		//gather packets with same PID and no transport error
+		run = 1;
+		while (i+run < nb_pck) {
+			u8 *next = pck + run*pck_size;
+			if ((next[0] != 0x47) || ((next[1] ^ pck[1]) & 0x9F) || (next[2] != pck[2]))
+				break;
+			run++;
+		}
+
+		if (ts->pid_filter_dirty)
+			gf_m2ts_update_pid_filter(ts);
+
+		pid = ((pck[1] & 0x1f) << 8) | pck[2];
+		if (!M2TS_PID_FILTER_ON(ts, pid)) {
+			u32 j;
+			for (j=0; j<run; j++) {
+				ts->pck_number++;
+				gf_m2ts_process_filtered_packet(ts, pck + j*pck_size, pid);
+			}
+		} else {
+			u32 j;
+			for (j=0; j<run; j++) {
+				e |= gf_m2ts_process_packet(ts, pck + j*pck_size);
+			}
+		}
+		i += run;
+	}
+	return e;
+}
+
 GF_EXPORT
 GF_Err gf_m2ts_process_data(GF_M2TS_Demuxer *ts, u8 *data, u32 data_size)
 {
 	GF_Err e=GF_OK;
-	u32 pos, pck_size;
+	u32 pos, pck_size, nb_pck;
 	Bool is_align = 1;
 
 	if (ts->buffer_size) {
@@ -2702,9 +2830,10 @@ GF_Err gf_m2ts_process_data(GF_M2TS_Demuxer *ts, u8 *data, u32 data_size)
 			}
 			return e;
 		}
-		/*process*/
-		e |= gf_m2ts_process_packet(ts, (unsigned char *)data + pos);
-		pos += pck_size;
+		/*process all complete packets*/
+		nb_pck = (data_size - pos) / pck_size;
+		e |= gf_m2ts_process_packets(ts, (unsigned char *)data + pos, nb_pck, pck_size);
+		pos += nb_pck * pck_size;
 	}
 	return e;
 }
@@ -2866,6 +2995,7 @@ GF_Err gf_m2ts_set_pes_framing(GF_M2TS_PES *pes, GF_M2TSPesFraming mode)
 
 		pes->program->ts->ess[pes->pid] = (GF_M2TS_ES *) pes;
 	}
+	pes->program->ts->pid_filter_dirty = GF_TRUE;
 
 	switch (mode) {
 	case GF_M2TS_PES_FRAMING_RAW:
@@ -2927,6 +3057,7 @@ GF_M2TS_Demuxer *gf_m2ts_demux_new()
 	if (!ts) return NULL;
 	ts->programs = gf_list_new();
 	ts->SDTs = gf_list_new();
+	ts->pid_filter_dirty = GF_TRUE;
 
 	ts->pat = gf_m2ts_section_filter_new(gf_m2ts_process_pat, 0);
 	ts->cat = gf_m2ts_section_filter_new(gf_m2ts_process_cat, 0);
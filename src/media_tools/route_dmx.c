@@ -140,6 +140,11 @@ struct __gf_routedmx {
 	u32 buffer_size;
 	u8 *unz_buffer;
 	u32 unz_buffer_size;
+	//datagrams received in one call on service sockets
+	u8 *batch_buffer;
+	GF_SockDatagram dgrams[GF_SK_MAX_BATCH];
+	u32 batch;
+	u64 nb_recv_calls;
 
 	u32 reorder_timeout;
 	Bool force_reorder;
@@ -227,6 +232,7 @@ GF_EXPORT
 void gf_route_dmx_del(GF_ROUTEDmx *routedmx)
 {
 	if (routedmx->buffer) gf_free(routedmx->buffer);
+	if (routedmx->batch_buffer) gf_free(routedmx->batch_buffer);
 	if (routedmx->unz_buffer) gf_free(routedmx->unz_buffer);
 	if (routedmx->atsc_sock) gf_sk_del(routedmx->atsc_sock);
     if (routedmx->dom) gf_xml_dom_del(routedmx->dom);
@@ -314,6 +320,7 @@ static GF_ROUTEDmx *gf_route_dmx_new_internal(const char *ifce, u32 sock_buffer_
 	routedmx->bs = gf_bs_new((char*)&e, 1, GF_BITSTREAM_READ);
 
 	routedmx->reorder_timeout = 5000;
+	routedmx->batch = GF_SK_MAX_BATCH;
 
 	routedmx->on_event = on_event;
 	routedmx->udta = udta;
@@ -1462,10 +1469,10 @@ static GF_Err gf_route_dmx_process_service_signaling(GF_ROUTEDmx *routedmx, GF_R
 }
 
 
-static GF_Err gf_route_dmx_process_service(GF_ROUTEDmx *routedmx, GF_ROUTEService *s, GF_ROUTESession *route_sess)
+static GF_Err gf_route_dmx_process_lct(GF_ROUTEDmx *routedmx, GF_ROUTEService *s, u8 *data, u32 nb_read)
 {
 	GF_Err e;
-	u32 nb_read, v, C, psi, S, O, H, /*Res, A,*/ B, hdr_len, cp, cc, tsi, toi, pos;
+	u32 v, C, psi, S, O, H, /*Res, A,*/ B, hdr_len, cp, cc, tsi, toi, pos;
 	u32 /*a_G=0, a_U=0,*/ a_S=0, a_M=0/*, a_A=0, a_H=0, a_D=0*/;
 	u64 tol_size=0;
 	Bool in_order = GF_TRUE;
@@ -1473,21 +1480,7 @@ static GF_Err gf_route_dmx_process_service(GF_ROUTEDmx *routedmx, GF_ROUTEServic
 	GF_ROUTELCTChannel *rlct=NULL;
 	GF_LCTObject *gather_object=NULL;
 
-	if (route_sess) {
-		e = gf_sk_receive_no_select(route_sess->sock, routedmx->buffer, routedmx->buffer_size, &nb_read);
-	} else {
-		e = gf_sk_receive_no_select(s->sock, routedmx->buffer, routedmx->buffer_size, &nb_read);
-	}
-
-	if (e != GF_OK) return e;
-	assert(nb_read);
-
-	routedmx->nb_packets++;
-	routedmx->total_bytes_recv += nb_read;
-	routedmx->last_pck_time = gf_sys_clock_high_res();
-	if (!routedmx->first_pck_time) routedmx->first_pck_time = routedmx->last_pck_time;
-
-	e = gf_bs_reassign_buffer(routedmx->bs, routedmx->buffer, nb_read);
+	e = gf_bs_reassign_buffer(routedmx->bs, data, nb_read);
 	if (e != GF_OK) return e;
 
 	//parse LCT header
@@ -1654,7 +1647,7 @@ static GF_Err gf_route_dmx_process_service(GF_ROUTEDmx *routedmx, GF_ROUTEServic
 
 	GF_LOG(GF_LOG_DEBUG, GF_LOG_ROUTE, ("[ROUTE] Service %d : LCT packet TSI %u TOI %u size %d startOffset %u TOL "LLU"\n", s->service_id, tsi, toi, nb_read-pos, start_offset, tol_size));
 
-	e = gf_route_service_gather_object(routedmx, s, tsi, toi, start_offset, routedmx->buffer + pos, nb_read-pos, (u32) tol_size, B, in_order, rlct, &gather_object);
+	e = gf_route_service_gather_object(routedmx, s, tsi, toi, start_offset, data + pos, nb_read-pos, (u32) tol_size, B, in_order, rlct, &gather_object);
 
 	if (e==GF_EOS) {
 		if (!tsi) {
@@ -1675,6 +1668,41 @@ static GF_Err gf_route_dmx_process_service(GF_ROUTEDmx *routedmx, GF_ROUTEServic
 	return GF_OK;
 }
 
+//datagrams are at most the size of an IP packet on the broadcast link
+#define ROUTE_DGRAM_SIZE	10000
+
+static GF_Err gf_route_dmx_process_service(GF_ROUTEDmx *routedmx, GF_ROUTEService *s, GF_ROUTESession *route_sess)
+{
+	GF_Err e, lct_e = GF_OK;
+	u32 i, nb_dgrams = 0;
+
+	if (!routedmx->batch_buffer) {
+		routedmx->batch_buffer = gf_malloc(ROUTE_DGRAM_SIZE * routedmx->batch);
+		if (!routedmx->batch_buffer) return GF_OUT_OF_MEM;
+	}
+	for (i=0; i<routedmx->batch; i++) {
+		routedmx->dgrams[i].data = routedmx->batch_buffer + i*ROUTE_DGRAM_SIZE;
+		routedmx->dgrams[i].size = ROUTE_DGRAM_SIZE;
+	}
+	e = gf_sk_receive_batch(route_sess ? route_sess->sock : s->sock, routedmx->dgrams, routedmx->batch, &nb_dgrams);
+	if (e != GF_OK) return e;
+	routedmx->nb_recv_calls++;
+
+	routedmx->last_pck_time = gf_sys_clock_high_res();
+	if (!routedmx->first_pck_time) routedmx->first_pck_time = routedmx->last_pck_time;
+
+	//process all received packets, return first error
+	for (i=0; i<nb_dgrams; i++) {
+		if (!routedmx->dgrams[i].size) continue;
+		routedmx->nb_packets++;
+		routedmx->total_bytes_recv += routedmx->dgrams[i].size;
+
+		e = gf_route_dmx_process_lct(routedmx, s, routedmx->dgrams[i].data, routedmx->dgrams[i].size);
+		if (e && !lct_e) lct_e = e;
+	}
+	return lct_e;
+}
+
 static GF_Err gf_route_dmx_process_lls(GF_ROUTEDmx *routedmx)
 {
 	u32 read;
@@ -1687,6 +1715,7 @@ static GF_Err gf_route_dmx_process_lls(GF_ROUTEDmx *routedmx)
 	e = gf_sk_receive_no_select(routedmx->atsc_sock, routedmx->buffer, routedmx->buffer_size, &read);
 	if (e)
 		return e;
+	routedmx->nb_recv_calls++;
 
 	routedmx->nb_packets++;
 	routedmx->total_bytes_recv += read;
@@ -1980,6 +2009,23 @@ u64 gf_route_dmx_get_recv_bytes(GF_ROUTEDmx *routedmx)
 	return routedmx ? routedmx->total_bytes_recv : 0;
 }
 
+GF_EXPORT
+u64 gf_route_dmx_get_nb_recv_calls(GF_ROUTEDmx *routedmx)
+{
+	return routedmx ? routedmx->nb_recv_calls : 0;
+}
+
+GF_EXPORT
+void gf_route_dmx_set_batch(GF_ROUTEDmx *routedmx, u32 nb_datagrams)
+{
+	if (!routedmx) return;
+	if (!nb_datagrams) nb_datagrams = 1;
+	else if (nb_datagrams>GF_SK_MAX_BATCH) nb_datagrams = GF_SK_MAX_BATCH;
+	//buffer is allocated at first reception
+	if (routedmx->batch_buffer) return;
+	routedmx->batch = nb_datagrams;
+}
+
 GF_EXPORT
 void gf_route_dmx_debug_tsi(GF_ROUTEDmx *routedmx, u32 tsi)
 {
@@ -75,6 +75,143 @@ struct __tag_bitstream
 
 };
 
+#if defined(WIN32) && !defined(__GNUC__) && (defined(_M_X64) || defined(_M_IX86))
+# include <intrin.h>
+# define GPAC_HAS_SSE2
+#elif defined(__SSE2__)
+# include <emmintrin.h>
+# define GPAC_HAS_SSE2
+# if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#  include <immintrin.h>
+#  define GPAC_HAS_AVX2
+# endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+# include <arm_neon.h>
+# define GPAC_HAS_NEON
+#endif
+
+static GFINLINE u32 bs_ctz(u32 v)
+{
+#if defined(__GNUC__)
+	return __builtin_ctz(v);
+#elif defined(GPAC_HAS_SSE2)
+	unsigned long idx;
+	_BitScanForward(&idx, v);
+	return (u32) idx;
+#else
+	u32 idx = 0;
+	while (!(v & 1)) {
+		v >>= 1;
+		idx++;
+	}
+	return idx;
+#endif
+}
+
+//scalar version, skips up to 3 bytes per test
+static u32 bs_find_zero_pair_c(const u8 *data, u32 size, u8 max_next)
+{
+	u32 i = 2;
+	while (i < size) {
+		if (data[i] > max_next) i += 3;
+		else if (data[i-1]) i += 2;
+		else if (data[i-2]) i += 1;
+		else return i-2;
+	}
+	return size;
+}
+
+#ifdef GPAC_HAS_SSE2
+static u32 bs_find_zero_pair_sse2(const u8 *data, u32 size, u8 max_next)
+{
+	u32 i = 0;
+	__m128i zero = _mm_setzero_si128();
+	__m128i vmax = _mm_set1_epi8((char) max_next);
+	//pattern starts i to i+15 are tested on each loop
+	for (; i + 18 <= size; i += 16) {
+		__m128i v0 = _mm_loadu_si128((const __m128i *) (data + i));
+		__m128i v1 = _mm_loadu_si128((const __m128i *) (data + i + 1));
+		__m128i v2 = _mm_loadu_si128((const __m128i *) (data + i + 2));
+		__m128i m = _mm_and_si128(_mm_cmpeq_epi8(_mm_or_si128(v0, v1), zero), _mm_cmpeq_epi8(_mm_min_epu8(v2, vmax), v2));
+		u32 mask = (u32) _mm_movemask_epi8(m);
+		if (mask) return i + bs_ctz(mask);
+	}
+	return i + bs_find_zero_pair_c(data + i, size - i, max_next);
+}
+#endif
+
+#ifdef GPAC_HAS_AVX2
+__attribute__((target("avx2")))
+static u32 bs_find_zero_pair_avx2(const u8 *data, u32 size, u8 max_next)
+{
+	u32 i = 0;
+	__m256i zero = _mm256_setzero_si256();
+	__m256i vmax = _mm256_set1_epi8((char) max_next);
+	for (; i + 34 <= size; i += 32) {
+		__m256i v0 = _mm256_loadu_si256((const __m256i *) (data + i));
+		__m256i v1 = _mm256_loadu_si256((const __m256i *) (data + i + 1));
+		__m256i v2 = _mm256_loadu_si256((const __m256i *) (data + i + 2));
+		__m256i m = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_or_si256(v0, v1), zero), _mm256_cmpeq_epi8(_mm256_min_epu8(v2, vmax), v2));
+		u32 mask = (u32) _mm256_movemask_epi8(m);
+		if (mask) return i + bs_ctz(mask);
+	}
+	return i + bs_find_zero_pair_sse2(data + i, size - i, max_next);
+}
+#endif
+
+#ifdef GPAC_HAS_NEON
+static u32 bs_find_zero_pair_neon(const u8 *data, u32 size, u8 max_next)
+{
+	u32 i = 0;
+	uint8x16_t zero = vdupq_n_u8(0);
+	uint8x16_t vmax = vdupq_n_u8(max_next);
+	for (; i + 18 <= size; i += 16) {
+		uint8x16_t v0 = vld1q_u8(data + i);
+		uint8x16_t v1 = vld1q_u8(data + i + 1);
+		uint8x16_t v2 = vld1q_u8(data + i + 2);
+		uint8x16_t m = vandq_u8(vceqq_u8(vorrq_u8(v0, v1), zero), vcleq_u8(v2, vmax));
+		//narrow to 4 bits per byte
+		u64 mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(m), 4)), 0);
+		if (mask) {
+			u32 idx = 0;
+			while (!(mask & 0xF)) {
+				mask >>= 4;
+				idx++;
+			}
+			return i + idx;
+		}
+	}
+	return i + bs_find_zero_pair_c(data + i, size - i, max_next);
+}
+#endif
+
+typedef u32 (*bs_find_zero_pair_fn)(const u8 *data, u32 size, u8 max_next);
+static bs_find_zero_pair_fn bs_find_zero_pair = NULL;
+
+static void bs_select_simd(void)
+{
+	bs_find_zero_pair_fn fn = bs_find_zero_pair_c;
+#if defined(GPAC_HAS_AVX2)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) fn = bs_find_zero_pair_avx2;
+	else fn = bs_find_zero_pair_sse2;
+#elif defined(GPAC_HAS_SSE2)
+	fn = bs_find_zero_pair_sse2;
+#elif defined(GPAC_HAS_NEON)
+	fn = bs_find_zero_pair_neon;
+#endif
+	//all versions give the same result, concurrent initialization is harmless
+	bs_find_zero_pair = fn;
+}
+
+GF_EXPORT
+u32 gf_bs_find_zero_pair(const u8 *data, u32 size, u8 max_next)
+{
+	if (!data || (size<3)) return size;
+	if (!bs_find_zero_pair) bs_select_simd();
+	return bs_find_zero_pair(data, size, max_next);
+}
+
 GF_Err gf_bs_reassign_buffer(GF_BitStream *bs, const u8 *buffer, u64 BufferSize)
 {
 	if (!bs) return GF_BAD_PARAM;
@@ -1212,8 +1349,39 @@ void gf_bs_skip_bytes(GF_BitStream *bs, u64 nbBytes)
 	if (bs->bsmode == GF_BITSTREAM_READ) {
 		if (bs->remove_emul_prevention_byte) {
 			while (nbBytes) {
-				gf_bs_read_u8(bs);
-				nbBytes--;
+				u64 start, end, next;
+				if (bs->position >= bs->size) {
+					gf_bs_read_u8(bs);
+					nbBytes--;
+					continue;
+				}
+				//bytes before the next 0x000003 pattern cannot be emulation prevention bytes, skip them in one go
+				end = bs->position + nbBytes;
+				if (end > bs->size) end = bs->size;
+				start = (bs->position >= 2) ? bs->position - 2 : 0;
+				if (end - start > 0xFFFFFFFF) end = start + 0xFFFFFFFF;
+				next = start + 2 + gf_bs_find_zero_pair((u8 *) bs->original + start, (u32) (end - start), 3);
+				if (next > end) next = end;
+
+				if (next > bs->position) {
+					u64 zpos = next;
+					while ((zpos > bs->position) && !bs->original[zpos-1]) zpos--;
+					if (zpos == bs->position) bs->nb_zeros += (u32) (next - zpos);
+					else bs->nb_zeros = (u32) (next - zpos);
+					nbBytes -= next - bs->position;
+					bs->position = next;
+				}
+				//zero bytes are never removed, skip zero runs without going through regular parsing
+				while (nbBytes && (bs->position < end) && !bs->original[bs->position]) {
+					bs->position++;
+					bs->nb_zeros++;
+					nbBytes--;
+				}
+				//candidate pattern, use regular parsing
+				if (nbBytes && (bs->position < end)) {
+					gf_bs_read_u8(bs);
+					nbBytes--;
+				}
 			}
 		} else {
 			bs->position += nbBytes;
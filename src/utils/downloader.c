@@ -44,6 +44,13 @@
 
 #endif
 
+#ifdef GPAC_HAS_HTTP2
+#include <nghttp2/nghttp2.h>
+
+typedef struct __gf_h2_session GF_H2Session;
+typedef struct __gf_h2_stream GF_H2Stream;
+#endif
+
 #ifdef __USE_POSIX
 #include <unistd.h>
 #endif
@@ -202,6 +209,20 @@ struct __gf_download_session
 	Bool server_mode;
 	//0: not PUT/POST, 1: waiting for body to be completed, 2: body done
 	u32 put_state;
+
+#ifdef GPAC_HAS_HTTP2
+	//HTTP/2 connection used by this session, shared with other sessions (client only)
+	GF_H2Session *h2_sess;
+	//current HTTP/2 stream of this session
+	GF_H2Stream *h2_stream;
+	//HTTP/2 stream weight, 0 for default
+	u32 h2_weight;
+	//start of the HTTP/2 client preface received so far (server only)
+	u8 h2_preface[NGHTTP2_CLIENT_MAGIC_LEN];
+	u32 h2_preface_len;
+	//first bytes received from the client have been checked for the HTTP/2 preface
+	Bool h2_sniffed;
+#endif
 };
 
 struct __gf_download_manager
@@ -226,6 +247,10 @@ struct __gf_download_manager
 #ifdef GPAC_HAS_SSL
 	SSL_CTX *ssl_ctx;
 #endif
+#ifdef GPAC_HAS_HTTP2
+	//active HTTP/2 client connections, protected by cache_mx
+	GF_List *h2_sessions;
+#endif
 
 	GF_FilterSession *filter_session;
 
@@ -474,6 +499,16 @@ error:
 }
 
 
+#ifdef GPAC_HAS_HTTP2
+static int h2_alpn_select_cb(SSL *ssl, const unsigned char **out, unsigned char *outlen, const unsigned char *in, unsigned int inlen, void *arg)
+{
+	static const u8 alpn_protos[] = "\x02h2\x08http/1.1";
+	if (SSL_select_next_proto((unsigned char **) out, outlen, alpn_protos, sizeof(alpn_protos)-1, in, inlen) != OPENSSL_NPN_NEGOTIATED)
+		return SSL_TLSEXT_ERR_NOACK;
+	return SSL_TLSEXT_ERR_OK;
+}
+#endif
+
 void *gf_ssl_server_context_new(const char *cert, const char *key)
 {
     const SSL_METHOD *method;
@@ -498,6 +533,10 @@ void *gf_ssl_server_context_new(const char *cert, const char *key)
 		SSL_CTX_free(ctx);
 		return NULL;
 	}
+#ifdef GPAC_HAS_HTTP2
+	if (!gf_opts_get_bool("core", "no-h2"))
+		SSL_CTX_set_alpn_select_cb(ctx, h2_alpn_select_cb, NULL);
+#endif
     return ctx;
 }
 
@@ -553,6 +592,1005 @@ GF_Err gf_ssl_write(void *ssl_ctx, const u8 *buffer, u32 size)
 
 #endif /* GPAC_HAS_SSL */
 
+#ifdef GPAC_HAS_HTTP2
+
+/*HTTP/2 support
+
+Messages are translated from and to HTTP/1.1 at the stream level, so that request building, reply parsing, chunk transfer and cache handling are shared with HTTP/1.1:
+- a request (client) or response (server) written by the session is parsed and submitted as HEADERS and DATA frames
+- a response (client) or request (server) received on a stream is rebuilt as an HTTP/1.1 message, using chunk transfer when no content length is given
+
+Client sessions to the same server share a single connection, each session using one stream at a time.
+Server sessions serve the streams of a connection one after the other.
+*/
+
+//stream receive window, updated as the session consumes data
+#define GF_H2_STREAM_WINDOW		(1<<20)
+//connection receive window
+#define GF_H2_SESSION_WINDOW	(16<<20)
+//max number of bytes queued for sending on a stream before the session reports it cannot accept more data
+#define GF_H2_MAX_PENDING		(1<<20)
+
+enum
+{
+	H2_SND_HEADERS = 0,
+	H2_SND_BODY_SIZE,
+	H2_SND_BODY_CHUNKED,
+	H2_SND_BODY_EOS,
+	H2_SND_DONE
+};
+
+enum
+{
+	H2_CHUNK_SIZE = 0,
+	H2_CHUNK_DATA,
+	H2_CHUNK_DATA_END,
+	H2_CHUNK_TRAILER
+};
+
+struct __gf_h2_stream
+{
+	GF_H2Session *h2;
+	//download session using this stream, NULL once detached
+	GF_DownloadSession *sess;
+	s32 id;
+	Bool closed, reset, served, detached, is_head;
+
+	//received message, rebuilt as HTTP/1.1
+	char *status, *method, *path, *authority;
+	char *rcv_hdrs;
+	Bool rcv_hdr_done, rcv_has_size, rcv_chunked, rcv_done;
+	u8 *rcv_buf;
+	u32 rcv_size, rcv_alloc, rcv_pos;
+	//received payload bytes not yet acknowledged to the peer
+	u32 nb_unconsumed;
+
+	//message to send, parsed from HTTP/1.1
+	char *snd_hdrs;
+	u32 snd_hdrs_size;
+	u32 snd_state, chunk_state;
+	u64 snd_left;
+	char chunk_line[20];
+	u32 chunk_line_len;
+	u8 *snd_buf;
+	u32 snd_size, snd_alloc, snd_pos;
+	Bool snd_eos, snd_deferred;
+};
+
+struct __gf_h2_session
+{
+	nghttp2_session *ng_sess;
+	GF_Socket *sock;
+#ifdef GPAC_HAS_SSL
+	SSL *ssl;
+#endif
+	GF_Mutex *mx;
+	GF_List *streams;
+	char *server_name;
+	u16 port;
+	Bool use_ssl, is_server, dead;
+	//number of attached download sessions
+	u32 nb_refs;
+
+	//frame data not yet written to the socket
+	u8 *out_buf;
+	u32 out_size, out_alloc, out_pos;
+	u8 rcv_buf[GF_DOWNLOAD_BUFFER_SIZE];
+};
+
+static GF_Err h2_buf_append(u8 **buf, u32 *size, u32 *alloc, u32 *pos, const u8 *data, u32 len)
+{
+	if (*pos) {
+		if (*pos == *size) {
+			*pos = *size = 0;
+		}
+		//compact only when at least as many bytes are reclaimed as moved, otherwise grow the buffer
+		else if ((*size + len > *alloc) && (*pos >= *size - *pos)) {
+			memmove(*buf, *buf + *pos, *size - *pos);
+			*size -= *pos;
+			*pos = 0;
+		}
+	}
+	if (*size + len > *alloc) {
+		u32 new_alloc = MAX(2 * (*alloc), *size + len);
+		u8 *new_buf = gf_realloc(*buf, new_alloc);
+		if (!new_buf) return GF_OUT_OF_MEM;
+		*buf = new_buf;
+		*alloc = new_alloc;
+	}
+	memcpy(*buf + *size, data, len);
+	*size += len;
+	return GF_OK;
+}
+
+#define H2_RCV_APPEND(_st, _data, _len)	h2_buf_append(&_st->rcv_buf, &_st->rcv_size, &_st->rcv_alloc, &_st->rcv_pos, (const u8 *) (_data), (u32) (_len))
+
+static GF_H2Stream *h2_stream_new(GF_H2Session *h2, s32 id)
+{
+	GF_H2Stream *st;
+	GF_SAFEALLOC(st, GF_H2Stream);
+	if (!st) return NULL;
+	st->h2 = h2;
+	st->id = id;
+	gf_list_add(h2->streams, st);
+	return st;
+}
+
+static void h2_stream_del(GF_H2Stream *st)
+{
+	GF_H2Session *h2 = st->h2;
+	gf_list_del_item(h2->streams, st);
+	if (h2->ng_sess && (st->id>0) && !st->closed)
+		nghttp2_session_set_stream_user_data(h2->ng_sess, st->id, NULL);
+	if (st->sess) st->sess->h2_stream = NULL;
+	if (st->status) gf_free(st->status);
+	if (st->method) gf_free(st->method);
+	if (st->path) gf_free(st->path);
+	if (st->authority) gf_free(st->authority);
+	if (st->rcv_hdrs) gf_free(st->rcv_hdrs);
+	if (st->rcv_buf) gf_free(st->rcv_buf);
+	if (st->snd_hdrs) gf_free(st->snd_hdrs);
+	if (st->snd_buf) gf_free(st->snd_buf);
+	gf_free(st);
+}
+
+static void h2_sess_set_dead(GF_H2Session *h2)
+{
+	u32 i, count = gf_list_count(h2->streams);
+	h2->dead = GF_TRUE;
+	for (i=0; i<count; i++) {
+		GF_H2Stream *st = gf_list_get(h2->streams, i);
+		if (!st->rcv_done) st->reset = GF_TRUE;
+	}
+}
+
+static void h2_stream_resume(GF_H2Stream *st)
+{
+	st->snd_deferred = GF_FALSE;
+	if (st->id>0) nghttp2_session_resume_data(st->h2->ng_sess, st->id);
+}
+
+static void h2_append_header(char **hdrs, const char *name, const char *value)
+{
+	u32 i, pos = *hdrs ? (u32) strlen(*hdrs) : 0;
+	gf_dynstrcat(hdrs, name, NULL);
+	if (! *hdrs) return;
+	//restore usual header name case, e.g. content-length -> Content-Length
+	for (i=pos; (*hdrs)[i]; i++) {
+		if ((i==pos) || ((*hdrs)[i-1]=='-'))
+			(*hdrs)[i] = toupper((*hdrs)[i]);
+	}
+	gf_dynstrcat(hdrs, value, ": ");
+	gf_dynstrcat(hdrs, "\r\n", NULL);
+}
+
+static void h2_stream_rcv_headers(GF_H2Stream *st, Bool is_eos)
+{
+	char *msg = NULL;
+	if (st->h2->is_server) {
+		gf_dynstrcat(&msg, st->method ? st->method : "GET", NULL);
+		gf_dynstrcat(&msg, st->path ? st->path : "/", " ");
+		gf_dynstrcat(&msg, "HTTP/1.1\r\n", " ");
+		if (st->authority) {
+			gf_dynstrcat(&msg, "Host: ", NULL);
+			gf_dynstrcat(&msg, st->authority, NULL);
+			gf_dynstrcat(&msg, "\r\n", NULL);
+		}
+		if (st->method && !strcmp(st->method, "HEAD"))
+			st->is_head = GF_TRUE;
+		if (!is_eos && !st->rcv_has_size)
+			st->rcv_chunked = GF_TRUE;
+	} else {
+		u32 code = st->status ? atoi(st->status) : 0;
+		//interim response, wait for the final one
+		if ((code>=100) && (code<200)) {
+			if (st->status) gf_free(st->status);
+			if (st->rcv_hdrs) gf_free(st->rcv_hdrs);
+			st->status = st->rcv_hdrs = NULL;
+			st->rcv_has_size = GF_FALSE;
+			return;
+		}
+		gf_dynstrcat(&msg, "HTTP/1.1 ", NULL);
+		gf_dynstrcat(&msg, st->status ? st->status : "500", NULL);
+		gf_dynstrcat(&msg, " \r\n", NULL);
+		if (!st->rcv_has_size && (code!=204) && (code!=304)) {
+			if (is_eos) gf_dynstrcat(&msg, "Content-Length: 0\r\n", NULL);
+			else st->rcv_chunked = GF_TRUE;
+		}
+	}
+	if (st->rcv_hdrs) gf_dynstrcat(&msg, st->rcv_hdrs, NULL);
+	if (st->rcv_chunked) gf_dynstrcat(&msg, "Transfer-Encoding: chunked\r\n", NULL);
+	gf_dynstrcat(&msg, "\r\n", NULL);
+	if (msg) {
+		H2_RCV_APPEND(st, msg, strlen(msg));
+		gf_free(msg);
+	}
+	st->rcv_hdr_done = GF_TRUE;
+}
+
+static void h2_stream_rcv_end(GF_H2Stream *st)
+{
+	if (st->rcv_done) return;
+	st->rcv_done = GF_TRUE;
+	if (st->rcv_hdr_done && st->rcv_chunked)
+		H2_RCV_APPEND(st, "0\r\n\r\n", 5);
+}
+
+static int h2_on_begin_headers(nghttp2_session *ng_sess, const nghttp2_frame *frame, void *user_data)
+{
+	GF_H2Stream *st;
+	GF_H2Session *h2 = (GF_H2Session *) user_data;
+	if (!h2->is_server || (frame->hd.type != NGHTTP2_HEADERS) || (frame->headers.cat != NGHTTP2_HCAT_REQUEST))
+		return 0;
+	st = h2_stream_new(h2, frame->hd.stream_id);
+	if (!st) return NGHTTP2_ERR_CALLBACK_FAILURE;
+	nghttp2_session_set_stream_user_data(ng_sess, frame->hd.stream_id, st);
+	return 0;
+}
+
+static int h2_on_header(nghttp2_session *ng_sess, const nghttp2_frame *frame, const uint8_t *name, size_t namelen, const uint8_t *value, size_t valuelen, uint8_t flags, void *user_data)
+{
+	GF_H2Stream *st;
+	char **pseudo = NULL;
+	if (frame->hd.type != NGHTTP2_HEADERS) return 0;
+	st = nghttp2_session_get_stream_user_data(ng_sess, frame->hd.stream_id);
+	//trailers are ignored
+	if (!st || st->rcv_hdr_done) return 0;
+
+	if (name[0] == ':') {
+		if (!strcmp((char *) name, ":status")) pseudo = &st->status;
+		else if (!strcmp((char *) name, ":method")) pseudo = &st->method;
+		else if (!strcmp((char *) name, ":path")) pseudo = &st->path;
+		else if (!strcmp((char *) name, ":authority")) pseudo = &st->authority;
+		if (pseudo) {
+			if (*pseudo) gf_free(*pseudo);
+			*pseudo = gf_strdup((char *) value);
+		}
+		return 0;
+	}
+	if (!strcmp((char *) name, "content-length"))
+		st->rcv_has_size = GF_TRUE;
+	h2_append_header(&st->rcv_hdrs, (char *) name, (char *) value);
+	return 0;
+}
+
+static int h2_on_frame_recv(nghttp2_session *ng_sess, const nghttp2_frame *frame, void *user_data)
+{
+	GF_H2Stream *st;
+	if ((frame->hd.type != NGHTTP2_HEADERS) && (frame->hd.type != NGHTTP2_DATA))
+		return 0;
+	st = nghttp2_session_get_stream_user_data(ng_sess, frame->hd.stream_id);
+	if (!st) return 0;
+	if ((frame->hd.type == NGHTTP2_HEADERS) && !st->rcv_hdr_done)
+		h2_stream_rcv_headers(st, (frame->hd.flags & NGHTTP2_FLAG_END_STREAM) ? GF_TRUE : GF_FALSE);
+	if (frame->hd.flags & NGHTTP2_FLAG_END_STREAM)
+		h2_stream_rcv_end(st);
+	return 0;
+}
+
+static int h2_on_data_chunk_recv(nghttp2_session *ng_sess, uint8_t flags, int32_t stream_id, const uint8_t *data, size_t len, void *user_data)
+{
+	GF_H2Stream *st = nghttp2_session_get_stream_user_data(ng_sess, stream_id);
+	//stream no longer used, acknowledge data right away
+	if (!st || st->detached) {
+		nghttp2_session_consume(ng_sess, stream_id, len);
+		return 0;
+	}
+	if (st->rcv_chunked) {
+		char szHdr[20];
+		sprintf(szHdr, "%X\r\n", (u32) len);
+		H2_RCV_APPEND(st, szHdr, strlen(szHdr));
+		H2_RCV_APPEND(st, data, len);
+		H2_RCV_APPEND(st, "\r\n", 2);
+	} else {
+		H2_RCV_APPEND(st, data, len);
+	}
+	st->nb_unconsumed += (u32) len;
+	return 0;
+}
+
+static int h2_on_stream_close(nghttp2_session *ng_sess, int32_t stream_id, uint32_t error_code, void *user_data)
+{
+	GF_H2Stream *st = nghttp2_session_get_stream_user_data(ng_sess, stream_id);
+	if (!st) return 0;
+	st->closed = GF_TRUE;
+	if (error_code) {
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_HTTP, ("[HTTP/2] Stream %d closed: %s\n", stream_id, nghttp2_http2_strerror(error_code)));
+		if (!st->rcv_done) st->reset = GF_TRUE;
+	} else {
+		h2_stream_rcv_end(st);
+	}
+	//stream no longer used
+	if (st->detached || (st->h2->is_server && !st->served))
+		h2_stream_del(st);
+	return 0;
+}
+
+static ssize_t h2_data_source_read(nghttp2_session *ng_sess, int32_t stream_id, uint8_t *buf, size_t length, uint32_t *data_flags, nghttp2_data_source *source, void *user_data)
+{
+	u32 nb_bytes;
+	GF_H2Stream *st = (GF_H2Stream *) source->ptr;
+	if (!st) {
+		*data_flags |= NGHTTP2_DATA_FLAG_EOF;
+		return 0;
+	}
+	nb_bytes = st->snd_size - st->snd_pos;
+	if (!nb_bytes && !st->snd_eos) {
+		st->snd_deferred = GF_TRUE;
+		return NGHTTP2_ERR_DEFERRED;
+	}
+	if (nb_bytes > length) nb_bytes = (u32) length;
+	memcpy(buf, st->snd_buf + st->snd_pos, nb_bytes);
+	st->snd_pos += nb_bytes;
+	if (st->snd_pos == st->snd_size) {
+		st->snd_pos = st->snd_size = 0;
+		if (st->snd_eos)
+			*data_flags |= NGHTTP2_DATA_FLAG_EOF;
+	}
+	return nb_bytes;
+}
+
+static GF_Err h2_stream_push(GF_H2Stream *st, const u8 *data, u32 size)
+{
+	GF_Err e = h2_buf_append(&st->snd_buf, &st->snd_size, &st->snd_alloc, &st->snd_pos, data, size);
+	if (!e && st->snd_deferred) h2_stream_resume(st);
+	return e;
+}
+
+static void h2_stream_push_end(GF_H2Stream *st)
+{
+	st->snd_state = H2_SND_DONE;
+	st->snd_eos = GF_TRUE;
+	if (st->snd_deferred) h2_stream_resume(st);
+}
+
+static void h2_set_nv(nghttp2_nv *nv, const char *name, const char *value)
+{
+	nv->name = (uint8_t *) name;
+	nv->namelen = strlen(name);
+	nv->value = (uint8_t *) value;
+	nv->valuelen = strlen(value);
+	nv->flags = NGHTTP2_NV_FLAG_NONE;
+}
+
+//parse HTTP/1.1 header block and submit it
+static GF_Err h2_stream_submit(GF_H2Stream *st)
+{
+	GF_H2Session *h2 = st->h2;
+	nghttp2_nv *nva;
+	nghttp2_data_provider data_prd;
+	u32 nb_nv, nb_lines=0, code=0;
+	s64 content_length = -1;
+	Bool chunked = GF_FALSE, is_response, has_body;
+	char *line, *next, *sep;
+	char *method=NULL, *path=NULL, *status=NULL, *authority=NULL;
+	s32 res;
+
+	line = st->snd_hdrs;
+	while ((line = strchr(line, '\n'))) {
+		nb_lines++;
+		line++;
+	}
+	nva = gf_malloc(sizeof(nghttp2_nv) * (nb_lines + 4));
+	if (!nva) return GF_OUT_OF_MEM;
+
+	line = st->snd_hdrs;
+	next = strstr(line, "\r\n");
+	next[0] = 0;
+	is_response = !strncmp(line, "HTTP/", 5) ? GF_TRUE : GF_FALSE;
+	if (is_response) {
+		status = strchr(line, ' ');
+		if (status) {
+			status++;
+			sep = strchr(status, ' ');
+			if (sep) sep[0] = 0;
+			code = atoi(status);
+		}
+		nb_nv = 1;
+	} else {
+		method = line;
+		path = strchr(line, ' ');
+		if (path) {
+			path[0] = 0;
+			path++;
+			sep = strchr(path, ' ');
+			if (sep) sep[0] = 0;
+		}
+		nb_nv = 4;
+	}
+	if ((is_response && !code) || (!is_response && !path)) {
+		gf_free(nva);
+		GF_LOG(GF_LOG_ERROR, GF_LOG_HTTP, ("[HTTP/2] Invalid message start line %s\n", line));
+		return GF_NON_COMPLIANT_BITSTREAM;
+	}
+
+	line = next+2;
+	while (line[0] && (line[0] != '\r')) {
+		char *name, *value;
+		next = strstr(line, "\r\n");
+		if (!next) break;
+		next[0] = 0;
+		name = line;
+		line = next+2;
+		value = strchr(name, ':');
+		if (!value) continue;
+		value[0] = 0;
+		value++;
+		while (value[0] == ' ') value++;
+		strlwr(name);
+
+		//connection-specific headers are not allowed in HTTP/2
+		if (!strcmp(name, "transfer-encoding")) {
+			if (strstr(value, "chunked")) chunked = GF_TRUE;
+			continue;
+		}
+		if (!strcmp(name, "host")) {
+			authority = value;
+			continue;
+		}
+		if (!strcmp(name, "connection") || !strcmp(name, "keep-alive") || !strcmp(name, "proxy-connection")
+			|| !strcmp(name, "upgrade") || !strcmp(name, "te")
+		) {
+			continue;
+		}
+		if (!strcmp(name, "content-length")) {
+			u64 val;
+			if (sscanf(value, LLU, &val) == 1) content_length = (s64) val;
+		}
+		h2_set_nv(&nva[nb_nv], name, value);
+		nb_nv++;
+	}
+
+	st->snd_state = H2_SND_DONE;
+	if (is_response) {
+		h2_set_nv(&nva[0], ":status", status);
+		if (st->is_head || (code<200) || (code==204) || (code==304)) {
+			if (code<200) st->snd_state = H2_SND_HEADERS;
+		} else if (chunked) {
+			st->snd_state = H2_SND_BODY_CHUNKED;
+			st->chunk_state = H2_CHUNK_SIZE;
+		} else if (content_length>0) {
+			st->snd_state = H2_SND_BODY_SIZE;
+			st->snd_left = content_length;
+		} else if (content_length<0) {
+			//no size, body ends when the session is reset
+			st->snd_state = H2_SND_BODY_EOS;
+		}
+	} else {
+		h2_set_nv(&nva[0], ":method", method);
+		h2_set_nv(&nva[1], ":scheme", h2->use_ssl ? "https" : "http");
+		h2_set_nv(&nva[2], ":authority", authority ? authority : (h2->server_name ? h2->server_name : ""));
+		h2_set_nv(&nva[3], ":path", path);
+		if (!strcmp(method, "HEAD")) st->is_head = GF_TRUE;
+		if (chunked) {
+			st->snd_state = H2_SND_BODY_CHUNKED;
+			st->chunk_state = H2_CHUNK_SIZE;
+		} else if (content_length>0) {
+			st->snd_state = H2_SND_BODY_SIZE;
+			st->snd_left = content_length;
+		}
+	}
+	has_body = ((st->snd_state != H2_SND_DONE) && (st->snd_state != H2_SND_HEADERS)) ? GF_TRUE : GF_FALSE;
+	if (!has_body) st->snd_eos = GF_TRUE;
+
+	data_prd.source.ptr = st;
+	data_prd.read_callback = h2_data_source_read;
+	if (is_response) {
+		if (code<200)
+			res = nghttp2_submit_headers(h2->ng_sess, NGHTTP2_FLAG_NONE, st->id, NULL, nva, nb_nv, NULL);
+		else
+			res = nghttp2_submit_response(h2->ng_sess, st->id, nva, nb_nv, has_body ? &data_prd : NULL);
+	} else {
+		nghttp2_priority_spec pri_spec;
+		u32 weight = (st->sess && st->sess->h2_weight) ? st->sess->h2_weight : NGHTTP2_DEFAULT_WEIGHT;
+		nghttp2_priority_spec_init(&pri_spec, 0, weight, 0);
+		res = nghttp2_submit_request(h2->ng_sess, &pri_spec, nva, nb_nv, has_body ? &data_prd : NULL, st);
+		if (res>0) {
+			st->id = res;
+			GF_LOG(GF_LOG_DEBUG, GF_LOG_HTTP, ("[HTTP/2] Sending %s %s on stream %d weight %d\n", method, path, st->id, weight));
+		}
+	}
+	gf_free(nva);
+	if (res<0) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_HTTP, ("[HTTP/2] Failed to submit %s: %s\n", is_response ? "response" : "request", nghttp2_strerror(res)));
+		return GF_IP_NETWORK_FAILURE;
+	}
+	return GF_OK;
+}
+
+//write HTTP/1.1 message data on stream
+static GF_Err h2_stream_write(GF_H2Stream *st, const u8 *data, u32 size)
+{
+	GF_Err e;
+	u32 i, nb_bytes;
+	char c;
+
+	while (size) {
+		switch (st->snd_state) {
+		case H2_SND_HEADERS:
+		{
+			u32 hdr_end = 0;
+			u32 start = (st->snd_hdrs_size>3) ? st->snd_hdrs_size-3 : 0;
+			char *hdrs = gf_realloc(st->snd_hdrs, st->snd_hdrs_size + size + 1);
+			if (!hdrs) return GF_OUT_OF_MEM;
+			st->snd_hdrs = hdrs;
+			memcpy(st->snd_hdrs + st->snd_hdrs_size, data, size);
+			st->snd_hdrs_size += size;
+			st->snd_hdrs[st->snd_hdrs_size] = 0;
+			for (i=start; i+3<st->snd_hdrs_size; i++) {
+				if (!memcmp(st->snd_hdrs+i, "\r\n\r\n", 4)) {
+					hdr_end = i+4;
+					break;
+				}
+			}
+			if (!hdr_end) return GF_OK;
+
+			//remaining bytes are body
+			nb_bytes = st->snd_hdrs_size - hdr_end;
+			data += size - nb_bytes;
+			size = nb_bytes;
+			st->snd_hdrs[hdr_end] = 0;
+			e = h2_stream_submit(st);
+			gf_free(st->snd_hdrs);
+			st->snd_hdrs = NULL;
+			st->snd_hdrs_size = 0;
+			if (e) return e;
+		}
+			break;
+		case H2_SND_BODY_SIZE:
+			nb_bytes = size;
+			if (nb_bytes > st->snd_left) nb_bytes = (u32) st->snd_left;
+			e = h2_stream_push(st, data, nb_bytes);
+			if (e) return e;
+			data += nb_bytes;
+			size -= nb_bytes;
+			st->snd_left -= nb_bytes;
+			if (!st->snd_left) h2_stream_push_end(st);
+			break;
+		case H2_SND_BODY_EOS:
+			return h2_stream_push(st, data, size);
+		case H2_SND_BODY_CHUNKED:
+			if (st->chunk_state == H2_CHUNK_DATA) {
+				nb_bytes = size;
+				if (nb_bytes > st->snd_left) nb_bytes = (u32) st->snd_left;
+				e = h2_stream_push(st, data, nb_bytes);
+				if (e) return e;
+				data += nb_bytes;
+				size -= nb_bytes;
+				st->snd_left -= nb_bytes;
+				if (!st->snd_left) st->chunk_state = H2_CHUNK_DATA_END;
+				break;
+			}
+			c = data[0];
+			data++;
+			size--;
+			if (st->chunk_state == H2_CHUNK_DATA_END) {
+				if (c=='\n') st->chunk_state = H2_CHUNK_SIZE;
+				break;
+			}
+			//chunk size or trailer line
+			if (c != '\n') {
+				if ((c != '\r') && (st->chunk_line_len+1 < sizeof(st->chunk_line)))
+					st->chunk_line[st->chunk_line_len++] = c;
+				break;
+			}
+			st->chunk_line[st->chunk_line_len] = 0;
+			if (st->chunk_state == H2_CHUNK_TRAILER) {
+				if (!st->chunk_line_len) h2_stream_push_end(st);
+			} else {
+				u32 chunk_size = 0;
+				sscanf(st->chunk_line, "%x", &chunk_size);
+				if (chunk_size) {
+					st->snd_left = chunk_size;
+					st->chunk_state = H2_CHUNK_DATA;
+				} else {
+					st->chunk_state = H2_CHUNK_TRAILER;
+				}
+			}
+			st->chunk_line_len = 0;
+			break;
+		default:
+			GF_LOG(GF_LOG_WARNING, GF_LOG_HTTP, ("[HTTP/2] %d bytes written after end of message on stream %d, ignoring\n", size, st->id));
+			return GF_OK;
+		}
+	}
+	return GF_OK;
+}
+
+static GF_Err h2_sess_write(GF_H2Session *h2, const u8 *data, u32 size, u32 *written)
+{
+#ifdef GPAC_HAS_SSL
+	if (h2->ssl) {
+		s32 res = SSL_write(h2->ssl, data, size);
+		*written = 0;
+		if (res>0) {
+			*written = res;
+			return GF_OK;
+		}
+		res = SSL_get_error(h2->ssl, res);
+		if ((res==SSL_ERROR_WANT_WRITE) || (res==SSL_ERROR_WANT_READ))
+			return GF_IP_SOCK_WOULD_BLOCK;
+		return GF_IP_CONNECTION_CLOSED;
+	}
+#endif
+	return gf_sk_send_ex(h2->sock, data, size, written);
+}
+
+//send pending frames until the socket would block
+static GF_Err h2_sess_flush(GF_H2Session *h2)
+{
+	if (h2->dead) return GF_IP_CONNECTION_CLOSED;
+	while (1) {
+		GF_Err e;
+		u32 size, written = 0;
+		const u8 *data;
+		Bool from_queue = GF_FALSE;
+		if (h2->out_size) {
+			data = h2->out_buf + h2->out_pos;
+			size = h2->out_size - h2->out_pos;
+			from_queue = GF_TRUE;
+		} else {
+			ssize_t len = nghttp2_session_mem_send(h2->ng_sess, &data);
+			if (len<0) {
+				GF_LOG(GF_LOG_ERROR, GF_LOG_HTTP, ("[HTTP/2] Failed to prepare frames: %s\n", nghttp2_strerror((int) len)));
+				h2_sess_set_dead(h2);
+				return GF_IP_NETWORK_FAILURE;
+			}
+			if (!len) return GF_OK;
+			size = (u32) len;
+		}
+		e = h2_sess_write(h2, data, size, &written);
+		if (from_queue) {
+			h2->out_pos += written;
+			if (h2->out_pos == h2->out_size) h2->out_pos = h2->out_size = 0;
+		} else if (written < size) {
+			GF_Err e2 = h2_buf_append(&h2->out_buf, &h2->out_size, &h2->out_alloc, &h2->out_pos, data + written, size - written);
+			if (e2) {
+				h2_sess_set_dead(h2);
+				return e2;
+			}
+		}
+		if ((e==GF_IP_SOCK_WOULD_BLOCK) || (e==GF_IP_NETWORK_EMPTY))
+			return GF_OK;
+		if (e) {
+			GF_LOG(GF_LOG_INFO, GF_LOG_HTTP, ("[HTTP/2] Connection lost while sending: %s\n", gf_error_to_string(e)));
+			h2_sess_set_dead(h2);
+			return e;
+		}
+	}
+	return GF_OK;
+}
+
+//read and process all available frames
+static GF_Err h2_sess_recv(GF_H2Session *h2)
+{
+	while (!h2->dead) {
+		GF_Err e;
+		ssize_t res;
+		u32 nb_read = 0;
+#ifdef GPAC_HAS_SSL
+		if (h2->ssl) {
+			s32 size;
+			e = gf_sk_receive(h2->sock, NULL, 0, NULL);
+			if ((e==GF_IP_NETWORK_EMPTY) && !SSL_pending(h2->ssl))
+				return GF_OK;
+			size = SSL_read(h2->ssl, h2->rcv_buf, GF_DOWNLOAD_BUFFER_SIZE);
+			if (size>0) {
+				nb_read = size;
+				e = GF_OK;
+			} else {
+				size = SSL_get_error(h2->ssl, size);
+				if ((size==SSL_ERROR_WANT_READ) || (size==SSL_ERROR_WANT_WRITE))
+					return GF_OK;
+				e = GF_IP_CONNECTION_CLOSED;
+			}
+		} else
+#endif
+			e = gf_sk_receive(h2->sock, h2->rcv_buf, GF_DOWNLOAD_BUFFER_SIZE, &nb_read);
+
+		if (e==GF_IP_NETWORK_EMPTY) return GF_OK;
+		if (e) {
+			GF_LOG(GF_LOG_INFO, GF_LOG_HTTP, ("[HTTP/2] Connection closed by peer\n"));
+			h2_sess_set_dead(h2);
+			return e;
+		}
+		if (!nb_read) return GF_OK;
+
+		res = nghttp2_session_mem_recv(h2->ng_sess, h2->rcv_buf, nb_read);
+		if (res<0) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_HTTP, ("[HTTP/2] Failed to process frames: %s\n", nghttp2_strerror((int) res)));
+			h2_sess_set_dead(h2);
+			return GF_NON_COMPLIANT_BITSTREAM;
+		}
+		if (nb_read < GF_DOWNLOAD_BUFFER_SIZE) return GF_OK;
+	}
+	return GF_IP_CONNECTION_CLOSED;
+}
+
+static void h2_sess_pump(GF_H2Session *h2)
+{
+	if (h2_sess_flush(h2)) return;
+	if (h2_sess_recv(h2)) return;
+	if (h2_sess_flush(h2)) return;
+	//connection terminated (GOAWAY exchanged)
+	if (!nghttp2_session_want_read(h2->ng_sess) && !nghttp2_session_want_write(h2->ng_sess))
+		h2_sess_set_dead(h2);
+}
+
+static void h2_sess_del(GF_H2Session *h2)
+{
+	if (h2->ng_sess) {
+		if (!h2->dead) {
+			nghttp2_session_terminate_session(h2->ng_sess, NGHTTP2_NO_ERROR);
+			h2_sess_flush(h2);
+		}
+		nghttp2_session_del(h2->ng_sess);
+		h2->ng_sess = NULL;
+	}
+	while (gf_list_count(h2->streams)) {
+		h2_stream_del(gf_list_last(h2->streams));
+	}
+	gf_list_del(h2->streams);
+	if (!h2->is_server) {
+#ifdef GPAC_HAS_SSL
+		if (h2->ssl) {
+			SSL_shutdown(h2->ssl);
+			SSL_free(h2->ssl);
+		}
+#endif
+		if (h2->sock) gf_sk_del(h2->sock);
+	}
+	if (h2->server_name) gf_free(h2->server_name);
+	if (h2->out_buf) gf_free(h2->out_buf);
+	gf_mx_del(h2->mx);
+	gf_free(h2);
+}
+
+static GF_H2Session *h2_sess_new(GF_Socket *sock, void *ssl, Bool is_server)
+{
+	s32 res;
+	GF_H2Session *h2;
+	nghttp2_session_callbacks *cbks;
+	nghttp2_option *opt;
+	nghttp2_settings_entry settings[2];
+
+	GF_SAFEALLOC(h2, GF_H2Session);
+	if (!h2) return NULL;
+	h2->sock = sock;
+#ifdef GPAC_HAS_SSL
+	h2->ssl = (SSL *) ssl;
+	//frames not sent are queued and may be resent from a different location
+	if (h2->ssl) SSL_set_mode(h2->ssl, SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER | SSL_MODE_ENABLE_PARTIAL_WRITE);
+#endif
+	h2->is_server = is_server;
+	h2->streams = gf_list_new();
+	h2->mx = gf_mx_new("HTTP2");
+	if (!h2->streams || !h2->mx) {
+		h2_sess_del(h2);
+		return NULL;
+	}
+
+	if (nghttp2_session_callbacks_new(&cbks)) {
+		h2_sess_del(h2);
+		return NULL;
+	}
+	nghttp2_session_callbacks_set_on_begin_headers_callback(cbks, h2_on_begin_headers);
+	nghttp2_session_callbacks_set_on_header_callback(cbks, h2_on_header);
+	nghttp2_session_callbacks_set_on_frame_recv_callback(cbks, h2_on_frame_recv);
+	nghttp2_session_callbacks_set_on_data_chunk_recv_callback(cbks, h2_on_data_chunk_recv);
+	nghttp2_session_callbacks_set_on_stream_close_callback(cbks, h2_on_stream_close);
+
+	//window updates are sent as data is consumed by the sessions
+	nghttp2_option_new(&opt);
+	nghttp2_option_set_no_auto_window_update(opt, 1);
+	if (is_server)
+		res = nghttp2_session_server_new2(&h2->ng_sess, cbks, h2, opt);
+	else
+		res = nghttp2_session_client_new2(&h2->ng_sess, cbks, h2, opt);
+	nghttp2_option_del(opt);
+	nghttp2_session_callbacks_del(cbks);
+	if (res) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_HTTP, ("[HTTP/2] Failed to create session: %s\n", nghttp2_strerror(res)));
+		h2->ng_sess = NULL;
+		h2_sess_del(h2);
+		return NULL;
+	}
+	settings[0].settings_id = NGHTTP2_SETTINGS_MAX_CONCURRENT_STREAMS;
+	settings[0].value = 100;
+	settings[1].settings_id = NGHTTP2_SETTINGS_INITIAL_WINDOW_SIZE;
+	settings[1].value = GF_H2_STREAM_WINDOW;
+	nghttp2_submit_settings(h2->ng_sess, NGHTTP2_FLAG_NONE, settings, 2);
+	nghttp2_session_set_local_window_size(h2->ng_sess, NGHTTP2_FLAG_NONE, 0, GF_H2_SESSION_WINDOW);
+	return h2;
+}
+
+static void h2_stream_detach(GF_DownloadSession *sess)
+{
+	GF_H2Session *h2 = sess->h2_sess;
+	GF_H2Stream *st = sess->h2_stream;
+	if (!h2 || !st) return;
+
+	gf_mx_p(h2->mx);
+	sess->h2_stream = NULL;
+	st->sess = NULL;
+	st->detached = GF_TRUE;
+	if (!h2->dead && (st->id>0) && !st->closed) {
+		if (st->nb_unconsumed) {
+			nghttp2_session_consume(h2->ng_sess, st->id, st->nb_unconsumed);
+			st->nb_unconsumed = 0;
+		}
+		if (h2->is_server) {
+			//response without size ends with the session, otherwise cancel incomplete responses
+			if (st->snd_state == H2_SND_BODY_EOS)
+				h2_stream_push_end(st);
+			else if (st->snd_state != H2_SND_DONE)
+				nghttp2_submit_rst_stream(h2->ng_sess, NGHTTP2_FLAG_NONE, st->id, (st->snd_state==H2_SND_HEADERS) ? NGHTTP2_INTERNAL_ERROR : NGHTTP2_CANCEL);
+		} else if (!st->rcv_done || (st->snd_state != H2_SND_DONE)) {
+			nghttp2_submit_rst_stream(h2->ng_sess, NGHTTP2_FLAG_NONE, st->id, NGHTTP2_CANCEL);
+		}
+		h2_sess_flush(h2);
+	}
+	if (st->closed || (st->id<=0) || h2->dead)
+		h2_stream_del(st);
+	gf_mx_v(h2->mx);
+}
+
+static void h2_sess_detach(GF_DownloadSession *sess)
+{
+	Bool do_del = GF_FALSE;
+	GF_H2Session *h2 = sess->h2_sess;
+	if (!h2) return;
+
+	if (h2->is_server) {
+		gf_mx_p(h2->mx);
+		if (h2->nb_refs) h2->nb_refs--;
+		do_del = h2->nb_refs ? GF_FALSE : GF_TRUE;
+		//server sockets are owned and may already be destroyed by the caller
+		if (do_del) h2->dead = GF_TRUE;
+		gf_mx_v(h2->mx);
+	}
+	h2_stream_detach(sess);
+	sess->h2_sess = NULL;
+	if (!h2->is_server) {
+		//socket is owned by the HTTP/2 session
+		sess->sock = NULL;
+		gf_mx_p(sess->dm->cache_mx);
+		if (h2->nb_refs) h2->nb_refs--;
+		if (!h2->nb_refs) {
+			gf_list_del_item(sess->dm->h2_sessions, h2);
+			do_del = GF_TRUE;
+		}
+		gf_mx_v(sess->dm->cache_mx);
+	}
+	if (do_del) h2_sess_del(h2);
+}
+
+static GF_Err h2_sess_read(GF_DownloadSession *sess, u8 *data, u32 data_size, u32 *out_read)
+{
+	GF_Err e = GF_OK;
+	GF_H2Session *h2 = sess->h2_sess;
+	GF_H2Stream *st;
+
+	*out_read = 0;
+	gf_mx_p(h2->mx);
+	h2_sess_pump(h2);
+
+	//pick next request
+	if (h2->is_server && !sess->h2_stream) {
+		u32 i, count = gf_list_count(h2->streams);
+		for (i=0; i<count; i++) {
+			st = gf_list_get(h2->streams, i);
+			if (st->served || st->reset || !st->rcv_hdr_done) continue;
+			st->served = GF_TRUE;
+			st->sess = sess;
+			sess->h2_stream = st;
+			break;
+		}
+	}
+	st = sess->h2_stream;
+	if (!st) {
+		e = h2->dead ? GF_IP_CONNECTION_CLOSED : GF_IP_NETWORK_EMPTY;
+	} else if (st->rcv_pos == st->rcv_size) {
+		if (st->reset || (h2->dead && !st->rcv_done)) e = GF_IP_CONNECTION_CLOSED;
+		else e = GF_IP_NETWORK_EMPTY;
+	} else {
+		u32 nb_bytes = st->rcv_size - st->rcv_pos;
+		if (nb_bytes > data_size) nb_bytes = data_size;
+		memcpy(data, st->rcv_buf + st->rcv_pos, nb_bytes);
+		st->rcv_pos += nb_bytes;
+		if (st->rcv_pos == st->rcv_size) st->rcv_pos = st->rcv_size = 0;
+		*out_read = nb_bytes;
+
+		//acknowledge consumed payload so that the peer can send more
+		if (st->nb_unconsumed && !h2->dead) {
+			u32 nb_ack = MIN(nb_bytes, st->nb_unconsumed);
+			nghttp2_session_consume(h2->ng_sess, st->id, nb_ack);
+			st->nb_unconsumed -= nb_ack;
+			h2_sess_flush(h2);
+		}
+	}
+	gf_mx_v(h2->mx);
+	return e;
+}
+
+static GF_Err h2_sess_send(GF_DownloadSession *sess, const u8 *data, u32 size)
+{
+	GF_Err e;
+	GF_H2Stream *st;
+	GF_H2Session *h2 = sess->h2_sess;
+
+	gf_mx_p(h2->mx);
+	if (h2->dead) {
+		gf_mx_v(h2->mx);
+		return GF_IP_CONNECTION_CLOSED;
+	}
+	st = sess->h2_stream;
+	if (!st) {
+		if (h2->is_server) {
+			gf_mx_v(h2->mx);
+			return GF_BAD_PARAM;
+		}
+		st = h2_stream_new(h2, 0);
+		if (!st) {
+			gf_mx_v(h2->mx);
+			return GF_OUT_OF_MEM;
+		}
+		st->sess = sess;
+		sess->h2_stream = st;
+	}
+	//response canceled by client, discard
+	if (h2->is_server && st->closed) {
+		gf_mx_v(h2->mx);
+		return GF_OK;
+	}
+	//data is queued on the stream, writers check gf_dm_sess_server_can_send before sending more
+	e = h2_stream_write(st, data, size);
+	if (!e) e = h2_sess_flush(h2);
+	if (h2->dead || st->reset) e = GF_IP_CONNECTION_CLOSED;
+	gf_mx_v(h2->mx);
+	return e;
+}
+
+static GF_Err h2_sess_new_server(GF_DownloadSession *sess, const u8 *data, u32 size)
+{
+	void *ssl = NULL;
+	GF_H2Session *h2;
+#ifdef GPAC_HAS_SSL
+	ssl = sess->ssl;
+#endif
+	h2 = h2_sess_new(sess->sock, ssl, GF_TRUE);
+	if (!h2) return GF_OUT_OF_MEM;
+	h2->nb_refs = 1;
+	sess->h2_sess = h2;
+	//the server polls its sockets, do not wait for data when pumping the session
+	gf_sk_set_usec_wait(sess->sock, 0);
+	GF_LOG(GF_LOG_INFO, GF_LOG_HTTP, ("[HTTP] Client switched to HTTP/2\n"));
+
+	gf_mx_p(h2->mx);
+	if (nghttp2_session_mem_recv(h2->ng_sess, data, size) < 0)
+		h2_sess_set_dead(h2);
+	h2_sess_flush(h2);
+	gf_mx_v(h2->mx);
+	return h2->dead ? GF_IP_CONNECTION_CLOSED : GF_OK;
+}
+
+#endif /* GPAC_HAS_HTTP2 */
+
+//send data on the session connection
+static GF_Err dm_sess_write(GF_DownloadSession *sess, const u8 *buffer, u32 size)
+{
+#ifdef GPAC_HAS_HTTP2
+	if (sess->h2_sess)
+		return h2_sess_send(sess, buffer, size);
+#endif
+#ifdef GPAC_HAS_SSL
+	if (sess->ssl)
+		return gf_ssl_write(sess->ssl, buffer, size);
+#endif
+	return gf_sk_send(sess->sock, buffer, size);
+}
+
+
 
 static Bool gf_dm_is_local(GF_DownloadManager *dm, const char *url)
 {
@@ -844,6 +1882,9 @@ static void gf_dm_disconnect(GF_DownloadSession *sess, Bool force_close)
 		if (force_close && sess->use_cache_file && sess->cache_entry) {
 			gf_cache_close_write_cache(sess->cache_entry, sess, GF_FALSE);
 		}
+#ifdef GPAC_HAS_HTTP2
+		if (!sess->server_mode) h2_stream_detach(sess);
+#endif
 		return;
 	}
 	GF_LOG(GF_LOG_DEBUG, GF_LOG_CORE, ("[Downloader] gf_dm_disconnect(%p)\n", sess ));
@@ -851,6 +1892,14 @@ static void gf_dm_disconnect(GF_DownloadSession *sess, Bool force_close)
 	gf_mx_p(sess->mx);
 
 	if (!sess->server_mode) {
+#ifdef GPAC_HAS_HTTP2
+		//the stream is closed but the connection is kept for other sessions, unless lost
+		if (sess->h2_sess) {
+			h2_stream_detach(sess);
+			if (sess->h2_sess->dead || !(sess->flags & GF_NETIO_SESSION_PERSISTENT))
+				h2_sess_detach(sess);
+		} else
+#endif
 		if (force_close || !(sess->flags & GF_NETIO_SESSION_PERSISTENT)) {
 #ifdef GPAC_HAS_SSL
 			if (sess->ssl) {
@@ -888,6 +1937,9 @@ void gf_dm_sess_del(GF_DownloadSession *sess)
 		return;
 	}
 	gf_dm_disconnect(sess, GF_TRUE);
+#ifdef GPAC_HAS_HTTP2
+	h2_sess_detach(sess);
+#endif
 	gf_dm_clear_headers(sess);
 
 	/*if threaded wait for thread exit*/
@@ -1283,6 +2335,10 @@ GF_Err gf_dm_sess_setup_from_url(GF_DownloadSession *sess, const char *url, Bool
 
 	if (sess->status==GF_NETIO_STATE_ERROR)
 		socket_changed = GF_TRUE;
+#ifdef GPAC_HAS_HTTP2
+	if (sess->h2_sess && sess->h2_sess->dead)
+		socket_changed = GF_TRUE;
+#endif
 
 	if (!socket_changed && info.userName && !strcmp(info.userName, sess->creds->username)) {
 	} else {
@@ -1303,6 +2359,11 @@ GF_Err gf_dm_sess_setup_from_url(GF_DownloadSession *sess, const char *url, Bool
 		sess->num_retry = SESSION_RETRY_COUNT;
 		sess->needs_cache_reconfig = 1;
 	} else {
+#ifdef GPAC_HAS_HTTP2
+		if (sess->h2_sess) {
+			h2_sess_detach(sess);
+		} else
+#endif
 		if (sess->sock) {
 			gf_sk_del(sess->sock);
 			sess->sock = NULL;
@@ -1542,27 +2603,10 @@ GF_DownloadSession *gf_dm_sess_new(GF_DownloadManager *dm, const char *url, u32
 	return sess;
 }
 
-static GF_Err gf_dm_read_data(GF_DownloadSession *sess, char *data, u32 data_size, u32 *out_read)
+//reads data from the session socket or TLS session
+static GF_Err dm_sess_read_raw(GF_DownloadSession *sess, char *data, u32 data_size, u32 *out_read)
 {
 	GF_Err e;
-
-	if (sess->dm && sess->dm->simulate_no_connection) {
-		if (sess->sock) {
-			sess->status = GF_NETIO_DISCONNECTED;
-		}
-		return GF_IP_NETWORK_FAILURE;
-	}
-
-	if (!sess)
-		return GF_BAD_PARAM;
-
-	gf_mx_p(sess->mx);
-	if (!sess->sock) {
-		sess->status = GF_NETIO_DISCONNECTED;
-		gf_mx_v(sess->mx);
-		return GF_IP_CONNECTION_CLOSED;
-	}
-
 #ifdef GPAC_HAS_SSL
 	if (sess->ssl) {
 		s32 size;
@@ -1578,7 +2622,6 @@ static GF_Err gf_dm_read_data(GF_DownloadSession *sess, char *data, u32 data_siz
 			!SSL_has_pending(sess->ssl)
 #endif
 		) {
-			gf_mx_v(sess->mx);
 			return e;
 		}
 		size = SSL_read(sess->ssl, data, data_size);
@@ -1591,10 +2634,89 @@ static GF_Err gf_dm_read_data(GF_DownloadSession *sess, char *data, u32 data_siz
 			data[size] = 0;
 			*out_read = size;
 		}
-	} else
+		return e;
+	}
+#endif
+	return gf_sk_receive(sess->sock, data, data_size, out_read);
+}
+
+#ifdef GPAC_HAS_HTTP2
+//checks if the client starts with the HTTP/2 preface (prior knowledge or negotiated through ALPN)
+//the preface may be received over several reads, bytes matching its start are kept until the preface is complete
+static GF_Err h2_sniff_preface(GF_DownloadSession *sess, char *data, u32 data_size, u32 *out_read)
+{
+	GF_Err e;
+	u32 nb_held = sess->h2_preface_len;
+	u32 size;
+
+	if (data_size <= nb_held) return GF_BAD_PARAM;
+	memcpy(data, sess->h2_preface, nb_held);
+	e = dm_sess_read_raw(sess, data + nb_held, data_size - nb_held, out_read);
+	if (e) {
+		*out_read = 0;
+		return e;
+	}
+	size = nb_held + *out_read;
+	*out_read = 0;
+	if (!memcmp(data, NGHTTP2_CLIENT_MAGIC, MIN(size, NGHTTP2_CLIENT_MAGIC_LEN))) {
+		if (size < NGHTTP2_CLIENT_MAGIC_LEN) {
+			memcpy(sess->h2_preface, data, size);
+			sess->h2_preface_len = size;
+			return GF_IP_NETWORK_EMPTY;
+		}
+		sess->h2_sniffed = GF_TRUE;
+		sess->h2_preface_len = 0;
+		e = h2_sess_new_server(sess, (u8 *) data, size);
+		if (e) return e;
+		return h2_sess_read(sess, (u8 *) data, data_size, out_read);
+	}
+	//not HTTP/2, deliver held bytes with the data just received
+	sess->h2_sniffed = GF_TRUE;
+	sess->h2_preface_len = 0;
+	*out_read = size;
+	return GF_OK;
+}
 #endif
 
-		e = gf_sk_receive(sess->sock, data, data_size, out_read);
+static GF_Err gf_dm_read_data(GF_DownloadSession *sess, char *data, u32 data_size, u32 *out_read)
+{
+	GF_Err e;
+
+	if (sess->dm && sess->dm->simulate_no_connection) {
+		if (sess->sock) {
+			sess->status = GF_NETIO_DISCONNECTED;
+		}
+		return GF_IP_NETWORK_FAILURE;
+	}
+
+	if (!sess)
+		return GF_BAD_PARAM;
+
+	gf_mx_p(sess->mx);
+	if (!sess->sock) {
+		sess->status = GF_NETIO_DISCONNECTED;
+		gf_mx_v(sess->mx);
+		return GF_IP_CONNECTION_CLOSED;
+	}
+#ifdef GPAC_HAS_HTTP2
+	if (sess->h2_sess) {
+		e = h2_sess_read(sess, (u8 *) data, data_size, out_read);
+		gf_mx_v(sess->mx);
+		return e;
+	}
+	//first bytes received from the client, check for HTTP/2
+	if (sess->server_mode && !sess->h2_sniffed) {
+		if (gf_opts_get_bool("core", "no-h2")) {
+			sess->h2_sniffed = GF_TRUE;
+		} else {
+			e = h2_sniff_preface(sess, data, data_size, out_read);
+			gf_mx_v(sess->mx);
+			return e;
+		}
+	}
+#endif
+
+	e = dm_sess_read_raw(sess, data, data_size, out_read);
 
 	gf_mx_v(sess->mx);
 	return e;
@@ -1645,12 +2767,91 @@ static Bool rfc2818_match(const char *pattern, const char *string)
 
 #endif
 
+#ifdef GPAC_HAS_HTTP2
+static Bool h2_allowed(GF_DownloadSession *sess)
+{
+	if (!sess->dm || sess->server_mode) return GF_FALSE;
+	if (gf_opts_get_bool("core", "no-h2") || gf_opts_get_bool("core", "proxy-on")) return GF_FALSE;
+	if (sess->flags & GF_DOWNLOAD_SESSION_USE_SSL) return GF_TRUE;
+	return gf_opts_get_bool("core", "h2c");
+}
+
+//attach session to an existing HTTP/2 connection to the same server
+static Bool h2_sess_reuse(GF_DownloadSession *sess)
+{
+	u32 i, count;
+	GF_H2Session *h2 = NULL;
+	Bool use_ssl = (sess->flags & GF_DOWNLOAD_SESSION_USE_SSL) ? GF_TRUE : GF_FALSE;
+	if (!sess->server_name) return GF_FALSE;
+
+	gf_mx_p(sess->dm->cache_mx);
+	count = gf_list_count(sess->dm->h2_sessions);
+	for (i=0; i<count; i++) {
+		GF_H2Session *a_h2 = gf_list_get(sess->dm->h2_sessions, i);
+		if (a_h2->dead || (a_h2->port != sess->port) || (a_h2->use_ssl != use_ssl)) continue;
+		if (strcmp(a_h2->server_name, sess->server_name)) continue;
+		a_h2->nb_refs++;
+		h2 = a_h2;
+		break;
+	}
+	gf_mx_v(sess->dm->cache_mx);
+	if (!h2) return GF_FALSE;
+
+	sess->h2_sess = h2;
+	sess->sock = h2->sock;
+	sess->connect_time = 0;
+	sess->ssl_setup_time = 0;
+	sess->status = GF_NETIO_CONNECTED;
+	GF_LOG(GF_LOG_INFO, GF_LOG_HTTP, ("[HTTP] Reusing HTTP/2 connection to %s:%d\n", sess->server_name, sess->port));
+	gf_dm_sess_notify_state(sess, GF_NETIO_CONNECTED, GF_OK);
+	gf_dm_configure_cache(sess);
+	return GF_TRUE;
+}
+
+//move session connection to a new HTTP/2 connection
+static void h2_sess_new_client(GF_DownloadSession *sess)
+{
+	void *ssl = NULL;
+	GF_H2Session *h2;
+#ifdef GPAC_HAS_SSL
+	ssl = sess->ssl;
+#endif
+	h2 = h2_sess_new(sess->sock, ssl, GF_FALSE);
+	if (!h2) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_HTTP, ("[HTTP] Failed to setup HTTP/2, using HTTP/1.1\n"));
+		return;
+	}
+	h2->server_name = gf_strdup(sess->server_name);
+	h2->port = sess->port;
+	h2->use_ssl = (sess->flags & GF_DOWNLOAD_SESSION_USE_SSL) ? GF_TRUE : GF_FALSE;
+	h2->nb_refs = 1;
+#ifdef GPAC_HAS_SSL
+	//TLS session is now owned by the HTTP/2 connection
+	sess->ssl = NULL;
+#endif
+	sess->h2_sess = h2;
+	gf_mx_p(h2->mx);
+	h2_sess_flush(h2);
+	gf_mx_v(h2->mx);
+
+	gf_mx_p(sess->dm->cache_mx);
+	gf_list_add(sess->dm->h2_sessions, h2);
+	gf_mx_v(sess->dm->cache_mx);
+	GF_LOG(GF_LOG_INFO, GF_LOG_HTTP, ("[HTTP] Using HTTP/2 (%s) with %s:%d\n", h2->use_ssl ? "h2" : "h2c", sess->server_name, sess->port));
+}
+#endif
+
 static void gf_dm_connect(GF_DownloadSession *sess)
 {
 	GF_Err e;
 	u16 proxy_port = 0;
 	const char *proxy;
 
+#ifdef GPAC_HAS_HTTP2
+	if (!sess->sock && h2_allowed(sess) && h2_sess_reuse(sess))
+		return;
+#endif
+
 	if (!sess->sock) {
 		sess->num_retry = 40;
 		sess->sock = gf_sk_new(GF_SOCK_TYPE_TCP);
@@ -1754,6 +2955,10 @@ static void gf_dm_connect(GF_DownloadSession *sess)
 			SSL_set_fd(sess->ssl, gf_sk_get_handle(sess->sock));
 			SSL_ctrl(sess->ssl, SSL_CTRL_SET_TLSEXT_HOSTNAME, TLSEXT_NAMETYPE_host_name, (void*) proxy);
 			SSL_set_connect_state(sess->ssl);
+#ifdef GPAC_HAS_HTTP2
+			if (h2_allowed(sess))
+				SSL_set_alpn_protos(sess->ssl, (const u8 *) "\x02h2\x08http/1.1", 12);
+#endif
 			ret = SSL_connect(sess->ssl);
 			if (ret<=0) {
 				ret = SSL_get_error(sess->ssl, ret);
@@ -1858,6 +3063,24 @@ static void gf_dm_connect(GF_DownloadSession *sess)
 	}
 #endif
 
+#ifdef GPAC_HAS_HTTP2
+	if (!sess->h2_sess && (sess->status==GF_NETIO_CONNECTED) && h2_allowed(sess)) {
+		Bool use_h2 = GF_FALSE;
+#ifdef GPAC_HAS_SSL
+		if (sess->ssl) {
+			const u8 *alpn = NULL;
+			u32 alpn_len = 0;
+			SSL_get0_alpn_selected(sess->ssl, &alpn, &alpn_len);
+			if ((alpn_len==2) && !memcmp(alpn, "h2", 2)) use_h2 = GF_TRUE;
+		} else
+#endif
+		if (!(sess->flags & GF_DOWNLOAD_SESSION_USE_SSL))
+			use_h2 = GF_TRUE;
+
+		if (use_h2) h2_sess_new_client(sess);
+	}
+#endif
+
 	/*this should be done when building HTTP GET request in case we have range directives*/
 	gf_dm_configure_cache(sess);
 
@@ -2142,6 +3365,9 @@ GF_DownloadManager *gf_dm_new(GF_FilterSession *fsess)
 		return NULL;
 	}
 	dm->sessions = gf_list_new();
+#ifdef GPAC_HAS_HTTP2
+	dm->h2_sessions = gf_list_new();
+#endif
 	dm->cache_entries = gf_list_new();
 	dm->credentials = gf_list_new();
 	dm->skip_proxy_servers = gf_list_new();
@@ -2265,6 +3491,15 @@ void gf_dm_del(GF_DownloadManager *dm)
 	}
 	gf_list_del(dm->sessions);
 	dm->sessions = NULL;
+#ifdef GPAC_HAS_HTTP2
+	//connections still referenced by sessions not created through the manager
+	while (gf_list_count(dm->h2_sessions)) {
+		GF_H2Session *h2 = gf_list_pop_back(dm->h2_sessions);
+		h2_sess_del(h2);
+	}
+	gf_list_del(dm->h2_sessions);
+	dm->h2_sessions = NULL;
+#endif
 	assert( dm->skip_proxy_servers );
 	while (gf_list_count(dm->skip_proxy_servers)) {
 		char *serv = (char*)gf_list_get(dm->skip_proxy_servers, 0);
@@ -2858,6 +4093,40 @@ Bool gf_dm_sess_can_be_cached_on_disk(const GF_DownloadSession *sess)
 }
 #endif
 
+GF_EXPORT
+GF_Err gf_dm_sess_set_priority(GF_DownloadSession *sess, u32 weight)
+{
+	if (!sess) return GF_BAD_PARAM;
+#ifdef GPAC_HAS_HTTP2
+	if (weight>256) weight = 256;
+	sess->h2_weight = weight;
+	if (sess->h2_sess && sess->h2_stream) {
+		GF_H2Session *h2 = sess->h2_sess;
+		gf_mx_p(h2->mx);
+		//update weight of the running request
+		if (!h2->dead && sess->h2_stream && (sess->h2_stream->id>0) && !sess->h2_stream->closed) {
+			nghttp2_priority_spec pri_spec;
+			nghttp2_priority_spec_init(&pri_spec, 0, weight ? weight : NGHTTP2_DEFAULT_WEIGHT, 0);
+			nghttp2_submit_priority(h2->ng_sess, NGHTTP2_FLAG_NONE, sess->h2_stream->id, &pri_spec);
+			h2_sess_flush(h2);
+		}
+		gf_mx_v(h2->mx);
+	}
+	return GF_OK;
+#else
+	return GF_NOT_SUPPORTED;
+#endif
+}
+
+GF_EXPORT
+Bool gf_dm_sess_is_h2(GF_DownloadSession *sess)
+{
+#ifdef GPAC_HAS_HTTP2
+	if (sess && sess->h2_sess) return GF_TRUE;
+#endif
+	return GF_FALSE;
+}
+
 GF_EXPORT
 void gf_dm_sess_abort(GF_DownloadSession * sess)
 {
@@ -3120,12 +4389,7 @@ static GF_Err http_send_headers(GF_DownloadSession *sess, char * sHTTP) {
 		sess->request_start_time = gf_sys_clock_high_res();
 		sess->req_hdr_size = len+par.size;
 
-#ifdef GPAC_HAS_SSL
-		if (sess->ssl) {
-			e = gf_ssl_write(sess->ssl, tmp_buf, len+par.size);
-		} else
-#endif
-			e = gf_sk_send(sess->sock, tmp_buf, len+par.size);
+		e = dm_sess_write(sess, (u8 *) tmp_buf, len+par.size);
 
 		GF_LOG(GF_LOG_INFO, GF_LOG_HTTP, ("[HTTP] Sending request at UTC "LLD" %s\n\n", gf_net_get_utc(), tmp_buf));
 		gf_free(tmp_buf);
@@ -3135,12 +4399,7 @@ static GF_Err http_send_headers(GF_DownloadSession *sess, char * sHTTP) {
 		sess->request_start_time = gf_sys_clock_high_res();
 		sess->req_hdr_size = len;
 
-#ifdef GPAC_HAS_SSL
-		if (sess->ssl) {
-			e = gf_ssl_write(sess->ssl, sHTTP, len);
-		} else
-#endif
-			e = gf_sk_send(sess->sock, sHTTP, len);
+		e = dm_sess_write(sess, (u8 *) sHTTP, len);
 
 #ifndef GPAC_DISABLE_LOG
 		if (e) {
@@ -3340,6 +4599,13 @@ static GF_Err wait_for_header_and_parse(GF_DownloadSession *sess, char * sHTTP)
 		switch (e) {
 		case GF_IP_NETWORK_EMPTY:
 			if (!bytesRead) {
+#ifdef GPAC_HAS_HTTP2
+				//idle HTTP/2 connection or partial HTTP/2 preface, wait for next stream or end of preface
+				if (sess->server_mode && (sess->h2_sess || sess->h2_preface_len)) {
+					sess->last_error = GF_IP_NETWORK_EMPTY;
+					return GF_OK;
+				}
+#endif
 				e = gf_sk_probe(sess->sock);
 				if ((e==GF_IP_CONNECTION_CLOSED) || (gf_sys_clock_high_res() - sess->request_start_time > 1000 * sess->request_timeout)
 				) {
@@ -3656,6 +4922,7 @@ static GF_Err wait_for_header_and_parse(GF_DownloadSession *sess, char * sHTTP)
 			gf_dm_data_received(sess, (u8 *) sHTTP + BodyStart, bytesRead - BodyStart, GF_TRUE, NULL, NULL);
 		}
 		par.reply = method;
+		sess->last_error = GF_OK;
 		gf_dm_sess_user_io(sess, &par);
 		sess->status = GF_NETIO_DATA_TRANSFERED;
 		return GF_OK;
@@ -4587,12 +5854,7 @@ GF_Err gf_dm_sess_send(GF_DownloadSession *sess, u8 *data, u32 size)
 		return GF_BAD_PARAM;
 	}
 
-#ifdef GPAC_HAS_SSL
-	if (sess->ssl) {
-		e = gf_ssl_write(sess->ssl, data, size);
-	} else
-#endif
-		e = gf_sk_send(sess->sock, data, size);
+	e = dm_sess_write(sess, data, size);
 
 	if (e==GF_IP_CONNECTION_CLOSED) {
 		sess->status = GF_NETIO_STATE_ERROR;
@@ -4604,4 +5866,121 @@ GF_Err gf_dm_sess_send(GF_DownloadSession *sess, u8 *data, u32 size)
 	return e;
 }
 
+//resets a server session once a response is sent, used for HTTP/2 where the session must be kept for the connection lifetime
+GF_EXPORT
+GF_Err gf_dm_sess_server_reset(GF_DownloadSession *sess)
+{
+	if (!sess || !sess->server_mode) return GF_BAD_PARAM;
+#ifdef GPAC_HAS_HTTP2
+	h2_stream_detach(sess);
+#endif
+	gf_dm_clear_headers(sess);
+	sess->status = GF_NETIO_CONNECTED;
+	sess->last_error = GF_OK;
+	sess->total_size = sess->bytes_done = 0;
+	sess->chunked = GF_FALSE;
+	sess->last_chunk_found = GF_FALSE;
+	sess->nb_left_in_chunk = sess->current_chunk_size = 0;
+	sess->remaining_data_size = 0;
+	sess->connection_close = GF_FALSE;
+	sess->put_state = 0;
+	if (sess->init_data) gf_free(sess->init_data);
+	sess->init_data = NULL;
+	sess->init_data_size = 0;
+	return GF_OK;
+}
+
+//checks if a server session has pending requests or data to send
+GF_EXPORT
+Bool gf_dm_sess_server_has_pending(GF_DownloadSession *sess)
+{
+	Bool res = GF_FALSE;
+#ifdef GPAC_HAS_HTTP2
+	u32 i, count;
+	GF_H2Session *h2 = sess ? sess->h2_sess : NULL;
+	if (!h2 || h2->dead) return GF_FALSE;
+	gf_mx_p(h2->mx);
+	if (h2->out_size || nghttp2_session_want_write(h2->ng_sess))
+		res = GF_TRUE;
+	count = gf_list_count(h2->streams);
+	for (i=0; !res && (i<count); i++) {
+		GF_H2Stream *st = gf_list_get(h2->streams, i);
+		if (!st->served && !st->reset && st->rcv_hdr_done) res = GF_TRUE;
+	}
+	gf_mx_v(h2->mx);
+#endif
+	return res;
+}
+
+//checks if a server session can accept more data for its response
+//for HTTP/2, data is queued on the stream and the caller must wait until the peer consumed enough of it
+GF_EXPORT
+Bool gf_dm_sess_server_can_send(GF_DownloadSession *sess)
+{
+	Bool res = GF_TRUE;
+#ifdef GPAC_HAS_HTTP2
+	GF_H2Stream *st;
+	GF_H2Session *h2 = sess ? sess->h2_sess : NULL;
+	if (!h2 || h2->dead) return GF_TRUE;
+	gf_mx_p(h2->mx);
+	st = sess->h2_stream;
+	if (st && (st->snd_size - st->snd_pos > GF_H2_MAX_PENDING)) {
+		//process window updates from the peer
+		h2_sess_pump(h2);
+		if (!h2->dead && !st->closed && (st->snd_size - st->snd_pos > GF_H2_MAX_PENDING))
+			res = GF_FALSE;
+	}
+	gf_mx_v(h2->mx);
+#endif
+	return res;
+}
+
+//creates a server session for the next pending request of an HTTP/2 connection, so that responses are sent concurrently
+//returns NULL and sets e to GF_IP_NETWORK_EMPTY if no request is pending
+GF_EXPORT
+GF_DownloadSession *gf_dm_sess_server_new_stream(GF_DownloadSession *sess, gf_dm_user_io user_io, void *usr_cbk, GF_Err *e)
+{
+#ifdef GPAC_HAS_HTTP2
+	u32 i, count;
+	GF_H2Stream *st = NULL;
+	GF_DownloadSession *st_sess;
+	GF_H2Session *h2 = sess ? sess->h2_sess : NULL;
+
+	if (!h2 || !h2->is_server) {
+		*e = GF_BAD_PARAM;
+		return NULL;
+	}
+	gf_mx_p(h2->mx);
+	count = h2->dead ? 0 : gf_list_count(h2->streams);
+	for (i=0; i<count; i++) {
+		st = gf_list_get(h2->streams, i);
+		if (!st->served && !st->reset && st->rcv_hdr_done) break;
+		st = NULL;
+	}
+	if (!st) {
+		gf_mx_v(h2->mx);
+		*e = GF_IP_NETWORK_EMPTY;
+		return NULL;
+	}
+	st_sess = gf_dm_sess_new_server(sess->sock, NULL, user_io, usr_cbk, e);
+	if (!st_sess) {
+		gf_mx_v(h2->mx);
+		return NULL;
+	}
+#ifdef GPAC_HAS_SSL
+	st_sess->ssl = sess->ssl;
+#endif
+	st->served = GF_TRUE;
+	st->sess = st_sess;
+	st_sess->h2_stream = st;
+	st_sess->h2_sess = h2;
+	h2->nb_refs++;
+	gf_mx_v(h2->mx);
+	return st_sess;
+#else
+	*e = GF_NOT_SUPPORTED;
+	return NULL;
+#endif
+}
+
 #endif
@@ -377,6 +377,46 @@ error:
 	return e;
 }
 
+GF_EXPORT
+GF_Err gf_file_replace(const char *fileName, const char *newFileName)
+{
+	GF_Err e = GF_OK;
+	if (!fileName || !newFileName) return GF_BAD_PARAM;
+#if defined(_WIN32_WCE)
+	TCHAR swzName[MAX_PATH];
+	TCHAR swzNewName[MAX_PATH];
+	CE_CharToWide((char*)fileName, swzName);
+	CE_CharToWide((char*)newFileName, swzNewName);
+	//no MoveFileEx on CE, destination is removed first
+	DeleteFile(swzNewName);
+	if (MoveFile(swzName, swzNewName) == 0)
+		e = GF_IO_ERR;
+#elif defined(WIN32)
+	BOOL op_result;
+	wchar_t* wcsFileName = gf_utf8_to_wcs(fileName);
+	wchar_t* wcsNewFileName = gf_utf8_to_wcs(newFileName);
+	if (!wcsFileName || !wcsNewFileName) {
+		e = GF_IO_ERR;
+	} else {
+		/* success if != 0 */
+		op_result = MoveFileExW(wcsFileName, wcsNewFileName, MOVEFILE_REPLACE_EXISTING);
+		if (op_result == 0)
+			e = GF_IO_ERR;
+	}
+	if (wcsFileName) gf_free(wcsFileName);
+	if (wcsNewFileName) gf_free(wcsNewFileName);
+#else
+	/* success is == 0, destination is atomically replaced */
+	if (rename(fileName, newFileName) != 0)
+		e = GF_IO_ERR;
+#endif
+
+	if (e) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_CORE, ("[core] Failed to replace file %s with %s: %s\n", newFileName, fileName, gf_error_to_string(e) ));
+	}
+	return e;
+}
+
 GF_EXPORT
 u64 gf_file_modification_time(const char *filename)
 {
@@ -1568,6 +1608,549 @@ u64 gf_fsize(FILE *fp)
 	return size;
 }
 
+#if defined(GPAC_CONFIG_LINUX) && !defined(GPAC_CONFIG_ANDROID) && !defined(GPAC_DISABLE_URING) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define GPAC_HAS_URING
+#endif
+#endif
+
+#ifdef GPAC_HAS_URING
+
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+
+//alignment of buffers, offsets and sizes for direct I/O
+#define AIO_ALIGN	4096
+
+enum
+{
+	AIO_BLOCK_FREE=0,
+	AIO_BLOCK_PENDING,
+	AIO_BLOCK_READY,
+};
+
+typedef struct
+{
+	u8 *data;
+	u64 offset;
+	//bytes to write, or bytes read once ready
+	u32 size;
+	u32 state;
+	Bool direct;
+} GF_AIOBlock;
+
+typedef struct
+{
+	//io_uring
+	int ring_fd;
+	u8 *sq_ring, *cq_ring;
+	size_t sq_ring_size, cq_ring_size, sqes_size;
+	u32 *sq_head, *sq_tail, *sq_mask, *sq_array;
+	u32 *cq_head, *cq_tail, *cq_mask;
+	struct io_uring_sqe *sqes;
+	struct io_uring_cqe *cqes;
+	//SQEs queued but not yet submitted, SQEs submitted and not yet completed
+	u32 nb_queued, nb_pending;
+
+	GF_FileIO *gfio;
+	int fd, fd_direct;
+	Bool is_write, has_error, no_direct;
+	u32 block_size, nb_blocks;
+	GF_AIOBlock *blocks;
+	u64 pos, file_size;
+	//read mode: offset of next block to read ahead
+	u64 ra_offset;
+	//write mode: block being filled, -1 if none
+	s32 cur_block;
+} GF_AIOFile;
+
+static Bool aio_ring_init(GF_AIOFile *af, u32 nb_entries)
+{
+	struct io_uring_params p;
+	memset(&p, 0, sizeof(p));
+	af->ring_fd = (int) syscall(__NR_io_uring_setup, nb_entries, &p);
+	if (af->ring_fd < 0) return GF_FALSE;
+
+	af->sq_ring_size = p.sq_off.array + p.sq_entries * sizeof(u32);
+	af->cq_ring_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+	if (p.features & IORING_FEAT_SINGLE_MMAP) {
+		if (af->cq_ring_size > af->sq_ring_size) af->sq_ring_size = af->cq_ring_size;
+		af->cq_ring_size = af->sq_ring_size;
+	}
+	af->sq_ring = mmap(NULL, af->sq_ring_size, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, af->ring_fd, IORING_OFF_SQ_RING);
+	if (af->sq_ring == MAP_FAILED) {
+		af->sq_ring = NULL;
+		return GF_FALSE;
+	}
+	if (p.features & IORING_FEAT_SINGLE_MMAP) {
+		af->cq_ring = af->sq_ring;
+	} else {
+		af->cq_ring = mmap(NULL, af->cq_ring_size, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, af->ring_fd, IORING_OFF_CQ_RING);
+		if (af->cq_ring == MAP_FAILED) {
+			af->cq_ring = NULL;
+			return GF_FALSE;
+		}
+	}
+	af->sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+	af->sqes = mmap(NULL, af->sqes_size, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, af->ring_fd, IORING_OFF_SQES);
+	if (af->sqes == MAP_FAILED) {
+		af->sqes = NULL;
+		return GF_FALSE;
+	}
+	af->sq_head = (u32 *) (af->sq_ring + p.sq_off.head);
+	af->sq_tail = (u32 *) (af->sq_ring + p.sq_off.tail);
+	af->sq_mask = (u32 *) (af->sq_ring + p.sq_off.ring_mask);
+	af->sq_array = (u32 *) (af->sq_ring + p.sq_off.array);
+	af->cq_head = (u32 *) (af->cq_ring + p.cq_off.head);
+	af->cq_tail = (u32 *) (af->cq_ring + p.cq_off.tail);
+	af->cq_mask = (u32 *) (af->cq_ring + p.cq_off.ring_mask);
+	af->cqes = (struct io_uring_cqe *) (af->cq_ring + p.cq_off.cqes);
+	return GF_TRUE;
+}
+
+static void aio_del(GF_AIOFile *af)
+{
+	u32 i;
+	if (af->sqes) munmap(af->sqes, af->sqes_size);
+	if (af->cq_ring && (af->cq_ring != af->sq_ring)) munmap(af->cq_ring, af->cq_ring_size);
+	if (af->sq_ring) munmap(af->sq_ring, af->sq_ring_size);
+	if (af->ring_fd>=0) close(af->ring_fd);
+	if (af->fd_direct>=0) close(af->fd_direct);
+	if (af->fd>=0) close(af->fd);
+	if (af->blocks) {
+		//allocated with posix_memalign
+		for (i=0; i<af->nb_blocks; i++) {
+			if (af->blocks[i].data) free(af->blocks[i].data);
+		}
+		gf_free(af->blocks);
+	}
+	if (af->gfio) gf_fileio_del(af->gfio);
+	gf_free(af);
+}
+
+//submits queued SQEs and waits for min_complete completions
+static Bool aio_enter(GF_AIOFile *af, u32 min_complete)
+{
+	int res;
+	do {
+		res = (int) syscall(__NR_io_uring_enter, af->ring_fd, af->nb_queued, min_complete, min_complete ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+	} while ((res<0) && (errno==EINTR));
+
+	if (res<0) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_CORE, ("[AIO] io_uring_enter failed: %s\n", strerror(errno)));
+		af->has_error = GF_TRUE;
+		return GF_FALSE;
+	}
+	af->nb_queued -= MIN((u32) res, af->nb_queued);
+	return GF_TRUE;
+}
+
+static void aio_queue(GF_AIOFile *af, u32 block_idx)
+{
+	GF_AIOBlock *b = &af->blocks[block_idx];
+	u32 tail = *af->sq_tail;
+	u32 idx = tail & *af->sq_mask;
+	struct io_uring_sqe *sqe = &af->sqes[idx];
+
+	memset(sqe, 0, sizeof(struct io_uring_sqe));
+	sqe->opcode = af->is_write ? IORING_OP_WRITE : IORING_OP_READ;
+	sqe->fd = b->direct ? af->fd_direct : af->fd;
+	sqe->off = b->offset;
+	sqe->addr = (u64) (uintptr_t) b->data;
+	sqe->len = af->is_write ? b->size : af->block_size;
+	sqe->user_data = block_idx;
+	af->sq_array[idx] = idx;
+	__atomic_store_n(af->sq_tail, tail+1, __ATOMIC_RELEASE);
+
+	b->state = AIO_BLOCK_PENDING;
+	af->nb_queued++;
+	af->nb_pending++;
+}
+
+static void aio_complete(GF_AIOFile *af, u32 block_idx, s32 res)
+{
+	GF_AIOBlock *b;
+	if (block_idx >= af->nb_blocks) return;
+	b = &af->blocks[block_idx];
+	if (b->state != AIO_BLOCK_PENDING) return;
+	af->nb_pending--;
+
+	if (!af->is_write) {
+		//failed (old kernel without IORING_OP_READ or I/O error), read synchronously
+		if (res<0) {
+			do {
+				res = (s32) pread(af->fd, b->data, af->block_size, b->offset);
+			} while ((res<0) && (errno==EINTR));
+			if (res<0) {
+				GF_LOG(GF_LOG_ERROR, GF_LOG_CORE, ("[AIO] Failed to read %u bytes at "LLU": %s\n", af->block_size, b->offset, strerror(errno)));
+				af->has_error = GF_TRUE;
+				res = 0;
+			}
+		}
+		b->size = (u32) res;
+		b->state = AIO_BLOCK_READY;
+		return;
+	}
+
+	if (res != (s32) b->size) {
+		u32 done = (res>0) ? (u32) res : 0;
+		if (b->direct && (res == -EINVAL)) {
+			GF_LOG(GF_LOG_INFO, GF_LOG_CORE, ("[AIO] Direct I/O not supported for this file, using buffered writes\n"));
+			af->no_direct = GF_TRUE;
+		}
+		//short or failed write, write remaining bytes synchronously
+		while (done < b->size) {
+			ssize_t w = pwrite(af->fd, b->data + done, b->size - done, b->offset + done);
+			if ((w<0) && (errno==EINTR)) continue;
+			if (w<=0) {
+				GF_LOG(GF_LOG_ERROR, GF_LOG_CORE, ("[AIO] Failed to write %u bytes at "LLU": %s\n", b->size - done, b->offset + done, strerror(errno)));
+				af->has_error = GF_TRUE;
+				break;
+			}
+			done += (u32) w;
+		}
+	}
+	b->state = AIO_BLOCK_FREE;
+}
+
+//submits queued requests and processes completions, waiting for at least min_complete of them
+static Bool aio_reap(GF_AIOFile *af, u32 min_complete)
+{
+	if (min_complete || af->nb_queued) {
+		if (!aio_enter(af, min_complete)) return GF_FALSE;
+	}
+	while (1) {
+		struct io_uring_cqe *cqe;
+		u32 head = *af->cq_head;
+		if (head == __atomic_load_n(af->cq_tail, __ATOMIC_ACQUIRE)) break;
+		cqe = &af->cqes[head & *af->cq_mask];
+		aio_complete(af, (u32) cqe->user_data, cqe->res);
+		__atomic_store_n(af->cq_head, head+1, __ATOMIC_RELEASE);
+	}
+	return GF_TRUE;
+}
+
+static void aio_wait_all(GF_AIOFile *af)
+{
+	while (af->nb_pending) {
+		if (!aio_reap(af, 1)) break;
+	}
+}
+
+static void aio_submit_write(GF_AIOFile *af, Bool force)
+{
+	if (af->cur_block>=0) {
+		GF_AIOBlock *b = &af->blocks[af->cur_block];
+		af->cur_block = -1;
+		if (b->size) {
+			//only full aligned blocks go through direct I/O
+			b->direct = ((af->fd_direct>=0) && !af->no_direct && (b->size==af->block_size) && !(b->offset % AIO_ALIGN)) ? GF_TRUE : GF_FALSE;
+			aio_queue(af, (u32) (b - af->blocks));
+		}
+	}
+	//batch submissions
+	if (af->nb_queued && (force || (2*af->nb_queued >= af->nb_blocks)))
+		aio_reap(af, 0);
+}
+
+static void aio_flush(GF_AIOFile *af)
+{
+	aio_submit_write(af, GF_TRUE);
+	aio_wait_all(af);
+}
+
+static void aio_read_ahead(GF_AIOFile *af)
+{
+	u32 i;
+	for (i=0; i<af->nb_blocks; i++) {
+		GF_AIOBlock *b = &af->blocks[i];
+		if (b->state != AIO_BLOCK_FREE) continue;
+		if (af->ra_offset >= af->file_size) break;
+		b->offset = af->ra_offset;
+		b->size = 0;
+		b->direct = GF_FALSE;
+		aio_queue(af, i);
+		af->ra_offset += af->block_size;
+	}
+	if (af->nb_queued) aio_reap(af, 0);
+}
+
+static GF_AIOBlock *aio_find_block(GF_AIOFile *af, u64 pos)
+{
+	u32 i;
+	for (i=0; i<af->nb_blocks; i++) {
+		GF_AIOBlock *b = &af->blocks[i];
+		if (b->state == AIO_BLOCK_FREE) continue;
+		if (pos < b->offset) continue;
+		if (pos >= b->offset + ((b->state==AIO_BLOCK_READY) ? b->size : af->block_size)) continue;
+		return b;
+	}
+	return NULL;
+}
+
+static void aio_update_size(GF_AIOFile *af)
+{
+	struct stat st;
+	if (!fstat(af->fd, &st) && ((u64) st.st_size > af->file_size))
+		af->file_size = (u64) st.st_size;
+}
+
+static u32 gfio_aio_read(GF_FileIO *fileio, u8 *buffer, u32 bytes)
+{
+	u32 i, nb_free, done = 0;
+	Bool restarted = GF_FALSE;
+	GF_AIOFile *af = gf_fileio_get_udta(fileio);
+
+	if (af->is_write) {
+		//read back in w+ mode, wait for pending writes and read synchronously
+		aio_flush(af);
+		while (done < bytes) {
+			ssize_t r = pread(af->fd, buffer + done, bytes - done, af->pos);
+			if ((r<0) && (errno==EINTR)) continue;
+			if (r<=0) break;
+			done += (u32) r;
+			af->pos += r;
+		}
+		return done;
+	}
+
+	while (done < bytes) {
+		u32 nb_copy;
+		GF_AIOBlock *b = aio_find_block(af, af->pos);
+		if (!b) {
+			if (restarted) break;
+			if (af->pos >= af->file_size) {
+				aio_update_size(af);
+				if (af->pos >= af->file_size) break;
+			}
+			//first read or seek outside of read-ahead window, restart read-ahead at current position
+			aio_wait_all(af);
+			for (i=0; i<af->nb_blocks; i++)
+				af->blocks[i].state = AIO_BLOCK_FREE;
+			af->ra_offset = af->pos;
+			aio_read_ahead(af);
+			restarted = GF_TRUE;
+			continue;
+		}
+		while (b->state == AIO_BLOCK_PENDING) {
+			if (!aio_reap(af, 1)) return done;
+		}
+		//short read
+		if (af->pos >= b->offset + b->size) {
+			b->state = AIO_BLOCK_FREE;
+			continue;
+		}
+		nb_copy = (u32) MIN(b->offset + b->size - af->pos, bytes - done);
+		memcpy(buffer + done, b->data + (af->pos - b->offset), nb_copy);
+		done += nb_copy;
+		af->pos += nb_copy;
+		restarted = GF_FALSE;
+
+		if (af->pos < b->offset + b->size) continue;
+		//block consumed, refill once half of the window is free or when nothing is in flight
+		b->state = AIO_BLOCK_FREE;
+		nb_free = 0;
+		for (i=0; i<af->nb_blocks; i++) {
+			if (af->blocks[i].state == AIO_BLOCK_FREE) nb_free++;
+		}
+		if (!af->nb_pending || (2*nb_free >= af->nb_blocks))
+			aio_read_ahead(af);
+	}
+	return done;
+}
+
+static u32 gfio_aio_write(GF_FileIO *fileio, u8 *buffer, u32 bytes)
+{
+	u32 done = 0;
+	GF_AIOFile *af = gf_fileio_get_udta(fileio);
+
+	//flush
+	if (!buffer || !bytes) {
+		aio_flush(af);
+		return 0;
+	}
+	if (af->has_error) return 0;
+
+	while (done < bytes) {
+		u32 nb_copy;
+		GF_AIOBlock *b;
+		if (af->cur_block<0) {
+			u32 i;
+			while (1) {
+				for (i=0; i<af->nb_blocks; i++) {
+					if (af->blocks[i].state == AIO_BLOCK_FREE) break;
+				}
+				if (i<af->nb_blocks) break;
+				if (!aio_reap(af, 1)) return done;
+			}
+			af->cur_block = i;
+			b = &af->blocks[i];
+			b->offset = af->pos;
+			b->size = 0;
+		}
+		b = &af->blocks[af->cur_block];
+		nb_copy = MIN(af->block_size - b->size, bytes - done);
+		memcpy(b->data + b->size, buffer + done, nb_copy);
+		b->size += nb_copy;
+		done += nb_copy;
+		af->pos += nb_copy;
+		if (af->pos > af->file_size) af->file_size = af->pos;
+
+		if (b->size == af->block_size)
+			aio_submit_write(af, GF_FALSE);
+	}
+	return done;
+}
+
+static GF_Err gfio_aio_seek(GF_FileIO *fileio, u64 offset, s32 whence)
+{
+	u64 pos;
+	GF_AIOFile *af = gf_fileio_get_udta(fileio);
+
+	if (whence==SEEK_END) {
+		if (!af->is_write) aio_update_size(af);
+		pos = af->file_size + (s64) offset;
+	} else if (whence==SEEK_CUR) {
+		pos = af->pos + (s64) offset;
+	} else {
+		pos = offset;
+	}
+	if ((s64) pos < 0) return GF_BAD_PARAM;
+
+	//writes are only in flight for a single contiguous range, wait for them before moving
+	if (af->is_write && (pos != af->pos))
+		aio_flush(af);
+	af->pos = pos;
+	return GF_OK;
+}
+
+static s64 gfio_aio_tell(GF_FileIO *fileio)
+{
+	GF_AIOFile *af = gf_fileio_get_udta(fileio);
+	return (s64) af->pos;
+}
+
+static Bool gfio_aio_eof(GF_FileIO *fileio)
+{
+	GF_AIOFile *af = gf_fileio_get_udta(fileio);
+	return (af->pos >= af->file_size) ? GF_TRUE : GF_FALSE;
+}
+
+static GF_FileIO *gfio_aio_open(GF_FileIO *fileio_ref, const char *url, const char *mode, GF_Err *out_err)
+{
+	GF_AIOFile *af = gf_fileio_get_udta(fileio_ref);
+	*out_err = GF_OK;
+	if (url) {
+		*out_err = GF_NOT_SUPPORTED;
+		return NULL;
+	}
+	if (!strcmp(mode, "deref")) {
+		if (af->is_write) {
+			aio_flush(af);
+			if (af->has_error) *out_err = GF_IO_ERR;
+		} else {
+			aio_wait_all(af);
+		}
+		aio_del(af);
+	}
+	return NULL;
+}
+
+#endif //GPAC_HAS_URING
+
+GF_EXPORT
+FILE *gf_fopen_aio(const char *file_name, const char *mode, u32 block_size, u32 nb_blocks, u32 flags)
+{
+#ifdef GPAC_HAS_URING
+	u32 i;
+	struct stat st;
+	GF_AIOFile *af;
+	Bool is_write;
+
+	if (!file_name || !mode) return NULL;
+	//only local files, in read or write/truncate mode
+	if (!strncmp(file_name, "gfio://", 7) || !strncmp(file_name, "gmem://", 7) || strchr(mode, 'a'))
+		return gf_fopen(file_name, mode);
+	if (strchr(mode, 'w')) is_write = GF_TRUE;
+	else if (strchr(mode, 'r') && !strchr(mode, '+')) is_write = GF_FALSE;
+	else return gf_fopen(file_name, mode);
+
+	if (!block_size) block_size = 0x100000;
+	if (!nb_blocks) nb_blocks = 4;
+	if (nb_blocks>64) nb_blocks = 64;
+	block_size = (block_size + AIO_ALIGN - 1) / AIO_ALIGN * AIO_ALIGN;
+
+	if (is_write) {
+		//create file and parent directories, truncate
+		FILE *f = gf_fopen(file_name, mode);
+		if (!f) return NULL;
+		gf_fclose(f);
+	}
+
+	GF_SAFEALLOC(af, GF_AIOFile);
+	if (!af) return gf_fopen(file_name, mode);
+	af->ring_fd = af->fd = af->fd_direct = -1;
+	af->cur_block = -1;
+	af->is_write = is_write;
+	af->block_size = block_size;
+	af->nb_blocks = nb_blocks;
+
+	af->fd = open(file_name, is_write ? O_RDWR : O_RDONLY);
+	if ((af->fd<0) || fstat(af->fd, &st) || !S_ISREG(st.st_mode))
+		goto fallback;
+	af->file_size = is_write ? 0 : (u64) st.st_size;
+
+	if (!aio_ring_init(af, nb_blocks)) {
+		GF_LOG(GF_LOG_INFO, GF_LOG_CORE, ("[AIO] io_uring not available (%s), using regular file I/O for %s\n", strerror(errno), file_name));
+		goto fallback;
+	}
+	af->blocks = gf_malloc(sizeof(GF_AIOBlock) * nb_blocks);
+	if (!af->blocks) goto fallback;
+	memset(af->blocks, 0, sizeof(GF_AIOBlock) * nb_blocks);
+	for (i=0; i<nb_blocks; i++) {
+		void *data = NULL;
+		if (posix_memalign(&data, AIO_ALIGN, block_size)) goto fallback;
+		af->blocks[i].data = data;
+	}
+
+#ifdef O_DIRECT
+	if (is_write && (flags & GF_FILE_AIO_DIRECT)) {
+		af->fd_direct = open(file_name, O_WRONLY | O_DIRECT);
+		if (af->fd_direct<0) {
+			GF_LOG(GF_LOG_INFO, GF_LOG_CORE, ("[AIO] Direct I/O not available for %s: %s\n", file_name, strerror(errno)));
+		}
+	}
+#endif
+
+	af->gfio = gf_fileio_new((char *) file_name, af, gfio_aio_open, gfio_aio_seek, gfio_aio_read, is_write ? gfio_aio_write : NULL, gfio_aio_tell, gfio_aio_eof, NULL);
+	if (!af->gfio) goto fallback;
+
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_CORE, ("[AIO] Opened %s for %s with %u blocks of %u bytes%s\n", file_name, is_write ? "writing" : "reading", nb_blocks, block_size, (af->fd_direct>=0) ? " - direct I/O" : ""));
+	gf_register_file_handle(file_name, (FILE *) af->gfio);
+	return (FILE *) af->gfio;
+
+fallback:
+	aio_del(af);
+	//file already created and truncated
+	return gf_fopen(file_name, is_write ? "r+b" : mode);
+
+#else
+	return gf_fopen(file_name, mode);
+#endif
+}
+
+GF_EXPORT
+Bool gf_file_is_aio(FILE *fp)
+{
+#ifdef GPAC_HAS_URING
+	if (gf_fileio_check(fp) && (((GF_FileIO *)fp)->open == gfio_aio_open))
+		return GF_TRUE;
+#endif
+	return GF_FALSE;
+}
+
 /**
   * Returns a pointer to the start of a filepath basename
  **/
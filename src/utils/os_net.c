@@ -23,6 +23,11 @@
  *
  */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+//for splice
+#define _GNU_SOURCE
+#endif
+
 #ifndef GPAC_DISABLE_CORE_TOOLS
 
 #if defined(WIN32) || defined(_WIN32_WCE)
@@ -111,9 +116,36 @@ static int wsa_init = 0;
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <arpa/inet.h>
+#include <poll.h>
 
 #include <gpac/network.h>
 
+#if defined(GPAC_CONFIG_LINUX) && !defined(GPAC_DISABLE_EPOLL)
+#include <sys/epoll.h>
+#include <gpac/config_file.h>
+#define GPAC_HAS_EPOLL
+#endif
+
+#if defined(GPAC_CONFIG_LINUX) && !defined(GPAC_DISABLE_MMSG)
+#include <netinet/udp.h>
+#define GPAC_HAS_MMSG
+/*UDP generic segmentation offload, linux 4.18+*/
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#endif
+
+#if defined(GPAC_CONFIG_LINUX) && !defined(GPAC_DISABLE_SENDFILE)
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <signal.h>
+#include <pthread.h>
+#define GPAC_HAS_SENDFILE
+#endif
+
 /*not defined on solaris*/
 #if !defined(INADDR_NONE)
 # if (defined(sun) && defined(__SVR4))
@@ -183,6 +215,14 @@ enum
 	/*socket is bound to a specific dest (server) or source (client) */
 	GF_SOCK_HAS_PEER = 1<<14,
 	GF_SOCK_IS_UN = 1<<15,
+	/*readiness reported by an epoll socket group*/
+	GF_SOCK_GROUP_READ = 1<<16,
+	/*socket is writable until a send would block*/
+	GF_SOCK_GROUP_WRITE = 1<<17,
+	/*socket group waits for the socket to be writable again*/
+	GF_SOCK_GROUP_POLLOUT = 1<<18,
+	/*UDP segmentation offload failed on this socket, do not use it anymore*/
+	GF_SOCK_NO_GSO = 1<<19,
 };
 
 struct __tag_socket
@@ -198,8 +238,58 @@ struct __tag_socket
 	u32 dest_addr_len;
 
 	u32 usec_wait;
+#ifdef GPAC_HAS_EPOLL
+	/*descriptor registered in the socket group epoll set, 0 if none*/
+	SOCKET ep_socket;
+#endif
 };
 
+#ifndef __SYMBIAN32__
+/*waits for a single socket to be ready for the given mode (read and write for GF_SK_SELECT_BOTH)
+returns SOCKET_ERROR on error, 0 if not ready, >0 otherwise
+select() cannot watch descriptors above FD_SETSIZE, poll() is used for these*/
+static int gf_sk_wait_ready(SOCKET sk, GF_SockSelectMode mode, u32 sec, u32 usec)
+{
+	int ready;
+	struct timeval timeout;
+	fd_set rgroup, wgroup;
+
+#if !defined(WIN32) && !defined(_WIN32_WCE)
+	if (sk >= FD_SETSIZE) {
+		struct pollfd pfd;
+		pfd.fd = sk;
+		pfd.events = 0;
+		pfd.revents = 0;
+		if (mode != GF_SK_SELECT_WRITE) pfd.events |= POLLIN;
+		if (mode != GF_SK_SELECT_READ) pfd.events |= POLLOUT;
+		ready = poll(&pfd, 1, (int) (sec*1000 + (usec+999)/1000) );
+		if (ready <= 0) return ready;
+		//error or hang-up, report as ready so that the next socket call gets the error
+		if (pfd.revents & (POLLERR|POLLHUP|POLLNVAL)) return 1;
+		if ((pfd.revents & pfd.events) != pfd.events) return 0;
+		return 1;
+	}
+#endif
+
+	FD_ZERO(&rgroup);
+	FD_ZERO(&wgroup);
+	if (mode != GF_SK_SELECT_WRITE)
+		FD_SET(sk, &rgroup);
+	if (mode != GF_SK_SELECT_READ)
+		FD_SET(sk, &wgroup);
+	timeout.tv_sec = sec;
+	timeout.tv_usec = usec;
+
+	ready = select((int) sk+1, (mode != GF_SK_SELECT_WRITE) ? &rgroup : NULL, (mode != GF_SK_SELECT_READ) ? &wgroup : NULL, NULL, &timeout);
+	if (ready <= 0) return ready;
+	if ((mode != GF_SK_SELECT_WRITE) && !FD_ISSET(sk, &rgroup))
+		return 0;
+	if ((mode != GF_SK_SELECT_READ) && !FD_ISSET(sk, &wgroup))
+		return 0;
+	return 1;
+}
+#endif
+
 
 
 GF_EXPORT
@@ -889,30 +979,23 @@ GF_Err gf_sk_bind(GF_Socket *sock, const char *local_ip, u16 port, const char *p
 
 //send length bytes of a buffer
 GF_EXPORT
-GF_Err gf_sk_send(GF_Socket *sock, const u8 *buffer, u32 length)
+GF_Err gf_sk_send_ex(GF_Socket *sock, const u8 *buffer, u32 length, u32 *written)
 {
 	u32 count;
 	s32 res;
 	Bool not_ready = GF_FALSE;
 #ifndef __SYMBIAN32__
 	int ready;
-	struct timeval timeout;
-	fd_set Group;
 #endif
 
+	if (written) *written = 0;
 	//the socket must be bound or connected
 	if (!sock || !sock->socket)
 		return GF_BAD_PARAM;
 
 #ifndef __SYMBIAN32__
 	//can we write?
-	FD_ZERO(&Group);
-	FD_SET(sock->socket, &Group);
-	timeout.tv_sec = 0;
-	timeout.tv_usec = sock->usec_wait;
-
-	//TODO CHECK IF THIS IS CORRECT
-	ready = select((int) sock->socket+1, NULL, &Group, NULL, &timeout);
+	ready = gf_sk_wait_ready(sock->socket, GF_SK_SELECT_WRITE, 0, sock->usec_wait);
 	if (ready == SOCKET_ERROR) {
 		switch (LASTSOCKERROR) {
 		case EAGAIN:
@@ -924,7 +1007,7 @@ GF_Err gf_sk_send(GF_Socket *sock, const u8 *buffer, u32 length)
 	}
 
 	//should never happen (to check: is writeability is guaranteed for not-connected sockets)
-	if (!ready || !FD_ISSET(sock->socket, &Group)) {
+	if (!ready) {
 		not_ready = GF_TRUE;
 	}
 #endif
@@ -942,11 +1025,15 @@ GF_Err gf_sk_send(GF_Socket *sock, const u8 *buffer, u32 length)
 			res = (s32) send(sock->socket, (char *) buffer+count, length - count, sflags);
 		}
 		if (res == SOCKET_ERROR) {
-			if (not_ready)
+			if (written) *written = count;
+			if (not_ready) {
+				sock->flags &= ~GF_SOCK_GROUP_WRITE;
 				return GF_IP_NETWORK_EMPTY;
+			}
 
 			switch (res = LASTSOCKERROR) {
 			case EAGAIN:
+				sock->flags &= ~GF_SOCK_GROUP_WRITE;
 				return GF_IP_SOCK_WOULD_BLOCK;
 #ifndef __SYMBIAN32__
 			case ENOTCONN:
@@ -970,16 +1057,235 @@ GF_Err gf_sk_send(GF_Socket *sock, const u8 *buffer, u32 length)
 		}
 		count += res;
 	}
+	if (written) *written = count;
 	return GF_OK;
 }
 
+GF_EXPORT
+GF_Err gf_sk_send(GF_Socket *sock, const u8 *buffer, u32 length)
+{
+	return gf_sk_send_ex(sock, buffer, length, NULL);
+}
+
+GF_EXPORT
+GF_Err gf_sk_send_file(GF_Socket *sock, FILE *file, u64 offset, u32 length, u32 *written)
+{
+#ifdef GPAC_HAS_SENDFILE
+	struct stat st;
+	sigset_t sig_pipe, sig_old;
+	Bool is_pipe, pipe_raised=GF_FALSE;
+	GF_Err e = GF_OK;
+	u32 count = 0;
+	int fd;
+#endif
+
+	if (written) *written = 0;
+	if (!sock || !sock->socket || !file)
+		return GF_BAD_PARAM;
+
+#ifdef GPAC_HAS_SENDFILE
+	//only for connected stream sockets and native files
+	if (!(sock->flags & GF_SOCK_IS_TCP) || (sock->flags & GF_SOCK_HAS_PEER))
+		return GF_NOT_SUPPORTED;
+	if (gf_fileio_check(file))
+		return GF_NOT_SUPPORTED;
+	fd = fileno(file);
+	if ((fd<0) || fstat(fd, &st))
+		return GF_NOT_SUPPORTED;
+	if (S_ISREG(st.st_mode)) is_pipe = GF_FALSE;
+	else if (S_ISFIFO(st.st_mode)) is_pipe = GF_TRUE;
+	else return GF_NOT_SUPPORTED;
+
+	//sendfile and splice have no MSG_NOSIGNAL equivalent, block SIGPIPE for this thread while sending
+	sigemptyset(&sig_pipe);
+	sigaddset(&sig_pipe, SIGPIPE);
+	pthread_sigmask(SIG_BLOCK, &sig_pipe, &sig_old);
+
+	while (count < length) {
+		ssize_t res;
+		if (is_pipe) {
+			res = splice(fd, NULL, sock->socket, NULL, length - count, SPLICE_F_MOVE | SPLICE_F_MORE);
+		} else {
+			off_t pos = (off_t) (offset + count);
+			res = sendfile(sock->socket, fd, &pos, length - count);
+		}
+		if (res<0) {
+			int err = errno;
+			if (err==EINTR) continue;
+			switch (err) {
+			case EAGAIN:
+				sock->flags &= ~GF_SOCK_GROUP_WRITE;
+				if (!count) e = GF_IP_SOCK_WOULD_BLOCK;
+				break;
+			case EINVAL:
+			case ENOSYS:
+			case EOPNOTSUPP:
+				//not supported by kernel or filesystem, caller shall use regular send
+				if (!count) e = GF_NOT_SUPPORTED;
+				break;
+			case EPIPE:
+				pipe_raised = GF_TRUE;
+				//fallthrough
+			case ENOTCONN:
+			case ECONNRESET:
+				GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[socket] sendfile failure: %s\n", gf_errno_str(err)));
+				e = GF_IP_CONNECTION_CLOSED;
+				break;
+			default:
+				GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[socket] sendfile failure: %s\n", gf_errno_str(err)));
+				e = GF_IP_NETWORK_FAILURE;
+				break;
+			}
+			break;
+		}
+		//end of file or pipe closed
+		if (!res) break;
+		count += (u32) res;
+	}
+
+	//consume pending SIGPIPE before restoring signal mask
+	if (pipe_raised) {
+		struct timespec no_wait = {0, 0};
+		while (sigtimedwait(&sig_pipe, NULL, &no_wait) > 0) {}
+	}
+	pthread_sigmask(SIG_SETMASK, &sig_old, NULL);
+
+	if (written) *written = count;
+	return e;
+#else
+	return GF_NOT_SUPPORTED;
+#endif
+}
+
+#ifdef GPAC_HAS_MMSG
+/*max payload of a UDP datagram sent with segmentation offload*/
+#define GF_SK_GSO_MAX_SIZE	65000
+
+static GF_Err gf_sk_batch_error(const char *name)
+{
+	int err = LASTSOCKERROR;
+	switch (err) {
+	case EAGAIN:
+		return GF_IP_SOCK_WOULD_BLOCK;
+	case ENOTCONN:
+	case ECONNRESET:
+	case ECONNREFUSED:
+	case EPIPE:
+		GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[socket] %s failure: %s\n", name, gf_errno_str(err)));
+		return GF_IP_CONNECTION_CLOSED;
+	case ENOBUFS:
+		GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[socket] %s failure: %s\n", name, gf_errno_str(err)));
+		return GF_BUFFER_TOO_SMALL;
+	default:
+		GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[socket] %s failure: %s\n", name, gf_errno_str(err)));
+		return GF_IP_NETWORK_FAILURE;
+	}
+}
+#endif
+
+GF_EXPORT
+GF_Err gf_sk_send_batch(GF_Socket *sock, const GF_SockDatagram *dgrams, u32 nb_dgrams, u32 *nb_sent)
+{
+	GF_Err e = GF_OK;
+	u32 done = 0;
+
+	if (nb_sent) *nb_sent = 0;
+	if (!sock || !sock->socket || !dgrams)
+		return GF_BAD_PARAM;
+
+#ifdef GPAC_HAS_MMSG
+	if (!(sock->flags & GF_SOCK_IS_TCP)) {
+		struct mmsghdr msgs[GF_SK_MAX_BATCH];
+		struct iovec iovs[GF_SK_MAX_BATCH];
+		union {
+			char buf[CMSG_SPACE(sizeof(u16))];
+			struct cmsghdr align;
+		} ctrl[GF_SK_MAX_BATCH];
+		u32 nb_dgrams_in_msg[GF_SK_MAX_BATCH];
+
+		while (done < nb_dgrams) {
+			s32 res;
+			u32 i, nb_msgs = 0;
+			u32 nb = MIN(nb_dgrams - done, GF_SK_MAX_BATCH);
+			Bool use_gso = (sock->flags & (GF_SOCK_NO_GSO|GF_SOCK_IS_UN)) ? GF_FALSE : GF_TRUE;
+
+			for (i=0; i<nb; i++) {
+				iovs[i].iov_base = dgrams[done+i].data;
+				iovs[i].iov_len = dgrams[done+i].size;
+			}
+			i = 0;
+			while (i<nb) {
+				struct msghdr *mh = &msgs[nb_msgs].msg_hdr;
+				u32 seg_size = dgrams[done+i].size;
+				u32 tot_size = seg_size;
+				u32 j = i+1;
+				//with segmentation offload, gather datagrams of the same size in a single message, the last one may be smaller
+				if (use_gso && seg_size) {
+					while ((j<nb) && dgrams[done+j].size && (dgrams[done+j].size <= seg_size) && (tot_size + dgrams[done+j].size <= GF_SK_GSO_MAX_SIZE)) {
+						tot_size += dgrams[done+j].size;
+						j++;
+						if (dgrams[done+j-1].size < seg_size) break;
+					}
+				}
+				memset(mh, 0, sizeof(struct msghdr));
+				msgs[nb_msgs].msg_len = 0;
+				if (sock->flags & GF_SOCK_HAS_PEER) {
+					mh->msg_name = &sock->dest_addr;
+					mh->msg_namelen = sock->dest_addr_len;
+				}
+				mh->msg_iov = &iovs[i];
+				mh->msg_iovlen = j - i;
+				if (j - i > 1) {
+					struct cmsghdr *cm;
+					mh->msg_control = ctrl[nb_msgs].buf;
+					mh->msg_controllen = sizeof(ctrl[nb_msgs].buf);
+					cm = CMSG_FIRSTHDR(mh);
+					cm->cmsg_level = SOL_UDP;
+					cm->cmsg_type = UDP_SEGMENT;
+					cm->cmsg_len = CMSG_LEN(sizeof(u16));
+					*((u16 *) CMSG_DATA(cm)) = (u16) seg_size;
+				}
+				nb_dgrams_in_msg[nb_msgs] = j - i;
+				nb_msgs++;
+				i = j;
+			}
+
+			res = sendmmsg(sock->socket, msgs, nb_msgs, MSG_NOSIGNAL);
+			if (res < 0) {
+				int err = LASTSOCKERROR;
+				if (err == EINTR) continue;
+				//segmentation offload not supported by kernel, driver or route: disable and retry
+				if ((nb_msgs < nb) && ((err==EIO) || (err==EINVAL) || (err==ENOPROTOOPT) || (err==EOPNOTSUPP))) {
+					GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[socket] UDP segmentation offload failure (%s), disabling\n", gf_errno_str(err) ));
+					sock->flags |= GF_SOCK_NO_GSO;
+					continue;
+				}
+				e = gf_sk_batch_error("sendmmsg");
+				if (e == GF_IP_SOCK_WOULD_BLOCK) sock->flags &= ~GF_SOCK_GROUP_WRITE;
+				break;
+			}
+			for (i=0; i<(u32) res; i++)
+				done += nb_dgrams_in_msg[i];
+		}
+		if (nb_sent) *nb_sent = done;
+		return e;
+	}
+#endif
+
+	//no batch support, one call per datagram
+	while (done < nb_dgrams) {
+		e = gf_sk_send(sock, dgrams[done].data, dgrams[done].size);
+		if (e) break;
+		done++;
+	}
+	if (nb_sent) *nb_sent = done;
+	return e;
+}
+
 GF_Err gf_sk_select(GF_Socket *sock, u32 mode)
 {
 #ifndef __SYMBIAN32__
 	int ready;
-	struct timeval timeout;
-	fd_set RGroup;
-	fd_set WGroup;
 #endif
 
 	//the socket must be bound or connected
@@ -987,18 +1293,7 @@ GF_Err gf_sk_select(GF_Socket *sock, u32 mode)
 		return GF_BAD_PARAM;
 
 #ifndef __SYMBIAN32__
-	//can we write?
-	FD_ZERO(&RGroup);
-	FD_ZERO(&WGroup);
-	if (mode != GF_SK_SELECT_WRITE)
-		FD_SET(sock->socket, &RGroup);
-	if (mode != GF_SK_SELECT_READ)
-		FD_SET(sock->socket, &WGroup);
-	timeout.tv_sec = 0;
-	timeout.tv_usec = sock->usec_wait;
-
-	//TODO CHECK IF THIS IS CORRECT
-	ready = select((int) sock->socket+1, &RGroup, &WGroup, NULL, &timeout);
+	ready = gf_sk_wait_ready(sock->socket, mode, 0, sock->usec_wait);
 	if (ready == SOCKET_ERROR) {
 		switch (LASTSOCKERROR) {
 		case EAGAIN:
@@ -1009,13 +1304,10 @@ GF_Err gf_sk_select(GF_Socket *sock, u32 mode)
 		}
 	}
 
-	//should never happen (to check: is writeability is guaranteed for not-connected sockets)
-	if (!ready)
-		return GF_IP_SOCK_WOULD_BLOCK;
-	if ((mode != GF_SK_SELECT_WRITE) && !FD_ISSET(sock->socket, &RGroup))
-		return GF_IP_SOCK_WOULD_BLOCK;
-	if ((mode != GF_SK_SELECT_READ) && !FD_ISSET(sock->socket, &WGroup))
+	if (!ready) {
+		if (mode == GF_SK_SELECT_WRITE) sock->flags &= ~GF_SOCK_GROUP_WRITE;
 		return GF_IP_SOCK_WOULD_BLOCK;
+	}
 	return GF_OK;
 #else
 	return GF_IP_SOCK_WOULD_BLOCK;
@@ -1268,8 +1560,15 @@ struct __tag_sock_group
 {
 	GF_List *sockets;
 	fd_set rgroup, wgroup;
+#ifdef GPAC_HAS_EPOLL
+	/*level-triggered epoll set, -1 if select() is used*/
+	int epfd;
+	struct epoll_event *events;
+	u32 nb_alloc_events;
+#endif
 };
 
+GF_EXPORT
 GF_SockGroup *gf_sk_group_new()
 {
 	GF_SockGroup *tmp;
@@ -1278,29 +1577,161 @@ GF_SockGroup *gf_sk_group_new()
 	tmp->sockets = gf_list_new();
 	FD_ZERO(&tmp->rgroup);
 	FD_ZERO(&tmp->wgroup);
+#ifdef GPAC_HAS_EPOLL
+	tmp->epfd = -1;
+	if (!gf_opts_get_bool("core", "no-epoll")) {
+		tmp->epfd = epoll_create1(EPOLL_CLOEXEC);
+		if (tmp->epfd < 0) {
+			GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[socket] cannot create epoll set (%s), using select\n", gf_errno_str(LASTSOCKERROR) ));
+		}
+	}
+#endif
 	return tmp;
 }
 
+GF_EXPORT
 void gf_sk_group_del(GF_SockGroup *sg)
 {
+#ifdef GPAC_HAS_EPOLL
+	if (sg->epfd >= 0) close(sg->epfd);
+	if (sg->events) gf_free(sg->events);
+#endif
 	gf_list_del(sg->sockets);
 	gf_free(sg);
 }
 
+#ifdef GPAC_HAS_EPOLL
+/*read readiness is level-triggered, as with select(), since callers usually do not read sockets until they would block
+write readiness is assumed until a send would block, the socket is then watched for writing until it becomes writable again*/
+static void gf_sk_group_epoll_add(GF_SockGroup *sg, GF_Socket *sk)
+{
+	struct epoll_event ev;
+	//socket not yet created
+	if (!sk->socket) return;
+	memset(&ev, 0, sizeof(struct epoll_event));
+	ev.events = EPOLLIN | EPOLLRDHUP;
+	ev.data.ptr = sk;
+	if ((epoll_ctl(sg->epfd, EPOLL_CTL_ADD, sk->socket, &ev) < 0) && (LASTSOCKERROR != EEXIST)) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[socket] cannot add socket to epoll set: %s\n", gf_errno_str(LASTSOCKERROR) ));
+		return;
+	}
+	sk->ep_socket = sk->socket;
+	sk->flags &= ~(GF_SOCK_GROUP_READ|GF_SOCK_GROUP_POLLOUT);
+	sk->flags |= GF_SOCK_GROUP_WRITE;
+}
+
+static void gf_sk_group_epoll_watch_write(GF_SockGroup *sg, GF_Socket *sk, Bool do_watch)
+{
+	struct epoll_event ev;
+	memset(&ev, 0, sizeof(struct epoll_event));
+	ev.events = EPOLLIN | EPOLLRDHUP;
+	if (do_watch) ev.events |= EPOLLOUT;
+	ev.data.ptr = sk;
+	if (epoll_ctl(sg->epfd, EPOLL_CTL_MOD, sk->ep_socket, &ev) < 0) {
+		//cannot watch, consider socket writable
+		sk->flags |= GF_SOCK_GROUP_WRITE;
+		sk->flags &= ~GF_SOCK_GROUP_POLLOUT;
+		return;
+	}
+	if (do_watch) sk->flags |= GF_SOCK_GROUP_POLLOUT;
+	else sk->flags &= ~GF_SOCK_GROUP_POLLOUT;
+}
+#endif
+
+GF_EXPORT
 void gf_sk_group_register(GF_SockGroup *sg, GF_Socket *sk)
 {
 	if (sg && sk) {
-		if (gf_list_find(sg->sockets, sk)<0)
+		if (gf_list_find(sg->sockets, sk)<0) {
 			gf_list_add(sg->sockets, sk);
+#ifdef GPAC_HAS_EPOLL
+			if (sg->epfd >= 0) gf_sk_group_epoll_add(sg, sk);
+#endif
+		}
 	}
 }
+GF_EXPORT
 void gf_sk_group_unregister(GF_SockGroup *sg, GF_Socket *sk)
 {
 	if (sg && sk) {
+#ifdef GPAC_HAS_EPOLL
+		if ((sg->epfd >= 0) && sk->ep_socket && (gf_list_find(sg->sockets, sk)>=0)) {
+			epoll_ctl(sg->epfd, EPOLL_CTL_DEL, sk->ep_socket, NULL);
+			sk->ep_socket = 0;
+			sk->flags &= ~(GF_SOCK_GROUP_READ|GF_SOCK_GROUP_WRITE|GF_SOCK_GROUP_POLLOUT);
+		}
+#endif
 		gf_list_del_item(sg->sockets, sk);
 	}
 }
 
+#ifdef GPAC_HAS_EPOLL
+static GF_Err gf_sk_group_select_epoll(GF_SockGroup *sg, u32 usec_wait, GF_SockSelectMode mode)
+{
+	s32 i, nb_ev;
+	u32 count, wait_ms;
+	Bool pending = GF_FALSE;
+	GF_Socket *sock;
+
+	count = gf_list_count(sg->sockets);
+	for (i=0; i<(s32) count; i++) {
+		sock = gf_list_get(sg->sockets, i);
+		//socket was created after registration
+		if (sock->socket != sock->ep_socket) {
+			if (sock->ep_socket) epoll_ctl(sg->epfd, EPOLL_CTL_DEL, sock->ep_socket, NULL);
+			sock->ep_socket = 0;
+			gf_sk_group_epoll_add(sg, sock);
+			if (!sock->ep_socket) continue;
+		}
+		sock->flags &= ~GF_SOCK_GROUP_READ;
+		if (sock->flags & GF_SOCK_GROUP_WRITE) {
+			if (mode != GF_SK_SELECT_READ) pending = GF_TRUE;
+		}
+		//a send would have blocked, wait for the socket to be writable
+		else if (!(sock->flags & GF_SOCK_GROUP_POLLOUT)) {
+			gf_sk_group_epoll_watch_write(sg, sock, GF_TRUE);
+		}
+	}
+	//at most 4096 events are fetched per wait, remaining ones are fetched at next wait
+	if (count > 4096) count = 4096;
+	if (sg->nb_alloc_events < count) {
+		struct epoll_event *events = gf_realloc(sg->events, sizeof(struct epoll_event) * count);
+		if (!events) return GF_OUT_OF_MEM;
+		sg->events = events;
+		sg->nb_alloc_events = count;
+	}
+	//epoll timeout is in milliseconds, shorter waits are treated as non-blocking
+	wait_ms = pending ? 0 : usec_wait/1000;
+	nb_ev = epoll_wait(sg->epfd, sg->events, (int) sg->nb_alloc_events, (int) wait_ms);
+	if (nb_ev < 0) {
+		if (LASTSOCKERROR == EINTR) return pending ? GF_OK : GF_IP_NETWORK_EMPTY;
+		GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[socket] cannot wait for epoll events: %s\n", gf_errno_str(LASTSOCKERROR) ));
+		return GF_IP_NETWORK_FAILURE;
+	}
+	for (i=0; i<nb_ev; i++) {
+		u32 ev = sg->events[i].events;
+		sock = sg->events[i].data.ptr;
+		//error or hang-up are signaled as readable and writable so that the next socket call gets the error
+		if (ev & (EPOLLIN|EPOLLRDHUP|EPOLLHUP|EPOLLERR)) {
+			sock->flags |= GF_SOCK_GROUP_READ;
+			if (mode != GF_SK_SELECT_WRITE) pending = GF_TRUE;
+		}
+		if (ev & (EPOLLOUT|EPOLLHUP|EPOLLERR)) {
+			sock->flags |= GF_SOCK_GROUP_WRITE;
+			if (sock->flags & GF_SOCK_GROUP_POLLOUT)
+				gf_sk_group_epoll_watch_write(sg, sock, GF_FALSE);
+			if (mode != GF_SK_SELECT_READ) pending = GF_TRUE;
+		}
+	}
+	if (!pending) {
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_NETWORK, ("[socket] nothing to be read - %d events\n", nb_ev));
+		return GF_IP_NETWORK_EMPTY;
+	}
+	return GF_OK;
+}
+#endif
+
+GF_EXPORT
 GF_Err gf_sk_group_select(GF_SockGroup *sg, u32 usec_wait, GF_SockSelectMode mode)
 {
 	s32 ready;
@@ -1313,6 +1744,11 @@ GF_Err gf_sk_group_select(GF_SockGroup *sg, u32 usec_wait, GF_SockSelectMode mod
 	if (!gf_list_count(sg->sockets))
 		return GF_IP_NETWORK_EMPTY;
 
+#ifdef GPAC_HAS_EPOLL
+	if (sg->epfd >= 0)
+		return gf_sk_group_select_epoll(sg, usec_wait, mode);
+#endif
+
 	FD_ZERO(&sg->rgroup);
 	FD_ZERO(&sg->wgroup);
 
@@ -1329,6 +1765,12 @@ GF_Err gf_sk_group_select(GF_SockGroup *sg, u32 usec_wait, GF_SockSelectMode mod
 		break;
 	}
 	while ((sock = gf_list_enum(sg->sockets, &i))) {
+#if !defined(WIN32) && !defined(_WIN32_WCE)
+		if (sock->socket >= FD_SETSIZE) {
+			GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[socket] descriptor %d above select() limit, ignoring\n", sock->socket));
+			continue;
+		}
+#endif
 		if (rgroup)
 			FD_SET(sock->socket, rgroup);
 
@@ -1369,9 +1811,22 @@ GF_Err gf_sk_group_select(GF_SockGroup *sg, u32 usec_wait, GF_SockSelectMode mod
 	return GF_OK;
 }
 
+GF_EXPORT
 Bool gf_sk_group_sock_is_set(GF_SockGroup *sg, GF_Socket *sk, GF_SockSelectMode mode)
 {
 	if (sg && sk) {
+#ifdef GPAC_HAS_EPOLL
+		if (sg->epfd >= 0) {
+			if ((mode!=GF_SK_SELECT_WRITE) && (sk->flags & GF_SOCK_GROUP_READ))
+				return GF_TRUE;
+			if ((mode!=GF_SK_SELECT_READ) && (sk->flags & GF_SOCK_GROUP_WRITE))
+				return GF_TRUE;
+			return GF_FALSE;
+		}
+#endif
+#if !defined(WIN32) && !defined(_WIN32_WCE)
+		if (sk->socket >= FD_SETSIZE) return GF_FALSE;
+#endif
 		if ((mode!=GF_SK_SELECT_WRITE) && FD_ISSET(sk->socket, &sg->rgroup))
 			return GF_TRUE;
 		if ((mode!=GF_SK_SELECT_READ) && FD_ISSET(sk->socket, &sg->wgroup))
@@ -1389,8 +1844,6 @@ GF_Err gf_sk_receive_internal(GF_Socket *sock, char *buffer, u32 length, u32 *By
 	s32 res;
 #ifndef __SYMBIAN32__
 	s32 ready;
-	struct timeval timeout;
-	fd_set Group;
 #endif
 
 	if (BytesRead) *BytesRead = 0;
@@ -1399,11 +1852,7 @@ GF_Err gf_sk_receive_internal(GF_Socket *sock, char *buffer, u32 length, u32 *By
 #ifndef __SYMBIAN32__
 	if (do_select) {
 		//can we read?
-		timeout.tv_sec = 0;
-		timeout.tv_usec = sock->usec_wait;
-		FD_ZERO(&Group);
-		FD_SET(sock->socket, &Group);
-		ready = select((int) sock->socket+1, &Group, NULL, NULL, &timeout);
+		ready = gf_sk_wait_ready(sock->socket, GF_SK_SELECT_READ, 0, sock->usec_wait);
 
 		if (ready == SOCKET_ERROR) {
 			switch (LASTSOCKERROR) {
@@ -1421,7 +1870,7 @@ GF_Err gf_sk_receive_internal(GF_Socket *sock, char *buffer, u32 length, u32 *By
 				return GF_IP_NETWORK_FAILURE;
 			}
 		}
-		if (!ready || !FD_ISSET(sock->socket, &Group)) {
+		if (!ready) {
 			GF_LOG(GF_LOG_DEBUG, GF_LOG_NETWORK, ("[socket] nothing to be read - ready %d\n", ready));
 			return GF_IP_NETWORK_EMPTY;
 		}
@@ -1475,6 +1924,73 @@ GF_Err gf_sk_receive_no_select(GF_Socket *sock, u8 *buffer, u32 length, u32 *Byt
 	return gf_sk_receive_internal(sock, buffer, length, BytesRead, GF_FALSE);
 }
 
+GF_EXPORT
+GF_Err gf_sk_receive_batch(GF_Socket *sock, GF_SockDatagram *dgrams, u32 nb_dgrams, u32 *nb_recv)
+{
+	GF_Err e = GF_OK;
+	u32 i;
+
+	if (nb_recv) *nb_recv = 0;
+	if (!sock || !sock->socket || !dgrams || !nb_dgrams || !nb_recv)
+		return GF_BAD_PARAM;
+	if (nb_dgrams > GF_SK_MAX_BATCH)
+		nb_dgrams = GF_SK_MAX_BATCH;
+
+#ifdef GPAC_HAS_MMSG
+	if (!(sock->flags & GF_SOCK_IS_TCP)) {
+		struct mmsghdr msgs[GF_SK_MAX_BATCH];
+		struct iovec iovs[GF_SK_MAX_BATCH];
+		s32 res;
+
+		memset(msgs, 0, sizeof(struct mmsghdr) * nb_dgrams);
+		for (i=0; i<nb_dgrams; i++) {
+			iovs[i].iov_base = dgrams[i].data;
+			iovs[i].iov_len = dgrams[i].size;
+			msgs[i].msg_hdr.msg_iov = &iovs[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+			//same as recvfrom, the peer address is the one of the last datagram
+			if (sock->flags & GF_SOCK_HAS_PEER) {
+				msgs[i].msg_hdr.msg_name = &sock->dest_addr;
+				msgs[i].msg_hdr.msg_namelen = sizeof(sock->dest_addr);
+			}
+		}
+		//wait for the first datagram only (non-blocking sockets return right away), then get what is available
+		do {
+			res = recvmmsg(sock->socket, msgs, nb_dgrams, MSG_WAITFORONE, NULL);
+		} while ((res < 0) && (LASTSOCKERROR == EINTR));
+
+		if (res < 0) {
+			e = gf_sk_batch_error("recvmmsg");
+			return (e==GF_IP_SOCK_WOULD_BLOCK) ? GF_IP_NETWORK_EMPTY : e;
+		}
+		if (!res) return GF_IP_NETWORK_EMPTY;
+
+		for (i=0; i<(u32) res; i++) {
+			dgrams[i].size = msgs[i].msg_len;
+			if (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) {
+				GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[socket] datagram truncated to %d bytes, reception buffer too small\n", dgrams[i].size));
+			}
+		}
+		if (sock->flags & GF_SOCK_HAS_PEER)
+			sock->dest_addr_len = msgs[res-1].msg_hdr.msg_namelen;
+		*nb_recv = (u32) res;
+		return GF_OK;
+	}
+#endif
+
+	//no batch support, one call per datagram
+	for (i=0; i<nb_dgrams; i++) {
+		u32 size = 0;
+		e = gf_sk_receive_internal(sock, dgrams[i].data, dgrams[i].size, &size, GF_FALSE);
+		if (e) break;
+		dgrams[i].size = size;
+		(*nb_recv)++;
+	}
+	if (*nb_recv) return GF_OK;
+	if (e==GF_IP_SOCK_WOULD_BLOCK) return GF_IP_NETWORK_EMPTY;
+	return e;
+}
+
 GF_EXPORT
 GF_Err gf_sk_listen(GF_Socket *sock, u32 MaxConnection)
 {
@@ -1494,21 +2010,13 @@ GF_Err gf_sk_accept(GF_Socket *sock, GF_Socket **newConnection)
 	SOCKET sk;
 #ifndef __SYMBIAN32__
 	s32 ready;
-	struct timeval timeout;
-	fd_set Group;
 #endif
 	*newConnection = NULL;
 	if (!sock || !(sock->flags & GF_SOCK_IS_LISTENING) ) return GF_BAD_PARAM;
 
 #ifndef __SYMBIAN32__
 	//can we read?
-	FD_ZERO(&Group);
-	FD_SET(sock->socket, &Group);
-	timeout.tv_sec = 0;
-	timeout.tv_usec = sock->usec_wait;
-
-	//TODO - check if this is correct
-	ready = select((int) sock->socket+1, &Group, NULL, NULL, &timeout);
+	ready = gf_sk_wait_ready(sock->socket, GF_SK_SELECT_READ, 0, sock->usec_wait);
 	if (ready == SOCKET_ERROR) {
 		switch (LASTSOCKERROR) {
 		case EAGAIN:
@@ -1518,7 +2026,7 @@ GF_Err gf_sk_accept(GF_Socket *sock, GF_Socket **newConnection)
 			return GF_IP_NETWORK_FAILURE;
 		}
 	}
-	if (!ready || !FD_ISSET(sock->socket, &Group)) return GF_IP_NETWORK_EMPTY;
+	if (!ready) return GF_IP_NETWORK_EMPTY;
 #endif
 
 #ifdef GPAC_HAS_IPV6
@@ -1542,8 +2050,11 @@ GF_Err gf_sk_accept(GF_Socket *sock, GF_Socket **newConnection)
 
 	(*newConnection) = (GF_Socket *) gf_malloc(sizeof(GF_Socket));
 	(*newConnection)->socket = sk;
-	(*newConnection)->flags = sock->flags & ~GF_SOCK_IS_LISTENING;
+	(*newConnection)->flags = sock->flags & ~(GF_SOCK_IS_LISTENING|GF_SOCK_GROUP_READ|GF_SOCK_GROUP_WRITE|GF_SOCK_GROUP_POLLOUT);
 	(*newConnection)->usec_wait = sock->usec_wait;
+#ifdef GPAC_HAS_EPOLL
+	(*newConnection)->ep_socket = 0;
+#endif
 #ifdef GPAC_HAS_IPV6
 	memcpy( &(*newConnection)->dest_addr, &sock->dest_addr, client_address_size);
 	memset(&sock->dest_addr, 0, sizeof(struct sockaddr_in6));
@@ -1654,8 +2165,6 @@ GF_Err gf_sk_send_to(GF_Socket *sock, const char *buffer, u32 length, char *remo
 #endif
 #ifndef __SYMBIAN32__
 	s32 ready;
-	struct timeval timeout;
-	fd_set Group;
 #endif
 
 	//the socket must be bound or connected
@@ -1664,13 +2173,7 @@ GF_Err gf_sk_send_to(GF_Socket *sock, const char *buffer, u32 length, char *remo
 
 #ifndef __SYMBIAN32__
 	//can we write?
-	FD_ZERO(&Group);
-	FD_SET(sock->socket, &Group);
-	timeout.tv_sec = 0;
-	timeout.tv_usec = sock->usec_wait;
-
-	//TODO - check if this is correct
-	ready = select((int) sock->socket+1, NULL, &Group, NULL, &timeout);
+	ready = gf_sk_wait_ready(sock->socket, GF_SK_SELECT_WRITE, 0, sock->usec_wait);
 	if (ready == SOCKET_ERROR) {
 		switch (LASTSOCKERROR) {
 		case EAGAIN:
@@ -1680,7 +2183,7 @@ GF_Err gf_sk_send_to(GF_Socket *sock, const char *buffer, u32 length, char *remo
 			return GF_IP_NETWORK_FAILURE;
 		}
 	}
-	if (!ready || !FD_ISSET(sock->socket, &Group)) return GF_IP_NETWORK_EMPTY;
+	if (!ready) return GF_IP_NETWORK_EMPTY;
 #endif
 
 
@@ -1741,8 +2244,6 @@ GF_Err gf_sk_probe(GF_Socket *sock)
 {
 #ifndef __SYMBIAN32__
 	s32 ready;
-	struct timeval timeout;
-	fd_set Group;
 #endif
 	s32 res;
 	u8 buffer[1];
@@ -1750,12 +2251,7 @@ GF_Err gf_sk_probe(GF_Socket *sock)
 
 #ifndef __SYMBIAN32__
 	//can we read?
-	FD_ZERO(&Group);
-	FD_SET(sock->socket, &Group);
-	timeout.tv_sec = 0;
-	timeout.tv_usec = 100;
-
-	ready = select((int) sock->socket+1, &Group, NULL, NULL, &timeout);
+	ready = gf_sk_wait_ready(sock->socket, GF_SK_SELECT_READ, 0, 100);
 	if (ready == SOCKET_ERROR) {
 		switch (LASTSOCKERROR) {
 		case EAGAIN:
@@ -1765,7 +2261,7 @@ GF_Err gf_sk_probe(GF_Socket *sock)
 			return GF_IP_CONNECTION_CLOSED;
 		}
 	}
-	if (!FD_ISSET(sock->socket, &Group)) {
+	if (!ready) {
 		return GF_IP_NETWORK_EMPTY;
 	}
 #endif
@@ -1794,8 +2290,6 @@ GF_Err gf_sk_receive_wait(GF_Socket *sock, u8 *buffer, u32 length, u32 *BytesRea
 	s32 res;
 #ifndef __SYMBIAN32__
 	s32 ready;
-	struct timeval timeout;
-	fd_set Group;
 #endif
 
 	if (!sock || !sock->socket || !buffer || !BytesRead) return GF_BAD_PARAM;
@@ -1803,12 +2297,7 @@ GF_Err gf_sk_receive_wait(GF_Socket *sock, u8 *buffer, u32 length, u32 *BytesRea
 
 #ifndef __SYMBIAN32__
 	//can we read?
-	FD_ZERO(&Group);
-	FD_SET(sock->socket, &Group);
-	timeout.tv_sec = Second;
-	timeout.tv_usec = sock->usec_wait;
-
-	ready = select((int) sock->socket+1, &Group, NULL, NULL, &timeout);
+	ready = gf_sk_wait_ready(sock->socket, GF_SK_SELECT_READ, Second, sock->usec_wait);
 	if (ready == SOCKET_ERROR) {
 		switch (LASTSOCKERROR) {
 		case EAGAIN:
@@ -1818,7 +2307,7 @@ GF_Err gf_sk_receive_wait(GF_Socket *sock, u8 *buffer, u32 length, u32 *BytesRea
 			return GF_IP_NETWORK_FAILURE;
 		}
 	}
-	if (!FD_ISSET(sock->socket, &Group)) {
+	if (!ready) {
 		return GF_IP_NETWORK_EMPTY;
 	}
 #endif
@@ -1846,8 +2335,6 @@ GF_Err gf_sk_send_wait(GF_Socket *sock, const u8 *buffer, u32 length, u32 Second
 	s32 res;
 #ifndef __SYMBIAN32__
 	s32 ready;
-	struct timeval timeout;
-	fd_set Group;
 #endif
 
 	//the socket must be bound or connected
@@ -1855,13 +2342,7 @@ GF_Err gf_sk_send_wait(GF_Socket *sock, const u8 *buffer, u32 length, u32 Second
 
 #ifndef __SYMBIAN32__
 	//can we write?
-	FD_ZERO(&Group);
-	FD_SET(sock->socket, &Group);
-	timeout.tv_sec = Second;
-	timeout.tv_usec = sock->usec_wait;
-
-	//TODO - check if this is correct
-	ready = select((int) sock->socket+1, NULL, &Group, NULL, &timeout);
+	ready = gf_sk_wait_ready(sock->socket, GF_SK_SELECT_WRITE, Second, sock->usec_wait);
 	if (ready == SOCKET_ERROR) {
 		switch (LASTSOCKERROR) {
 		case EAGAIN:
@@ -1872,7 +2353,7 @@ GF_Err gf_sk_send_wait(GF_Socket *sock, const u8 *buffer, u32 length, u32 Second
 		}
 	}
 	//should never happen (to check: is writeability is guaranteed for not-connected sockets)
-	if (!ready || !FD_ISSET(sock->socket, &Group)) {
+	if (!ready) {
 		return GF_IP_NETWORK_EMPTY;
 	}
 #endif
@@ -23,6 +23,11 @@
  *
  */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+//for CPU affinity and sched_getcpu
+#define _GNU_SOURCE
+#endif
+
 #ifndef GPAC_DISABLE_CORE_TOOLS
 
 #ifdef GPAC_CONFIG_ANDROID
@@ -43,6 +48,9 @@ typedef HANDLE TH_HANDLE;
 #include <pthread.h>
 #include <semaphore.h>
 #include <errno.h>
+#if defined(__linux__) && !defined(GPAC_CONFIG_ANDROID)
+#include <dirent.h>
+#endif
 typedef pthread_t TH_HANDLE ;
 
 #endif
@@ -401,6 +409,105 @@ void gf_th_set_priority(GF_Thread *t, s32 priority)
 #endif
 }
 
+GF_EXPORT
+GF_Err gf_th_set_cpu_affinity(GF_Thread *t, const u32 *cpus, u32 nb_cpus)
+{
+	u32 i;
+	if (!cpus || !nb_cpus) return GF_BAD_PARAM;
+
+#if defined(WIN32) && !defined(_WIN32_WCE)
+	DWORD_PTR mask = 0;
+	for (i=0; i<nb_cpus; i++) {
+		if (cpus[i] < 8*sizeof(DWORD_PTR))
+			mask |= ((DWORD_PTR)1) << cpus[i];
+	}
+	if (!mask) return GF_BAD_PARAM;
+	if (!SetThreadAffinityMask(t ? t->threadH : GetCurrentThread(), mask)) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_MUTEX, ("[Thread %s] Couldn't set CPU affinity, error %d\n", t ? t->log_name : "current", GetLastError() ));
+		return GF_IO_ERR;
+	}
+	return GF_OK;
+#elif defined(__linux__) && !defined(GPAC_CONFIG_ANDROID)
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	for (i=0; i<nb_cpus; i++) {
+		if (cpus[i] < CPU_SETSIZE)
+			CPU_SET(cpus[i], &set);
+	}
+	if (!CPU_COUNT(&set)) return GF_BAD_PARAM;
+	if (pthread_setaffinity_np(t ? t->threadH : pthread_self(), sizeof(cpu_set_t), &set)) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_MUTEX, ("[Thread %s] Couldn't set CPU affinity\n", t ? t->log_name : "current"));
+		return GF_IO_ERR;
+	}
+	return GF_OK;
+#else
+	return GF_NOT_SUPPORTED;
+#endif
+}
+
+GF_EXPORT
+s32 gf_th_get_cpu()
+{
+#if defined(WIN32) && !defined(_WIN32_WCE)
+	return (s32) GetCurrentProcessorNumber();
+#elif defined(__linux__) && !defined(GPAC_CONFIG_ANDROID)
+	return sched_getcpu();
+#else
+	return -1;
+#endif
+}
+
+GF_EXPORT
+s32 gf_sys_get_cpu_node(u32 cpu)
+{
+#if defined(__linux__) && !defined(GPAC_CONFIG_ANDROID)
+	DIR *dir;
+	struct dirent *ent;
+	s32 node = -1;
+	char szPath[100];
+	//kernel without NUMA support, single node
+	if (!gf_dir_exists("/sys/devices/system/node"))
+		return 0;
+
+	//the cpu directory contains a nodeN link to its NUMA node
+	sprintf(szPath, "/sys/devices/system/cpu/cpu%u", cpu);
+	dir = opendir(szPath);
+	if (!dir) return -1;
+	while ((ent = readdir(dir)) != NULL) {
+		u32 val;
+		if (strncmp(ent->d_name, "node", 4)) continue;
+		if (sscanf(ent->d_name+4, "%u", &val) == 1) {
+			node = (s32) val;
+			break;
+		}
+	}
+	closedir(dir);
+	//no node link, cpu belongs to the only node
+	return (node<0) ? 0 : node;
+#else
+	//assume single node
+	return 0;
+#endif
+}
+
+GF_EXPORT
+u32 gf_sys_get_node_cpus(u32 node, u32 *cpus, u32 max_cpus)
+{
+	u32 i, nb_cpus=0;
+	GF_SystemRTInfo rti;
+	memset(&rti, 0, sizeof(GF_SystemRTInfo));
+	if (!gf_sys_get_rti(0, &rti, 0) || !rti.nb_cores)
+		return 0;
+
+	for (i=0; i<rti.nb_cores; i++) {
+		if (nb_cpus==max_cpus) break;
+		if (gf_sys_get_cpu_node(i) != (s32) node) continue;
+		cpus[nb_cpus] = i;
+		nb_cpus++;
+	}
+	return nb_cpus;
+}
+
 GF_EXPORT
 u32 gf_th_status(GF_Thread *t)
 {
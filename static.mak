@@ -18,6 +18,11 @@ ifeq ($(HAS_OPENSSL),yes)
 LINKLIBS+=$(SSL_LIBS)
 endif
 
+#2b - HTTP/2 support
+ifeq ($(HAS_HTTP2),yes)
+LINKLIBS+=$(H2_LIBS)
+endif
+
 #3 - spidermonkey support
 ifeq ($(CONFIG_JS),no)
 else